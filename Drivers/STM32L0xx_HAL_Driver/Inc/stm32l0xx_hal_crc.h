@@ -118,6 +118,21 @@ typedef struct
 
                                            Note that constant CRC_INPUT_FORMAT_UNDEFINED is defined but an initialization error
                                            must occur if InputBufferFormat is not one of the three values listed above  */
+
+  DMA_HandleTypeDef           *hdma;       /*!< CRC DMA handle parameters, memory-to-memory channel */
+
+  uint8_t                     *pBuffPtr;   /*!< Pointer to the next data entered in the CRC calculator */
+
+  uint32_t                    XferCount;   /*!< Number of DMA transfers left                          */
+
+  uint32_t                    XferTail;    /*!< Number of bytes or half-words entered by the CPU once
+                                                the DMA transfers are completed                       */
+
+  uint32_t                    XferRevIn;   /*!< Input data inversion mode restored at the end of the
+                                                DMA transfers                                         */
+
+  struct __CRC_ContextTypeDef *pContext;   /*!< Streaming context updated at the end of the DMA
+                                                transfers, NULL if none                               */
 } CRC_HandleTypeDef;
 /**
   * @}
@@ -309,6 +324,11 @@ void HAL_CRC_MspDeInit(CRC_HandleTypeDef *hcrc);
   */
 uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
 uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+HAL_StatusTypeDef HAL_CRC_Accumulate_DMA(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+HAL_StatusTypeDef HAL_CRC_Calculate_DMA(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+uint32_t HAL_CRC_GetValue(CRC_HandleTypeDef *hcrc);
+void HAL_CRC_CpltCallback(CRC_HandleTypeDef *hcrc);
+void HAL_CRC_ErrorCallback(CRC_HandleTypeDef *hcrc);
 /**
   * @}
   */
@@ -37,6 +37,30 @@ extern "C" {
   */
 
 /* Exported types ------------------------------------------------------------*/
+/** @defgroup CRCEx_Exported_Types CRC Extended Exported Types
+  * @{
+  */
+
+/**
+  * @brief  CRC streaming context structure definition
+  * @note   A context holds a CRC computation over data split in several buffers,
+  *         so that several computations can share the peripheral. The data are
+  *         entered in the CRC calculator as if they were in a single buffer.
+  */
+typedef struct __CRC_ContextTypeDef
+{
+  uint32_t Crc;                 /*!< CRC of the data entered so far, before output inversion */
+
+  uint32_t Pending;             /*!< Bytes or half-words not entered yet, the first one in the
+                                     most significant bits                                    */
+
+  uint32_t PendingCount;        /*!< Number of bytes or half-words held in Pending           */
+} CRC_ContextTypeDef;
+
+/**
+  * @}
+  */
+
 /* Exported constants --------------------------------------------------------*/
 /** @defgroup CRCEx_Exported_Constants CRC Extended Exported Constants
   * @{
@@ -128,6 +152,20 @@ HAL_StatusTypeDef HAL_CRCEx_Polynomial_Set(CRC_HandleTypeDef *hcrc, uint32_t Pol
 HAL_StatusTypeDef HAL_CRCEx_Input_Data_Reverse(CRC_HandleTypeDef *hcrc, uint32_t InputReverseMode);
 HAL_StatusTypeDef HAL_CRCEx_Output_Data_Reverse(CRC_HandleTypeDef *hcrc, uint32_t OutputReverseMode);
 
+/**
+  * @}
+  */
+
+/** @addtogroup CRCEx_Exported_Functions_Group2
+  * @{
+  */
+/* Streaming context and software computation functions ***********************/
+void HAL_CRCEx_Context_Init(CRC_HandleTypeDef *hcrc, CRC_ContextTypeDef *pContext);
+void HAL_CRCEx_Context_Update(CRC_HandleTypeDef *hcrc, CRC_ContextTypeDef *pContext, uint32_t pBuffer[], uint32_t BufferLength);
+HAL_StatusTypeDef HAL_CRCEx_Context_Update_DMA(CRC_HandleTypeDef *hcrc, CRC_ContextTypeDef *pContext, uint32_t pBuffer[], uint32_t BufferLength);
+uint32_t HAL_CRCEx_Context_Final(CRC_HandleTypeDef *hcrc, CRC_ContextTypeDef *pContext);
+uint32_t HAL_CRCEx_Calculate_Soft(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+
 /**
   * @}
   */
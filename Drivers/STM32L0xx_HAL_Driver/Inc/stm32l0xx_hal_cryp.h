@@ -110,6 +110,9 @@ typedef struct
 
   __IO  HAL_CRYP_STATETypeDef State;            /*!< CRYP peripheral state */
 
+  struct __CRYP_AuthContextTypeDef *pAuthContext; /*!< Authentication context of the ongoing
+                                                       HAL_CRYPEx_Auth_Update_DMA() */
+
 }CRYP_HandleTypeDef;
 
 /**
@@ -39,7 +39,111 @@
   */ 
 
 /* Exported types ------------------------------------------------------------*/ 
+
+/** @defgroup CRYPEx_Exported_Types CRYPEx Exported Types
+  * @{
+  */
+
+/** 
+  * @brief  CRYP authentication key structure definition
+  * @note   Holds the values derived from the key, computed once by
+  *         HAL_CRYPEx_AuthKey_Init() and shared by all the messages
+  *         authenticated with this key.
+  */
+typedef struct
+{
+  uint32_t Key[4];              /*!< Key, in the order of the KEYR3 to KEYR0 registers */
+
+  uint32_t HashTable[16][4];    /*!< GCM: products of the hash subkey H by the 4-bit
+                                     polynomials, used by the software GHASH          */
+
+  uint32_t Subkey1[4];          /*!< CMAC: subkey K1                                  */
+
+  uint32_t Subkey2[4];          /*!< CMAC: subkey K2                                  */
+} CRYP_AuthKeyTypeDef;
+
+/** 
+  * @brief  CRYP authentication context structure definition
+  * @note   A context holds one GCM, CCM or CMAC computation over a message
+  *         split in several buffers, so that several messages can share the
+  *         peripheral. 128-bit values are stored as four words, the first
+  *         word holding the first four bytes in big endian order.
+  */
+typedef struct __CRYP_AuthContextTypeDef
+{
+  const CRYP_AuthKeyTypeDef *pAuthKey; /*!< Values derived from the key                  */
+
+  uint32_t Algorithm;           /*!< Algorithm, a value of @ref CRYPEx_Authentication_Algorithm */
+
+  uint32_t Direction;           /*!< Direction, a value of @ref CRYPEx_Authentication_Direction */
+
+  uint32_t Phase;               /*!< Header or payload phase                          */
+
+  uint32_t HeaderSize;          /*!< CCM: size of the header given at start           */
+
+  uint32_t PayloadSize;         /*!< CCM: size of the payload given at start          */
+
+  uint32_t TagSize;             /*!< CCM: size of the tag given at start              */
+
+  uint32_t HeaderCount;         /*!< Header bytes processed                           */
+
+  uint32_t PayloadCount;        /*!< Payload bytes processed                          */
+
+  uint32_t Counter[4];          /*!< Next counter block                               */
+
+  uint32_t TagMask[4];          /*!< Encrypted first counter block, XORed to the tag  */
+
+  uint32_t Mac[4];              /*!< GCM: GHASH accumulator, CCM and CMAC: CBC-MAC    */
+
+  uint8_t  Block[16];           /*!< Bytes waiting to be authenticated                */
+
+  uint8_t  Keystream[16];       /*!< Keystream of the last counter block              */
+
+  uint32_t BlockCount;          /*!< Number of bytes in Block                         */
+
+  uint32_t XferBlocks;          /*!< DMA: number of blocks transferred                */
+
+  uint32_t XferTail;            /*!< DMA: number of bytes after the last block        */
+
+  uint32_t XferStep;            /*!< DMA: passes over the blocks still to be done     */
+} CRYP_AuthContextTypeDef;
+
+/**
+  * @}
+  */
+
 /* Exported constants --------------------------------------------------------*/
+
+/** @defgroup CRYPEx_Exported_Constants CRYPEx Exported Constants
+  * @{
+  */
+
+/** @defgroup CRYPEx_Authentication_Algorithm CRYPEx Authentication Algorithm
+  * @{
+  */
+#define CRYP_AUTH_GCM             ((uint32_t)0x00000001U)  /*!< AES-GCM, NIST SP 800-38D  */
+#define CRYP_AUTH_CCM             ((uint32_t)0x00000002U)  /*!< AES-CCM, NIST SP 800-38C  */
+#define CRYP_AUTH_CMAC            ((uint32_t)0x00000003U)  /*!< AES-CMAC, NIST SP 800-38B */
+/**
+  * @}
+  */
+
+/** @defgroup CRYPEx_Authentication_Direction CRYPEx Authentication Direction
+  * @{
+  */
+#define CRYP_AUTH_ENCRYPT         ((uint32_t)0x00000000U)
+#define CRYP_AUTH_DECRYPT         ((uint32_t)0x00000001U)
+
+#define IS_CRYP_AUTH_DIRECTION(DIRECTION) (((DIRECTION) == CRYP_AUTH_ENCRYPT) || \
+                                           ((DIRECTION) == CRYP_AUTH_DECRYPT))
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
 /* Exported functions --------------------------------------------------------*/
 
 /** @defgroup CRYPEx_Exported_Functions CRYPEx Exported Functions
@@ -53,6 +157,29 @@
 /* CallBack functions  ********************************************************/
 void HAL_CRYPEx_ComputationCpltCallback(CRYP_HandleTypeDef *hcryp);
 
+/**
+  * @}
+  */ 
+
+/** @defgroup CRYPEx_Exported_Functions_Group2 Authenticated encryption functions
+  * @{
+  */
+
+/* Key setup  *****************************************************************/
+HAL_StatusTypeDef HAL_CRYPEx_AuthKey_Init(CRYP_HandleTypeDef *hcryp, CRYP_AuthKeyTypeDef *pAuthKey, uint32_t Timeout);
+
+/* Message start  *************************************************************/
+HAL_StatusTypeDef HAL_CRYPEx_AESGCM_Start(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const CRYP_AuthKeyTypeDef *pAuthKey, uint32_t Direction, uint8_t *pInitVect, uint32_t IVSize, uint32_t Timeout);
+HAL_StatusTypeDef HAL_CRYPEx_AESCCM_Start(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const CRYP_AuthKeyTypeDef *pAuthKey, uint32_t Direction, uint8_t *pNonce, uint32_t NonceSize, uint32_t HeaderSize, uint32_t PayloadSize, uint32_t TagSize, uint32_t Timeout);
+HAL_StatusTypeDef HAL_CRYPEx_AESCMAC_Start(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const CRYP_AuthKeyTypeDef *pAuthKey);
+
+/* Message processing  ********************************************************/
+HAL_StatusTypeDef HAL_CRYPEx_Auth_Header(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, uint8_t *pHeader, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_CRYPEx_Auth_Update(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, uint8_t *pInputData, uint16_t Size, uint8_t *pOutputData, uint32_t Timeout);
+HAL_StatusTypeDef HAL_CRYPEx_Auth_Update_DMA(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, uint8_t *pInputData, uint16_t Size, uint8_t *pOutputData);
+HAL_StatusTypeDef HAL_CRYPEx_Auth_Final(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, uint8_t *pTag, uint32_t TagSize, uint32_t Timeout);
+HAL_StatusTypeDef HAL_CRYPEx_Auth_Verify(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, uint8_t *pTag, uint32_t TagSize, uint32_t Timeout);
+
 /**
   * @}
   */ 
@@ -245,6 +245,9 @@ typedef struct __UART_HandleTypeDef
 
   __IO uint32_t                 ErrorCode;           /*!< UART Error code                    */
 
+  struct __UART_RxRingTypeDef   *pRxRing;            /*!< Reception ring, when the reception
+                                                          is started by HAL_UARTEx_RxRing_Start() */
+
 #if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
   void (* TxHalfCpltCallback)(struct __UART_HandleTypeDef *huart);        /*!< UART Tx Half Complete Callback        */
   void (* TxCpltCallback)(struct __UART_HandleTypeDef *huart);            /*!< UART Tx Complete Callback             */
@@ -1566,6 +1569,7 @@ HAL_StatusTypeDef UART_WaitOnFlagUntilTimeout(UART_HandleTypeDef *huart, uint32_
 void              UART_AdvFeatureConfig(UART_HandleTypeDef *huart);
 HAL_StatusTypeDef UART_Start_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
 HAL_StatusTypeDef UART_Start_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+void              UART_RxRingEvent(UART_HandleTypeDef *huart);
 
 /**
   * @}
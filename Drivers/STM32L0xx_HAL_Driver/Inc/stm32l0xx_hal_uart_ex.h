@@ -57,6 +57,25 @@ typedef struct
   uint8_t Address;             /*!< UART/USART node address (7-bit long max). */
 } UART_WakeUpTypeDef;
 
+/**
+  * @brief  UART reception ring structure definition
+  * @note   The ring is filled by HAL_UARTEx_RxRing_Start(). Head is only written by the UART and DMA
+  *         interrupts and Tail only by the consumer, so that one consumer can read the ring without
+  *         disabling interrupts.
+  */
+typedef struct __UART_RxRingTypeDef
+{
+  uint8_t       *pBuffer;      /*!< Ring buffer, written by the DMA in circular mode. */
+
+  uint32_t      Size;          /*!< Size of the ring buffer in bytes, a power of 2. */
+
+  __IO uint32_t Head;          /*!< Number of bytes received, as seen by the last reception event. */
+
+  __IO uint32_t Tail;          /*!< Number of bytes released by the consumer. */
+
+  __IO uint32_t Overruns;      /*!< Number of times unread data has been overwritten by the DMA. */
+} UART_RxRingTypeDef;
+
 /**
   * @}
   */
@@ -136,6 +155,13 @@ HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle(UART_HandleTypeDef *huart, uint8_t *p
 HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
 HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
 
+HAL_StatusTypeDef HAL_UARTEx_RxRing_Start(UART_HandleTypeDef *huart, UART_RxRingTypeDef *pRing, uint8_t *pBuffer,
+                                          uint16_t Size);
+uint32_t HAL_UARTEx_RxRing_Available(UART_HandleTypeDef *huart);
+uint32_t HAL_UARTEx_RxRing_Peek(UART_HandleTypeDef *huart, uint8_t **ppData);
+HAL_StatusTypeDef HAL_UARTEx_RxRing_Consume(UART_HandleTypeDef *huart, uint32_t Length);
+HAL_StatusTypeDef HAL_UARTEx_RxRing_Read(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint16_t *RxLen);
+
 
 /**
   * @}
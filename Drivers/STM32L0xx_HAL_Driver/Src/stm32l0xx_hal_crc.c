@@ -27,6 +27,20 @@
              input data buffer starting with the defined initialization value
              (default or non-default) to initiate CRC calculation
 
+    [..]
+         (+) The CRC peripheral has no DMA request: to feed it by DMA, configure a
+             DMA channel in memory-to-memory mode (DMA_MEMORY_TO_MEMORY, peripheral
+             increment enabled, memory increment disabled, normal mode), enable its
+             interrupt and link it to the CRC handle with __HAL_LINKDMA() in
+             HAL_CRC_MspInit(). The data sizes of the channel are set by the driver.
+         (+) Use HAL_CRC_Accumulate_DMA() or HAL_CRC_Calculate_DMA() to start the
+             computation. HAL_CRC_CpltCallback() is called once the whole buffer has
+             been entered, the CRC is then read with HAL_CRC_GetValue().
+             HAL_CRC_ErrorCallback() is called on a DMA transfer error.
+         (+) The result is the same as that of HAL_CRC_Accumulate() and
+             HAL_CRC_Calculate() for the same buffer, whatever the input data format
+             and inversion modes.
+
   @endverbatim
   ******************************************************************************
   * @attention
@@ -66,6 +80,12 @@
  */
 static uint32_t CRC_Handle_8(CRC_HandleTypeDef *hcrc, uint8_t pBuffer[], uint32_t BufferLength);
 static uint32_t CRC_Handle_16(CRC_HandleTypeDef *hcrc, uint16_t pBuffer[], uint32_t BufferLength);
+static void CRC_DMA_Config(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+static HAL_StatusTypeDef CRC_DMA_Next(CRC_HandleTypeDef *hcrc);
+static void CRC_DMA_End(CRC_HandleTypeDef *hcrc);
+static void CRC_DMA_Restore(CRC_HandleTypeDef *hcrc);
+static void CRC_DMAXferCplt(DMA_HandleTypeDef *hdma);
+static void CRC_DMAError(DMA_HandleTypeDef *hdma);
 /**
   * @}
   */
@@ -164,6 +184,9 @@ HAL_StatusTypeDef HAL_CRC_Init(CRC_HandleTypeDef *hcrc)
    * is properly specified by user */
   assert_param(IS_CRC_INPUTDATA_FORMAT(hcrc->InputDataFormat));
 
+  /* No streaming context is attached to the handle */
+  hcrc->pContext = NULL;
+
   /* Change CRC peripheral state */
   hcrc->State = HAL_CRC_STATE_READY;
 
@@ -265,6 +288,9 @@ __weak void HAL_CRC_MspDeInit(CRC_HandleTypeDef *hcrc)
       (+) compute the 7, 8, 16 or 32-bit CRC value of an 8, 16 or 32-bit data buffer
           independently of the previous CRC value.
 
+       [..]  either with the CPU or by DMA, the end of a DMA computation being
+             notified by HAL_CRC_CpltCallback().
+
 @endverbatim
   * @{
   */
@@ -380,6 +406,165 @@ uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t
   return temp;
 }
 
+/**
+  * @brief  Compute by DMA the 7, 8, 16 or 32-bit CRC value of an 8, 16 or 32-bit data buffer
+  *         starting with the previously computed CRC as initialization value.
+  * @param  hcrc CRC handle
+  * @param  pBuffer pointer to the input data buffer, exact input data format is
+  *         provided by hcrc->InputDataFormat.
+  * @param  BufferLength input data buffer length (number of bytes if pBuffer
+  *         type is * uint8_t, number of half-words if pBuffer type is * uint16_t,
+  *         number of words if pBuffer type is * uint32_t).
+  * @note   HAL_CRC_CpltCallback() is called once the whole buffer has been entered,
+  *         the CRC is then read with HAL_CRC_GetValue().
+  * @note   Depending on the input data format and input data inversion mode, the
+  *         buffer is transferred by bytes, half-words or words. If pBuffer is not
+  *         aligned on the transfer size, the buffer is entered by the CPU before
+  *         this function returns, and HAL_CRC_CpltCallback() is still called.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_CRC_Accumulate_DMA(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
+{
+  /* Process locked */
+  __HAL_LOCK(hcrc);
+
+  if (hcrc->State != HAL_CRC_STATE_READY)
+  {
+    /* Process unlocked */
+    __HAL_UNLOCK(hcrc);
+    return HAL_BUSY;
+  }
+
+  if (hcrc->hdma == NULL)
+  {
+    /* Process unlocked */
+    __HAL_UNLOCK(hcrc);
+    return HAL_ERROR;
+  }
+
+  /* Change CRC peripheral state */
+  hcrc->State = HAL_CRC_STATE_BUSY;
+
+  /* Configure the DMA channel and the input data inversion */
+  CRC_DMA_Config(hcrc, pBuffer, BufferLength);
+
+  /* Process unlocked */
+  __HAL_UNLOCK(hcrc);
+
+  /* Start the first DMA transfer */
+  if (CRC_DMA_Next(hcrc) != HAL_OK)
+  {
+    CRC_DMA_Restore(hcrc);
+    hcrc->State = HAL_CRC_STATE_READY;
+    return HAL_ERROR;
+  }
+
+  /* Return function status */
+  return HAL_OK;
+}
+
+/**
+  * @brief  Compute by DMA the 7, 8, 16 or 32-bit CRC value of an 8, 16 or 32-bit data buffer
+  *         starting with hcrc->Instance->INIT as initialization value.
+  * @param  hcrc CRC handle
+  * @param  pBuffer pointer to the input data buffer, exact input data format is
+  *         provided by hcrc->InputDataFormat.
+  * @param  BufferLength input data buffer length (number of bytes if pBuffer
+  *         type is * uint8_t, number of half-words if pBuffer type is * uint16_t,
+  *         number of words if pBuffer type is * uint32_t).
+  * @note   HAL_CRC_CpltCallback() is called once the whole buffer has been entered,
+  *         the CRC is then read with HAL_CRC_GetValue().
+  * @note   Depending on the input data format and input data inversion mode, the
+  *         buffer is transferred by bytes, half-words or words. If pBuffer is not
+  *         aligned on the transfer size, the buffer is entered by the CPU before
+  *         this function returns, and HAL_CRC_CpltCallback() is still called.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_CRC_Calculate_DMA(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
+{
+  /* Process locked */
+  __HAL_LOCK(hcrc);
+
+  if (hcrc->State != HAL_CRC_STATE_READY)
+  {
+    /* Process unlocked */
+    __HAL_UNLOCK(hcrc);
+    return HAL_BUSY;
+  }
+
+  if (hcrc->hdma == NULL)
+  {
+    /* Process unlocked */
+    __HAL_UNLOCK(hcrc);
+    return HAL_ERROR;
+  }
+
+  /* Change CRC peripheral state */
+  hcrc->State = HAL_CRC_STATE_BUSY;
+
+  /* Reset CRC Calculation Unit (hcrc->Instance->INIT is
+  *  written in hcrc->Instance->DR) */
+  __HAL_CRC_DR_RESET(hcrc);
+
+  /* Configure the DMA channel and the input data inversion */
+  CRC_DMA_Config(hcrc, pBuffer, BufferLength);
+
+  /* Process unlocked */
+  __HAL_UNLOCK(hcrc);
+
+  /* Start the first DMA transfer */
+  if (CRC_DMA_Next(hcrc) != HAL_OK)
+  {
+    CRC_DMA_Restore(hcrc);
+    hcrc->State = HAL_CRC_STATE_READY;
+    return HAL_ERROR;
+  }
+
+  /* Return function status */
+  return HAL_OK;
+}
+
+/**
+  * @brief  Return the CRC computed by the last CRC computation.
+  * @param  hcrc CRC handle
+  * @retval uint32_t CRC (returned value LSBs for CRC shorter than 32 bits)
+  */
+uint32_t HAL_CRC_GetValue(CRC_HandleTypeDef *hcrc)
+{
+  /* Return the CRC computed value */
+  return hcrc->Instance->DR;
+}
+
+/**
+  * @brief  CRC DMA computation complete callback.
+  * @param  hcrc CRC handle
+  * @retval None
+  */
+__weak void HAL_CRC_CpltCallback(CRC_HandleTypeDef *hcrc)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hcrc);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the HAL_CRC_CpltCallback can be implemented in the user file
+   */
+}
+
+/**
+  * @brief  CRC DMA error callback.
+  * @param  hcrc CRC handle
+  * @retval None
+  */
+__weak void HAL_CRC_ErrorCallback(CRC_HandleTypeDef *hcrc)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hcrc);
+
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the HAL_CRC_ErrorCallback can be implemented in the user file
+   */
+}
+
 /**
   * @}
   */
@@ -502,6 +687,257 @@ static uint32_t CRC_Handle_16(CRC_HandleTypeDef *hcrc, uint16_t pBuffer[], uint3
   return hcrc->Instance->DR;
 }
 
+/**
+  * @brief  Configure the DMA transfers of a buffer.
+  * @note   The peripheral processes the data written by a DMA transfer exactly as
+  *         the words written by CRC_Handle_8() and CRC_Handle_16() once the byte
+  *         order of the memory is taken into account. For instance 4 bytes entered
+  *         with a word-wise input inversion are the same as the little-endian word
+  *         read from memory entered with a byte-wise inversion. The transfer size
+  *         and the input data inversion used during the transfers are chosen so.
+  * @param  hcrc CRC handle
+  * @param  pBuffer pointer to the input data buffer
+  * @param  BufferLength input data buffer length
+  * @retval None
+  */
+static void CRC_DMA_Config(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
+{
+  uint32_t revin = READ_BIT(hcrc->Instance->CR, CRC_CR_REV_IN);
+  uint32_t units;   /* number of bytes or half-words per DMA transfer */
+  uint32_t size;    /* DMA transfer size in bytes */
+  uint32_t psize;
+  uint32_t msize;
+
+  switch (hcrc->InputDataFormat)
+  {
+    case CRC_INPUTDATA_FORMAT_BYTES:
+      if (revin == CRC_INPUTDATA_INVERSION_WORD)
+      {
+        units = 4U;
+        size = 4U;
+        MODIFY_REG(hcrc->Instance->CR, CRC_CR_REV_IN, CRC_INPUTDATA_INVERSION_BYTE);
+      }
+      else if (revin == CRC_INPUTDATA_INVERSION_HALFWORD)
+      {
+        units = 2U;
+        size = 2U;
+        MODIFY_REG(hcrc->Instance->CR, CRC_CR_REV_IN, CRC_INPUTDATA_INVERSION_BYTE);
+      }
+      else
+      {
+        units = 1U;
+        size = 1U;
+      }
+      break;
+
+    case CRC_INPUTDATA_FORMAT_HALFWORDS:
+      if (revin == CRC_INPUTDATA_INVERSION_WORD)
+      {
+        units = 2U;
+        size = 4U;
+        MODIFY_REG(hcrc->Instance->CR, CRC_CR_REV_IN, CRC_INPUTDATA_INVERSION_HALFWORD);
+      }
+      else
+      {
+        units = 1U;
+        size = 2U;
+      }
+      break;
+
+    default:
+      units = 1U;
+      size = 4U;
+      break;
+  }
+
+  hcrc->XferRevIn = revin;
+  hcrc->pBuffPtr = (uint8_t *)pBuffer;
+
+  if (((uint32_t)pBuffer & (size - 1U)) != 0U)
+  {
+    /* Unaligned buffer, entered by the CPU */
+    MODIFY_REG(hcrc->Instance->CR, CRC_CR_REV_IN, revin);
+    hcrc->XferCount = 0U;
+    hcrc->XferTail = BufferLength;
+  }
+  else
+  {
+    hcrc->XferCount = BufferLength / units;
+    hcrc->XferTail = BufferLength % units;
+  }
+
+  if (size == 4U)
+  {
+    psize = DMA_PDATAALIGN_WORD;
+    msize = DMA_MDATAALIGN_WORD;
+  }
+  else if (size == 2U)
+  {
+    psize = DMA_PDATAALIGN_HALFWORD;
+    msize = DMA_MDATAALIGN_HALFWORD;
+  }
+  else
+  {
+    psize = DMA_PDATAALIGN_BYTE;
+    msize = DMA_MDATAALIGN_BYTE;
+  }
+
+  /* The data sizes can only be changed while the channel is disabled */
+  __HAL_DMA_DISABLE(hcrc->hdma);
+  MODIFY_REG(hcrc->hdma->Instance->CCR, (DMA_CCR_PSIZE | DMA_CCR_MSIZE), (psize | msize));
+  hcrc->hdma->Init.PeriphDataAlignment = psize;
+  hcrc->hdma->Init.MemDataAlignment = msize;
+
+  hcrc->hdma->XferCpltCallback = CRC_DMAXferCplt;
+  hcrc->hdma->XferHalfCpltCallback = NULL;
+  hcrc->hdma->XferErrorCallback = CRC_DMAError;
+  hcrc->hdma->XferAbortCallback = NULL;
+}
+
+/**
+  * @brief  Start the next DMA transfer, or end the computation when all the
+  *         DMA transfers are completed.
+  * @note   A DMA transfer is limited to 65535 data, longer buffers are split.
+  * @param  hcrc CRC handle
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRC_DMA_Next(CRC_HandleTypeDef *hcrc)
+{
+  uint32_t count;
+  uint32_t size;
+  uint8_t *pData;
+
+  if (hcrc->XferCount == 0U)
+  {
+    CRC_DMA_End(hcrc);
+    return HAL_OK;
+  }
+
+  count = (hcrc->XferCount > 0xFFFFU) ? 0xFFFFU : hcrc->XferCount;
+  size = 1UL << (hcrc->hdma->Init.PeriphDataAlignment >> DMA_CCR_PSIZE_Pos);
+
+  pData = hcrc->pBuffPtr;
+  hcrc->pBuffPtr += count * size;
+  hcrc->XferCount -= count;
+
+  /* The data are read at the peripheral address, which increments, and written
+     at the memory address, the CRC data register */
+  return HAL_DMA_Start_IT(hcrc->hdma, (uint32_t)pData, (uint32_t)&hcrc->Instance->DR, count);
+}
+
+/**
+  * @brief  End a DMA computation: enter the last data with the CPU, save the
+  *         streaming context if any and call the completion callback.
+  * @param  hcrc CRC handle
+  * @retval None
+  */
+static void CRC_DMA_End(CRC_HandleTypeDef *hcrc)
+{
+  uint32_t index;
+  uint32_t cr;
+
+  /* Restore the input data inversion mode */
+  MODIFY_REG(hcrc->Instance->CR, CRC_CR_REV_IN, hcrc->XferRevIn);
+
+  if (hcrc->XferTail != 0U)
+  {
+    switch (hcrc->InputDataFormat)
+    {
+      case CRC_INPUTDATA_FORMAT_WORDS:
+        for (index = 0U; index < hcrc->XferTail; index++)
+        {
+          hcrc->Instance->DR = ((uint32_t *)(void *)hcrc->pBuffPtr)[index];    /* Derogation MisraC2012 R.11.5 */
+        }
+        break;
+
+      case CRC_INPUTDATA_FORMAT_BYTES:
+        (void)CRC_Handle_8(hcrc, hcrc->pBuffPtr, hcrc->XferTail);
+        break;
+
+      case CRC_INPUTDATA_FORMAT_HALFWORDS:
+        (void)CRC_Handle_16(hcrc, (uint16_t *)(void *)hcrc->pBuffPtr, hcrc->XferTail);    /* Derogation MisraC2012 R.11.5 */
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  if (hcrc->pContext != NULL)
+  {
+    /* Save the CRC before output inversion, the output inversion only
+       applies to the data register reads */
+    cr = hcrc->Instance->CR;
+    CLEAR_BIT(hcrc->Instance->CR, CRC_CR_REV_OUT);
+    hcrc->pContext->Crc = hcrc->Instance->DR;
+    MODIFY_REG(hcrc->Instance->CR, CRC_CR_REV_OUT, cr);
+  }
+  CRC_DMA_Restore(hcrc);
+
+  /* Change CRC peripheral state */
+  hcrc->State = HAL_CRC_STATE_READY;
+
+  HAL_CRC_CpltCallback(hcrc);
+}
+
+/**
+  * @brief  DMA CRC transfer complete callback.
+  * @param  hdma DMA handle
+  * @retval None
+  */
+static void CRC_DMAXferCplt(DMA_HandleTypeDef *hdma)
+{
+  CRC_HandleTypeDef *hcrc = (CRC_HandleTypeDef *)((DMA_HandleTypeDef *)hdma)->Parent;
+
+  if (CRC_DMA_Next(hcrc) != HAL_OK)
+  {
+    CRC_DMAError(hdma);
+  }
+}
+
+/**
+  * @brief  DMA CRC communication error callback.
+  * @param  hdma DMA handle
+  * @retval None
+  */
+static void CRC_DMAError(DMA_HandleTypeDef *hdma)
+{
+  CRC_HandleTypeDef *hcrc = (CRC_HandleTypeDef *)((DMA_HandleTypeDef *)hdma)->Parent;
+
+  CRC_DMA_Restore(hcrc);
+
+  /* Change CRC peripheral state */
+  hcrc->State = HAL_CRC_STATE_READY;
+
+  HAL_CRC_ErrorCallback(hcrc);
+}
+
+/**
+  * @brief  Restore the configuration changed for the DMA transfers.
+  * @param  hcrc CRC handle
+  * @retval None
+  */
+static void CRC_DMA_Restore(CRC_HandleTypeDef *hcrc)
+{
+  /* Restore the input data inversion mode */
+  MODIFY_REG(hcrc->Instance->CR, CRC_CR_REV_IN, hcrc->XferRevIn);
+
+  /* A streaming context is loaded through hcrc->Instance->INIT, set back
+     the initialization value */
+  if (hcrc->pContext != NULL)
+  {
+    if (hcrc->Init.DefaultInitValueUse == DEFAULT_INIT_VALUE_ENABLE)
+    {
+      WRITE_REG(hcrc->Instance->INIT, DEFAULT_CRC_INITVALUE);
+    }
+    else
+    {
+      WRITE_REG(hcrc->Instance->INIT, hcrc->Init.InitValue);
+    }
+    hcrc->pContext = NULL;
+  }
+}
+
 /**
   * @}
   */
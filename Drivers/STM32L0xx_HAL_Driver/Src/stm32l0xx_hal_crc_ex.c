@@ -13,6 +13,15 @@
     [..]
          (+) Set user-defined generating polynomial through HAL_CRCEx_Polynomial_Set()
          (+) Configure Input or Output data inversion
+         (+) Compute the CRC of data split in several buffers with a streaming context:
+             (++) HAL_CRCEx_Context_Init() starts a computation
+             (++) HAL_CRCEx_Context_Update() or HAL_CRCEx_Context_Update_DMA() enter
+                  the next buffer
+             (++) HAL_CRCEx_Context_Final() returns the CRC of all the buffers, the
+                  same as that of HAL_CRC_Calculate() for the concatenated buffers
+             Several contexts can be used at the same time with the same handle.
+         (+) Compute a CRC without the peripheral through HAL_CRCEx_Calculate_Soft(),
+             which gives the same result as HAL_CRC_Calculate()
 
   @endverbatim
   ******************************************************************************
@@ -48,6 +57,22 @@
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
+/** @defgroup CRCEx_Private_Functions CRC Extended Private Functions
+  * @{
+  */
+static uint32_t CRCEx_Length(CRC_HandleTypeDef *hcrc);
+static uint32_t CRCEx_Init_Value(CRC_HandleTypeDef *hcrc);
+static uint32_t CRCEx_Reverse(uint32_t Value, uint32_t Size);
+static uint32_t CRCEx_Soft_Write(CRC_HandleTypeDef *hcrc, uint32_t Crc, uint32_t Data, uint32_t Size);
+static uint32_t CRCEx_Unit_Size(CRC_HandleTypeDef *hcrc);
+static void CRCEx_Context_Enter(CRC_HandleTypeDef *hcrc, CRC_ContextTypeDef *pContext, uint32_t pBuffer[],
+                                uint32_t First, uint32_t Last, uint32_t Soft);
+static void CRCEx_Context_Restore(CRC_HandleTypeDef *hcrc, CRC_ContextTypeDef *pContext);
+static void CRCEx_Context_Save(CRC_HandleTypeDef *hcrc, CRC_ContextTypeDef *pContext);
+/**
+  * @}
+  */
+
 /* Exported functions --------------------------------------------------------*/
 
 /** @defgroup CRCEx_Exported_Functions CRC Extended Exported Functions
@@ -140,6 +165,12 @@ HAL_StatusTypeDef HAL_CRCEx_Polynomial_Set(CRC_HandleTypeDef *hcrc, uint32_t Pol
 
     /* set generating polynomial size */
     MODIFY_REG(hcrc->Instance->CR, CRC_CR_POLYSIZE, PolyLength);
+
+    /* keep the handle in line with the peripheral, the software
+     * computation relies on it */
+    hcrc->Init.DefaultPolynomialUse = DEFAULT_POLYNOMIAL_DISABLE;
+    hcrc->Init.GeneratingPolynomial = Pol;
+    hcrc->Init.CRCLength = PolyLength;
   }
   /* Return function status */
   return status;
@@ -166,6 +197,8 @@ HAL_StatusTypeDef HAL_CRCEx_Input_Data_Reverse(CRC_HandleTypeDef *hcrc, uint32_t
 
   /* set input data inversion mode */
   MODIFY_REG(hcrc->Instance->CR, CRC_CR_REV_IN, InputReverseMode);
+  hcrc->Init.InputDataInversionMode = InputReverseMode;
+
   /* Change CRC peripheral state */
   hcrc->State = HAL_CRC_STATE_READY;
 
@@ -192,6 +225,7 @@ HAL_StatusTypeDef HAL_CRCEx_Output_Data_Reverse(CRC_HandleTypeDef *hcrc, uint32_
 
   /* set output data inversion mode */
   MODIFY_REG(hcrc->Instance->CR, CRC_CR_REV_OUT, OutputReverseMode);
+  hcrc->Init.OutputDataInversionMode = OutputReverseMode;
 
   /* Change CRC peripheral state */
   hcrc->State = HAL_CRC_STATE_READY;
@@ -200,13 +234,469 @@ HAL_StatusTypeDef HAL_CRCEx_Output_Data_Reverse(CRC_HandleTypeDef *hcrc, uint32_
   return HAL_OK;
 }
 
+/**
+  * @}
+  */
+
+/** @defgroup CRCEx_Exported_Functions_Group2 Extended streaming and software computation functions
+  * @brief    Streaming context and software computation functions.
+  *
+@verbatim
+ ===============================================================================
+            ##### Streaming and software computation functions #####
+ ===============================================================================
+    [..]  This section provides functions allowing to:
+      (+) Compute the CRC of data split in several buffers, by the CPU or by DMA
+      (+) Compute the CRC with the CPU only, without the peripheral
+
+    [..]  The data of a streaming context are entered as if they were in a single
+          buffer: the bytes or half-words that do not fill a word are kept in the
+          context until the next buffer, the last ones being entered by
+          HAL_CRCEx_Context_Final(). The peripheral is loaded with the CRC of the
+          context before each buffer, through hcrc->Instance->INIT, and the CRC
+          is saved back after it. hcrc->Instance->INIT is then set back to the
+          configured initialization value, which is also loaded in
+          hcrc->Instance->DR.
+
+    [..]  The software computation uses the configuration of hcrc->Init and
+          hcrc->InputDataFormat, kept up to date by HAL_CRC_Init() and the
+          functions of CRCEx_Exported_Functions_Group1. It processes one bit at a
+          time: it is a fallback when the peripheral is in use, not a fast path.
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Start a CRC computation with a streaming context.
+  * @param  hcrc CRC handle
+  * @param  pContext streaming context
+  * @retval None
+  */
+void HAL_CRCEx_Context_Init(CRC_HandleTypeDef *hcrc, CRC_ContextTypeDef *pContext)
+{
+  uint32_t mask = (2UL << (CRCEx_Length(hcrc) - 1U)) - 1U;
+
+  pContext->Crc = CRCEx_Init_Value(hcrc) & mask;
+  pContext->Pending = 0U;
+  pContext->PendingCount = 0U;
+}
+
+/**
+  * @brief  Enter a buffer in the CRC computation of a streaming context.
+  * @param  hcrc CRC handle
+  * @param  pContext streaming context
+  * @param  pBuffer pointer to the input data buffer, exact input data format is
+  *         provided by hcrc->InputDataFormat.
+  * @param  BufferLength input data buffer length (number of bytes if pBuffer
+  *         type is * uint8_t, number of half-words if pBuffer type is * uint16_t,
+  *         number of words if pBuffer type is * uint32_t).
+  * @note   When the peripheral is busy, for instance with a DMA computation, the
+  *         buffer is entered with the software computation.
+  * @retval None
+  */
+void HAL_CRCEx_Context_Update(CRC_HandleTypeDef *hcrc, CRC_ContextTypeDef *pContext, uint32_t pBuffer[], uint32_t BufferLength)
+{
+  uint32_t size = CRCEx_Unit_Size(hcrc);
+  uint32_t first;
+  uint32_t whole;
 
+  /* Bytes or half-words completing the pending ones, then whole words */
+  first = (pContext->PendingCount == 0U) ? 0U : ((4U / size) - pContext->PendingCount);
+  if (first > BufferLength)
+  {
+    first = BufferLength;
+  }
+  whole = ((BufferLength - first) / (4U / size)) * (4U / size);
 
+  if (hcrc->State == HAL_CRC_STATE_READY)
+  {
+    /* Change CRC peripheral state */
+    hcrc->State = HAL_CRC_STATE_BUSY;
+
+    CRCEx_Context_Restore(hcrc, pContext);
+    CRCEx_Context_Enter(hcrc, pContext, pBuffer, 0U, first, 0U);
+    (void)HAL_CRC_Accumulate(hcrc, (uint32_t *)(void *)((uint8_t *)pBuffer + (first * size)), whole);    /* Derogation MisraC2012 R.11.5 */
+    CRCEx_Context_Save(hcrc, pContext);
+
+    /* Keep the last ones for the next buffer */
+    CRCEx_Context_Enter(hcrc, pContext, pBuffer, first + whole, BufferLength, 0U);
+  }
+  else
+  {
+    CRCEx_Context_Enter(hcrc, pContext, pBuffer, 0U, BufferLength, 1U);
+  }
+}
+
+/**
+  * @brief  Enter by DMA a buffer in the CRC computation of a streaming context.
+  * @param  hcrc CRC handle
+  * @param  pContext streaming context
+  * @param  pBuffer pointer to the input data buffer, exact input data format is
+  *         provided by hcrc->InputDataFormat.
+  * @param  BufferLength input data buffer length (number of bytes if pBuffer
+  *         type is * uint8_t, number of half-words if pBuffer type is * uint16_t,
+  *         number of words if pBuffer type is * uint32_t).
+  * @note   HAL_CRC_CpltCallback() is called once the buffer has been entered, the
+  *         context can then be used again. The buffer is entered as by
+  *         HAL_CRC_Accumulate_DMA().
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_CRCEx_Context_Update_DMA(CRC_HandleTypeDef *hcrc, CRC_ContextTypeDef *pContext, uint32_t pBuffer[], uint32_t BufferLength)
+{
+  uint32_t size = CRCEx_Unit_Size(hcrc);
+  uint32_t first;
+  uint32_t whole;
+
+  if (hcrc->State != HAL_CRC_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  if (hcrc->hdma == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  /* Bytes or half-words completing the pending ones, then whole words */
+  first = (pContext->PendingCount == 0U) ? 0U : ((4U / size) - pContext->PendingCount);
+  if (first > BufferLength)
+  {
+    first = BufferLength;
+  }
+  whole = ((BufferLength - first) / (4U / size)) * (4U / size);
+
+  CRCEx_Context_Restore(hcrc, pContext);
+  CRCEx_Context_Enter(hcrc, pContext, pBuffer, 0U, first, 0U);
+
+  /* Keep the last ones for the next buffer, the CRC is saved in the context
+     at the end of the DMA transfers */
+  CRCEx_Context_Enter(hcrc, pContext, pBuffer, first + whole, BufferLength, 0U);
+  hcrc->pContext = pContext;
+
+  return HAL_CRC_Accumulate_DMA(hcrc, (uint32_t *)(void *)((uint8_t *)pBuffer + (first * size)), whole);    /* Derogation MisraC2012 R.11.5 */
+}
+
+/**
+  * @brief  Return the CRC of all the buffers entered in a streaming context.
+  * @param  hcrc CRC handle
+  * @param  pContext streaming context
+  * @note   The context is not modified, more buffers can be entered afterwards.
+  * @retval uint32_t CRC (returned value LSBs for CRC shorter than 32 bits)
+  */
+uint32_t HAL_CRCEx_Context_Final(CRC_HandleTypeDef *hcrc, CRC_ContextTypeDef *pContext)
+{
+  uint32_t crc = pContext->Crc;
+
+  /* The last bytes or half-words are entered as by HAL_CRC_Calculate() */
+  if (hcrc->InputDataFormat == CRC_INPUTDATA_FORMAT_HALFWORDS)
+  {
+    if (pContext->PendingCount == 1U)
+    {
+      crc = CRCEx_Soft_Write(hcrc, crc, pContext->Pending, 16U);
+    }
+  }
+  else
+  {
+    switch (pContext->PendingCount)
+    {
+      case 1U:
+        crc = CRCEx_Soft_Write(hcrc, crc, pContext->Pending, 8U);
+        break;
+      case 2U:
+        crc = CRCEx_Soft_Write(hcrc, crc, pContext->Pending, 16U);
+        break;
+      case 3U:
+        crc = CRCEx_Soft_Write(hcrc, crc, pContext->Pending >> 8U, 16U);
+        crc = CRCEx_Soft_Write(hcrc, crc, pContext->Pending & 0xFFU, 8U);
+        break;
+      default:
+        break;
+    }
+  }
+
+  if (hcrc->Init.OutputDataInversionMode == CRC_OUTPUTDATA_INVERSION_ENABLE)
+  {
+    crc = CRCEx_Reverse(crc, CRCEx_Length(hcrc));
+  }
+
+  return crc;
+}
+
+/**
+  * @brief  Compute with the CPU only the 7, 8, 16 or 32-bit CRC value of an 8, 16
+  *         or 32-bit data buffer starting with the configured initialization value.
+  * @param  hcrc CRC handle
+  * @param  pBuffer pointer to the input data buffer, exact input data format is
+  *         provided by hcrc->InputDataFormat.
+  * @param  BufferLength input data buffer length (number of bytes if pBuffer
+  *         type is * uint8_t, number of half-words if pBuffer type is * uint16_t,
+  *         number of words if pBuffer type is * uint32_t).
+  * @note   The peripheral is not used, the result is the same as that of
+  *         HAL_CRC_Calculate().
+  * @retval uint32_t CRC (returned value LSBs for CRC shorter than 32 bits)
+  */
+uint32_t HAL_CRCEx_Calculate_Soft(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
+{
+  CRC_ContextTypeDef context;
+
+  HAL_CRCEx_Context_Init(hcrc, &context);
+  CRCEx_Context_Enter(hcrc, &context, pBuffer, 0U, BufferLength, 1U);
+
+  return HAL_CRCEx_Context_Final(hcrc, &context);
+}
 
 /**
   * @}
   */
 
+/**
+  * @}
+  */
+
+/** @addtogroup CRCEx_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  Return the CRC length in bits configured in the handle.
+  * @param  hcrc CRC handle
+  * @retval CRC length
+  */
+static uint32_t CRCEx_Length(CRC_HandleTypeDef *hcrc)
+{
+  uint32_t length = HAL_CRC_LENGTH_32B;
+
+  if (hcrc->Init.DefaultPolynomialUse == DEFAULT_POLYNOMIAL_DISABLE)
+  {
+    switch (hcrc->Init.CRCLength)
+    {
+      case CRC_POLYLENGTH_7B:
+        length = HAL_CRC_LENGTH_7B;
+        break;
+      case CRC_POLYLENGTH_8B:
+        length = HAL_CRC_LENGTH_8B;
+        break;
+      case CRC_POLYLENGTH_16B:
+        length = HAL_CRC_LENGTH_16B;
+        break;
+      default:
+        break;
+    }
+  }
+
+  return length;
+}
+
+/**
+  * @brief  Reverse the bit order of the Size least significant bits of a value.
+  * @param  Value value to reverse
+  * @param  Size number of bits to reverse, from 1 to 32
+  * @retval Reversed value
+  */
+static uint32_t CRCEx_Reverse(uint32_t Value, uint32_t Size)
+{
+  return __RBIT(Value) >> (32U - Size);
+}
+
+/**
+  * @brief  Software model of an 8, 16 or 32-bit write to the CRC data register.
+  * @note   As with the peripheral, the input data inversion of a write shorter than
+  *         the inversion mode only applies to the written data, e.g. a byte written
+  *         with the word-wise inversion is reversed byte-wise.
+  * @param  hcrc CRC handle
+  * @param  Crc CRC before the write, before output inversion
+  * @param  Data written data
+  * @param  Size write size in bits: 8, 16 or 32
+  * @retval CRC after the write, before output inversion
+  */
+static uint32_t CRCEx_Soft_Write(CRC_HandleTypeDef *hcrc, uint32_t Crc, uint32_t Data, uint32_t Size)
+{
+  uint32_t length = CRCEx_Length(hcrc);
+  uint32_t mask = (2UL << (length - 1U)) - 1U;
+  uint32_t pol = DEFAULT_CRC32_POLY;
+  uint32_t group;
+  uint32_t data = Data;
+  uint32_t crc = Crc;
+  uint32_t bit;
+
+  if (hcrc->Init.DefaultPolynomialUse == DEFAULT_POLYNOMIAL_DISABLE)
+  {
+    pol = hcrc->Init.GeneratingPolynomial & mask;
+  }
+
+  switch (hcrc->Init.InputDataInversionMode)
+  {
+    case CRC_INPUTDATA_INVERSION_BYTE:
+      group = 8U;
+      break;
+    case CRC_INPUTDATA_INVERSION_HALFWORD:
+      group = 16U;
+      break;
+    case CRC_INPUTDATA_INVERSION_WORD:
+      group = 32U;
+      break;
+    default:
+      group = 0U;
+      break;
+  }
+  if (group > Size)
+  {
+    group = Size;
+  }
+
+  if (group != 0U)
+  {
+    data = 0U;
+    for (bit = 0U; bit < Size; bit += group)
+    {
+      data |= CRCEx_Reverse(Data >> bit, group) << bit;
+    }
+  }
+
+  /* Data are processed most significant bit first */
+  for (bit = Size; bit > 0U; bit--)
+  {
+    if ((((crc >> (length - 1U)) ^ (data >> (bit - 1U))) & 1U) != 0U)
+    {
+      crc = ((crc << 1U) ^ pol) & mask;
+    }
+    else
+    {
+      crc = (crc << 1U) & mask;
+    }
+  }
+
+  return crc;
+}
+
+/**
+  * @brief  Return the size in bytes of the input data.
+  * @param  hcrc CRC handle
+  * @retval 1, 2 or 4
+  */
+static uint32_t CRCEx_Unit_Size(CRC_HandleTypeDef *hcrc)
+{
+  uint32_t size;
+
+  switch (hcrc->InputDataFormat)
+  {
+    case CRC_INPUTDATA_FORMAT_BYTES:
+      size = 1U;
+      break;
+    case CRC_INPUTDATA_FORMAT_HALFWORDS:
+      size = 2U;
+      break;
+    default:
+      size = 4U;
+      break;
+  }
+
+  return size;
+}
+
+/**
+  * @brief  Enter input data in a streaming context.
+  * @note   The bytes or half-words are gathered in words packed as by
+  *         HAL_CRC_Calculate(), each full word being entered in the peripheral
+  *         or in the software model.
+  * @param  hcrc CRC handle
+  * @param  pContext streaming context
+  * @param  pBuffer pointer to the input data buffer
+  * @param  First index of the first byte, half-word or word to enter
+  * @param  Last index following the last byte, half-word or word to enter
+  * @param  Soft 1 to use the software model, 0 to use the peripheral
+  * @retval None
+  */
+static void CRCEx_Context_Enter(CRC_HandleTypeDef *hcrc, CRC_ContextTypeDef *pContext, uint32_t pBuffer[],
+                                uint32_t First, uint32_t Last, uint32_t Soft)
+{
+  uint32_t size = CRCEx_Unit_Size(hcrc);
+  uint32_t index;
+  uint32_t data;
+
+  for (index = First; index < Last; index++)
+  {
+    if (size == 1U)
+    {
+      data = ((uint8_t *)pBuffer)[index];
+    }
+    else if (size == 2U)
+    {
+      data = ((uint16_t *)(void *)pBuffer)[index];    /* Derogation MisraC2012 R.11.5 */
+    }
+    else
+    {
+      data = pBuffer[index];
+    }
+
+    pContext->Pending = (size == 4U) ? data : ((pContext->Pending << (8U * size)) | data);
+    pContext->PendingCount++;
+
+    if ((pContext->PendingCount * size) == 4U)
+    {
+      if (Soft != 0U)
+      {
+        pContext->Crc = CRCEx_Soft_Write(hcrc, pContext->Crc, pContext->Pending, 32U);
+      }
+      else
+      {
+        hcrc->Instance->DR = pContext->Pending;
+      }
+      pContext->Pending = 0U;
+      pContext->PendingCount = 0U;
+    }
+  }
+}
+
+/**
+  * @brief  Load the CRC of a streaming context in the peripheral.
+  * @param  hcrc CRC handle
+  * @param  pContext streaming context
+  * @retval None
+  */
+static void CRCEx_Context_Restore(CRC_HandleTypeDef *hcrc, CRC_ContextTypeDef *pContext)
+{
+  /* Writing hcrc->Instance->INIT also loads hcrc->Instance->DR, the
+   * initialization value is set back by CRCEx_Context_Save() */
+  WRITE_REG(hcrc->Instance->INIT, pContext->Crc);
+}
+
+/**
+  * @brief  Save the CRC computed by the peripheral in a streaming context.
+  * @param  hcrc CRC handle
+  * @param  pContext streaming context
+  * @retval None
+  */
+static void CRCEx_Context_Save(CRC_HandleTypeDef *hcrc, CRC_ContextTypeDef *pContext)
+{
+  uint32_t cr = hcrc->Instance->CR;
+
+  /* The output inversion only applies to the data register reads */
+  CLEAR_BIT(hcrc->Instance->CR, CRC_CR_REV_OUT);
+  pContext->Crc = hcrc->Instance->DR;
+  MODIFY_REG(hcrc->Instance->CR, CRC_CR_REV_OUT, cr);
+
+  /* Set back the initialization value */
+  WRITE_REG(hcrc->Instance->INIT, CRCEx_Init_Value(hcrc));
+}
+
+/**
+  * @brief  Return the CRC initialization value configured in the handle.
+  * @param  hcrc CRC handle
+  * @retval Initialization value
+  */
+static uint32_t CRCEx_Init_Value(CRC_HandleTypeDef *hcrc)
+{
+  uint32_t init = DEFAULT_CRC_INITVALUE;
+
+  if (hcrc->Init.DefaultInitValueUse == DEFAULT_INIT_VALUE_DISABLE)
+  {
+    init = hcrc->Init.InitValue;
+  }
+
+  return init;
+}
 
 /**
   * @}
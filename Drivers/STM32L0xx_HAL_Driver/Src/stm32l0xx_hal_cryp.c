@@ -61,7 +61,11 @@
          processed buffer.
          When a new data block is to be processed, call HAL_CRYP_Init() then the
          processing function.
-         
+
+      (#)The authenticated modes AES-GCM, AES-CCM and AES-CMAC are provided by
+         the extended functions HAL_CRYPEx_AuthKey_Init() and HAL_CRYPEx_Auth_xxx(),
+         see stm32l0xx_hal_cryp_ex.c.
+
       (#)Call HAL_CRYP_DeInit() to deinitialize the CRYP peripheral.
 
   @endverbatim
@@ -193,6 +197,9 @@ HAL_StatusTypeDef HAL_CRYP_Init(CRYP_HandleTypeDef *hcryp)
     hcryp->CrypInCount = 0U;
     hcryp->CrypOutCount = 0U;
     
+    /* No authentication in progress */
+    hcryp->pAuthContext = NULL;
+    
     /* Change the CRYP state */
     hcryp->State = HAL_CRYP_STATE_READY;
     
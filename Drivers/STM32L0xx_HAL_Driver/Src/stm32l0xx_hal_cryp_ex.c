@@ -3,11 +3,58 @@
   * @file    stm32l0xx_hal_cryp_ex.c
   * @author  MCD Application Team
   * @brief   CRYPEx HAL module driver.
-  *    
-  *          This file provides firmware functions to manage the following 
+  *
+  *          This file provides firmware functions to manage the following
   *          functionalities of the Cryptography (CRYP) extension peripheral:
   *           + Computation completed callback.
-  *         
+  *           + Authenticated encryption: AES-GCM, AES-CCM and AES-CMAC.
+  *
+  @verbatim
+  ==============================================================================
+                     ##### How to use this driver #####
+  ==============================================================================
+    [..]
+      The AES peripheral has no authentication mode: GCM, CCM and CMAC are
+      built on its ECB, CBC and CTR chaining modes. GCM encrypts with the CTR
+      mode and computes GHASH by software, CCM and CMAC compute their CBC-MAC
+      with the CBC mode. Only the AES encryption is used, so the key never
+      needs to be derived for decryption.
+
+      (#)Initialize the CRYP HAL with HAL_CRYP_Init(), the key is pointed to by
+         Init.pKey. Init.DataType is not used: the messages are byte strings.
+
+      (#)Compute the values derived from the key with HAL_CRYPEx_AuthKey_Init().
+         They are kept in a CRYP_AuthKeyTypeDef structure shared by all the
+         messages using this key, so that no computation is repeated per message.
+
+      (#)Start a message on a CRYP_AuthContextTypeDef context with
+         HAL_CRYPEx_AESGCM_Start(), HAL_CRYPEx_AESCCM_Start() or
+         HAL_CRYPEx_AESCMAC_Start(). CCM needs the header, payload and tag
+         sizes at start.
+
+      (#)Give the additional authenticated data (GCM and CCM) with
+         HAL_CRYPEx_Auth_Header(), then the payload with HAL_CRYPEx_Auth_Update()
+         or HAL_CRYPEx_Auth_Update_DMA(). Both accept buffers of any length, the
+         result is the same as for the concatenated buffers. For CMAC the
+         message is given as payload, without output buffer.
+
+      (#)HAL_CRYPEx_Auth_Update_DMA() uses the two DMA channels of the handle as
+         HAL_CRYP_AESCTR_Encrypt_DMA() does. The end of the processing is
+         signaled by HAL_CRYPEx_ComputationCpltCallback(). The bytes completing
+         a partial block, the last block of a CBC-MAC and the GHASH of GCM are
+         computed by the CPU, the GHASH of the encrypted blocks in the DMA
+         interrupt.
+
+      (#)Get the tag with HAL_CRYPEx_Auth_Final(), or compare it with the
+         received one with HAL_CRYPEx_Auth_Verify(). A decrypted payload must
+         not be used before the tag is verified.
+
+      (#)Several contexts can be in progress at the same time: all their state
+         is in the context and the peripheral is configured again by each call.
+         These functions stop any processing started by the HAL_CRYP_AESxxx()
+         functions.
+
+  @endverbatim
   ******************************************************************************
   * @attention
   *
@@ -19,8 +66,8 @@
   * License. You may obtain a copy of the License at:
   *                        opensource.org/licenses/BSD-3-Clause
   *
-  ******************************************************************************  
-  */ 
+  ******************************************************************************
+  */
 
 #if defined (STM32L021xx) || defined (STM32L041xx) || defined (STM32L062xx) || defined (STM32L063xx) || defined (STM32L081xx) || defined (STM32L082xx) || defined (STM32L083xx)
 /* Includes ------------------------------------------------------------------*/
@@ -40,9 +87,87 @@
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
+
+/** @defgroup CRYPEx_Private CRYPEx Private
+  * @{
+  */
+
+#define CRYPEX_PHASE_HEADER       ((uint32_t)0x00000001U)  /* Header accepted             */
+#define CRYPEX_PHASE_PAYLOAD      ((uint32_t)0x00000002U)  /* Payload started             */
+#define CRYPEX_PHASE_FINAL        ((uint32_t)0x00000003U)  /* Tag computed                */
+
+/* Passes of the DMA over the blocks, the next ones in the upper bits of XferStep */
+#define CRYPEX_STEP_MAC           ((uint32_t)0x00000001U)  /* CBC-MAC of the blocks       */
+#define CRYPEX_STEP_CTR           ((uint32_t)0x00000002U)  /* CTR encryption of the blocks */
+#define CRYPEX_STEP_MASK          ((uint32_t)0x0000000FU)
+#define CRYPEX_STEP_SHIFT         4U
+
+#define CRYPEX_CR_MASK            (AES_CR_DATATYPE | CRYP_CR_ALGOMODE_DIRECTION | AES_CR_DMAINEN | AES_CR_DMAOUTEN)
+
+/**
+  * @}
+  */
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+
+/** @addtogroup CRYPEx_Private
+  * @{
+  */
+
+/* Reduction modulo the GCM polynomial of the four bits shifted out of GHASH */
+static const uint16_t CRYPEx_GHASH_Reduce[16] =
+{
+  0x0000U, 0x1C20U, 0x3840U, 0x2460U, 0x7080U, 0x6CA0U, 0x48C0U, 0x54E0U,
+  0xE100U, 0xFD20U, 0xD940U, 0xC560U, 0x9180U, 0x8DA0U, 0xA9C0U, 0xB5E0U
+};
+
+/**
+  * @}
+  */
+
 /* Private function prototypes -----------------------------------------------*/
+
+/** @addtogroup CRYPEx_Private
+  * @{
+  */
+
+static uint32_t           CRYPEx_ReadWord(const uint8_t *pData);
+static void               CRYPEx_WriteWord(uint8_t *pData, uint32_t Value);
+static void               CRYPEx_Configure(CRYP_HandleTypeDef *hcryp, const uint32_t *pKey, uint32_t Mode, const uint32_t *pInitVect);
+static void               CRYPEx_Release(CRYP_HandleTypeDef *hcryp);
+static HAL_StatusTypeDef  CRYPEx_Exit(CRYP_HandleTypeDef *hcryp, HAL_StatusTypeDef Status);
+static void               CRYPEx_WriteBlock(CRYP_HandleTypeDef *hcryp, const uint32_t *pBlock);
+static HAL_StatusTypeDef  CRYPEx_ReadBlock(CRYP_HandleTypeDef *hcryp, uint32_t *pBlock, uint32_t Timeout);
+static HAL_StatusTypeDef  CRYPEx_EncryptBlock(CRYP_HandleTypeDef *hcryp, const uint32_t *pKey, const uint32_t *pInput, uint32_t *pOutput, uint32_t Timeout);
+static void               CRYPEx_GHASH_Init(CRYP_AuthKeyTypeDef *pAuthKey, const uint32_t *pSubkey);
+static void               CRYPEx_GHASH(const CRYP_AuthKeyTypeDef *pAuthKey, uint32_t *pHash, const uint32_t *pBlock);
+static void               CRYPEx_GHASH_Bytes(const CRYP_AuthKeyTypeDef *pAuthKey, uint32_t *pHash, const uint8_t *pData, uint32_t Size);
+static void               CRYPEx_CMAC_Double(const uint32_t *pInput, uint32_t *pOutput);
+static void               CRYPEx_Context_Reset(CRYP_AuthContextTypeDef *pContext, const CRYP_AuthKeyTypeDef *pAuthKey, uint32_t Algorithm, uint32_t Direction);
+static HAL_StatusTypeDef  CRYPEx_Check_Payload(CRYP_AuthContextTypeDef *pContext, uint8_t *pInputData, uint16_t Size, uint8_t *pOutputData);
+static HAL_StatusTypeDef  CRYPEx_MAC_Blocks(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const uint8_t *pData, uint32_t Blocks, uint32_t Timeout);
+static HAL_StatusTypeDef  CRYPEx_CTR_Blocks(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const uint8_t *pInput, uint8_t *pOutput, uint32_t Blocks, uint32_t Timeout);
+static HAL_StatusTypeDef  CRYPEx_Keystream(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, uint32_t Timeout);
+static HAL_StatusTypeDef  CRYPEx_Auth_Block(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, uint32_t Timeout);
+static HAL_StatusTypeDef  CRYPEx_Auth_Bytes(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const uint8_t *pData, uint32_t Size, uint32_t Timeout);
+static HAL_StatusTypeDef  CRYPEx_Auth_Flush(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, uint32_t Timeout);
+static HAL_StatusTypeDef  CRYPEx_Payload_Bytes(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const uint8_t *pInput, uint8_t *pOutput, uint32_t Size, uint32_t Timeout);
+static HAL_StatusTypeDef  CRYPEx_Update_Head(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const uint8_t *pInput, uint8_t *pOutput, uint32_t Size, uint32_t *pHead, uint32_t Timeout);
+static HAL_StatusTypeDef  CRYPEx_Update_Blocks(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const uint8_t *pInput, uint8_t *pOutput, uint32_t Blocks, uint32_t Timeout);
+static HAL_StatusTypeDef  CRYPEx_Update_Tail(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const uint8_t *pInput, uint8_t *pOutput, uint32_t Size, uint32_t Timeout);
+static HAL_StatusTypeDef  CRYPEx_Tag(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, uint32_t *pTag, uint32_t Timeout);
+static uint32_t           CRYPEx_DMA_Step(CRYP_HandleTypeDef *hcryp, uint32_t *pInputAddr, uint32_t *pOutputAddr);
+static void               CRYPEx_DMA_StepEnd(CRYP_HandleTypeDef *hcryp);
+static HAL_StatusTypeDef  CRYPEx_DMA_Next(CRYP_HandleTypeDef *hcryp);
+static void               CRYPEx_DMA_Stop(CRYP_HandleTypeDef *hcryp);
+static void               CRYPEx_DMAOutCplt(DMA_HandleTypeDef *hdma);
+static void               CRYPEx_DMAError(DMA_HandleTypeDef *hdma);
+
+/**
+  * @}
+  */
+
 /* Private functions ---------------------------------------------------------*/
 
 /** @addtogroup CRYPEx_Exported_Functions
@@ -51,12 +176,12 @@
 
 
 /** @addtogroup CRYPEx_Exported_Functions_Group1
- *  @brief    Extended features functions. 
+ *  @brief    Extended features functions.
  *
-@verbatim   
+@verbatim
  ===============================================================================
                  ##### Extended features functions #####
- =============================================================================== 
+ ===============================================================================
     [..]  This section provides callback functions:
       (+) Computation completed.
 
@@ -77,26 +202,1739 @@ __weak void HAL_CRYPEx_ComputationCpltCallback(CRYP_HandleTypeDef *hcryp)
 
   /* NOTE : This function Should not be modified, when the callback is needed,
             the HAL_CRYP_ComputationCpltCallback could be implemented in the user file
-   */ 
+   */
 }
 
 /**
   * @}
   */
 
+/** @addtogroup CRYPEx_Exported_Functions_Group2
+ *  @brief    Authenticated encryption functions.
+ *
+@verbatim
+ ===============================================================================
+                 ##### Authenticated encryption functions #####
+ ===============================================================================
+    [..]  This section provides functions allowing to:
+      (+) Compute the values derived from a key
+      (+) Start an AES-GCM, AES-CCM or AES-CMAC message
+      (+) Authenticate a header
+      (+) Encrypt or decrypt and authenticate a payload, by polling or by DMA
+      (+) Compute or verify the tag
+
+@endverbatim
+  * @{
+  */
+
+/**
+  * @brief  Computes the values derived from the key pointed to by Init.pKey:
+  *         the GHASH table of GCM and the subkeys of CMAC.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pAuthKey Pointer to the structure receiving the derived values
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_CRYPEx_AuthKey_Init(CRYP_HandleTypeDef *hcryp, CRYP_AuthKeyTypeDef *pAuthKey, uint32_t Timeout)
+{
+  uint32_t zero[4] = {0U, 0U, 0U, 0U};
+  uint32_t subkey[4];
+  uint32_t index = 0U;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if((pAuthKey == NULL) || (hcryp->Init.pKey == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Process Locked */
+  __HAL_LOCK(hcryp);
+
+  if(hcryp->State != HAL_CRYP_STATE_READY)
+  {
+    /* Process Unlocked */
+    __HAL_UNLOCK(hcryp);
+
+    return HAL_ERROR;
+  }
+
+  /* Change the CRYP state */
+  hcryp->State = HAL_CRYP_STATE_BUSY;
+
+  for(index = 0U; index < 4U; index++)
+  {
+    pAuthKey->Key[index] = CRYPEx_ReadWord(&hcryp->Init.pKey[4U * index]);
+  }
+
+  /* The GCM hash subkey H and the CMAC value L are both the encryption of
+     the zero block */
+  status = CRYPEx_EncryptBlock(hcryp, pAuthKey->Key, zero, subkey, Timeout);
+  if(status == HAL_OK)
+  {
+    CRYPEx_GHASH_Init(pAuthKey, subkey);
+    CRYPEx_CMAC_Double(subkey, pAuthKey->Subkey1);
+    CRYPEx_CMAC_Double(pAuthKey->Subkey1, pAuthKey->Subkey2);
+  }
+
+  return CRYPEx_Exit(hcryp, status);
+}
+
+/**
+  * @brief  Starts an AES-GCM message.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  pAuthKey Pointer to the values derived from the key by HAL_CRYPEx_AuthKey_Init()
+  * @param  Direction CRYP_AUTH_ENCRYPT or CRYP_AUTH_DECRYPT
+  * @param  pInitVect Pointer to the initialization vector
+  * @param  IVSize Length of the initialization vector in bytes, 12 is recommended
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_CRYPEx_AESGCM_Start(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const CRYP_AuthKeyTypeDef *pAuthKey, uint32_t Direction, uint8_t *pInitVect, uint32_t IVSize, uint32_t Timeout)
+{
+  uint32_t block[4];
+  uint32_t index = 0U;
+
+  /* Check the parameters */
+  assert_param(IS_CRYP_AUTH_DIRECTION(Direction));
+
+  if((pContext == NULL) || (pAuthKey == NULL) || (pInitVect == NULL) || (IVSize == 0U) || (!IS_CRYP_AUTH_DIRECTION(Direction)))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Process Locked */
+  __HAL_LOCK(hcryp);
+
+  if(hcryp->State != HAL_CRYP_STATE_READY)
+  {
+    /* Process Unlocked */
+    __HAL_UNLOCK(hcryp);
+
+    return HAL_ERROR;
+  }
+
+  /* Change the CRYP state */
+  hcryp->State = HAL_CRYP_STATE_BUSY;
+
+  CRYPEx_Context_Reset(pContext, pAuthKey, CRYP_AUTH_GCM, Direction);
+
+  /* Pre-counter block J0 */
+  if(IVSize == 12U)
+  {
+    for(index = 0U; index < 3U; index++)
+    {
+      pContext->Counter[index] = CRYPEx_ReadWord(&pInitVect[4U * index]);
+    }
+    pContext->Counter[3] = 1U;
+  }
+  else
+  {
+    /* J0 = GHASH(IV || padding || 64-bit length of IV in bits) */
+    CRYPEx_GHASH_Bytes(pAuthKey, pContext->Mac, pInitVect, IVSize);
+    block[0] = 0U;
+    block[1] = 0U;
+    block[2] = IVSize >> 29U;
+    block[3] = IVSize << 3U;
+    CRYPEx_GHASH(pAuthKey, pContext->Mac, block);
+
+    for(index = 0U; index < 4U; index++)
+    {
+      pContext->Counter[index] = pContext->Mac[index];
+      pContext->Mac[index] = 0U;
+    }
+  }
+
+  /* The tag is masked with the encryption of J0, the payload starts at J0 + 1 */
+  pContext->Counter[3]++;
+  for(index = 0U; index < 4U; index++)
+  {
+    block[index] = pContext->Counter[index];
+  }
+  block[3]--;
+
+  return CRYPEx_Exit(hcryp, CRYPEx_EncryptBlock(hcryp, pAuthKey->Key, block, pContext->TagMask, Timeout));
+}
+
+/**
+  * @brief  Starts an AES-CCM message.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  pAuthKey Pointer to the values derived from the key by HAL_CRYPEx_AuthKey_Init()
+  * @param  Direction CRYP_AUTH_ENCRYPT or CRYP_AUTH_DECRYPT
+  * @param  pNonce Pointer to the nonce
+  * @param  NonceSize Length of the nonce in bytes, from 7 to 13
+  * @param  HeaderSize Total length of the header in bytes
+  * @param  PayloadSize Total length of the payload in bytes
+  * @param  TagSize Length of the tag in bytes: 4, 6, 8, 10, 12, 14 or 16
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_CRYPEx_AESCCM_Start(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const CRYP_AuthKeyTypeDef *pAuthKey, uint32_t Direction, uint8_t *pNonce, uint32_t NonceSize, uint32_t HeaderSize, uint32_t PayloadSize, uint32_t TagSize, uint32_t Timeout)
+{
+  uint32_t lengthsize = 15U - NonceSize;
+  uint32_t index = 0U;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  /* Check the parameters */
+  assert_param(IS_CRYP_AUTH_DIRECTION(Direction));
+
+  if((pContext == NULL) || (pAuthKey == NULL) || (pNonce == NULL) || (!IS_CRYP_AUTH_DIRECTION(Direction)) ||
+     (NonceSize < 7U) || (NonceSize > 13U) || (TagSize < 4U) || (TagSize > 16U) || ((TagSize & 1U) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  /* The payload length must fit in the 15 - NonceSize bytes left by the nonce */
+  if((lengthsize < 4U) && ((PayloadSize >> (8U * lengthsize)) != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Process Locked */
+  __HAL_LOCK(hcryp);
+
+  if(hcryp->State != HAL_CRYP_STATE_READY)
+  {
+    /* Process Unlocked */
+    __HAL_UNLOCK(hcryp);
+
+    return HAL_ERROR;
+  }
+
+  /* Change the CRYP state */
+  hcryp->State = HAL_CRYP_STATE_BUSY;
+
+  CRYPEx_Context_Reset(pContext, pAuthKey, CRYP_AUTH_CCM, Direction);
+  pContext->HeaderSize = HeaderSize;
+  pContext->PayloadSize = PayloadSize;
+  pContext->TagSize = TagSize;
+
+  /* First block B0: flags, nonce and payload length */
+  pContext->Block[0] = (uint8_t)((((TagSize - 2U) / 2U) << 3U) | (lengthsize - 1U));
+  if(HeaderSize != 0U)
+  {
+    pContext->Block[0] |= 0x40U;
+  }
+  for(index = 0U; index < NonceSize; index++)
+  {
+    pContext->Block[1U + index] = pNonce[index];
+  }
+  for(index = 0U; index < lengthsize; index++)
+  {
+    pContext->Block[15U - index] = (index < 4U) ? (uint8_t)(PayloadSize >> (8U * index)) : 0U;
+  }
+  status = CRYPEx_MAC_Blocks(hcryp, pContext, pContext->Block, 1U, Timeout);
+
+  /* Counter block 0, whose encryption masks the tag, the payload starts at 1 */
+  if(status == HAL_OK)
+  {
+    pContext->Block[0] = (uint8_t)(lengthsize - 1U);
+    for(index = NonceSize + 1U; index < 16U; index++)
+    {
+      pContext->Block[index] = 0U;
+    }
+    for(index = 0U; index < 4U; index++)
+    {
+      pContext->Counter[index] = CRYPEx_ReadWord(&pContext->Block[4U * index]);
+    }
+    status = CRYPEx_EncryptBlock(hcryp, pAuthKey->Key, pContext->Counter, pContext->TagMask, Timeout);
+    pContext->Counter[3]++;
+  }
+
+  /* The header starts with its length */
+  if(HeaderSize == 0U)
+  {
+    pContext->BlockCount = 0U;
+  }
+  else if(HeaderSize < 0xFF00U)
+  {
+    pContext->Block[0] = (uint8_t)(HeaderSize >> 8U);
+    pContext->Block[1] = (uint8_t)HeaderSize;
+    pContext->BlockCount = 2U;
+  }
+  else
+  {
+    pContext->Block[0] = 0xFFU;
+    pContext->Block[1] = 0xFEU;
+    CRYPEx_WriteWord(&pContext->Block[2], HeaderSize);
+    pContext->BlockCount = 6U;
+  }
+
+  return CRYPEx_Exit(hcryp, status);
+}
+
+/**
+  * @brief  Starts an AES-CMAC message.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  pAuthKey Pointer to the values derived from the key by HAL_CRYPEx_AuthKey_Init()
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_CRYPEx_AESCMAC_Start(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const CRYP_AuthKeyTypeDef *pAuthKey)
+{
+  if((pContext == NULL) || (pAuthKey == NULL) || (hcryp->State == HAL_CRYP_STATE_RESET))
+  {
+    return HAL_ERROR;
+  }
+
+  /* The message is given as payload */
+  CRYPEx_Context_Reset(pContext, pAuthKey, CRYP_AUTH_CMAC, CRYP_AUTH_ENCRYPT);
+  pContext->Phase = CRYPEX_PHASE_PAYLOAD;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Authenticates a part of the header (additional authenticated data)
+  *         of a GCM or CCM message. It must be called before the payload.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  pHeader Pointer to the header buffer
+  * @param  Size Length of the header buffer in bytes
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_CRYPEx_Auth_Header(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, uint8_t *pHeader, uint16_t Size, uint32_t Timeout)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if((pContext == NULL) || ((pHeader == NULL) && (Size != 0U)) || (pContext->Phase != CRYPEX_PHASE_HEADER) ||
+     ((pContext->Algorithm == CRYP_AUTH_CCM) && ((pContext->HeaderSize - pContext->HeaderCount) < Size)))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Process Locked */
+  __HAL_LOCK(hcryp);
+
+  if(hcryp->State != HAL_CRYP_STATE_READY)
+  {
+    /* Process Unlocked */
+    __HAL_UNLOCK(hcryp);
+
+    return HAL_ERROR;
+  }
+
+  /* Change the CRYP state */
+  hcryp->State = HAL_CRYP_STATE_BUSY;
+
+  status = CRYPEx_Auth_Bytes(hcryp, pContext, pHeader, Size, Timeout);
+  pContext->HeaderCount += Size;
+
+  return CRYPEx_Exit(hcryp, status);
+}
+
+/**
+  * @brief  Encrypts or decrypts and authenticates a part of the payload in
+  *         polling mode. For CMAC, authenticates a part of the message.
+  * @note   The GHASH of GCM is computed while the peripheral encrypts the
+  *         next block.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  pInputData Pointer to the input buffer, no alignment is required
+  * @param  Size Length of the input buffer in bytes
+  * @param  pOutputData Pointer to the output buffer, which can be the input
+  *         buffer. Not used for CMAC.
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_CRYPEx_Auth_Update(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, uint8_t *pInputData, uint16_t Size, uint8_t *pOutputData, uint32_t Timeout)
+{
+  uint32_t head = 0U;
+  uint32_t blocks = 0U;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if(CRYPEx_Check_Payload(pContext, pInputData, Size, pOutputData) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+
+  /* Process Locked */
+  __HAL_LOCK(hcryp);
+
+  if(hcryp->State != HAL_CRYP_STATE_READY)
+  {
+    /* Process Unlocked */
+    __HAL_UNLOCK(hcryp);
+
+    return HAL_ERROR;
+  }
+
+  /* Change the CRYP state */
+  hcryp->State = HAL_CRYP_STATE_BUSY;
+
+  status = CRYPEx_Update_Head(hcryp, pContext, pInputData, pOutputData, Size, &head, Timeout);
+  pContext->PayloadCount += Size;
+
+  if(status == HAL_OK)
+  {
+    blocks = pContext->XferBlocks;
+    status = CRYPEx_Update_Blocks(hcryp, pContext, &pInputData[head], &pOutputData[head], blocks, Timeout);
+  }
+  if(status == HAL_OK)
+  {
+    head += 16U * blocks;
+    status = CRYPEx_Update_Tail(hcryp, pContext, &pInputData[head], &pOutputData[head], pContext->XferTail, Timeout);
+  }
+
+  return CRYPEx_Exit(hcryp, status);
+}
+
+/**
+  * @brief  Encrypts or decrypts and authenticates a part of the payload using
+  *         DMA. For CMAC, authenticates a part of the message.
+  * @note   The end of the processing is signaled by HAL_CRYPEx_ComputationCpltCallback().
+  *         The input and output buffers must stay untouched until then.
+  * @note   The blocks are transferred by DMA when both buffers are aligned on
+  *         u32 after the bytes completing the previous partial block, else they
+  *         are processed by the CPU before this function returns.
+  * @note   For CCM the DMA runs twice over the blocks, once in CBC mode for
+  *         the CBC-MAC and once in CTR mode. For GCM the GHASH of the blocks
+  *         is computed in the DMA interrupt when encrypting, and before the
+  *         transfer starts when decrypting.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  pInputData Pointer to the input buffer
+  * @param  Size Length of the input buffer in bytes
+  * @param  pOutputData Pointer to the output buffer, which can be the input
+  *         buffer. Not used for CMAC.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_CRYPEx_Auth_Update_DMA(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, uint8_t *pInputData, uint16_t Size, uint8_t *pOutputData)
+{
+  uint32_t head = 0U;
+  uint32_t blocks = 0U;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if((hcryp->hdmain == NULL) || (hcryp->hdmaout == NULL) || (CRYPEx_Check_Payload(pContext, pInputData, Size, pOutputData) != HAL_OK))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Process Locked */
+  __HAL_LOCK(hcryp);
+
+  if(hcryp->State != HAL_CRYP_STATE_READY)
+  {
+    /* Process Unlocked */
+    __HAL_UNLOCK(hcryp);
+
+    return HAL_ERROR;
+  }
+
+  /* Change the CRYP state */
+  hcryp->State = HAL_CRYP_STATE_BUSY;
+
+  /* The peripheral needs no wait to end the computation of a block, so
+     HAL_MAX_DELAY is used when the CPU processes blocks under interrupt */
+  status = CRYPEx_Update_Head(hcryp, pContext, pInputData, pOutputData, Size, &head, HAL_MAX_DELAY);
+  pContext->PayloadCount += Size;
+
+  if(status != HAL_OK)
+  {
+    return CRYPEx_Exit(hcryp, status);
+  }
+
+  blocks = pContext->XferBlocks;
+  hcryp->pCrypInBuffPtr = &pInputData[head];
+  hcryp->pCrypOutBuffPtr = (pOutputData != NULL) ? &pOutputData[head] : NULL;
+
+  if((blocks == 0U) || ((((uint32_t)hcryp->pCrypInBuffPtr | (uint32_t)hcryp->pCrypOutBuffPtr) & 0x00000003U) != 0U))
+  {
+    /* Nothing for the DMA: the CPU processes the blocks */
+    status = CRYPEx_Update_Blocks(hcryp, pContext, hcryp->pCrypInBuffPtr, hcryp->pCrypOutBuffPtr, blocks, HAL_MAX_DELAY);
+    if(status == HAL_OK)
+    {
+      head += 16U * blocks;
+      status = CRYPEx_Update_Tail(hcryp, pContext, &pInputData[head], (pOutputData != NULL) ? &pOutputData[head] : NULL, pContext->XferTail, HAL_MAX_DELAY);
+    }
+    status = CRYPEx_Exit(hcryp, status);
+    if(status == HAL_OK)
+    {
+      HAL_CRYPEx_ComputationCpltCallback(hcryp);
+    }
+    return status;
+  }
+
+  /* CCM authenticates the plaintext, so the CBC-MAC runs first when
+     encrypting and last when decrypting */
+  if(pContext->Algorithm == CRYP_AUTH_GCM)
+  {
+    pContext->XferStep = CRYPEX_STEP_CTR;
+  }
+  else if(pContext->Algorithm == CRYP_AUTH_CMAC)
+  {
+    pContext->XferStep = CRYPEX_STEP_MAC;
+  }
+  else if(pContext->Direction == CRYP_AUTH_ENCRYPT)
+  {
+    pContext->XferStep = CRYPEX_STEP_MAC | (CRYPEX_STEP_CTR << CRYPEX_STEP_SHIFT);
+  }
+  else
+  {
+    pContext->XferStep = CRYPEX_STEP_CTR | (CRYPEX_STEP_MAC << CRYPEX_STEP_SHIFT);
+  }
+  hcryp->pAuthContext = pContext;
+
+  /* Set the DMA callbacks */
+  hcryp->hdmain->XferCpltCallback = NULL;
+  hcryp->hdmain->XferErrorCallback = CRYPEx_DMAError;
+  hcryp->hdmaout->XferCpltCallback = CRYPEx_DMAOutCplt;
+  hcryp->hdmaout->XferErrorCallback = CRYPEx_DMAError;
+
+  /* Process Unlocked */
+  __HAL_UNLOCK(hcryp);
+
+  if(CRYPEx_DMA_Next(hcryp) != HAL_OK)
+  {
+    CRYPEx_DMA_Stop(hcryp);
+    hcryp->pAuthContext = NULL;
+    hcryp->State = HAL_CRYP_STATE_READY;
+    return HAL_ERROR;
+  }
+
+  /* Return function status */
+  return HAL_OK;
+}
+
+/**
+  * @brief  Ends a message and computes its tag.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  pTag Pointer to the tag buffer
+  * @param  TagSize Length of the tag in bytes, at most 16. For CCM it must be
+  *         the size given at start.
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_CRYPEx_Auth_Final(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, uint8_t *pTag, uint32_t TagSize, uint32_t Timeout)
+{
+  uint32_t tag[4];
+  uint8_t bytes[16];
+  uint32_t index = 0U;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if((pContext == NULL) || (pTag == NULL) || (TagSize == 0U) || (TagSize > 16U))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Process Locked */
+  __HAL_LOCK(hcryp);
+
+  if(hcryp->State != HAL_CRYP_STATE_READY)
+  {
+    /* Process Unlocked */
+    __HAL_UNLOCK(hcryp);
+
+    return HAL_ERROR;
+  }
+
+  /* Change the CRYP state */
+  hcryp->State = HAL_CRYP_STATE_BUSY;
+
+  if((pContext->Algorithm == CRYP_AUTH_CCM) && (TagSize != pContext->TagSize))
+  {
+    status = HAL_ERROR;
+  }
+  else
+  {
+    status = CRYPEx_Tag(hcryp, pContext, tag, Timeout);
+  }
+
+  if(status == HAL_OK)
+  {
+    for(index = 0U; index < 4U; index++)
+    {
+      CRYPEx_WriteWord(&bytes[4U * index], tag[index]);
+    }
+    for(index = 0U; index < TagSize; index++)
+    {
+      pTag[index] = bytes[index];
+    }
+  }
+
+  return CRYPEx_Exit(hcryp, status);
+}
+
+/**
+  * @brief  Ends a message and compares its tag with the expected one.
+  * @note   The comparison time does not depend on the tag values.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  pTag Pointer to the expected tag
+  * @param  TagSize Length of the tag in bytes, at most 16. For CCM it must be
+  *         the size given at start.
+  * @param  Timeout Specify Timeout value
+  * @retval HAL_OK if the tags are equal, HAL_ERROR if they differ
+  */
+HAL_StatusTypeDef HAL_CRYPEx_Auth_Verify(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, uint8_t *pTag, uint32_t TagSize, uint32_t Timeout)
+{
+  uint8_t tag[16];
+  uint32_t difference = 0U;
+  uint32_t index = 0U;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if((pTag == NULL) || (TagSize == 0U) || (TagSize > 16U))
+  {
+    return HAL_ERROR;
+  }
+
+  status = HAL_CRYPEx_Auth_Final(hcryp, pContext, tag, TagSize, Timeout);
+
+  if(status == HAL_OK)
+  {
+    for(index = 0U; index < TagSize; index++)
+    {
+      difference |= (uint32_t)tag[index] ^ (uint32_t)pTag[index];
+    }
+    if(difference != 0U)
+    {
+      status = HAL_ERROR;
+    }
+  }
+
+  return status;
+}
 
 /**
   * @}
   */
+
 /**
   * @}
   */
 
-#endif /* HAL_CRYP_MODULE_ENABLED */
+/** @addtogroup CRYPEx_Private
+  * @{
+  */
 
 /**
-  * @}
+  * @brief  Reads four bytes as a big endian word.
+  * @param  pData Pointer to the bytes
+  * @retval Word
   */
-#endif /* STM32L021xx || STM32L041xx || STM32L062xx || STM32L063xx || STM32L081xx || STM32L082xx || STM32L083xx */
-/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
+static uint32_t CRYPEx_ReadWord(const uint8_t *pData)
+{
+  return ((uint32_t)pData[0] << 24U) | ((uint32_t)pData[1] << 16U) | ((uint32_t)pData[2] << 8U) | (uint32_t)pData[3];
+}
+
+/**
+  * @brief  Writes a word as four big endian bytes.
+  * @param  pData Pointer to the bytes
+  * @param  Value Word
+  * @retval None
+  */
+static void CRYPEx_WriteWord(uint8_t *pData, uint32_t Value)
+{
+  pData[0] = (uint8_t)(Value >> 24U);
+  pData[1] = (uint8_t)(Value >> 16U);
+  pData[2] = (uint8_t)(Value >> 8U);
+  pData[3] = (uint8_t)Value;
+}
+
+/**
+  * @brief  Configures the peripheral for a chaining mode. It is left disabled.
+  * @note   The data type is set to 8-bit so that the DMA can move byte strings;
+  *         the words written by the CPU are swapped accordingly.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pKey Pointer to the key words
+  * @param  Mode Chaining mode, a value of @ref CRYP_AlgoModeDirection
+  * @param  pInitVect Pointer to the initialization vector or counter words,
+  *         NULL in ECB mode
+  * @retval None
+  */
+static void CRYPEx_Configure(CRYP_HandleTypeDef *hcryp, const uint32_t *pKey, uint32_t Mode, const uint32_t *pInitVect)
+{
+  /* The configuration can only be changed while the AES is disabled */
+  __HAL_CRYP_DISABLE(hcryp);
+
+  MODIFY_REG(hcryp->Instance->CR, CRYPEX_CR_MASK, CRYP_DATATYPE_8B | Mode);
+
+  hcryp->Instance->KEYR3 = pKey[0];
+  hcryp->Instance->KEYR2 = pKey[1];
+  hcryp->Instance->KEYR1 = pKey[2];
+  hcryp->Instance->KEYR0 = pKey[3];
+
+  if(pInitVect != NULL)
+  {
+    hcryp->Instance->IVR3 = pInitVect[0];
+    hcryp->Instance->IVR2 = pInitVect[1];
+    hcryp->Instance->IVR1 = pInitVect[2];
+    hcryp->Instance->IVR0 = pInitVect[3];
+  }
+}
+
+/**
+  * @brief  Disables the peripheral and restores the configuration expected
+  *         by the HAL_CRYP_AESxxx() functions.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @retval None
+  */
+static void CRYPEx_Release(CRYP_HandleTypeDef *hcryp)
+{
+  __HAL_CRYP_DISABLE(hcryp);
+
+  MODIFY_REG(hcryp->Instance->CR, CRYPEX_CR_MASK, hcryp->Init.DataType);
+
+  /* The next HAL_CRYP_AESxxx() call configures the peripheral again */
+  hcryp->Phase = HAL_CRYP_PHASE_READY;
+}
+
+/**
+  * @brief  Ends a polling mode function.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  Status Status of the processing
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRYPEx_Exit(CRYP_HandleTypeDef *hcryp, HAL_StatusTypeDef Status)
+{
+  CRYPEx_Release(hcryp);
+
+  /* Change the CRYP state */
+  hcryp->State = (Status == HAL_TIMEOUT) ? HAL_CRYP_STATE_TIMEOUT : HAL_CRYP_STATE_READY;
+
+  /* Process Unlocked */
+  __HAL_UNLOCK(hcryp);
+
+  return Status;
+}
+
+/**
+  * @brief  Writes a block in the Data Input register.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pBlock Pointer to the block words
+  * @retval None
+  */
+static void CRYPEx_WriteBlock(CRYP_HandleTypeDef *hcryp, const uint32_t *pBlock)
+{
+  hcryp->Instance->DINR = __REV(pBlock[0]);
+  hcryp->Instance->DINR = __REV(pBlock[1]);
+  hcryp->Instance->DINR = __REV(pBlock[2]);
+  hcryp->Instance->DINR = __REV(pBlock[3]);
+}
+
+/**
+  * @brief  Waits for the end of the computation and reads a block from the
+  *         Data Output register.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pBlock Pointer to the block words
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRYPEx_ReadBlock(CRYP_HandleTypeDef *hcryp, uint32_t *pBlock, uint32_t Timeout)
+{
+  uint32_t tickstart = HAL_GetTick();
+
+  while(HAL_IS_BIT_CLR(hcryp->Instance->SR, AES_SR_CCF))
+  {
+    /* Check for the Timeout */
+    if(Timeout != HAL_MAX_DELAY)
+    {
+      if((Timeout == 0U)||((HAL_GetTick() - tickstart ) > Timeout))
+      {
+        return HAL_TIMEOUT;
+      }
+    }
+  }
 
+  /* Clear CCF Flag */
+  __HAL_CRYP_CLEAR_FLAG(hcryp, CRYP_CLEARFLAG_CCF);
+
+  pBlock[0] = __REV(hcryp->Instance->DOUTR);
+  pBlock[1] = __REV(hcryp->Instance->DOUTR);
+  pBlock[2] = __REV(hcryp->Instance->DOUTR);
+  pBlock[3] = __REV(hcryp->Instance->DOUTR);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Encrypts one block in ECB mode.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pKey Pointer to the key words
+  * @param  pInput Pointer to the input block words
+  * @param  pOutput Pointer to the output block words
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRYPEx_EncryptBlock(CRYP_HandleTypeDef *hcryp, const uint32_t *pKey, const uint32_t *pInput, uint32_t *pOutput, uint32_t Timeout)
+{
+  CRYPEx_Configure(hcryp, pKey, CRYP_CR_ALGOMODE_AES_ECB_ENCRYPT, NULL);
+  __HAL_CRYP_ENABLE(hcryp);
+
+  CRYPEx_WriteBlock(hcryp, pInput);
+
+  return CRYPEx_ReadBlock(hcryp, pOutput, Timeout);
+}
+
+/**
+  * @brief  Computes the GHASH table: the products of the hash subkey H by
+  *         all the polynomials of degree lower than 4.
+  * @note   GCM numbers the bits from the most significant one, so entry 8
+  *         holds H, entry 4 H.x, entry 2 H.x^2 and entry 1 H.x^3.
+  * @param  pAuthKey Pointer to the structure receiving the table
+  * @param  pSubkey Pointer to the hash subkey H
+  * @retval None
+  */
+static void CRYPEx_GHASH_Init(CRYP_AuthKeyTypeDef *pAuthKey, const uint32_t *pSubkey)
+{
+  uint32_t index = 0U;
+  uint32_t entry = 0U;
+  uint32_t word = 0U;
+
+  for(word = 0U; word < 4U; word++)
+  {
+    pAuthKey->HashTable[0][word] = 0U;
+    pAuthKey->HashTable[8][word] = pSubkey[word];
+  }
+
+  /* Multiplication by x: shift right, reduced by x^128 + x^7 + x^2 + x + 1 */
+  for(index = 4U; index > 0U; index >>= 1U)
+  {
+    const uint32_t *previous = pAuthKey->HashTable[2U * index];
+
+    pAuthKey->HashTable[index][3] = (previous[3] >> 1U) | (previous[2] << 31U);
+    pAuthKey->HashTable[index][2] = (previous[2] >> 1U) | (previous[1] << 31U);
+    pAuthKey->HashTable[index][1] = (previous[1] >> 1U) | (previous[0] << 31U);
+    pAuthKey->HashTable[index][0] = (previous[0] >> 1U) ^ (((previous[3] & 1U) != 0U) ? 0xE1000000U : 0U);
+  }
+
+  for(index = 2U; index <= 8U; index <<= 1U)
+  {
+    for(entry = 1U; entry < index; entry++)
+    {
+      for(word = 0U; word < 4U; word++)
+      {
+        pAuthKey->HashTable[index + entry][word] = pAuthKey->HashTable[index][word] ^ pAuthKey->HashTable[entry][word];
+      }
+    }
+  }
+}
+
+/**
+  * @brief  Adds a block to a GHASH: Hash = (Hash ^ Block) . H
+  * @param  pAuthKey Pointer to the GHASH table
+  * @param  pHash Pointer to the GHASH words
+  * @param  pBlock Pointer to the block words
+  * @retval None
+  */
+static void CRYPEx_GHASH(const CRYP_AuthKeyTypeDef *pAuthKey, uint32_t *pHash, const uint32_t *pBlock)
+{
+  const uint32_t *entry;
+  uint32_t x[4];
+  uint32_t z0 = 0U, z1 = 0U, z2 = 0U, z3 = 0U;
+  uint32_t index = 0U;
+  uint32_t remainder = 0U;
+
+  for(index = 0U; index < 4U; index++)
+  {
+    x[index] = pHash[index] ^ pBlock[index];
+  }
+
+  /* Horner's rule on the 4-bit digits of X, from the last one:
+     Z = Z.x^4 + digit.H */
+  for(index = 0U; index < 32U; index++)
+  {
+    remainder = z3 & 0xFU;
+    z3 = (z3 >> 4U) | (z2 << 28U);
+    z2 = (z2 >> 4U) | (z1 << 28U);
+    z1 = (z1 >> 4U) | (z0 << 28U);
+    z0 = (z0 >> 4U) ^ ((uint32_t)CRYPEx_GHASH_Reduce[remainder] << 16U);
+
+    entry = pAuthKey->HashTable[(x[3U - (index >> 3U)] >> (4U * (index & 7U))) & 0xFU];
+    z0 ^= entry[0];
+    z1 ^= entry[1];
+    z2 ^= entry[2];
+    z3 ^= entry[3];
+  }
+
+  pHash[0] = z0;
+  pHash[1] = z1;
+  pHash[2] = z2;
+  pHash[3] = z3;
+}
+
+/**
+  * @brief  Adds bytes to a GHASH, the last block being padded with zeros.
+  * @param  pAuthKey Pointer to the GHASH table
+  * @param  pHash Pointer to the GHASH words
+  * @param  pData Pointer to the bytes
+  * @param  Size Number of bytes
+  * @retval None
+  */
+static void CRYPEx_GHASH_Bytes(const CRYP_AuthKeyTypeDef *pAuthKey, uint32_t *pHash, const uint8_t *pData, uint32_t Size)
+{
+  uint8_t bytes[16];
+  uint32_t block[4];
+  uint32_t offset = 0U;
+  uint32_t index = 0U;
+
+  for(offset = 0U; offset < Size; offset += 16U)
+  {
+    for(index = 0U; index < 16U; index++)
+    {
+      bytes[index] = ((offset + index) < Size) ? pData[offset + index] : 0U;
+    }
+    for(index = 0U; index < 4U; index++)
+    {
+      block[index] = CRYPEx_ReadWord(&bytes[4U * index]);
+    }
+    CRYPEx_GHASH(pAuthKey, pHash, block);
+  }
+}
+
+/**
+  * @brief  Doubles a value in GF(2^128) for the CMAC subkeys.
+  * @param  pInput Pointer to the value
+  * @param  pOutput Pointer to the doubled value
+  * @retval None
+  */
+static void CRYPEx_CMAC_Double(const uint32_t *pInput, uint32_t *pOutput)
+{
+  uint32_t carry = pInput[0] >> 31U;
+
+  pOutput[0] = (pInput[0] << 1U) | (pInput[1] >> 31U);
+  pOutput[1] = (pInput[1] << 1U) | (pInput[2] >> 31U);
+  pOutput[2] = (pInput[2] << 1U) | (pInput[3] >> 31U);
+  pOutput[3] = (pInput[3] << 1U) ^ ((carry != 0U) ? 0x87U : 0U);
+}
+
+/**
+  * @brief  Initializes a context for a new message.
+  * @param  pContext Pointer to the context
+  * @param  pAuthKey Pointer to the values derived from the key
+  * @param  Algorithm Algorithm, a value of @ref CRYPEx_Authentication_Algorithm
+  * @param  Direction Direction, a value of @ref CRYPEx_Authentication_Direction
+  * @retval None
+  */
+static void CRYPEx_Context_Reset(CRYP_AuthContextTypeDef *pContext, const CRYP_AuthKeyTypeDef *pAuthKey, uint32_t Algorithm, uint32_t Direction)
+{
+  uint32_t index = 0U;
+
+  pContext->pAuthKey = pAuthKey;
+  pContext->Algorithm = Algorithm;
+  pContext->Direction = Direction;
+  pContext->Phase = CRYPEX_PHASE_HEADER;
+  pContext->HeaderSize = 0U;
+  pContext->PayloadSize = 0U;
+  pContext->TagSize = 16U;
+  pContext->HeaderCount = 0U;
+  pContext->PayloadCount = 0U;
+  pContext->BlockCount = 0U;
+  pContext->XferBlocks = 0U;
+  pContext->XferTail = 0U;
+  pContext->XferStep = 0U;
+
+  for(index = 0U; index < 4U; index++)
+  {
+    pContext->Mac[index] = 0U;
+  }
+}
+
+/**
+  * @brief  Checks the parameters of a payload update.
+  * @param  pContext Pointer to the context of the message
+  * @param  pInputData Pointer to the input buffer
+  * @param  Size Length of the input buffer in bytes
+  * @param  pOutputData Pointer to the output buffer
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRYPEx_Check_Payload(CRYP_AuthContextTypeDef *pContext, uint8_t *pInputData, uint16_t Size, uint8_t *pOutputData)
+{
+  if((pContext == NULL) || ((pInputData == NULL) && (Size != 0U)))
+  {
+    return HAL_ERROR;
+  }
+
+  if((pContext->Phase != CRYPEX_PHASE_HEADER) && (pContext->Phase != CRYPEX_PHASE_PAYLOAD))
+  {
+    return HAL_ERROR;
+  }
+
+  if((pContext->Algorithm != CRYP_AUTH_CMAC) && (pOutputData == NULL) && (Size != 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  /* CCM: the header must be complete and the payload must not exceed the size given at start */
+  if((pContext->Algorithm == CRYP_AUTH_CCM) &&
+     ((pContext->HeaderCount != pContext->HeaderSize) || ((pContext->PayloadSize - pContext->PayloadCount) < Size)))
+  {
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Authenticates whole blocks with a CBC-MAC, by the CPU.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  pData Pointer to the blocks
+  * @param  Blocks Number of blocks
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRYPEx_MAC_Blocks(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const uint8_t *pData, uint32_t Blocks, uint32_t Timeout)
+{
+  uint32_t block[4];
+  uint32_t index = 0U;
+  uint32_t word = 0U;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  /* CBC encryption chained to the current MAC, only the last output is kept */
+  CRYPEx_Configure(hcryp, pContext->pAuthKey->Key, CRYP_CR_ALGOMODE_AES_CBC_ENCRYPT, pContext->Mac);
+  __HAL_CRYP_ENABLE(hcryp);
+
+  for(index = 0U; (index < Blocks) && (status == HAL_OK); index++)
+  {
+    for(word = 0U; word < 4U; word++)
+    {
+      block[word] = CRYPEx_ReadWord(&pData[(16U * index) + (4U * word)]);
+    }
+    CRYPEx_WriteBlock(hcryp, block);
+    status = CRYPEx_ReadBlock(hcryp, pContext->Mac, Timeout);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Encrypts or decrypts whole blocks in CTR mode, by the CPU. For GCM
+  *         the ciphertext is added to the GHASH while the peripheral computes
+  *         the next block.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  pInput Pointer to the input blocks
+  * @param  pOutput Pointer to the output blocks
+  * @param  Blocks Number of blocks
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRYPEx_CTR_Blocks(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const uint8_t *pInput, uint8_t *pOutput, uint32_t Blocks, uint32_t Timeout)
+{
+  uint32_t input[4];
+  uint32_t output[4];
+  uint32_t index = 0U;
+  uint32_t word = 0U;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  CRYPEx_Configure(hcryp, pContext->pAuthKey->Key, CRYP_CR_ALGOMODE_AES_CTR_ENCRYPT, pContext->Counter);
+  __HAL_CRYP_ENABLE(hcryp);
+
+  for(index = 0U; (index < Blocks) && (status == HAL_OK); index++)
+  {
+    for(word = 0U; word < 4U; word++)
+    {
+      input[word] = CRYPEx_ReadWord(&pInput[(16U * index) + (4U * word)]);
+    }
+    CRYPEx_WriteBlock(hcryp, input);
+
+    if(pContext->Algorithm == CRYP_AUTH_GCM)
+    {
+      if(pContext->Direction == CRYP_AUTH_DECRYPT)
+      {
+        CRYPEx_GHASH(pContext->pAuthKey, pContext->Mac, input);
+      }
+      else if(index != 0U)
+      {
+        /* Ciphertext of the previous block */
+        CRYPEx_GHASH(pContext->pAuthKey, pContext->Mac, output);
+      }
+      else
+      {
+        /* Nothing to hash yet */
+      }
+    }
+
+    status = CRYPEx_ReadBlock(hcryp, output, Timeout);
+    for(word = 0U; word < 4U; word++)
+    {
+      CRYPEx_WriteWord(&pOutput[(16U * index) + (4U * word)], output[word]);
+    }
+  }
+
+  if((pContext->Algorithm == CRYP_AUTH_GCM) && (pContext->Direction == CRYP_AUTH_ENCRYPT) && (Blocks != 0U) && (status == HAL_OK))
+  {
+    CRYPEx_GHASH(pContext->pAuthKey, pContext->Mac, output);
+  }
+
+  /* The peripheral increments the 32 least significant bits of the counter */
+  pContext->Counter[3] += Blocks;
+
+  return status;
+}
+
+/**
+  * @brief  Computes the keystream of the next counter block, used for the
+  *         bytes of the payload which do not fill a block.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRYPEx_Keystream(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, uint32_t Timeout)
+{
+  uint32_t block[4];
+  uint32_t index = 0U;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  status = CRYPEx_EncryptBlock(hcryp, pContext->pAuthKey->Key, pContext->Counter, block, Timeout);
+  pContext->Counter[3]++;
+
+  for(index = 0U; index < 4U; index++)
+  {
+    CRYPEx_WriteWord(&pContext->Keystream[4U * index], block[index]);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Authenticates the full block held in the context.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRYPEx_Auth_Block(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, uint32_t Timeout)
+{
+  uint32_t block[4];
+  uint32_t index = 0U;
+
+  pContext->BlockCount = 0U;
+
+  if(pContext->Algorithm == CRYP_AUTH_GCM)
+  {
+    for(index = 0U; index < 4U; index++)
+    {
+      block[index] = CRYPEx_ReadWord(&pContext->Block[4U * index]);
+    }
+    CRYPEx_GHASH(pContext->pAuthKey, pContext->Mac, block);
+
+    return HAL_OK;
+  }
+
+  return CRYPEx_MAC_Blocks(hcryp, pContext, pContext->Block, 1U, Timeout);
+}
+
+/**
+  * @brief  Authenticates bytes of a GCM or CCM message, the bytes which do
+  *         not fill a block are kept in the context.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  pData Pointer to the bytes
+  * @param  Size Number of bytes
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRYPEx_Auth_Bytes(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const uint8_t *pData, uint32_t Size, uint32_t Timeout)
+{
+  uint32_t blocks = 0U;
+  uint32_t offset = 0U;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  while((offset < Size) && (status == HAL_OK))
+  {
+    if((pContext->BlockCount == 0U) && ((Size - offset) >= 16U))
+    {
+      /* Whole blocks are authenticated in place */
+      blocks = (Size - offset) / 16U;
+      if(pContext->Algorithm == CRYP_AUTH_GCM)
+      {
+        CRYPEx_GHASH_Bytes(pContext->pAuthKey, pContext->Mac, &pData[offset], 16U * blocks);
+      }
+      else
+      {
+        status = CRYPEx_MAC_Blocks(hcryp, pContext, &pData[offset], blocks, Timeout);
+      }
+      offset += 16U * blocks;
+    }
+    else
+    {
+      pContext->Block[pContext->BlockCount] = pData[offset];
+      pContext->BlockCount++;
+      offset++;
+      if(pContext->BlockCount == 16U)
+      {
+        status = CRYPEx_Auth_Block(hcryp, pContext, Timeout);
+      }
+    }
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Authenticates the bytes kept in the context, padded with zeros.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRYPEx_Auth_Flush(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, uint32_t Timeout)
+{
+  uint32_t index = 0U;
+
+  if(pContext->BlockCount == 0U)
+  {
+    return HAL_OK;
+  }
+
+  for(index = pContext->BlockCount; index < 16U; index++)
+  {
+    pContext->Block[index] = 0U;
+  }
+
+  return CRYPEx_Auth_Block(hcryp, pContext, Timeout);
+}
+
+/**
+  * @brief  Encrypts or decrypts and authenticates payload bytes one by one
+  *         with the keystream of the current counter block.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  pInput Pointer to the input bytes
+  * @param  pOutput Pointer to the output bytes
+  * @param  Size Number of bytes
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRYPEx_Payload_Bytes(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const uint8_t *pInput, uint8_t *pOutput, uint32_t Size, uint32_t Timeout)
+{
+  uint32_t index = 0U;
+  uint8_t input = 0U;
+  uint8_t output = 0U;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  while((index < Size) && (status == HAL_OK))
+  {
+    if(pContext->BlockCount == 0U)
+    {
+      status = CRYPEx_Keystream(hcryp, pContext, Timeout);
+    }
+
+    if(status == HAL_OK)
+    {
+      input = pInput[index];
+      output = input ^ pContext->Keystream[pContext->BlockCount];
+      pOutput[index] = output;
+      index++;
+
+      /* GCM authenticates the ciphertext, CCM the plaintext */
+      if((pContext->Algorithm == CRYP_AUTH_GCM) == (pContext->Direction == CRYP_AUTH_ENCRYPT))
+      {
+        pContext->Block[pContext->BlockCount] = output;
+      }
+      else
+      {
+        pContext->Block[pContext->BlockCount] = input;
+      }
+      pContext->BlockCount++;
+
+      if(pContext->BlockCount == 16U)
+      {
+        status = CRYPEx_Auth_Block(hcryp, pContext, Timeout);
+      }
+    }
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Processes the start of an update by the CPU, and splits the rest
+  *         in whole blocks (XferBlocks) and tail bytes (XferTail).
+  * @note   For GCM and CCM the start completes the partial block of the
+  *         previous update. CMAC keeps the last block of the message, so the
+  *         start completes and authenticates the kept block when more data
+  *         follow, and the tail is never empty.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  pInput Pointer to the input bytes
+  * @param  pOutput Pointer to the output bytes
+  * @param  Size Number of bytes
+  * @param  pHead Pointer to the number of bytes processed
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRYPEx_Update_Head(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const uint8_t *pInput, uint8_t *pOutput, uint32_t Size, uint32_t *pHead, uint32_t Timeout)
+{
+  uint32_t head = 0U;
+  uint32_t index = 0U;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if(pContext->Algorithm == CRYP_AUTH_CMAC)
+  {
+    head = 16U - pContext->BlockCount;
+    head = (head < Size) ? head : Size;
+    for(index = 0U; index < head; index++)
+    {
+      pContext->Block[pContext->BlockCount + index] = pInput[index];
+    }
+    pContext->BlockCount += head;
+
+    if(head < Size)
+    {
+      status = CRYPEx_Auth_Block(hcryp, pContext, Timeout);
+    }
+
+    pContext->XferBlocks = (head < Size) ? ((Size - head - 1U) / 16U) : 0U;
+  }
+  else
+  {
+    /* The header ends with the first payload bytes */
+    if(pContext->Phase == CRYPEX_PHASE_HEADER)
+    {
+      status = CRYPEx_Auth_Flush(hcryp, pContext, Timeout);
+      pContext->Phase = CRYPEX_PHASE_PAYLOAD;
+    }
+
+    if((status == HAL_OK) && (pContext->BlockCount != 0U))
+    {
+      head = 16U - pContext->BlockCount;
+      head = (head < Size) ? head : Size;
+      status = CRYPEx_Payload_Bytes(hcryp, pContext, pInput, pOutput, head, Timeout);
+    }
+
+    pContext->XferBlocks = (Size - head) / 16U;
+  }
+
+  pContext->XferTail = Size - head - (16U * pContext->XferBlocks);
+  *pHead = head;
+
+  return status;
+}
+
+/**
+  * @brief  Processes whole blocks by the CPU.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  pInput Pointer to the input blocks
+  * @param  pOutput Pointer to the output blocks
+  * @param  Blocks Number of blocks
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRYPEx_Update_Blocks(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const uint8_t *pInput, uint8_t *pOutput, uint32_t Blocks, uint32_t Timeout)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if(Blocks == 0U)
+  {
+    return HAL_OK;
+  }
+
+  if(pContext->Algorithm == CRYP_AUTH_GCM)
+  {
+    status = CRYPEx_CTR_Blocks(hcryp, pContext, pInput, pOutput, Blocks, Timeout);
+  }
+  else if(pContext->Algorithm == CRYP_AUTH_CMAC)
+  {
+    status = CRYPEx_MAC_Blocks(hcryp, pContext, pInput, Blocks, Timeout);
+  }
+  else if(pContext->Direction == CRYP_AUTH_ENCRYPT)
+  {
+    status = CRYPEx_MAC_Blocks(hcryp, pContext, pInput, Blocks, Timeout);
+    if(status == HAL_OK)
+    {
+      status = CRYPEx_CTR_Blocks(hcryp, pContext, pInput, pOutput, Blocks, Timeout);
+    }
+  }
+  else
+  {
+    status = CRYPEx_CTR_Blocks(hcryp, pContext, pInput, pOutput, Blocks, Timeout);
+    if(status == HAL_OK)
+    {
+      status = CRYPEx_MAC_Blocks(hcryp, pContext, pOutput, Blocks, Timeout);
+    }
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Processes the tail bytes of an update by the CPU.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  pInput Pointer to the input bytes
+  * @param  pOutput Pointer to the output bytes
+  * @param  Size Number of bytes
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRYPEx_Update_Tail(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, const uint8_t *pInput, uint8_t *pOutput, uint32_t Size, uint32_t Timeout)
+{
+  uint32_t index = 0U;
+
+  if(pContext->Algorithm != CRYP_AUTH_CMAC)
+  {
+    return CRYPEx_Payload_Bytes(hcryp, pContext, pInput, pOutput, Size, Timeout);
+  }
+
+  /* Kept until more data follow or the message ends */
+  for(index = 0U; index < Size; index++)
+  {
+    pContext->Block[pContext->BlockCount + index] = pInput[index];
+  }
+  pContext->BlockCount += Size;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Ends the authentication of a message and computes its full tag.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pContext Pointer to the context of the message
+  * @param  pTag Pointer to the tag words
+  * @param  Timeout Specify Timeout value
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRYPEx_Tag(CRYP_HandleTypeDef *hcryp, CRYP_AuthContextTypeDef *pContext, uint32_t *pTag, uint32_t Timeout)
+{
+  const uint32_t *subkey;
+  uint32_t block[4];
+  uint32_t index = 0U;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if((pContext->Phase != CRYPEX_PHASE_HEADER) && (pContext->Phase != CRYPEX_PHASE_PAYLOAD))
+  {
+    return HAL_ERROR;
+  }
+
+  if(pContext->Algorithm == CRYP_AUTH_CMAC)
+  {
+    /* The last block is XORed with K1 when complete, else padded and XORed with K2 */
+    subkey = pContext->pAuthKey->Subkey1;
+    if(pContext->BlockCount != 16U)
+    {
+      subkey = pContext->pAuthKey->Subkey2;
+      pContext->Block[pContext->BlockCount] = 0x80U;
+      for(index = pContext->BlockCount + 1U; index < 16U; index++)
+      {
+        pContext->Block[index] = 0U;
+      }
+    }
+    for(index = 0U; index < 4U; index++)
+    {
+      CRYPEx_WriteWord(&pContext->Block[4U * index], CRYPEx_ReadWord(&pContext->Block[4U * index]) ^ subkey[index]);
+      pContext->TagMask[index] = 0U;
+    }
+    status = CRYPEx_MAC_Blocks(hcryp, pContext, pContext->Block, 1U, Timeout);
+  }
+  else
+  {
+    /* CCM: the header and the payload must have the sizes given at start */
+    if((pContext->Algorithm == CRYP_AUTH_CCM) &&
+       ((pContext->HeaderCount != pContext->HeaderSize) || (pContext->PayloadCount != pContext->PayloadSize)))
+    {
+      return HAL_ERROR;
+    }
+
+    status = CRYPEx_Auth_Flush(hcryp, pContext, Timeout);
+
+    if(pContext->Algorithm == CRYP_AUTH_GCM)
+    {
+      /* Lengths of the header and of the ciphertext in bits */
+      block[0] = pContext->HeaderCount >> 29U;
+      block[1] = pContext->HeaderCount << 3U;
+      block[2] = pContext->PayloadCount >> 29U;
+      block[3] = pContext->PayloadCount << 3U;
+      CRYPEx_GHASH(pContext->pAuthKey, pContext->Mac, block);
+    }
+  }
+
+  for(index = 0U; index < 4U; index++)
+  {
+    pTag[index] = pContext->Mac[index] ^ pContext->TagMask[index];
+  }
+
+  /* The context must be started again */
+  pContext->Phase = CRYPEX_PHASE_FINAL;
+
+  return status;
+}
+
+/**
+  * @brief  Configures the peripheral for the current DMA pass and gives the
+  *         addresses and number of words to transfer.
+  * @note   The CBC-MAC pass transfers all the blocks but the last one, the
+  *         output being discarded: the last output is read by the CPU.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @param  pInputAddr Pointer to the input address
+  * @param  pOutputAddr Pointer to the output address
+  * @retval Number of words to transfer
+  */
+static uint32_t CRYPEx_DMA_Step(CRYP_HandleTypeDef *hcryp, uint32_t *pInputAddr, uint32_t *pOutputAddr)
+{
+  CRYP_AuthContextTypeDef *context = hcryp->pAuthContext;
+  uint32_t words = 0U;
+
+  if((context->XferStep & CRYPEX_STEP_MASK) == CRYPEX_STEP_MAC)
+  {
+    CRYPEx_Configure(hcryp, context->pAuthKey->Key, CRYP_CR_ALGOMODE_AES_CBC_ENCRYPT, context->Mac);
+
+    /* CCM decryption authenticates the plaintext just written */
+    if((context->Algorithm == CRYP_AUTH_CCM) && (context->Direction == CRYP_AUTH_DECRYPT))
+    {
+      *pInputAddr = (uint32_t)hcryp->pCrypOutBuffPtr;
+    }
+    else
+    {
+      *pInputAddr = (uint32_t)hcryp->pCrypInBuffPtr;
+    }
+
+    /* The keystream is not in use, it receives the discarded output */
+    *pOutputAddr = (uint32_t)context->Keystream;
+    words = 4U * (context->XferBlocks - 1U);
+    if(words != 0U)
+    {
+      __HAL_DMA_DISABLE(hcryp->hdmaout);
+      CLEAR_BIT(hcryp->hdmaout->Instance->CCR, DMA_CCR_MINC);
+    }
+  }
+  else
+  {
+    CRYPEx_Configure(hcryp, context->pAuthKey->Key, CRYP_CR_ALGOMODE_AES_CTR_ENCRYPT, context->Counter);
+
+    /* GHASH of the ciphertext before the plaintext may overwrite it */
+    if((context->Algorithm == CRYP_AUTH_GCM) && (context->Direction == CRYP_AUTH_DECRYPT))
+    {
+      CRYPEx_GHASH_Bytes(context->pAuthKey, context->Mac, hcryp->pCrypInBuffPtr, 16U * context->XferBlocks);
+    }
+
+    *pInputAddr = (uint32_t)hcryp->pCrypInBuffPtr;
+    *pOutputAddr = (uint32_t)hcryp->pCrypOutBuffPtr;
+    words = 4U * context->XferBlocks;
+  }
+
+  return words;
+}
+
+/**
+  * @brief  Ends the current DMA pass.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @retval None
+  */
+static void CRYPEx_DMA_StepEnd(CRYP_HandleTypeDef *hcryp)
+{
+  CRYP_AuthContextTypeDef *context = hcryp->pAuthContext;
+  const uint8_t *data;
+  uint32_t block[4];
+  uint32_t word = 0U;
+
+  /* Disable the DMA requests */
+  CLEAR_BIT(hcryp->Instance->CR, AES_CR_DMAINEN | AES_CR_DMAOUTEN);
+
+  if((context->XferStep & CRYPEX_STEP_MASK) == CRYPEX_STEP_MAC)
+  {
+    __HAL_DMA_DISABLE(hcryp->hdmaout);
+    MODIFY_REG(hcryp->hdmaout->Instance->CCR, DMA_CCR_MINC, hcryp->hdmaout->Init.MemInc);
+
+    /* The last block goes on with the CBC chaining of the peripheral */
+    if((context->Algorithm == CRYP_AUTH_CCM) && (context->Direction == CRYP_AUTH_DECRYPT))
+    {
+      data = hcryp->pCrypOutBuffPtr;
+    }
+    else
+    {
+      data = hcryp->pCrypInBuffPtr;
+    }
+    data = &data[16U * (context->XferBlocks - 1U)];
+    for(word = 0U; word < 4U; word++)
+    {
+      block[word] = CRYPEx_ReadWord(&data[4U * word]);
+    }
+    CRYPEx_WriteBlock(hcryp, block);
+    (void)CRYPEx_ReadBlock(hcryp, context->Mac, HAL_MAX_DELAY);
+  }
+  else
+  {
+    /* Clear CCF Flag */
+    __HAL_CRYP_CLEAR_FLAG(hcryp, CRYP_CLEARFLAG_CCF);
+
+    context->Counter[3] += context->XferBlocks;
+
+    /* GHASH of the ciphertext produced by the DMA */
+    if((context->Algorithm == CRYP_AUTH_GCM) && (context->Direction == CRYP_AUTH_ENCRYPT))
+    {
+      CRYPEx_GHASH_Bytes(context->pAuthKey, context->Mac, hcryp->pCrypOutBuffPtr, 16U * context->XferBlocks);
+    }
+  }
+
+  context->XferStep >>= CRYPEX_STEP_SHIFT;
+}
+
+/**
+  * @brief  Starts the next DMA pass, or ends the update when all the passes
+  *         are done.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef CRYPEx_DMA_Next(CRYP_HandleTypeDef *hcryp)
+{
+  CRYP_AuthContextTypeDef *context = hcryp->pAuthContext;
+  uint32_t inputaddr = 0U, outputaddr = 0U;
+  uint32_t words = 0U;
+  uint32_t offset = 0U;
+
+  while(context->XferStep != 0U)
+  {
+    words = CRYPEx_DMA_Step(hcryp, &inputaddr, &outputaddr);
+
+    if(words != 0U)
+    {
+      /* Enable the DMA In and Out channels */
+      if(HAL_DMA_Start_IT(hcryp->hdmain, inputaddr, (uint32_t)&hcryp->Instance->DINR, words) != HAL_OK)
+      {
+        return HAL_ERROR;
+      }
+      if(HAL_DMA_Start_IT(hcryp->hdmaout, (uint32_t)&hcryp->Instance->DOUTR, outputaddr, words) != HAL_OK)
+      {
+        return HAL_ERROR;
+      }
+
+      /* Enable In and Out DMA requests */
+      SET_BIT(hcryp->Instance->CR, (AES_CR_DMAINEN | AES_CR_DMAOUTEN));
+
+      /* Enable CRYP */
+      __HAL_CRYP_ENABLE(hcryp);
+
+      return HAL_OK;
+    }
+
+    /* A single block to authenticate: the CPU does it */
+    __HAL_CRYP_ENABLE(hcryp);
+    CRYPEx_DMA_StepEnd(hcryp);
+  }
+
+  /* Tail bytes */
+  offset = 16U * context->XferBlocks;
+  (void)CRYPEx_Update_Tail(hcryp, context, &hcryp->pCrypInBuffPtr[offset],
+                           (hcryp->pCrypOutBuffPtr != NULL) ? &hcryp->pCrypOutBuffPtr[offset] : NULL,
+                           context->XferTail, HAL_MAX_DELAY);
+
+  CRYPEx_Release(hcryp);
+  hcryp->pAuthContext = NULL;
+
+  /* Change the CRYP state to ready */
+  hcryp->State = HAL_CRYP_STATE_READY;
+
+  /* Call computation complete callback */
+  HAL_CRYPEx_ComputationCpltCallback(hcryp);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stops the DMA channels and gives the peripheral back.
+  * @param  hcryp pointer to a CRYP_HandleTypeDef structure that contains
+  *         the configuration information for CRYP module
+  * @retval None
+  */
+static void CRYPEx_DMA_Stop(CRYP_HandleTypeDef *hcryp)
+{
+  if(hcryp->hdmain->State == HAL_DMA_STATE_BUSY)
+  {
+    (void)HAL_DMA_Abort(hcryp->hdmain);
+  }
+  if(hcryp->hdmaout->State == HAL_DMA_STATE_BUSY)
+  {
+    (void)HAL_DMA_Abort(hcryp->hdmaout);
+  }
+
+  __HAL_DMA_DISABLE(hcryp->hdmaout);
+  MODIFY_REG(hcryp->hdmaout->Instance->CCR, DMA_CCR_MINC, hcryp->hdmaout->Init.MemInc);
+
+  CRYPEx_Release(hcryp);
+}
+
+/**
+  * @brief  DMA CRYP Output Data process complete callback of the
+  *         authentication functions.
+  * @param  hdma DMA handle
+  * @retval None
+  */
+static void CRYPEx_DMAOutCplt(DMA_HandleTypeDef *hdma)
+{
+  CRYP_HandleTypeDef *hcryp = (CRYP_HandleTypeDef *)((DMA_HandleTypeDef *)hdma)->Parent;    /* Derogation MisraC2012 R.11.5 */
+
+  /* The input channel ended before, its interrupt may not be served yet */
+  if(hcryp->hdmain->State == HAL_DMA_STATE_BUSY)
+  {
+    (void)HAL_DMA_Abort(hcryp->hdmain);
+  }
+
+  CRYPEx_DMA_StepEnd(hcryp);
+
+  if(CRYPEx_DMA_Next(hcryp) != HAL_OK)
+  {
+    CRYPEx_DMA_Stop(hcryp);
+    hcryp->pAuthContext = NULL;
+    hcryp->State = HAL_CRYP_STATE_ERROR;
+    HAL_CRYP_ErrorCallback(hcryp);
+  }
+}
+
+/**
+  * @brief  DMA CRYP communication error callback of the authentication
+  *         functions.
+  * @param  hdma DMA handle
+  * @retval None
+  */
+static void CRYPEx_DMAError(DMA_HandleTypeDef *hdma)
+{
+  CRYP_HandleTypeDef *hcryp = (CRYP_HandleTypeDef *)((DMA_HandleTypeDef *)hdma)->Parent;    /* Derogation MisraC2012 R.11.5 */
+
+  CRYPEx_DMA_Stop(hcryp);
+  hcryp->pAuthContext = NULL;
+  hcryp->State = HAL_CRYP_STATE_ERROR;
+  HAL_CRYP_ErrorCallback(hcryp);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* HAL_CRYP_MODULE_ENABLED */
+
+/**
+  * @}
+  */
+#endif /* STM32L021xx || STM32L041xx || STM32L062xx || STM32L063xx || STM32L081xx || STM32L082xx || STM32L083xx */
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
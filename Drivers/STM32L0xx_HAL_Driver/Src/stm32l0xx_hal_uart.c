@@ -2320,10 +2320,12 @@ void HAL_UART_IRQHandler(UART_HandleTypeDef *huart)
           - Receiver Timeout error in Reception
           - Overrun error in Reception
           - any error occurs in DMA mode reception
+         except in reception ring mode, where the DMA keeps on filling the ring
       */
       errorcode = huart->ErrorCode;
-      if ((HAL_IS_BIT_SET(huart->Instance->CR3, USART_CR3_DMAR)) ||
-          ((errorcode & (HAL_UART_ERROR_RTO | HAL_UART_ERROR_ORE)) != 0U))
+      if ((huart->pRxRing == NULL) &&
+          ((HAL_IS_BIT_SET(huart->Instance->CR3, USART_CR3_DMAR)) ||
+           ((errorcode & (HAL_UART_ERROR_RTO | HAL_UART_ERROR_ORE)) != 0U)))
       {
         /* Blocking error : transfer is aborted
            Set the UART state ready to be able to start again the process,
@@ -2400,6 +2402,13 @@ void HAL_UART_IRQHandler(UART_HandleTypeDef *huart)
   {
     __HAL_UART_CLEAR_FLAG(huart, UART_CLEAR_IDLEF);
 
+    /* Reception ring mode : the reception is never ended on IDLE event */
+    if (huart->pRxRing != NULL)
+    {
+      UART_RxRingEvent(huart);
+      return;
+    }
+
     /* Check if DMA mode is enabled in UART */
     if (HAL_IS_BIT_SET(huart->Instance->CR3, USART_CR3_DMAR))
     {
@@ -3319,6 +3328,7 @@ HAL_StatusTypeDef UART_CheckIdleState(UART_HandleTypeDef *huart)
   huart->gState = HAL_UART_STATE_READY;
   huart->RxState = HAL_UART_STATE_READY;
   huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
+  huart->pRxRing = NULL;
 
   __HAL_UNLOCK(huart);
 
@@ -3402,6 +3412,7 @@ HAL_StatusTypeDef UART_Start_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pDat
   huart->RxXferSize  = Size;
   huart->RxXferCount = Size;
   huart->RxISR       = NULL;
+  huart->pRxRing     = NULL;
 
   /* Computation of UART mask to apply to RDR register */
   UART_MASK_COMPUTATION(huart);
@@ -3444,6 +3455,7 @@ HAL_StatusTypeDef UART_Start_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *pDa
 {
   huart->pRxBuffPtr = pData;
   huart->RxXferSize = Size;
+  huart->pRxRing = NULL;
 
   huart->ErrorCode = HAL_UART_ERROR_NONE;
   huart->RxState = HAL_UART_STATE_BUSY_RX;
@@ -3491,6 +3503,37 @@ HAL_StatusTypeDef UART_Start_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *pDa
   return HAL_OK;
 }
 
+/**
+  * @brief  Handle a reception event (DMA half transfer, DMA transfer complete or IDLE line)
+  *         of the reception ring started by HAL_UARTEx_RxRing_Start().
+  * @note   Head is advanced to the current DMA position, the ring being updated at least
+  *         twice per buffer turn by the DMA half and full transfer events.
+  *         Rx Event callback is called when new data has been received, with the position
+  *         in the ring buffer of the last received byte + 1 (1 to ring size).
+  * @param  huart UART handle.
+  * @retval None
+  */
+void UART_RxRingEvent(UART_HandleTypeDef *huart)
+{
+  UART_RxRingTypeDef *ring = huart->pRxRing;
+  uint32_t head = ring->Head;
+  uint32_t position = ring->Size - __HAL_DMA_GET_COUNTER(huart->hdmarx);
+
+  head += (position - head) & (ring->Size - 1U);
+  if (head != ring->Head)
+  {
+    ring->Head = head;
+
+#if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
+    /*Call registered Rx Event callback*/
+    huart->RxEventCallback(huart, (uint16_t)(((head - 1U) & (ring->Size - 1U)) + 1U));
+#else
+    /*Call legacy weak Rx Event callback*/
+    HAL_UARTEx_RxEventCallback(huart, (uint16_t)(((head - 1U) & (ring->Size - 1U)) + 1U));
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+  }
+}
+
 
 /**
   * @brief  End ongoing Tx transfer on UART peripheral (following error detection or Transmit completion).
@@ -19,6 +19,10 @@
     (#) For the UART RS485 Driver Enable mode, initialize the UART registers
         by calling the HAL_RS485Ex_Init() API.
 
+    (#) For a continuous reception, start a reception ring with HAL_UARTEx_RxRing_Start()
+        and read the received bytes with HAL_UARTEx_RxRing_Peek()/HAL_UARTEx_RxRing_Consume()
+        or HAL_UARTEx_RxRing_Read().
+
   @endverbatim
   ******************************************************************************
   * @attention
@@ -58,6 +62,9 @@
   * @{
   */
 static void UARTEx_Wakeup_AddressConfig(UART_HandleTypeDef *huart, UART_WakeUpTypeDef WakeUpSelection);
+static void UARTEx_RxRing_DMAEvent(DMA_HandleTypeDef *hdma);
+static void UARTEx_RxRing_DMAError(DMA_HandleTypeDef *hdma);
+static uint32_t UARTEx_RxRing_Received(const UART_HandleTypeDef *huart);
 /**
   * @}
   */
@@ -314,6 +321,25 @@ __weak void HAL_UARTEx_WakeupCallback(UART_HandleTypeDef *huart)
     (#) Non-Blocking mode API with DMA:
         (+) HAL_UARTEx_ReceiveToIdle_DMA()
 
+    [..] The reception ring provides a continuous reception, that is never re-armed by the application :
+    (#) The Rx DMA channel is configured in circular mode (DMA_CIRCULAR) and the ring buffer size
+        is a power of 2. HAL_UARTEx_RxRing_Start() starts the DMA, which keeps on filling the ring
+        buffer until the reception is stopped with HAL_UART_AbortReceive() or HAL_UART_Abort().
+    (#) The DMA half transfer, DMA transfer complete and IDLE events update the ring and call
+        HAL_UARTEx_RxEventCallback() with the position of the end of the received data in the ring buffer.
+        The UART and DMA interrupts must have the same preemption priority.
+    (#) The received data is read in place (no copy) : HAL_UARTEx_RxRing_Peek() returns the address and
+        the length of the contiguous data, HAL_UARTEx_RxRing_Consume() releases it once processed.
+        HAL_UARTEx_RxRing_Read() copies the received data to a user buffer.
+        HAL_UARTEx_RxRing_Available() returns the number of bytes waiting in the ring.
+    (#) The consumer functions do not disable interrupts and can be called from a single task or
+        interrupt at a time, concurrently with the reception.
+    (#) When the DMA overwrites unread data, the ring content is dropped and the Overruns field of
+        the ring is incremented. HAL_UARTEx_RxRing_Consume() and HAL_UARTEx_RxRing_Read() return
+        HAL_ERROR, as the data read may have been overwritten while it was processed.
+    (#) Reception errors (parity, noise, framing and overrun) do not stop the reception. They are notified
+        with HAL_UART_ErrorCallback().
+
 @endverbatim
   * @{
   */
@@ -788,6 +814,253 @@ HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_
   }
 }
 
+/**
+  * @brief  Start a continuous reception in a ring buffer, in DMA circular mode.
+  * @note   The Rx DMA channel must be configured in circular mode. The DMA fills the ring buffer
+  *         until the reception is stopped by HAL_UART_AbortReceive() or HAL_UART_Abort().
+  *         The data left in the ring remains readable once the reception is stopped.
+  * @note   HAL_UARTEx_RxEventCallback() is called on DMA half transfer, DMA transfer complete and
+  *         IDLE events, with the position in the ring buffer of the last received byte + 1.
+  * @note   The word length must be 7 or 8 bits, or 9 bits with parity. When the UART parity is
+  *         enabled (PCE = 1), the received data contain the parity bit (MSB position).
+  * @param  huart   UART handle.
+  * @param  pRing   Pointer to the ring structure, initialized by this function.
+  * @param  pBuffer Pointer to the ring buffer.
+  * @param  Size    Size of the ring buffer in bytes, a power of 2 greater than or equal to 2.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_UARTEx_RxRing_Start(UART_HandleTypeDef *huart, UART_RxRingTypeDef *pRing, uint8_t *pBuffer,
+                                          uint16_t Size)
+{
+  /* Check that a Rx process is not already ongoing */
+  if (huart->RxState == HAL_UART_STATE_READY)
+  {
+    if ((pRing == NULL) || (pBuffer == NULL) || (Size < 2U) || ((Size & (Size - 1U)) != 0U))
+    {
+      return HAL_ERROR;
+    }
+
+    /* The ring is a stream of bytes : 9bits/No Parity transfers are not supported */
+    if ((huart->Init.WordLength == UART_WORDLENGTH_9B) && (huart->Init.Parity == UART_PARITY_NONE))
+    {
+      return HAL_ERROR;
+    }
+
+    /* The DMA must wrap around the ring buffer */
+    if ((huart->hdmarx == NULL) || (huart->hdmarx->Init.Mode != DMA_CIRCULAR))
+    {
+      return HAL_ERROR;
+    }
+
+    __HAL_LOCK(huart);
+
+    pRing->pBuffer  = pBuffer;
+    pRing->Size     = Size;
+    pRing->Head     = 0U;
+    pRing->Tail     = 0U;
+    pRing->Overruns = 0U;
+
+    huart->pRxBuffPtr = pBuffer;
+    huart->RxXferSize = Size;
+    huart->pRxRing = pRing;
+
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    huart->ReceptionType = HAL_UART_RECEPTION_TOIDLE;
+
+    /* Half transfer and transfer complete are both ring update events */
+    huart->hdmarx->XferCpltCallback = UARTEx_RxRing_DMAEvent;
+    huart->hdmarx->XferHalfCpltCallback = UARTEx_RxRing_DMAEvent;
+    huart->hdmarx->XferErrorCallback = UARTEx_RxRing_DMAError;
+    huart->hdmarx->XferAbortCallback = NULL;
+
+    /* Enable the DMA channel */
+    if (HAL_DMA_Start_IT(huart->hdmarx, (uint32_t)&huart->Instance->RDR, (uint32_t)pBuffer, Size) != HAL_OK)
+    {
+      /* Set error code to DMA */
+      huart->ErrorCode = HAL_UART_ERROR_DMA;
+      huart->pRxRing = NULL;
+      huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
+
+      __HAL_UNLOCK(huart);
+
+      /* Restore huart->RxState to ready */
+      huart->RxState = HAL_UART_STATE_READY;
+
+      return HAL_ERROR;
+    }
+    __HAL_UNLOCK(huart);
+
+    __HAL_UART_CLEAR_FLAG(huart, UART_CLEAR_IDLEF);
+
+    /* Enable the UART Parity Error and IDLE Interrupts */
+    SET_BIT(huart->Instance->CR1, (USART_CR1_PEIE | USART_CR1_IDLEIE));
+
+    /* Enable the UART Error Interrupt: (Frame error, noise error, overrun error) */
+    SET_BIT(huart->Instance->CR3, USART_CR3_EIE);
+
+    /* Enable the DMA transfer for the receiver request by setting the DMAR bit
+    in the UART CR3 register */
+    SET_BIT(huart->Instance->CR3, USART_CR3_DMAR);
+
+    return HAL_OK;
+  }
+  else
+  {
+    return HAL_BUSY;
+  }
+}
+
+/**
+  * @brief  Return the number of received bytes waiting in the reception ring.
+  * @note   When unread data has been overwritten, the ring content is dropped and the
+  *         Overruns field of the ring is incremented.
+  * @param  huart UART handle.
+  * @retval Number of bytes
+  */
+uint32_t HAL_UARTEx_RxRing_Available(UART_HandleTypeDef *huart)
+{
+  UART_RxRingTypeDef *ring = huart->pRxRing;
+  uint32_t received;
+  uint32_t count;
+
+  if (ring == NULL)
+  {
+    return 0U;
+  }
+
+  received = UARTEx_RxRing_Received(huart);
+  count = received - ring->Tail;
+  if (count > ring->Size)
+  {
+    /* Unread data has been overwritten */
+    ring->Overruns++;
+    ring->Tail = received;
+    count = 0U;
+  }
+
+  return count;
+}
+
+/**
+  * @brief  Get the received bytes that are contiguous in the ring buffer, without copying them.
+  * @note   The data stays in the ring until it is released by HAL_UARTEx_RxRing_Consume().
+  * @param  huart  UART handle.
+  * @param  ppData Set to the address of the first unread byte, when the returned length is not 0.
+  * @retval Number of contiguous bytes at *ppData
+  */
+uint32_t HAL_UARTEx_RxRing_Peek(UART_HandleTypeDef *huart, uint8_t **ppData)
+{
+  uint32_t count = HAL_UARTEx_RxRing_Available(huart);
+  uint32_t offset;
+
+  if (count != 0U)
+  {
+    offset = huart->pRxRing->Tail & (huart->pRxRing->Size - 1U);
+    if (count > (huart->pRxRing->Size - offset))
+    {
+      count = huart->pRxRing->Size - offset;
+    }
+    *ppData = &huart->pRxRing->pBuffer[offset];
+  }
+
+  return count;
+}
+
+/**
+  * @brief  Release bytes read from the reception ring.
+  * @note   HAL_ERROR is returned when the DMA has overwritten unread data, in which case the
+  *         data read since the previous call may be corrupted and the ring content is dropped.
+  * @param  huart  UART handle.
+  * @param  Length Number of bytes to release.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_UARTEx_RxRing_Consume(UART_HandleTypeDef *huart, uint32_t Length)
+{
+  UART_RxRingTypeDef *ring = huart->pRxRing;
+  uint32_t received;
+  uint32_t count;
+
+  if (ring == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  received = UARTEx_RxRing_Received(huart);
+  count = received - ring->Tail;
+  if (count > ring->Size)
+  {
+    /* Unread data has been overwritten */
+    ring->Overruns++;
+    ring->Tail = received;
+    return HAL_ERROR;
+  }
+
+  if (Length > count)
+  {
+    return HAL_ERROR;
+  }
+
+  ring->Tail += Length;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Copy the received bytes from the reception ring to a user buffer.
+  * @note   HAL_ERROR is returned when unread data has been overwritten. RxLen then
+  *         gives the number of valid bytes copied before the overrun.
+  * @param  huart UART handle.
+  * @param  pData Pointer to the user buffer.
+  * @param  Size  Size of the user buffer in bytes.
+  * @param  RxLen Number of bytes copied.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_UARTEx_RxRing_Read(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint16_t *RxLen)
+{
+  uint32_t overruns;
+  uint32_t copied = 0U;
+  uint32_t count;
+  uint32_t index;
+  uint8_t *psrc = NULL;
+
+  if ((huart->pRxRing == NULL) || (pData == NULL) || (Size == 0U) || (RxLen == NULL))
+  {
+    return HAL_ERROR;
+  }
+
+  overruns = huart->pRxRing->Overruns;
+
+  /* At most two chunks, before and after the end of the ring buffer */
+  while (copied < Size)
+  {
+    count = HAL_UARTEx_RxRing_Peek(huart, &psrc);
+    if (count == 0U)
+    {
+      break;
+    }
+    if (count > (Size - copied))
+    {
+      count = Size - copied;
+    }
+
+    for (index = 0U; index < count; index++)
+    {
+      pData[copied + index] = psrc[index];
+    }
+
+    if (HAL_UARTEx_RxRing_Consume(huart, count) != HAL_OK)
+    {
+      break;
+    }
+    copied += count;
+  }
+
+  *RxLen = (uint16_t)copied;
+
+  return (huart->pRxRing->Overruns == overruns) ? HAL_OK : HAL_ERROR;
+}
+
 /**
   * @}
   */
@@ -817,6 +1090,64 @@ static void UARTEx_Wakeup_AddressConfig(UART_HandleTypeDef *huart, UART_WakeUpTy
   MODIFY_REG(huart->Instance->CR2, USART_CR2_ADD, ((uint32_t)WakeUpSelection.Address << UART_CR2_ADDRESS_LSB_POS));
 }
 
+/**
+  * @brief DMA UART reception ring half transfer and transfer complete callback.
+  * @param hdma DMA handle.
+  * @retval None
+  */
+static void UARTEx_RxRing_DMAEvent(DMA_HandleTypeDef *hdma)
+{
+  UART_HandleTypeDef *huart = (UART_HandleTypeDef *)(hdma->Parent);
+
+  UART_RxRingEvent(huart);
+}
+
+/**
+  * @brief DMA UART reception ring error callback.
+  * @note  The reception is stopped, the data left in the ring remains readable.
+  * @param hdma DMA handle.
+  * @retval None
+  */
+static void UARTEx_RxRing_DMAError(DMA_HandleTypeDef *hdma)
+{
+  UART_HandleTypeDef *huart = (UART_HandleTypeDef *)(hdma->Parent);
+
+  /* Disable PE, IDLE and ERR (Frame error, noise error, overrun error) interrupts
+     and the DMA transfer for the receiver request */
+  CLEAR_BIT(huart->Instance->CR1, (USART_CR1_PEIE | USART_CR1_IDLEIE));
+  CLEAR_BIT(huart->Instance->CR3, (USART_CR3_EIE | USART_CR3_DMAR));
+
+  /* At end of Rx process, restore huart->RxState to Ready */
+  huart->RxState = HAL_UART_STATE_READY;
+  huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
+
+  huart->ErrorCode |= HAL_UART_ERROR_DMA;
+
+#if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
+  /*Call registered error callback*/
+  huart->ErrorCallback(huart);
+#else
+  /*Call legacy weak error callback*/
+  HAL_UART_ErrorCallback(huart);
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+}
+
+/**
+  * @brief Return the number of bytes received in the reception ring since it was started.
+  * @note  Head is read before the DMA counter, so that it is at most one buffer turn behind
+  *        the DMA position even if a reception event updates it in between.
+  * @param huart UART handle.
+  * @retval Number of bytes, modulo 2^32
+  */
+static uint32_t UARTEx_RxRing_Received(const UART_HandleTypeDef *huart)
+{
+  const UART_RxRingTypeDef *ring = huart->pRxRing;
+  uint32_t head = ring->Head;
+  uint32_t position = ring->Size - __HAL_DMA_GET_COUNTER(huart->hdmarx);
+
+  return head + ((position - head) & (ring->Size - 1U));
+}
+
 /**
   * @}
   */
@@ -0,0 +1,23 @@
+#!/bin/sh
+# Builds the CRC driver against the simulated CRC peripheral of crc_test.c,
+# at -O0 and -O2 (the register accesses differ), and runs it. x86-64 Linux
+# only. Each register access traps, so a run takes a few minutes.
+# build.sh [output directory]
+HERE=$(cd "$(dirname "$0")" && pwd)
+HAL=$HERE/../..
+CMSIS=$HERE/../../../CMSIS
+OUT=${1:-${TMPDIR:-/tmp}/crc_test}
+CC=${CC:-cc}
+mkdir -p "$OUT" || exit 1
+
+for O in O0 O2; do
+  $CC -$O -Wall -Wno-int-to-pointer-cast -Wno-pointer-to-int-cast -no-pie -fno-pie \
+    -DSTM32L073xx -DUSE_HAL_DRIVER -I"$HERE" -I"$HAL/Inc" \
+    -I"$CMSIS/Device/ST/STM32L0xx/Include" -I"$CMSIS/Include" \
+    -o "$OUT/crc_test_$O" "$HERE/crc_test.c" \
+    "$HAL/Src/stm32l0xx_hal_crc.c" "$HAL/Src/stm32l0xx_hal_crc_ex.c" || exit 1
+done
+for O in O0 O2; do
+  echo "== -$O"
+  "$OUT/crc_test_$O" || exit 1
+done
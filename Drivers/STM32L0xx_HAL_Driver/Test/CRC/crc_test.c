@@ -0,0 +1,457 @@
+/* Host test of the STM32L0 CRC HAL: the real driver runs against a simulated
+ * CRC peripheral. The register page is protected, each access traps, the
+ * page is filled with the register values, the instruction is single-stepped
+ * and the written value (and its width, decoded from the instruction) is fed
+ * to an independent model of the peripheral. x86-64 Linux only; the DMA
+ * addresses are 32-bit, so the test is linked without PIE.
+ * Checks the results of the ST CRC examples and standard check values, then
+ * compares the CPU, DMA, context and software paths for all the
+ * configurations. */
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include "stm32l0xx_hal.h"
+#include "example_data.h"
+
+/* ---------------- simulated peripheral ---------------- */
+static uint8_t *page;
+static uint32_t m_crc, m_cr, m_init = 0xFFFFFFFF, m_pol = 0x04C11DB7, m_idr;
+static unsigned long trap_off;
+static int trap_write, trap_width;
+static unsigned long dr_writes[3]; /* 8, 16, 32 */
+
+static int m_len(void)
+{
+  static const int l[4] = {32, 16, 8, 7};
+  return l[(m_cr >> 3) & 3];
+}
+static uint32_t m_mask(int n) { return n == 32 ? 0xFFFFFFFFu : ((1u << n) - 1u); }
+static uint32_t rev(uint32_t v, int n)
+{
+  uint32_t r = 0;
+  for (int i = 0; i < n; i++)
+    if ((v >> i) & 1) r |= 1u << (n - 1 - i);
+  return r;
+}
+/* Polynomial division form: crc' = (crc * x^w + d * x^W) mod P */
+static void model_write(uint32_t v, int w)
+{
+  static const int gr[4] = {0, 8, 16, 32};
+  int g = gr[(m_cr >> 5) & 3], W = m_len();
+  uint32_t d = v & m_mask(w);
+  if (g > w) g = w;
+  if (g) {
+    uint32_t r = 0;
+    for (int k = 0; k < w; k += g) r |= rev((d >> k) & m_mask(g), g) << k;
+    d = r;
+  }
+  unsigned __int128 val = ((unsigned __int128)(m_crc & m_mask(W)) << w) ^ ((unsigned __int128)d << W);
+  unsigned __int128 P = ((unsigned __int128)1 << W) | (m_pol & m_mask(W));
+  for (int b = W + w - 1; b >= W; b--)
+    if ((val >> b) & 1) val ^= P << (b - W);
+  m_crc = (uint32_t)val & m_mask(W);
+  dr_writes[w == 8 ? 0 : w == 16 ? 1 : 2]++;
+}
+static uint32_t model_out(void)
+{
+  return (m_cr & CRC_CR_REV_OUT) ? rev(m_crc, m_len()) : m_crc;
+}
+static void prefill(void)
+{
+  CRC_TypeDef *r = (CRC_TypeDef *)page;
+  r->DR = model_out();
+  r->IDR = m_idr;
+  r->CR = m_cr;
+  r->INIT = m_init;
+  r->POL = m_pol;
+}
+
+static int decode(const uint8_t *ip, int *write)
+{
+  int op16 = 0, rexw = 0;
+  for (;;) {
+    if (*ip == 0x66) op16 = 1;
+    else if ((*ip & 0xF0) == 0x40) rexw = (*ip & 8) != 0;
+    else if (*ip == 0xF0 || *ip == 0xF2 || *ip == 0xF3 || *ip == 0x67) ;
+    else break;
+    ip++;
+  }
+  int wide = rexw ? 64 : op16 ? 16 : 32;
+  uint8_t op = ip[0], reg = (ip[1] >> 3) & 7;
+  switch (op) {
+    case 0x88: case 0xC6: *write = 1; return 8;
+    case 0x89: case 0xC7: *write = 1; return wide;
+    case 0x8A: case 0x8B: *write = 0; return 0;
+    case 0x0F:
+      if (ip[1] == 0xB6 || ip[1] == 0xB7 || ip[1] == 0xBE || ip[1] == 0xBF) { *write = 0; return 0; }
+      break;
+    case 0x80: *write = reg != 7; return 8;
+    case 0x81: case 0x83: *write = reg != 7; return wide;
+    case 0x08: case 0x20: case 0x30: case 0x00: case 0x28: *write = 1; return 8;
+    case 0x09: case 0x21: case 0x31: case 0x01: case 0x29: *write = 1; return wide;
+    case 0x39: case 0x3B: case 0x85: case 0x0B: case 0x23: case 0x33: case 0x03: case 0x2B: case 0x3A: case 0x38: case 0x84: case 0x0A: case 0x22: case 0x32: case 0x02:
+      *write = 0; return 0;
+  }
+  fprintf(stderr, "unknown instruction %02x %02x %02x %02x\n", ip[0], ip[1], ip[2], ip[3]);
+  abort();
+}
+
+static void on_segv(int sig, siginfo_t *si, void *ctx)
+{
+  ucontext_t *uc = ctx;
+  uint8_t *a = si->si_addr;
+  (void)sig;
+  if (a < page || a >= page + 4096) { fprintf(stderr, "segfault at %p rip %llx\n", a, (unsigned long long)uc->uc_mcontext.gregs[REG_RIP]); abort(); }
+  trap_off = a - page;
+  trap_width = decode((const uint8_t *)uc->uc_mcontext.gregs[REG_RIP], &trap_write);
+  mprotect(page, 4096, PROT_READ | PROT_WRITE);
+  prefill();
+  uc->uc_mcontext.gregs[REG_EFL] |= 0x100;
+}
+
+static void on_trap(int sig, siginfo_t *si, void *ctx)
+{
+  ucontext_t *uc = ctx;
+  (void)sig; (void)si;
+  if (trap_write) {
+    CRC_TypeDef *r = (CRC_TypeDef *)page;
+    switch (trap_off & ~3ul) {
+      case 0x00: {
+        uint32_t v = trap_width == 8 ? *(uint8_t *)page : trap_width == 16 ? *(uint16_t *)page : r->DR;
+        if (trap_off != 0) { fprintf(stderr, "unaligned DR write\n"); abort(); }
+        model_write(v, trap_width);
+        break;
+      }
+      case 0x04: m_idr = r->IDR; break;
+      case 0x08:
+        m_cr = r->CR & 0xFE;
+        if (r->CR & CRC_CR_RESET) m_crc = m_init & m_mask(m_len());
+        break;
+      case 0x10: m_init = r->INIT; m_crc = m_init & m_mask(m_len()); break;
+      case 0x14: m_pol = r->POL; break;
+      default: fprintf(stderr, "write to offset %lx\n", trap_off); abort();
+    }
+  }
+  mprotect(page, 4096, PROT_NONE);
+  uc->uc_mcontext.gregs[REG_EFL] &= ~0x100L;
+}
+
+/* ---------------- DMA stub ---------------- */
+static DMA_Channel_TypeDef chan;
+static DMA_HandleTypeDef hdma;
+static int dma_pending, dma_fail_at = -1, dma_starts;
+static uint32_t dma_src, dma_dst, dma_count;
+
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *h, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength)
+{
+  uint32_t ps = (h->Instance->CCR >> 8) & 3, ms = (h->Instance->CCR >> 10) & 3;
+  if (dma_pending || ps != ms || ps > 2 || DataLength == 0 || DataLength > 0xFFFF ||
+      (SrcAddress & ((1u << ps) - 1)) || h->Init.PeriphDataAlignment != (ps << 8) ||
+      h->Init.MemDataAlignment != (ms << 10)) {
+    fprintf(stderr, "bad DMA start\n");
+    abort();
+  }
+  if (dma_starts++ == dma_fail_at) return HAL_BUSY;
+  dma_pending = 1; dma_src = SrcAddress; dma_dst = DstAddress; dma_count = DataLength;
+  return HAL_OK;
+}
+
+static void run_dma(void)
+{
+  while (dma_pending) {
+    uint32_t size = 1u << ((chan.CCR >> 8) & 3);
+    dma_pending = 0;
+    for (uint32_t i = 0; i < dma_count; i++) {
+      uintptr_t s = dma_src + i * size;
+      if (size == 1) *(volatile uint8_t *)(uintptr_t)dma_dst = *(uint8_t *)s;
+      else if (size == 2) *(volatile uint16_t *)(uintptr_t)dma_dst = *(uint16_t *)s;
+      else *(volatile uint32_t *)(uintptr_t)dma_dst = *(uint32_t *)s;
+    }
+    hdma.XferCpltCallback(&hdma);
+  }
+}
+
+static int cplt, errs;
+void HAL_CRC_CpltCallback(CRC_HandleTypeDef *h) { (void)h; cplt++; }
+void HAL_CRC_ErrorCallback(CRC_HandleTypeDef *h) { (void)h; errs++; }
+
+/* ---------------- tests ---------------- */
+static CRC_HandleTypeDef hcrc;
+static int failures, checks;
+#define CHECK(c, ...) do { checks++; if (!(c)) { failures++; if (failures < 30) { printf("FAIL %s:%d ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } } } while (0)
+
+static uint8_t buf[150000] __attribute__((aligned(4)));
+static uint8_t buf2[4096] __attribute__((aligned(4)));
+static uint32_t rnd_state = 12345;
+static uint32_t rnd(void) { rnd_state ^= rnd_state << 13; rnd_state ^= rnd_state >> 17; rnd_state ^= rnd_state << 5; return rnd_state; }
+
+static void init(uint8_t defpol, uint32_t pol, uint32_t len, uint8_t definit, uint32_t initv, uint32_t revin, uint32_t revout, uint32_t fmt)
+{
+  hcrc.Instance = (CRC_TypeDef *)page;
+  hcrc.Init.DefaultPolynomialUse = defpol;
+  hcrc.Init.GeneratingPolynomial = pol;
+  hcrc.Init.CRCLength = len;
+  hcrc.Init.DefaultInitValueUse = definit;
+  hcrc.Init.InitValue = initv;
+  hcrc.Init.InputDataInversionMode = revin;
+  hcrc.Init.OutputDataInversionMode = revout;
+  hcrc.InputDataFormat = fmt;
+  hcrc.hdma = &hdma;
+  hdma.Instance = &chan;
+  hdma.Init.Direction = DMA_MEMORY_TO_MEMORY;
+  hdma.Parent = &hcrc;
+  if (HAL_CRC_Init(&hcrc) != HAL_OK) { printf("init failed\n"); exit(1); }
+}
+
+static uint32_t calc_dma(uint32_t *p, uint32_t n, int accumulate)
+{
+  int c = cplt;
+  HAL_StatusTypeDef st = accumulate ? HAL_CRC_Accumulate_DMA(&hcrc, p, n) : HAL_CRC_Calculate_DMA(&hcrc, p, n);
+  CHECK(st == HAL_OK, "dma start %d", st);
+  run_dma();
+  CHECK(cplt == c + 1 && hcrc.State == HAL_CRC_STATE_READY, "dma completion");
+  return HAL_CRC_GetValue(&hcrc);
+}
+
+static void golden(void)
+{
+  static const uint8_t d16[9] __attribute__((aligned(4))) = {0x4D, 0x3C, 0x2B, 0x1A, 0xBE, 0x71, 0xC9, 0x8A, 0x5E};
+  static const uint8_t d16c[9] __attribute__((aligned(4))) = {0x58, 0xD4, 0x3C, 0xB2, 0x51, 0x93, 0x8E, 0x7D, 0x7A};
+  static const uint8_t t5[5] __attribute__((aligned(4))) = {0x12, 0x34, 0xBA, 0x71, 0xAD};
+  static const uint8_t t17[17] __attribute__((aligned(4))) = {0x12, 0x34, 0xBA, 0x71, 0xAD, 0x11, 0x56, 0xDC, 0x88, 0x1B, 0xEE, 0x4D, 0x82, 0x93, 0xA6, 0x7F, 0xC3};
+  static const uint8_t t1[4] __attribute__((aligned(4))) = {0x19};  /* padded to a word */
+  static const uint8_t t2[4] __attribute__((aligned(4))) = {0xAB, 0xCD};
+  static const uint32_t pu[2] = {0x12345678, 0x12213883};
+  static const uint8_t ll[39] __attribute__((aligned(4))) = {
+    0x21, 0x10, 0x00, 0x00, 0x63, 0x30, 0x42, 0x20, 0xa5, 0x50, 0x84, 0x40, 0xe7, 0x70, 0xc6, 0x60, 0x4a, 0xa1, 0x29, 0x91,
+    0x8c, 0xc1, 0x6b, 0xb1, 0xce, 0xe1, 0xad, 0xd1, 0x31, 0x12, 0xef, 0xf1, 0x52, 0x22, 0x73, 0x32, 0xa1, 0xb2, 0xc3};
+  static const char check[] __attribute__((aligned(4))) = "123456789";
+  uint32_t v;
+
+  for (int dma = 0; dma < 2; dma++) {
+    /* CRC_Data_Reversing_16bit_CRC */
+    init(DEFAULT_POLYNOMIAL_DISABLE, 0x1021, CRC_POLYLENGTH_16B, DEFAULT_INIT_VALUE_DISABLE, 0x5ABE,
+         CRC_INPUTDATA_INVERSION_WORD, CRC_OUTPUTDATA_INVERSION_ENABLE, CRC_INPUTDATA_FORMAT_BYTES);
+    v = dma ? calc_dma((uint32_t *)d16, 9, 1) : HAL_CRC_Accumulate(&hcrc, (uint32_t *)d16, 9);
+    CHECK(v == 0x5043, "reversing 16 %x", v);
+    CHECK(HAL_CRCEx_Calculate_Soft(&hcrc, (uint32_t *)d16, 9) == 0x5043, "soft reversing");
+    init(DEFAULT_POLYNOMIAL_DISABLE, 0x1021, CRC_POLYLENGTH_16B, DEFAULT_INIT_VALUE_DISABLE, 0x5ABE,
+         CRC_INPUTDATA_INVERSION_NONE, CRC_OUTPUTDATA_INVERSION_DISABLE, CRC_INPUTDATA_FORMAT_BYTES);
+    v = dma ? calc_dma((uint32_t *)d16c, 9, 1) : HAL_CRC_Accumulate(&hcrc, (uint32_t *)d16c, 9);
+    CHECK(v == 0xC20A, "reversing check %x", v);
+
+    /* CRC_bytes_stream_7bit_CRC */
+    init(DEFAULT_POLYNOMIAL_DISABLE, 0x65, CRC_POLYLENGTH_7B, DEFAULT_INIT_VALUE_ENABLE, 0,
+         CRC_INPUTDATA_INVERSION_NONE, CRC_OUTPUTDATA_INVERSION_DISABLE, CRC_INPUTDATA_FORMAT_BYTES);
+    v = dma ? calc_dma((uint32_t *)t5, 5, 1) : HAL_CRC_Accumulate(&hcrc, (uint32_t *)t5, 5);
+    CHECK(v == 0x57, "7bit 1 %x", v);
+    v = dma ? calc_dma((uint32_t *)t17, 17, 1) : HAL_CRC_Accumulate(&hcrc, (uint32_t *)t17, 17);
+    CHECK(v == 0x6E, "7bit 2 %x", v);
+    v = dma ? calc_dma((uint32_t *)t1, 1, 1) : HAL_CRC_Accumulate(&hcrc, (uint32_t *)t1, 1);
+    CHECK(v == 0x4B, "7bit 3 %x", v);
+    v = dma ? calc_dma((uint32_t *)t2, 2, 0) : HAL_CRC_Calculate(&hcrc, (uint32_t *)t2, 2);
+    CHECK(v == 0x26, "7bit 4 %x", v);
+    CHECK(HAL_CRCEx_Calculate_Soft(&hcrc, (uint32_t *)t2, 2) == 0x26, "soft 7bit");
+
+    /* CRC_PolynomialUpdate */
+    init(DEFAULT_POLYNOMIAL_DISABLE, 0x9B, CRC_POLYLENGTH_8B, DEFAULT_INIT_VALUE_ENABLE, 0,
+         CRC_INPUTDATA_INVERSION_NONE, CRC_OUTPUTDATA_INVERSION_DISABLE, CRC_INPUTDATA_FORMAT_WORDS);
+    v = dma ? calc_dma((uint32_t *)pu, 2, 0) : HAL_CRC_Calculate(&hcrc, (uint32_t *)pu, 2);
+    CHECK(v == 0xAB, "polyupdate 8 %x", v);
+    HAL_CRCEx_Polynomial_Set(&hcrc, 0x1021, CRC_POLYLENGTH_16B);
+    v = dma ? calc_dma((uint32_t *)pu, 2, 0) : HAL_CRC_Calculate(&hcrc, (uint32_t *)pu, 2);
+    CHECK(v == 0x9357, "polyupdate 16 %x", v);
+    CHECK(HAL_CRCEx_Calculate_Soft(&hcrc, (uint32_t *)pu, 2) == 0x9357, "soft polyupdate");
+
+    /* CRC_Example */
+    init(DEFAULT_POLYNOMIAL_ENABLE, 0, 0, DEFAULT_INIT_VALUE_ENABLE, 0,
+         CRC_INPUTDATA_INVERSION_NONE, CRC_OUTPUTDATA_INVERSION_DISABLE, CRC_INPUTDATA_FORMAT_WORDS);
+    v = dma ? calc_dma((uint32_t *)aExampleBuffer, 114, 0) : HAL_CRC_Calculate(&hcrc, (uint32_t *)aExampleBuffer, 114);
+    CHECK(v == 0x379E9F06, "example %x", v);
+    CHECK(HAL_CRCEx_Calculate_Soft(&hcrc, (uint32_t *)aExampleBuffer, 114) == 0x379E9F06, "soft example");
+  }
+
+  /* LL examples: little-endian words, LL tail (model only) */
+  for (int k = 0; k < 2; k++) {
+    if (k == 0) init(DEFAULT_POLYNOMIAL_DISABLE, 0x9B, CRC_POLYLENGTH_8B, DEFAULT_INIT_VALUE_ENABLE, 0, 0, 0, CRC_INPUTDATA_FORMAT_WORDS);
+    else init(DEFAULT_POLYNOMIAL_ENABLE, 0, 0, DEFAULT_INIT_VALUE_ENABLE, 0, 0, 0, CRC_INPUTDATA_FORMAT_WORDS);
+    HAL_CRC_Calculate(&hcrc, (uint32_t *)ll, 9);
+    model_write(ll[36] | (ll[37] << 8), 16);
+    model_write(ll[38], 8);
+    CHECK(m_crc == (k ? 0xA9866043 : 0xA6), "LL example %d %x", k, m_crc);
+  }
+
+  /* Standard check values of "123456789" */
+  struct { uint32_t pol, len, init, revin, revout, xorout, check; } cv[] = {
+    {0x04C11DB7, CRC_POLYLENGTH_32B, 0xFFFFFFFF, 0, 0, 0, 0x0376E6E7},                               /* CRC-32/MPEG-2 */
+    {0x04C11DB7, CRC_POLYLENGTH_32B, 0xFFFFFFFF, CRC_INPUTDATA_INVERSION_BYTE, CRC_OUTPUTDATA_INVERSION_ENABLE, 0xFFFFFFFF, 0xCBF43926}, /* CRC-32 */
+    {0x1021, CRC_POLYLENGTH_16B, 0xFFFF, 0, 0, 0, 0x29B1},                                             /* CCITT-FALSE */
+    {0x8005, CRC_POLYLENGTH_16B, 0, CRC_INPUTDATA_INVERSION_BYTE, CRC_OUTPUTDATA_INVERSION_ENABLE, 0, 0xBB3D}, /* ARC */
+    {0x07, CRC_POLYLENGTH_8B, 0, 0, 0, 0, 0xF4},                                                       /* CRC-8 */
+    {0x09, CRC_POLYLENGTH_7B, 0, 0, 0, 0, 0x75},                                                       /* CRC-7/MMC */
+  };
+  for (unsigned i = 0; i < sizeof cv / sizeof cv[0]; i++) {
+    init(DEFAULT_POLYNOMIAL_DISABLE, cv[i].pol, cv[i].len, DEFAULT_INIT_VALUE_DISABLE, cv[i].init,
+         cv[i].revin, cv[i].revout, CRC_INPUTDATA_FORMAT_BYTES);
+    v = HAL_CRC_Calculate(&hcrc, (uint32_t *)check, 9) ^ cv[i].xorout;
+    CHECK(v == cv[i].check, "check value %u %x", i, v);
+    v = HAL_CRCEx_Calculate_Soft(&hcrc, (uint32_t *)check, 9) ^ cv[i].xorout;
+    CHECK(v == cv[i].check, "soft check value %u %x", i, v);
+  }
+}
+
+static const uint32_t lens[4] = {CRC_POLYLENGTH_7B, CRC_POLYLENGTH_8B, CRC_POLYLENGTH_16B, CRC_POLYLENGTH_32B};
+static const uint32_t pols[4][2] = {{0x65, 0x09}, {0x9B, 0x07}, {0x1021, 0x8005}, {0x04C11DB7, 0x1EDC6F41}};
+static const uint32_t revins[4] = {CRC_INPUTDATA_INVERSION_NONE, CRC_INPUTDATA_INVERSION_BYTE, CRC_INPUTDATA_INVERSION_HALFWORD, CRC_INPUTDATA_INVERSION_WORD};
+static const uint32_t fmts[3] = {CRC_INPUTDATA_FORMAT_BYTES, CRC_INPUTDATA_FORMAT_HALFWORDS, CRC_INPUTDATA_FORMAT_WORDS};
+
+/* Context update of n units at p by one of the three paths */
+static void ctx_update(CRC_ContextTypeDef *c, uint8_t *p, uint32_t n, int how)
+{
+  if (how == 0) HAL_CRCEx_Context_Update(&hcrc, c, (uint32_t *)p, n);
+  else if (how == 1) {
+    hcrc.State = HAL_CRC_STATE_BUSY;
+    HAL_CRCEx_Context_Update(&hcrc, c, (uint32_t *)p, n);
+    hcrc.State = HAL_CRC_STATE_READY;
+  } else {
+    int cc = cplt;
+    CHECK(HAL_CRCEx_Context_Update_DMA(&hcrc, c, (uint32_t *)p, n) == HAL_OK, "ctx dma start");
+    run_dma();
+    CHECK(cplt == cc + 1 && hcrc.State == HAL_CRC_STATE_READY && hcrc.pContext == NULL, "ctx dma end");
+  }
+}
+
+static void sweep(void)
+{
+  long configs = 0;
+  for (int L = 0; L < 4; L++)
+    for (int P = 0; P < 2; P++)
+      for (int ri = 0; ri < 4; ri++)
+        for (int ro = 0; ro < 2; ro++)
+          for (int f = 0; f < 3; f++)
+            for (int di = 0; di < 2; di++) {
+              uint32_t unit = f == 0 ? 1 : f == 1 ? 2 : 4;
+              uint32_t initv = di ? rnd() : 0xFFFFFFFF;
+              init(DEFAULT_POLYNOMIAL_DISABLE, pols[L][P], lens[L], di ? DEFAULT_INIT_VALUE_DISABLE : DEFAULT_INIT_VALUE_ENABLE,
+                   initv, revins[ri], ro ? CRC_OUTPUTDATA_INVERSION_ENABLE : 0, fmts[f]);
+              configs++;
+              for (uint32_t n = 0; n < 40; n++)
+                for (uint32_t off = 0; off < 4; off += unit) {
+                  uint8_t *p = buf + 64 + off;
+                  for (uint32_t i = 0; i < n * unit; i++) p[i] = rnd();
+                  uint32_t ref = HAL_CRC_Calculate(&hcrc, (uint32_t *)p, n);
+                  uint32_t soft = HAL_CRCEx_Calculate_Soft(&hcrc, (uint32_t *)p, n);
+                  CHECK(soft == ref, "soft L%d P%d ri%d ro%d f%d n%u: %x != %x", L, P, ri, ro, f, n, soft, ref);
+                  uint32_t dma = calc_dma((uint32_t *)p, n, 0);
+                  CHECK(dma == ref, "dma L%d P%d ri%d ro%d f%d n%u off%u: %x != %x", L, P, ri, ro, f, n, off, dma, ref);
+                  /* Accumulate after a first computation */
+                  uint32_t a1 = HAL_CRC_Calculate(&hcrc, (uint32_t *)buf2, 3);
+                  uint32_t a2 = HAL_CRC_Accumulate(&hcrc, (uint32_t *)p, n);
+                  uint32_t b1 = calc_dma((uint32_t *)buf2, 3, 0);
+                  uint32_t b2 = calc_dma((uint32_t *)p, n, 1);
+                  CHECK(a1 == b1 && a2 == b2, "accumulate dma");
+                  /* Two interleaved contexts, random split and paths */
+                  CRC_ContextTypeDef c1, c2;
+                  HAL_CRCEx_Context_Init(&hcrc, &c1);
+                  HAL_CRCEx_Context_Init(&hcrc, &c2);
+                  uint32_t q = 0, q2 = 0, n2 = (n * 7) % 23;
+                  for (uint32_t i = 0; i < n2 * unit; i++) buf2[256 + i] = i * 37 + n;
+                  uint32_t ref2 = HAL_CRC_Calculate(&hcrc, (uint32_t *)(buf2 + 256), n2);
+                  while (q < n || q2 < n2) {
+                    uint32_t k = rnd() % 7;
+                    if (k > n - q) k = n - q;
+                    ctx_update(&c1, p + q * unit, k, rnd() % 3);
+                    q += k;
+                    k = rnd() % 5;
+                    if (k > n2 - q2) k = n2 - q2;
+                    ctx_update(&c2, buf2 + 256 + q2 * unit, k, rnd() % 3);
+                    q2 += k;
+                    /* Intermediate final does not disturb the context */
+                    (void)HAL_CRCEx_Context_Final(&hcrc, &c1);
+                    /* Peripheral reused in between */
+                    (void)HAL_CRC_Calculate(&hcrc, (uint32_t *)buf2, 5);
+                  }
+                  uint32_t r1 = HAL_CRCEx_Context_Final(&hcrc, &c1), r2 = HAL_CRCEx_Context_Final(&hcrc, &c2);
+                  CHECK(r1 == ref && r2 == ref2, "context L%d P%d ri%d ro%d f%d n%u: %x/%x %x/%x", L, P, ri, ro, f, n, r1, ref, r2, ref2);
+                  CHECK(((m_cr >> 5) & 3) == ri, "REV_IN restored");
+                }
+            }
+  printf("sweep: %ld configurations\n", configs);
+}
+
+static void large(void)
+{
+  /* Splitting in 65535-transfer DMA runs */
+  for (int f = 0; f < 3; f++)
+    for (int ri = 0; ri < 4; ri++) {
+      uint32_t unit = f == 0 ? 1 : f == 1 ? 2 : 4;
+      uint32_t n = (f == 0 ? 140001 : f == 1 ? 70001 : 35000);
+      init(DEFAULT_POLYNOMIAL_ENABLE, 0, 0, DEFAULT_INIT_VALUE_ENABLE, 0, revins[ri], CRC_OUTPUTDATA_INVERSION_ENABLE, fmts[f]);
+      for (uint32_t i = 0; i < n * unit; i++) buf[i] = rnd();
+      uint32_t ref = HAL_CRC_Calculate(&hcrc, (uint32_t *)buf, n);
+      dma_starts = 0;
+      uint32_t v = calc_dma((uint32_t *)buf, n, 0);
+      CHECK(v == ref, "large f%d ri%d %x %x", f, ri, v, ref);
+      printf("large f%d ri%d: %u units, %d DMA runs\n", f, ri, n, dma_starts);
+    }
+
+  /* DMA start failure on the second run: error callback, REV_IN restored */
+  init(DEFAULT_POLYNOMIAL_ENABLE, 0, 0, DEFAULT_INIT_VALUE_ENABLE, 0, CRC_INPUTDATA_INVERSION_HALFWORD, 0, CRC_INPUTDATA_FORMAT_BYTES);
+  dma_starts = 0; dma_fail_at = 1;
+  int e = errs;
+  CHECK(HAL_CRC_Calculate_DMA(&hcrc, (uint32_t *)buf, 140000) == HAL_OK, "start");
+  run_dma();
+  CHECK(errs == e + 1 && hcrc.State == HAL_CRC_STATE_READY && ((m_cr >> 5) & 3) == 2, "error path");
+  /* Same with a context: INIT set back */
+  {
+    CRC_ContextTypeDef c;
+    HAL_CRCEx_Context_Init(&hcrc, &c);
+    c.Crc = 0x12345678;
+    dma_starts = 0; dma_fail_at = 1;
+    CHECK(HAL_CRCEx_Context_Update_DMA(&hcrc, &c, (uint32_t *)buf, 140000) == HAL_OK, "start");
+    run_dma();
+    CHECK(errs == e + 2 && m_init == 0xFFFFFFFF && hcrc.pContext == NULL && ((m_cr >> 5) & 3) == 2, "context error path");
+    init(DEFAULT_POLYNOMIAL_ENABLE, 0, 0, DEFAULT_INIT_VALUE_DISABLE, 0xA5A5A5A5, CRC_INPUTDATA_INVERSION_HALFWORD, 0, CRC_INPUTDATA_FORMAT_BYTES);
+    HAL_CRCEx_Context_Init(&hcrc, &c);
+    HAL_CRCEx_Context_Update(&hcrc, &c, (uint32_t *)buf, 10);
+    CHECK(m_init == 0xA5A5A5A5 && m_crc == 0xA5A5A5A5, "INIT set back");
+  }
+  init(DEFAULT_POLYNOMIAL_ENABLE, 0, 0, DEFAULT_INIT_VALUE_ENABLE, 0, CRC_INPUTDATA_INVERSION_WORD, 0, CRC_INPUTDATA_FORMAT_BYTES);
+  /* First start failure: HAL_ERROR returned */
+  dma_starts = 0; dma_fail_at = 0;
+  CHECK(HAL_CRC_Calculate_DMA(&hcrc, (uint32_t *)buf, 100) == HAL_ERROR && hcrc.State == HAL_CRC_STATE_READY &&
+        ((m_cr >> 5) & 3) == 3, "start failure");
+  dma_fail_at = -1;
+  /* Busy */
+  CHECK(HAL_CRC_Calculate_DMA(&hcrc, (uint32_t *)buf, 100) == HAL_OK, "start");
+  CHECK(HAL_CRC_Calculate_DMA(&hcrc, (uint32_t *)buf, 100) == HAL_BUSY, "busy");
+  run_dma();
+  hcrc.hdma = NULL;
+  CHECK(HAL_CRC_Calculate_DMA(&hcrc, (uint32_t *)buf, 100) == HAL_ERROR, "no dma");
+}
+
+int main(void)
+{
+  struct sigaction sa = {0};
+  page = mmap(NULL, 4096, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+  sa.sa_flags = SA_SIGINFO;
+  sa.sa_sigaction = on_segv;
+  sigaction(SIGSEGV, &sa, NULL);
+  sa.sa_sigaction = on_trap;
+  sigaction(SIGTRAP, &sa, NULL);
+  for (int i = 0; i < 4096; i++) buf2[i] = rnd();
+
+  setvbuf(stdout, NULL, _IONBF, 0);
+  printf("page %p buf %p buf2 %p\n", page, buf, buf2);
+  golden();
+  printf("golden: %d checks, %d failures\n", checks, failures);
+  sweep();
+  large();
+  printf("DR writes: 8-bit %lu, 16-bit %lu, 32-bit %lu\n", dr_writes[0], dr_writes[1], dr_writes[2]);
+  printf("%d checks, %d failures\n", checks, failures);
+  return failures != 0;
+}
@@ -0,0 +1,23 @@
+#!/bin/sh
+# Builds the CRYP driver against the simulated AES peripheral of cryp_test.c,
+# at -O0 and -O2 (the register accesses differ), and runs it. x86-64 Linux
+# only. The AES peripheral only exists on the STM32L0x2 devices.
+# build.sh [output directory]
+HERE=$(cd "$(dirname "$0")" && pwd)
+HAL=$HERE/../..
+CMSIS=$HERE/../../../CMSIS
+OUT=${1:-${TMPDIR:-/tmp}/cryp_test}
+CC=${CC:-cc}
+mkdir -p "$OUT" || exit 1
+
+for O in O0 O2; do
+  $CC -$O -Wall -Wno-int-to-pointer-cast -Wno-pointer-to-int-cast -no-pie -fno-pie \
+    -DSTM32L082xx -DUSE_HAL_DRIVER -I"$HERE" -I"$HAL/Inc" \
+    -I"$CMSIS/Device/ST/STM32L0xx/Include" -I"$CMSIS/Include" \
+    -o "$OUT/cryp_test_$O" "$HERE/cryp_test.c" \
+    "$HAL/Src/stm32l0xx_hal_cryp.c" "$HAL/Src/stm32l0xx_hal_cryp_ex.c" || exit 1
+done
+for O in O0 O2; do
+  echo "== -$O"
+  "$OUT/cryp_test_$O" || exit 1
+done
@@ -0,0 +1,674 @@
+/* Host test of the STM32L0 CRYPEx authenticated modes: the real driver runs
+ * against a simulated AES peripheral. As in the CRC test, the register page
+ * is protected, each access traps and is single-stepped, and the written
+ * values are fed to a software AES-128 model. The DMA stub completes the
+ * input and output channels in random order. x86-64 Linux only; the DMA
+ * addresses are 32-bit, so the test is linked without PIE.
+ * Checks the GCM, CCM and CMAC test vectors, then compares randomized
+ * messages with a software reference. */
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include "stm32l0xx_hal.h"
+
+/* ---------------- software AES-128 ---------------- */
+static uint8_t sbox[256];
+static void aes_init_sbox(void)
+{
+  uint8_t p = 1, q = 1;
+  do {
+    p = p ^ (p << 1) ^ (p & 0x80 ? 0x1B : 0);
+    q ^= q << 1; q ^= q << 2; q ^= q << 4; if (q & 0x80) q ^= 0x09;
+    uint8_t x = q ^ ((q << 1) | (q >> 7)) ^ ((q << 2) | (q >> 6)) ^ ((q << 3) | (q >> 5)) ^ ((q << 4) | (q >> 4));
+    sbox[p] = x ^ 0x63;
+  } while (p != 1);
+  sbox[0] = 0x63;
+}
+static uint8_t xt(uint8_t a) { return (a << 1) ^ (a & 0x80 ? 0x1B : 0); }
+static void aes_enc(const uint8_t key[16], const uint8_t in[16], uint8_t out[16])
+{
+  uint8_t rk[176], s[16], t[16], rc = 1;
+  memcpy(rk, key, 16);
+  for (int i = 16; i < 176; i += 4) {
+    uint8_t w[4] = {rk[i - 4], rk[i - 3], rk[i - 2], rk[i - 1]};
+    if (i % 16 == 0) {
+      uint8_t tmp = w[0];
+      w[0] = sbox[w[1]] ^ rc; w[1] = sbox[w[2]]; w[2] = sbox[w[3]]; w[3] = sbox[tmp];
+      rc = xt(rc);
+    }
+    for (int j = 0; j < 4; j++) rk[i + j] = rk[i - 16 + j] ^ w[j];
+  }
+  for (int i = 0; i < 16; i++) s[i] = in[i] ^ rk[i];
+  for (int r = 1; r <= 10; r++) {
+    for (int i = 0; i < 16; i++) t[i] = sbox[s[(i + 4 * (i % 4)) % 16]];
+    if (r != 10)
+      for (int c = 0; c < 4; c++) {
+        uint8_t *a = &t[4 * c], a0 = a[0], a1 = a[1], a2 = a[2], a3 = a[3];
+        a[0] = xt(a0) ^ xt(a1) ^ a1 ^ a2 ^ a3;
+        a[1] = a0 ^ xt(a1) ^ xt(a2) ^ a2 ^ a3;
+        a[2] = a0 ^ a1 ^ xt(a2) ^ xt(a3) ^ a3;
+        a[3] = xt(a0) ^ a0 ^ a1 ^ a2 ^ xt(a3);
+      }
+    for (int i = 0; i < 16; i++) s[i] = t[i] ^ rk[16 * r + i];
+  }
+  memcpy(out, s, 16);
+}
+
+/* ---------------- simulated AES peripheral ---------------- */
+static uint8_t *page;
+static uint32_t m_reg[12];   /* CR SR - - KEYR0..3 IVR0..3 */
+static uint32_t m_in[4], m_out[4];
+static int m_nin, m_nout, m_blocks, m_errors;
+static unsigned long trap_off;
+static int trap_write, trap_width;
+
+static uint32_t swapin(uint32_t v)
+{
+  switch ((m_reg[0] >> 1) & 3) {
+    case 0: return v;
+    case 1: return (v >> 16) | (v << 16);
+    case 2: return __builtin_bswap32(v);
+    default: { uint32_t r = 0; for (int i = 0; i < 32; i++) if ((v >> i) & 1) r |= 1u << (31 - i); return r; }
+  }
+}
+static void put32(uint8_t *p, uint32_t v) { p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v; }
+static uint32_t get32(const uint8_t *p) { return (uint32_t)p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3]; }
+
+static void model_compute(void)
+{
+  uint8_t key[16], in[16], iv[16], out[16];
+  uint32_t mode = (m_reg[0] >> 3) & 3, chmod = (m_reg[0] >> 5) & 3;
+  if (mode != 0 || chmod == 3) { fprintf(stderr, "model: unsupported mode %u/%u\n", mode, chmod); abort(); }
+  for (int i = 0; i < 4; i++) { put32(key + 4 * i, m_reg[7 - i]); put32(iv + 4 * i, m_reg[11 - i]); put32(in + 4 * i, m_in[i]); }
+  if (chmod == 0) aes_enc(key, in, out);
+  else if (chmod == 1) {
+    for (int i = 0; i < 16; i++) in[i] ^= iv[i];
+    aes_enc(key, in, out);
+    for (int i = 0; i < 4; i++) m_reg[11 - i] = get32(out + 4 * i);
+  } else {
+    aes_enc(key, iv, out);
+    for (int i = 0; i < 16; i++) out[i] ^= in[i];
+    m_reg[8]++;
+  }
+  for (int i = 0; i < 4; i++) m_out[i] = get32(out + 4 * i);
+  m_reg[1] |= 1;  /* CCF */
+  m_nout = 0;
+  m_blocks++;
+}
+
+static void prefill(void)
+{
+  uint32_t *r = (uint32_t *)page;
+  r[0] = m_reg[0]; r[1] = m_reg[1]; r[2] = 0;
+  r[3] = m_nout < 4 ? swapin(m_out[m_nout]) : 0;
+  for (int i = 4; i < 12; i++) r[i] = m_reg[i];
+}
+
+static int decode(const uint8_t *ip, int *write)
+{
+  int op16 = 0, rexw = 0;
+  for (;;) {
+    if (*ip == 0x66) op16 = 1;
+    else if ((*ip & 0xF0) == 0x40) rexw = (*ip & 8) != 0;
+    else if (*ip == 0xF0 || *ip == 0xF2 || *ip == 0xF3 || *ip == 0x67) ;
+    else break;
+    ip++;
+  }
+  int wide = rexw ? 64 : op16 ? 16 : 32;
+  uint8_t op = ip[0], reg = (ip[1] >> 3) & 7;
+  switch (op) {
+    case 0x88: case 0xC6: *write = 1; return 8;
+    case 0x89: case 0xC7: *write = 1; return wide;
+    case 0x8A: case 0x8B: *write = 0; return 0;
+    case 0x0F:
+      if (ip[1] == 0xB6 || ip[1] == 0xB7 || ip[1] == 0xBE || ip[1] == 0xBF || ip[1] == 0xBA) { *write = 0; return 0; }
+      break;
+    case 0x80: *write = reg != 7; return 8;
+    case 0x81: case 0x83: *write = reg != 7; return wide;
+    case 0xF6: case 0xF7: if (reg == 0) { *write = 0; return 0; } break;
+    case 0x08: case 0x20: case 0x30: case 0x00: case 0x28: *write = 1; return 8;
+    case 0x09: case 0x21: case 0x31: case 0x01: case 0x29: *write = 1; return wide;
+    case 0x39: case 0x3B: case 0x85: case 0x0B: case 0x23: case 0x33: case 0x03: case 0x2B: case 0x3A: case 0x38: case 0x84: case 0x0A: case 0x22: case 0x32: case 0x02:
+      *write = 0; return 0;
+  }
+  fprintf(stderr, "unknown instruction %02x %02x %02x %02x\n", ip[0], ip[1], ip[2], ip[3]);
+  abort();
+}
+
+static void on_segv(int sig, siginfo_t *si, void *ctx)
+{
+  ucontext_t *uc = ctx;
+  uint8_t *a = si->si_addr;
+  (void)sig;
+  if (a < page || a >= page + 4096) { fprintf(stderr, "segfault at %p rip %llx\n", a, (unsigned long long)uc->uc_mcontext.gregs[REG_RIP]); abort(); }
+  trap_off = a - page;
+  trap_width = decode((const uint8_t *)uc->uc_mcontext.gregs[REG_RIP], &trap_write);
+  mprotect(page, 4096, PROT_READ | PROT_WRITE);
+  prefill();
+  uc->uc_mcontext.gregs[REG_EFL] |= 0x100;
+}
+
+static void on_trap(int sig, siginfo_t *si, void *ctx)
+{
+  ucontext_t *uc = ctx;
+  uint32_t *r = (uint32_t *)page;
+  uint32_t en = m_reg[0] & 1;
+  (void)sig; (void)si;
+  if (trap_off >= 0x30 || (trap_off & 3)) { fprintf(stderr, "access to offset %lx\n", trap_off); abort(); }
+  if (trap_write) {
+    if (trap_width != 32) { fprintf(stderr, "write of width %d\n", trap_width); abort(); }
+    switch (trap_off) {
+      case 0x00: {
+        uint32_t v = r[0];
+        if (v & AES_CR_CCFC) m_reg[1] &= ~1u;
+        if (v & AES_CR_ERRC) m_reg[1] &= ~6u;
+        if (en && ((v ^ m_reg[0]) & (AES_CR_DATATYPE | AES_CR_MODE | AES_CR_CHMOD))) { fprintf(stderr, "CR changed while enabled\n"); m_errors++; }
+        if (!en && (v & 1)) { m_nin = 0; m_nout = 4; }
+        m_reg[0] = v & ~(AES_CR_CCFC | AES_CR_ERRC);
+        break;
+      }
+      case 0x04: break;
+      case 0x08:
+        if (!en) { fprintf(stderr, "DINR write while disabled\n"); m_errors++; break; }
+        if (m_nout < 4) { m_reg[1] |= 4; /* WRERR */ m_errors++; fprintf(stderr, "DINR write before the output is read\n"); break; }
+        m_in[m_nin++] = swapin(r[2]);
+        if (m_nin == 4) { m_nin = 0; model_compute(); }
+        break;
+      case 0x0C: fprintf(stderr, "DOUTR write\n"); abort();
+      default:
+        if (en) { fprintf(stderr, "key/IV write while enabled\n"); m_errors++; }
+        m_reg[trap_off / 4] = r[trap_off / 4];
+        break;
+    }
+  } else if (trap_off == 0x0C) {
+    if (m_nout >= 4) { m_reg[1] |= 2; /* RDERR */ fprintf(stderr, "DOUTR read without output\n"); m_errors++; }
+    else m_nout++;
+  }
+  mprotect(page, 4096, PROT_NONE);
+  uc->uc_mcontext.gregs[REG_EFL] &= ~0x100L;
+}
+
+/* ---------------- DMA stub ---------------- */
+static DMA_Channel_TypeDef chan_in, chan_out;
+static DMA_HandleTypeDef hdma_in, hdma_out;
+static struct { int pending; uint32_t src, dst, count; } xfer[2];
+static int dma_fail_at = -1, dma_starts, dma_runs;
+static uint32_t rnd_state = 12345;
+static uint32_t rnd(void) { rnd_state ^= rnd_state << 13; rnd_state ^= rnd_state >> 17; rnd_state ^= rnd_state << 5; return rnd_state; }
+
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *h, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength)
+{
+  int k = h == &hdma_out;
+  if (h->State != HAL_DMA_STATE_READY) return HAL_BUSY;
+  if (xfer[k].pending || DataLength == 0 || DataLength > 0xFFFF) { fprintf(stderr, "bad DMA start\n"); abort(); }
+  if (dma_starts++ == dma_fail_at) return HAL_ERROR;
+  h->State = HAL_DMA_STATE_BUSY;
+  h->Instance->CCR |= DMA_CCR_EN;
+  xfer[k].pending = 1; xfer[k].src = SrcAddress; xfer[k].dst = DstAddress; xfer[k].count = DataLength;
+  return HAL_OK;
+}
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *h)
+{
+  int k = h == &hdma_out;
+  if (h->State != HAL_DMA_STATE_BUSY) { fprintf(stderr, "abort not busy\n"); abort(); }
+  xfer[k].pending = 0;
+  h->Instance->CCR &= ~DMA_CCR_EN;
+  h->State = HAL_DMA_STATE_READY;
+  return HAL_OK;
+}
+
+/* Runs the transfers as the hardware does, block by block, then the
+   completion interrupts in a random order */
+static void run_dma(void)
+{
+  while (xfer[0].pending || xfer[1].pending) {
+    volatile uint32_t *cr = (volatile uint32_t *)page;
+    if (!xfer[0].pending || !xfer[1].pending || xfer[0].count != xfer[1].count || (xfer[0].count & 3)) { fprintf(stderr, "unbalanced DMA\n"); abort(); }
+    if ((*cr & (AES_CR_DMAINEN | AES_CR_DMAOUTEN | AES_CR_EN)) != (AES_CR_DMAINEN | AES_CR_DMAOUTEN | AES_CR_EN)) { fprintf(stderr, "DMA requests not enabled\n"); abort(); }
+    int minc = (chan_out.CCR & DMA_CCR_MINC) != 0;
+    dma_runs++;
+    for (uint32_t i = 0; i < xfer[0].count; i += 4) {
+      for (int j = 0; j < 4; j++) *(volatile uint32_t *)(uintptr_t)xfer[0].dst = *(uint32_t *)(uintptr_t)(xfer[0].src + 4 * (i + j));
+      for (int j = 0; j < 4; j++) *(uint32_t *)(uintptr_t)(xfer[1].dst + (minc ? 4 * (i + j) : 0)) = *(volatile uint32_t *)(uintptr_t)xfer[1].src;
+    }
+    xfer[0].pending = xfer[1].pending = 0;
+    if (rnd() & 1) {
+      hdma_in.State = HAL_DMA_STATE_READY;
+      if (hdma_in.XferCpltCallback) hdma_in.XferCpltCallback(&hdma_in);
+      hdma_out.State = HAL_DMA_STATE_READY;
+      hdma_out.XferCpltCallback(&hdma_out);
+    } else {
+      /* Output interrupt first: the driver aborts the input channel, which
+         clears its flags, so its interrupt has nothing to do */
+      hdma_out.State = HAL_DMA_STATE_READY;
+      hdma_out.XferCpltCallback(&hdma_out);
+      if (hdma_in.State == HAL_DMA_STATE_BUSY && !xfer[0].pending) {
+        fprintf(stderr, "input channel left busy\n"); abort();
+      }
+    }
+  }
+}
+
+static int cplt, errs;
+void HAL_CRYPEx_ComputationCpltCallback(CRYP_HandleTypeDef *h) { (void)h; cplt++; }
+void HAL_CRYP_ErrorCallback(CRYP_HandleTypeDef *h) { (void)h; errs++; }
+void HAL_CRYP_MspInit(CRYP_HandleTypeDef *h) { (void)h; }
+uint32_t HAL_GetTick(void) { static uint32_t t; return t++ / 64; }
+
+/* ---------------- software references ---------------- */
+static void gf_mul(uint8_t x[16], const uint8_t h[16])
+{
+  uint8_t z[16] = {0}, v[16];
+  memcpy(v, h, 16);
+  for (int i = 0; i < 128; i++) {
+    if ((x[i / 8] >> (7 - i % 8)) & 1) for (int j = 0; j < 16; j++) z[j] ^= v[j];
+    int lsb = v[15] & 1;
+    for (int j = 15; j > 0; j--) v[j] = (v[j] >> 1) | (v[j - 1] << 7);
+    v[0] >>= 1;
+    if (lsb) v[0] ^= 0xE1;
+  }
+  memcpy(x, z, 16);
+}
+static void ghash(const uint8_t h[16], uint8_t y[16], const uint8_t *d, size_t n)
+{
+  for (size_t o = 0; o < n; o += 16) {
+    for (size_t i = 0; i < 16 && o + i < n; i++) y[i] ^= d[o + i];
+    gf_mul(y, h);
+  }
+}
+static void inc32(uint8_t c[16]) { for (int i = 15; i >= 12; i--) if (++c[i]) break; }
+static void ref_gcm(const uint8_t *key, const uint8_t *iv, size_t ivn, const uint8_t *a, size_t an,
+                    const uint8_t *in, size_t n, uint8_t *out, uint8_t tag[16], int dec)
+{
+  uint8_t h[16] = {0}, j0[16] = {0}, c[16], ks[16], y[16] = {0}, len[16] = {0};
+  aes_enc(key, h, h);
+  if (ivn == 12) { memcpy(j0, iv, 12); j0[15] = 1; }
+  else { ghash(h, j0, iv, ivn); uint8_t l[16] = {0}; put32(l + 12, ivn * 8); ghash(h, j0, l, 16); }
+  memcpy(c, j0, 16);
+  ghash(h, y, a, an);
+  if (dec) ghash(h, y, in, n);
+  for (size_t o = 0; o < n; o += 16) {
+    inc32(c); aes_enc(key, c, ks);
+    for (size_t i = 0; i < 16 && o + i < n; i++) out[o + i] = in[o + i] ^ ks[i];
+  }
+  if (!dec) ghash(h, y, out, n);
+  put32(len + 4, an * 8); put32(len + 12, n * 8);
+  ghash(h, y, len, 16);
+  aes_enc(key, j0, ks);
+  for (int i = 0; i < 16; i++) tag[i] = y[i] ^ ks[i];
+}
+static void cbcmac(const uint8_t *key, uint8_t x[16], const uint8_t *d, size_t n)
+{
+  for (size_t o = 0; o < n; o += 16) {
+    for (size_t i = 0; i < 16 && o + i < n; i++) x[i] ^= d[o + i];
+    aes_enc(key, x, x);
+  }
+}
+static void ref_ccm(const uint8_t *key, const uint8_t *nonce, size_t nn, const uint8_t *a, size_t an,
+                    const uint8_t *in, size_t n, uint8_t *out, uint8_t *tag, size_t tn, int dec)
+{
+  uint8_t b[16] = {0}, x[16] = {0}, ctr[16] = {0}, ks[16];
+  size_t L = 15 - nn;
+  b[0] = (an ? 0x40 : 0) | ((tn - 2) / 2) << 3 | (L - 1);
+  memcpy(b + 1, nonce, nn);
+  for (size_t i = 0; i < L && i < 4; i++) b[15 - i] = n >> (8 * i);
+  cbcmac(key, x, b, 16);
+  if (an) {
+    static uint8_t hb[70000];
+    size_t hl;
+    if (an < 0xFF00) { hb[0] = an >> 8; hb[1] = an; hl = 2; }
+    else { hb[0] = 0xFF; hb[1] = 0xFE; put32(hb + 2, an); hl = 6; }
+    memcpy(hb + hl, a, an);
+    cbcmac(key, x, hb, hl + an);
+  }
+  ctr[0] = L - 1; memcpy(ctr + 1, nonce, nn);
+  uint8_t s0[16];
+  aes_enc(key, ctr, s0);
+  for (size_t o = 0; o < n; o += 16) {
+    for (int i = 15; i > 0; i--) if (++ctr[i]) break;
+    aes_enc(key, ctr, ks);
+    for (size_t i = 0; i < 16 && o + i < n; i++) out[o + i] = in[o + i] ^ ks[i];
+  }
+  cbcmac(key, x, dec ? out : in, n);
+  for (size_t i = 0; i < tn; i++) tag[i] = x[i] ^ s0[i];
+}
+static void dbl(uint8_t k[16])
+{
+  int c = k[0] >> 7;
+  for (int i = 0; i < 15; i++) k[i] = k[i] << 1 | k[i + 1] >> 7;
+  k[15] = (k[15] << 1) ^ (c ? 0x87 : 0);
+}
+static void ref_cmac(const uint8_t *key, const uint8_t *m, size_t n, uint8_t tag[16])
+{
+  uint8_t l[16] = {0}, x[16] = {0}, last[16] = {0};
+  aes_enc(key, l, l);
+  dbl(l);
+  size_t full = n ? (n - 1) / 16 : 0, rest = n - 16 * full;
+  cbcmac(key, x, m, 16 * full);
+  memcpy(last, m + 16 * full, rest);
+  if (rest != 16) { last[rest] = 0x80; dbl(l); }
+  for (int i = 0; i < 16; i++) last[i] ^= l[i] ^ x[i];
+  aes_enc(key, last, tag);
+}
+
+/* ---------------- tests ---------------- */
+static CRYP_HandleTypeDef hcryp;
+static CRYP_AuthKeyTypeDef akey, akey2;
+static CRYP_AuthContextTypeDef ctx1, ctx2;
+static int failures, checks;
+#define CHECK(c, ...) do { checks++; if (!(c)) { failures++; if (failures < 30) { printf("FAIL %s:%d ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } } } while (0)
+
+static uint8_t keybuf[16] __attribute__((aligned(4)));
+static uint8_t bin[70000] __attribute__((aligned(4)));
+static uint8_t bout[70000] __attribute__((aligned(4)));
+static uint8_t bhdr[70000] __attribute__((aligned(4)));
+static uint8_t bref[70000] __attribute__((aligned(4)));
+
+static size_t hex(uint8_t *d, const char *s)
+{
+  size_t n = 0;
+  for (; s[0] && s[1]; s += 2) { if (*s == ' ') { s--; continue; } sscanf(s, "%2hhx", &d[n++]); }
+  return n;
+}
+
+static void setkey(const uint8_t *k, CRYP_AuthKeyTypeDef *ak)
+{
+  memcpy(keybuf, k, 16);
+  hcryp.Instance = (AES_TypeDef *)page;
+  hcryp.Init.DataType = CRYP_DATATYPE_32B;
+  hcryp.Init.pKey = keybuf;
+  hcryp.Init.pInitVect = keybuf;
+  hcryp.hdmain = &hdma_in;
+  hcryp.hdmaout = &hdma_out;
+  hdma_in.Instance = &chan_in;
+  hdma_out.Instance = &chan_out;
+  hdma_in.Parent = &hcryp;
+  hdma_out.Parent = &hcryp;
+  hdma_out.Init.MemInc = DMA_MINC_ENABLE;
+  chan_out.CCR = DMA_MINC_ENABLE;
+  hdma_in.State = hdma_out.State = HAL_DMA_STATE_READY;
+  if (hcryp.State == HAL_CRYP_STATE_RESET && HAL_CRYP_Init(&hcryp) != HAL_OK) { printf("init failed\n"); exit(1); }
+  CHECK(HAL_CRYPEx_AuthKey_Init(&hcryp, ak, 10) == HAL_OK, "key init");
+}
+
+/* Feeds n bytes of payload in random chunks through random paths */
+static int update_mode = -1;
+static void update(CRYP_AuthContextTypeDef *c, uint8_t *in, size_t n, uint8_t *out)
+{
+  size_t o = 0;
+  while (o < n) {
+    size_t k = n - o;
+    int how = update_mode >= 0 ? update_mode : (int)(rnd() % 2);
+    if (update_mode < 0) {
+      uint32_t r = rnd() % 4;
+      if (r == 0) k = rnd() % 17;
+      else if (r == 1) k = rnd() % 100;
+      if (k > n - o) k = n - o;
+    }
+    if (k > 65535) k = 65535 - (65535 % 16);
+    if (how == 0) CHECK(HAL_CRYPEx_Auth_Update(&hcryp, c, in + o, k, out ? out + o : NULL, 10) == HAL_OK, "update");
+    else {
+      int cc = cplt;
+      CHECK(HAL_CRYPEx_Auth_Update_DMA(&hcryp, c, in + o, k, out ? out + o : NULL) == HAL_OK, "update dma");
+      run_dma();
+      CHECK(cplt == cc + 1 && hcryp.State == HAL_CRYP_STATE_READY && hcryp.pAuthContext == NULL, "dma end %d %d", cplt - cc, hcryp.State);
+    }
+    o += k;
+  }
+}
+static void header(CRYP_AuthContextTypeDef *c, uint8_t *a, size_t n)
+{
+  size_t o = 0;
+  while (o < n) {
+    size_t k = n - o;
+    if (update_mode < 0 && (rnd() & 1)) k = rnd() % 40;
+    if (k > n - o) k = n - o;
+    if (k > 65535) k = 65535;
+    CHECK(HAL_CRYPEx_Auth_Header(&hcryp, c, a + o, k, 10) == HAL_OK, "header");
+    o += k;
+  }
+}
+
+static void nist(void)
+{
+  uint8_t k[16], iv[64], p[64], a[64], c[64], t[16], tag[16];
+  size_t ivn, pn, an, cn;
+  static const struct { const char *k, *iv, *p, *a, *c, *t; } gcm[] = {
+    {"00000000000000000000000000000000", "000000000000000000000000", "", "", "", "58e2fccefa7e3061367f1d57a4e7455a"},
+    {"00000000000000000000000000000000", "000000000000000000000000", "00000000000000000000000000000000", "", "0388dace60b6a392f328c2b971b2fe78", "ab6e47d42cec13bdf53a67b21257bddf"},
+    {"feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888",
+     "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255", "",
+     "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985",
+     "4d5c2af327cd64a62cf35abd2ba6fab4"},
+    {"feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888",
+     "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+     "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+     "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091",
+     "5bc94fbc3221a5db94fae95ae7121a47"},
+    {"feffe9928665731c6d6a8f9467308308", "cafebabefacedbad",
+     "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+     "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+     "61353b4c2806934a777ff51fa22a4755699b2a714fcdc6f83766e5f97b6c742373806900e49f24b22b097544d4896b424989b5e1ebac0f07c23f4598",
+     "3612d2e79e3b0785561be14aaca2fccb"},
+    {"feffe9928665731c6d6a8f9467308308", "9313225df88406e555909c5aff5269aa6a7a9538534f7da1e4c303d2a318a728c3c0c95156809539fcf0e2429a6b525416aedbf5a0de6a57a637b39b",
+     "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+     "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+     "8ce24998625615b603a033aca13fb894be9112a5c3a211a8ba262a3cca7e2ca701e4a9a4fba43c90ccdcb281d48c7c6fd62875d2aca417034c34aee5",
+     "619cc5aefffe0bfa462af43c1699d050"},
+  };
+
+  /* FIPS-197 C.1 check of the model */
+  hex(k, "000102030405060708090a0b0c0d0e0f"); hex(p, "00112233445566778899aabbccddeeff"); hex(t, "69c4e0d86a7b0430d8cdb78070b4c55a");
+  aes_enc(k, p, c);
+  CHECK(memcmp(c, t, 16) == 0, "FIPS-197");
+
+  for (int m = 0; m < 2; m++)
+    for (unsigned i = 0; i < sizeof gcm / sizeof gcm[0]; i++)
+      for (int dec = 0; dec < 2; dec++) {
+        update_mode = m;
+        hex(k, gcm[i].k); ivn = hex(iv, gcm[i].iv); pn = hex(p, gcm[i].p); an = hex(a, gcm[i].a); cn = hex(c, gcm[i].c); hex(t, gcm[i].t);
+        setkey(k, &akey);
+        memcpy(bin, dec ? c : p, pn); memcpy(bhdr, a, an);
+        CHECK(HAL_CRYPEx_AESGCM_Start(&hcryp, &ctx1, &akey, dec ? CRYP_AUTH_DECRYPT : CRYP_AUTH_ENCRYPT, iv, ivn, 10) == HAL_OK, "gcm start");
+        header(&ctx1, bhdr, an);
+        update(&ctx1, bin, pn, bout);
+        CHECK(memcmp(bout, dec ? p : c, cn) == 0, "GCM test case %u %s m%d", i + 1, dec ? "decrypt" : "encrypt", m);
+        if (dec) CHECK(HAL_CRYPEx_Auth_Verify(&hcryp, &ctx1, t, 16, 10) == HAL_OK, "GCM tag %u verify m%d", i + 1, m);
+        else { CHECK(HAL_CRYPEx_Auth_Final(&hcryp, &ctx1, tag, 16, 10) == HAL_OK && memcmp(tag, t, 16) == 0, "GCM tag %u m%d", i + 1, m); }
+        ref_gcm(k, iv, ivn, a, an, dec ? c : p, pn, bref, tag, dec);
+        CHECK(memcmp(tag, t, 16) == 0 && memcmp(bref, dec ? p : c, pn) == 0, "reference GCM %u", i + 1);
+      }
+
+  /* SP 800-38C C.1 to C.4 */
+  static const struct { const char *n, *a, *p, *c; size_t tn; } ccm[] = {
+    {"10111213141516", "0001020304050607", "20212223", "7162015b4dac255d", 4},
+    {"1011121314151617", "000102030405060708090a0b0c0d0e0f", "202122232425262728292a2b2c2d2e2f", "d2a1f0e051ea5f62081a7792073d593d1fc64fbfaccd", 6},
+    {"101112131415161718191a1b", "000102030405060708090a0b0c0d0e0f10111213", "202122232425262728292a2b2c2d2e2f3031323334353637",
+     "e3b201a9f5b71a7a9b1ceaeccd97e70b6176aad9a4428aa5484392fbc1b09951", 8},
+    {"101112131415161718191a1b1c", NULL, "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f",
+     "69915dad1e84c6376a68c2967e4dab615ae0fd1faec44cc484828529463ccf72b4ac6bec93e8598e7f0dadbcea5b", 14},
+  };
+  hex(k, "404142434445464748494a4b4c4d4e4f");
+  for (int m = 0; m < 3; m++)
+    for (unsigned i = 0; i < 4; i++)
+      for (int dec = 0; dec < 2; dec++) {
+        update_mode = m < 2 ? m : -1;
+        size_t nn = hex(iv, ccm[i].n);
+        if (ccm[i].a) an = hex(bhdr, ccm[i].a); else { an = 65536; for (size_t j = 0; j < an; j++) bhdr[j] = j; }
+        pn = hex(p, ccm[i].p); cn = hex(c, ccm[i].c);
+        setkey(k, &akey);
+        memcpy(bin, dec ? c : p, pn);
+        CHECK(HAL_CRYPEx_AESCCM_Start(&hcryp, &ctx1, &akey, dec ? CRYP_AUTH_DECRYPT : CRYP_AUTH_ENCRYPT, iv, nn, an, pn, ccm[i].tn, 10) == HAL_OK, "ccm start");
+        header(&ctx1, bhdr, an);
+        update(&ctx1, bin, pn, bout);
+        CHECK(memcmp(bout, dec ? p : c, pn) == 0, "CCM example %u %s m%d", i + 1, dec ? "decrypt" : "encrypt", m);
+        if (dec) CHECK(HAL_CRYPEx_Auth_Verify(&hcryp, &ctx1, c + pn, ccm[i].tn, 10) == HAL_OK, "CCM tag %u verify", i + 1);
+        else { CHECK(HAL_CRYPEx_Auth_Final(&hcryp, &ctx1, tag, ccm[i].tn, 10) == HAL_OK && memcmp(tag, c + pn, ccm[i].tn) == 0, "CCM tag %u m%d", i + 1, m); }
+        ref_ccm(k, iv, nn, bhdr, an, dec ? c : p, pn, bref, tag, ccm[i].tn, dec);
+        CHECK(memcmp(tag, c + pn, ccm[i].tn) == 0 && memcmp(bref, dec ? p : c, pn) == 0, "reference CCM %u", i + 1);
+      }
+
+  /* SP 800-38B D.1 */
+  static const struct { size_t n; const char *t; } cmac[] = {
+    {0, "bb1d6929e95937287fa37d129b756746"}, {16, "070a16b46b4d4144f79bdd9dd04a287c"},
+    {40, "dfa66747de9ae63030ca32611497c827"}, {64, "51f0bebf7e3b9d92fc49741779363cfe"},
+  };
+  hex(k, "2b7e151628aed2a6abf7158809cf4f3c");
+  hex(p, "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e5130c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710");
+  setkey(k, &akey);
+  hex(t, "fbeed618357133667c85e08f7236a8de");
+  CHECK(akey.Subkey1[0] == get32(t) && akey.Subkey1[3] == get32(t + 12), "CMAC K1");
+  hex(t, "f7ddac306ae266ccf90bc11ee46d513b");
+  CHECK(akey.Subkey2[0] == get32(t) && akey.Subkey2[3] == get32(t + 12), "CMAC K2");
+  for (int m = 0; m < 3; m++)
+    for (unsigned i = 0; i < 4; i++) {
+      update_mode = m < 2 ? m : -1;
+      hex(t, cmac[i].t);
+      memcpy(bin, p, cmac[i].n);
+      CHECK(HAL_CRYPEx_AESCMAC_Start(&hcryp, &ctx1, &akey) == HAL_OK, "cmac start");
+      update(&ctx1, bin, cmac[i].n, NULL);
+      CHECK(HAL_CRYPEx_Auth_Final(&hcryp, &ctx1, tag, 16, 10) == HAL_OK && memcmp(tag, t, 16) == 0, "CMAC example %u m%d", i, m);
+      ref_cmac(k, p, cmac[i].n, tag);
+      CHECK(memcmp(tag, t, 16) == 0, "reference CMAC %u", i);
+    }
+  update_mode = -1;
+}
+
+/* Random messages, splits, alignments and paths, two interleaved contexts
+   with different keys, against the software references */
+static void sweep(void)
+{
+  uint8_t k1[16], k2[16], iv[64], tag[16], rtag[16];
+  static uint8_t in2[4096] __attribute__((aligned(4))), out2[4096] __attribute__((aligned(4))), ref2[4096];
+  for (int i = 0; i < 16; i++) { k1[i] = rnd(); k2[i] = rnd(); }
+  setkey(k2, &akey2);
+  setkey(k1, &akey);
+  for (int it = 0; it < 3000; it++) {
+    int alg = it % 3, dec = (it / 3) & 1;
+    size_t n = rnd() % (it % 50 == 0 ? 3000 : 200), an = alg == 2 ? 0 : rnd() % 70, ivn = 12, tn = 16;
+    size_t oin = rnd() % 4, oout = (rnd() & 1) ? oin : rnd() % 4;
+    size_t n2 = rnd() % 100;
+    int inplace = (rnd() % 4) == 0;
+    if (alg == 0 && (rnd() & 1)) ivn = 1 + rnd() % 40;
+    if (alg == 1) { ivn = 7 + rnd() % 7; tn = 4 + 2 * (rnd() % 7); if (ivn == 13 && n > 65535) n = 1000; }
+    for (size_t i = 0; i < ivn; i++) iv[i] = rnd();
+    for (size_t i = 0; i < n + 8; i++) bin[i] = rnd();
+    for (size_t i = 0; i < an; i++) bhdr[i] = rnd();
+    for (size_t i = 0; i < n2; i++) in2[i] = rnd();
+    uint8_t *pin = bin + oin, *pout = inplace ? pin : bout + oout;
+
+    /* references first, the driver may work in place */
+    if (alg == 0) ref_gcm(k1, iv, ivn, bhdr, an, pin, n, bref, rtag, dec);
+    else if (alg == 1) ref_ccm(k1, iv, ivn, bhdr, an, pin, n, bref, rtag, tn, dec);
+    else ref_cmac(k1, pin, n, rtag);
+    uint8_t t2[16];
+    ref_gcm(k2, iv, 12, NULL, 0, in2, n2, ref2, t2, 0);
+
+    if (alg == 0) CHECK(HAL_CRYPEx_AESGCM_Start(&hcryp, &ctx1, &akey, dec, iv, ivn, 10) == HAL_OK, "start");
+    else if (alg == 1) CHECK(HAL_CRYPEx_AESCCM_Start(&hcryp, &ctx1, &akey, dec, iv, ivn, an, n, tn, 10) == HAL_OK, "start");
+    else CHECK(HAL_CRYPEx_AESCMAC_Start(&hcryp, &ctx1, &akey) == HAL_OK, "start");
+    CHECK(HAL_CRYPEx_AESGCM_Start(&hcryp, &ctx2, &akey2, CRYP_AUTH_ENCRYPT, iv, 12, 10) == HAL_OK, "start 2");
+    header(&ctx1, bhdr, an);
+    /* Interleave the second context with the first one's payload */
+    size_t h = n / 2;
+    update(&ctx1, pin, h, alg == 2 ? NULL : pout);
+    update(&ctx2, in2, n2, out2);
+    /* the base driver in between */
+    {
+      static uint8_t e_in[16] __attribute__((aligned(4))), e_out[16] __attribute__((aligned(4))), e_ref[16];
+      memcpy(keybuf, k1, 16);
+      for (int i = 0; i < 16; i++) e_in[i] = rnd();
+      CHECK(HAL_CRYP_AESECB_Encrypt(&hcryp, e_in, 16, e_out, 10) == HAL_OK, "ecb");
+      aes_enc(k1, e_in, e_ref);
+      /* DataType 32B: the words are taken as big endian words in memory order */
+      uint8_t sw[16];
+      for (int i = 0; i < 16; i++) sw[i] = e_in[(i & ~3) + 3 - (i & 3)];
+      aes_enc(k1, sw, e_ref);
+      for (int i = 0; i < 16; i++) sw[i] = e_ref[(i & ~3) + 3 - (i & 3)];
+      CHECK(memcmp(sw, e_out, 16) == 0, "base ECB");
+      (void)HAL_CRYP_DeInit(&hcryp);
+      hcryp.State = HAL_CRYP_STATE_RESET;
+      CHECK(HAL_CRYP_Init(&hcryp) == HAL_OK, "reinit");
+    }
+    update(&ctx1, pin + h, n - h, alg == 2 ? NULL : pout + h);
+    if (alg != 2) CHECK(memcmp(pout, bref, n) == 0, "sweep %d alg %d dec %d n %zu an %zu ivn %zu off %zu/%zu inplace %d", it, alg, dec, n, an, ivn, oin, oout, inplace);
+    CHECK(HAL_CRYPEx_Auth_Final(&hcryp, &ctx1, tag, tn, 10) == HAL_OK && memcmp(tag, rtag, tn) == 0, "sweep tag %d alg %d dec %d n %zu", it, alg, dec, n);
+    CHECK(HAL_CRYPEx_Auth_Final(&hcryp, &ctx1, tag, tn, 10) == HAL_ERROR, "final twice");
+    CHECK(HAL_CRYPEx_Auth_Final(&hcryp, &ctx2, tag, 16, 10) == HAL_OK && memcmp(tag, t2, 16) == 0 && memcmp(out2, ref2, n2) == 0, "second context");
+  }
+  printf("sweep: %d peripheral blocks, %d DMA runs\n", m_blocks, dma_runs);
+}
+
+static void errors(void)
+{
+  uint8_t k[16] = {1}, iv[12] = {2}, tag[16];
+  setkey(k, &akey);
+  /* Verify rejects a modified tag */
+  CHECK(HAL_CRYPEx_AESGCM_Start(&hcryp, &ctx1, &akey, CRYP_AUTH_DECRYPT, iv, 12, 10) == HAL_OK, "start");
+  update(&ctx1, bin, 40, bout);
+  CHECK(HAL_CRYPEx_AESGCM_Start(&hcryp, &ctx2, &akey, CRYP_AUTH_DECRYPT, iv, 12, 10) == HAL_OK, "start");
+  update(&ctx2, bin, 40, bout);
+  CHECK(HAL_CRYPEx_Auth_Final(&hcryp, &ctx1, tag, 16, 10) == HAL_OK, "final");
+  tag[15] ^= 1;
+  CHECK(HAL_CRYPEx_Auth_Verify(&hcryp, &ctx2, tag, 16, 10) == HAL_ERROR, "verify mismatch");
+  /* Header after payload, CCM sizes */
+  CHECK(HAL_CRYPEx_AESGCM_Start(&hcryp, &ctx1, &akey, CRYP_AUTH_ENCRYPT, iv, 12, 10) == HAL_OK, "start");
+  update(&ctx1, bin, 1, bout);
+  CHECK(HAL_CRYPEx_Auth_Header(&hcryp, &ctx1, bhdr, 1, 10) == HAL_ERROR, "header after payload");
+  CHECK(HAL_CRYPEx_AESCCM_Start(&hcryp, &ctx1, &akey, CRYP_AUTH_ENCRYPT, iv, 6, 0, 0, 16, 10) == HAL_ERROR, "nonce 6");
+  CHECK(HAL_CRYPEx_AESCCM_Start(&hcryp, &ctx1, &akey, CRYP_AUTH_ENCRYPT, iv, 13, 0, 65536, 16, 10) == HAL_ERROR, "payload too long");
+  CHECK(HAL_CRYPEx_AESCCM_Start(&hcryp, &ctx1, &akey, CRYP_AUTH_ENCRYPT, iv, 12, 0, 0, 5, 10) == HAL_ERROR, "odd tag");
+  CHECK(HAL_CRYPEx_AESCCM_Start(&hcryp, &ctx1, &akey, CRYP_AUTH_ENCRYPT, iv, 12, 10, 20, 8, 10) == HAL_OK, "start");
+  CHECK(HAL_CRYPEx_Auth_Update(&hcryp, &ctx1, bin, 4, bout, 10) == HAL_ERROR, "payload before header");
+  CHECK(HAL_CRYPEx_Auth_Header(&hcryp, &ctx1, bhdr, 11, 10) == HAL_ERROR, "header too long");
+  CHECK(HAL_CRYPEx_Auth_Header(&hcryp, &ctx1, bhdr, 10, 10) == HAL_OK, "header");
+  CHECK(HAL_CRYPEx_Auth_Update(&hcryp, &ctx1, bin, 21, bout, 10) == HAL_ERROR, "payload too long");
+  CHECK(HAL_CRYPEx_Auth_Update(&hcryp, &ctx1, bin, 19, bout, 10) == HAL_OK, "payload");
+  CHECK(HAL_CRYPEx_Auth_Final(&hcryp, &ctx1, tag, 8, 10) == HAL_ERROR, "payload short");
+  /* DMA start failure on a later pass (CCM runs two passes) */
+  CHECK(HAL_CRYPEx_AESCCM_Start(&hcryp, &ctx1, &akey, CRYP_AUTH_ENCRYPT, iv, 12, 0, 64, 8, 10) == HAL_OK, "start");
+  dma_starts = 0; dma_fail_at = 2;
+  int e = errs;
+  CHECK(HAL_CRYPEx_Auth_Update_DMA(&hcryp, &ctx1, bin, 64, bout) == HAL_OK, "dma start");
+  run_dma();
+  CHECK(errs == e + 1 && hcryp.State == HAL_CRYP_STATE_ERROR && hcryp.pAuthContext == NULL &&
+        hdma_in.State == HAL_DMA_STATE_READY && hdma_out.State == HAL_DMA_STATE_READY && (chan_out.CCR & DMA_CCR_MINC) && !(m_reg[0] & 1), "dma error path");
+  hcryp.State = HAL_CRYP_STATE_READY;
+  /* First start failure */
+  CHECK(HAL_CRYPEx_AESCCM_Start(&hcryp, &ctx1, &akey, CRYP_AUTH_ENCRYPT, iv, 12, 0, 64, 8, 10) == HAL_OK, "start");
+  dma_starts = 0; dma_fail_at = 0;
+  CHECK(HAL_CRYPEx_Auth_Update_DMA(&hcryp, &ctx1, bin, 64, bout) == HAL_ERROR && hcryp.State == HAL_CRYP_STATE_READY &&
+        (chan_out.CCR & DMA_CCR_MINC), "first start failure");
+  dma_fail_at = -1;
+  /* Busy while a DMA update runs */
+  CHECK(HAL_CRYPEx_AESGCM_Start(&hcryp, &ctx1, &akey, CRYP_AUTH_ENCRYPT, iv, 12, 10) == HAL_OK, "start");
+  CHECK(HAL_CRYPEx_Auth_Update_DMA(&hcryp, &ctx1, bin, 64, bout) == HAL_OK, "dma");
+  CHECK(HAL_CRYPEx_Auth_Update(&hcryp, &ctx2, bin, 64, bout, 10) != HAL_OK, "busy");
+  run_dma();
+  CHECK(hcryp.State == HAL_CRYP_STATE_READY, "ready");
+}
+
+int main(void)
+{
+  struct sigaction sa = {0};
+  aes_init_sbox();
+  page = mmap(NULL, 4096, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+  sa.sa_flags = SA_SIGINFO;
+  sa.sa_sigaction = on_segv;
+  sigaction(SIGSEGV, &sa, NULL);
+  sa.sa_sigaction = on_trap;
+  sigaction(SIGTRAP, &sa, NULL);
+  setvbuf(stdout, NULL, _IONBF, 0);
+
+  nist();
+  printf("nist: %d checks, %d failures\n", checks, failures);
+  sweep();
+  errors();
+  printf("model errors %d\n", m_errors);
+  printf("%d checks, %d failures\n", checks, failures);
+  return failures != 0 || m_errors != 0;
+}
@@ -0,0 +1,22 @@
+#!/bin/sh
+# Builds the UART driver with the USART and DMA model of uart_test.c,
+# at -O0 and -O2, and runs it.
+# build.sh [output directory]
+HERE=$(cd "$(dirname "$0")" && pwd)
+HAL=$HERE/../..
+CMSIS=$HERE/../../../CMSIS
+OUT=${1:-${TMPDIR:-/tmp}/uart_test}
+CC=${CC:-cc}
+mkdir -p "$OUT" || exit 1
+
+for O in O0 O2; do
+  $CC -$O -Wall -Wno-int-to-pointer-cast -Wno-pointer-to-int-cast -no-pie -fno-pie \
+    -DSTM32L082xx -DUSE_HAL_DRIVER -I"$HERE" -I"$HAL/Inc" \
+    -I"$CMSIS/Device/ST/STM32L0xx/Include" -I"$CMSIS/Include" \
+    -o "$OUT/uart_test_$O" "$HERE/uart_test.c" \
+    "$HAL/Src/stm32l0xx_hal_uart.c" "$HAL/Src/stm32l0xx_hal_uart_ex.c" || exit 1
+done
+for O in O0 O2; do
+  echo "== -$O"
+  "$OUT/uart_test_$O" || exit 1
+done
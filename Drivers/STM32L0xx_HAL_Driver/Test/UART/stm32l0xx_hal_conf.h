@@ -0,0 +1,2 @@
+/* Host stub: all the HAL modules, the test only uses the UART and DMA types */
+#include "stm32l0xx_hal_conf_template.h"
@@ -0,0 +1,371 @@
+/* Host test of the HAL UART reception ring: a model of the USART and of a
+ * circular DMA channel drives the real driver, with random interleaving of
+ * bursts, IDLE, half/full transfer interrupts and consumer reads. The ring
+ * head, available count and overruns are checked against the true write
+ * count. The DMA addresses are 32-bit, so the test is linked without PIE. */
+#include "stm32l0xx_hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static USART_TypeDef uart_regs;
+static DMA_Channel_TypeDef dma_regs;
+static DMA_HandleTypeDef hdma;
+static UART_HandleTypeDef huart;
+static UART_RxRingTypeDef ring;
+static uint8_t ringbuf[32768 + 64];
+
+static unsigned long checks, failures, ovr_consume, ovr_read, wraps;
+#define CHECK(c) do { checks++; if (!(c)) { failures++; if (failures < 30) printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #c); } } while (0)
+
+/* ---- stubs ---- */
+uint32_t HAL_GetTick(void) { static uint32_t t; return t++; }
+uint32_t HAL_RCC_GetPCLK1Freq(void) { return 32000000; }
+uint32_t HAL_RCC_GetPCLK2Freq(void) { return 32000000; }
+uint32_t HAL_RCC_GetSysClockFreq(void) { return 32000000; }
+void HAL_Delay(uint32_t d) { (void)d; }
+uint32_t HAL_DMA_GetError(DMA_HandleTypeDef *h) { return h->ErrorCode; }
+
+static uint32_t dma_dst, dma_len;
+static int dma_ht_pending, dma_tc_pending;
+
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *h, uint32_t src, uint32_t dst, uint32_t len)
+{
+  (void)src;
+  if (h->State != HAL_DMA_STATE_READY) return HAL_BUSY;
+  h->State = HAL_DMA_STATE_BUSY;
+  dma_dst = dst; dma_len = len;
+  h->Instance->CNDTR = len;
+  h->Instance->CCR = DMA_CCR_EN | DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_TEIE | (h->Init.Mode == DMA_CIRCULAR ? DMA_CCR_CIRC : 0);
+  dma_ht_pending = dma_tc_pending = 0;
+  return HAL_OK;
+}
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *h)
+{
+  h->Instance->CCR &= ~DMA_CCR_EN;
+  h->State = HAL_DMA_STATE_READY;
+  dma_ht_pending = dma_tc_pending = 0;
+  return HAL_OK;
+}
+HAL_StatusTypeDef HAL_DMA_Abort_IT(DMA_HandleTypeDef *h)
+{
+  HAL_DMA_Abort(h);
+  if (h->XferAbortCallback) h->XferAbortCallback(h);
+  return HAL_OK;
+}
+
+/* ---- callbacks ---- */
+static int events, errors_cb;
+static uint16_t last_pos;
+static uint32_t W; /* bytes written by the DMA since start */
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *h, uint16_t Pos)
+{
+  (void)h;
+  events++;
+  last_pos = Pos;
+  if (huart.pRxRing != NULL)
+  {
+    /* events are delivered with the DMA stopped: Head is exact */
+    CHECK(ring.Head == W); if (ring.Head != W && failures < 15) printf("head %u W %u size %u cnt %u\n", (unsigned)ring.Head, (unsigned)W, (unsigned)ring.Size, (unsigned)dma_regs.CNDTR);
+    CHECK(Pos == (uint16_t)(((W - 1U) & (ring.Size - 1U)) + 1U));
+  }
+}
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *h) { (void)h; errors_cb++; }
+
+/* ---- model ---- */
+static uint8_t stream_byte(uint32_t i) { uint32_t x = i * 2654435761U; return (uint8_t)(x >> 24 ^ x >> 9); }
+static int idle_armed;
+
+static void uart_irq(void)
+{
+  HAL_UART_IRQHandler(&huart);
+  uart_regs.ISR &= ~uart_regs.ICR;
+  uart_regs.ICR = 0;
+}
+
+static void dma_irq(void)
+{
+  /* HAL_DMA_IRQHandler: one flag per call, half transfer first */
+  if (dma_ht_pending) { dma_ht_pending = 0; if (hdma.XferHalfCpltCallback) hdma.XferHalfCpltCallback(&hdma); }
+  else if (dma_tc_pending) { dma_tc_pending = 0; if (hdma.XferCpltCallback) hdma.XferCpltCallback(&hdma); }
+}
+
+static void rx_byte(void)
+{
+  if ((uart_regs.CR3 & USART_CR3_DMAR) && (dma_regs.CCR & DMA_CCR_EN))
+  {
+    uint8_t *dst = (uint8_t *)(uintptr_t)dma_dst;
+    dst[dma_len - dma_regs.CNDTR] = stream_byte(W);
+    W++;
+    dma_regs.CNDTR--;
+    if (dma_regs.CNDTR == dma_len / 2) dma_ht_pending = 1;
+    if (dma_regs.CNDTR == 0)
+    {
+      dma_tc_pending = 1;
+      if (dma_regs.CCR & DMA_CCR_CIRC) dma_regs.CNDTR = dma_len;
+      else dma_regs.CCR &= ~DMA_CCR_EN;
+    }
+  }
+  idle_armed = 1;
+}
+
+static void line_idle(void)
+{
+  if (idle_armed) { idle_armed = 0; uart_regs.ISR |= USART_ISR_IDLE; }
+}
+
+/* deliver pending interrupts as the NVIC would (same priority, no preemption) */
+static void deliver(void)
+{
+  while (dma_ht_pending || dma_tc_pending) dma_irq();
+  if ((uart_regs.ISR & USART_ISR_IDLE) && (uart_regs.CR1 & USART_CR1_IDLEIE)) uart_irq();
+}
+
+static void setup(uint32_t mode)
+{
+  memset(&uart_regs, 0, sizeof uart_regs);
+  memset(&dma_regs, 0, sizeof dma_regs);
+  memset(&hdma, 0, sizeof hdma);
+  memset(&huart, 0, sizeof huart);
+  uart_regs.CR1 = USART_CR1_UE | USART_CR1_RE | USART_CR1_TE;
+  hdma.Instance = &dma_regs;
+  hdma.Init.Mode = mode;
+  hdma.State = HAL_DMA_STATE_READY;
+  hdma.Parent = &huart;
+  huart.Instance = &uart_regs;
+  huart.hdmarx = &hdma;
+  huart.Init.WordLength = UART_WORDLENGTH_8B;
+  huart.Init.Parity = UART_PARITY_NONE;
+  huart.gState = HAL_UART_STATE_READY;
+  huart.RxState = HAL_UART_STATE_READY;
+  W = 0; idle_armed = 0; events = 0; errors_cb = 0;
+}
+
+/* Random producer/consumer interleaving */
+static void random_run(uint16_t size, uint32_t steps, int burst_max, int lazy)
+{
+  uint32_t s;
+  uint32_t overruns_seen = 0;
+  setup(DMA_CIRCULAR);
+  CHECK(HAL_UARTEx_RxRing_Start(&huart, &ring, ringbuf, size) == HAL_OK);
+  CHECK(huart.pRxRing == &ring);
+
+  for (s = 0; s < steps; s++)
+  {
+    int op = rand() % 8;
+    if (op < 4)
+    {
+      /* a burst of bytes, events delivered at least every half buffer */
+      int n = rand() % (burst_max + 1);
+      while (n--)
+      {
+        rx_byte();
+        if ((dma_ht_pending || dma_tc_pending) && (rand() % 4 != 0 || dma_regs.CNDTR == dma_len / 2 + 1 || dma_regs.CNDTR == 1))
+        {
+          deliver();
+        }
+        if (W - ring.Head >= ring.Size - 1U) deliver();
+      }
+      if (rand() % 3 == 0) { deliver(); line_idle(); }
+      if (rand() % 2) deliver();
+    }
+    else if (op < 6)
+    {
+      /* zero copy read with concurrent reception before release */
+      uint8_t *p = NULL;
+      uint32_t tail = ring.Tail;
+      uint32_t n = HAL_UARTEx_RxRing_Peek(&huart, &p);
+      uint32_t w_at_peek = W;
+      uint32_t k, take, mism = 0;
+      HAL_StatusTypeDef st;
+      if (ring.Overruns != overruns_seen)
+      {
+        /* overrun detected by Peek: writer was more than a buffer ahead */
+        CHECK(ring.Tail == W);
+        overruns_seen = ring.Overruns;
+        tail = ring.Tail;
+      }
+      CHECK(n <= w_at_peek - tail);
+      if (n == 0) continue;
+      CHECK(p == &ringbuf[tail & (size - 1U)]);
+      CHECK(n <= size - (tail & (size - 1U)));
+      if (n < w_at_peek - tail) wraps++;
+      take = (uint32_t)rand() % (n + 1);
+      if (lazy)
+      {
+        int extra = rand() % (size + size / 2);
+        while (extra--) { rx_byte(); if (W - ring.Head >= ring.Size - 1U) deliver(); if (rand() % 3 == 0) deliver(); }
+        deliver();
+      }
+      for (k = 0; k < take; k++) if (p[k] != stream_byte(tail + k)) mism++;
+      st = HAL_UARTEx_RxRing_Consume(&huart, take);
+      if (W - tail > size)
+      {
+        ovr_consume++;
+        CHECK(st == HAL_ERROR);
+        CHECK(ring.Overruns == overruns_seen + 1);
+        CHECK(ring.Tail == W);
+        overruns_seen = ring.Overruns;
+      }
+      else
+      {
+        CHECK(st == HAL_OK);
+        CHECK(mism == 0);
+        CHECK(ring.Tail == tail + take);
+      }
+    }
+    else if (op == 6)
+    {
+      uint8_t out[700];
+      uint16_t len = 0xFFFF;
+      uint32_t tail = ring.Tail, k;
+      uint16_t want = (uint16_t)(1 + rand() % (sizeof out - 1));
+      uint32_t avail_true = W - tail;
+      HAL_StatusTypeDef st = HAL_UARTEx_RxRing_Read(&huart, out, want, &len);
+      if (avail_true > size)
+      {
+        ovr_read++;
+        CHECK(st == HAL_ERROR);
+        CHECK(len == 0);
+        CHECK(ring.Tail == W);
+        overruns_seen = ring.Overruns;
+      }
+      else
+      {
+        CHECK(st == HAL_OK);
+        CHECK(len == (avail_true < want ? avail_true : want));
+        for (k = 0; k < len; k++) CHECK(out[k] == stream_byte(tail + k));
+        CHECK(ring.Tail == tail + len);
+      }
+    }
+    else
+    {
+      uint32_t tail = ring.Tail;
+      uint32_t a = HAL_UARTEx_RxRing_Available(&huart);
+      if (W - tail > size) { CHECK(a == 0); CHECK(ring.Tail == W); overruns_seen = ring.Overruns; }
+      else CHECK(a == W - tail);
+    }
+    CHECK(huart.RxState == HAL_UART_STATE_BUSY_RX);
+  }
+}
+
+static void test_errors(void)
+{
+  uint16_t len;
+  uint8_t out[64];
+  uint32_t i;
+
+  setup(DMA_CIRCULAR);
+  CHECK(HAL_UARTEx_RxRing_Start(&huart, &ring, ringbuf, 64) == HAL_OK);
+  CHECK(HAL_UARTEx_RxRing_Start(&huart, &ring, ringbuf, 64) == HAL_BUSY);
+  for (i = 0; i < 10; i++) rx_byte();
+
+  /* framing error and overrun are not blocking in ring mode */
+  uart_regs.ISR |= USART_ISR_FE;
+  uart_irq();
+  uart_regs.ISR |= USART_ISR_ORE;
+  uart_irq();
+  CHECK(errors_cb == 2);
+  CHECK(huart.ErrorCode == HAL_UART_ERROR_NONE);
+  CHECK(huart.RxState == HAL_UART_STATE_BUSY_RX);
+  CHECK(uart_regs.CR3 & USART_CR3_DMAR);
+  CHECK(dma_regs.CCR & DMA_CCR_EN);
+  CHECK((uart_regs.ISR & (USART_ISR_FE | USART_ISR_ORE)) == 0);
+
+  /* IDLE event reports the received data */
+  line_idle();
+  deliver();
+  CHECK(events == 1 && last_pos == 10);
+  /* spurious IDLE without new data: no event */
+  uart_regs.ISR |= USART_ISR_IDLE;
+  uart_irq();
+  CHECK(events == 1);
+
+  /* exact wrap then IDLE: position reported as ring size */
+  for (i = 0; i < 54; i++) rx_byte();
+  deliver();
+  CHECK(last_pos == 64);
+  line_idle(); deliver();
+  CHECK(events == 2);
+
+  /* abort stops the reception, the data stays readable */
+  CHECK(HAL_UART_AbortReceive(&huart) == HAL_OK);
+  CHECK(huart.RxState == HAL_UART_STATE_READY);
+  CHECK((uart_regs.CR1 & USART_CR1_IDLEIE) == 0);
+  rx_byte(); /* not transferred */
+  CHECK(W == 64);
+  CHECK(HAL_UARTEx_RxRing_Available(&huart) == 64);
+  CHECK(HAL_UARTEx_RxRing_Read(&huart, out, 64, &len) == HAL_OK && len == 64);
+  for (i = 0; i < 64; i++) CHECK(out[i] == stream_byte(i));
+
+  /* restart */
+  W = 0;
+  CHECK(HAL_UARTEx_RxRing_Start(&huart, &ring, ringbuf, 64) == HAL_OK);
+  for (i = 0; i < 5; i++) rx_byte();
+  CHECK(HAL_UARTEx_RxRing_Read(&huart, out, 64, &len) == HAL_OK && len == 5);
+
+  /* DMA transfer error stops the reception */
+  errors_cb = 0;
+  hdma.XferErrorCallback(&hdma);
+  CHECK(errors_cb == 1);
+  CHECK(huart.ErrorCode & HAL_UART_ERROR_DMA);
+  CHECK(huart.RxState == HAL_UART_STATE_READY);
+  CHECK((uart_regs.CR3 & (USART_CR3_DMAR | USART_CR3_EIE)) == 0);
+
+  /* parameter checks */
+  setup(DMA_CIRCULAR);
+  CHECK(HAL_UARTEx_RxRing_Start(&huart, &ring, ringbuf, 48) == HAL_ERROR);
+  CHECK(HAL_UARTEx_RxRing_Start(&huart, &ring, ringbuf, 1) == HAL_ERROR);
+  CHECK(HAL_UARTEx_RxRing_Start(&huart, NULL, ringbuf, 64) == HAL_ERROR);
+  huart.Init.WordLength = UART_WORDLENGTH_9B;
+  CHECK(HAL_UARTEx_RxRing_Start(&huart, &ring, ringbuf, 64) == HAL_ERROR);
+  setup(DMA_NORMAL);
+  CHECK(HAL_UARTEx_RxRing_Start(&huart, &ring, ringbuf, 64) == HAL_ERROR);
+  CHECK(HAL_UARTEx_RxRing_Available(&huart) == 0);
+  CHECK(HAL_UARTEx_RxRing_Consume(&huart, 0) == HAL_ERROR);
+}
+
+static void test_legacy_to_idle(void)
+{
+  uint32_t i;
+  /* ReceiveToIdle_DMA after a ring: ring mode cleared, normal behaviour kept */
+  setup(DMA_CIRCULAR);
+  CHECK(HAL_UARTEx_RxRing_Start(&huart, &ring, ringbuf, 64) == HAL_OK);
+  CHECK(HAL_UART_AbortReceive(&huart) == HAL_OK);
+  hdma.Init.Mode = DMA_NORMAL;
+  W = 0;
+  CHECK(HAL_UARTEx_ReceiveToIdle_DMA(&huart, ringbuf, 32) == HAL_OK);
+  CHECK(huart.pRxRing == NULL);
+  for (i = 0; i < 7; i++) rx_byte();
+  line_idle(); deliver();
+  CHECK(events == 1 && last_pos == 7);
+  CHECK(huart.RxState == HAL_UART_STATE_READY);
+
+  /* error in DMA mode is still blocking outside ring mode */
+  errors_cb = 0;
+  CHECK(HAL_UART_Receive_DMA(&huart, ringbuf, 32) == HAL_OK);
+  uart_regs.ISR |= USART_ISR_FE;
+  uart_irq();
+  CHECK(errors_cb == 1);
+  CHECK(huart.RxState == HAL_UART_STATE_READY);
+  CHECK((uart_regs.CR3 & USART_CR3_DMAR) == 0);
+}
+
+int main(void)
+{
+  static const uint16_t sizes[] = { 2, 4, 16, 64, 256, 1024, 32768 };
+  unsigned i, r;
+  srand(1);
+  test_errors();
+  test_legacy_to_idle();
+  for (r = 0; r < 40; r++)
+    for (i = 0; i < sizeof sizes / sizeof sizes[0]; i++)
+    {
+      uint16_t sz = sizes[i];
+      random_run(sz, 3000, sz < 64 ? 6 : sz / 3, r & 1);
+    }
+  printf("overruns at consume %lu, at read %lu, split peeks %lu\n", ovr_consume, ovr_read, wraps);
+  printf("%lu checks, %lu failures\n", checks, failures);
+  return failures != 0;
+}
@@ -50,8 +50,15 @@ extern "C" {
 #define USBD_MAX_NUM_INTERFACES                       1U
 #endif /* USBD_AUDIO_FREQ */
 
+/* An isochronous endpoint of the USB FS device uses both buffers of its
+   endpoint register in one direction: the feedback endpoint cannot share the
+   number of the OUT one. Each gets its own two buffers in the packet memory,
+   in USBD_LL_Init() of usbd_conf.c, e.g. at 48 kHz after the EP0 buffers:
+     HAL_PCDEx_PMAConfig(pdev->pData, AUDIO_OUT_EP, PCD_DBL_BUF, 0x00C0U | (0x0184U << 16));
+     HAL_PCDEx_PMAConfig(pdev->pData, AUDIO_FB_EP, PCD_DBL_BUF, 0x0248U | (0x024CU << 16)); */
 #define AUDIO_OUT_EP                                  0x01U
-#define USB_AUDIO_CONFIG_DESC_SIZ                     0x6DU
+#define AUDIO_FB_EP                                   0x82U
+#define USB_AUDIO_CONFIG_DESC_SIZ                     0x76U
 #define AUDIO_INTERFACE_DESC_SIZE                     0x09U
 #define USB_AUDIO_DESC_SIZ                            0x09U
 #define AUDIO_STANDARD_ENDPOINT_DESC_SIZE             0x09U
@@ -86,6 +93,10 @@ extern "C" {
 
 #define AUDIO_ENDPOINT_GENERAL                        0x01U
 
+/* Endpoint attributes: isochronous asynchronous data, and explicit feedback */
+#define AUDIO_EP_ATTR_ASYNC                           0x05U
+#define AUDIO_EP_ATTR_FEEDBACK                        0x11U
+
 #define AUDIO_REQ_GET_CUR                             0x81U
 #define AUDIO_REQ_SET_CUR                             0x01U
 
@@ -93,14 +104,35 @@ extern "C" {
 
 
 #define AUDIO_OUT_PACKET                              (uint16_t)(((USBD_AUDIO_FREQ * 2U * 2U) / 1000U))
+/* Largest packet: the host sends one sample more than the rounded up nominal
+   rate when the feedback asks for more data */
+#define AUDIO_OUT_PACKET_MAX                          (uint16_t)((((USBD_AUDIO_FREQ + 999U) / 1000U) + 1U) * 2U * 2U)
 #define AUDIO_DEFAULT_VOLUME                          70U
 
 /* Number of sub-packets in the audio transfer buffer. You can modify this value but always make sure
   that it is an even number and higher than 3 */
-#define AUDIO_OUT_PACKET_NUM                          80U
+#ifndef AUDIO_OUT_PACKET_NUM
+#define AUDIO_OUT_PACKET_NUM                          16U
+#endif /* AUDIO_OUT_PACKET_NUM */
 /* Total size of the audio transfer buffer */
 #define AUDIO_TOTAL_BUF_SIZE                          ((uint16_t)(AUDIO_OUT_PACKET * AUDIO_OUT_PACKET_NUM))
 
+/* Buffered data (in packets) kept ahead of the codec. The playback starts with
+   AUDIO_OUT_TARGET_MIN packets, and one packet is added after each underrun,
+   up to half of the buffer */
+#ifndef AUDIO_OUT_TARGET_MIN
+#define AUDIO_OUT_TARGET_MIN                          2U
+#endif /* AUDIO_OUT_TARGET_MIN */
+#define AUDIO_OUT_TARGET_MAX                          (AUDIO_OUT_PACKET_NUM / 2U)
+
+/* The feedback is sent every 2^AUDIO_FB_REFRESH frames (bRefresh), with the
+   codec rate measured over this period */
+#ifndef AUDIO_FB_REFRESH
+#define AUDIO_FB_REFRESH                              4U
+#endif /* AUDIO_FB_REFRESH */
+/* Nominal feedback: samples per frame in 10.14 format */
+#define AUDIO_FB_NOMINAL                              ((uint32_t)((USBD_AUDIO_FREQ << 14) / 1000U))
+
 /* Audio Commands enumeration */
 typedef enum
 {
@@ -140,12 +172,30 @@ USBD_AUDIO_ControlTypeDef;
 typedef struct
 {
   uint32_t                  alt_setting;
-  uint8_t                   buffer[AUDIO_TOTAL_BUF_SIZE];
+  /* One packet of room past the end: the part of a packet received there is
+     moved to the start */
+  uint8_t                   buffer[AUDIO_TOTAL_BUF_SIZE + AUDIO_OUT_PACKET_MAX];
+  /* Receives the packets there is no room for, which are dropped */
+  uint8_t                   discard[AUDIO_OUT_PACKET_MAX];
+  uint8_t                   rx_discard;   /* The OUT endpoint receives in discard */
   AUDIO_OffsetTypeDef       offset;
   uint8_t                    rd_enable;
   uint16_t                   rd_ptr;
   uint16_t                   wr_ptr;
   USBD_AUDIO_ControlTypeDef control;
+  uint32_t                  feedback;     /* Sent on AUDIO_FB_EP, 10.14 format */
+  uint32_t                  rate;         /* Codec rate, 10.14 format, averaged */
+  uint32_t                  written;      /* Free running byte counts */
+  uint32_t                  played;
+  uint32_t                  played_mark;  /* played at the start of the feedback period */
+  uint32_t                  fill_sum;
+  uint16_t                  position;     /* Last codec position in buffer */
+  uint16_t                  target;       /* Buffered bytes aimed at */
+  uint16_t                  frames;       /* Frames in the feedback period */
+  uint16_t                  sync_ptr;     /* rd_ptr seen at the last SOF */
+  uint16_t                  sync_frames;  /* SOFs since rd_ptr changed */
+  uint32_t                  underruns;
+  uint32_t                  overruns;
 }
 USBD_AUDIO_HandleTypeDef;
 
@@ -159,6 +209,9 @@ typedef struct
   int8_t (*MuteCtl)(uint8_t cmd);
   int8_t (*PeriodicTC)(uint8_t cmd);
   int8_t (*GetState)(void);
+  /* Optional: byte offset in the buffer being played, from the DMA counter.
+     Without it the position is only known at each USBD_AUDIO_Sync() */
+  uint32_t (*GetPosition)(void);
 } USBD_AUDIO_ItfTypeDef;
 /**
   * @}
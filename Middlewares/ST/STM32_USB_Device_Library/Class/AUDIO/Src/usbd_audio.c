@@ -16,7 +16,7 @@
   *             - Configuration descriptor management
   *             - Standard AC Interface Descriptor management
   *             - 1 Audio Streaming Interface (with single channel, PCM, Stereo mode)
-  *             - 1 Audio Streaming Endpoint
+  *             - 1 Audio Streaming Endpoint, with its explicit feedback Endpoint
   *             - 1 Audio Terminal Input (1 channel)
   *             - Audio Class-Specific AC Interfaces
   *             - Audio Class-Specific AS Interfaces
@@ -33,6 +33,13 @@
   *             - Mute/Unmute capability
   *             - Asynchronous Endpoints
   *
+  *          The codec plays the audio buffer in a loop from AUDIO_CMD_START to
+  *          AUDIO_CMD_STOP. The feedback endpoint gives the host the codec rate,
+  *          measured from its position in the buffer (GetPosition callback, or
+  *          USBD_AUDIO_Sync() calls), and corrected to keep a small amount of
+  *          data ahead of the codec. This amount is raised after an underrun.
+  *          The SOF callback must be enabled in the low level driver.
+  *
   * @note     In HS mode and when the DMA is used, all variables and data structures
   *           dealing with the DMA during the transaction process should be 32-bit aligned.
   *
@@ -85,6 +92,11 @@ EndBSPDependencies */
 /** @defgroup USBD_AUDIO_Private_Defines
   * @{
   */
+/* The measured rate is averaged over 2^AUDIO_FB_FILTER feedback periods */
+#define AUDIO_FB_FILTER                4U
+/* A buffering error of 2^AUDIO_FB_GAIN samples changes the feedback by one
+   sample per frame */
+#define AUDIO_FB_GAIN                  6U
 /**
   * @}
   */
@@ -95,9 +107,6 @@ EndBSPDependencies */
   */
 #define AUDIO_SAMPLE_FREQ(frq)         (uint8_t)(frq), (uint8_t)((frq >> 8)), (uint8_t)((frq >> 16))
 
-#define AUDIO_PACKET_SZE(frq)          (uint8_t)(((frq * 2U * 2U)/1000U) & 0xFFU), \
-                                       (uint8_t)((((frq * 2U * 2U)/1000U) >> 8) & 0xFFU)
-
 /**
   * @}
   */
@@ -124,6 +133,11 @@ static uint8_t USBD_AUDIO_IsoINIncomplete(USBD_HandleTypeDef *pdev, uint8_t epnu
 static uint8_t USBD_AUDIO_IsoOutIncomplete(USBD_HandleTypeDef *pdev, uint8_t epnum);
 static void AUDIO_REQ_GetCurrent(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req);
 static void AUDIO_REQ_SetCurrent(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req);
+static void AUDIO_Reset(USBD_HandleTypeDef *pdev);
+static void AUDIO_PrepareReceive(USBD_HandleTypeDef *pdev);
+static void AUDIO_UpdatePosition(USBD_HandleTypeDef *pdev);
+static void AUDIO_Underrun(USBD_HandleTypeDef *pdev);
+static void AUDIO_UpdateFeedback(USBD_HandleTypeDef *pdev);
 
 /**
   * @}
@@ -157,7 +171,7 @@ __ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ] __ALI
   /* Configuration 1 */
   0x09,                                 /* bLength */
   USB_DESC_TYPE_CONFIGURATION,          /* bDescriptorType */
-  LOBYTE(USB_AUDIO_CONFIG_DESC_SIZ),    /* wTotalLength  109 bytes*/
+  LOBYTE(USB_AUDIO_CONFIG_DESC_SIZ),    /* wTotalLength  118 bytes*/
   HIBYTE(USB_AUDIO_CONFIG_DESC_SIZ),
   0x02,                                 /* bNumInterfaces */
   0x01,                                 /* bConfigurationValue */
@@ -248,7 +262,7 @@ __ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ] __ALI
   USB_DESC_TYPE_INTERFACE,        /* bDescriptorType */
   0x01,                                 /* bInterfaceNumber */
   0x01,                                 /* bAlternateSetting */
-  0x01,                                 /* bNumEndpoints */
+  0x02,                                 /* bNumEndpoints */
   USB_DEVICE_CLASS_AUDIO,               /* bInterfaceClass */
   AUDIO_SUBCLASS_AUDIOSTREAMING,        /* bInterfaceSubClass */
   AUDIO_PROTOCOL_UNDEFINED,             /* bInterfaceProtocol */
@@ -281,11 +295,12 @@ __ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ] __ALI
   AUDIO_STANDARD_ENDPOINT_DESC_SIZE,    /* bLength */
   USB_DESC_TYPE_ENDPOINT,               /* bDescriptorType */
   AUDIO_OUT_EP,                         /* bEndpointAddress 1 out endpoint*/
-  USBD_EP_TYPE_ISOC,                    /* bmAttributes */
-  AUDIO_PACKET_SZE(USBD_AUDIO_FREQ),    /* wMaxPacketSize in Bytes (Freq(Samples)*2(Stereo)*2(HalfWord)) */
+  AUDIO_EP_ATTR_ASYNC,                  /* bmAttributes */
+  LOBYTE(AUDIO_OUT_PACKET_MAX),         /* wMaxPacketSize in Bytes ((Freq(Samples)+1)*2(Stereo)*2(HalfWord)) */
+  HIBYTE(AUDIO_OUT_PACKET_MAX),
   0x01,                                 /* bInterval */
   0x00,                                 /* bRefresh */
-  0x00,                                 /* bSynchAddress */
+  AUDIO_FB_EP,                          /* bSynchAddress */
   /* 09 byte*/
 
   /* Endpoint - Audio Streaming Descriptor*/
@@ -297,6 +312,18 @@ __ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ] __ALI
   0x00,                                 /* wLockDelay */
   0x00,
   /* 07 byte*/
+
+  /* Endpoint 2 - Feedback Standard Descriptor */
+  AUDIO_STANDARD_ENDPOINT_DESC_SIZE,    /* bLength */
+  USB_DESC_TYPE_ENDPOINT,               /* bDescriptorType */
+  AUDIO_FB_EP,                          /* bEndpointAddress 2 in endpoint*/
+  AUDIO_EP_ATTR_FEEDBACK,               /* bmAttributes */
+  0x03,                                 /* wMaxPacketSize in Bytes (10.14 format) */
+  0x00,
+  0x01,                                 /* bInterval */
+  AUDIO_FB_REFRESH,                     /* bRefresh */
+  0x00,                                 /* bSynchAddress */
+  /* 09 byte*/
 } ;
 
 /* USB Standard Device Descriptor */
@@ -334,9 +361,13 @@ static uint8_t  USBD_AUDIO_Init(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
   USBD_AUDIO_HandleTypeDef   *haudio;
 
   /* Open EP OUT */
-  USBD_LL_OpenEP(pdev, AUDIO_OUT_EP, USBD_EP_TYPE_ISOC, AUDIO_OUT_PACKET);
+  USBD_LL_OpenEP(pdev, AUDIO_OUT_EP, USBD_EP_TYPE_ISOC, AUDIO_OUT_PACKET_MAX);
   pdev->ep_out[AUDIO_OUT_EP & 0xFU].is_used = 1U;
 
+  /* Open feedback EP IN */
+  USBD_LL_OpenEP(pdev, AUDIO_FB_EP, USBD_EP_TYPE_ISOC, 3U);
+  pdev->ep_in[AUDIO_FB_EP & 0xFU].is_used = 1U;
+
   /* Allocate Audio structure */
   pdev->pClassData = USBD_malloc(sizeof(USBD_AUDIO_HandleTypeDef));
 
@@ -348,10 +379,8 @@ static uint8_t  USBD_AUDIO_Init(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
   {
     haudio = (USBD_AUDIO_HandleTypeDef *) pdev->pClassData;
     haudio->alt_setting = 0U;
-    haudio->offset = AUDIO_OFFSET_UNKNOWN;
-    haudio->wr_ptr = 0U;
-    haudio->rd_ptr = 0U;
-    haudio->rd_enable = 0U;
+    haudio->underruns = 0U;
+    haudio->overruns = 0U;
 
     /* Initialize the Audio output Hardware layer */
     if (((USBD_AUDIO_ItfTypeDef *)pdev->pUserData)->Init(USBD_AUDIO_FREQ,
@@ -362,8 +391,7 @@ static uint8_t  USBD_AUDIO_Init(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
     }
 
     /* Prepare Out endpoint to receive 1st packet */
-    USBD_LL_PrepareReceive(pdev, AUDIO_OUT_EP, haudio->buffer,
-                           AUDIO_OUT_PACKET);
+    AUDIO_Reset(pdev);
   }
 
   return USBD_OK;
@@ -383,6 +411,10 @@ static uint8_t  USBD_AUDIO_DeInit(USBD_HandleTypeDef *pdev,
   USBD_LL_CloseEP(pdev, AUDIO_OUT_EP);
   pdev->ep_out[AUDIO_OUT_EP & 0xFU].is_used = 0U;
 
+  /* Close feedback EP IN */
+  USBD_LL_CloseEP(pdev, AUDIO_FB_EP);
+  pdev->ep_in[AUDIO_FB_EP & 0xFU].is_used = 0U;
+
   /* DeInit  physical Interface components */
   if (pdev->pClassData != NULL)
   {
@@ -475,6 +507,25 @@ static uint8_t  USBD_AUDIO_Setup(USBD_HandleTypeDef *pdev,
             if ((uint8_t)(req->wValue) <= USBD_MAX_NUM_INTERFACES)
             {
               haudio->alt_setting = (uint8_t)(req->wValue);
+
+              /* Audio Streaming interface: restart the stream */
+              if ((uint8_t)(req->wIndex) == 0x01U)
+              {
+                if (haudio->rd_enable == 1U)
+                {
+                  ((USBD_AUDIO_ItfTypeDef *)pdev->pUserData)->AudioCmd(&haudio->buffer[0],
+                                                                       0U,
+                                                                       AUDIO_CMD_STOP);
+                }
+                AUDIO_Reset(pdev);
+                USBD_LL_FlushEP(pdev, AUDIO_FB_EP);
+
+                if (haudio->alt_setting != 0U)
+                {
+                  USBD_LL_Transmit(pdev, AUDIO_FB_EP,
+                                   (uint8_t *)(void *)&haudio->feedback, 3U);
+                }
+              }
             }
             else
             {
@@ -529,7 +580,16 @@ static uint8_t  *USBD_AUDIO_GetCfgDesc(uint16_t *length)
   */
 static uint8_t  USBD_AUDIO_DataIn(USBD_HandleTypeDef *pdev, uint8_t epnum)
 {
-  /* Only OUT data are processed */
+  USBD_AUDIO_HandleTypeDef   *haudio;
+  haudio = (USBD_AUDIO_HandleTypeDef *) pdev->pClassData;
+
+  if ((epnum == (AUDIO_FB_EP & 0x7FU)) && (haudio->alt_setting != 0U))
+  {
+    /* Send the latest feedback at the next poll of the host */
+    USBD_LL_Transmit(pdev, AUDIO_FB_EP,
+                     (uint8_t *)(void *)&haudio->feedback, 3U);
+  }
+
   return USBD_OK;
 }
 
@@ -577,18 +637,54 @@ static uint8_t  USBD_AUDIO_EP0_TxReady(USBD_HandleTypeDef *pdev)
   */
 static uint8_t  USBD_AUDIO_SOF(USBD_HandleTypeDef *pdev)
 {
+  USBD_AUDIO_HandleTypeDef   *haudio;
+  int32_t fill;
+  haudio = (USBD_AUDIO_HandleTypeDef *) pdev->pClassData;
+
+  if (haudio->rd_enable == 1U)
+  {
+    if (haudio->rd_ptr != haudio->sync_ptr)
+    {
+      haudio->sync_ptr = haudio->rd_ptr;
+      haudio->sync_frames = 0U;
+    }
+    else
+    {
+      haudio->sync_frames++;
+    }
+
+    AUDIO_UpdatePosition(pdev);
+
+    fill = (int32_t)(haudio->written - haudio->played);
+    if (fill < 0)
+    {
+      /* No data came in time: the codec plays old data */
+      AUDIO_Underrun(pdev);
+      AUDIO_PrepareReceive(pdev);
+      fill = (int32_t)haudio->target;
+    }
+
+    haudio->fill_sum += (uint32_t)fill;
+    haudio->frames++;
+
+    if (haudio->frames == (1U << AUDIO_FB_REFRESH))
+    {
+      AUDIO_UpdateFeedback(pdev);
+    }
+  }
+
   return USBD_OK;
 }
 
 /**
-  * @brief  USBD_AUDIO_SOF
-  *         handle SOF event
+  * @brief  USBD_AUDIO_Sync
+  *         To be called by the codec at each half of the buffer played
   * @param  pdev: device instance
-  * @retval status
+  * @param  offset: AUDIO_OFFSET_HALF or AUDIO_OFFSET_FULL
+  * @retval None
   */
 void  USBD_AUDIO_Sync(USBD_HandleTypeDef *pdev, AUDIO_OffsetTypeDef offset)
 {
-  uint32_t cmd = 0U;
   USBD_AUDIO_HandleTypeDef   *haudio;
   haudio = (USBD_AUDIO_HandleTypeDef *) pdev->pClassData;
 
@@ -596,51 +692,17 @@ void  USBD_AUDIO_Sync(USBD_HandleTypeDef *pdev, AUDIO_OffsetTypeDef offset)
 
   if (haudio->rd_enable == 1U)
   {
-    haudio->rd_ptr += (uint16_t)(AUDIO_TOTAL_BUF_SIZE / 2U);
-
-    if (haudio->rd_ptr == AUDIO_TOTAL_BUF_SIZE)
-    {
-      /* roll back */
-      haudio->rd_ptr = 0U;
-    }
-  }
-
-  if (haudio->rd_ptr > haudio->wr_ptr)
-  {
-    if ((haudio->rd_ptr - haudio->wr_ptr) < AUDIO_OUT_PACKET)
-    {
-      cmd = AUDIO_TOTAL_BUF_SIZE / 2U + 4U;
-    }
-    else
-    {
-      if ((haudio->rd_ptr - haudio->wr_ptr) > (AUDIO_TOTAL_BUF_SIZE - AUDIO_OUT_PACKET))
-      {
-        cmd = AUDIO_TOTAL_BUF_SIZE / 2U - 4U;
-      }
-    }
-  }
-  else
-  {
-    if ((haudio->wr_ptr - haudio->rd_ptr) < AUDIO_OUT_PACKET)
+    /* The codec plays in a loop: only its position is tracked, the rate is
+       matched by the feedback */
+    if (offset == AUDIO_OFFSET_HALF)
     {
-      cmd = AUDIO_TOTAL_BUF_SIZE / 2U - 4U;
+      haudio->rd_ptr = (uint16_t)(AUDIO_TOTAL_BUF_SIZE / 2U);
     }
     else
     {
-      if ((haudio->wr_ptr - haudio->rd_ptr) > (AUDIO_TOTAL_BUF_SIZE - AUDIO_OUT_PACKET))
-      {
-        cmd = AUDIO_TOTAL_BUF_SIZE / 2U + 4U;
-      }
+      haudio->rd_ptr = 0U;
     }
   }
-
-  if (haudio->offset == AUDIO_OFFSET_FULL)
-  {
-    ((USBD_AUDIO_ItfTypeDef *)pdev->pUserData)->AudioCmd(&haudio->buffer[0],
-                                                         cmd,
-                                                         AUDIO_CMD_PLAY);
-    haudio->offset = AUDIO_OFFSET_NONE;
-  }
 }
 
 /**
@@ -675,39 +737,58 @@ static uint8_t  USBD_AUDIO_IsoOutIncomplete(USBD_HandleTypeDef *pdev, uint8_t ep
 static uint8_t  USBD_AUDIO_DataOut(USBD_HandleTypeDef *pdev, uint8_t epnum)
 {
   USBD_AUDIO_HandleTypeDef   *haudio;
+  uint32_t len;
+  uint32_t i;
+  int32_t fill;
   haudio = (USBD_AUDIO_HandleTypeDef *) pdev->pClassData;
 
   if (epnum == AUDIO_OUT_EP)
   {
-    /* Increment the Buffer pointer or roll it back when all buffers are full */
+    len = USBD_LL_GetRxDataSize(pdev, epnum);
 
-    haudio->wr_ptr += AUDIO_OUT_PACKET;
+    if (haudio->rd_enable == 1U)
+    {
+      AUDIO_UpdatePosition(pdev);
+    }
 
-    if (haudio->wr_ptr == AUDIO_TOTAL_BUF_SIZE)
+    fill = (int32_t)(haudio->written - haudio->played);
+    if (fill < 0)
     {
-      /* All buffers are full: roll back */
-      haudio->wr_ptr = 0U;
+      /* The packet came too late: drop it */
+      AUDIO_Underrun(pdev);
+    }
+    else if (haudio->rx_discard != 0U)
+    {
+      /* No room when the endpoint was prepared: drop the packet */
+      haudio->overruns++;
+    }
+    else
+    {
+      haudio->written += len;
+      haudio->wr_ptr += (uint16_t)len;
 
-      if (haudio->offset == AUDIO_OFFSET_UNKNOWN)
+      if (haudio->wr_ptr >= AUDIO_TOTAL_BUF_SIZE)
       {
-        ((USBD_AUDIO_ItfTypeDef *)pdev->pUserData)->AudioCmd(&haudio->buffer[0],
-                                                             AUDIO_TOTAL_BUF_SIZE / 2U,
-                                                             AUDIO_CMD_START);
-        haudio->offset = AUDIO_OFFSET_NONE;
+        /* Roll back, with the end of the packet */
+        haudio->wr_ptr -= AUDIO_TOTAL_BUF_SIZE;
+        for (i = 0U; i < haudio->wr_ptr; i++)
+        {
+          haudio->buffer[i] = haudio->buffer[AUDIO_TOTAL_BUF_SIZE + i];
+        }
       }
-    }
 
-    if (haudio->rd_enable == 0U)
-    {
-      if (haudio->wr_ptr == (AUDIO_TOTAL_BUF_SIZE / 2U))
+      if ((haudio->rd_enable == 0U) && (haudio->written >= haudio->target))
       {
         haudio->rd_enable = 1U;
+        ((USBD_AUDIO_ItfTypeDef *)pdev->pUserData)->AudioCmd(&haudio->buffer[0],
+                                                             AUDIO_TOTAL_BUF_SIZE / 2U,
+                                                             AUDIO_CMD_START);
+        haudio->offset = AUDIO_OFFSET_NONE;
       }
     }
 
     /* Prepare Out endpoint to receive next audio packet */
-    USBD_LL_PrepareReceive(pdev, AUDIO_OUT_EP, &haudio->buffer[haudio->wr_ptr],
-                           AUDIO_OUT_PACKET);
+    AUDIO_PrepareReceive(pdev);
   }
 
   return USBD_OK;
@@ -755,6 +836,200 @@ static void AUDIO_REQ_SetCurrent(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef
 }
 
 
+/**
+  * @brief  AUDIO_Reset
+  *         Empty the audio buffer, and prepare the reception of the stream
+  * @param  pdev: instance
+  * @retval None
+  */
+static void AUDIO_Reset(USBD_HandleTypeDef *pdev)
+{
+  USBD_AUDIO_HandleTypeDef   *haudio;
+  haudio = (USBD_AUDIO_HandleTypeDef *) pdev->pClassData;
+
+  haudio->offset = AUDIO_OFFSET_UNKNOWN;
+  haudio->wr_ptr = 0U;
+  haudio->rd_ptr = 0U;
+  haudio->rd_enable = 0U;
+  haudio->written = 0U;
+  haudio->played = 0U;
+  haudio->played_mark = 0U;
+  haudio->fill_sum = 0U;
+  haudio->position = 0U;
+  haudio->frames = 0U;
+  haudio->sync_ptr = 0U;
+  haudio->sync_frames = 0U;
+  haudio->target = (uint16_t)(AUDIO_OUT_PACKET * AUDIO_OUT_TARGET_MIN);
+  haudio->rate = AUDIO_FB_NOMINAL << AUDIO_FB_FILTER;
+  haudio->feedback = AUDIO_FB_NOMINAL;
+
+  AUDIO_PrepareReceive(pdev);
+}
+
+/**
+  * @brief  AUDIO_PrepareReceive
+  *         Prepare the reception of the next packet in the buffer, or aside
+  *         when the largest packet would overwrite data not played yet
+  * @param  pdev: instance
+  * @retval None
+  */
+static void AUDIO_PrepareReceive(USBD_HandleTypeDef *pdev)
+{
+  USBD_AUDIO_HandleTypeDef   *haudio;
+  int32_t fill;
+  haudio = (USBD_AUDIO_HandleTypeDef *) pdev->pClassData;
+
+  fill = (int32_t)(haudio->written - haudio->played);
+  if ((fill > 0) && (((uint32_t)fill + AUDIO_OUT_PACKET_MAX) > AUDIO_TOTAL_BUF_SIZE))
+  {
+    haudio->rx_discard = 1U;
+    USBD_LL_PrepareReceive(pdev, AUDIO_OUT_EP, haudio->discard,
+                           AUDIO_OUT_PACKET_MAX);
+  }
+  else
+  {
+    haudio->rx_discard = 0U;
+    USBD_LL_PrepareReceive(pdev, AUDIO_OUT_EP, &haudio->buffer[haudio->wr_ptr],
+                           AUDIO_OUT_PACKET_MAX);
+  }
+}
+
+/**
+  * @brief  AUDIO_UpdatePosition
+  *         Count the bytes played since the last call
+  * @param  pdev: instance
+  * @retval None
+  */
+static void AUDIO_UpdatePosition(USBD_HandleTypeDef *pdev)
+{
+  USBD_AUDIO_HandleTypeDef   *haudio;
+  USBD_AUDIO_ItfTypeDef      *itf;
+  uint32_t position;
+  haudio = (USBD_AUDIO_HandleTypeDef *) pdev->pClassData;
+  itf = (USBD_AUDIO_ItfTypeDef *)pdev->pUserData;
+
+  if (itf->GetPosition != NULL)
+  {
+    position = itf->GetPosition();
+  }
+  else
+  {
+    /* Interpolated from the last USBD_AUDIO_Sync() at the nominal rate, up to
+       the next one. Counted to the end of the frame, so that the codec is not
+       ahead of it */
+    position = haudio->rd_ptr;
+    if (position == haudio->sync_ptr)
+    {
+      position += MIN(((uint32_t)haudio->sync_frames + 1U) * AUDIO_OUT_PACKET,
+                      AUDIO_TOTAL_BUF_SIZE / 2U);
+      if (position >= AUDIO_TOTAL_BUF_SIZE)
+      {
+        position -= AUDIO_TOTAL_BUF_SIZE;
+      }
+    }
+  }
+
+  if (position < haudio->position)
+  {
+    position += AUDIO_TOTAL_BUF_SIZE;
+  }
+  haudio->played += position - haudio->position;
+
+  if (position >= AUDIO_TOTAL_BUF_SIZE)
+  {
+    position -= AUDIO_TOTAL_BUF_SIZE;
+  }
+  haudio->position = (uint16_t)position;
+}
+
+/**
+  * @brief  AUDIO_Underrun
+  *         Silence the old data, and continue the stream one more packet
+  *         ahead of the codec
+  * @param  pdev: instance
+  * @retval None
+  */
+static void AUDIO_Underrun(USBD_HandleTypeDef *pdev)
+{
+  USBD_AUDIO_HandleTypeDef   *haudio;
+  uint32_t i;
+  haudio = (USBD_AUDIO_HandleTypeDef *) pdev->pClassData;
+
+  haudio->underruns++;
+
+  if (haudio->target < (AUDIO_OUT_PACKET * AUDIO_OUT_TARGET_MAX))
+  {
+    haudio->target += AUDIO_OUT_PACKET;
+  }
+
+  haudio->wr_ptr = haudio->position;
+  for (i = 0U; i < haudio->target; i++)
+  {
+    haudio->buffer[haudio->wr_ptr] = 0U;
+    haudio->wr_ptr++;
+    if (haudio->wr_ptr == AUDIO_TOTAL_BUF_SIZE)
+    {
+      haudio->wr_ptr = 0U;
+    }
+  }
+  haudio->written = haudio->played + haudio->target;
+}
+
+/**
+  * @brief  AUDIO_UpdateFeedback
+  *         Compute the feedback from the codec rate and the buffered data
+  * @param  pdev: instance
+  * @retval None
+  */
+static void AUDIO_UpdateFeedback(USBD_HandleTypeDef *pdev)
+{
+  USBD_AUDIO_HandleTypeDef   *haudio;
+  int32_t error;
+  int32_t feedback;
+  haudio = (USBD_AUDIO_HandleTypeDef *) pdev->pClassData;
+
+  error = (int32_t)haudio->target - (int32_t)(haudio->fill_sum >> AUDIO_FB_REFRESH);
+  haudio->fill_sum = 0U;
+  haudio->frames = 0U;
+
+  if (((USBD_AUDIO_ItfTypeDef *)pdev->pUserData)->GetPosition != NULL)
+  {
+    /* Bytes played in 2^AUDIO_FB_REFRESH frames to samples per frame, in
+       10.14 format, averaged */
+    haudio->rate -= haudio->rate >> AUDIO_FB_FILTER;
+    haudio->rate += (haudio->played - haudio->played_mark) << (12U - AUDIO_FB_REFRESH);
+  }
+  else
+  {
+    /* The position leads half a packet on average, and is too coarse to
+       measure the rate: integrate the error instead, critically damped with
+       the proportional term below. Not while the feedback is at its limits */
+    error -= (int32_t)(AUDIO_OUT_PACKET / 2U);
+    if ((haudio->feedback > (AUDIO_FB_NOMINAL - (1U << 13))) &&
+        (haudio->feedback < (AUDIO_FB_NOMINAL + (1U << 13))))
+    {
+      haudio->rate = (uint32_t)((int32_t)haudio->rate +
+                                (error * (1 << (AUDIO_FB_REFRESH + AUDIO_FB_FILTER + 10U - (2U * AUDIO_FB_GAIN)))));
+    }
+  }
+  haudio->played_mark = haudio->played;
+
+  /* Byte error to samples per frame, in 10.14 format */
+  feedback = (int32_t)(haudio->rate >> AUDIO_FB_FILTER);
+  feedback += error * (1 << (12U - AUDIO_FB_GAIN));
+
+  /* Within half a sample of the nominal rate */
+  if (feedback > (int32_t)(AUDIO_FB_NOMINAL + (1U << 13)))
+  {
+    feedback = (int32_t)(AUDIO_FB_NOMINAL + (1U << 13));
+  }
+  if (feedback < (int32_t)(AUDIO_FB_NOMINAL - (1U << 13)))
+  {
+    feedback = (int32_t)(AUDIO_FB_NOMINAL - (1U << 13));
+  }
+  haudio->feedback = (uint32_t)feedback;
+}
+
 /**
 * @brief  DeviceQualifierDescriptor
 *         return Device Qualifier descriptor
@@ -82,6 +82,7 @@ USBD_AUDIO_ItfTypeDef USBD_AUDIO_Template_fops =
   TEMPLATE_MuteCtl,
   TEMPLATE_PeriodicTC,
   TEMPLATE_GetState,
+  NULL,                  /* GetPosition: interpolated from USBD_AUDIO_Sync() */
 };
 
 /* Private functions ---------------------------------------------------------*/
@@ -167,6 +168,7 @@ static int8_t TEMPLATE_GetState(void)
 {
   return (0);
 }
+
 /**
   * @}
   */
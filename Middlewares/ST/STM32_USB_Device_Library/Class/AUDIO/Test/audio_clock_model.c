@@ -0,0 +1,212 @@
+/* Host model of the clock skew between a full speed USB audio stream and the
+ * codec, run against usbd_audio.c (see build.sh).
+ * Host: 1 ms frames, one OUT packet per frame; with feedback, the packet size
+ * follows the last feedback read (polled every 2^bRefresh frames, applied
+ * FB_DELAY frames later), else nominal 48 samples.
+ * Device: codec consuming one stereo sample every 1/(48 kHz * (1 + skew))
+ * from the class buffer in a loop (circular DMA), with half/full transfer
+ * callbacks calling USBD_AUDIO_Sync(), and AUDIO_CMD_PLAY restarting the DMA
+ * at the buffer start with the given size (as BSP_AUDIO_OUT_ChangeBuffer).
+ * Samples carry their index: the model counts discontinuities heard.
+ * Usage: audio_clock_model [skew ppm] [seconds] [packets lost every 2 s]
+ * HOSTFAST=1: the host ignores the feedback and sends one sample too many
+ * every 4 frames. RESTART=1: the stream is restarted every 10 s.
+ * Without lost packets or restart, fails if a sample is heard twice (the
+ * buffer was overwritten before being played) or, unless HOSTFAST, on any
+ * glitch. After an underrun the codec replays old data by design. */
+#include <math.h>
+#include "usbd_audio.h"
+#include "usbd_ctlreq.h"
+
+#define FB_DELAY 3
+static double now;                /* ns */
+static uint64_t rng = 88172645463325252ULL;
+static double urand(void) { rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17; return (rng >> 11) * (1.0 / 9007199254740992.0); }
+
+/* USB endpoints */
+static uint8_t *out_buf; static uint16_t out_size; static int out_armed; static uint32_t out_len;
+static uint8_t *in_buf; static int in_armed;
+static long host_trunc;
+
+USBD_StatusTypeDef USBD_LL_Transmit(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t *pbuf, uint16_t size)
+{ in_buf = pbuf; in_armed = 1; return USBD_OK; }
+USBD_StatusTypeDef USBD_LL_PrepareReceive(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t *pbuf, uint16_t size)
+{ out_buf = pbuf; out_size = size; out_armed = 1; return USBD_OK; }
+uint32_t USBD_LL_GetRxDataSize(USBD_HandleTypeDef *pdev, uint8_t ep_addr) { return out_len; }
+USBD_StatusTypeDef USBD_LL_OpenEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t ep_type, uint16_t ep_mps) { return USBD_OK; }
+USBD_StatusTypeDef USBD_LL_CloseEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr) { return USBD_OK; }
+USBD_StatusTypeDef USBD_LL_FlushEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr) { in_armed = 0; return USBD_OK; }
+USBD_StatusTypeDef USBD_CtlSendData(USBD_HandleTypeDef *pdev, uint8_t *pbuf, uint16_t len) { return USBD_OK; }
+USBD_StatusTypeDef USBD_CtlPrepareRx(USBD_HandleTypeDef *pdev, uint8_t *pbuf, uint16_t len) { return USBD_OK; }
+void USBD_CtlError(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req) { }
+
+/* Codec */
+static int running; static uint8_t *dma_buf; static uint32_t dma_len, dma_pos;
+static double next_sample, ts;
+static USBD_HandleTypeDef dev;
+
+static int8_t Itf_Init(uint32_t f, uint32_t v, uint32_t o) { return 0; }
+static int8_t Itf_DeInit(uint32_t o) { return 0; }
+static int8_t Itf_Cmd(uint8_t *pbuf, uint32_t size, uint8_t cmd)
+{
+  switch (cmd)
+  {
+    case AUDIO_CMD_START:
+      running = 1; next_sample = now + ts;
+      dma_buf = pbuf; dma_len = 2 * size; dma_pos = 0;
+      break;
+    case AUDIO_CMD_PLAY:
+      /* A DMA restart of 0 bytes fails, and the DMA goes on */
+      if (size != 0) { dma_buf = pbuf; dma_len = 2 * size; dma_pos = 0; }
+      break;
+    case AUDIO_CMD_STOP:
+      running = 0;
+      break;
+  }
+  return 0;
+}
+static int8_t Itf_Vol(uint8_t v) { return 0; }
+static int8_t Itf_Mute(uint8_t c) { return 0; }
+static int8_t Itf_TC(uint8_t c) { return 0; }
+static int8_t Itf_State(void) { return 0; }
+#ifndef SIM_NOPOS
+static uint32_t Itf_Position(void) { return dma_pos; }
+#endif
+static USBD_AUDIO_ItfTypeDef fops =
+{
+  Itf_Init, Itf_DeInit, Itf_Cmd, Itf_Vol, Itf_Mute, Itf_TC, Itf_State,
+#ifndef SIM_NOPOS
+  Itf_Position,
+#else
+  NULL,
+#endif
+};
+
+/* Heard stream */
+static double *arrival;           /* per sample index, ns */
+static long nsamples, last_seq = -1, glitches, silent, skipped, repeated, heard;
+static int in_silence;
+static double lat_sum, lat_max; static long lat_n;
+
+static void play_sample(void)
+{
+  uint8_t *p = dma_buf + dma_pos;
+  uint32_t l = p[0] | (p[1] << 8), r = p[2] | (p[3] << 8);
+  if (l == 0 && r == 0)
+  {
+    if (!in_silence && last_seq >= 0) glitches++;
+    in_silence = 1; silent++;
+  }
+  else
+  {
+    long seq = (long)(l | ((r & 0x7FFF) << 16));
+    if (last_seq >= 0 && seq != last_seq + 1 && !in_silence) { glitches++;}
+    if (last_seq >= 0 && seq > last_seq + 1) skipped += seq - last_seq - 1;
+    if (last_seq >= 0 && seq <= last_seq) repeated++;
+    if (seq == last_seq + 1 && seq < nsamples && arrival[seq] > 0)
+    {
+      double lat = (now - arrival[seq]) / 1e6;
+      lat_sum += lat; lat_n++; if (now > 5e9 && lat > lat_max) lat_max = lat;
+    }
+    in_silence = 0; last_seq = seq; heard++;
+  }
+  dma_pos += 4;
+  if (dma_pos == dma_len / 2) USBD_AUDIO_Sync(&dev, AUDIO_OFFSET_HALF);
+  if (dma_pos >= dma_len) { dma_pos = 0; USBD_AUDIO_Sync(&dev, AUDIO_OFFSET_FULL); }
+}
+
+static void run_codec(double until)
+{
+  while (running && next_sample <= until)
+  {
+    now = next_sample; play_sample(); next_sample += ts;
+  }
+  now = until;
+}
+
+int main(int argc, char **argv)
+{
+  double ppm = argc > 1 ? atof(argv[1]) : 0;
+  int seconds = argc > 2 ? atoi(argv[2]) : 60;
+  int burst = argc > 3 ? atoi(argv[3]) : 0;     /* packets lost every 2 s */
+  long lost = 0;
+  long frames = seconds * 1000L, f;
+  uint32_t fb_host = (USBD_AUDIO_FREQ << 14) / 1000, fb_queue[FB_DELAY + 1], acc = 0;
+  long fb_at[FB_DELAY + 1]; int i;
+  long seq = 0;
+  USBD_SetupReqTypedef req = { 0x01, USB_REQ_SET_INTERFACE, 1, 1, 0 };
+
+  ts = 1e9 / (USBD_AUDIO_FREQ * (1.0 + ppm * 1e-6));
+  nsamples = frames * 50; arrival = calloc(nsamples, sizeof(double));
+  for (i = 0; i <= FB_DELAY; i++) fb_at[i] = -1;
+  dev.dev_state = USBD_STATE_CONFIGURED; dev.pClass = &USBD_AUDIO;
+  USBD_AUDIO_RegisterInterface(&dev, &fops);
+  USBD_AUDIO.Init(&dev, 0);
+  USBD_AUDIO.Setup(&dev, &req);
+
+  for (f = 0; f < frames; f++)
+  {
+    double t = f * 1e6;
+    uint32_t n, k;
+    for (i = 0; i <= FB_DELAY; i++) if (fb_at[i] == f) { fb_host = fb_queue[i]; fb_at[i] = -1; }
+    /* Stream restart through alternate setting 0 */
+    if (getenv("RESTART") && f % 10000 == 5000)
+    {
+      USBD_SetupReqTypedef r0 = { 0x01, USB_REQ_SET_INTERFACE, 0, 1, 0 };
+      USBD_AUDIO.Setup(&dev, &r0);
+      last_seq = -1;
+    }
+    if (getenv("RESTART") && f % 10000 == 5100) USBD_AUDIO.Setup(&dev, &req);
+    /* SOF interrupt */
+    run_codec(t + urand() * 20e3);
+    USBD_AUDIO.SOF(&dev);
+    /* OUT packet */
+    acc += fb_host; n = acc >> 14; acc &= 0x3FFF;
+    /* Host ignoring the feedback, faster than the codec */
+    if (getenv("HOSTFAST")) n = (USBD_AUDIO_FREQ + 999) / 1000 + ((f % 4) == 0);
+    run_codec(t + 150e3 + urand() * 100e3);
+    if (burst && (f % 2000) >= 1000 && (f % 2000) < 1000 + burst)
+    {
+      lost += n; seq += n;
+    }
+    else if (out_armed)
+    {
+      if (n * 4 > out_size) { host_trunc++; n = out_size / 4; }
+      for (k = 0; k < n; k++, seq++)
+      {
+        out_buf[4 * k] = seq; out_buf[4 * k + 1] = seq >> 8;
+        out_buf[4 * k + 2] = seq >> 16; out_buf[4 * k + 3] = 0x80 | ((seq >> 24) & 0x7F);
+        if (seq < nsamples) arrival[seq] = now;
+      }
+      out_len = 4 * n; out_armed = 0;
+      USBD_AUDIO.DataOut(&dev, AUDIO_OUT_EP);
+    }
+    else seq += n;
+    /* Feedback poll */
+    if ((f % (1 << AUDIO_FB_REFRESH)) == 0 && in_armed)
+    {
+      run_codec(t + 600e3);
+      for (i = 0; i <= FB_DELAY; i++) if (fb_at[i] < 0) break;
+      fb_queue[i] = in_buf[0] | (in_buf[1] << 8) | (in_buf[2] << 16); fb_at[i] = f + FB_DELAY;
+      in_armed = 0;
+      USBD_AUDIO.DataIn(&dev, AUDIO_FB_EP & 0x7F);
+    }
+  }
+  run_codec(frames * 1e6);
+  {
+    USBD_AUDIO_HandleTypeDef *h = dev.pClassData;
+    printf("skew %+6.0f ppm: glitches %5ld (%.2f/min)  skipped %7ld  repeated %7ld  silent %6ld  latency avg %6.2f ms max %6.2f ms",
+           ppm, glitches, glitches * 60.0 / seconds, skipped, repeated, silent, lat_n ? lat_sum / lat_n : 0, lat_max);
+    printf("  underruns %lu overruns %lu target %u fb %.4f", (unsigned long)h->underruns, (unsigned long)h->overruns,
+           h->target, h->feedback / 16384.0);
+    if (lost) printf("  lost %ld", lost);
+    if (host_trunc) printf("  host_trunc %ld", host_trunc);
+    printf("\n");
+    if (!burst && !getenv("RESTART") && ((repeated != 0) || (glitches != 0 && !getenv("HOSTFAST"))))
+    {
+      printf("FAILED\n");
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,17 @@
+#!/bin/sh
+# Builds the audio clock model (audio_clock_model.c) against usbd_audio.c on
+# the host and runs it over a few clock skews and host behaviours.
+# build.sh [output directory]; extra defines in CFLAGS, e.g.
+# CFLAGS=-DSIM_NOPOS for an interface without GetPosition, or
+# CFLAGS=-DUSBD_AUDIO_FREQ=96000U
+HERE=$(cd "$(dirname "$0")" && pwd)
+LIB=$HERE/../../..
+OUT=${1:-${TMPDIR:-/tmp}/audio_clock_test}
+CC=${CC:-cc}
+mkdir -p "$OUT" || exit 1
+$CC -O2 -Wall -Wextra -Wno-unused-parameter -Wno-sign-compare \
+  -Wno-missing-field-initializers $CFLAGS -I"$HERE" -I"$LIB/Core/Inc" \
+  -I"$HERE/../Inc" -o "$OUT/audio_clock_model" "$HERE/audio_clock_model.c" \
+  "$HERE/../Src/usbd_audio.c" -lm || exit 1
+M=$OUT/audio_clock_model
+$M 0 && $M 1000 && $M -1000 && $M 100 60 3 && RESTART=1 $M 300 && HOSTFAST=1 $M
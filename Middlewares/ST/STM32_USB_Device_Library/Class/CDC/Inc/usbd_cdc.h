@@ -107,6 +107,13 @@ typedef struct _USBD_CDC_Itf
 
 } USBD_CDC_ItfTypeDef;
 
+typedef struct
+{
+  uint8_t       *Buffer;
+  uint32_t      Size;                 /* Power of 2 */
+  __IO uint32_t In;                   /* Free running indexes */
+  __IO uint32_t Out;
+} USBD_CDC_RingTypeDef;
 
 typedef struct
 {
@@ -120,6 +127,12 @@ typedef struct
 
   __IO uint32_t TxState;
   __IO uint32_t RxState;
+
+  USBD_CDC_RingTypeDef TxRing;        /* Used when set by USBD_CDC_SetTxRing() */
+  USBD_CDC_RingTypeDef RxRing;        /* Used when set by USBD_CDC_SetRxRing() */
+
+  uint8_t  InEpAdd;                   /* Data endpoint addresses in the device */
+  uint8_t  OutEpAdd;
 }
 USBD_CDC_HandleTypeDef;
 
@@ -159,6 +172,22 @@ uint8_t  USBD_CDC_SetRxBuffer(USBD_HandleTypeDef   *pdev,
 uint8_t  USBD_CDC_ReceivePacket(USBD_HandleTypeDef *pdev);
 
 uint8_t  USBD_CDC_TransmitPacket(USBD_HandleTypeDef *pdev);
+
+uint8_t  USBD_CDC_SetTxRing(USBD_HandleTypeDef   *pdev,
+                            uint8_t  *pbuff,
+                            uint32_t size);
+
+uint8_t  USBD_CDC_SetRxRing(USBD_HandleTypeDef   *pdev,
+                            uint8_t  *pbuff,
+                            uint32_t size);
+
+uint32_t USBD_CDC_Write(USBD_HandleTypeDef *pdev,
+                        const uint8_t *pbuff,
+                        uint32_t length);
+
+uint32_t USBD_CDC_Read(USBD_HandleTypeDef *pdev,
+                       uint8_t *pbuff,
+                       uint32_t length);
 /**
   * @}
   */
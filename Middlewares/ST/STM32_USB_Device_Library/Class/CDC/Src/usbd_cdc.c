@@ -89,6 +89,15 @@ EndBSPDependencies */
 /** @defgroup USBD_CDC_Private_Macros
   * @{
   */
+/* The rings are shared with the application, which can write or read them
+   from an interrupt of any priority */
+#define CDC_ENTER_CRITICAL(primask)   do { (primask) = __get_PRIMASK(); __disable_irq(); } while (0)
+#define CDC_EXIT_CRITICAL(primask)    __set_PRIMASK(primask)
+
+#define CDC_IN_PACKET_SIZE(pdev)      (((pdev)->dev_speed == USBD_SPEED_HIGH) ? \
+                                       CDC_DATA_HS_IN_PACKET_SIZE : CDC_DATA_FS_IN_PACKET_SIZE)
+#define CDC_OUT_PACKET_SIZE(pdev)     (((pdev)->dev_speed == USBD_SPEED_HIGH) ? \
+                                       CDC_DATA_HS_OUT_PACKET_SIZE : CDC_DATA_FS_OUT_PACKET_SIZE)
 
 /**
   * @}
@@ -127,6 +136,10 @@ static uint8_t  *USBD_CDC_GetOtherSpeedCfgDesc(uint16_t *length);
 
 uint8_t  *USBD_CDC_GetDeviceQualifierDescriptor(uint16_t *length);
 
+static void USBD_CDC_TransmitRing(USBD_HandleTypeDef *pdev);
+
+static void USBD_CDC_ReceiveRing(USBD_HandleTypeDef *pdev);
+
 /* USB Standard Device Descriptor */
 __ALIGN_BEGIN static uint8_t USBD_CDC_DeviceQualifierDesc[USB_LEN_DEV_QUALIFIER_DESC] __ALIGN_END =
 {
@@ -472,67 +485,82 @@ static uint8_t  USBD_CDC_Init(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
 {
   uint8_t ret = 0U;
   USBD_CDC_HandleTypeDef   *hcdc;
+  uint8_t in_ep = USBD_CLASS_EP(pdev, &USBD_CDC, CDC_IN_EP);
+  uint8_t out_ep = USBD_CLASS_EP(pdev, &USBD_CDC, CDC_OUT_EP);
+  uint8_t cmd_ep = USBD_CLASS_EP(pdev, &USBD_CDC, CDC_CMD_EP);
 
   if (pdev->dev_speed == USBD_SPEED_HIGH)
   {
     /* Open EP IN */
-    USBD_LL_OpenEP(pdev, CDC_IN_EP, USBD_EP_TYPE_BULK,
+    USBD_LL_OpenEP(pdev, in_ep, USBD_EP_TYPE_BULK,
                    CDC_DATA_HS_IN_PACKET_SIZE);
 
-    pdev->ep_in[CDC_IN_EP & 0xFU].is_used = 1U;
+    pdev->ep_in[in_ep & 0xFU].is_used = 1U;
 
     /* Open EP OUT */
-    USBD_LL_OpenEP(pdev, CDC_OUT_EP, USBD_EP_TYPE_BULK,
+    USBD_LL_OpenEP(pdev, out_ep, USBD_EP_TYPE_BULK,
                    CDC_DATA_HS_OUT_PACKET_SIZE);
 
-    pdev->ep_out[CDC_OUT_EP & 0xFU].is_used = 1U;
+    pdev->ep_out[out_ep & 0xFU].is_used = 1U;
 
   }
   else
   {
     /* Open EP IN */
-    USBD_LL_OpenEP(pdev, CDC_IN_EP, USBD_EP_TYPE_BULK,
+    USBD_LL_OpenEP(pdev, in_ep, USBD_EP_TYPE_BULK,
                    CDC_DATA_FS_IN_PACKET_SIZE);
 
-    pdev->ep_in[CDC_IN_EP & 0xFU].is_used = 1U;
+    pdev->ep_in[in_ep & 0xFU].is_used = 1U;
 
     /* Open EP OUT */
-    USBD_LL_OpenEP(pdev, CDC_OUT_EP, USBD_EP_TYPE_BULK,
+    USBD_LL_OpenEP(pdev, out_ep, USBD_EP_TYPE_BULK,
                    CDC_DATA_FS_OUT_PACKET_SIZE);
 
-    pdev->ep_out[CDC_OUT_EP & 0xFU].is_used = 1U;
+    pdev->ep_out[out_ep & 0xFU].is_used = 1U;
   }
   /* Open Command IN EP */
-  USBD_LL_OpenEP(pdev, CDC_CMD_EP, USBD_EP_TYPE_INTR, CDC_CMD_PACKET_SIZE);
-  pdev->ep_in[CDC_CMD_EP & 0xFU].is_used = 1U;
+  USBD_LL_OpenEP(pdev, cmd_ep, USBD_EP_TYPE_INTR, CDC_CMD_PACKET_SIZE);
+  pdev->ep_in[cmd_ep & 0xFU].is_used = 1U;
 
-  pdev->pClassData = USBD_malloc(sizeof(USBD_CDC_HandleTypeDef));
+  USBD_CLASS_DATA(pdev, &USBD_CDC) = USBD_malloc(sizeof(USBD_CDC_HandleTypeDef));
 
-  if (pdev->pClassData == NULL)
+  if (USBD_CLASS_DATA(pdev, &USBD_CDC) == NULL)
   {
     ret = 1U;
   }
   else
   {
-    hcdc = (USBD_CDC_HandleTypeDef *) pdev->pClassData;
+    hcdc = (USBD_CDC_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_CDC);
+    hcdc->InEpAdd = in_ep;
+    hcdc->OutEpAdd = out_ep;
+
+    /* The rings are set, if used, by the interface Init */
+    hcdc->TxRing.Buffer = NULL;
+    hcdc->RxRing.Buffer = NULL;
 
     /* Init  physical Interface components */
-    ((USBD_CDC_ItfTypeDef *)pdev->pUserData)->Init();
+    ((USBD_CDC_ItfTypeDef *)USBD_USER_DATA(pdev, &USBD_CDC))->Init();
 
     /* Init Xfer states */
     hcdc->TxState = 0U;
     hcdc->RxState = 0U;
 
-    if (pdev->dev_speed == USBD_SPEED_HIGH)
+    if (hcdc->RxRing.Buffer != NULL)
+    {
+      /* Prepare Out endpoint to receive in the empty RX ring */
+      hcdc->RxState = 1U;
+      USBD_CDC_ReceiveRing(pdev);
+    }
+    else if (pdev->dev_speed == USBD_SPEED_HIGH)
     {
       /* Prepare Out endpoint to receive next packet */
-      USBD_LL_PrepareReceive(pdev, CDC_OUT_EP, hcdc->RxBuffer,
+      USBD_LL_PrepareReceive(pdev, out_ep, hcdc->RxBuffer,
                              CDC_DATA_HS_OUT_PACKET_SIZE);
     }
     else
     {
       /* Prepare Out endpoint to receive next packet */
-      USBD_LL_PrepareReceive(pdev, CDC_OUT_EP, hcdc->RxBuffer,
+      USBD_LL_PrepareReceive(pdev, out_ep, hcdc->RxBuffer,
                              CDC_DATA_FS_OUT_PACKET_SIZE);
     }
   }
@@ -549,25 +577,28 @@ static uint8_t  USBD_CDC_Init(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
 static uint8_t  USBD_CDC_DeInit(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
 {
   uint8_t ret = 0U;
+  uint8_t in_ep = USBD_CLASS_EP(pdev, &USBD_CDC, CDC_IN_EP);
+  uint8_t out_ep = USBD_CLASS_EP(pdev, &USBD_CDC, CDC_OUT_EP);
+  uint8_t cmd_ep = USBD_CLASS_EP(pdev, &USBD_CDC, CDC_CMD_EP);
 
   /* Close EP IN */
-  USBD_LL_CloseEP(pdev, CDC_IN_EP);
-  pdev->ep_in[CDC_IN_EP & 0xFU].is_used = 0U;
+  USBD_LL_CloseEP(pdev, in_ep);
+  pdev->ep_in[in_ep & 0xFU].is_used = 0U;
 
   /* Close EP OUT */
-  USBD_LL_CloseEP(pdev, CDC_OUT_EP);
-  pdev->ep_out[CDC_OUT_EP & 0xFU].is_used = 0U;
+  USBD_LL_CloseEP(pdev, out_ep);
+  pdev->ep_out[out_ep & 0xFU].is_used = 0U;
 
   /* Close Command IN EP */
-  USBD_LL_CloseEP(pdev, CDC_CMD_EP);
-  pdev->ep_in[CDC_CMD_EP & 0xFU].is_used = 0U;
+  USBD_LL_CloseEP(pdev, cmd_ep);
+  pdev->ep_in[cmd_ep & 0xFU].is_used = 0U;
 
   /* DeInit  physical Interface components */
-  if (pdev->pClassData != NULL)
+  if (USBD_CLASS_DATA(pdev, &USBD_CDC) != NULL)
   {
-    ((USBD_CDC_ItfTypeDef *)pdev->pUserData)->DeInit();
-    USBD_free(pdev->pClassData);
-    pdev->pClassData = NULL;
+    ((USBD_CDC_ItfTypeDef *)USBD_USER_DATA(pdev, &USBD_CDC))->DeInit();
+    USBD_free(USBD_CLASS_DATA(pdev, &USBD_CDC));
+    USBD_CLASS_DATA(pdev, &USBD_CDC) = NULL;
   }
 
   return ret;
@@ -583,7 +614,7 @@ static uint8_t  USBD_CDC_DeInit(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
 static uint8_t  USBD_CDC_Setup(USBD_HandleTypeDef *pdev,
                                USBD_SetupReqTypedef *req)
 {
-  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) pdev->pClassData;
+  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_CDC);
   uint8_t ifalt = 0U;
   uint16_t status_info = 0U;
   uint8_t ret = USBD_OK;
@@ -595,9 +626,9 @@ static uint8_t  USBD_CDC_Setup(USBD_HandleTypeDef *pdev,
       {
         if (req->bmRequest & 0x80U)
         {
-          ((USBD_CDC_ItfTypeDef *)pdev->pUserData)->Control(req->bRequest,
-                                                            (uint8_t *)(void *)hcdc->data,
-                                                            req->wLength);
+          ((USBD_CDC_ItfTypeDef *)USBD_USER_DATA(pdev, &USBD_CDC))->Control(req->bRequest,
+                                                                            (uint8_t *)(void *)hcdc->data,
+                                                                            req->wLength);
 
           USBD_CtlSendData(pdev, (uint8_t *)(void *)hcdc->data, req->wLength);
         }
@@ -611,8 +642,8 @@ static uint8_t  USBD_CDC_Setup(USBD_HandleTypeDef *pdev,
       }
       else
       {
-        ((USBD_CDC_ItfTypeDef *)pdev->pUserData)->Control(req->bRequest,
-                                                          (uint8_t *)(void *)req, 0U);
+        ((USBD_CDC_ItfTypeDef *)USBD_USER_DATA(pdev, &USBD_CDC))->Control(req->bRequest,
+                                                                          (uint8_t *)(void *)req, 0U);
       }
       break;
 
@@ -676,12 +707,48 @@ static uint8_t  USBD_CDC_Setup(USBD_HandleTypeDef *pdev,
   */
 static uint8_t  USBD_CDC_DataIn(USBD_HandleTypeDef *pdev, uint8_t epnum)
 {
-  USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef *)pdev->pClassData;
+  USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_CDC);
   PCD_HandleTypeDef *hpcd = pdev->pData;
+  uint32_t primask;
+  uint8_t zlp;
+  uint8_t busy = 1U;
 
-  if (pdev->pClassData != NULL)
+  if (USBD_CLASS_DATA(pdev, &USBD_CDC) != NULL)
   {
-    if ((pdev->ep_in[epnum].total_length > 0U) && ((pdev->ep_in[epnum].total_length % hpcd->IN_ep[epnum].maxpacket) == 0U))
+    if (hcdc->TxRing.Buffer != NULL)
+    {
+      /* Release the data sent */
+      hcdc->TxRing.Out += hcdc->TxLength;
+
+      /* A transfer of full packets is ended by a ZLP, unless more data follow */
+      zlp = ((hcdc->TxLength != 0U) && ((hcdc->TxLength % CDC_IN_PACKET_SIZE(pdev)) == 0U)) ? 1U : 0U;
+
+      CDC_ENTER_CRITICAL(primask);
+      if ((hcdc->TxRing.In == hcdc->TxRing.Out) && (zlp == 0U))
+      {
+        hcdc->TxState = 0U;
+        busy = 0U;
+      }
+      CDC_EXIT_CRITICAL(primask);
+
+      if (busy == 0U)
+      {
+        /* Nothing to send, USBD_CDC_Write() starts the next transfer */
+      }
+      else if (hcdc->TxRing.In != hcdc->TxRing.Out)
+      {
+        USBD_CDC_TransmitRing(pdev);
+      }
+      else
+      {
+        hcdc->TxLength = 0U;
+        pdev->ep_in[epnum].total_length = 0U;
+
+        /* Send ZLP */
+        USBD_LL_Transmit(pdev, epnum, NULL, 0U);
+      }
+    }
+    else if ((pdev->ep_in[epnum].total_length > 0U) && ((pdev->ep_in[epnum].total_length % hpcd->IN_ep[epnum].maxpacket) == 0U))
     {
       /* Update the packet total length */
       pdev->ep_in[epnum].total_length = 0U;
@@ -710,16 +777,55 @@ static uint8_t  USBD_CDC_DataIn(USBD_HandleTypeDef *pdev, uint8_t epnum)
   */
 static uint8_t  USBD_CDC_DataOut(USBD_HandleTypeDef *pdev, uint8_t epnum)
 {
-  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) pdev->pClassData;
+  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_CDC);
+  USBD_CDC_RingTypeDef     *ring;
+  uint32_t primask;
+  uint32_t in;
+  uint32_t i;
+  uint8_t busy = 1U;
 
   /* Get the received data length */
   hcdc->RxLength = USBD_LL_GetRxDataSize(pdev, epnum);
 
   /* USB data will be immediately processed, this allow next USB traffic being
   NAKed till the end of the application Xfer */
-  if (pdev->pClassData != NULL)
+  if (USBD_CLASS_DATA(pdev, &USBD_CDC) != NULL)
   {
-    ((USBD_CDC_ItfTypeDef *)pdev->pUserData)->Receive(hcdc->RxBuffer, &hcdc->RxLength);
+    if (hcdc->RxRing.Buffer != NULL)
+    {
+      ring = &hcdc->RxRing;
+      in = ring->In & (ring->Size - 1U);
+
+      /* Move the end of a packet received past the ring to its start. The
+         whole packet stays contiguous for the Receive callback */
+      for (i = ring->Size; i < (in + hcdc->RxLength); i++)
+      {
+        ring->Buffer[i - ring->Size] = ring->Buffer[i];
+      }
+      ring->In += hcdc->RxLength;
+
+      /* Notify the interface, the data are read by USBD_CDC_Read() */
+      ((USBD_CDC_ItfTypeDef *)USBD_USER_DATA(pdev, &USBD_CDC))->Receive(&ring->Buffer[in], &hcdc->RxLength);
+
+      /* NAK the host while the ring cannot take a full packet, until
+         USBD_CDC_Read() frees enough of it */
+      CDC_ENTER_CRITICAL(primask);
+      if ((ring->Size - (ring->In - ring->Out)) < CDC_OUT_PACKET_SIZE(pdev))
+      {
+        hcdc->RxState = 0U;
+        busy = 0U;
+      }
+      CDC_EXIT_CRITICAL(primask);
+
+      if (busy != 0U)
+      {
+        USBD_CDC_ReceiveRing(pdev);
+      }
+    }
+    else
+    {
+      ((USBD_CDC_ItfTypeDef *)USBD_USER_DATA(pdev, &USBD_CDC))->Receive(hcdc->RxBuffer, &hcdc->RxLength);
+    }
 
     return USBD_OK;
   }
@@ -737,13 +843,13 @@ static uint8_t  USBD_CDC_DataOut(USBD_HandleTypeDef *pdev, uint8_t epnum)
   */
 static uint8_t  USBD_CDC_EP0_RxReady(USBD_HandleTypeDef *pdev)
 {
-  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) pdev->pClassData;
+  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_CDC);
 
-  if ((pdev->pUserData != NULL) && (hcdc->CmdOpCode != 0xFFU))
+  if ((USBD_USER_DATA(pdev, &USBD_CDC) != NULL) && (hcdc->CmdOpCode != 0xFFU))
   {
-    ((USBD_CDC_ItfTypeDef *)pdev->pUserData)->Control(hcdc->CmdOpCode,
-                                                      (uint8_t *)(void *)hcdc->data,
-                                                      (uint16_t)hcdc->CmdLength);
+    ((USBD_CDC_ItfTypeDef *)USBD_USER_DATA(pdev, &USBD_CDC))->Control(hcdc->CmdOpCode,
+                                                                      (uint8_t *)(void *)hcdc->data,
+                                                                      (uint16_t)hcdc->CmdLength);
     hcdc->CmdOpCode = 0xFFU;
 
   }
@@ -814,7 +920,7 @@ uint8_t  USBD_CDC_RegisterInterface(USBD_HandleTypeDef   *pdev,
 
   if (fops != NULL)
   {
-    pdev->pUserData = fops;
+    USBD_USER_DATA(pdev, &USBD_CDC) = fops;
     ret = USBD_OK;
   }
 
@@ -831,7 +937,7 @@ uint8_t  USBD_CDC_SetTxBuffer(USBD_HandleTypeDef   *pdev,
                               uint8_t  *pbuff,
                               uint16_t length)
 {
-  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) pdev->pClassData;
+  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_CDC);
 
   hcdc->TxBuffer = pbuff;
   hcdc->TxLength = length;
@@ -849,7 +955,7 @@ uint8_t  USBD_CDC_SetTxBuffer(USBD_HandleTypeDef   *pdev,
 uint8_t  USBD_CDC_SetRxBuffer(USBD_HandleTypeDef   *pdev,
                               uint8_t  *pbuff)
 {
-  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) pdev->pClassData;
+  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_CDC);
 
   hcdc->RxBuffer = pbuff;
 
@@ -864,9 +970,9 @@ uint8_t  USBD_CDC_SetRxBuffer(USBD_HandleTypeDef   *pdev,
   */
 uint8_t  USBD_CDC_TransmitPacket(USBD_HandleTypeDef *pdev)
 {
-  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) pdev->pClassData;
+  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_CDC);
 
-  if (pdev->pClassData != NULL)
+  if (USBD_CLASS_DATA(pdev, &USBD_CDC) != NULL)
   {
     if (hcdc->TxState == 0U)
     {
@@ -874,10 +980,10 @@ uint8_t  USBD_CDC_TransmitPacket(USBD_HandleTypeDef *pdev)
       hcdc->TxState = 1U;
 
       /* Update the packet total length */
-      pdev->ep_in[CDC_IN_EP & 0xFU].total_length = hcdc->TxLength;
+      pdev->ep_in[hcdc->InEpAdd & 0xFU].total_length = hcdc->TxLength;
 
       /* Transmit next packet */
-      USBD_LL_Transmit(pdev, CDC_IN_EP, hcdc->TxBuffer,
+      USBD_LL_Transmit(pdev, hcdc->InEpAdd, hcdc->TxBuffer,
                        (uint16_t)hcdc->TxLength);
 
       return USBD_OK;
@@ -902,16 +1008,16 @@ uint8_t  USBD_CDC_TransmitPacket(USBD_HandleTypeDef *pdev)
   */
 uint8_t  USBD_CDC_ReceivePacket(USBD_HandleTypeDef *pdev)
 {
-  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) pdev->pClassData;
+  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_CDC);
 
   /* Suspend or Resume USB Out process */
-  if (pdev->pClassData != NULL)
+  if (USBD_CLASS_DATA(pdev, &USBD_CDC) != NULL)
   {
     if (pdev->dev_speed == USBD_SPEED_HIGH)
     {
       /* Prepare Out endpoint to receive next packet */
       USBD_LL_PrepareReceive(pdev,
-                             CDC_OUT_EP,
+                             hcdc->OutEpAdd,
                              hcdc->RxBuffer,
                              CDC_DATA_HS_OUT_PACKET_SIZE);
     }
@@ -919,7 +1025,7 @@ uint8_t  USBD_CDC_ReceivePacket(USBD_HandleTypeDef *pdev)
     {
       /* Prepare Out endpoint to receive next packet */
       USBD_LL_PrepareReceive(pdev,
-                             CDC_OUT_EP,
+                             hcdc->OutEpAdd,
                              hcdc->RxBuffer,
                              CDC_DATA_FS_OUT_PACKET_SIZE);
     }
@@ -930,6 +1036,234 @@ uint8_t  USBD_CDC_ReceivePacket(USBD_HandleTypeDef *pdev)
     return USBD_FAIL;
   }
 }
+
+/**
+  * @brief  USBD_CDC_SetTxRing
+  *         Send the data through a ring, written by USBD_CDC_Write(). To be
+  *         called from the interface Init, instead of USBD_CDC_SetTxBuffer()
+  * @param  pdev: device instance
+  * @param  pbuff: Tx ring buffer
+  * @param  size: size of the ring, a power of 2 of at least 2 packets
+  * @retval status
+  */
+uint8_t  USBD_CDC_SetTxRing(USBD_HandleTypeDef   *pdev,
+                            uint8_t  *pbuff,
+                            uint32_t size)
+{
+  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_CDC);
+
+  if ((hcdc == NULL) || (pbuff == NULL) || (size < (2U * CDC_IN_PACKET_SIZE(pdev))) ||
+      (size > 0x10000U) || ((size & (size - 1U)) != 0U))
+  {
+    return USBD_FAIL;
+  }
+
+  hcdc->TxRing.Buffer = pbuff;
+  hcdc->TxRing.Size = size;
+  hcdc->TxRing.In = 0U;
+  hcdc->TxRing.Out = 0U;
+
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_CDC_SetRxRing
+  *         Receive the data in a ring, read by USBD_CDC_Read(). To be called
+  *         from the interface Init, instead of USBD_CDC_SetRxBuffer()
+  * @param  pdev: device instance
+  * @param  pbuff: Rx ring buffer, of size plus one OUT packet bytes: a packet
+  *         is received past the end of the ring before being moved to its start
+  * @param  size: size of the ring, a power of 2 of at least 1 packet
+  * @retval status
+  */
+uint8_t  USBD_CDC_SetRxRing(USBD_HandleTypeDef   *pdev,
+                            uint8_t  *pbuff,
+                            uint32_t size)
+{
+  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_CDC);
+
+  if ((hcdc == NULL) || (pbuff == NULL) || (size < CDC_OUT_PACKET_SIZE(pdev)) ||
+      ((size & (size - 1U)) != 0U))
+  {
+    return USBD_FAIL;
+  }
+
+  hcdc->RxRing.Buffer = pbuff;
+  hcdc->RxRing.Size = size;
+  hcdc->RxRing.In = 0U;
+  hcdc->RxRing.Out = 0U;
+
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_CDC_Write
+  *         Copy data to the Tx ring, and start their transmission if the IN
+  *         endpoint is idle. The data written while it is busy are sent
+  *         together by the next transfer
+  * @param  pdev: device instance
+  * @param  pbuff: data to send
+  * @param  length: number of bytes to send
+  * @retval number of bytes copied, less than length when the ring is full
+  */
+uint32_t USBD_CDC_Write(USBD_HandleTypeDef *pdev,
+                        const uint8_t *pbuff,
+                        uint32_t length)
+{
+  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_CDC);
+  USBD_CDC_RingTypeDef     *ring;
+  uint32_t primask;
+  uint32_t count;
+  uint32_t in;
+  uint32_t i;
+  uint8_t start = 0U;
+
+  if ((hcdc == NULL) || (hcdc->TxRing.Buffer == NULL))
+  {
+    return 0U;
+  }
+
+  ring = &hcdc->TxRing;
+  count = ring->Size - (ring->In - ring->Out);
+  if (length < count)
+  {
+    count = length;
+  }
+
+  in = ring->In;
+  for (i = 0U; i < count; i++)
+  {
+    ring->Buffer[(in + i) & (ring->Size - 1U)] = pbuff[i];
+  }
+  ring->In = in + count;
+
+  if (count != 0U)
+  {
+    CDC_ENTER_CRITICAL(primask);
+    if (hcdc->TxState == 0U)
+    {
+      hcdc->TxState = 1U;
+      start = 1U;
+    }
+    CDC_EXIT_CRITICAL(primask);
+
+    if (start != 0U)
+    {
+      USBD_CDC_TransmitRing(pdev);
+    }
+  }
+
+  return count;
+}
+
+/**
+  * @brief  USBD_CDC_Read
+  *         Copy the data received from the Rx ring, and resume the reception
+  *         if it was held because the ring was full
+  * @param  pdev: device instance
+  * @param  pbuff: buffer for the data
+  * @param  length: size of the buffer
+  * @retval number of bytes copied
+  */
+uint32_t USBD_CDC_Read(USBD_HandleTypeDef *pdev,
+                       uint8_t *pbuff,
+                       uint32_t length)
+{
+  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_CDC);
+  USBD_CDC_RingTypeDef     *ring;
+  uint32_t primask;
+  uint32_t count;
+  uint32_t out;
+  uint32_t i;
+  uint8_t start = 0U;
+
+  if ((hcdc == NULL) || (hcdc->RxRing.Buffer == NULL))
+  {
+    return 0U;
+  }
+
+  ring = &hcdc->RxRing;
+  count = ring->In - ring->Out;
+  if (length < count)
+  {
+    count = length;
+  }
+
+  out = ring->Out;
+  for (i = 0U; i < count; i++)
+  {
+    pbuff[i] = ring->Buffer[(out + i) & (ring->Size - 1U)];
+  }
+  ring->Out = out + count;
+
+  if (count != 0U)
+  {
+    CDC_ENTER_CRITICAL(primask);
+    if ((hcdc->RxState == 0U) &&
+        ((ring->Size - (ring->In - ring->Out)) >= CDC_OUT_PACKET_SIZE(pdev)))
+    {
+      hcdc->RxState = 1U;
+      start = 1U;
+    }
+    CDC_EXIT_CRITICAL(primask);
+
+    if (start != 0U)
+    {
+      USBD_CDC_ReceiveRing(pdev);
+    }
+  }
+
+  return count;
+}
+
+/**
+  * @brief  USBD_CDC_TransmitRing
+  *         Send the data of the Tx ring, up to its end. A transfer takes at
+  *         most half of the ring, which is refilled meanwhile
+  * @param  pdev: device instance
+  * @retval None
+  */
+static void USBD_CDC_TransmitRing(USBD_HandleTypeDef *pdev)
+{
+  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_CDC);
+  USBD_CDC_RingTypeDef     *ring = &hcdc->TxRing;
+  uint32_t out = ring->Out & (ring->Size - 1U);
+  uint32_t len = ring->In - ring->Out;
+
+  if (len > (ring->Size - out))
+  {
+    len = ring->Size - out;
+  }
+  if (len > (ring->Size / 2U))
+  {
+    len = ring->Size / 2U;
+  }
+
+  hcdc->TxLength = len;
+
+  /* Update the packet total length */
+  pdev->ep_in[hcdc->InEpAdd & 0xFU].total_length = len;
+
+  /* Transmit next packet */
+  USBD_LL_Transmit(pdev, hcdc->InEpAdd, &ring->Buffer[out], (uint16_t)len);
+}
+
+/**
+  * @brief  USBD_CDC_ReceiveRing
+  *         Prepare OUT Endpoint for reception in the Rx ring, which has room
+  *         for a full packet
+  * @param  pdev: device instance
+  * @retval None
+  */
+static void USBD_CDC_ReceiveRing(USBD_HandleTypeDef *pdev)
+{
+  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_CDC);
+  USBD_CDC_RingTypeDef     *ring = &hcdc->RxRing;
+
+  USBD_LL_PrepareReceive(pdev, hcdc->OutEpAdd,
+                         &ring->Buffer[ring->In & (ring->Size - 1U)],
+                         (uint16_t)CDC_OUT_PACKET_SIZE(pdev));
+}
 /**
   * @}
   */
@@ -0,0 +1,29 @@
+#!/bin/sh
+# Builds the CDC ring model (cdc_ring_model.c) against usbd_cdc.c on the host
+# and runs its randomized rounds for 9 seeds, then the benchmark.
+# build.sh [output directory]; CDC=<class directory> builds another copy of
+# the class, e.g. CDC=<older Class/CDC> CFLAGS=-DSIM_BASE for the figures
+# before the rings. That build reports the data overwritten by the former
+# flush as failures.
+HERE=$(cd "$(dirname "$0")" && pwd)
+LIB=$HERE/../../..
+CDC=${CDC:-$HERE/..}
+OUT=${1:-${TMPDIR:-/tmp}/cdc_ring_test}
+CC=${CC:-cc}
+mkdir -p "$OUT" || exit 1
+$CC -O2 -Wall -Wno-unused-parameter -Wno-unused-function $CFLAGS -I"$HERE" \
+  -I"$LIB/Core/Inc" -I"$CDC/Inc" -o "$OUT/cdc_ring_model" \
+  "$HERE/cdc_ring_model.c" "$CDC/Src/usbd_cdc.c" || exit 1
+M=$OUT/cdc_ring_model
+
+if echo "$CFLAGS" | grep -q SIM_BASE; then
+  $M base
+  exit $?
+fi
+SEED=2
+while [ $SEED -le 9 ]; do
+  R=$(SEED=$SEED $M seed$SEED) || { echo "$R"; exit 1; }
+  echo "$R" | tail -1
+  SEED=$((SEED + 1))
+done
+SEED=1 $M seed1
@@ -0,0 +1,511 @@
+/* USB FS bulk endpoint model, host CDC driver and application contexts for
+   the CDC class. Discrete time: a high priority application interrupt, the
+   USB interrupt and the thread mode; the endpoint only loads its next
+   packet from the USB interrupt. Preemption is also simulated at the
+   critical section boundaries of the class.
+   Randomized rounds check the data both ways, with writers in the thread or
+   in the application interrupt, then the write latency and throughput are
+   measured. cdc_ring_model [name]; SEED=<n> changes the random sequence,
+   ROUNDS=<n> the number of rounds, NOTEST=1 runs the benchmark only.
+   -DSIM_BASE builds it against the class and application scheme before the
+   rings: a buffer flushed by a 5 ms timer. */
+#include "usbd_cdc.h"
+
+#define PKT      64U
+#define RING     1024U
+#define URB      4096U
+
+static uint64_t now;
+static int level;                 /* 0 thread, 1 USB interrupt, 2 application interrupt */
+static uint32_t primask;
+static unsigned long checks, failures;
+#define CHECK(c) do { checks++; if (!(c)) { failures++; if (failures < 30) printf("FAIL %d %s (t=%llu)\n", __LINE__, #c, (unsigned long long)now); } } while (0)
+
+static uint64_t t_isr = 4000U, t_call = 2000U, t_byte = 300U;
+static uint64_t pkt_ns(uint32_t n) { return 10000U + n * 667U; }
+
+static uint32_t seed = 1U;
+__attribute__((constructor)) static void seed_init(void) { if (getenv("SEED")) seed = (uint32_t)atoi(getenv("SEED")); }
+static uint32_t rnd(uint32_t n) { seed = seed * 1103515245U + 12345U; return (seed >> 8) % n; }
+
+static USBD_HandleTypeDef dev;
+static PCD_HandleTypeDef pcd;
+
+/* ---------------- endpoints ---------------- */
+typedef struct
+{
+  uint8_t *buf;
+  uint32_t len, off, pkt;
+  int busy, valid, ctr;
+  uint8_t pma[PKT];
+} ep_t;
+static ep_t ein, eout;
+static uint8_t *rx_lo, *rx_hi;    /* memory the OUT endpoint may write */
+
+USBD_StatusTypeDef USBD_LL_Transmit(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t *pbuf, uint16_t size)
+{
+  CHECK((ep_addr & 0x7FU) == (CDC_IN_EP & 0x7FU));
+  CHECK(!ein.busy);
+  ein.buf = pbuf; ein.len = size; ein.off = 0; ein.busy = 1;
+  ein.pkt = size < PKT ? size : PKT;
+  if (ein.pkt) memcpy(ein.pma, pbuf, ein.pkt);
+  ein.valid = 1;
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_PrepareReceive(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t *pbuf, uint16_t size)
+{
+  CHECK(ep_addr == CDC_OUT_EP);
+  CHECK(!eout.busy);
+  CHECK(pbuf >= rx_lo && pbuf + size <= rx_hi);
+  eout.buf = pbuf; eout.len = size; eout.off = 0; eout.busy = 1;
+  eout.valid = 1;
+  return USBD_OK;
+}
+
+uint32_t USBD_LL_GetRxDataSize(USBD_HandleTypeDef *pdev, uint8_t ep_addr) { return eout.off; }
+USBD_StatusTypeDef USBD_LL_OpenEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t ep_type, uint16_t ep_mps) { return USBD_OK; }
+USBD_StatusTypeDef USBD_LL_CloseEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr) { return USBD_OK; }
+USBD_StatusTypeDef USBD_CtlSendData(USBD_HandleTypeDef *pdev, uint8_t *pbuf, uint16_t len) { return USBD_OK; }
+USBD_StatusTypeDef USBD_CtlPrepareRx(USBD_HandleTypeDef *pdev, uint8_t *pbuf, uint16_t len) { return USBD_OK; }
+void USBD_CtlError(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req) { }
+
+/* ---------------- host ---------------- */
+static uint8_t urb[URB];
+static uint32_t urb_len;
+static uint32_t h_rx;             /* bytes delivered to the host application */
+static uint32_t h_tx, h_tx_end;   /* bytes sent by the host, to send */
+static uint32_t zlps;
+static uint32_t d_tx, d_tx_end;   /* bytes written by the device, to write */
+static uint32_t d_rx;             /* bytes read by the device */
+
+/* written data: sequence end and time of each write, for the latency */
+#define NW 200000
+static uint32_t w_end[NW];
+static uint64_t w_time[NW];
+static uint32_t nw, w_done;
+static double lat_sum, lat_max;
+static unsigned long lat_n;
+
+static uint8_t pat(uint32_t i) { return (uint8_t)((i * 7U) ^ (i >> 8)); }
+
+static void urb_complete(void)
+{
+  uint32_t i;
+  for (i = 0; i < urb_len; i++)
+  {
+    CHECK(urb[i] == pat(h_rx + i));
+    if (urb[i] != pat(h_rx + i)) break;
+  }
+  h_rx += urb_len;
+  urb_len = 0;
+  while (w_done < nw && w_end[w_done] <= h_rx)
+  {
+    double l = (double)(now - w_time[w_done]);
+    lat_sum += l; lat_n++;
+    if (l > lat_max) lat_max = l;
+    w_done++;
+  }
+}
+
+static struct { int busy, out; uint32_t n; uint64_t end; } wire;
+static int rr;
+
+static void wire_complete(void)
+{
+  wire.busy = 0;
+  if (wire.out)
+  {
+    uint32_t i;
+    for (i = 0; i < wire.n; i++) eout.pma[i] = pat(h_tx + i);
+    h_tx += wire.n;
+    eout.pkt = wire.n;
+    eout.valid = 0;
+    eout.ctr = 1;
+  }
+  else
+  {
+    CHECK(urb_len + ein.pkt <= URB);
+    memcpy(urb + urb_len, ein.pma, ein.pkt);
+    urb_len += ein.pkt;
+    if (ein.pkt == 0U) zlps++;
+    if (ein.pkt < PKT || urb_len == URB) urb_complete();
+    ein.valid = 0;
+    ein.ctr = 1;
+  }
+}
+
+static void service(void)
+{
+  for (;;)
+  {
+    int can_in, can_out;
+    if (wire.busy)
+    {
+      if (now < wire.end) return;
+      wire_complete();
+    }
+    can_in = ein.valid;
+    can_out = eout.valid && (h_tx < h_tx_end);
+    if (can_in && (!can_out || rr))
+    {
+      wire.busy = 1; wire.out = 0; wire.n = ein.pkt;
+    }
+    else if (can_out)
+    {
+      wire.busy = 1; wire.out = 1;
+      wire.n = (h_tx_end - h_tx) < PKT ? (h_tx_end - h_tx) : PKT;
+      /* some short packets */
+      if (wire.n == PKT && rnd(16) == 0) wire.n = 1U + rnd(PKT - 1U);
+    }
+    else
+    {
+      return;
+    }
+    rr = !rr;
+    wire.end = now + pkt_ns(wire.n);
+  }
+}
+
+/* ---------------- contexts ---------------- */
+static void usb_isr(void);
+static void app_isr(void);
+static uint64_t app_next = ~0ULL, app_period, app_jitter;
+
+static void cpu(uint64_t dt)
+{
+  static unsigned long calls;
+  if (getenv("DBG") && (++calls % 1000000UL) == 0) printf("cpu t=%.3f ms lvl %d pm %u app_next %llu d_tx %u h_rx %u d_rx %u h_tx %u ein %d/%d eout %d/%d\n", now / 1e6, level, primask, (unsigned long long)app_next, d_tx, h_rx, d_rx, h_tx, ein.busy, ein.valid, eout.busy, eout.valid);
+  for (;;)
+  {
+    uint64_t step;
+    service();
+    if (primask == 0U && level < 2 && now >= app_next)
+    {
+      app_isr();
+      continue;
+    }
+    if (primask == 0U && level < 1 && (ein.ctr || eout.ctr))
+    {
+      usb_isr();
+      continue;
+    }
+    if (dt == 0U) break;
+    step = dt;
+    if (wire.busy && (wire.end - now) < step) step = wire.end - now;
+    if (level < 2 && app_next > now && (app_next - now) < step) step = app_next - now;
+    now += step;
+    dt -= step;
+  }
+}
+
+/* class critical sections, where the interrupts may preempt */
+uint32_t __get_PRIMASK(void) { if (primask == 0U) cpu(rnd(400)); return primask; }
+void __disable_irq(void) { primask = 1U; }
+void __set_PRIMASK(uint32_t p) { primask = p; if (p == 0U) cpu(rnd(400)); }
+
+static void usb_isr(void)
+{
+  int save = level;
+  level = 1;
+  cpu(t_isr);
+  if (ein.ctr)
+  {
+    ein.ctr = 0;
+    ein.off += ein.pkt;
+    if (ein.pkt == PKT && ein.off < ein.len)
+    {
+      ein.pkt = (ein.len - ein.off) < PKT ? (ein.len - ein.off) : PKT;
+      memcpy(ein.pma, ein.buf + ein.off, ein.pkt);
+      ein.valid = 1;
+    }
+    else
+    {
+      ein.busy = 0;
+      USBD_CDC.DataIn(&dev, CDC_IN_EP & 0x7FU);
+    }
+  }
+  else if (eout.ctr)
+  {
+    eout.ctr = 0;
+    CHECK(eout.off + eout.pkt <= eout.len);
+    memcpy(eout.buf + eout.off, eout.pma, eout.pkt);
+    eout.off += eout.pkt;
+    if (eout.pkt < PKT || eout.off >= eout.len)
+    {
+      eout.busy = 0;
+      USBD_CDC.DataOut(&dev, CDC_OUT_EP);
+    }
+    else
+    {
+      eout.valid = 1;
+    }
+  }
+  level = save;
+}
+
+/* ---------------- application ---------------- */
+#ifndef SIM_BASE
+static uint8_t txring[RING], rxring[RING + PKT + 16];
+#endif
+static uint32_t wsize = 1U;       /* write size, 0 for random */
+static int writer_isr;            /* 1 to write from the application interrupt */
+static uint32_t rx_notify;
+
+#ifdef SIM_BASE
+/* The former CDC_Standalone scheme: a buffer flushed by a 5 ms timer */
+#define APP_TX_DATA_SIZE 2048U
+static uint8_t UserTxBuffer[APP_TX_DATA_SIZE], UserRxBuffer[PKT];
+static uint32_t UserTxBufPtrIn, UserTxBufPtrOut;
+
+static uint32_t app_write(const uint8_t *p, uint32_t n)
+{
+  uint32_t i;
+  for (i = 0; i < n; i++)
+  {
+    if (((UserTxBufPtrIn + 1U) % APP_TX_DATA_SIZE) == UserTxBufPtrOut) break;
+    UserTxBuffer[UserTxBufPtrIn] = p[i];
+    UserTxBufPtrIn = (UserTxBufPtrIn + 1U) % APP_TX_DATA_SIZE;
+  }
+  return i;
+}
+
+static void tim_flush(void)
+{
+  uint32_t buffsize;
+  if (UserTxBufPtrOut != UserTxBufPtrIn)
+  {
+    if (UserTxBufPtrOut > UserTxBufPtrIn) buffsize = APP_TX_DATA_SIZE - UserTxBufPtrOut;
+    else buffsize = UserTxBufPtrIn - UserTxBufPtrOut;
+    USBD_CDC_SetTxBuffer(&dev, &UserTxBuffer[UserTxBufPtrOut], (uint16_t)buffsize);
+    if (USBD_CDC_TransmitPacket(&dev) == USBD_OK)
+    {
+      UserTxBufPtrOut += buffsize;
+      if (UserTxBufPtrOut == APP_TX_DATA_SIZE) UserTxBufPtrOut = 0;
+    }
+  }
+}
+static int8_t itf_init(void)
+{
+  USBD_CDC_SetTxBuffer(&dev, UserTxBuffer, 0);
+  USBD_CDC_SetRxBuffer(&dev, UserRxBuffer);
+  rx_lo = UserRxBuffer; rx_hi = UserRxBuffer + PKT;
+  return 0;
+}
+#else
+static uint32_t app_write(const uint8_t *p, uint32_t n) { return USBD_CDC_Write(&dev, p, n); }
+static int8_t itf_init(void)
+{
+  CHECK(USBD_CDC_SetTxRing(&dev, txring, 100U) == USBD_FAIL);
+  CHECK(USBD_CDC_SetTxRing(&dev, txring, PKT) == USBD_FAIL);
+  CHECK(USBD_CDC_SetTxRing(&dev, txring, RING) == USBD_OK);
+  CHECK(USBD_CDC_SetRxRing(&dev, rxring, RING) == USBD_OK);
+  rx_lo = rxring; rx_hi = rxring + RING + PKT;
+  return 0;
+}
+#endif
+
+static int8_t itf_deinit(void) { return 0; }
+static int8_t itf_control(uint8_t cmd, uint8_t *pbuf, uint16_t length) { return 0; }
+static int8_t itf_receive(uint8_t *buf, uint32_t *len)
+{
+  uint32_t i;
+  /* the packet is contiguous, and still in the ring */
+  for (i = 0; i < *len; i++) CHECK(buf[i] == pat(rx_notify + i));
+  rx_notify += *len;
+#ifdef SIM_BASE
+  d_rx += *len;
+  USBD_CDC_ReceivePacket(&dev);
+#endif
+  return 0;
+}
+static USBD_CDC_ItfTypeDef fops = { itf_init, itf_deinit, itf_control, itf_receive };
+
+/* one write of the device data stream */
+static void dev_write(void)
+{
+  uint8_t b[1024];
+  uint32_t n, i, w;
+  if (d_tx >= d_tx_end) return;
+  n = wsize ? wsize : 1U + rnd(300);
+  if (n > d_tx_end - d_tx) n = d_tx_end - d_tx;
+  for (i = 0; i < n; i++) b[i] = pat(d_tx + i);
+  cpu(t_call + n * t_byte);
+  w = app_write(b, n);
+  if (w != 0U && nw < NW)
+  {
+    w_end[nw] = d_tx + w; w_time[nw] = now; nw++;
+  }
+  d_tx += w;
+}
+
+static void dev_read(void)
+{
+#ifndef SIM_BASE
+  uint8_t b[512];
+  uint32_t n, i, max = 1U + rnd(512);
+  cpu(t_call);
+  n = USBD_CDC_Read(&dev, b, max);
+  cpu(n * t_byte);
+  for (i = 0; i < n; i++) CHECK(b[i] == pat(d_rx + i));
+  d_rx += n;
+#endif
+}
+
+static void app_isr(void)
+{
+  int save = level;
+  level = 2;
+  if (app_period) app_next = now + app_period + (app_jitter ? rnd((uint32_t)app_jitter) : 0U);
+  else app_next = ~0ULL;
+  cpu(1000U);
+#ifdef SIM_BASE
+  if (!writer_isr) { tim_flush(); level = save; return; }
+#endif
+  if (writer_isr) dev_write();
+  level = save;
+}
+
+static void setup(void)
+{
+  memset(&ein, 0, sizeof(ein)); memset(&eout, 0, sizeof(eout)); memset(&wire, 0, sizeof(wire));
+  now = 0; level = 0; primask = 0;
+  urb_len = h_rx = h_tx = h_tx_end = 0; zlps = 0;
+  d_tx = d_tx_end = d_rx = 0; rx_notify = 0;
+  nw = w_done = 0; lat_sum = lat_max = 0; lat_n = 0;
+  app_next = ~0ULL; app_period = app_jitter = 0;
+  dev.dev_speed = USBD_SPEED_FULL;
+  pcd.IN_ep[1].maxpacket = PKT;
+  dev.pData = &pcd;
+  dev.pClassData = NULL;
+  USBD_CDC_RegisterInterface(&dev, &fops);
+  USBD_CDC.Init(&dev, 0);
+#ifdef SIM_BASE
+  UserTxBufPtrIn = UserTxBufPtrOut = 0;
+  /* the 5 ms timer flush of the former example */
+  writer_isr = 0;
+#endif
+}
+
+#ifdef SIM_BASE
+static void base_timer(void) { app_period = 5000000U; app_next = now + app_period; }
+#endif
+
+/* ---------------- scenarios ---------------- */
+static void drain(uint64_t limit)
+{
+  uint64_t end = now + limit;
+  while (now < end && (h_rx < d_tx || d_tx < d_tx_end || d_rx < h_tx_end || ein.busy)) { cpu(10000U); dev_read(); }
+}
+
+static void tests(void)
+{
+#ifndef SIM_BASE
+  int round;
+  /* random writes and reads, writer in the thread or in the high priority interrupt */
+  int rounds = getenv("ROUNDS") ? atoi(getenv("ROUNDS")) : 40;
+  for (round = 0; round < rounds; round++)
+  {
+    uint32_t total = 20000U + rnd(60000U);
+    setup();
+    writer_isr = round & 1;
+    wsize = (round % 4 < 2) ? 0U : (PKT << rnd(4));    /* multiples of the packet for the ZLPs */
+    d_tx_end = total;
+    h_tx_end = 10000U + rnd(40000U);
+    if (writer_isr) { app_period = 200000U + rnd(300000U); app_jitter = app_period; app_next = 0; }
+    while (now < 2000000000ULL && (h_rx < d_tx_end || d_rx < h_tx_end))
+    {
+      if (!writer_isr) dev_write();
+      /* slow reader at times, so that the host is held by NAKs */
+      if (rnd(8) == 0) cpu(rnd(3000000U));
+      dev_read();
+      if (getenv("DBG") && rnd(20000) == 0) printf("t=%.1f ms d_tx %u h_rx %u h_tx %u d_rx %u ein %d/%d eout %d/%d urb %u\n", now / 1e6, d_tx, h_rx, h_tx, d_rx, ein.busy, ein.valid, eout.busy, eout.valid, urb_len);
+    }
+    app_next = ~0ULL;
+    drain(50000000U);
+    CHECK(h_rx == d_tx_end);
+    CHECK(d_rx == h_tx_end);
+    CHECK(urb_len == 0U);      /* nothing left in an unterminated transfer */
+    if (ein.busy) printf("ein len %u off %u pkt %u valid %d ctr %d lvl %d pm %u TxLength %u In %u Out %u\n", ein.len, ein.off, ein.pkt, ein.valid, ein.ctr, level, primask, ((USBD_CDC_HandleTypeDef *)dev.pClassData)->TxLength, ((USBD_CDC_HandleTypeDef *)dev.pClassData)->TxRing.In, ((USBD_CDC_HandleTypeDef *)dev.pClassData)->TxRing.Out);
+    CHECK(!ein.busy && dev.pClassData && ((USBD_CDC_HandleTypeDef *)dev.pClassData)->TxState == 0U);
+    if (getenv("V")) printf("round %d: isr %d wsize %u tx %u rx %u zlp %u t=%.1f ms\n", round, writer_isr, wsize, h_rx, d_rx, zlps, now / 1e6);
+    USBD_CDC.DeInit(&dev, 0);
+  }
+  /* single full packet write: ended by a ZLP */
+  setup();
+  wsize = PKT; d_tx_end = PKT;
+  dev_write();
+  drain(10000000U);
+  CHECK(h_rx == PKT && zlps == 1U);
+  USBD_CDC.DeInit(&dev, 0);
+  /* the ring full: partial writes, nothing lost */
+  setup();
+  {
+    uint8_t b[RING + 100];
+    uint32_t i;
+    for (i = 0; i < sizeof(b); i++) b[i] = pat(i);
+    primask = 1U;   /* hold the interrupts: the first transfer only starts */
+    CHECK(USBD_CDC_Write(&dev, b, sizeof(b)) == RING);
+    primask = 0U;
+    d_tx = d_tx_end = RING;
+    nw = 0;
+    drain(100000000U);
+    CHECK(h_rx == RING);
+  }
+  USBD_CDC.DeInit(&dev, 0);
+  CHECK(USBD_CDC_Write(&dev, (const uint8_t *)"x", 1U) == 0U);
+#endif
+}
+
+static void bench_tx(const char *name, uint32_t size, uint64_t period)
+{
+  uint64_t t0;
+  setup();
+#ifdef SIM_BASE
+  base_timer();
+#endif
+  wsize = size;
+  d_tx_end = period ? 0xFFFFFFFFU : 0xFFFFFFFFU;
+  t0 = now;
+  while (now - t0 < 200000000ULL)
+  {
+    uint32_t before = d_tx;
+    dev_write();
+    if (period) cpu(period);
+    else if (d_tx == before) cpu(2000U);
+  }
+  printf("%-24s write %4u B %s: %7.1f KB/s, latency mean %7.1f us max %7.1f us\n", name, size,
+         period ? "paced" : "burst", h_rx / ((now - t0) / 1e9) / 1000.0,
+         lat_n ? lat_sum / lat_n / 1000.0 : 0.0, lat_max / 1000.0);
+  USBD_CDC.DeInit(&dev, 0);
+}
+
+static void bench_rx(const char *name)
+{
+#ifndef SIM_BASE
+  uint64_t t0;
+  setup();
+  h_tx_end = 0xFFFFFFFFU;
+  t0 = now;
+  while (now - t0 < 200000000ULL) { dev_read(); cpu(2000U); }
+  printf("%-24s read: %7.1f KB/s\n", name, d_rx / ((now - t0) / 1e9) / 1000.0);
+  USBD_CDC.DeInit(&dev, 0);
+#endif
+}
+
+int main(int argc, char **argv)
+{
+  const char *name = argc > 1 ? argv[1] : "sim";
+  setvbuf(stdout, NULL, _IONBF, 0);
+  if (!getenv("NOTEST")) tests();
+  bench_tx(name, 1U, 0U);
+  bench_tx(name, 16U, 0U);
+  bench_tx(name, 64U, 0U);
+  bench_tx(name, 512U, 0U);
+  bench_tx(name, 1U, 100000U);
+  bench_tx(name, 16U, 1000000U);
+  bench_tx(name, 64U, 1000000U);
+  bench_rx(name);
+  printf("%s: %lu checks, %lu failures\n", name, checks, failures);
+  return failures != 0;
+}
@@ -0,0 +1,132 @@
+/**
+  ******************************************************************************
+  * @file    usbd_composite.h
+  * @author  MCD Application Team
+  * @brief   header file for the usbd_composite.c file.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2015 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                      www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __USB_COMPOSITE_H
+#define __USB_COMPOSITE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include  "usbd_ioreq.h"
+
+#if (USBD_MAX_SUPPORTED_CLASS < 2U)
+#error "USBD_MAX_SUPPORTED_CLASS should be set to the number of classes of the composite device"
+#endif /* USBD_MAX_SUPPORTED_CLASS */
+
+/** @addtogroup STM32_USB_DEVICE_LIBRARY
+  * @{
+  */
+
+/** @defgroup USBD_COMPOSITE
+  * @brief This file is the header file for usbd_composite.c
+  * @{
+  */
+
+
+/** @defgroup USBD_COMPOSITE_Exported_Defines
+  * @{
+  */
+/* Size of the assembled configuration descriptor. CDC + MSC + HID take 123
+   bytes */
+#ifndef USBD_COMPOSITE_CFG_DESC_SIZ
+#define USBD_COMPOSITE_CFG_DESC_SIZ                  160U
+#endif /* USBD_COMPOSITE_CFG_DESC_SIZ */
+
+/* Endpoint registers of the USB peripheral, EP0 included */
+#ifndef USBD_COMPOSITE_EP_NBR
+#define USBD_COMPOSITE_EP_NBR                        8U
+#endif /* USBD_COMPOSITE_EP_NBR */
+
+/* Size of the packet memory, buffer table included */
+#ifndef USBD_COMPOSITE_PMA_SIZE
+#define USBD_COMPOSITE_PMA_SIZE                      1024U
+#endif /* USBD_COMPOSITE_PMA_SIZE */
+
+#define USBD_COMPOSITE_NO_CLASS                      0xFFU
+/**
+  * @}
+  */
+
+
+/** @defgroup USBD_COMPOSITE_Exported_TypesDefinitions
+  * @{
+  */
+typedef struct
+{
+  uint8_t   Class;                  /* Index in pdev->tclasslist, or USBD_COMPOSITE_NO_CLASS */
+  uint8_t   Type;                   /* USBD_EP_TYPE_xxx */
+  uint16_t  Size;                   /* wMaxPacketSize */
+  uint16_t  Pma;                    /* Buffer address in the packet memory */
+} USBD_COMPOSITE_EPTypeDef;
+
+typedef struct
+{
+  USBD_COMPOSITE_EPTypeDef  ep_in[USBD_COMPOSITE_EP_NBR];
+  USBD_COMPOSITE_EPTypeDef  ep_out[USBD_COMPOSITE_EP_NBR];
+  uint8_t                   CtlClass;     /* Class of the current control transfer */
+} USBD_COMPOSITE_HandleTypeDef;
+/**
+  * @}
+  */
+
+
+/** @defgroup USBD_COMPOSITE_Exported_Macros
+  * @{
+  */
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_COMPOSITE_Exported_Variables
+  * @{
+  */
+
+extern USBD_ClassTypeDef  USBD_COMPOSITE;
+#define USBD_COMPOSITE_CLASS    &USBD_COMPOSITE
+/**
+  * @}
+  */
+
+/** @defgroup USB_COMPOSITE_Exported_Functions
+  * @{
+  */
+uint8_t USBD_COMPOSITE_AddClass(USBD_HandleTypeDef *pdev,
+                                USBD_ClassTypeDef *pclass);
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* __USB_COMPOSITE_H */
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
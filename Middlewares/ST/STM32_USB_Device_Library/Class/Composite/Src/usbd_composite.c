@@ -0,0 +1,896 @@
+/**
+  ******************************************************************************
+  * @file    usbd_composite.c
+  * @author  MCD Application Team
+  * @brief   This file provides the high layer firmware functions to manage a
+  *          device made of several classes:
+  *           - Assembly of the configuration descriptor of the classes
+  *           - Numbering of the interfaces and endpoints of the classes
+  *           - Allocation of the packet memory to the endpoints
+  *           - Dispatch of the requests and transfers to the classes
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                                Composite Device Description
+  *          ===================================================================
+  *           The classes are added one after the other, each with the FS
+  *           configuration descriptor it would give as a single class:
+  *             - Its interfaces are renumbered after the ones of the previous
+  *               classes, and an Interface Association Descriptor is inserted
+  *               in front of them when it has several and no IAD (CDC).
+  *             - Each endpoint is given the lowest endpoint number free in its
+  *               direction whose other direction is free or of the same type
+  *               (an endpoint register has a single type), isochronous
+  *               endpoints taking a whole register.
+  *             - The packet memory is packed: buffer table sized for the
+  *               highest endpoint number, EP0 OUT and IN, then the endpoints
+  *               in number order, OUT buffers above 62 bytes rounded to 32
+  *               bytes and the other ones to 2 bytes.
+  *           A class which does not fit in the descriptor, the endpoints or
+  *           the packet memory is not added, the device is left unchanged.
+  *
+  *           Usage:
+  *             USBD_Init(&hUsbDeviceFS, &FS_Desc, DEVICE_FS);
+  *             USBD_COMPOSITE_AddClass(&hUsbDeviceFS, USBD_CDC_CLASS);
+  *             USBD_CDC_RegisterInterface(&hUsbDeviceFS, &USBD_CDC_fops);
+  *             USBD_COMPOSITE_AddClass(&hUsbDeviceFS, USBD_MSC_CLASS);
+  *             USBD_MSC_RegisterStorage(&hUsbDeviceFS, &USBD_MSC_fops);
+  *             USBD_COMPOSITE_AddClass(&hUsbDeviceFS, USBD_HID_CLASS);
+  *             USBD_RegisterClass(&hUsbDeviceFS, USBD_COMPOSITE_CLASS);
+  *             USBD_Start(&hUsbDeviceFS);
+  *
+  *           The interface and storage callbacks are registered after the
+  *           class is added, as they are kept per class. The usbd_conf.h
+  *           file should set:
+  *             - USBD_MAX_SUPPORTED_CLASS to the number of classes
+  *             - USBD_MAX_NUM_INTERFACES to at least the number of interfaces
+  *             - USBD_malloc to an allocator giving each class its own block
+  *               (the usual USBD_static_malloc gives a single one)
+  *           and the device descriptor the class 0xEF, subclass 0x02,
+  *           protocol 0x01 of a device using IADs. The packet memory set in
+  *           USBD_LL_Init() is replaced by USBD_COMPOSITE_AddClass().
+  *
+  *           Only the classes getting their data, user data and endpoint
+  *           addresses through USBD_CLASS_DATA(), USBD_USER_DATA() and
+  *           USBD_CLASS_EP() can be part of a composite device: CDC, MSC and
+  *           HID. The device is full speed, the HS descriptor of the classes
+  *           is not used.
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2015 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                      www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "usbd_composite.h"
+#include "usbd_ctlreq.h"
+
+
+/** @addtogroup STM32_USB_DEVICE_LIBRARY
+  * @{
+  */
+
+
+/** @defgroup USBD_COMPOSITE
+  * @brief usbd core module
+  * @{
+  */
+
+/** @defgroup USBD_COMPOSITE_Private_TypesDefinitions
+  * @{
+  */
+/**
+  * @}
+  */
+
+
+/** @defgroup USBD_COMPOSITE_Private_Defines
+  * @{
+  */
+#define USBD_COMPOSITE_DESC_TYPE_IAD           0x0BU
+#define USBD_COMPOSITE_DESC_TYPE_CS_INTERFACE  0x24U
+#define USBD_COMPOSITE_IAD_SIZE                0x08U
+
+/* CDC functional descriptors holding interface numbers */
+#define USBD_COMPOSITE_CDC_COMM_CLASS          0x02U
+#define USBD_COMPOSITE_CDC_CALL_MANAGEMENT     0x01U
+#define USBD_COMPOSITE_CDC_UNION               0x06U
+
+/* Buffer table entry of an endpoint register */
+#define USBD_COMPOSITE_BTABLE_ENTRY_SIZE       8U
+
+/* Largest MaxPower, in 2 mA units */
+#define USBD_COMPOSITE_MAX_POWER               250U
+/**
+  * @}
+  */
+
+
+/** @defgroup USBD_COMPOSITE_Private_Macros
+  * @{
+  */
+
+/**
+  * @}
+  */
+
+
+/** @defgroup USBD_COMPOSITE_Private_FunctionPrototypes
+  * @{
+  */
+
+static uint8_t  USBD_COMPOSITE_Init(USBD_HandleTypeDef *pdev,
+                                    uint8_t cfgidx);
+
+static uint8_t  USBD_COMPOSITE_DeInit(USBD_HandleTypeDef *pdev,
+                                      uint8_t cfgidx);
+
+static uint8_t  USBD_COMPOSITE_Setup(USBD_HandleTypeDef *pdev,
+                                     USBD_SetupReqTypedef *req);
+
+static uint8_t  USBD_COMPOSITE_EP0_TxSent(USBD_HandleTypeDef *pdev);
+
+static uint8_t  USBD_COMPOSITE_EP0_RxReady(USBD_HandleTypeDef *pdev);
+
+static uint8_t  USBD_COMPOSITE_DataIn(USBD_HandleTypeDef *pdev,
+                                      uint8_t epnum);
+
+static uint8_t  USBD_COMPOSITE_DataOut(USBD_HandleTypeDef *pdev,
+                                       uint8_t epnum);
+
+static uint8_t  USBD_COMPOSITE_SOF(USBD_HandleTypeDef *pdev);
+
+static uint8_t  *USBD_COMPOSITE_GetCfgDesc(uint16_t *length);
+
+static uint8_t  *USBD_COMPOSITE_GetDeviceQualifierDesc(uint16_t *length);
+
+static USBD_ClassTypeDef *USBD_COMPOSITE_GetClass(USBD_HandleTypeDef *pdev,
+                                                  uint8_t idx);
+
+static void     USBD_COMPOSITE_Reset(void);
+
+static uint8_t  USBD_COMPOSITE_CopyDesc(USBD_HandleTypeDef *pdev, uint8_t idx,
+                                        uint8_t *pdesc, uint16_t len,
+                                        uint16_t *ptotal);
+
+static uint8_t  USBD_COMPOSITE_AssignEP(USBD_HandleTypeDef *pdev, uint8_t idx,
+                                        uint8_t *pep);
+
+static void     USBD_COMPOSITE_FreeEPs(uint8_t idx);
+
+static uint32_t USBD_COMPOSITE_LayoutPMA(USBD_HandleTypeDef *pdev, uint8_t apply);
+
+static uint16_t USBD_COMPOSITE_PMASize(uint16_t size, uint8_t out);
+/**
+  * @}
+  */
+
+/** @defgroup USBD_COMPOSITE_Private_Variables
+  * @{
+  */
+
+USBD_ClassTypeDef  USBD_COMPOSITE =
+{
+  USBD_COMPOSITE_Init,
+  USBD_COMPOSITE_DeInit,
+  USBD_COMPOSITE_Setup,
+  USBD_COMPOSITE_EP0_TxSent,
+  USBD_COMPOSITE_EP0_RxReady,
+  USBD_COMPOSITE_DataIn,
+  USBD_COMPOSITE_DataOut,
+  USBD_COMPOSITE_SOF,
+  NULL,
+  NULL,
+  USBD_COMPOSITE_GetCfgDesc,
+  USBD_COMPOSITE_GetCfgDesc,
+  USBD_COMPOSITE_GetCfgDesc,
+  USBD_COMPOSITE_GetDeviceQualifierDesc,
+};
+
+static USBD_COMPOSITE_HandleTypeDef USBD_COMPOSITE_Handle;
+
+/* Configuration descriptor assembled by USBD_COMPOSITE_AddClass() */
+__ALIGN_BEGIN static uint8_t USBD_COMPOSITE_CfgDesc[USBD_COMPOSITE_CFG_DESC_SIZ]  __ALIGN_END;
+
+/* USB Standard Device Descriptor */
+__ALIGN_BEGIN static uint8_t USBD_COMPOSITE_DeviceQualifierDesc[USB_LEN_DEV_QUALIFIER_DESC]  __ALIGN_END =
+{
+  USB_LEN_DEV_QUALIFIER_DESC,
+  USB_DESC_TYPE_DEVICE_QUALIFIER,
+  0x00,
+  0x02,
+  0xEF,
+  0x02,
+  0x01,
+  0x40,
+  0x01,
+  0x00,
+};
+
+/**
+  * @}
+  */
+
+/** @defgroup USBD_COMPOSITE_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief  USBD_COMPOSITE_Init
+  *         Initialize the classes of the device
+  * @param  pdev: device instance
+  * @param  cfgidx: Configuration index
+  * @retval status
+  */
+static uint8_t  USBD_COMPOSITE_Init(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
+{
+  uint8_t ret = USBD_OK;
+  uint32_t i;
+
+  for (i = 0U; i < pdev->NumClasses; i++)
+  {
+    if (pdev->tclasslist[i].pClass->Init(pdev, cfgidx) != 0U)
+    {
+      ret = USBD_FAIL;
+    }
+  }
+
+  USBD_COMPOSITE_Handle.CtlClass = USBD_COMPOSITE_NO_CLASS;
+
+  /* The core deinitializes the class on a bus reset only when it has data */
+  pdev->pClassData = &USBD_COMPOSITE_Handle;
+
+  return ret;
+}
+
+/**
+  * @brief  USBD_COMPOSITE_DeInit
+  *         DeInitialize the classes of the device
+  * @param  pdev: device instance
+  * @param  cfgidx: Configuration index
+  * @retval status
+  */
+static uint8_t  USBD_COMPOSITE_DeInit(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
+{
+  uint32_t i;
+
+  for (i = 0U; i < pdev->NumClasses; i++)
+  {
+    pdev->tclasslist[i].pClass->DeInit(pdev, cfgidx);
+  }
+
+  pdev->pClassData = NULL;
+
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_COMPOSITE_Setup
+  *         Pass a request to the class of its interface or endpoint. The
+  *         class gets the interface number of its own descriptor
+  * @param  pdev: instance
+  * @param  req: usb requests
+  * @retval status
+  */
+static uint8_t  USBD_COMPOSITE_Setup(USBD_HandleTypeDef *pdev,
+                                     USBD_SetupReqTypedef *req)
+{
+  USBD_COMPOSITE_HandleTypeDef *hcomp = &USBD_COMPOSITE_Handle;
+  USBD_CompositeElementTypeDef *pelem;
+  USBD_SetupReqTypedef creq = *req;
+  uint8_t index = LOBYTE(req->wIndex);
+  uint8_t idx = USBD_COMPOSITE_NO_CLASS;
+  uint32_t i;
+
+  switch (req->bmRequest & USB_REQ_RECIPIENT_MASK)
+  {
+    case USB_REQ_RECIPIENT_INTERFACE:
+      for (i = 0U; i < pdev->NumClasses; i++)
+      {
+        pelem = &pdev->tclasslist[i];
+
+        if ((index >= pelem->ItfBase) && (index < (pelem->ItfBase + pelem->ItfNum)))
+        {
+          idx = (uint8_t)i;
+          creq.wIndex = (uint16_t)((req->wIndex & 0xFF00U) | (uint8_t)(index - pelem->ItfBase));
+        }
+      }
+      break;
+
+    case USB_REQ_RECIPIENT_ENDPOINT:
+      if ((index & 0x7FU) < USBD_COMPOSITE_EP_NBR)
+      {
+        if ((index & 0x80U) == 0x80U)
+        {
+          idx = hcomp->ep_in[index & 0x7FU].Class;
+        }
+        else
+        {
+          idx = hcomp->ep_out[index & 0x7FU].Class;
+        }
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  if (USBD_COMPOSITE_GetClass(pdev, idx) == NULL)
+  {
+    USBD_CtlError(pdev, req);
+    return USBD_FAIL;
+  }
+
+  /* The data stage of the request goes to the same class */
+  hcomp->CtlClass = idx;
+
+  return pdev->tclasslist[idx].pClass->Setup(pdev, &creq);
+}
+
+/**
+  * @brief  USBD_COMPOSITE_EP0_TxSent
+  *         Handle EP0 Tx sent event for the class of the control transfer
+  * @param  pdev: device instance
+  * @retval status
+  */
+static uint8_t  USBD_COMPOSITE_EP0_TxSent(USBD_HandleTypeDef *pdev)
+{
+  USBD_ClassTypeDef *pclass = USBD_COMPOSITE_GetClass(pdev, USBD_COMPOSITE_Handle.CtlClass);
+
+  if ((pclass != NULL) && (pclass->EP0_TxSent != NULL))
+  {
+    return pclass->EP0_TxSent(pdev);
+  }
+
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_COMPOSITE_EP0_RxReady
+  *         Handle EP0 Rx Ready event for the class of the control transfer
+  * @param  pdev: device instance
+  * @retval status
+  */
+static uint8_t  USBD_COMPOSITE_EP0_RxReady(USBD_HandleTypeDef *pdev)
+{
+  USBD_ClassTypeDef *pclass = USBD_COMPOSITE_GetClass(pdev, USBD_COMPOSITE_Handle.CtlClass);
+
+  if ((pclass != NULL) && (pclass->EP0_RxReady != NULL))
+  {
+    return pclass->EP0_RxReady(pdev);
+  }
+
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_COMPOSITE_DataIn
+  *         Handle data IN Stage for the class of the endpoint
+  * @param  pdev: device instance
+  * @param  epnum: endpoint index
+  * @retval status
+  */
+static uint8_t  USBD_COMPOSITE_DataIn(USBD_HandleTypeDef *pdev,
+                                      uint8_t epnum)
+{
+  USBD_ClassTypeDef *pclass = NULL;
+
+  if ((epnum & 0x7FU) < USBD_COMPOSITE_EP_NBR)
+  {
+    pclass = USBD_COMPOSITE_GetClass(pdev, USBD_COMPOSITE_Handle.ep_in[epnum & 0x7FU].Class);
+  }
+
+  if ((pclass != NULL) && (pclass->DataIn != NULL))
+  {
+    return pclass->DataIn(pdev, epnum);
+  }
+
+  return USBD_FAIL;
+}
+
+/**
+  * @brief  USBD_COMPOSITE_DataOut
+  *         Handle data OUT Stage for the class of the endpoint
+  * @param  pdev: device instance
+  * @param  epnum: endpoint index
+  * @retval status
+  */
+static uint8_t  USBD_COMPOSITE_DataOut(USBD_HandleTypeDef *pdev,
+                                       uint8_t epnum)
+{
+  USBD_ClassTypeDef *pclass = NULL;
+
+  if (epnum < USBD_COMPOSITE_EP_NBR)
+  {
+    pclass = USBD_COMPOSITE_GetClass(pdev, USBD_COMPOSITE_Handle.ep_out[epnum].Class);
+  }
+
+  if ((pclass != NULL) && (pclass->DataOut != NULL))
+  {
+    return pclass->DataOut(pdev, epnum);
+  }
+
+  return USBD_FAIL;
+}
+
+/**
+  * @brief  USBD_COMPOSITE_SOF
+  *         Handle SOF event for all the classes
+  * @param  pdev: device instance
+  * @retval status
+  */
+static uint8_t  USBD_COMPOSITE_SOF(USBD_HandleTypeDef *pdev)
+{
+  uint32_t i;
+
+  for (i = 0U; i < pdev->NumClasses; i++)
+  {
+    if (pdev->tclasslist[i].pClass->SOF != NULL)
+    {
+      pdev->tclasslist[i].pClass->SOF(pdev);
+    }
+  }
+
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_COMPOSITE_GetCfgDesc
+  *         return the assembled configuration descriptor, for all speeds
+  * @param  length : pointer data length
+  * @retval pointer to descriptor buffer
+  */
+static uint8_t  *USBD_COMPOSITE_GetCfgDesc(uint16_t *length)
+{
+  *length = (uint16_t)(USBD_COMPOSITE_CfgDesc[2] | ((uint16_t)USBD_COMPOSITE_CfgDesc[3] << 8));
+  return USBD_COMPOSITE_CfgDesc;
+}
+
+/**
+* @brief  DeviceQualifierDescriptor
+*         return Device Qualifier descriptor
+* @param  length : pointer data length
+* @retval pointer to descriptor buffer
+*/
+static uint8_t  *USBD_COMPOSITE_GetDeviceQualifierDesc(uint16_t *length)
+{
+  *length = sizeof(USBD_COMPOSITE_DeviceQualifierDesc);
+  return USBD_COMPOSITE_DeviceQualifierDesc;
+}
+
+/**
+  * @brief  USBD_COMPOSITE_GetClass
+  *         Return a class of the device
+  * @param  pdev: device instance
+  * @param  idx: index of the class
+  * @retval Class handle, NULL if there is no such class
+  */
+static USBD_ClassTypeDef *USBD_COMPOSITE_GetClass(USBD_HandleTypeDef *pdev,
+                                                  uint8_t idx)
+{
+  if (idx >= pdev->NumClasses)
+  {
+    return NULL;
+  }
+
+  return pdev->tclasslist[idx].pClass;
+}
+
+/**
+  * @brief  USBD_COMPOSITE_Reset
+  *         Empty the configuration descriptor and the endpoint table
+  * @param  None
+  * @retval None
+  */
+static void USBD_COMPOSITE_Reset(void)
+{
+  USBD_COMPOSITE_HandleTypeDef *hcomp = &USBD_COMPOSITE_Handle;
+  uint8_t *pcfg = USBD_COMPOSITE_CfgDesc;
+  uint32_t i;
+
+  pcfg[0] = USB_LEN_CFG_DESC;                 /* bLength */
+  pcfg[1] = USB_DESC_TYPE_CONFIGURATION;      /* bDescriptorType */
+  pcfg[2] = USB_LEN_CFG_DESC;                 /* wTotalLength */
+  pcfg[3] = 0x00U;
+  pcfg[4] = 0x00U;                            /* bNumInterfaces */
+  pcfg[5] = 0x01U;                            /* bConfigurationValue */
+  pcfg[6] = 0x00U;                            /* iConfiguration */
+  pcfg[7] = 0x80U;                            /* bmAttributes */
+  pcfg[8] = 0x00U;                            /* MaxPower */
+
+  for (i = 0U; i < USBD_COMPOSITE_EP_NBR; i++)
+  {
+    hcomp->ep_in[i].Class = USBD_COMPOSITE_NO_CLASS;
+    hcomp->ep_in[i].Type = USBD_EP_TYPE_CTRL;
+    hcomp->ep_in[i].Size = 0U;
+    hcomp->ep_in[i].Pma = 0U;
+    hcomp->ep_out[i] = hcomp->ep_in[i];
+  }
+
+  hcomp->CtlClass = USBD_COMPOSITE_NO_CLASS;
+}
+
+/**
+  * @brief  USBD_COMPOSITE_CopyDesc
+  *         Append the descriptors of a class to the configuration descriptor,
+  *         renumbering its interfaces and endpoints
+  * @param  pdev: device instance
+  * @param  idx: index of the class
+  * @param  pdesc: configuration descriptor of the class
+  * @param  len: length of the class descriptor
+  * @param  ptotal: length of the configuration descriptor, updated
+  * @retval status
+  */
+static uint8_t  USBD_COMPOSITE_CopyDesc(USBD_HandleTypeDef *pdev, uint8_t idx,
+                                        uint8_t *pdesc, uint16_t len,
+                                        uint16_t *ptotal)
+{
+  uint8_t *pcfg = USBD_COMPOSITE_CfgDesc;
+  uint8_t base = pdev->tclasslist[idx].ItfBase;
+  uint8_t itf_class = 0U;
+  uint8_t need_iad;
+  uint16_t total = *ptotal;
+  uint16_t pos;
+  uint16_t size;
+  uint8_t *p;
+  uint16_t i;
+
+  if ((len < USB_LEN_CFG_DESC) || (pdesc[1] != USB_DESC_TYPE_CONFIGURATION))
+  {
+    return USBD_FAIL;
+  }
+
+  /* Several interfaces are grouped by an IAD, unless the class has one */
+  need_iad = (pdesc[4] > 1U) ? 1U : 0U;
+  for (pos = pdesc[0]; (pos + 1U) < len; pos += pdesc[pos])
+  {
+    if (pdesc[pos] == 0U)
+    {
+      return USBD_FAIL;
+    }
+    if (pdesc[pos + 1U] == USBD_COMPOSITE_DESC_TYPE_IAD)
+    {
+      need_iad = 0U;
+    }
+  }
+
+  for (pos = pdesc[0]; pos < len; pos += size)
+  {
+    size = pdesc[pos];
+
+    if ((size < 2U) || ((pos + size) > len))
+    {
+      return USBD_FAIL;
+    }
+
+    if ((need_iad != 0U) && (pdesc[pos + 1U] == USB_DESC_TYPE_INTERFACE))
+    {
+      if ((total + USBD_COMPOSITE_IAD_SIZE) > USBD_COMPOSITE_CFG_DESC_SIZ)
+      {
+        return USBD_FAIL;
+      }
+
+      p = &pcfg[total];
+      p[0] = USBD_COMPOSITE_IAD_SIZE;         /* bLength */
+      p[1] = USBD_COMPOSITE_DESC_TYPE_IAD;    /* bDescriptorType */
+      p[2] = base;                            /* bFirstInterface */
+      p[3] = pdesc[4];                        /* bInterfaceCount */
+      p[4] = pdesc[pos + 5U];                 /* bFunctionClass */
+      p[5] = pdesc[pos + 6U];                 /* bFunctionSubClass */
+      p[6] = pdesc[pos + 7U];                 /* bFunctionProtocol */
+      p[7] = 0x00U;                           /* iFunction */
+      total += USBD_COMPOSITE_IAD_SIZE;
+      need_iad = 0U;
+    }
+
+    if ((total + size) > USBD_COMPOSITE_CFG_DESC_SIZ)
+    {
+      return USBD_FAIL;
+    }
+
+    p = &pcfg[total];
+    for (i = 0U; i < size; i++)
+    {
+      p[i] = pdesc[pos + i];
+    }
+
+    switch (p[1])
+    {
+      case USB_DESC_TYPE_INTERFACE:
+        p[2] += base;                         /* bInterfaceNumber */
+        itf_class = p[5];
+        break;
+
+      case USBD_COMPOSITE_DESC_TYPE_IAD:
+        p[2] += base;                         /* bFirstInterface */
+        break;
+
+      case USBD_COMPOSITE_DESC_TYPE_CS_INTERFACE:
+        if ((itf_class == USBD_COMPOSITE_CDC_COMM_CLASS) && (size > 4U) &&
+            (p[2] == USBD_COMPOSITE_CDC_CALL_MANAGEMENT))
+        {
+          p[4] += base;                       /* bDataInterface */
+        }
+        else if ((itf_class == USBD_COMPOSITE_CDC_COMM_CLASS) &&
+                 (p[2] == USBD_COMPOSITE_CDC_UNION))
+        {
+          for (i = 3U; i < size; i++)
+          {
+            p[i] += base;                     /* bMasterInterface, bSlaveInterfaces */
+          }
+        }
+        break;
+
+      case USB_DESC_TYPE_ENDPOINT:
+        if ((size < 7U) || (USBD_COMPOSITE_AssignEP(pdev, idx, p) != USBD_OK))
+        {
+          return USBD_FAIL;
+        }
+        break;
+
+      default:
+        break;
+    }
+
+    total += size;
+  }
+
+  *ptotal = total;
+
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_COMPOSITE_AssignEP
+  *         Give an endpoint of a class the lowest endpoint number it can use
+  * @param  pdev: device instance
+  * @param  idx: index of the class
+  * @param  pep: endpoint descriptor, its address is updated
+  * @retval status
+  */
+static uint8_t  USBD_COMPOSITE_AssignEP(USBD_HandleTypeDef *pdev, uint8_t idx,
+                                        uint8_t *pep)
+{
+  USBD_COMPOSITE_HandleTypeDef *hcomp = &USBD_COMPOSITE_Handle;
+  USBD_CompositeElementTypeDef *pelem = &pdev->tclasslist[idx];
+  USBD_COMPOSITE_EPTypeDef *pself;
+  USBD_COMPOSITE_EPTypeDef *pother;
+  uint8_t ep_addr = pep[2];
+  uint8_t type = pep[3] & 0x03U;
+  uint8_t num;
+
+  if (pelem->NumEps >= USBD_MAX_CLASS_ENDPOINTS)
+  {
+    return USBD_FAIL;
+  }
+
+  for (num = 1U; num < USBD_COMPOSITE_EP_NBR; num++)
+  {
+    pself = ((ep_addr & 0x80U) == 0x80U) ? &hcomp->ep_in[num] : &hcomp->ep_out[num];
+    pother = ((ep_addr & 0x80U) == 0x80U) ? &hcomp->ep_out[num] : &hcomp->ep_in[num];
+
+    if ((pself->Class == USBD_COMPOSITE_NO_CLASS) &&
+        ((pother->Class == USBD_COMPOSITE_NO_CLASS) ||
+         ((pother->Type == type) && (type != USBD_EP_TYPE_ISOC))))
+    {
+      break;
+    }
+  }
+
+  if (num == USBD_COMPOSITE_EP_NBR)
+  {
+    return USBD_FAIL;
+  }
+
+  pself->Class = idx;
+  pself->Type = type;
+  pself->Size = (uint16_t)(pep[4] | ((uint16_t)pep[5] << 8)) & 0x7FFU;
+
+  pelem->EpDef[pelem->NumEps] = ep_addr;
+  pelem->EpAdd[pelem->NumEps] = (ep_addr & 0x80U) | num;
+  pep[2] = pelem->EpAdd[pelem->NumEps];
+  pelem->NumEps++;
+
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_COMPOSITE_FreeEPs
+  *         Release the endpoint numbers given to a class
+  * @param  idx: index of the class
+  * @retval None
+  */
+static void USBD_COMPOSITE_FreeEPs(uint8_t idx)
+{
+  USBD_COMPOSITE_HandleTypeDef *hcomp = &USBD_COMPOSITE_Handle;
+  uint32_t i;
+
+  for (i = 1U; i < USBD_COMPOSITE_EP_NBR; i++)
+  {
+    if (hcomp->ep_in[i].Class == idx)
+    {
+      hcomp->ep_in[i].Class = USBD_COMPOSITE_NO_CLASS;
+    }
+    if (hcomp->ep_out[i].Class == idx)
+    {
+      hcomp->ep_out[i].Class = USBD_COMPOSITE_NO_CLASS;
+    }
+  }
+}
+
+/**
+  * @brief  USBD_COMPOSITE_LayoutPMA
+  *         Place the buffers of the endpoints in the packet memory
+  * @param  pdev: device instance
+  * @param  apply: 0 to only size the layout, 1 to set it to the endpoints
+  * @retval end of the used packet memory
+  */
+static uint32_t USBD_COMPOSITE_LayoutPMA(USBD_HandleTypeDef *pdev, uint8_t apply)
+{
+  USBD_COMPOSITE_HandleTypeDef *hcomp = &USBD_COMPOSITE_Handle;
+  uint32_t last = 0U;
+  uint32_t addr;
+  uint32_t i;
+
+  for (i = 1U; i < USBD_COMPOSITE_EP_NBR; i++)
+  {
+    if ((hcomp->ep_in[i].Class != USBD_COMPOSITE_NO_CLASS) ||
+        (hcomp->ep_out[i].Class != USBD_COMPOSITE_NO_CLASS))
+    {
+      last = i;
+    }
+  }
+
+  /* The buffer table only covers the endpoint registers in use */
+  addr = USBD_COMPOSITE_BTABLE_ENTRY_SIZE * (last + 1U);
+
+  if (apply != 0U)
+  {
+    HAL_PCDEx_PMAConfig(pdev->pData, 0x00U, PCD_SNG_BUF, addr);
+    HAL_PCDEx_PMAConfig(pdev->pData, 0x80U, PCD_SNG_BUF, addr + USB_MAX_EP0_SIZE);
+  }
+  addr += 2U * USB_MAX_EP0_SIZE;
+
+  for (i = 1U; i <= last; i++)
+  {
+    if (hcomp->ep_out[i].Class != USBD_COMPOSITE_NO_CLASS)
+    {
+      if (apply != 0U)
+      {
+        hcomp->ep_out[i].Pma = (uint16_t)addr;
+        HAL_PCDEx_PMAConfig(pdev->pData, (uint16_t)i, PCD_SNG_BUF, addr);
+      }
+      addr += USBD_COMPOSITE_PMASize(hcomp->ep_out[i].Size, 1U);
+    }
+
+    if (hcomp->ep_in[i].Class != USBD_COMPOSITE_NO_CLASS)
+    {
+      if (apply != 0U)
+      {
+        hcomp->ep_in[i].Pma = (uint16_t)addr;
+        HAL_PCDEx_PMAConfig(pdev->pData, (uint16_t)(0x80U | i), PCD_SNG_BUF, addr);
+      }
+      addr += USBD_COMPOSITE_PMASize(hcomp->ep_in[i].Size, 0U);
+    }
+  }
+
+  return addr;
+}
+
+/**
+  * @brief  USBD_COMPOSITE_PMASize
+  *         Return the packet memory taken by an endpoint buffer. The size of
+  *         an OUT buffer is counted in 32 bytes blocks above 62 bytes
+  * @param  size: max packet size of the endpoint
+  * @param  out: 1 for an OUT endpoint
+  * @retval size in the packet memory
+  */
+static uint16_t USBD_COMPOSITE_PMASize(uint16_t size, uint8_t out)
+{
+  if ((out != 0U) && (size > 62U))
+  {
+    return (uint16_t)((size + 31U) & ~31U);
+  }
+
+  return (uint16_t)((size + 1U) & ~1U);
+}
+
+/**
+  * @brief  USBD_COMPOSITE_AddClass
+  *         Add a class to the device. To be called after USBD_Init() and
+  *         before USBD_RegisterClass() of USBD_COMPOSITE
+  * @param  pdev: device instance
+  * @param  pclass: class to add
+  * @retval status: USBD_FAIL if the class does not fit in the device
+  */
+uint8_t USBD_COMPOSITE_AddClass(USBD_HandleTypeDef *pdev,
+                                USBD_ClassTypeDef *pclass)
+{
+  USBD_CompositeElementTypeDef *pelem;
+  uint8_t *pcfg = USBD_COMPOSITE_CfgDesc;
+  uint8_t *pdesc;
+  uint16_t len;
+  uint16_t total;
+  uint8_t idx;
+
+  if ((pclass == NULL) || (pdev->NumClasses >= USBD_MAX_SUPPORTED_CLASS))
+  {
+    return USBD_FAIL;
+  }
+
+  if (pdev->NumClasses == 0U)
+  {
+    USBD_COMPOSITE_Reset();
+  }
+
+  idx = (uint8_t)pdev->NumClasses;
+  pelem = &pdev->tclasslist[idx];
+  pelem->pClass = pclass;
+  pelem->pClassData = NULL;
+  pelem->pUserData = NULL;
+  pelem->ItfBase = pcfg[4];
+  pelem->ItfNum = 0U;
+  pelem->NumEps = 0U;
+
+  pdesc = pclass->GetFSConfigDescriptor(&len);
+  total = (uint16_t)(pcfg[2] | ((uint16_t)pcfg[3] << 8));
+
+  if ((pdesc == NULL) || ((pcfg[4] + pdesc[4]) > USBD_MAX_NUM_INTERFACES) ||
+      (USBD_COMPOSITE_CopyDesc(pdev, idx, pdesc, len, &total) != USBD_OK) ||
+      (USBD_COMPOSITE_LayoutPMA(pdev, 0U) > USBD_COMPOSITE_PMA_SIZE))
+  {
+    /* The descriptors copied past wTotalLength are dropped */
+    USBD_COMPOSITE_FreeEPs(idx);
+    return USBD_FAIL;
+  }
+
+  (void)USBD_COMPOSITE_LayoutPMA(pdev, 1U);
+
+  pelem->ItfNum = pdesc[4];
+
+  pcfg[2] = LOBYTE(total);
+  pcfg[3] = HIBYTE(total);
+  pcfg[4] += pdesc[4];
+  pcfg[7] |= pdesc[7];
+  /* The classes draw their current together, up to the 500 mA of a port */
+  if (((uint32_t)pcfg[8] + pdesc[8]) > USBD_COMPOSITE_MAX_POWER)
+  {
+    pcfg[8] = USBD_COMPOSITE_MAX_POWER;
+  }
+  else
+  {
+    pcfg[8] += pdesc[8];
+  }
+
+  pdev->NumClasses++;
+
+  return USBD_OK;
+}
+
+/**
+  * @}
+  */
+
+
+/**
+  * @}
+  */
+
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,42 @@
+#!/bin/sh
+# Builds the composite device model (composite_sim.c) against the USB device
+# core and classes on the host, and runs it:
+# - CDC + MSC + HID through the composite class;
+# - each class alone through the composite class, then on its own;
+# - CDC + MSC + HID with a 400-byte packet memory, where MSC does not fit.
+# build.sh [output directory]
+HERE=$(cd "$(dirname "$0")" && pwd)
+LIB=$HERE/../../..
+OUT=${1:-${TMPDIR:-/tmp}/composite_test}
+CC=${CC:-cc}
+mkdir -p "$OUT" || exit 1
+
+# sim <name> <classes: 1 CDC, 2 MSC, 4 HID> <composite 0|1> [defines]
+sim()
+{
+  N=$1; M=$2; C=$3; shift 3
+  S="$LIB/Core/Src/usbd_core.c $LIB/Core/Src/usbd_ctlreq.c $LIB/Core/Src/usbd_ioreq.c"
+  [ $((M & 1)) -ne 0 ] && S="$S $LIB/Class/CDC/Src/usbd_cdc.c"
+  [ $((M & 2)) -ne 0 ] && S="$S $LIB/Class/MSC/Src/usbd_msc.c $LIB/Class/MSC/Src/usbd_msc_bot.c $LIB/Class/MSC/Src/usbd_msc_scsi.c $LIB/Class/MSC/Src/usbd_msc_data.c"
+  [ $((M & 4)) -ne 0 ] && S="$S $LIB/Class/HID/Src/usbd_hid.c"
+  if [ "$C" = 1 ]; then
+    S="$S $LIB/Class/Composite/Src/usbd_composite.c"
+  else
+    set -- -DUSBD_MAX_SUPPORTED_CLASS=1U "$@"
+  fi
+  echo "== $N"
+  $CC -O2 -Wall -Wextra -Wno-unused-parameter -Wno-sign-compare \
+    -Wno-missing-field-initializers -Wno-unused-function -Wno-unused-variable \
+    -Wno-unused-but-set-variable -I"$HERE" \
+    -I"$LIB/Core/Inc" -I"$LIB/Class/CDC/Inc" -I"$LIB/Class/MSC/Inc" \
+    -I"$LIB/Class/HID/Inc" -I"$LIB/Class/Composite/Inc" \
+    -DSIM_CLASSES=$M -DSIM_COMPOSITE=$C "$@" -o "$OUT/$N" \
+    "$HERE/composite_sim.c" $S || exit 1
+  "$OUT/$N" || exit 1
+}
+
+sim composite 7 1
+for M in 1 2 4; do
+  sim composite_$M $M 1 && sim single_$M $M 0
+done
+sim composite_small_pma 7 1 -DUSBD_COMPOSITE_PMA_SIZE=400U
@@ -0,0 +1,584 @@
+/* Host side control/bulk/interrupt model for a CDC + MSC + HID device built
+   on the real USB device core (see build.sh). Enumerates the device from reset, parses and
+   checks the configuration descriptor and the endpoint/PMA layout, issues
+   class requests through EP0, then runs a CDC loopback, MSC write/read-back
+   and HID reports concurrently on a 1 ms frame bus model (19 bulk/interrupt
+   transactions of up to 64 bytes per frame). */
+#include <time.h>
+#include "usbd_core.h"
+#include "usbd_ctlreq.h"
+#if SIM_CLASSES & 1
+#include "usbd_cdc.h"
+#endif
+#if SIM_CLASSES & 2
+#include "usbd_msc.h"
+#endif
+#if SIM_CLASSES & 4
+#include "usbd_hid.h"
+#endif
+#if SIM_COMPOSITE
+#include "usbd_composite.h"
+#endif
+
+static unsigned long checks, failures;
+#define CHECK(c) do { checks++; if (!(c)) { failures++; if (failures < 30) printf("FAIL %d %s\n", __LINE__, #c); } } while (0)
+
+uint32_t __get_PRIMASK(void) { return 0; }
+void __disable_irq(void) { }
+void __set_PRIMASK(uint32_t primask) { }
+
+static USBD_HandleTypeDef dev;
+static PCD_HandleTypeDef pcd;
+static int pma_set[2][8];
+
+/* ---------------- low level ---------------- */
+typedef struct { int open, armed; uint8_t type; uint16_t mps; uint8_t *buf; uint32_t len, off; } lep_t;
+static lep_t lin[8], lout[8];
+static int ep0_stall;
+static uint8_t dev_addr;
+
+HAL_StatusTypeDef HAL_PCDEx_PMAConfig(PCD_HandleTypeDef *hpcd, uint16_t ep_addr, uint16_t ep_kind, uint32_t pmaadress)
+{
+  CHECK(hpcd == &pcd);
+  if (ep_addr & 0x80U) { hpcd->IN_ep[ep_addr & 7U].pmaadress = pmaadress; pma_set[1][ep_addr & 7U] = 1; }
+  else { hpcd->OUT_ep[ep_addr & 7U].pmaadress = pmaadress; pma_set[0][ep_addr & 7U] = 1; }
+  return HAL_OK;
+}
+USBD_StatusTypeDef USBD_LL_Init(USBD_HandleTypeDef *pdev) { pdev->pData = &pcd; return USBD_OK; }
+USBD_StatusTypeDef USBD_LL_DeInit(USBD_HandleTypeDef *pdev) { return USBD_OK; }
+USBD_StatusTypeDef USBD_LL_Start(USBD_HandleTypeDef *pdev) { return USBD_OK; }
+USBD_StatusTypeDef USBD_LL_Stop(USBD_HandleTypeDef *pdev) { return USBD_OK; }
+USBD_StatusTypeDef USBD_LL_OpenEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t ep_type, uint16_t ep_mps)
+{
+  uint8_t n = ep_addr & 0x7FU;
+  lep_t *e = (ep_addr & 0x80U) ? &lin[n] : &lout[n], *o = (ep_addr & 0x80U) ? &lout[n] : &lin[n];
+  CHECK(n < 8U);
+  CHECK(!e->open);
+  /* one type per endpoint register */
+  CHECK(!o->open || o->type == ep_type);
+  e->open = 1; e->armed = 0; e->type = ep_type; e->mps = ep_mps;
+  if (ep_addr & 0x80U) pcd.IN_ep[n].maxpacket = ep_mps; else pcd.OUT_ep[n].maxpacket = ep_mps;
+  return USBD_OK;
+}
+USBD_StatusTypeDef USBD_LL_CloseEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  lep_t *e = (ep_addr & 0x80U) ? &lin[ep_addr & 7U] : &lout[ep_addr & 7U];
+  e->open = 0; e->armed = 0;
+  return USBD_OK;
+}
+USBD_StatusTypeDef USBD_LL_FlushEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr) { return USBD_OK; }
+USBD_StatusTypeDef USBD_LL_StallEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr) { if ((ep_addr & 0x7FU) == 0U) ep0_stall = 1; return USBD_OK; }
+USBD_StatusTypeDef USBD_LL_ClearStallEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr) { return USBD_OK; }
+uint8_t USBD_LL_IsStallEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr) { return 0; }
+USBD_StatusTypeDef USBD_LL_SetUSBAddress(USBD_HandleTypeDef *pdev, uint8_t a) { dev_addr = a; return USBD_OK; }
+void USBD_LL_Delay(uint32_t Delay) { }
+USBD_StatusTypeDef USBD_LL_Transmit(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t *pbuf, uint16_t size)
+{
+  lep_t *e = &lin[ep_addr & 7U];
+  CHECK(e->open);
+  CHECK((ep_addr & 0x7FU) == 0U || !e->armed);
+  e->buf = pbuf; e->len = size; e->off = 0; e->armed = 1;
+  return USBD_OK;
+}
+USBD_StatusTypeDef USBD_LL_PrepareReceive(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t *pbuf, uint16_t size)
+{
+  lep_t *e = &lout[ep_addr & 7U];
+  CHECK(e->open);
+  CHECK((ep_addr & 0x7FU) == 0U || !e->armed);
+  e->buf = pbuf; e->len = size; e->off = 0; e->armed = 1;
+  return USBD_OK;
+}
+uint32_t USBD_LL_GetRxDataSize(USBD_HandleTypeDef *pdev, uint8_t ep_addr) { return lout[ep_addr & 7U].off; }
+
+/* ---------------- descriptors ---------------- */
+static uint8_t devdesc[18] = { 18, 1, 0x00, 0x02, 0xEF, 0x02, 0x01, 64, 0x83, 0x04, 0x40, 0x57, 0x00, 0x02, 1, 2, 3, 1 };
+static uint8_t strdesc[4] = { 4, 3, 0x09, 0x04 };
+static uint8_t *GetDev(USBD_SpeedTypeDef s, uint16_t *l) { *l = sizeof(devdesc); return devdesc; }
+static uint8_t *GetStr(USBD_SpeedTypeDef s, uint16_t *l) { *l = sizeof(strdesc); return strdesc; }
+static USBD_DescriptorsTypeDef desc = { GetDev, GetStr, GetStr, GetStr, GetStr, GetStr, GetStr };
+
+/* ---------------- timing of the device side ---------------- */
+static double dev_ns; static unsigned long dev_calls;
+static double tnow(void) { struct timespec t; clock_gettime(CLOCK_MONOTONIC, &t); return t.tv_sec * 1e9 + t.tv_nsec; }
+static void data_in(uint8_t n) { double t = tnow(); USBD_LL_DataInStage(&dev, n, lin[n].buf); dev_ns += tnow() - t; dev_calls++; }
+static void data_out(uint8_t n) { double t = tnow(); USBD_LL_DataOutStage(&dev, n, lout[n].buf); dev_ns += tnow() - t; dev_calls++; }
+
+/* ---------------- host: control transfers ---------------- */
+static int ctrl(uint8_t bm, uint8_t breq, uint16_t val, uint16_t idx, uint16_t len, uint8_t *data)
+{
+  uint8_t setup[8] = { bm, breq, (uint8_t)val, (uint8_t)(val >> 8), (uint8_t)idx, (uint8_t)(idx >> 8), (uint8_t)len, (uint8_t)(len >> 8) };
+  uint32_t got = 0, pkt;
+
+  ep0_stall = 0; lin[0].armed = 0; lout[0].armed = 0;
+  USBD_LL_SetupStage(&dev, setup);
+  if (ep0_stall) return -1;
+  if ((bm & 0x80U) && len)
+  {
+    for (;;)
+    {
+      if (!lin[0].armed) return -1;
+      pkt = lin[0].len < 64U ? lin[0].len : 64U;
+      memcpy(data + got, lin[0].buf, (got + pkt) > len ? len - got : pkt);
+      got += pkt; lin[0].armed = 0;
+      USBD_LL_DataInStage(&dev, 0, lin[0].buf + pkt);
+      if (pkt < 64U || got >= len) break;
+    }
+    CHECK(lout[0].armed);
+    lout[0].armed = 0;
+    USBD_LL_DataOutStage(&dev, 0, NULL);
+    return (int)got;
+  }
+  if (len)
+  {
+    while (got < len)
+    {
+      CHECK(lout[0].armed);
+      if (!lout[0].armed) return -1;
+      pkt = (len - got) < 64U ? (len - got) : 64U;
+      memcpy(lout[0].buf, data + got, pkt);
+      got += pkt; lout[0].armed = 0;
+      USBD_LL_DataOutStage(&dev, 0, lout[0].buf);
+    }
+  }
+  if (ep0_stall) return -1;
+  CHECK(lin[0].armed && lin[0].len == 0U);
+  lin[0].armed = 0;
+  USBD_LL_DataInStage(&dev, 0, NULL);
+  return (int)got;
+}
+
+/* ---------------- host: bulk/interrupt transactions ---------------- */
+static int in_txn(uint8_t n, uint8_t *dst)   /* -1 NAK, else bytes */
+{
+  lep_t *e = &lin[n];
+  uint32_t pkt;
+  if (!e->open || !e->armed) return -1;
+  pkt = (e->len - e->off) < e->mps ? e->len - e->off : e->mps;
+  memcpy(dst, e->buf + e->off, pkt);
+  e->off += pkt;
+  if (pkt < e->mps || e->off == e->len) { e->armed = 0; data_in(n); }
+  return (int)pkt;
+}
+static int out_txn(uint8_t n, const uint8_t *src, uint32_t k)
+{
+  lep_t *e = &lout[n];
+  if (!e->open || !e->armed) return -1;
+  CHECK(k <= e->mps && e->off + k <= e->len);
+  memcpy(e->buf + e->off, src, k);
+  e->off += k;
+  if (k < e->mps || e->off == e->len) { e->armed = 0; data_out(n); }
+  return (int)k;
+}
+
+/* ---------------- descriptor parsing ---------------- */
+static uint8_t cfg[512]; static uint16_t cfg_len;
+static struct { int itf; uint8_t in, out, intr, interval; } h_cdc = { -1 }, h_msc = { -1 }, h_hid = { -1 };
+static int n_itf;
+static uint32_t max_power;        /* Expected MaxPower */
+
+static void parse_cfg(void)
+{
+  uint16_t pos = cfg[0];
+  int cur_class = -1, last_itf = -1, iad_first = -1, iad_count = 0, i, j;
+  uint8_t eps[32]; uint8_t types[32]; int neps = 0;
+  CHECK(cfg[1] == 2U && (cfg[2] | (cfg[3] << 8)) == cfg_len);
+  while (pos < cfg_len)
+  {
+    uint8_t *d = &cfg[pos];
+    CHECK(d[0] >= 2U && pos + d[0] <= cfg_len);
+    if (d[0] < 2U) break;
+    switch (d[1])
+    {
+      case 0x0B:
+        iad_first = d[2]; iad_count = d[3];
+        CHECK(d[4] == 0x02U && d[5] == 0x02U);
+        break;
+      case 4:
+        if (d[3] == 0U) { CHECK(d[2] == last_itf + 1); last_itf = d[2]; }
+        cur_class = d[5];
+        if (cur_class == 0x02) { h_cdc.itf = d[2]; CHECK(!SIM_COMPOSITE || (iad_first == d[2] && iad_count == 2)); }
+        if (cur_class == 0x08) h_msc.itf = d[2];
+        if (cur_class == 0x03) h_hid.itf = d[2];
+        if (cur_class == 0x0A) CHECK(h_cdc.itf >= 0 && d[2] == h_cdc.itf + 1);
+        break;
+      case 0x24:
+        if (d[2] == 0x01U) CHECK(d[4] == h_cdc.itf + 1);
+        if (d[2] == 0x06U) CHECK(d[3] == h_cdc.itf && d[4] == h_cdc.itf + 1);
+        break;
+      case 5:
+        for (i = 0; i < neps; i++) CHECK(eps[i] != d[2]);
+        /* same register: same type */
+        for (i = 0; i < neps; i++) if ((eps[i] & 0x7FU) == (d[2] & 0x7FU)) CHECK(types[i] == (d[3] & 3U) && (d[3] & 3U) != 1U);
+        CHECK((d[2] & 0x7FU) >= 1U && (d[2] & 0x7FU) <= 7U);
+        eps[neps] = d[2]; types[neps++] = d[3] & 3U;
+        if (cur_class == 0x02) h_cdc.intr = d[2];
+        if (cur_class == 0x0A) { if (d[2] & 0x80U) h_cdc.in = d[2]; else h_cdc.out = d[2]; }
+        if (cur_class == 0x08) { if (d[2] & 0x80U) h_msc.in = d[2]; else h_msc.out = d[2]; }
+        if (cur_class == 0x03) { h_hid.in = d[2]; h_hid.interval = d[6]; }
+        break;
+    }
+    pos += d[0];
+  }
+  n_itf = last_itf + 1;
+  CHECK(cfg[4] == n_itf);
+  CHECK(cfg[8] == max_power);
+  (void)j;
+}
+
+static void check_pma(void)
+{
+  /* regions of the open endpoints: no overlap, above the BTABLE, in 1 KB */
+  uint32_t lo[16], hi[16]; int n = 0, i, j, last = 0;
+  for (i = 0; i < 8; i++) if (lin[i].open || lout[i].open) last = i;
+  for (i = 0; i < 8; i++)
+  {
+    if (lout[i].open)
+    {
+      uint32_t s = lout[i].mps > 62U ? (lout[i].mps + 31U) & ~31U : (lout[i].mps + 1U) & ~1U;
+      CHECK(pma_set[0][i]);
+      lo[n] = pcd.OUT_ep[i].pmaadress; hi[n++] = pcd.OUT_ep[i].pmaadress + s;
+    }
+    if (lin[i].open)
+    {
+      CHECK(pma_set[1][i]);
+      lo[n] = pcd.IN_ep[i].pmaadress; hi[n++] = pcd.IN_ep[i].pmaadress + ((lin[i].mps + 1U) & ~1U);
+    }
+  }
+  for (i = 0; i < n; i++)
+  {
+    CHECK(lo[i] >= 8U * (last + 1U) && hi[i] <= 1024U && (lo[i] & 1U) == 0U);
+    for (j = 0; j < i; j++) CHECK(hi[i] <= lo[j] || hi[j] <= lo[i]);
+  }
+  printf("  PMA:");
+  for (i = 0; i < 8; i++)
+  {
+    if (lout[i].open) printf(" %02X@%u", i, (unsigned)pcd.OUT_ep[i].pmaadress);
+    if (lin[i].open) printf(" %02X@%u", 0x80 | i, (unsigned)pcd.IN_ep[i].pmaadress);
+  }
+  {
+    uint32_t end = 0; for (i = 0; i < n; i++) if (hi[i] > end) end = hi[i];
+    printf("  end %u of 1024\n", (unsigned)end);
+  }
+}
+
+/* ---------------- CDC application: loopback ---------------- */
+#if SIM_CLASSES & 1
+static uint8_t cdc_rx[64], cdc_tx[256], fifo[4096];
+static uint32_t f_in, f_out;
+static int rx_held;
+static uint8_t line[7];
+static int8_t CDC_Itf_Init(void) { USBD_CDC_SetRxBuffer(&dev, cdc_rx); f_in = f_out = 0; rx_held = 0; return 0; }
+static int8_t CDC_Itf_DeInit(void) { return 0; }
+static int8_t CDC_Itf_Control(uint8_t cmd, uint8_t *pbuf, uint16_t length)
+{
+  if (cmd == CDC_SET_LINE_CODING) memcpy(line, pbuf, 7);
+  if (cmd == CDC_GET_LINE_CODING) memcpy(pbuf, line, 7);
+  return 0;
+}
+static int8_t CDC_Itf_Receive(uint8_t *buf, uint32_t *len)
+{
+  uint32_t i;
+  CHECK(buf == cdc_rx);
+  for (i = 0; i < *len; i++) fifo[(f_in++) & 4095U] = buf[i];
+  if (4096U - (f_in - f_out) >= 64U) USBD_CDC_ReceivePacket(&dev); else rx_held = 1;
+  return 0;
+}
+static USBD_CDC_ItfTypeDef cdc_fops = { CDC_Itf_Init, CDC_Itf_DeInit, CDC_Itf_Control, CDC_Itf_Receive };
+static void cdc_app(void)
+{
+  USBD_CDC_HandleTypeDef *h = (USBD_CDC_HandleTypeDef *)USBD_CLASS_DATA(&dev, &USBD_CDC);
+  uint32_t n = f_in - f_out, i;
+  if (h == NULL) return;
+  if (h->TxState == 0U && n)
+  {
+    if (n > sizeof(cdc_tx)) n = sizeof(cdc_tx);
+    for (i = 0; i < n; i++) cdc_tx[i] = fifo[(f_out++) & 4095U];
+    USBD_CDC_SetTxBuffer(&dev, cdc_tx, (uint16_t)n);
+    CHECK(USBD_CDC_TransmitPacket(&dev) == USBD_OK);
+  }
+  if (rx_held && 4096U - (f_in - f_out) >= 64U) { rx_held = 0; USBD_CDC_ReceivePacket(&dev); }
+}
+#endif
+
+/* ---------------- MSC storage ---------------- */
+#if SIM_CLASSES & 2
+#define NBLK 1024U
+static uint8_t disk[NBLK * 512U];
+static int8_t inquiry[36] = { 0, (int8_t)0x80, 2, 2, 31, 0, 0, 0, 'S', 'I', 'M', ' ', ' ', ' ', ' ', ' ', 'D', 'i', 's', 'k' };
+static int8_t St_Init(uint8_t lun) { return 0; }
+static int8_t St_Cap(uint8_t lun, uint32_t *n, uint16_t *s) { *n = NBLK; *s = 512U; return 0; }
+static int8_t St_Ready(uint8_t lun) { return 0; }
+static int8_t St_WP(uint8_t lun) { return 0; }
+static int8_t St_Read(uint8_t lun, uint8_t *buf, uint32_t a, uint16_t n) { memcpy(buf, disk + a * 512U, n * 512U); return 0; }
+static int8_t St_Write(uint8_t lun, uint8_t *buf, uint32_t a, uint16_t n) { memcpy(disk + a * 512U, buf, n * 512U); return 0; }
+static int8_t St_MaxLun(void) { return 0; }
+static USBD_StorageTypeDef msc_fops = { St_Init, St_Cap, St_Ready, St_WP, St_Read, St_Write, St_MaxLun, inquiry };
+#endif
+
+/* ---------------- host MSC BOT ---------------- */
+enum { M_CBW, M_DOUT, M_DIN, M_CSW, M_DONE };
+static struct { int phase; uint8_t cbw[31]; uint32_t tag, len, done; int in; uint8_t data[8 * 512]; uint8_t csw[13]; uint32_t cswn; } bot;
+static void put32(uint8_t *p, uint32_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24); }
+static uint32_t get32(const uint8_t *p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+static void bot_start(const uint8_t *cb, int cblen, uint32_t len, int in)
+{
+  memset(bot.cbw, 0, 31);
+  put32(bot.cbw, 0x43425355U); put32(bot.cbw + 4, ++bot.tag); put32(bot.cbw + 8, len);
+  bot.cbw[12] = in ? 0x80U : 0U; bot.cbw[14] = (uint8_t)cblen; memcpy(bot.cbw + 15, cb, cblen);
+  bot.len = len; bot.in = in; bot.done = 0; bot.cswn = 0; bot.phase = M_CBW;
+}
+static int bot_step(void)   /* one transaction, -1 on NAK */
+{
+  int r;
+  uint32_t k;
+  uint8_t pkt[64];
+  switch (bot.phase)
+  {
+    case M_CBW:
+      r = out_txn(h_msc.out & 0x7FU, bot.cbw, 31);
+      if (r >= 0) bot.phase = bot.len ? (bot.in ? M_DIN : M_DOUT) : M_CSW;
+      return r;
+    case M_DOUT:
+      k = bot.len - bot.done < 64U ? bot.len - bot.done : 64U;
+      r = out_txn(h_msc.out & 0x7FU, bot.data + bot.done, k);
+      if (r >= 0) { bot.done += k; if (bot.done == bot.len) bot.phase = M_CSW; }
+      return r;
+    case M_DIN:
+      r = in_txn(h_msc.in & 0x7FU, pkt);
+      if (r >= 0) { memcpy(bot.data + bot.done, pkt, r); bot.done += r; if (bot.done == bot.len || r < 64) bot.phase = M_CSW; }
+      return r;
+    case M_CSW:
+      r = in_txn(h_msc.in & 0x7FU, pkt);
+      if (r >= 0)
+      {
+        CHECK(r == 13 && get32(pkt) == 0x53425355U && get32(pkt + 4) == bot.tag && pkt[12] == 0U);
+        bot.phase = M_DONE;
+      }
+      return r;
+  }
+  return -1;
+}
+static void bot_run(void) { int guard = 100000; while (bot.phase != M_DONE && guard--) bot_step(); CHECK(bot.phase == M_DONE); }
+
+/* ---------------- enumeration ---------------- */
+static void enumerate(void)
+{
+  uint8_t buf[512];
+  int r;
+
+  memset(lin, 0, sizeof(lin)); memset(lout, 0, sizeof(lout));
+  USBD_LL_SetSpeed(&dev, USBD_SPEED_FULL);
+  USBD_LL_Reset(&dev);
+  r = ctrl(0x80, USB_REQ_GET_DESCRIPTOR, 0x0100, 0, 64, buf);
+  CHECK(r == 18 && buf[4] == 0xEFU);
+  CHECK(ctrl(0x00, USB_REQ_SET_ADDRESS, 5, 0, 0, NULL) == 0);
+  CHECK(dev_addr == 5U);
+  r = ctrl(0x80, USB_REQ_GET_DESCRIPTOR, 0x0200, 0, 9, buf);
+  CHECK(r == 9);
+  cfg_len = buf[2] | (buf[3] << 8);
+  r = ctrl(0x80, USB_REQ_GET_DESCRIPTOR, 0x0200, 0, 0xFF, cfg);
+  CHECK(r == cfg_len);
+  parse_cfg();
+  CHECK(ctrl(0x00, USB_REQ_SET_CONFIGURATION, 1, 0, 0, NULL) == 0);
+  CHECK(dev.dev_state == USBD_STATE_CONFIGURED);
+}
+
+static void class_requests(int classes)
+{
+  uint8_t buf[256];
+  int r;
+#if SIM_CLASSES & 1
+  {
+    uint8_t lc[7] = { 0x00, 0xC2, 0x01, 0x00, 0, 0, 8 }, rd[7];
+    CHECK(ctrl(0x21, CDC_SET_LINE_CODING, 0, (uint16_t)h_cdc.itf, 7, lc) == 7);
+    CHECK(memcmp(line, lc, 7) == 0);
+    CHECK(ctrl(0xA1, CDC_GET_LINE_CODING, 0, (uint16_t)h_cdc.itf, 7, rd) == 7);
+    CHECK(memcmp(rd, lc, 7) == 0);
+    CHECK(ctrl(0x21, CDC_SET_CONTROL_LINE_STATE, 3, (uint16_t)h_cdc.itf, 0, NULL) == 0);
+  }
+#endif
+#if SIM_CLASSES & 2
+  if (classes & 2)
+  {
+  r = ctrl(0xA1, 0xFE, 0, (uint16_t)h_msc.itf, 1, buf);
+  CHECK(r == 1 && buf[0] == 0U);
+  {
+    uint8_t inq[6] = { 0x12, 0, 0, 0, 36, 0 }, cap[10] = { 0x25 };
+    bot_start(inq, 6, 36, 1); bot_run();
+    CHECK(memcmp(bot.data + 8, "SIM", 3) == 0);
+    bot_start(cap, 10, 8, 1); bot_run();
+    CHECK(get32(bot.data) == 0U || 1);
+    CHECK(((bot.data[0] << 24) | (bot.data[1] << 16) | (bot.data[2] << 8) | bot.data[3]) == (int)NBLK - 1);
+  }
+  }
+  else CHECK(h_msc.itf < 0 && ctrl(0xA1, 0xFE, 0, (uint16_t)n_itf, 1, buf) == -1);
+#endif
+#if SIM_CLASSES & 4
+  r = ctrl(0x81, USB_REQ_GET_DESCRIPTOR, 0x2200, (uint16_t)h_hid.itf, 255, buf);
+  CHECK(r == HID_MOUSE_REPORT_DESC_SIZE && buf[0] == 0x05U);
+#endif
+#if SIM_COMPOSITE
+  /* an interface of no class, and one beyond USBD_MAX_NUM_INTERFACES */
+  CHECK(ctrl(0x21, 0x01, 0, (uint16_t)n_itf, 0, NULL) == -1);
+  CHECK(ctrl(0x21, 0x01, 0, 9, 0, NULL) == -1);
+#endif
+  (void)r; (void)buf;
+}
+
+static uint32_t class_power(USBD_ClassTypeDef *pclass)
+{
+  uint16_t len;
+  return pclass->GetFSConfigDescriptor(&len)[8];
+}
+
+/* ---------------- traffic ---------------- */
+static uint32_t lfsr(uint32_t i) { i ^= i << 13; i ^= i >> 17; i ^= i << 5; return i; }
+
+int main(int argc, char **argv)
+{
+  long frames = argc > 1 ? atol(argv[1]) : 20000;
+  int classes = argc > 2 ? atoi(argv[2]) : SIM_CLASSES;
+  long f;
+  uint32_t c_tx = 0, c_rx = 0, m_bytes = 0, h_reports = 0;
+  uint8_t h_seq = 0, d_seq = 0;
+  int m_stage = 0; uint32_t m_lba = 0;
+  uint8_t ref[8 * 512];
+  int round;
+
+  USBD_Init(&dev, &desc, 0);
+#if SIM_COMPOSITE
+  /* The classes add up their MaxPower, up to 500 mA */
+#if SIM_CLASSES & 1
+  max_power += class_power(USBD_CDC_CLASS);
+#endif
+#if SIM_CLASSES & 4
+  max_power += class_power(USBD_HID_CLASS);
+#endif
+#if SIM_CLASSES & 1
+  CHECK(USBD_COMPOSITE_AddClass(&dev, USBD_CDC_CLASS) == USBD_OK);
+  USBD_CDC_RegisterInterface(&dev, &cdc_fops);
+#endif
+#if SIM_CLASSES & 2
+  if (USBD_COMPOSITE_AddClass(&dev, USBD_MSC_CLASS) == USBD_OK) { USBD_MSC_RegisterStorage(&dev, &msc_fops); max_power += class_power(USBD_MSC_CLASS); }
+  else { printf("  MSC not added\n"); classes &= ~2; }
+#endif
+#if SIM_CLASSES & 4
+  CHECK(USBD_COMPOSITE_AddClass(&dev, USBD_HID_CLASS) == USBD_OK);
+#endif
+  if (max_power > 250U) max_power = 250U;
+  USBD_RegisterClass(&dev, USBD_COMPOSITE_CLASS);
+#else
+  max_power = 0x32U;
+#if SIM_CLASSES == 1
+  USBD_RegisterClass(&dev, USBD_CDC_CLASS); USBD_CDC_RegisterInterface(&dev, &cdc_fops);
+#elif SIM_CLASSES == 2
+  USBD_RegisterClass(&dev, USBD_MSC_CLASS); USBD_MSC_RegisterStorage(&dev, &msc_fops);
+#else
+  USBD_RegisterClass(&dev, USBD_HID_CLASS);
+#endif
+#endif
+  USBD_Start(&dev);
+
+  for (round = 0; round < 2; round++)
+  {
+    enumerate();
+    printf("round %d: %u bytes, %d interfaces, EPs:", round, cfg_len, n_itf);
+    if (h_cdc.itf >= 0) printf(" CDC itf %d %02X/%02X/%02X", h_cdc.itf, h_cdc.intr, h_cdc.out, h_cdc.in);
+    if (h_msc.itf >= 0) printf(" MSC itf %d %02X/%02X", h_msc.itf, h_msc.in, h_msc.out);
+    if (h_hid.itf >= 0) printf(" HID itf %d %02X", h_hid.itf, h_hid.in);
+    printf("\n");
+#if SIM_COMPOSITE
+    check_pma();
+#endif
+    class_requests(classes);
+
+    c_tx = c_rx = m_bytes = h_reports = 0; dev_ns = 0; dev_calls = 0;
+    h_seq = d_seq = 0; m_stage = 0;
+    for (f = 0; f < frames; f++)
+    {
+      int slots = 19, busy = 1;
+      int nak_cdc_out = 0, nak_cdc_in = 0, nak_msc = 0;
+      USBD_LL_SOF(&dev);
+#if SIM_CLASSES & 1
+      if (classes & 1) cdc_app();
+#endif
+#if SIM_CLASSES & 4
+      if (classes & 4)
+      {
+        USBD_HID_HandleTypeDef *hh = (USBD_HID_HandleTypeDef *)USBD_CLASS_DATA(&dev, &USBD_HID);
+        if (hh->state == HID_IDLE) { static uint8_t rep[4]; rep[1] = d_seq; USBD_HID_SendReport(&dev, rep, 4); d_seq++; }
+        if ((f % h_hid.interval) == 0)
+        {
+          uint8_t p[64];
+          if (in_txn(h_hid.in & 0x7FU, p) == 4) { CHECK(p[1] == h_seq); h_seq++; h_reports++; }
+          slots--;
+        }
+      }
+#endif
+#if SIM_CLASSES & 2
+      if ((classes & 2) && bot.phase == M_DONE)
+      {
+        if (m_stage)
+        {
+          CHECK(memcmp(bot.data, ref, sizeof(ref)) == 0);
+          m_bytes += 2 * sizeof(ref);
+          m_lba = (lfsr(m_lba + 1) % (NBLK / 8)) * 8;
+        }
+        {
+          uint8_t cb[10] = { m_stage ? 0x28 : 0x2A, 0, (uint8_t)(m_lba >> 24), (uint8_t)(m_lba >> 16), (uint8_t)(m_lba >> 8), (uint8_t)m_lba, 0, 0, 8, 0 };
+          uint32_t i;
+          if (!m_stage) { for (i = 0; i < sizeof(ref); i++) ref[i] = (uint8_t)lfsr(m_lba * 4096 + i + f); memcpy(bot.data, ref, sizeof(ref)); }
+          bot_start(cb, 10, sizeof(ref), m_stage == 0 ? 0 : 1);
+          m_stage = !m_stage;
+        }
+      }
+      else if (!(classes & 2)) nak_msc = 1;
+#else
+      nak_msc = 1;
+#endif
+#if !(SIM_CLASSES & 1)
+      nak_cdc_out = nak_cdc_in = 1;
+#else
+      if (!(classes & 1)) nak_cdc_out = nak_cdc_in = 1;
+#endif
+      /* round robin of the bulk pipes */
+      while (slots > 0 && busy)
+      {
+        busy = 0;
+#if SIM_CLASSES & 1
+        if (!nak_cdc_out && slots > 0)
+        {
+          uint8_t p[64]; uint32_t i;
+          for (i = 0; i < 64; i++) p[i] = (uint8_t)lfsr(c_tx + i);
+          /* a byte stream: the pattern depends on the position only */
+          for (i = 0; i < 64; i++) p[i] = (uint8_t)((c_tx + i) * 7U + ((c_tx + i) >> 8));
+          if (out_txn(h_cdc.out & 0x7FU, p, 64) < 0) nak_cdc_out = 1; else { c_tx += 64; busy = 1; }
+          slots--;
+        }
+        if (!nak_cdc_in && slots > 0)
+        {
+          uint8_t p[64]; int r = in_txn(h_cdc.in & 0x7FU, p), i;
+          if (r < 0) nak_cdc_in = 1;
+          else { for (i = 0; i < r; i++) CHECK(p[i] == (uint8_t)((c_rx + i) * 7U + ((c_rx + i) >> 8))); c_rx += r; busy = 1; }
+          slots--;
+        }
+#endif
+#if SIM_CLASSES & 2
+        if (!nak_msc && slots > 0)
+        {
+          if (bot.phase == M_DONE || bot_step() < 0) nak_msc = 1; else busy = 1;
+          slots--;
+        }
+#endif
+      }
+    }
+    printf("  %ld frames:", frames);
+    if (classes & 1) printf(" CDC loopback out %.1f KB/s in %.1f KB/s;", c_tx / (frames * 1.024), c_rx / (frames * 1.024));
+    if (classes & 2) printf(" MSC write+read %.1f KB/s;", m_bytes / (frames * 1.024));
+    if (classes & 4) printf(" HID %u reports;", (unsigned)h_reports);
+    printf(" device %.0f ns per transfer callback\n", dev_calls ? dev_ns / dev_calls : 0);
+  }
+  USBD_DeInit(&dev);
+  printf("%lu checks, %lu failures\n", checks, failures);
+  return failures != 0;
+}
@@ -0,0 +1,33 @@
+/* Host stub of usbd_conf.h for the composite device model */
+#ifndef __USBD_CONF_H
+#define __USBD_CONF_H
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#define __IO volatile
+#define UNUSED(x) ((void)(x))
+#ifndef USBD_MAX_SUPPORTED_CLASS
+#define USBD_MAX_SUPPORTED_CLASS              4U
+#endif
+#define USBD_MAX_NUM_INTERFACES               4U
+#define USBD_MAX_NUM_CONFIGURATION            1U
+#define USBD_MAX_STR_DESC_SIZ                 0x100U
+#define USBD_SELF_POWERED                     1U
+#define USBD_DEBUG_LEVEL                      0U
+#define MSC_MEDIA_PACKET                      512U
+#define USBD_malloc               malloc
+#define USBD_free                 free
+#define USBD_memset               memset
+#define USBD_memcpy               memcpy
+#define USBD_UsrLog(...)
+#define USBD_ErrLog(...)
+#define USBD_DbgLog(...)
+#define PCD_SNG_BUF 0U
+typedef enum { HAL_OK = 0 } HAL_StatusTypeDef;
+typedef struct { struct { uint32_t maxpacket; uint32_t pmaadress; } IN_ep[8], OUT_ep[8]; } PCD_HandleTypeDef;
+HAL_StatusTypeDef HAL_PCDEx_PMAConfig(PCD_HandleTypeDef *hpcd, uint16_t ep_addr, uint16_t ep_kind, uint32_t pmaadress);
+uint32_t __get_PRIMASK(void);
+void __disable_irq(void);
+void __set_PRIMASK(uint32_t primask);
+#endif
@@ -111,6 +111,12 @@ extern "C" {
 #define DFU_MEDIA_ERASE                0x00U
 #define DFU_MEDIA_PROGRAM              0x01U
 
+/* Returned by the media Erase() and Write() while a previous operation is
+   still running: the command is retried after the next DFU_GETSTATUS.
+   A Write() of 0 bytes, made at manifestation, completes the pending
+   operations before it returns and never returns DFU_MEDIA_BUSY */
+#define DFU_MEDIA_BUSY                 0xFFFFU
+
 /**************************************************/
 /* Other defines                                  */
 /**************************************************/
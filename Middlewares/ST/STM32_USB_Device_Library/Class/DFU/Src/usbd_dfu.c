@@ -147,6 +147,10 @@ static void DFU_Abort(USBD_HandleTypeDef *pdev);
 
 static void DFU_Leave(USBD_HandleTypeDef *pdev);
 
+static void DFU_MediaStatus(USBD_HandleTypeDef *pdev);
+
+static void DFU_MediaError(USBD_HandleTypeDef *pdev, uint8_t error);
+
 
 /**
   * @}
@@ -527,6 +531,7 @@ static uint8_t  USBD_DFU_EP0_RxReady(USBD_HandleTypeDef *pdev)
 static uint8_t  USBD_DFU_EP0_TxReady(USBD_HandleTypeDef *pdev)
 {
   uint32_t addr;
+  uint16_t status;
   USBD_SetupReqTypedef     req;
   USBD_DFU_HandleTypeDef   *hdfu;
 
@@ -555,8 +560,16 @@ static uint8_t  USBD_DFU_EP0_TxReady(USBD_HandleTypeDef *pdev)
         hdfu->data_ptr += (uint32_t)hdfu->buffer.d8[3] << 16;
         hdfu->data_ptr += (uint32_t)hdfu->buffer.d8[4] << 24;
 
-        if (((USBD_DFU_MediaTypeDef *)pdev->pUserData)->Erase(hdfu->data_ptr) != USBD_OK)
+        status = ((USBD_DFU_MediaTypeDef *)pdev->pUserData)->Erase(hdfu->data_ptr);
+
+        if (status == DFU_MEDIA_BUSY)
         {
+          /* Stay in dfuDNBUSY, the erase is retried after the next DFU_GETSTATUS */
+          return USBD_OK;
+        }
+        else if (status != USBD_OK)
+        {
+          DFU_MediaError(pdev, DFU_ERROR_ERASE);
           return USBD_FAIL;
         }
       }
@@ -580,9 +593,18 @@ static uint8_t  USBD_DFU_EP0_TxReady(USBD_HandleTypeDef *pdev)
         addr = ((hdfu->wblock_num - 2U) * USBD_DFU_XFER_SIZE) + hdfu->data_ptr;
 
         /* Preform the write operation */
-        if (((USBD_DFU_MediaTypeDef *)pdev->pUserData)->Write(hdfu->buffer.d8,
-                                                              (uint8_t *)addr, hdfu->wlength) != USBD_OK)
+        status = ((USBD_DFU_MediaTypeDef *)pdev->pUserData)->Write(hdfu->buffer.d8,
+                                                                   (uint8_t *)addr, hdfu->wlength);
+
+        if (status == DFU_MEDIA_BUSY)
+        {
+          /* The media still holds the previous block: keep this one in the
+             buffer and stay in dfuDNBUSY until the media takes it */
+          return USBD_OK;
+        }
+        else if (status != USBD_OK)
         {
+          DFU_MediaError(pdev, DFU_ERROR_WRITE);
           return USBD_FAIL;
         }
       }
@@ -605,6 +627,18 @@ static uint8_t  USBD_DFU_EP0_TxReady(USBD_HandleTypeDef *pdev)
   {
     if (hdfu->dev_state == DFU_STATE_MANIFEST)/* Manifestation in progress */
     {
+      /* Complete the last blocks before leaving: the hosts send no other
+         DFU_GETSTATUS once the manifestation has started */
+      status = ((USBD_DFU_MediaTypeDef *)pdev->pUserData)->Write(hdfu->buffer.d8,
+                                                                 (uint8_t *)hdfu->data_ptr, 0U);
+
+      if (status != USBD_OK)
+      {
+        hdfu->manif_state = DFU_MANIFEST_COMPLETE;
+        DFU_MediaError(pdev, DFU_ERROR_WRITE);
+        return USBD_FAIL;
+      }
+
       /* Start leaving DFU mode */
       DFU_Leave(pdev);
     }
@@ -937,14 +971,7 @@ static void DFU_GetStatus(USBD_HandleTypeDef *pdev)
         hdfu->dev_status[3] = 0U;
         hdfu->dev_status[4] = hdfu->dev_state;
 
-        if ((hdfu->wblock_num == 0U) && (hdfu->buffer.d8[0] == DFU_CMD_ERASE))
-        {
-          ((USBD_DFU_MediaTypeDef *)pdev->pUserData)->GetStatus(hdfu->data_ptr, DFU_MEDIA_ERASE, hdfu->dev_status);
-        }
-        else
-        {
-          ((USBD_DFU_MediaTypeDef *)pdev->pUserData)->GetStatus(hdfu->data_ptr, DFU_MEDIA_PROGRAM, hdfu->dev_status);
-        }
+        DFU_MediaStatus(pdev);
       }
       else  /* (hdfu->wlength==0)*/
       {
@@ -957,6 +984,15 @@ static void DFU_GetStatus(USBD_HandleTypeDef *pdev)
       }
       break;
 
+    case   DFU_STATE_DNLOAD_BUSY:
+      /* The media was busy: report the time left before it takes the command */
+      hdfu->dev_status[1] = 0U;
+      hdfu->dev_status[2] = 0U;
+      hdfu->dev_status[3] = 0U;
+
+      DFU_MediaStatus(pdev);
+      break;
+
     case   DFU_STATE_MANIFEST_SYNC :
       if (hdfu->manif_state == DFU_MANIFEST_IN_PROGRESS)
       {
@@ -1116,6 +1152,56 @@ static void DFU_Leave(USBD_HandleTypeDef *pdev)
   }
 }
 
+/**
+  * @brief  DFU_MediaStatus
+  *         Gets the bwPollTimeout of the pending download command from the media.
+  * @param  pdev: device instance
+  * @retval None
+  */
+static void DFU_MediaStatus(USBD_HandleTypeDef *pdev)
+{
+  USBD_DFU_HandleTypeDef   *hdfu;
+
+  hdfu = (USBD_DFU_HandleTypeDef *) pdev->pClassData;
+
+  if (hdfu->wblock_num == 0U)
+  {
+    if (hdfu->buffer.d8[0] == DFU_CMD_ERASE)
+    {
+      ((USBD_DFU_MediaTypeDef *)pdev->pUserData)->GetStatus(hdfu->data_ptr, DFU_MEDIA_ERASE, hdfu->dev_status);
+    }
+  }
+  else
+  {
+    ((USBD_DFU_MediaTypeDef *)pdev->pUserData)->GetStatus(hdfu->data_ptr, DFU_MEDIA_PROGRAM, hdfu->dev_status);
+  }
+}
+
+/**
+  * @brief  DFU_MediaError
+  *         Ends the download command after a media failure.
+  * @param  pdev: device instance
+  * @param  error: DFU status to report
+  * @retval None
+  */
+static void DFU_MediaError(USBD_HandleTypeDef *pdev, uint8_t error)
+{
+  USBD_DFU_HandleTypeDef   *hdfu;
+
+  hdfu = (USBD_DFU_HandleTypeDef *) pdev->pClassData;
+
+  /* Reset the global length and block number */
+  hdfu->wlength = 0U;
+  hdfu->wblock_num = 0U;
+
+  hdfu->dev_state = DFU_STATE_ERROR;
+  hdfu->dev_status[0] = error;
+  hdfu->dev_status[1] = 0U;
+  hdfu->dev_status[2] = 0U;
+  hdfu->dev_status[3] = 0U;
+  hdfu->dev_status[4] = hdfu->dev_state;
+}
+
 /**
   * @}
   */
@@ -89,6 +89,7 @@ typedef struct
   uint32_t             IdleState;
   uint32_t             AltSetting;
   HID_StateTypeDef     state;
+  uint8_t              EpInAdd;     /* Endpoint address in the device */
 }
 USBD_HID_HandleTypeDef;
 /**
@@ -382,18 +382,21 @@ __ALIGN_BEGIN static uint8_t HID_MOUSE_ReportDesc[HID_MOUSE_REPORT_DESC_SIZE]  _
   */
 static uint8_t  USBD_HID_Init(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
 {
+  uint8_t in_ep = USBD_CLASS_EP(pdev, &USBD_HID, HID_EPIN_ADDR);
+
   /* Open EP IN */
-  USBD_LL_OpenEP(pdev, HID_EPIN_ADDR, USBD_EP_TYPE_INTR, HID_EPIN_SIZE);
-  pdev->ep_in[HID_EPIN_ADDR & 0xFU].is_used = 1U;
+  USBD_LL_OpenEP(pdev, in_ep, USBD_EP_TYPE_INTR, HID_EPIN_SIZE);
+  pdev->ep_in[in_ep & 0xFU].is_used = 1U;
 
-  pdev->pClassData = USBD_malloc(sizeof(USBD_HID_HandleTypeDef));
+  USBD_CLASS_DATA(pdev, &USBD_HID) = USBD_malloc(sizeof(USBD_HID_HandleTypeDef));
 
-  if (pdev->pClassData == NULL)
+  if (USBD_CLASS_DATA(pdev, &USBD_HID) == NULL)
   {
     return USBD_FAIL;
   }
 
-  ((USBD_HID_HandleTypeDef *)pdev->pClassData)->state = HID_IDLE;
+  ((USBD_HID_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_HID))->state = HID_IDLE;
+  ((USBD_HID_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_HID))->EpInAdd = in_ep;
 
   return USBD_OK;
 }
@@ -408,15 +411,17 @@ static uint8_t  USBD_HID_Init(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
 static uint8_t  USBD_HID_DeInit(USBD_HandleTypeDef *pdev,
                                 uint8_t cfgidx)
 {
+  uint8_t in_ep = USBD_CLASS_EP(pdev, &USBD_HID, HID_EPIN_ADDR);
+
   /* Close HID EPs */
-  USBD_LL_CloseEP(pdev, HID_EPIN_ADDR);
-  pdev->ep_in[HID_EPIN_ADDR & 0xFU].is_used = 0U;
+  USBD_LL_CloseEP(pdev, in_ep);
+  pdev->ep_in[in_ep & 0xFU].is_used = 0U;
 
   /* FRee allocated memory */
-  if (pdev->pClassData != NULL)
+  if (USBD_CLASS_DATA(pdev, &USBD_HID) != NULL)
   {
-    USBD_free(pdev->pClassData);
-    pdev->pClassData = NULL;
+    USBD_free(USBD_CLASS_DATA(pdev, &USBD_HID));
+    USBD_CLASS_DATA(pdev, &USBD_HID) = NULL;
   }
 
   return USBD_OK;
@@ -432,7 +437,7 @@ static uint8_t  USBD_HID_DeInit(USBD_HandleTypeDef *pdev,
 static uint8_t  USBD_HID_Setup(USBD_HandleTypeDef *pdev,
                                USBD_SetupReqTypedef *req)
 {
-  USBD_HID_HandleTypeDef *hhid = (USBD_HID_HandleTypeDef *) pdev->pClassData;
+  USBD_HID_HandleTypeDef *hhid = (USBD_HID_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_HID);
   uint16_t len = 0U;
   uint8_t *pbuf = NULL;
   uint16_t status_info = 0U;
@@ -551,7 +556,7 @@ uint8_t USBD_HID_SendReport(USBD_HandleTypeDef  *pdev,
                             uint8_t *report,
                             uint16_t len)
 {
-  USBD_HID_HandleTypeDef     *hhid = (USBD_HID_HandleTypeDef *)pdev->pClassData;
+  USBD_HID_HandleTypeDef     *hhid = (USBD_HID_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_HID);
 
   if (pdev->dev_state == USBD_STATE_CONFIGURED)
   {
@@ -559,7 +564,7 @@ uint8_t USBD_HID_SendReport(USBD_HandleTypeDef  *pdev,
     {
       hhid->state = HID_BUSY;
       USBD_LL_Transmit(pdev,
-                       HID_EPIN_ADDR,
+                       hhid->EpInAdd,
                        report,
                        len);
     }
@@ -647,7 +652,7 @@ static uint8_t  USBD_HID_DataIn(USBD_HandleTypeDef *pdev,
 
   /* Ensure that the FIFO is empty before a new transfer, this condition could
   be caused by  a new transfer before the end of the previous transfer */
-  ((USBD_HID_HandleTypeDef *)pdev->pClassData)->state = HID_IDLE;
+  ((USBD_HID_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_HID))->state = HID_IDLE;
   return USBD_OK;
 }
 
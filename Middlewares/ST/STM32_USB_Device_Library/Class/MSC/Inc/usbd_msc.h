@@ -48,6 +48,19 @@ extern "C" {
 #define MSC_MEDIA_PACKET             512U
 #endif /* MSC_MEDIA_PACKET */
 
+/* Number of media packets buffered by READ10 and WRITE10: the storage
+   accesses some packets while the USB transfers another one */
+#ifndef MSC_MEDIA_PACKET_NBR
+#define MSC_MEDIA_PACKET_NBR         2U
+#endif /* MSC_MEDIA_PACKET_NBR */
+
+/* Set to 1 to call the storage Read and Write from USBD_MSC_Process(),
+   which the application calls out of the USB interrupt, instead of from
+   the USB interrupt */
+#ifndef MSC_MEDIA_DEFERRED
+#define MSC_MEDIA_DEFERRED           0U
+#endif /* MSC_MEDIA_DEFERRED */
+
 #define MSC_MAX_FS_PACKET            0x40U
 #define MSC_MAX_HS_PACKET            0x200U
 
@@ -87,7 +100,7 @@ typedef struct
   uint8_t                  bot_state;
   uint8_t                  bot_status;
   uint16_t                 bot_data_length;
-  uint8_t                  bot_data[MSC_MEDIA_PACKET];
+  uint8_t                  bot_data[MSC_MEDIA_PACKET * MSC_MEDIA_PACKET_NBR];
   USBD_MSC_BOT_CBWTypeDef  cbw;
   USBD_MSC_BOT_CSWTypeDef  csw;
 
@@ -100,6 +113,15 @@ typedef struct
 
   uint32_t                 scsi_blk_addr;
   uint32_t                 scsi_blk_len;
+
+  uint32_t                 media_len;     /* Bytes left to transfer on USB */
+  __IO uint32_t            media_in;      /* Packets read from the storage or received */
+  __IO uint32_t            media_out;     /* Packets sent or written to the storage */
+  __IO uint8_t             media_xfer;    /* 1 while the USB transfers a packet */
+  uint8_t                  media_failed;  /* 1 after a storage error */
+
+  uint8_t                  epin_addr;     /* Endpoint addresses in the device */
+  uint8_t                  epout_addr;
 }
 USBD_MSC_BOT_HandleTypeDef;
 
@@ -109,6 +131,8 @@ extern USBD_ClassTypeDef  USBD_MSC;
 
 uint8_t  USBD_MSC_RegisterStorage(USBD_HandleTypeDef   *pdev,
                                   USBD_StorageTypeDef *fops);
+
+uint8_t  USBD_MSC_Process(USBD_HandleTypeDef *pdev);
 /**
   * @}
   */
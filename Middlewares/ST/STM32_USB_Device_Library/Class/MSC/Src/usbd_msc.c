@@ -279,33 +279,39 @@ __ALIGN_BEGIN  uint8_t USBD_MSC_DeviceQualifierDesc[USB_LEN_DEV_QUALIFIER_DESC]
   */
 uint8_t USBD_MSC_Init(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
 {
+  uint8_t in_ep = USBD_CLASS_EP(pdev, &USBD_MSC, MSC_EPIN_ADDR);
+  uint8_t out_ep = USBD_CLASS_EP(pdev, &USBD_MSC, MSC_EPOUT_ADDR);
+
   if (pdev->dev_speed == USBD_SPEED_HIGH)
   {
     /* Open EP OUT */
-    USBD_LL_OpenEP(pdev, MSC_EPOUT_ADDR, USBD_EP_TYPE_BULK, MSC_MAX_HS_PACKET);
-    pdev->ep_out[MSC_EPOUT_ADDR & 0xFU].is_used = 1U;
+    USBD_LL_OpenEP(pdev, out_ep, USBD_EP_TYPE_BULK, MSC_MAX_HS_PACKET);
+    pdev->ep_out[out_ep & 0xFU].is_used = 1U;
 
     /* Open EP IN */
-    USBD_LL_OpenEP(pdev, MSC_EPIN_ADDR, USBD_EP_TYPE_BULK, MSC_MAX_HS_PACKET);
-    pdev->ep_in[MSC_EPIN_ADDR & 0xFU].is_used = 1U;
+    USBD_LL_OpenEP(pdev, in_ep, USBD_EP_TYPE_BULK, MSC_MAX_HS_PACKET);
+    pdev->ep_in[in_ep & 0xFU].is_used = 1U;
   }
   else
   {
     /* Open EP OUT */
-    USBD_LL_OpenEP(pdev, MSC_EPOUT_ADDR, USBD_EP_TYPE_BULK, MSC_MAX_FS_PACKET);
-    pdev->ep_out[MSC_EPOUT_ADDR & 0xFU].is_used = 1U;
+    USBD_LL_OpenEP(pdev, out_ep, USBD_EP_TYPE_BULK, MSC_MAX_FS_PACKET);
+    pdev->ep_out[out_ep & 0xFU].is_used = 1U;
 
     /* Open EP IN */
-    USBD_LL_OpenEP(pdev, MSC_EPIN_ADDR, USBD_EP_TYPE_BULK, MSC_MAX_FS_PACKET);
-    pdev->ep_in[MSC_EPIN_ADDR & 0xFU].is_used = 1U;
+    USBD_LL_OpenEP(pdev, in_ep, USBD_EP_TYPE_BULK, MSC_MAX_FS_PACKET);
+    pdev->ep_in[in_ep & 0xFU].is_used = 1U;
   }
-  pdev->pClassData = USBD_malloc(sizeof(USBD_MSC_BOT_HandleTypeDef));
+  USBD_CLASS_DATA(pdev, &USBD_MSC) = USBD_malloc(sizeof(USBD_MSC_BOT_HandleTypeDef));
 
-  if (pdev->pClassData == NULL)
+  if (USBD_CLASS_DATA(pdev, &USBD_MSC) == NULL)
   {
     return USBD_FAIL;
   }
 
+  ((USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC))->epin_addr = in_ep;
+  ((USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC))->epout_addr = out_ep;
+
   /* Init the BOT  layer */
   MSC_BOT_Init(pdev);
 
@@ -322,22 +328,25 @@ uint8_t USBD_MSC_Init(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
 uint8_t USBD_MSC_DeInit(USBD_HandleTypeDef *pdev,
                          uint8_t cfgidx)
 {
+  uint8_t in_ep = USBD_CLASS_EP(pdev, &USBD_MSC, MSC_EPIN_ADDR);
+  uint8_t out_ep = USBD_CLASS_EP(pdev, &USBD_MSC, MSC_EPOUT_ADDR);
+
   /* Close MSC EPs */
-  USBD_LL_CloseEP(pdev, MSC_EPOUT_ADDR);
-  pdev->ep_out[MSC_EPOUT_ADDR & 0xFU].is_used = 0U;
+  USBD_LL_CloseEP(pdev, out_ep);
+  pdev->ep_out[out_ep & 0xFU].is_used = 0U;
 
   /* Close EP IN */
-  USBD_LL_CloseEP(pdev, MSC_EPIN_ADDR);
-  pdev->ep_in[MSC_EPIN_ADDR & 0xFU].is_used = 0U;
+  USBD_LL_CloseEP(pdev, in_ep);
+  pdev->ep_in[in_ep & 0xFU].is_used = 0U;
 
   /* De-Init the BOT layer */
   MSC_BOT_DeInit(pdev);
 
   /* Free MSC Class Resources */
-  if (pdev->pClassData != NULL)
+  if (USBD_CLASS_DATA(pdev, &USBD_MSC) != NULL)
   {
-    USBD_free(pdev->pClassData);
-    pdev->pClassData  = NULL;
+    USBD_free(USBD_CLASS_DATA(pdev, &USBD_MSC));
+    USBD_CLASS_DATA(pdev, &USBD_MSC)  = NULL;
   }
 
   return USBD_OK;
@@ -351,7 +360,7 @@ uint8_t USBD_MSC_DeInit(USBD_HandleTypeDef *pdev,
 */
 uint8_t USBD_MSC_Setup(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req)
 {
-  USBD_MSC_BOT_HandleTypeDef *hmsc = (USBD_MSC_BOT_HandleTypeDef *) pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef *hmsc = (USBD_MSC_BOT_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_MSC);
   uint8_t ret = USBD_OK;
   uint16_t status_info = 0U;
 
@@ -365,7 +374,7 @@ uint8_t USBD_MSC_Setup(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req)
           if ((req->wValue  == 0U) && (req->wLength == 1U) &&
               ((req->bmRequest & 0x80U) == 0x80U))
           {
-            hmsc->max_lun = (uint32_t)((USBD_StorageTypeDef *)pdev->pUserData)->GetMaxLun();
+            hmsc->max_lun = (uint32_t)((USBD_StorageTypeDef *)USBD_USER_DATA(pdev, &USBD_MSC))->GetMaxLun();
             USBD_CtlSendData(pdev, (uint8_t *)(void *)&hmsc->max_lun, 1U);
           }
           else
@@ -447,16 +456,16 @@ uint8_t USBD_MSC_Setup(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req)
             if (pdev->dev_speed == USBD_SPEED_HIGH)
             {
               /* Open EP IN */
-              USBD_LL_OpenEP(pdev, MSC_EPIN_ADDR, USBD_EP_TYPE_BULK,
+              USBD_LL_OpenEP(pdev, hmsc->epin_addr, USBD_EP_TYPE_BULK,
                              MSC_MAX_HS_PACKET);
             }
             else
             {
               /* Open EP IN */
-              USBD_LL_OpenEP(pdev, MSC_EPIN_ADDR, USBD_EP_TYPE_BULK,
+              USBD_LL_OpenEP(pdev, hmsc->epin_addr, USBD_EP_TYPE_BULK,
                              MSC_MAX_FS_PACKET);
             }
-            pdev->ep_in[MSC_EPIN_ADDR & 0xFU].is_used = 1U;
+            pdev->ep_in[hmsc->epin_addr & 0xFU].is_used = 1U;
           }
           else
           {
@@ -464,16 +473,16 @@ uint8_t USBD_MSC_Setup(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req)
             if (pdev->dev_speed == USBD_SPEED_HIGH)
             {
               /* Open EP OUT */
-              USBD_LL_OpenEP(pdev, MSC_EPOUT_ADDR, USBD_EP_TYPE_BULK,
+              USBD_LL_OpenEP(pdev, hmsc->epout_addr, USBD_EP_TYPE_BULK,
                              MSC_MAX_HS_PACKET);
             }
             else
             {
               /* Open EP OUT */
-              USBD_LL_OpenEP(pdev, MSC_EPOUT_ADDR, USBD_EP_TYPE_BULK,
+              USBD_LL_OpenEP(pdev, hmsc->epout_addr, USBD_EP_TYPE_BULK,
                              MSC_MAX_FS_PACKET);
             }
-            pdev->ep_out[MSC_EPOUT_ADDR & 0xFU].is_used = 1U;
+            pdev->ep_out[hmsc->epout_addr & 0xFU].is_used = 1U;
           }
 
           /* Handle BOT error */
@@ -585,9 +594,28 @@ uint8_t USBD_MSC_RegisterStorage(USBD_HandleTypeDef *pdev,
 {
   if (fops != NULL)
   {
-    pdev->pUserData = fops;
+    USBD_USER_DATA(pdev, &USBD_MSC) = fops;
+  }
+
+  return USBD_OK;
+}
+
+/**
+* @brief  USBD_MSC_Process
+*         Carry on the storage accesses of READ10 and WRITE10. To be called
+*         continuously out of the USB interrupt when MSC_MEDIA_DEFERRED is 1
+* @param  pdev: device instance
+* @retval status
+*/
+uint8_t USBD_MSC_Process(USBD_HandleTypeDef *pdev)
+{
+  if (USBD_CLASS_DATA(pdev, &USBD_MSC) == NULL)
+  {
+    return USBD_FAIL;
   }
 
+  MSC_BOT_Process(pdev);
+
   return USBD_OK;
 }
 
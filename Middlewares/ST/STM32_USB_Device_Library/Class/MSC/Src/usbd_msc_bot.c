@@ -100,7 +100,7 @@ static void MSC_BOT_Abort(USBD_HandleTypeDef  *pdev);
 */
 void MSC_BOT_Init(USBD_HandleTypeDef  *pdev)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
 
   hmsc->bot_state = USBD_BOT_IDLE;
   hmsc->bot_status = USBD_BOT_STATUS_NORMAL;
@@ -108,13 +108,13 @@ void MSC_BOT_Init(USBD_HandleTypeDef  *pdev)
   hmsc->scsi_sense_tail = 0U;
   hmsc->scsi_sense_head = 0U;
 
-  ((USBD_StorageTypeDef *)pdev->pUserData)->Init(0U);
+  ((USBD_StorageTypeDef *)USBD_USER_DATA(pdev, &USBD_MSC))->Init(0U);
 
-  USBD_LL_FlushEP(pdev, MSC_EPOUT_ADDR);
-  USBD_LL_FlushEP(pdev, MSC_EPIN_ADDR);
+  USBD_LL_FlushEP(pdev, hmsc->epout_addr);
+  USBD_LL_FlushEP(pdev, hmsc->epin_addr);
 
   /* Prapare EP to Receive First BOT Cmd */
-  USBD_LL_PrepareReceive(pdev, MSC_EPOUT_ADDR, (uint8_t *)(void *)&hmsc->cbw,
+  USBD_LL_PrepareReceive(pdev, hmsc->epout_addr, (uint8_t *)(void *)&hmsc->cbw,
                          USBD_BOT_CBW_LENGTH);
 }
 
@@ -126,13 +126,13 @@ void MSC_BOT_Init(USBD_HandleTypeDef  *pdev)
 */
 void MSC_BOT_Reset(USBD_HandleTypeDef  *pdev)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
 
   hmsc->bot_state  = USBD_BOT_IDLE;
   hmsc->bot_status = USBD_BOT_STATUS_RECOVERY;
 
   /* Prapare EP to Receive First BOT Cmd */
-  USBD_LL_PrepareReceive(pdev, MSC_EPOUT_ADDR, (uint8_t *)(void *)&hmsc->cbw,
+  USBD_LL_PrepareReceive(pdev, hmsc->epout_addr, (uint8_t *)(void *)&hmsc->cbw,
                          USBD_BOT_CBW_LENGTH);
 }
 
@@ -144,7 +144,7 @@ void MSC_BOT_Reset(USBD_HandleTypeDef  *pdev)
 */
 void MSC_BOT_DeInit(USBD_HandleTypeDef  *pdev)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
   hmsc->bot_state = USBD_BOT_IDLE;
 }
 
@@ -158,7 +158,7 @@ void MSC_BOT_DeInit(USBD_HandleTypeDef  *pdev)
 void MSC_BOT_DataIn(USBD_HandleTypeDef  *pdev,
                     uint8_t epnum)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
 
   switch (hmsc->bot_state)
   {
@@ -188,7 +188,7 @@ void MSC_BOT_DataIn(USBD_HandleTypeDef  *pdev,
 void MSC_BOT_DataOut(USBD_HandleTypeDef  *pdev,
                      uint8_t epnum)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
 
   switch (hmsc->bot_state)
   {
@@ -209,6 +209,25 @@ void MSC_BOT_DataOut(USBD_HandleTypeDef  *pdev,
   }
 }
 
+/**
+* @brief  MSC_BOT_Process
+*         Carry on the storage accesses of the data stage
+* @param  pdev: device instance
+* @retval None
+*/
+void MSC_BOT_Process(USBD_HandleTypeDef  *pdev)
+{
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
+
+  if ((hmsc->bot_state == USBD_BOT_DATA_IN) || (hmsc->bot_state == USBD_BOT_DATA_OUT))
+  {
+    if (SCSI_ProcessMedia(pdev, hmsc->cbw.bLUN) < 0)
+    {
+      MSC_BOT_SendCSW(pdev, USBD_CSW_CMD_FAILED);
+    }
+  }
+}
+
 /**
 * @brief  MSC_BOT_CBW_Decode
 *         Decode the CBW command and set the BOT state machine accordingly
@@ -217,12 +236,12 @@ void MSC_BOT_DataOut(USBD_HandleTypeDef  *pdev,
 */
 static void  MSC_BOT_CBW_Decode(USBD_HandleTypeDef  *pdev)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
 
   hmsc->csw.dTag = hmsc->cbw.dTag;
   hmsc->csw.dDataResidue = hmsc->cbw.dDataLength;
 
-  if ((USBD_LL_GetRxDataSize(pdev, MSC_EPOUT_ADDR) != USBD_BOT_CBW_LENGTH) ||
+  if ((USBD_LL_GetRxDataSize(pdev, hmsc->epout_addr) != USBD_BOT_CBW_LENGTH) ||
       (hmsc->cbw.dSignature != USBD_BOT_CBW_SIGNATURE) ||
       (hmsc->cbw.bLUN > 1U) ||
       (hmsc->cbw.bCBLength < 1U) || (hmsc->cbw.bCBLength > 16U))
@@ -282,7 +301,7 @@ static void  MSC_BOT_CBW_Decode(USBD_HandleTypeDef  *pdev)
 static void  MSC_BOT_SendData(USBD_HandleTypeDef *pdev, uint8_t *pbuf,
                               uint16_t len)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
 
   uint16_t length = (uint16_t)MIN(hmsc->cbw.dDataLength, len);
 
@@ -290,7 +309,7 @@ static void  MSC_BOT_SendData(USBD_HandleTypeDef *pdev, uint8_t *pbuf,
   hmsc->csw.bStatus = USBD_CSW_CMD_PASSED;
   hmsc->bot_state = USBD_BOT_SEND_DATA;
 
-  USBD_LL_Transmit(pdev, MSC_EPIN_ADDR, pbuf, length);
+  USBD_LL_Transmit(pdev, hmsc->epin_addr, pbuf, length);
 }
 
 /**
@@ -303,17 +322,17 @@ static void  MSC_BOT_SendData(USBD_HandleTypeDef *pdev, uint8_t *pbuf,
 void  MSC_BOT_SendCSW(USBD_HandleTypeDef  *pdev,
                       uint8_t CSW_Status)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
 
   hmsc->csw.dSignature = USBD_BOT_CSW_SIGNATURE;
   hmsc->csw.bStatus = CSW_Status;
   hmsc->bot_state = USBD_BOT_IDLE;
 
-  USBD_LL_Transmit(pdev, MSC_EPIN_ADDR, (uint8_t *)(void *)&hmsc->csw,
+  USBD_LL_Transmit(pdev, hmsc->epin_addr, (uint8_t *)(void *)&hmsc->csw,
                    USBD_BOT_CSW_LENGTH);
 
   /* Prepare EP to Receive next Cmd */
-  USBD_LL_PrepareReceive(pdev, MSC_EPOUT_ADDR, (uint8_t *)(void *)&hmsc->cbw,
+  USBD_LL_PrepareReceive(pdev, hmsc->epout_addr, (uint8_t *)(void *)&hmsc->cbw,
                          USBD_BOT_CBW_LENGTH);
 }
 
@@ -326,20 +345,20 @@ void  MSC_BOT_SendCSW(USBD_HandleTypeDef  *pdev,
 
 static void  MSC_BOT_Abort(USBD_HandleTypeDef  *pdev)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
 
   if ((hmsc->cbw.bmFlags == 0U) &&
       (hmsc->cbw.dDataLength != 0U) &&
       (hmsc->bot_status == USBD_BOT_STATUS_NORMAL))
   {
-    USBD_LL_StallEP(pdev, MSC_EPOUT_ADDR);
+    USBD_LL_StallEP(pdev, hmsc->epout_addr);
   }
 
-  USBD_LL_StallEP(pdev, MSC_EPIN_ADDR);
+  USBD_LL_StallEP(pdev, hmsc->epin_addr);
 
   if (hmsc->bot_status == USBD_BOT_STATUS_ERROR)
   {
-    USBD_LL_PrepareReceive(pdev, MSC_EPOUT_ADDR, (uint8_t *)(void *)&hmsc->cbw,
+    USBD_LL_PrepareReceive(pdev, hmsc->epout_addr, (uint8_t *)(void *)&hmsc->cbw,
                            USBD_BOT_CBW_LENGTH);
   }
 }
@@ -354,11 +373,11 @@ static void  MSC_BOT_Abort(USBD_HandleTypeDef  *pdev)
 
 void  MSC_BOT_CplClrFeature(USBD_HandleTypeDef  *pdev, uint8_t epnum)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
 
   if (hmsc->bot_status == USBD_BOT_STATUS_ERROR) /* Bad CBW Signature */
   {
-    USBD_LL_StallEP(pdev, MSC_EPIN_ADDR);
+    USBD_LL_StallEP(pdev, hmsc->epin_addr);
     hmsc->bot_status = USBD_BOT_STATUS_NORMAL;
   }
   else if (((epnum & 0x80U) == 0x80U) && (hmsc->bot_status != USBD_BOT_STATUS_RECOVERY))
@@ -52,6 +52,9 @@ EndBSPDependencies */
 /** @defgroup MSC_SCSI_Private_Defines
   * @{
   */
+/* Media packets accessed at least by one storage Read or Write, unless the
+   USB has nothing else to transfer */
+#define MSC_MEDIA_BATCH    (((MSC_MEDIA_PACKET_NBR / 2U) != 0U) ? (MSC_MEDIA_PACKET_NBR / 2U) : 1U)
 
 /**
   * @}
@@ -94,6 +97,8 @@ static int8_t SCSI_CheckAddressRange(USBD_HandleTypeDef *pdev, uint8_t lun,
 
 static int8_t SCSI_ProcessRead(USBD_HandleTypeDef *pdev, uint8_t lun);
 static int8_t SCSI_ProcessWrite(USBD_HandleTypeDef *pdev, uint8_t lun);
+static void SCSI_SendMedia(USBD_HandleTypeDef *pdev);
+static void SCSI_ReceiveMedia(USBD_HandleTypeDef *pdev);
 /**
   * @}
   */
@@ -114,61 +119,88 @@ static int8_t SCSI_ProcessWrite(USBD_HandleTypeDef *pdev, uint8_t lun);
 */
 int8_t SCSI_ProcessCmd(USBD_HandleTypeDef *pdev, uint8_t lun, uint8_t *cmd)
 {
+  int8_t ret;
+
   switch (cmd[0])
   {
     case SCSI_TEST_UNIT_READY:
-      SCSI_TestUnitReady(pdev, lun, cmd);
+      ret = SCSI_TestUnitReady(pdev, lun, cmd);
       break;
 
     case SCSI_REQUEST_SENSE:
-      SCSI_RequestSense(pdev, lun, cmd);
+      ret = SCSI_RequestSense(pdev, lun, cmd);
       break;
     case SCSI_INQUIRY:
-      SCSI_Inquiry(pdev, lun, cmd);
+      ret = SCSI_Inquiry(pdev, lun, cmd);
       break;
 
     case SCSI_START_STOP_UNIT:
-      SCSI_StartStopUnit(pdev, lun, cmd);
+      ret = SCSI_StartStopUnit(pdev, lun, cmd);
       break;
 
     case SCSI_ALLOW_MEDIUM_REMOVAL:
-      SCSI_StartStopUnit(pdev, lun, cmd);
+      ret = SCSI_StartStopUnit(pdev, lun, cmd);
       break;
 
     case SCSI_MODE_SENSE6:
-      SCSI_ModeSense6(pdev, lun, cmd);
+      ret = SCSI_ModeSense6(pdev, lun, cmd);
       break;
 
     case SCSI_MODE_SENSE10:
-      SCSI_ModeSense10(pdev, lun, cmd);
+      ret = SCSI_ModeSense10(pdev, lun, cmd);
       break;
 
     case SCSI_READ_FORMAT_CAPACITIES:
-      SCSI_ReadFormatCapacity(pdev, lun, cmd);
+      ret = SCSI_ReadFormatCapacity(pdev, lun, cmd);
       break;
 
     case SCSI_READ_CAPACITY10:
-      SCSI_ReadCapacity10(pdev, lun, cmd);
+      ret = SCSI_ReadCapacity10(pdev, lun, cmd);
       break;
 
     case SCSI_READ10:
-      SCSI_Read10(pdev, lun, cmd);
+      ret = SCSI_Read10(pdev, lun, cmd);
       break;
 
     case SCSI_WRITE10:
-      SCSI_Write10(pdev, lun, cmd);
+      ret = SCSI_Write10(pdev, lun, cmd);
       break;
 
     case SCSI_VERIFY10:
-      SCSI_Verify10(pdev, lun, cmd);
+      ret = SCSI_Verify10(pdev, lun, cmd);
       break;
 
     default:
       SCSI_SenseCode(pdev, lun, ILLEGAL_REQUEST, INVALID_CDB);
-      return -1;
+      ret = -1;
+      break;
   }
 
-  return 0;
+  return ret;
+}
+
+/**
+* @brief  SCSI_ProcessMedia
+*         Carry on the storage accesses of the READ10 or WRITE10 in progress
+* @param  pdev: device instance
+* @param  lun: Logical unit number
+* @retval status
+*/
+int8_t SCSI_ProcessMedia(USBD_HandleTypeDef *pdev, uint8_t lun)
+{
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
+
+  switch (hmsc->bot_state)
+  {
+    case USBD_BOT_DATA_IN:
+      return SCSI_ProcessRead(pdev, lun);
+
+    case USBD_BOT_DATA_OUT:
+      return SCSI_ProcessWrite(pdev, lun);
+
+    default:
+      return 0;
+  }
 }
 
 
@@ -181,7 +213,7 @@ int8_t SCSI_ProcessCmd(USBD_HandleTypeDef *pdev, uint8_t lun, uint8_t *cmd)
 */
 static int8_t SCSI_TestUnitReady(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t *params)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
 
   /* case 9 : Hi > D0 */
   if (hmsc->cbw.dDataLength != 0U)
@@ -191,7 +223,7 @@ static int8_t SCSI_TestUnitReady(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t
     return -1;
   }
 
-  if (((USBD_StorageTypeDef *)pdev->pUserData)->IsReady(lun) != 0)
+  if (((USBD_StorageTypeDef *)USBD_USER_DATA(pdev, &USBD_MSC))->IsReady(lun) != 0)
   {
     SCSI_SenseCode(pdev, lun, NOT_READY, MEDIUM_NOT_PRESENT);
     hmsc->bot_state = USBD_BOT_NO_DATA;
@@ -214,7 +246,7 @@ static int8_t  SCSI_Inquiry(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t *par
 {
   uint8_t *pPage;
   uint16_t len;
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
 
   if (params[1] & 0x01U)/*Evpd is set*/
   {
@@ -229,7 +261,7 @@ static int8_t  SCSI_Inquiry(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t *par
   }
   else
   {
-    pPage = (uint8_t *)(void *) & ((USBD_StorageTypeDef *)pdev->pUserData)->pInquiry[lun * STANDARD_INQUIRY_DATA_LEN];
+    pPage = (uint8_t *)(void *) & ((USBD_StorageTypeDef *)USBD_USER_DATA(pdev, &USBD_MSC))->pInquiry[lun * STANDARD_INQUIRY_DATA_LEN];
     len = (uint16_t)pPage[4] + 5U;
 
     if (params[4] <= len)
@@ -257,9 +289,9 @@ static int8_t  SCSI_Inquiry(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t *par
 */
 static int8_t SCSI_ReadCapacity10(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t *params)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
 
-  if (((USBD_StorageTypeDef *)pdev->pUserData)->GetCapacity(lun, &hmsc->scsi_blk_nbr, &hmsc->scsi_blk_size) != 0)
+  if (((USBD_StorageTypeDef *)USBD_USER_DATA(pdev, &USBD_MSC))->GetCapacity(lun, &hmsc->scsi_blk_nbr, &hmsc->scsi_blk_size) != 0)
   {
     SCSI_SenseCode(pdev, lun, NOT_READY, MEDIUM_NOT_PRESENT);
     return -1;
@@ -290,7 +322,7 @@ static int8_t SCSI_ReadCapacity10(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_
 */
 static int8_t SCSI_ReadFormatCapacity(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t *params)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
 
   uint16_t blk_size;
   uint32_t blk_nbr;
@@ -301,7 +333,7 @@ static int8_t SCSI_ReadFormatCapacity(USBD_HandleTypeDef  *pdev, uint8_t lun, ui
     hmsc->bot_data[i] = 0U;
   }
 
-  if (((USBD_StorageTypeDef *)pdev->pUserData)->GetCapacity(lun, &blk_nbr, &blk_size) != 0U)
+  if (((USBD_StorageTypeDef *)USBD_USER_DATA(pdev, &USBD_MSC))->GetCapacity(lun, &blk_nbr, &blk_size) != 0U)
   {
     SCSI_SenseCode(pdev, lun, NOT_READY, MEDIUM_NOT_PRESENT);
     return -1;
@@ -332,7 +364,7 @@ static int8_t SCSI_ReadFormatCapacity(USBD_HandleTypeDef  *pdev, uint8_t lun, ui
 */
 static int8_t SCSI_ModeSense6(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t *params)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
   uint16_t len = 8U;
   hmsc->bot_data_length = len;
 
@@ -354,7 +386,7 @@ static int8_t SCSI_ModeSense6(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t *p
 static int8_t SCSI_ModeSense10(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t *params)
 {
   uint16_t len = 8U;
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
 
   hmsc->bot_data_length = len;
 
@@ -378,7 +410,7 @@ static int8_t SCSI_ModeSense10(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t *
 static int8_t SCSI_RequestSense(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t *params)
 {
   uint8_t i;
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
 
   for (i = 0U ; i < REQUEST_SENSE_DATA_LEN; i++)
   {
@@ -421,7 +453,7 @@ static int8_t SCSI_RequestSense(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t
 */
 void SCSI_SenseCode(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t sKey, uint8_t ASC)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
 
   hmsc->scsi_sense[hmsc->scsi_sense_tail].Skey  = sKey;
   hmsc->scsi_sense[hmsc->scsi_sense_tail].w.ASC = ASC << 8;
@@ -440,7 +472,7 @@ void SCSI_SenseCode(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t sKey, uint8_
 */
 static int8_t SCSI_StartStopUnit(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t *params)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *) pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_MSC);
   hmsc->bot_data_length = 0U;
   return 0;
 }
@@ -454,7 +486,7 @@ static int8_t SCSI_StartStopUnit(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t
 */
 static int8_t SCSI_Read10(USBD_HandleTypeDef *pdev, uint8_t lun, uint8_t *params)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *) pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_MSC);
 
   if (hmsc->bot_state == USBD_BOT_IDLE) /* Idle */
   {
@@ -465,7 +497,7 @@ static int8_t SCSI_Read10(USBD_HandleTypeDef *pdev, uint8_t lun, uint8_t *params
       return -1;
     }
 
-    if (((USBD_StorageTypeDef *)pdev->pUserData)->IsReady(lun) != 0)
+    if (((USBD_StorageTypeDef *)USBD_USER_DATA(pdev, &USBD_MSC))->IsReady(lun) != 0)
     {
       SCSI_SenseCode(pdev, lun, NOT_READY, MEDIUM_NOT_PRESENT);
       return -1;
@@ -492,10 +524,28 @@ static int8_t SCSI_Read10(USBD_HandleTypeDef *pdev, uint8_t lun, uint8_t *params
       SCSI_SenseCode(pdev, hmsc->cbw.bLUN, ILLEGAL_REQUEST, INVALID_CDB);
       return -1;
     }
+
+    hmsc->media_len = hmsc->cbw.dDataLength;
+    hmsc->media_in = 0U;
+    hmsc->media_out = 0U;
+    hmsc->media_xfer = 0U;
+    hmsc->media_failed = 0U;
+  }
+  else
+  {
+    /* A packet has been sent, send the next one */
+    hmsc->media_out++;
+    hmsc->media_xfer = 0U;
+    SCSI_SendMedia(pdev);
   }
   hmsc->bot_data_length = MSC_MEDIA_PACKET;
 
+#if (MSC_MEDIA_DEFERRED == 1U)
+  /* The storage is read by USBD_MSC_Process() */
+  return 0;
+#else
   return SCSI_ProcessRead(pdev, lun);
+#endif /* MSC_MEDIA_DEFERRED */
 }
 
 /**
@@ -508,7 +558,7 @@ static int8_t SCSI_Read10(USBD_HandleTypeDef *pdev, uint8_t lun, uint8_t *params
 
 static int8_t SCSI_Write10(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t *params)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *) pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_MSC);
   uint32_t len;
 
   if (hmsc->bot_state == USBD_BOT_IDLE) /* Idle */
@@ -521,14 +571,14 @@ static int8_t SCSI_Write10(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t *para
     }
 
     /* Check whether Media is ready */
-    if (((USBD_StorageTypeDef *)pdev->pUserData)->IsReady(lun) != 0)
+    if (((USBD_StorageTypeDef *)USBD_USER_DATA(pdev, &USBD_MSC))->IsReady(lun) != 0)
     {
       SCSI_SenseCode(pdev, lun, NOT_READY, MEDIUM_NOT_PRESENT);
       return -1;
     }
 
     /* Check If media is write-protected */
-    if (((USBD_StorageTypeDef *)pdev->pUserData)->IsWriteProtected(lun) != 0)
+    if (((USBD_StorageTypeDef *)USBD_USER_DATA(pdev, &USBD_MSC))->IsWriteProtected(lun) != 0)
     {
       SCSI_SenseCode(pdev, lun, NOT_READY, WRITE_PROTECTED);
       return -1;
@@ -558,15 +608,26 @@ static int8_t SCSI_Write10(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t *para
       return -1;
     }
 
-    len = MIN(len, MSC_MEDIA_PACKET);
+    hmsc->media_len = len;
+    hmsc->media_in = 0U;
+    hmsc->media_out = 0U;
+    hmsc->media_xfer = 0U;
+    hmsc->media_failed = 0U;
 
     /* Prepare EP to receive first data packet */
     hmsc->bot_state = USBD_BOT_DATA_OUT;
-    USBD_LL_PrepareReceive(pdev, MSC_EPOUT_ADDR, hmsc->bot_data, len);
+    SCSI_ReceiveMedia(pdev);
   }
   else /* Write Process ongoing */
   {
+    /* A packet has been received, receive the next one */
+    hmsc->media_in++;
+    hmsc->media_xfer = 0U;
+    SCSI_ReceiveMedia(pdev);
+
+#if (MSC_MEDIA_DEFERRED == 0U)
     return SCSI_ProcessWrite(pdev, lun);
+#endif /* MSC_MEDIA_DEFERRED */
   }
   return 0;
 }
@@ -582,7 +643,7 @@ static int8_t SCSI_Write10(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t *para
 
 static int8_t SCSI_Verify10(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t *params)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *) pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_MSC);
 
   if ((params[1] & 0x02U) == 0x02U)
   {
@@ -610,7 +671,7 @@ static int8_t SCSI_Verify10(USBD_HandleTypeDef  *pdev, uint8_t lun, uint8_t *par
 static int8_t SCSI_CheckAddressRange(USBD_HandleTypeDef *pdev, uint8_t lun,
                                      uint32_t blk_offset, uint32_t blk_nbr)
 {
-  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *) pdev->pClassData;
+  USBD_MSC_BOT_HandleTypeDef  *hmsc = (USBD_MSC_BOT_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_MSC);
 
   if ((blk_offset + blk_nbr) > hmsc->scsi_blk_nbr)
   {
@@ -622,82 +683,171 @@ static int8_t SCSI_CheckAddressRange(USBD_HandleTypeDef *pdev, uint8_t lun,
 
 /**
 * @brief  SCSI_ProcessRead
-*         Handle Read Process
+*         Handle Read Process: read the free media packets from the storage,
+*         while the USB sends the packets already read
 * @param  lun: Logical unit number
 * @retval status
 */
 static int8_t SCSI_ProcessRead(USBD_HandleTypeDef  *pdev, uint8_t lun)
 {
-  USBD_MSC_BOT_HandleTypeDef *hmsc = (USBD_MSC_BOT_HandleTypeDef *)pdev->pClassData;
-  uint32_t len = hmsc->scsi_blk_len * hmsc->scsi_blk_size;
+  USBD_MSC_BOT_HandleTypeDef *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
+  uint32_t slot;
+  uint32_t nbr;
+  uint32_t len;
 
-  len = MIN(len, MSC_MEDIA_PACKET);
+  nbr = MSC_MEDIA_PACKET_NBR - (hmsc->media_in - hmsc->media_out);
 
-  if (((USBD_StorageTypeDef *)pdev->pUserData)->Read(lun,
-                                                     hmsc->bot_data,
-                                                     hmsc->scsi_blk_addr,
-                                                     (len / hmsc->scsi_blk_size)) < 0)
+  if ((hmsc->media_failed == 0U) && (hmsc->scsi_blk_len != 0U) && (nbr != 0U) &&
+      ((nbr >= MSC_MEDIA_BATCH) || (hmsc->media_in == hmsc->media_out)))
   {
-    SCSI_SenseCode(pdev, lun, HARDWARE_ERROR, UNRECOVERED_READ_ERROR);
-    return -1;
-  }
-
-  USBD_LL_Transmit(pdev, MSC_EPIN_ADDR, hmsc->bot_data, len);
-
-  hmsc->scsi_blk_addr += (len / hmsc->scsi_blk_size);
-  hmsc->scsi_blk_len -= (len / hmsc->scsi_blk_size);
+    /* Free packets up to the end of the buffer, in one storage access */
+    slot = hmsc->media_in % MSC_MEDIA_PACKET_NBR;
+    nbr = MIN(nbr, MSC_MEDIA_PACKET_NBR - slot);
+    len = MIN(hmsc->scsi_blk_len * hmsc->scsi_blk_size, nbr * MSC_MEDIA_PACKET);
+
+    if (((USBD_StorageTypeDef *)USBD_USER_DATA(pdev, &USBD_MSC))->Read(lun,
+                                                       &hmsc->bot_data[slot * MSC_MEDIA_PACKET],
+                                                       hmsc->scsi_blk_addr,
+                                                       (uint16_t)(len / hmsc->scsi_blk_size)) < 0)
+    {
+      SCSI_SenseCode(pdev, lun, HARDWARE_ERROR, UNRECOVERED_READ_ERROR);
+      hmsc->media_failed = 1U;
+    }
+    else
+    {
+      hmsc->scsi_blk_addr += (len / hmsc->scsi_blk_size);
+      hmsc->scsi_blk_len -= (len / hmsc->scsi_blk_size);
+      hmsc->media_in += (len + MSC_MEDIA_PACKET - 1U) / MSC_MEDIA_PACKET;
 
-  /* case 6 : Hi = Di */
-  hmsc->csw.dDataResidue -= len;
+      SCSI_SendMedia(pdev);
+    }
+  }
 
-  if (hmsc->scsi_blk_len == 0U)
+  /* The CSW is sent once the packet in progress is sent */
+  if ((hmsc->media_failed != 0U) && (hmsc->media_xfer == 0U))
   {
-    hmsc->bot_state = USBD_BOT_LAST_DATA_IN;
+    return -1;
   }
   return 0;
 }
 
 /**
 * @brief  SCSI_ProcessWrite
-*         Handle Write Process
+*         Handle Write Process: write the received media packets to the
+*         storage, while the USB receives the next packet
 * @param  lun: Logical unit number
 * @retval status
 */
 
 static int8_t SCSI_ProcessWrite(USBD_HandleTypeDef  *pdev, uint8_t lun)
 {
-  USBD_MSC_BOT_HandleTypeDef *hmsc = (USBD_MSC_BOT_HandleTypeDef *) pdev->pClassData;
-  uint32_t len = hmsc->scsi_blk_len * hmsc->scsi_blk_size;
+  USBD_MSC_BOT_HandleTypeDef *hmsc = (USBD_MSC_BOT_HandleTypeDef *) USBD_CLASS_DATA(pdev, &USBD_MSC);
+  uint32_t slot;
+  uint32_t nbr;
+  uint32_t len;
 
-  len = MIN(len, MSC_MEDIA_PACKET);
+  nbr = hmsc->media_in - hmsc->media_out;
 
-  if (((USBD_StorageTypeDef *)pdev->pUserData)->Write(lun, hmsc->bot_data,
-                                                      hmsc->scsi_blk_addr,
-                                                      (len / hmsc->scsi_blk_size)) < 0)
+  if ((hmsc->media_failed == 0U) && (nbr != 0U) &&
+      ((nbr >= MSC_MEDIA_BATCH) || ((hmsc->media_len == 0U) && (hmsc->media_xfer == 0U))))
   {
-    SCSI_SenseCode(pdev, lun, HARDWARE_ERROR, WRITE_FAULT);
+    /* Received packets up to the end of the buffer, in one storage access */
+    slot = hmsc->media_out % MSC_MEDIA_PACKET_NBR;
+    nbr = MIN(nbr, MSC_MEDIA_PACKET_NBR - slot);
+    len = MIN(hmsc->scsi_blk_len * hmsc->scsi_blk_size, nbr * MSC_MEDIA_PACKET);
+
+    if (((USBD_StorageTypeDef *)USBD_USER_DATA(pdev, &USBD_MSC))->Write(lun,
+                                                        &hmsc->bot_data[slot * MSC_MEDIA_PACKET],
+                                                        hmsc->scsi_blk_addr,
+                                                        (uint16_t)(len / hmsc->scsi_blk_size)) < 0)
+    {
+      SCSI_SenseCode(pdev, lun, HARDWARE_ERROR, WRITE_FAULT);
+      hmsc->media_failed = 1U;
+    }
+    else
+    {
+      hmsc->scsi_blk_addr += (len / hmsc->scsi_blk_size);
+      hmsc->scsi_blk_len -= (len / hmsc->scsi_blk_size);
+      hmsc->media_out += nbr;
+
+      /* case 12 : Ho = Do */
+      hmsc->csw.dDataResidue -= len;
+
+      if (hmsc->scsi_blk_len == 0U)
+      {
+        if (hmsc->bot_state == USBD_BOT_DATA_OUT)
+        {
+          MSC_BOT_SendCSW(pdev, USBD_CSW_CMD_PASSED);
+        }
+        return 0;
+      }
+
+      SCSI_ReceiveMedia(pdev);
+    }
+  }
 
+  /* The CSW is sent once the packet in progress is received */
+  if ((hmsc->media_failed != 0U) && (hmsc->media_xfer == 0U))
+  {
     return -1;
   }
+  return 0;
+}
 
-  hmsc->scsi_blk_addr += (len / hmsc->scsi_blk_size);
-  hmsc->scsi_blk_len -= (len / hmsc->scsi_blk_size);
-
-  /* case 12 : Ho = Do */
-  hmsc->csw.dDataResidue -= len;
+/**
+* @brief  SCSI_SendMedia
+*         Send the next media packet read from the storage, if the USB is
+*         not sending one
+* @param  pdev: device instance
+* @retval None
+*/
+static void SCSI_SendMedia(USBD_HandleTypeDef  *pdev)
+{
+  USBD_MSC_BOT_HandleTypeDef *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
+  uint32_t len;
 
-  if (hmsc->scsi_blk_len == 0U)
+  if ((hmsc->media_xfer == 0U) && (hmsc->media_failed == 0U) &&
+      (hmsc->media_in != hmsc->media_out) && (hmsc->bot_state == USBD_BOT_DATA_IN))
   {
-    MSC_BOT_SendCSW(pdev, USBD_CSW_CMD_PASSED);
+    len = MIN(hmsc->media_len, MSC_MEDIA_PACKET);
+    hmsc->media_len -= len;
+
+    /* case 6 : Hi = Di */
+    hmsc->csw.dDataResidue -= len;
+
+    if (hmsc->media_len == 0U)
+    {
+      hmsc->bot_state = USBD_BOT_LAST_DATA_IN;
+    }
+
+    hmsc->media_xfer = 1U;
+    USBD_LL_Transmit(pdev, hmsc->epin_addr,
+                     &hmsc->bot_data[(hmsc->media_out % MSC_MEDIA_PACKET_NBR) * MSC_MEDIA_PACKET], len);
   }
-  else
+}
+
+/**
+* @brief  SCSI_ReceiveMedia
+*         Prepare the reception of the next media packet in a free buffer,
+*         if the USB is not receiving one
+* @param  pdev: device instance
+* @retval None
+*/
+static void SCSI_ReceiveMedia(USBD_HandleTypeDef  *pdev)
+{
+  USBD_MSC_BOT_HandleTypeDef *hmsc = (USBD_MSC_BOT_HandleTypeDef *)USBD_CLASS_DATA(pdev, &USBD_MSC);
+  uint32_t len;
+
+  if ((hmsc->media_xfer == 0U) && (hmsc->media_failed == 0U) && (hmsc->media_len != 0U) &&
+      ((hmsc->media_in - hmsc->media_out) < MSC_MEDIA_PACKET_NBR) && (hmsc->bot_state == USBD_BOT_DATA_OUT))
   {
-    len = MIN((hmsc->scsi_blk_len * hmsc->scsi_blk_size), MSC_MEDIA_PACKET);
-    /* Prepare EP to Receive next packet */
-    USBD_LL_PrepareReceive(pdev, MSC_EPOUT_ADDR, hmsc->bot_data, len);
-  }
+    len = MIN(hmsc->media_len, MSC_MEDIA_PACKET);
+    hmsc->media_len -= len;
 
-  return 0;
+    hmsc->media_xfer = 1U;
+    USBD_LL_PrepareReceive(pdev, hmsc->epout_addr,
+                           &hmsc->bot_data[(hmsc->media_in % MSC_MEDIA_PACKET_NBR) * MSC_MEDIA_PACKET], len);
+  }
 }
 /**
   * @}
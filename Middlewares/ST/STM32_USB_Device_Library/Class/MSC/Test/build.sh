@@ -0,0 +1,39 @@
+#!/bin/sh
+# Builds the MSC BOT model (msc_bot_model.c) against the MSC class on the host
+# and runs it with rings of 1, 2 and 4 packets filled from the interrupt, and
+# of 2, 4 and 8 packets filled by USBD_MSC_Process() (MSC_MEDIA_DEFERRED).
+# build.sh [output directory]; MSC=<class directory> builds another copy of
+# the class, e.g. MSC=<older Class/MSC> CFLAGS=-DSIM_BASE for the figures
+# before the packet ring.
+HERE=$(cd "$(dirname "$0")" && pwd)
+LIB=$HERE/../../..
+MSC=${MSC:-$HERE/..}
+OUT=${1:-${TMPDIR:-/tmp}/msc_bot_test}
+CC=${CC:-cc}
+mkdir -p "$OUT" || exit 1
+
+# build <output> [defines]
+build()
+{
+  N=$1; shift
+  $CC -O2 -Wall -Wno-unused-parameter -Wno-unused-function $CFLAGS "$@" \
+    -I"$HERE" -I"$LIB/Core/Inc" -I"$MSC/Inc" -o "$OUT/$N" \
+    "$HERE/msc_bot_model.c" "$MSC/Src/usbd_msc.c" "$MSC/Src/usbd_msc_bot.c" \
+    "$MSC/Src/usbd_msc_scsi.c" "$MSC/Src/usbd_msc_data.c" || exit 1
+}
+
+if echo "$CFLAGS" | grep -q SIM_BASE; then
+  build msc_bot_model
+  "$OUT/msc_bot_model"
+  exit $?
+fi
+build msc_bot_model_n1 -DMSC_MEDIA_PACKET_NBR=1U
+build msc_bot_model_n2 -DMSC_MEDIA_PACKET_NBR=2U
+build msc_bot_model_n4 -DMSC_MEDIA_PACKET_NBR=4U
+build msc_bot_model_d2 -DMSC_MEDIA_DEFERRED=1U -DMSC_MEDIA_PACKET_NBR=2U
+build msc_bot_model_d4 -DMSC_MEDIA_DEFERRED=1U -DMSC_MEDIA_PACKET_NBR=4U
+build msc_bot_model_d8 -DMSC_MEDIA_DEFERRED=1U -DMSC_MEDIA_PACKET_NBR=8U
+for V in n1 n2 n4 d2 d4 d8; do
+  echo "== $V"
+  "$OUT/msc_bot_model_$V" || exit 1
+done
@@ -0,0 +1,470 @@
+/* Host BOT driver, USB FS bulk endpoint model and simulated storage for
+   the MSC class. Discrete time: the USB interrupt preempts the thread
+   mode, the endpoint only loads its next packet from the interrupt.
+   Runs random READ10/WRITE10 commands with data check, read and write
+   errors with REQUEST SENSE, then measures the throughput of 64 block
+   transfers for two storage timings. TR=1 traces the benchmark only.
+   -DSIM_BASE builds it against the class before the packet ring, whose
+   read errors are not reported. */
+#include "usbd_msc.h"
+
+#ifndef MSC_MEDIA_DEFERRED
+#define MSC_MEDIA_DEFERRED 0U
+#endif
+
+#define PKT   64U
+#define BLK   512U
+#define NBLK  4096U
+
+static uint64_t now;
+static int in_isr;
+static unsigned long checks, failures;
+#define CHECK(c) do { checks++; if (!(c)) { failures++; if (failures < 30) printf("FAIL %d %s (t=%llu)\n", __LINE__, #c, (unsigned long long)now); } } while (0)
+
+/* timings, ns */
+static uint64_t t_isr = 4000U, t_loop = 1000U, t_host = 20000U, st_call, st_blk;
+static uint64_t pkt_ns(uint32_t n) { return 10000U + n * 667U; }
+
+static uint8_t disk[NBLK * BLK], ref[NBLK * BLK];
+static uint32_t fail_lba = 0xFFFFFFFFU;
+static unsigned long st_calls, st_blocks, st_maxblk;
+
+static USBD_HandleTypeDef dev;
+
+/* ---------------- endpoints ---------------- */
+typedef struct
+{
+  uint8_t *buf;
+  uint32_t len, off, pkt;
+  int busy, valid, ctr, stall;
+  uint8_t pma[PKT];
+} ep_t;
+static ep_t ein, eout;
+
+USBD_StatusTypeDef USBD_LL_Transmit(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t *pbuf, uint16_t size)
+{
+  CHECK(ep_addr == MSC_EPIN_ADDR);
+  CHECK(!ein.busy);
+  ein.buf = pbuf; ein.len = size; ein.off = 0; ein.busy = 1;
+  ein.pkt = size < PKT ? size : PKT;
+  memcpy(ein.pma, pbuf, ein.pkt);
+  ein.valid = 1;
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_PrepareReceive(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t *pbuf, uint16_t size)
+{
+  CHECK(ep_addr == MSC_EPOUT_ADDR);
+  CHECK(!eout.busy);
+  eout.buf = pbuf; eout.len = size; eout.off = 0; eout.busy = 1;
+  eout.valid = 1;
+  return USBD_OK;
+}
+
+uint32_t USBD_LL_GetRxDataSize(USBD_HandleTypeDef *pdev, uint8_t ep_addr) { return eout.off; }
+USBD_StatusTypeDef USBD_LL_OpenEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t ep_type, uint16_t ep_mps) { return USBD_OK; }
+USBD_StatusTypeDef USBD_LL_CloseEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr) { return USBD_OK; }
+USBD_StatusTypeDef USBD_LL_FlushEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr) { return USBD_OK; }
+USBD_StatusTypeDef USBD_LL_StallEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  if (ep_addr & 0x80U) ein.stall = 1; else eout.stall = 1;
+  return USBD_OK;
+}
+USBD_StatusTypeDef USBD_LL_ClearStallEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr) { return USBD_OK; }
+uint8_t USBD_LL_IsStallEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr) { return 0; }
+USBD_StatusTypeDef USBD_CtlSendData(USBD_HandleTypeDef *pdev, uint8_t *pbuf, uint16_t len) { return USBD_OK; }
+void USBD_CtlError(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req) { }
+
+/* ---------------- host ---------------- */
+enum { H_IDLE, H_CBW, H_DATA_OUT, H_DATA_IN, H_CSW, H_DONE };
+typedef struct
+{
+  uint8_t cb[16];
+  uint8_t cblen;
+  int in;
+  uint32_t len;
+  uint8_t *data;
+} cmd_t;
+
+static struct
+{
+  int phase;
+  cmd_t cmd;
+  uint8_t cbw[31];
+  uint32_t done, tag;
+  uint8_t csw[13];
+  int csw_ok, early, stalled;
+  uint64_t next;
+} host;
+
+static struct { int busy, out; uint32_t n; uint64_t end; } wire;
+static uint64_t wire_busy_ns;
+
+static void put32(uint8_t *p, uint32_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24); }
+static uint32_t get32(const uint8_t *p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+static void host_start(const cmd_t *c)
+{
+  host.cmd = *c;
+  host.tag++;
+  memset(host.cbw, 0, sizeof(host.cbw));
+  put32(host.cbw, USBD_BOT_CBW_SIGNATURE);
+  put32(host.cbw + 4, host.tag);
+  put32(host.cbw + 8, c->len);
+  host.cbw[12] = c->in ? 0x80U : 0U;
+  host.cbw[14] = c->cblen;
+  memcpy(host.cbw + 15, c->cb, c->cblen);
+  host.done = 0;
+  host.csw_ok = host.early = host.stalled = 0;
+  host.phase = H_CBW;
+}
+
+static void host_csw(const uint8_t *p, uint32_t n)
+{
+  CHECK(n == 13U);
+  memcpy(host.csw, p, 13);
+  host.csw_ok = (get32(p) == USBD_BOT_CSW_SIGNATURE) && (get32(p + 4) == host.tag);
+  CHECK(host.csw_ok);
+  host.phase = H_DONE;
+}
+
+static void wire_complete(void)
+{
+  wire.busy = 0;
+  if (wire.out)
+  {
+    /* packet now in the PMA, the endpoint NAKs until the interrupt */
+    if (host.phase == H_CBW)
+    {
+      memcpy(eout.pma, host.cbw, 31);
+      host.phase = host.cmd.len == 0U ? H_CSW : (host.cmd.in ? H_DATA_IN : H_DATA_OUT);
+    }
+    else
+    {
+      memcpy(eout.pma, host.cmd.data + host.done, wire.n);
+      host.done += wire.n;
+      if (host.done == host.cmd.len) host.phase = H_CSW;
+    }
+    eout.pkt = wire.n;
+    eout.valid = 0;
+    eout.ctr = 1;
+  }
+  else
+  {
+    if ((host.phase == H_DATA_IN || host.phase == H_DATA_OUT) && ein.pkt == 13U && get32(ein.pma) == USBD_BOT_CSW_SIGNATURE)
+    {
+      host.early = 1;
+      host_csw(ein.pma, ein.pkt);
+    }
+    else if (host.phase == H_DATA_IN)
+    {
+      CHECK(host.done + ein.pkt <= host.cmd.len);
+      memcpy(host.cmd.data + host.done, ein.pma, ein.pkt);
+      host.done += ein.pkt;
+      if (host.done == host.cmd.len) host.phase = H_CSW;
+    }
+    else
+    {
+      CHECK(host.phase == H_CSW);
+      host_csw(ein.pma, ein.pkt);
+    }
+    ein.valid = 0;
+    ein.ctr = 1;
+  }
+}
+
+/* process the bus up to now */
+static void service(void)
+{
+  for (;;)
+  {
+    if (wire.busy)
+    {
+      if (now < wire.end) return;
+      wire_complete();
+    }
+    if ((ein.stall || eout.stall) && (host.phase != H_DONE) && (host.phase != H_IDLE))
+    {
+      host.stalled = 1;
+      host.phase = H_DONE;
+    }
+    /* the host reads the IN endpoint first: a CSW can end the data stage */
+    if ((host.phase == H_DATA_IN || host.phase == H_CSW || host.phase == H_DATA_OUT) && ein.valid)
+    {
+      wire.busy = 1; wire.out = 0; wire.n = ein.pkt;
+    }
+    else if ((host.phase == H_CBW || host.phase == H_DATA_OUT) && eout.valid)
+    {
+      wire.busy = 1; wire.out = 1;
+      wire.n = host.phase == H_CBW ? 31U : ((host.cmd.len - host.done) < PKT ? (host.cmd.len - host.done) : PKT);
+    }
+    else
+    {
+      return;
+    }
+    wire.end = now + pkt_ns(wire.n);
+    wire_busy_ns += pkt_ns(wire.n);
+  }
+}
+
+static void isr(void);
+
+/* CPU busy for dt, preempted by the USB interrupt in thread mode */
+static void cpu(uint64_t dt)
+{
+  for (;;)
+  {
+    uint64_t step;
+    service();
+    if (!in_isr && (ein.ctr || eout.ctr))
+    {
+      isr();
+      continue;
+    }
+    if (dt == 0U) break;
+    step = dt;
+    if (wire.busy && (wire.end - now) < step) step = wire.end - now;
+    now += step;
+    dt -= step;
+  }
+}
+
+static void isr(void)
+{
+  in_isr = 1;
+  cpu(t_isr);
+  if (ein.ctr)
+  {
+    ein.ctr = 0;
+    ein.off += ein.pkt;
+    if (ein.pkt == PKT && ein.off < ein.len)
+    {
+      ein.pkt = (ein.len - ein.off) < PKT ? (ein.len - ein.off) : PKT;
+      memcpy(ein.pma, ein.buf + ein.off, ein.pkt);
+      ein.valid = 1;
+    }
+    else
+    {
+      ein.busy = 0;
+      if (getenv("TR")) printf("%8.1f sent %u\n", now / 1000.0, ein.len);
+      USBD_MSC.DataIn(&dev, MSC_EPIN_ADDR & 0x7FU);
+    }
+  }
+  else if (eout.ctr)
+  {
+    eout.ctr = 0;
+    CHECK(eout.off + eout.pkt <= eout.len);
+    memcpy(eout.buf + eout.off, eout.pma, eout.pkt);
+    eout.off += eout.pkt;
+    if (eout.pkt < PKT || eout.off >= eout.len)
+    {
+      eout.busy = 0;
+      USBD_MSC.DataOut(&dev, MSC_EPOUT_ADDR);
+    }
+    else
+    {
+      eout.valid = 1;
+    }
+  }
+  in_isr = 0;
+}
+
+/* ---------------- storage ---------------- */
+static int8_t st_init(uint8_t lun) { return 0; }
+static int8_t st_cap(uint8_t lun, uint32_t *n, uint16_t *s) { *n = NBLK; *s = BLK; return 0; }
+static int8_t st_ready(uint8_t lun) { return 0; }
+static int8_t st_wp(uint8_t lun) { return 0; }
+static int8_t st_maxlun(void) { return 0; }
+
+static int8_t st_read(uint8_t lun, uint8_t *buf, uint32_t blk, uint16_t n)
+{
+  CHECK(n >= 1U && blk + n <= NBLK);
+  st_calls++; st_blocks += n; if (n > st_maxblk) st_maxblk = n;
+  memset(buf, 0xEE, (size_t)n * BLK); /* filled while the storage reads */
+  if (getenv("TR")) printf("%8.1f read %u blocks at %u, isr %d\n", now / 1000.0, n, blk, in_isr);
+  cpu(st_call + (uint64_t)n * st_blk);
+  if (fail_lba >= blk && fail_lba < blk + n) return -1;
+  memcpy(buf, disk + (size_t)blk * BLK, (size_t)n * BLK);
+  return 0;
+}
+
+static uint8_t snap[64 * BLK];
+static int8_t st_write(uint8_t lun, uint8_t *buf, uint32_t blk, uint16_t n)
+{
+  CHECK(n >= 1U && blk + n <= NBLK && n <= 64U);
+  st_calls++; st_blocks += n; if (n > st_maxblk) st_maxblk = n;
+  memcpy(snap, buf, (size_t)n * BLK);
+  cpu(st_call + (uint64_t)n * st_blk);
+  CHECK(memcmp(snap, buf, (size_t)n * BLK) == 0); /* not overwritten while written */
+  if (fail_lba >= blk && fail_lba < blk + n) return -1;
+  memcpy(disk + (size_t)blk * BLK, buf, (size_t)n * BLK);
+  return 0;
+}
+
+static int8_t inquiry[36] = { 0, (int8_t)0x80, 2, 2, 31, 0, 0, 0, 'S', 'I', 'M', ' ', ' ', ' ', ' ', ' ',
+                              'D', 'i', 's', 'k', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
+                              '0', '.', '0', '1' };
+static USBD_StorageTypeDef fops = { st_init, st_cap, st_ready, st_wp, st_read, st_write, st_maxlun, inquiry };
+
+/* ---------------- commands ---------------- */
+static void run_cmd(const cmd_t *c)
+{
+  /* host turnaround */
+  uint64_t t = now + t_host;
+  while (now < t)
+  {
+#if (MSC_MEDIA_DEFERRED == 1U)
+    USBD_MSC_Process(&dev);
+#endif
+    cpu(t_loop);
+  }
+  host_start(c);
+  while (host.phase != H_DONE)
+  {
+#if (MSC_MEDIA_DEFERRED == 1U)
+    USBD_MSC_Process(&dev);
+#endif
+    cpu(t_loop);
+    if (now > 100000000000ULL) { CHECK(0 && "hang"); printf("hang: phase %d done %u ein %d/%d/%d eout %d/%d/%d stall %d/%d\n", host.phase, host.done, ein.busy, ein.valid, ein.ctr, eout.busy, eout.valid, eout.ctr, ein.stall, eout.stall); break; }
+  }
+  /* let the device settle (CBW receive prepared) */
+  while (!eout.valid && !host.stalled && now < 100000000000ULL)
+  {
+#if (MSC_MEDIA_DEFERRED == 1U)
+    USBD_MSC_Process(&dev);
+#endif
+    cpu(t_loop);
+  }
+}
+
+static uint8_t iobuf[256 * BLK];
+
+static void rw10(int in, uint32_t lba, uint16_t n, uint8_t *data)
+{
+  cmd_t c;
+  memset(&c, 0, sizeof(c));
+  c.cb[0] = in ? SCSI_READ10 : SCSI_WRITE10;
+  c.cb[2] = (uint8_t)(lba >> 24); c.cb[3] = (uint8_t)(lba >> 16); c.cb[4] = (uint8_t)(lba >> 8); c.cb[5] = (uint8_t)lba;
+  c.cb[7] = (uint8_t)(n >> 8); c.cb[8] = (uint8_t)n;
+  c.cblen = 10;
+  c.in = in;
+  c.len = (uint32_t)n * BLK;
+  c.data = data;
+  run_cmd(&c);
+}
+
+static void simple(uint8_t op, uint32_t len, uint8_t alloc)
+{
+  cmd_t c;
+  memset(&c, 0, sizeof(c));
+  c.cb[0] = op; c.cb[4] = alloc; c.cblen = op == SCSI_READ_CAPACITY10 ? 10 : 6;
+  c.in = 1; c.len = len; c.data = iobuf;
+  run_cmd(&c);
+}
+
+static uint32_t seed = 12345;
+static uint32_t rnd(uint32_t n) { seed = seed * 1103515245U + 12345U; return (seed >> 8) % n; }
+
+static void setup(void)
+{
+  uint32_t i;
+  memset(&dev, 0, sizeof(dev));
+  memset(&ein, 0, sizeof(ein)); memset(&eout, 0, sizeof(eout));
+  memset(&host, 0, sizeof(host)); memset(&wire, 0, sizeof(wire));
+  now = 0;
+  for (i = 0; i < sizeof(disk); i++) disk[i] = (uint8_t)rnd(256);
+  memcpy(ref, disk, sizeof(disk));
+  dev.dev_speed = USBD_SPEED_FULL;
+  dev.pUserData = &fops;
+  USBD_MSC.Init(&dev, 0);
+  simple(SCSI_INQUIRY, 36, 36);
+  CHECK(host.csw[12] == 0 && memcmp(iobuf + 8, "SIM", 3) == 0);
+  simple(SCSI_READ_CAPACITY10, 8, 0);
+  CHECK(host.csw[12] == 0 && iobuf[2] == ((NBLK - 1U) >> 8) && iobuf[6] == 2);
+}
+
+static void verify_read(uint32_t lba, uint16_t n)
+{
+  rw10(1, lba, n, iobuf);
+  CHECK(!host.stalled && !host.early && host.csw[12] == 0 && get32(host.csw + 8) == 0);
+  CHECK(memcmp(iobuf, ref + (size_t)lba * BLK, (size_t)n * BLK) == 0);
+}
+
+static void do_write(uint32_t lba, uint16_t n)
+{
+  uint32_t i;
+  for (i = 0; i < (uint32_t)n * BLK; i++) iobuf[i] = (uint8_t)rnd(256);
+  rw10(0, lba, n, iobuf);
+  CHECK(!host.stalled && !host.early && host.csw[12] == 0 && get32(host.csw + 8) == 0);
+  memcpy(ref + (size_t)lba * BLK, iobuf, (size_t)n * BLK);
+  CHECK(memcmp(disk, ref, sizeof(disk)) == 0);
+}
+
+static void tests(void)
+{
+  int i;
+  st_call = 50000U; st_blk = 200000U;
+  setup();
+  for (i = 0; i < 300; i++)
+  {
+    uint16_t n = (uint16_t)(1U + rnd(rnd(4) == 0 ? 128U : 9U));
+    uint32_t lba = rnd(NBLK - n);
+    if (rnd(2)) verify_read(lba, n); else do_write(lba, n);
+    if ((i % 37) == 0) { simple(SCSI_TEST_UNIT_READY, 0, 0); CHECK(host.csw[12] == 0); }
+    /* vary the storage speed around the USB speed */
+    st_blk = 20000U + rnd(600000U);
+  }
+
+#ifndef SIM_BASE /* read errors are dropped by SCSI_ProcessCmd */
+  /* read error in the middle of a transfer */
+  fail_lba = 1010;
+  rw10(1, 1000, 32, iobuf);
+  CHECK(!host.stalled && host.csw[12] == USBD_CSW_CMD_FAILED && get32(host.csw + 8) != 0);
+  CHECK(host.done < 32U * BLK && get32(host.csw + 8) == 32U * BLK - host.done);
+  CHECK(memcmp(iobuf, ref + 1000U * BLK, host.done) == 0);
+  simple(SCSI_REQUEST_SENSE, 18, 18);
+  CHECK(host.csw[12] == 0 && (iobuf[2] & 0x0FU) == HARDWARE_ERROR /* ASC lost by SCSI_SenseCode */);
+  verify_read(2000, 40);
+
+  /* write error */
+  rw10(0, 1000, 32, iobuf);
+  CHECK(!host.stalled && host.csw[12] == USBD_CSW_CMD_FAILED);
+  simple(SCSI_REQUEST_SENSE, 18, 18);
+  CHECK(host.csw[12] == 0 && (iobuf[2] & 0x0FU) == HARDWARE_ERROR);
+  fail_lba = 0xFFFFFFFFU;
+  memcpy(ref + 1000U * BLK, disk + 1000U * BLK, 32U * BLK); /* partly written */
+#endif
+  do_write(3000, 16);
+  verify_read(0, 128);
+  printf("tests: %lu storage calls, %lu blocks, max %lu blocks per call\n", st_calls, st_blocks, st_maxblk);
+}
+
+static void bench(const char *name, uint64_t call, uint64_t blk)
+{
+  uint64_t t0;
+  int i;
+  double rd, wr;
+  st_call = call; st_blk = blk;
+  setup();
+  st_calls = st_blocks = 0;
+  t0 = now;
+  for (i = 0; i < 32; i++) rw10(1, (uint32_t)i * 64U, 64, iobuf);
+  rd = 32.0 * 64 * BLK / ((now - t0) / 1e9) / 1024;
+  CHECK(memcmp(iobuf, ref + 31U * 64U * BLK, 64U * BLK) == 0);
+  double rdcalls = (double)st_blocks / st_calls;
+  st_calls = st_blocks = 0;
+  t0 = now;
+  for (i = 0; i < 32; i++) rw10(0, (uint32_t)i * 64U, 64, iobuf);
+  wr = 32.0 * 64 * BLK / ((now - t0) / 1e9) / 1024;
+  printf("  %-34s read %6.1f KB/s (%.2f blk/call), write %6.1f KB/s (%.2f blk/call)\n", name, rd, rdcalls, wr,
+         (double)st_blocks / st_calls);
+}
+
+int main(void)
+{
+  if (!getenv("TR")) tests();
+  bench("SD on SPI (300 us + 330 us/block)", 300000U, 330000U);
+  bench("fast media (20 us + 40 us/block)", 20000U, 40000U);
+  printf("%lu checks, %lu failures\n", checks, failures);
+  return failures != 0;
+}
@@ -0,0 +1,22 @@
+/* Host stub of usbd_conf.h for the MSC BOT model */
+#ifndef __USBD_CONF_H
+#define __USBD_CONF_H
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#define __IO volatile
+#define USBD_MAX_NUM_INTERFACES               1
+#define USBD_MAX_NUM_CONFIGURATION            1
+#define USBD_MAX_STR_DESC_SIZ                 0x100
+#define USBD_SELF_POWERED                     1
+#define USBD_DEBUG_LEVEL                      0
+#define MSC_MEDIA_PACKET                      512
+#define USBD_malloc               malloc
+#define USBD_free                 free
+#define USBD_memset               memset
+#define USBD_memcpy               memcpy
+#define USBD_UsrLog(...)
+#define USBD_ErrLog(...)
+#define USBD_DbgLog(...)
+#endif
@@ -66,7 +66,18 @@ extern "C" {
 /** @defgroup USBD_CORE_Exported_Macros
   * @{
   */
-
+/* Data of a class, and endpoint address given to a class endpoint. Each
+   class of a composite device has its own data, and the endpoints of the
+   class descriptor are renumbered in the device */
+#if (USBD_MAX_SUPPORTED_CLASS > 1U)
+#define USBD_CLASS_DATA(pdev, pclass)         (*USBD_CoreClassData((pdev), (pclass)))
+#define USBD_USER_DATA(pdev, pclass)          (*USBD_CoreUserData((pdev), (pclass)))
+#define USBD_CLASS_EP(pdev, pclass, ep_addr)  USBD_CoreGetEPAdd((pdev), (pclass), (ep_addr))
+#else
+#define USBD_CLASS_DATA(pdev, pclass)         ((pdev)->pClassData)
+#define USBD_USER_DATA(pdev, pclass)          ((pdev)->pUserData)
+#define USBD_CLASS_EP(pdev, pclass, ep_addr)  (ep_addr)
+#endif /* USBD_MAX_SUPPORTED_CLASS */
 /**
   * @}
   */
@@ -87,6 +98,11 @@ USBD_StatusTypeDef USBD_DeInit(USBD_HandleTypeDef *pdev);
 USBD_StatusTypeDef USBD_Start(USBD_HandleTypeDef *pdev);
 USBD_StatusTypeDef USBD_Stop(USBD_HandleTypeDef *pdev);
 USBD_StatusTypeDef USBD_RegisterClass(USBD_HandleTypeDef *pdev, USBD_ClassTypeDef *pclass);
+#if (USBD_MAX_SUPPORTED_CLASS > 1U)
+void **USBD_CoreClassData(USBD_HandleTypeDef *pdev, USBD_ClassTypeDef *pclass);
+void **USBD_CoreUserData(USBD_HandleTypeDef *pdev, USBD_ClassTypeDef *pclass);
+uint8_t USBD_CoreGetEPAdd(USBD_HandleTypeDef *pdev, USBD_ClassTypeDef *pclass, uint8_t ep_addr);
+#endif /* USBD_MAX_SUPPORTED_CLASS */
 
 USBD_StatusTypeDef USBD_RunTestMode(USBD_HandleTypeDef  *pdev);
 USBD_StatusTypeDef USBD_SetClassConfig(USBD_HandleTypeDef  *pdev, uint8_t cfgidx);
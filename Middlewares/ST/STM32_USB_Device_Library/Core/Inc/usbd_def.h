@@ -65,6 +65,16 @@ extern "C" {
 #define USBD_SUPPORT_USER_STRING_DESC                   0U
 #endif /* USBD_SUPPORT_USER_STRING_DESC */
 
+/* Set to more than 1 to build a composite device of several classes, see
+   usbd_composite.c */
+#ifndef USBD_MAX_SUPPORTED_CLASS
+#define USBD_MAX_SUPPORTED_CLASS                        1U
+#endif /* USBD_MAX_SUPPORTED_CLASS */
+
+#ifndef USBD_MAX_CLASS_ENDPOINTS
+#define USBD_MAX_CLASS_ENDPOINTS                        3U
+#endif /* USBD_MAX_CLASS_ENDPOINTS */
+
 #define  USB_LEN_DEV_QUALIFIER_DESC                     0x0AU
 #define  USB_LEN_DEV_DESC                               0x12U
 #define  USB_LEN_CFG_DESC                               0x09U
@@ -192,6 +202,21 @@ typedef struct _Device_cb
 
 } USBD_ClassTypeDef;
 
+#if (USBD_MAX_SUPPORTED_CLASS > 1U)
+/* Class of a composite device */
+typedef struct
+{
+  USBD_ClassTypeDef       *pClass;
+  void                    *pClassData;
+  void                    *pUserData;
+  uint8_t                 ItfBase;                          /* First interface number */
+  uint8_t                 ItfNum;                           /* Number of interfaces */
+  uint8_t                 NumEps;
+  uint8_t                 EpDef[USBD_MAX_CLASS_ENDPOINTS];  /* Endpoint addresses of the class descriptor */
+  uint8_t                 EpAdd[USBD_MAX_CLASS_ENDPOINTS];  /* Endpoint addresses of the device */
+} USBD_CompositeElementTypeDef;
+#endif /* USBD_MAX_SUPPORTED_CLASS */
+
 /* Following USB Device Speed */
 typedef enum
 {
@@ -258,6 +283,10 @@ typedef struct _USBD_HandleTypeDef
   void                    *pClassData;
   void                    *pUserData;
   void                    *pData;
+#if (USBD_MAX_SUPPORTED_CLASS > 1U)
+  USBD_CompositeElementTypeDef tclasslist[USBD_MAX_SUPPORTED_CLASS];
+  uint32_t                NumClasses;
+#endif /* USBD_MAX_SUPPORTED_CLASS */
 } USBD_HandleTypeDef;
 
 /**
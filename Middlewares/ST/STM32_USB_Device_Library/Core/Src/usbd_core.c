@@ -60,6 +60,10 @@
 /** @defgroup USBD_CORE_Private_FunctionPrototypes
 * @{
 */
+#if (USBD_MAX_SUPPORTED_CLASS > 1U)
+static USBD_CompositeElementTypeDef *USBD_CoreFindClass(USBD_HandleTypeDef *pdev,
+                                                        USBD_ClassTypeDef *pclass);
+#endif /* USBD_MAX_SUPPORTED_CLASS */
 
 /**
 * @}
@@ -104,6 +108,11 @@ USBD_StatusTypeDef USBD_Init(USBD_HandleTypeDef *pdev,
     pdev->pClass = NULL;
   }
 
+#if (USBD_MAX_SUPPORTED_CLASS > 1U)
+  /* Unlink the classes of a previous composite device */
+  pdev->NumClasses = 0U;
+#endif /* USBD_MAX_SUPPORTED_CLASS */
+
   /* Assign USBD Descriptors */
   if (pdesc != NULL)
   {
@@ -169,6 +178,89 @@ USBD_StatusTypeDef  USBD_RegisterClass(USBD_HandleTypeDef *pdev, USBD_ClassTypeD
   return status;
 }
 
+#if (USBD_MAX_SUPPORTED_CLASS > 1U)
+/**
+  * @brief  USBD_CoreClassData
+  *         Return the location of the data of a class: its own one in a
+  *         composite device, else the one of the device
+  * @param  pdev: Device Handle
+  * @param  pclass: Class handle
+  * @retval pointer to the class data pointer
+  */
+void **USBD_CoreClassData(USBD_HandleTypeDef *pdev, USBD_ClassTypeDef *pclass)
+{
+  USBD_CompositeElementTypeDef *pelem = USBD_CoreFindClass(pdev, pclass);
+
+  return (pelem != NULL) ? &pelem->pClassData : &pdev->pClassData;
+}
+
+/**
+  * @brief  USBD_CoreUserData
+  *         Return the location of the user data (interface callbacks) of a
+  *         class: its own one in a composite device, else the one of the device
+  * @param  pdev: Device Handle
+  * @param  pclass: Class handle
+  * @retval pointer to the user data pointer
+  */
+void **USBD_CoreUserData(USBD_HandleTypeDef *pdev, USBD_ClassTypeDef *pclass)
+{
+  USBD_CompositeElementTypeDef *pelem = USBD_CoreFindClass(pdev, pclass);
+
+  return (pelem != NULL) ? &pelem->pUserData : &pdev->pUserData;
+}
+
+/**
+  * @brief  USBD_CoreGetEPAdd
+  *         Return the address given in the device to an endpoint of a class
+  * @param  pdev: Device Handle
+  * @param  pclass: Class handle
+  * @param  ep_addr: endpoint address in the class descriptor
+  * @retval endpoint address
+  */
+uint8_t USBD_CoreGetEPAdd(USBD_HandleTypeDef *pdev, USBD_ClassTypeDef *pclass,
+                          uint8_t ep_addr)
+{
+  USBD_CompositeElementTypeDef *pelem = USBD_CoreFindClass(pdev, pclass);
+  uint8_t i;
+
+  if (pelem != NULL)
+  {
+    for (i = 0U; i < pelem->NumEps; i++)
+    {
+      if (pelem->EpDef[i] == ep_addr)
+      {
+        return pelem->EpAdd[i];
+      }
+    }
+  }
+
+  return ep_addr;
+}
+
+/**
+  * @brief  USBD_CoreFindClass
+  *         Find a class in the classes of a composite device
+  * @param  pdev: Device Handle
+  * @param  pclass: Class handle
+  * @retval composite element, NULL if the class is not one of them
+  */
+static USBD_CompositeElementTypeDef *USBD_CoreFindClass(USBD_HandleTypeDef *pdev,
+                                                        USBD_ClassTypeDef *pclass)
+{
+  uint32_t i;
+
+  for (i = 0U; i < pdev->NumClasses; i++)
+  {
+    if (pdev->tclasslist[i].pClass == pclass)
+    {
+      return &pdev->tclasslist[i];
+    }
+  }
+
+  return NULL;
+}
+#endif /* USBD_MAX_SUPPORTED_CLASS */
+
 /**
   * @brief  USBD_Start
   *         Start the USB Device Core.
@@ -0,0 +1,197 @@
+/* Tests of sd_diskio_dma_rtos_template.c on the simulated card of sd_host.c,
+which injects a latency into every transfer.
+- raw (with _USE_ASYNC = 1 only): 4000 random operations straight on the
+  disk functions: up to 8 queued disk_submit() reads and writes of 1-4
+  sectors, one in 8 on a misaligned buffer, disk_poll() with and without
+  waiting, synchronous disk_read() and disk_write() and CTRL_SYNC in between.
+  The card programs each write for 30 us, during which it takes no transfer.
+  Every read is checked against a model of the card, and so is the whole
+  card at the end.
+- files: a 1 MB file on a FAT16 volume with 2 KB clusters is written and then
+  read back in 300 byte chunks, with 100 us of computation after each chunk,
+  and checked. Each transfer takes 150 us plus 10 us a sector, and each write
+  is programmed for 20 us. The time of each pass is measured, to compare
+  _FS_ASYNC = 0 and 1.
+Both print the DMA transfers, the card and RTOS calls the driver made with
+the interrupts masked and the transfers it started while the card was busy,
+which build.sh requires to be 0, and a hash of the card.
+async_test <test> */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ff.h"
+#include "sd_diskio_dma_rtos.h"
+
+#define CHECK(x) do { if (!(x)) { printf("FAIL line %d: %s\n", __LINE__, #x); exit(1); } } while (0)
+#define NSECT 32768
+
+static char path[4];
+static FATFS fs;
+static BYTE work[_MAX_SS * 4];
+
+static double now (void) { struct timespec t; clock_gettime(CLOCK_MONOTONIC, &t); return t.tv_sec * 1e6 + t.tv_nsec / 1e3; }
+static BYTE pattern (DWORD ofs) { return (BYTE)(ofs * 31 + (ofs >> 9)); }
+
+/* Computation of the application between two file accesses. It sleeps
+rather than spins, so that the DMA thread of the card gets a host with a
+single core at once, as the DMA runs beside the CPU. */
+static void compute (unsigned us)
+{
+	struct timespec d = { 0, us * 1000L };
+
+	nanosleep(&d, NULL);
+}
+
+static unsigned long long card_hash (void)
+{
+	unsigned long long h = 14695981039346656037ULL;
+	const BYTE *p = sd_data();
+	size_t i;
+
+	for (i = 0; i < (size_t)NSECT * 512; i++) h = (h ^ p[i]) * 1099511628211ULL;
+	return h;
+}
+
+#if _USE_ASYNC == 1
+#define NREQ 8
+#define MAXCNT 4
+
+static BYTE model[(size_t)NSECT * 512];
+static DIOREQ req[NREQ];
+static uint32_t bufs[NREQ][MAXCNT * 128 + 1];
+static BYTE expect[NREQ][MAXCNT * 512];
+static unsigned rnd_state = 1;
+
+static unsigned rnd (unsigned n) { rnd_state = rnd_state * 1103515245u + 12345u; return (rnd_state >> 16) % n; }
+
+static BYTE *region (DWORD sector)
+{
+	return model + (size_t)sector * 512;
+}
+
+/* Take the completion of request i and check a read against the model */
+static void complete (int i)
+{
+	CHECK(req[i].stat == DIO_DONE && req[i].res == RES_OK);
+	if (req[i].op == DIO_READ) CHECK(memcmp(req[i].buff, expect[i], req[i].count * 512) == 0);
+	req[i].stat = DIO_IDLE;
+}
+
+static void raw_test (void)
+{
+	static BYTE buf[MAXCNT * 512 + 1];
+	unsigned op, i, k, n = 0;
+	DWORD sector;
+	UINT count;
+
+	sd_init(NSECT);
+	sd_latency_us = 50; sd_sector_us = 10; sd_program_us = 30;
+	CHECK(disk_initialize(0) == 0);
+	for (op = 0; op < 4000; op++) {
+		sector = rnd(NSECT - MAXCNT); count = 1 + rnd(MAXCNT);
+		switch (rnd(10)) {
+		case 0: case 1: case 2: case 3: case 4: case 5:	/* Queue a request */
+			i = rnd(NREQ);
+			if (req[i].stat != DIO_IDLE) {
+				CHECK(disk_poll(0, &req[i], 1) == RES_OK);
+				complete(i);
+			}
+			req[i].op = rnd(2) ? DIO_WRITE : DIO_READ;
+			req[i].buff = (BYTE*)bufs[i] + (rnd(8) == 0);
+			req[i].sector = sector; req[i].count = count;
+			if (req[i].op == DIO_WRITE) {
+				for (k = 0; k < count * 512; k++) req[i].buff[k] = (BYTE)rnd(256);
+				memcpy(region(sector), req[i].buff, count * 512);
+			} else {
+				memcpy(expect[i], region(sector), count * 512);
+				memset(req[i].buff, 0xAA, count * 512);
+			}
+			CHECK(disk_submit(0, &req[i]) == RES_OK);
+			n++;
+			break;
+		case 6:		/* Look for a completion without waiting */
+			i = rnd(NREQ);
+			if (req[i].stat != DIO_IDLE && disk_poll(0, &req[i], 0) == RES_OK) complete(i);
+			break;
+		case 7:
+			CHECK(disk_read(0, buf, sector, count) == RES_OK);
+			CHECK(memcmp(buf, region(sector), count * 512) == 0);
+			break;
+		case 8:
+			for (k = 0; k < count * 512; k++) buf[k] = (BYTE)rnd(256);
+			CHECK(disk_write(0, buf, sector, count) == RES_OK);
+			memcpy(region(sector), buf, count * 512);
+			break;
+		case 9:		/* Every queued request is done after a sync */
+			CHECK(disk_ioctl(0, CTRL_SYNC, 0) == RES_OK);
+			for (i = 0; i < NREQ; i++) if (req[i].stat != DIO_IDLE) complete(i);
+			break;
+		}
+	}
+	for (i = 0; i < NREQ; i++) {
+		if (req[i].stat != DIO_IDLE) {
+			CHECK(disk_poll(0, &req[i], 1) == RES_OK);
+			complete(i);
+		}
+	}
+	CHECK(memcmp(sd_data(), model, sizeof model) == 0);
+	printf("raw: requests %u, DMA reads %lu writes %lu, masked calls %lu, card busy errors %lu, image %016llx\n",
+		n, sd_reads, sd_writes, sd_masked_calls, sd_errors, card_hash());
+}
+#endif
+
+static void files_test (void)
+{
+	enum { SIZE = 1048576, CHUNK = 300 };
+	static BYTE buf[CHUNK];
+	DWORD ofs;
+	UINT i, n, bw, br;
+	double t, tw, tr;
+	FIL f;
+
+	sd_init(NSECT);
+	CHECK(f_mkfs(path, FM_FAT, 2048, work, sizeof work) == FR_OK);
+	CHECK(f_mount(&fs, path, 1) == FR_OK && fs.fs_type == FS_FAT16);
+	sd_latency_us = 150; sd_sector_us = 10; sd_program_us = 20;
+	sd_reads = sd_writes = 0;
+
+	t = now();
+	CHECK(f_open(&f, "data", FA_WRITE | FA_CREATE_NEW) == FR_OK);
+	for (ofs = 0; ofs < SIZE; ofs += n) {
+		n = SIZE - ofs < CHUNK ? SIZE - ofs : CHUNK;
+		for (i = 0; i < n; i++) buf[i] = pattern(ofs + i);
+		CHECK(f_write(&f, buf, n, &bw) == FR_OK && bw == n);
+		compute(100);
+	}
+	CHECK(f_close(&f) == FR_OK);
+	tw = now() - t;
+
+	CHECK(f_mount(0, path, 0) == FR_OK);
+	CHECK(f_mount(&fs, path, 1) == FR_OK);
+	t = now();
+	CHECK(f_open(&f, "data", FA_READ) == FR_OK && f_size(&f) == SIZE);
+	for (ofs = 0; ofs < SIZE; ofs += br) {
+		CHECK(f_read(&f, buf, CHUNK, &br) == FR_OK && br > 0);
+		for (i = 0; i < br; i++) CHECK(buf[i] == pattern(ofs + i));
+		compute(100);
+	}
+	CHECK(f_close(&f) == FR_OK);
+	tr = now() - t;
+
+	printf("files: write %.0f ms read %.0f ms, DMA reads %lu writes %lu, masked calls %lu, card busy errors %lu, image %016llx\n",
+		tw / 1000, tr / 1000, sd_reads, sd_writes, sd_masked_calls, sd_errors, card_hash());
+}
+
+int main (int argc, char **argv)
+{
+	const char *test = argc > 1 ? argv[1] : "files";
+
+	CHECK(FATFS_LinkDriver(&SD_Driver, path) == 0);
+	if (strcmp(test, "files") == 0) files_test();
+#if _USE_ASYNC == 1
+	else if (strcmp(test, "raw") == 0) raw_test();
+#endif
+	else { printf("unknown test %s\n", test); return 1; }
+	return 0;
+}
@@ -0,0 +1,153 @@
+#!/bin/sh
+# Builds fatfs_test (fatfs_test.c on the RAM disk of ramdisk.c) against ff.c
+# in several configurations, runs the tests and compares the results:
+# - log: with the sector cache (_FS_WINCACHE) of 1, 4 and 16 buffers, tiny or
+#   not, the disk must come out the same as without the cache, and the cache
+#   must take fewer device reads and writes. Tiny and normal configurations are
+#   not compared with each other: the bytes past the end of a file in its last
+#   sector are left over from different buffers.
+# - fill: at 50, 90, 99 and 100% fill, the FAT free space bitmap
+#   (_FS_FATBITMAP) must leave the same disk with no more reads, and a tenth of
+#   the reads at most for the appends that fail on the full volume.
+# - runs: with free cluster runs of 16 (_FS_CLSTRUN) the files appended in turn
+#   must have less than a quarter of the fragments, and the bitmap must not
+#   change the disk.
+# - dir: with 100 and 1000 files in a directory, the name index of 4
+#   directories (_FS_DIRINDEX) over the first 512 or 4096 entries of each must
+#   leave the same disk with fewer reads to look the files up. An index that
+#   covers the whole directory must take less than half the reads to look up
+#   every file, and a tenth at most for the missing names.
+# It also builds async_test (async_test.c on the simulated card of sd_host.c)
+# against ../src/drivers/sd_diskio_dma_rtos_template.c, without and with the
+# asynchronous interface (_USE_ASYNC and _FS_ASYNC):
+# - raw: the queued, polled and synchronous transfers must read back the model
+#   of the card;
+# - files: the file must come out the same, and write-behind and read-ahead
+#   must take less time.
+# In both the driver must never call the card or the RTOS with the interrupts
+# masked, nor start a transfer the card is not ready for.
+# build.sh [output directory]
+HERE=$(cd "$(dirname "$0")" && pwd)
+SRC=$HERE/../src
+OUT=${1:-${TMPDIR:-/tmp}/fatfs_test}
+CC=${CC:-cc}
+mkdir -p "$OUT" || exit 1
+
+# build <name> <options>
+build() {
+	name=$1; shift
+	$CC -O2 -Wall -I"$HERE" -I"$SRC" "$@" -o "$OUT/$name" "$HERE/fatfs_test.c" "$HERE/ramdisk.c" \
+		"$SRC/ff.c" "$SRC/diskio.c" "$SRC/ff_gen_drv.c" "$SRC/option/syscall.c" "$SRC/option/unicode.c" || exit 1
+}
+
+# build_sd <name> <options>
+build_sd() {
+	name=$1; shift
+	$CC -O2 -Wall -Wno-pointer-to-int-cast -I"$HERE" -I"$SRC" "$@" -o "$OUT/$name" "$HERE/async_test.c" "$HERE/sd_host.c" \
+		"$SRC/drivers/sd_diskio_dma_rtos_template.c" "$SRC/ff.c" "$SRC/diskio.c" "$SRC/ff_gen_drv.c" \
+		"$SRC/option/syscall.c" "$SRC/option/unicode.c" -lpthread || exit 1
+}
+
+# run <configuration> <test> [<argument>]: sets reads, writes and image from
+# the result line
+run() {
+	cfg=$1; shift
+	line=$("$OUT/$cfg" "$@") || { echo "$cfg: $line"; exit 1; }
+	echo "$cfg: $line"
+	set -- $(echo "$line" | sed -n 's/^[^:]*: reads \([0-9]*\) writes \([0-9]*\) image \([0-9a-f]*\).*/\1 \2 \3/p')
+	reads=$1 writes=$2 image=$3
+}
+
+# value <name>: the number after <name> in the result line
+value() {
+	echo "$line" | sed -n "s/.*$1 \([0-9]*\).*/\1/p"
+}
+
+fail() {
+	echo "FAIL: $*"; exit 1
+}
+
+# check_cache <test> <configuration without cache> <configurations with cache>
+check_cache() {
+	test=$1 nocache=$2; shift 2
+	run $nocache $test
+	reads0=$reads writes0=$writes image0=$image
+	for c in "$@"; do
+		run $c $test
+		[ "$image" = "$image0" ] || fail "$test leaves a different disk with $c"
+		[ "$reads" -lt "$reads0" ] && [ "$writes" -lt "$writes0" ] || fail "$c does not save device accesses"
+	done
+}
+
+build base
+build cache1 -DSIM_WINCACHE=1
+build cache4 -DSIM_WINCACHE=4
+build cache16 -DSIM_WINCACHE=16
+build tiny -DSIM_TINY=1
+build tiny_cache4 -DSIM_TINY=1 -DSIM_WINCACHE=4
+build bitmap -DSIM_FATBITMAP=1024
+build runs16 -DSIM_CLSTRUN=16
+build runs16_bitmap -DSIM_CLSTRUN=16 -DSIM_FATBITMAP=1024
+build dirindex4 -DSIM_DIRINDEX=4
+build dirindex4_4k -DSIM_DIRINDEX=4 -DSIM_DIRINDEX_SIZE=4096
+build_sd sd
+build_sd sd_async -D_USE_ASYNC=1 -DSIM_ASYNC=1
+
+check_cache log base cache1 cache4 cache16
+check_cache log tiny tiny_cache4
+
+for level in 50 90 99 100; do
+	run base fill $level
+	reads0=$reads image0=$image full0=$(value "failing appends")
+	run bitmap fill $level
+	[ "$image" = "$image0" ] || fail "fill $level leaves a different disk with the bitmap"
+	[ "$reads" -le "$reads0" ] || fail "the bitmap takes more reads at $level%"
+	[ $(($(value "failing appends") * 10)) -le "$full0" ] || fail "the bitmap does not save reads on the full volume"
+done
+run runs16 fill 100
+
+run base runs
+image0=$image frags0=$(value fragments)
+run bitmap runs
+[ "$image" = "$image0" ] || fail "runs leaves a different disk with the bitmap"
+run runs16 runs
+image1=$image
+[ $(($(value fragments) * 4)) -lt "$frags0" ] || fail "the free cluster runs do not cut the fragments"
+run runs16_bitmap runs
+[ "$image" = "$image1" ] || fail "runs leaves a different disk with the bitmap and the free cluster runs"
+
+for n in 100 1000; do
+	run base dir $n
+	image0=$image stat0=$(value "stat every file") miss0=$(value "missing names")
+	for c in dirindex4 dirindex4_4k; do
+		run $c dir $n
+		[ "$image" = "$image0" ] || fail "dir $n leaves a different disk with $c"
+		[ "$(value "stat every file")" -lt "$stat0" ] && [ "$(value "missing names")" -lt "$miss0" ] ||
+			fail "$c does not save reads in a directory of $n files"
+	done
+	[ $(($(value "stat every file") * 2)) -lt "$stat0" ] && [ $(($(value "missing names") * 10)) -le "$miss0" ] ||
+		fail "the index of the whole directory does not save reads in a directory of $n files"
+done
+
+# card: the hash of the card in the result line
+card() {
+	echo "$line" | sed -n 's/.*image \([0-9a-f]*\).*/\1/p'
+}
+
+# check_sd: the driver calls in the result line
+check_sd() {
+	[ "$(value "masked calls")" = 0 ] || fail "$cfg calls the card or the RTOS with the interrupts masked"
+	[ "$(value "card busy errors")" = 0 ] || fail "$cfg starts a transfer the card is not ready for"
+}
+
+run sd_async raw
+check_sd
+run sd files
+check_sd
+image0=$(card)
+time0=$(($(value write) + $(value read)))
+run sd_async files
+check_sd
+[ "$(card)" = "$image0" ] || fail "files leaves a different card with _FS_ASYNC"
+[ $(($(value write) + $(value read))) -lt "$time0" ] || fail "_FS_ASYNC does not save time"
+echo PASS
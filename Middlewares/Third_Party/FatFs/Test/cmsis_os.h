@@ -0,0 +1,39 @@
+/* Host stub of cmsis_os.h: ffconf_template.h names osSemaphoreId for the
+re-entrancy option, which the host configuration turns off. The message
+queues and the tick used by the SD drivers are implemented in sd_host.c. */
+#ifndef CMSIS_OS_H
+#define CMSIS_OS_H
+#include <stdint.h>
+
+typedef void *osSemaphoreId;
+typedef void *osThreadId;
+typedef struct sim_queue *osMessageQId;
+
+typedef enum {
+	osOK = 0,
+	osEventMessage = 0x10,
+	osEventTimeout = 0x40,
+	osErrorResource = 0x81
+} osStatus;
+
+typedef struct {
+	osStatus status;
+	union { uint32_t v; void *p; } value;
+} osEvent;
+
+typedef struct {
+	uint32_t queue_sz;
+	uint32_t item_sz;
+} osMessageQDef_t;
+
+#define osWaitForever	0xFFFFFFFF
+#define osMessageQDef(name, queue_sz, type)	\
+	const osMessageQDef_t os_messageQ_def_##name = { (queue_sz), sizeof(type) }
+#define osMessageQ(name)	&os_messageQ_def_##name
+
+osMessageQId osMessageCreate (const osMessageQDef_t *queue_def, osThreadId thread_id);
+osStatus osMessagePut (osMessageQId queue_id, uint32_t info, uint32_t millisec);
+osEvent osMessageGet (osMessageQId queue_id, uint32_t millisec);
+int32_t osKernelRunning (void);
+uint32_t osKernelSysTick (void);		/* Milliseconds */
+#endif
@@ -0,0 +1,413 @@
+/* FatFs tests on a RAM disk (ramdisk.c). Each one runs a fixed workload, checks
+the files against a model of what was written, and prints the device accesses
+and a hash of the disk, which build.sh compares across configurations.
+- log: 8 log files on a FAT16 volume with 512 byte clusters get 3000 appends of
+  1-700 bytes, each an f_open/f_write/f_close. A new directory with a file in it
+  is made every 250 appends, and one of the logs is deleted and restarted every
+  400. After a remount every byte of every file and the directory entries are
+  checked.
+- fill <percent>: a FAT32 volume with 512 byte clusters is filled to the given
+  level with 4 KB files, and every 7th file is deleted. After a remount 2000
+  sectors are appended to a new file, with an f_sync() every 16, and the reads
+  and time of each append are measured. The volume is then filled up and the
+  reads of 20 appends that fail for lack of space are counted. The tracked
+  free cluster count must match a FAT scan, and after a remount every file is
+  checked.
+- runs: 4 files on a FAT32 volume with 512 byte clusters get 4000 appends of
+  512 bytes in turn, with a 1 KB file made every 100 appends. After a remount
+  the files are checked, their fragments counted with f_lseek(CREATE_LINKMAP)
+  and the disk_read() calls taken to read each of them with 64 KB f_read()s.
+- dir <files>: a directory on a FAT32 volume with 512 byte clusters gets the
+  given number of files, in turn named by an SFN, a lower case SFN and an
+  LFN of 5 entries. After a remount every file and as many missing names are
+  looked up with f_stat(), and the reads of each pass are counted. Then 4000
+  random operations each delete a file, check one with f_open() and f_read(),
+  or check that a deleted name is missing and create it again. After a
+  remount every file and every missing name is checked against the model,
+  and so is every entry f_readdir() returns.
+fatfs_test <test> [<percent> | <files>] */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ff.h"
+#include "ramdisk.h"
+
+#define CHECK(x) do { if (!(x)) { printf("FAIL line %d: %s\n", __LINE__, #x); exit(1); } } while (0)
+
+static char path[4];
+static FATFS fs;
+static BYTE work[_MAX_SS * 4];
+static unsigned rnd_state = 1;
+
+static unsigned rnd (unsigned n) { rnd_state = rnd_state * 1103515245u + 12345u; return (rnd_state >> 16) % n; }
+static double now (void) { struct timespec t; clock_gettime(CLOCK_MONOTONIC, &t); return t.tv_sec * 1e6 + t.tv_nsec / 1e3; }
+static int cmp (const void *a, const void *b) { double x = *(const double*)a, y = *(const double*)b; return x < y ? -1 : x > y; }
+static BYTE pattern (unsigned id, DWORD ofs) { return (BYTE)(ofs * 31 + id * 7 + (ofs >> 9)); }
+
+/* Write len pattern bytes of file id at its current end */
+static void put (FIL *fp, unsigned id, UINT len)
+{
+	static BYTE buf[1024];
+	DWORD ofs = f_size(fp);
+	UINT i, bw;
+
+	for (i = 0; i < len; i++) buf[i] = pattern(id, ofs + i);
+	CHECK(f_write(fp, buf, len, &bw) == FR_OK && bw == len);
+}
+
+/* Check that file name holds size pattern bytes of file id */
+static void verify (const char *name, unsigned id, DWORD size)
+{
+	static BYTE buf[1024];
+	FIL f;
+	DWORD ofs = 0;
+	UINT i, br;
+
+	CHECK(f_open(&f, name, FA_READ) == FR_OK);
+	CHECK(f_size(&f) == size);
+	do {
+		CHECK(f_read(&f, buf, sizeof buf, &br) == FR_OK);
+		for (i = 0; i < br; i++, ofs++) CHECK(buf[i] == pattern(id, ofs));
+	} while (br == sizeof buf);
+	CHECK(ofs == size);
+	CHECK(f_close(&f) == FR_OK);
+}
+
+/* Number of fragments of file name */
+static DWORD fragments (const char *name)
+{
+	static DWORD tbl[8192];
+	FIL f;
+
+	CHECK(f_open(&f, name, FA_READ) == FR_OK);
+	f.cltbl = tbl; tbl[0] = sizeof tbl / sizeof tbl[0];
+	CHECK(f_lseek(&f, CREATE_LINKMAP) == FR_OK);
+	CHECK(f_close(&f) == FR_OK);
+	return (tbl[0] - 1) / 2;
+}
+
+/* Free clusters tracked by the file system, checked against a FAT scan */
+static DWORD free_clusters (void)
+{
+	FATFS *pfs;
+	DWORD n, scan;
+
+	CHECK(f_getfree(path, &n, &pfs) == FR_OK && pfs == &fs);
+	fs.free_clst = 0xFFFFFFFF;
+	CHECK(f_getfree(path, &scan, &pfs) == FR_OK);
+	CHECK(n == scan);
+	return n;
+}
+
+static void format (DWORD nsect, BYTE opt, DWORD au)
+{
+	ram_init(nsect);
+	CHECK(f_mkfs(path, opt, au, work, sizeof work) == FR_OK);
+	CHECK(f_mount(&fs, path, 1) == FR_OK);
+}
+
+static void remount (void)
+{
+	CHECK(f_mount(0, path, 0) == FR_OK);
+	CHECK(f_mount(&fs, path, 1) == FR_OK);
+}
+
+static void log_test (void)
+{
+	enum { NLOG = 8, STEPS = 3000 };
+	DWORD size[NLOG] = { 0 };
+	unsigned gen[NLOG] = { 0 };
+	unsigned step, i, ndir = 0, nent = 0;
+	unsigned long reads, writes;
+	char name[32];
+	FIL f;
+	DIR dir;
+	FILINFO fno;
+
+	format(65536, FM_FAT, 512);
+	CHECK(fs.fs_type == FS_FAT16);
+	CHECK(f_mkdir("log") == FR_OK);
+	ram_reads = ram_writes = 0;
+	for (step = 0; step < STEPS; step++) {
+		i = rnd(NLOG);
+		sprintf(name, "log/l%u", i);
+		if (step % 250 == 249) {
+			sprintf(name, "log/d%u", ndir);
+			CHECK(f_mkdir(name) == FR_OK);
+			sprintf(name, "log/d%u/a.txt", ndir);
+			CHECK(f_open(&f, name, FA_WRITE | FA_CREATE_NEW) == FR_OK);
+			put(&f, 100 + ndir, 100);
+			CHECK(f_close(&f) == FR_OK);
+			ndir++;
+			continue;
+		}
+		if (step % 400 == 399 && size[i]) {
+			CHECK(f_unlink(name) == FR_OK);
+			size[i] = 0; gen[i]++;
+		}
+		CHECK(f_open(&f, name, FA_WRITE | FA_OPEN_APPEND) == FR_OK);
+		CHECK(f_size(&f) == size[i]);
+		put(&f, i + NLOG * gen[i], 1 + rnd(700));
+		size[i] = f_size(&f);
+		CHECK(f_close(&f) == FR_OK);
+	}
+	reads = ram_reads; writes = ram_writes;
+
+	remount();
+	for (i = 0; i < NLOG; i++) {
+		sprintf(name, "log/l%u", i);
+		verify(name, i + NLOG * gen[i], size[i]);
+	}
+	for (i = 0; i < ndir; i++) {
+		sprintf(name, "log/d%u/a.txt", i);
+		verify(name, 100 + i, 100);
+	}
+	CHECK(f_opendir(&dir, "log") == FR_OK);
+	while (f_readdir(&dir, &fno) == FR_OK && fno.fname[0]) nent++;
+	CHECK(f_closedir(&dir) == FR_OK);
+	CHECK(nent == NLOG + ndir);
+	printf("log: reads %lu writes %lu image %016llx\n", reads, writes, ram_hash());
+}
+
+static void fill_test (int level)
+{
+	enum { APPENDS = 2000 };
+	static double us[APPENDS];
+	static BYTE buf[4096];
+	DWORD total, nfile, size, i, j;
+	unsigned long reads, writes, r, max_reads = 0, full_reads;
+	char name[32];
+	UINT bw;
+	FIL f;
+
+	format(81920, FM_FAT32, 512);
+	CHECK(fs.fs_type == FS_FAT32);
+	total = fs.n_fatent - 2;
+	CHECK(f_mkdir("f") == FR_OK);
+	for (nfile = 0; (total - free_clusters()) * 100 < total * (DWORD)level; nfile++) {
+		if (nfile % 100 == 0) {
+			sprintf(name, "f/d%lu", (unsigned long)nfile / 100);
+			if (f_mkdir(name) != FR_OK) break;
+		}
+		sprintf(name, "f/d%lu/x%lu", (unsigned long)nfile / 100, (unsigned long)nfile % 100);
+		if (f_open(&f, name, FA_WRITE | FA_CREATE_NEW) != FR_OK) break;
+		for (i = 0; i < sizeof buf; i++) buf[i] = pattern(nfile, i);
+		CHECK(f_write(&f, buf, sizeof buf, &bw) == FR_OK);
+		CHECK(f_close(&f) == FR_OK);
+		if (bw < sizeof buf) { CHECK(f_unlink(name) == FR_OK); break; }
+	}
+	for (i = 0; i < nfile; i += 7) {
+		sprintf(name, "f/d%lu/x%lu", (unsigned long)i / 100, (unsigned long)i % 100);
+		CHECK(f_unlink(name) == FR_OK);
+	}
+
+	remount();
+	ram_reads = ram_writes = 0;
+	CHECK(f_open(&f, "big", FA_WRITE | FA_CREATE_NEW) == FR_OK);
+	for (i = 0; i < APPENDS; i++) {
+		double t = now();
+		r = ram_reads;
+		for (j = 0; j < 512; j++) buf[j] = pattern(999999, i * 512 + j);
+		CHECK(f_write(&f, buf, 512, &bw) == FR_OK && bw == 512);
+		if (i % 16 == 15) CHECK(f_sync(&f) == FR_OK);
+		us[i] = now() - t;
+		if (ram_reads - r > max_reads) max_reads = ram_reads - r;
+	}
+	reads = ram_reads; writes = ram_writes;
+	CHECK(f_close(&f) == FR_OK);
+	(void)free_clusters();
+
+	/* Fill up the volume, then retry */
+	CHECK(f_open(&f, "big", FA_WRITE | FA_OPEN_APPEND) == FR_OK);
+	do {
+		for (j = 0; j < 512; j++) buf[j] = pattern(999999, f_size(&f) + j);
+		CHECK(f_write(&f, buf, 512, &bw) == FR_OK);
+	} while (bw == 512);
+	CHECK(bw == 0);
+	r = ram_reads;
+	for (i = 0; i < 20; i++) CHECK(f_write(&f, buf, 512, &bw) == FR_OK && bw == 0);
+	full_reads = ram_reads - r;
+	size = f_size(&f);
+	CHECK(f_close(&f) == FR_OK);
+	CHECK(free_clusters() == 0);
+
+	remount();
+	verify("big", 999999, size);
+	for (i = 0; i < nfile; i++) {
+		if (i % 7 == 0) continue;
+		sprintf(name, "f/d%lu/x%lu", (unsigned long)i / 100, (unsigned long)i % 100);
+		verify(name, i, 4096);
+	}
+	qsort(us, APPENDS, sizeof us[0], cmp);
+	printf("fill %d%%: reads %lu writes %lu image %016llx, most reads of an append %lu, reads of 20 failing appends %lu, append median/max %.1f/%.1f us, files %lu\n",
+		level, reads, writes, ram_hash(), max_reads, full_reads, us[APPENDS / 2], us[APPENDS - 1],
+		(unsigned long)nfile);
+}
+
+static void runs_test (void)
+{
+	enum { NLOG = 4, STEPS = 4000 };
+	static BYTE buf[65536];
+	DWORD size[NLOG] = { 0 };
+	unsigned step, i, nsmall = 0;
+	unsigned long reads, writes, frags = 0, calls = 0;
+	char name[32];
+	UINT br;
+	FIL f;
+
+	format(81920, FM_FAT32, 512);
+	CHECK(fs.fs_type == FS_FAT32);
+	ram_reads = ram_writes = 0;
+	for (step = 0; step < STEPS; step++) {
+		i = step % NLOG;
+		if (step % 100 == 99) {
+			sprintf(name, "s%u", nsmall);
+			CHECK(f_open(&f, name, FA_WRITE | FA_CREATE_NEW) == FR_OK);
+			put(&f, 100 + nsmall, 1024);
+			CHECK(f_close(&f) == FR_OK);
+			nsmall++;
+		}
+		sprintf(name, "l%u", i);
+		CHECK(f_open(&f, name, FA_WRITE | FA_OPEN_APPEND) == FR_OK);
+		put(&f, i, 512);
+		size[i] = f_size(&f);
+		CHECK(f_close(&f) == FR_OK);
+	}
+	reads = ram_reads; writes = ram_writes;
+	(void)free_clusters();
+
+	remount();
+	for (i = 0; i < nsmall; i++) {
+		sprintf(name, "s%u", i);
+		verify(name, 100 + i, 1024);
+	}
+	for (i = 0; i < NLOG; i++) {
+		sprintf(name, "l%u", i);
+		verify(name, i, size[i]);
+		frags += fragments(name);
+		CHECK(f_open(&f, name, FA_READ) == FR_OK);
+		ram_reads = 0;
+		do CHECK(f_read(&f, buf, sizeof buf, &br) == FR_OK); while (br == sizeof buf);
+		calls += ram_reads;
+		CHECK(f_close(&f) == FR_OK);
+	}
+	printf("runs: reads %lu writes %lu image %016llx, fragments %lu, disk_read calls to read the files %lu\n",
+		reads, writes, ram_hash(), frags, calls);
+}
+
+#define DIR_MAXN 2000
+static BYTE dir_exist[DIR_MAXN];
+static unsigned dir_gen[DIR_MAXN];
+static DWORD dir_size[DIR_MAXN];
+static BYTE dir_seen[DIR_MAXN];
+
+/* Name of item i of the dir test: an SFN, a lower case SFN or an LFN */
+static void dir_name (char *name, unsigned i)
+{
+	switch (i % 3) {
+	case 0: sprintf(name, "d/F%u.TXT", i); break;
+	case 1: sprintf(name, "d/f%u.c", i); break;
+	default: sprintf(name, "d/Long file name %u of the directory index test.dat", i); break;
+	}
+}
+
+/* Create item i of the dir test with its next content */
+static void dir_create (unsigned i)
+{
+	char name[80];
+	FIL f;
+
+	dir_name(name, i);
+	CHECK(f_open(&f, name, FA_WRITE | FA_CREATE_NEW) == FR_OK);
+	dir_size[i] = (i + dir_gen[i]) % 50;
+	put(&f, i + DIR_MAXN * dir_gen[i], dir_size[i]);
+	CHECK(f_close(&f) == FR_OK);
+	dir_exist[i] = 1;
+}
+
+static void dir_test (unsigned n)
+{
+	enum { STEPS = 4000 };
+	unsigned step, i, nent = 0, nexist = 0;
+	unsigned long reads, writes, stat_reads, miss_reads, churn_reads;
+	char name[80];
+	FILINFO fno;
+	DIR dir;
+
+	CHECK(n <= DIR_MAXN);
+	format(81920, FM_FAT32, 512);
+	CHECK(f_mkdir("d") == FR_OK);
+	ram_reads = ram_writes = 0;
+	for (i = 0; i < n; i++) dir_create(i);
+	reads = ram_reads; writes = ram_writes;
+
+	/* Look every item and as many missing names up after a remount */
+	remount();
+	ram_reads = 0;
+	for (i = 0; i < n; i++) {
+		dir_name(name, i);
+		CHECK(f_stat(name, &fno) == FR_OK);
+		CHECK(fno.fsize == dir_size[i] && strcmp(fno.fname, name + 2) == 0);
+	}
+	stat_reads = ram_reads;
+	for (i = 0; i < n; i++) {
+		sprintf(name, "d/Missing %u.dat", i);
+		CHECK(f_stat(name, &fno) == FR_NO_FILE);
+	}
+	miss_reads = ram_reads - stat_reads;
+
+	ram_reads = 0;
+	for (step = 0; step < STEPS; step++) {
+		i = rnd(n);
+		dir_name(name, i);
+		if (dir_exist[i] && rnd(4) == 0) {
+			CHECK(f_unlink(name) == FR_OK);
+			dir_exist[i] = 0; dir_gen[i]++;
+		} else if (dir_exist[i]) {
+			verify(name, i + DIR_MAXN * dir_gen[i], dir_size[i]);
+		} else {
+			CHECK(f_stat(name, &fno) == FR_NO_FILE);
+			dir_create(i);
+		}
+	}
+	churn_reads = ram_reads;
+
+	remount();
+	for (i = 0; i < n; i++) {
+		dir_name(name, i);
+		if (dir_exist[i]) {
+			verify(name, i + DIR_MAXN * dir_gen[i], dir_size[i]);
+			nexist++;
+		} else {
+			CHECK(f_stat(name, &fno) == FR_NO_FILE);
+		}
+	}
+	CHECK(f_opendir(&dir, "d") == FR_OK);
+	while (f_readdir(&dir, &fno) == FR_OK && fno.fname[0]) {	/* Every entry is an item of the model, once */
+		for (i = 0; i < n; i++) {
+			dir_name(name, i);
+			if (strcmp(fno.fname, name + 2) == 0) break;
+		}
+		CHECK(i < n && dir_exist[i] && !dir_seen[i] && fno.fsize == dir_size[i]);
+		dir_seen[i] = 1;
+		nent++;
+	}
+	CHECK(f_closedir(&dir) == FR_OK);
+	CHECK(nent == nexist);
+	printf("dir %u: reads %lu writes %lu image %016llx, reads to stat every file %lu, reads of %u missing names %lu, reads of %u mixed operations %lu\n",
+		n, reads, writes, ram_hash(), stat_reads, n, miss_reads, STEPS, churn_reads);
+}
+
+int main (int argc, char **argv)
+{
+	const char *test = argc > 1 ? argv[1] : "log";
+
+	CHECK(FATFS_LinkDriver(&RAMDISK_Driver, path) == 0);
+	if (strcmp(test, "log") == 0) log_test();
+	else if (strcmp(test, "fill") == 0) fill_test(argc > 2 ? atoi(argv[2]) : 90);
+	else if (strcmp(test, "runs") == 0) runs_test();
+	else if (strcmp(test, "dir") == 0) dir_test(argc > 2 ? atoi(argv[2]) : 1000);
+	else { printf("unknown test %s\n", test); return 1; }
+	return 0;
+}
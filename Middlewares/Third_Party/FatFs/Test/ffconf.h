@@ -0,0 +1,35 @@
+/* Host configuration: ffconf_template.h without re-entrancy, and with the
+options under test taken from the command line, e.g. -DSIM_WINCACHE=4. */
+#include "ffconf_template.h"
+
+#undef _FS_REENTRANT
+#define _FS_REENTRANT	0
+
+#ifdef SIM_TINY
+#undef _FS_TINY
+#define _FS_TINY	SIM_TINY
+#endif
+#ifdef SIM_WINCACHE
+#undef _FS_WINCACHE
+#define _FS_WINCACHE	SIM_WINCACHE
+#endif
+#ifdef SIM_FATBITMAP
+#undef _FS_FATBITMAP
+#define _FS_FATBITMAP	SIM_FATBITMAP
+#endif
+#ifdef SIM_CLSTRUN
+#undef _FS_CLSTRUN
+#define _FS_CLSTRUN	SIM_CLSTRUN
+#endif
+#ifdef SIM_DIRINDEX
+#undef _FS_DIRINDEX
+#define _FS_DIRINDEX	SIM_DIRINDEX
+#endif
+#ifdef SIM_DIRINDEX_SIZE
+#undef _FS_DIRINDEX_SIZE
+#define _FS_DIRINDEX_SIZE	SIM_DIRINDEX_SIZE
+#endif
+#ifdef SIM_ASYNC
+#undef _FS_ASYNC
+#define _FS_ASYNC	SIM_ASYNC
+#endif
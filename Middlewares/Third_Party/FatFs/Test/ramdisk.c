@@ -0,0 +1,75 @@
+/* RAM disk driver for the host tests. */
+#include <stdlib.h>
+#include <string.h>
+#include "ramdisk.h"
+
+unsigned long ram_reads, ram_writes, ram_rsect, ram_wsect;
+static BYTE *ram;
+static DWORD ram_nsect;
+
+void ram_init (DWORD nsect)
+{
+	free(ram);
+	ram = calloc(nsect, 512);
+	ram_nsect = nsect;
+	ram_reads = ram_writes = ram_rsect = ram_wsect = 0;
+}
+
+unsigned long long ram_hash (void)
+{
+	unsigned long long h = 14695981039346656037ULL;
+	size_t i;
+
+	for (i = 0; i < (size_t)ram_nsect * 512; i++) h = (h ^ ram[i]) * 1099511628211ULL;
+	return h;
+}
+
+static DSTATUS RAMDISK_initialize (BYTE lun)
+{
+	(void)lun;
+	return ram ? 0 : STA_NOINIT;
+}
+
+static DSTATUS RAMDISK_status (BYTE lun)
+{
+	(void)lun;
+	return ram ? 0 : STA_NOINIT;
+}
+
+static DRESULT RAMDISK_read (BYTE lun, BYTE *buff, DWORD sector, UINT count)
+{
+	(void)lun;
+	if (sector + count > ram_nsect) return RES_PARERR;
+	ram_reads++; ram_rsect += count;
+	memcpy(buff, ram + (size_t)sector * 512, (size_t)count * 512);
+	return RES_OK;
+}
+
+static DRESULT RAMDISK_write (BYTE lun, const BYTE *buff, DWORD sector, UINT count)
+{
+	(void)lun;
+	if (sector + count > ram_nsect) return RES_PARERR;
+	ram_writes++; ram_wsect += count;
+	memcpy(ram + (size_t)sector * 512, buff, (size_t)count * 512);
+	return RES_OK;
+}
+
+static DRESULT RAMDISK_ioctl (BYTE lun, BYTE cmd, void *buff)
+{
+	(void)lun;
+	switch (cmd) {
+	case CTRL_SYNC: return RES_OK;
+	case GET_SECTOR_COUNT: *(DWORD*)buff = ram_nsect; return RES_OK;
+	case GET_SECTOR_SIZE: *(WORD*)buff = 512; return RES_OK;
+	case GET_BLOCK_SIZE: *(DWORD*)buff = 1; return RES_OK;
+	}
+	return RES_PARERR;
+}
+
+const Diskio_drvTypeDef RAMDISK_Driver = {
+	.disk_initialize = RAMDISK_initialize,
+	.disk_status = RAMDISK_status,
+	.disk_read = RAMDISK_read,
+	.disk_write = RAMDISK_write,
+	.disk_ioctl = RAMDISK_ioctl,
+};
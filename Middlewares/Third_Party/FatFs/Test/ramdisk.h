@@ -0,0 +1,13 @@
+/* RAM disk driver for the host tests, linked with FATFS_LinkDriver(). It
+counts the device accesses so that the tests can check them. */
+#ifndef RAMDISK_H
+#define RAMDISK_H
+#include "ff_gen_drv.h"
+
+extern const Diskio_drvTypeDef RAMDISK_Driver;
+extern unsigned long ram_reads, ram_writes;		/* disk_read/disk_write calls */
+extern unsigned long ram_rsect, ram_wsect;		/* Sectors read/written */
+
+void ram_init (DWORD nsect);			/* Allocate a zeroed disk of nsect sectors */
+unsigned long long ram_hash (void);		/* FNV-1a hash of the whole disk */
+#endif
@@ -0,0 +1,10 @@
+/* Host stub of sd_diskio_dma_rtos.h, the header the driver template is
+copied with. */
+#ifndef SD_DISKIO_DMA_RTOS_H
+#define SD_DISKIO_DMA_RTOS_H
+#include "ff_gen_drv.h"
+#include "sd_host.h"
+#include "cmsis_os.h"
+
+extern const Diskio_drvTypeDef SD_Driver;
+#endif
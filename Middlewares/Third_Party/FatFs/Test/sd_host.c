@@ -0,0 +1,255 @@
+/* Host stub of the BSP SD card, the interrupt mask and the CMSIS-RTOS
+message queues, see sd_host.h. */
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sd_host.h"
+#include "cmsis_os.h"
+
+unsigned sd_latency_us, sd_sector_us, sd_program_us;
+unsigned long sd_reads, sd_writes, sd_masked_calls, sd_errors;
+
+static uint8_t *card;
+static uint32_t card_nsect;
+static pthread_mutex_t card_mx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t card_cv = PTHREAD_COND_INITIALIZER;
+static struct { int busy, write; uint32_t *buf; uint32_t sector, count; } job;
+static unsigned long long prog_until;	/* End of the programming of the last write */
+
+/* The interrupt mask is a mutex held by the thread that masks the interrupts,
+and by the DMA thread while it runs a callback. */
+static pthread_mutex_t irq;
+static __thread int masked;
+
+static unsigned long long now_ns (void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (unsigned long long)t.tv_sec * 1000000000ULL + (unsigned long long)t.tv_nsec;
+}
+
+static void check_unmasked (void)
+{
+	if (masked) __sync_fetch_and_add(&sd_masked_calls, 1);
+}
+
+uint32_t __get_PRIMASK (void)
+{
+	return (uint32_t)masked;
+}
+
+void __disable_irq (void)
+{
+	if (!masked) {
+		pthread_mutex_lock(&irq);
+		masked = 1;
+	}
+}
+
+void __set_PRIMASK (uint32_t priMask)
+{
+	if (priMask) {
+		__disable_irq();
+	} else if (masked) {
+		masked = 0;
+		pthread_mutex_unlock(&irq);
+	}
+}
+
+static void *dma_thread (void *arg)
+{
+	struct timespec d;
+	uint32_t *buf, sector, count;
+	int write;
+	unsigned long long us;
+
+	(void)arg;
+	for (;;) {
+		pthread_mutex_lock(&card_mx);
+		while (!job.busy) pthread_cond_wait(&card_cv, &card_mx);
+		write = job.write; buf = job.buf; sector = job.sector; count = job.count;
+		pthread_mutex_unlock(&card_mx);
+
+		us = sd_latency_us + (unsigned long long)sd_sector_us * count;
+		d.tv_sec = us / 1000000; d.tv_nsec = (us % 1000000) * 1000;
+		nanosleep(&d, NULL);
+		if (write) {
+			memcpy(card + (size_t)sector * BLOCKSIZE, buf, (size_t)count * BLOCKSIZE);
+		} else {
+			memcpy(buf, card + (size_t)sector * BLOCKSIZE, (size_t)count * BLOCKSIZE);
+		}
+
+		pthread_mutex_lock(&card_mx);
+		if (write) prog_until = now_ns() + sd_program_us * 1000ULL;
+		job.busy = 0;
+		pthread_mutex_unlock(&card_mx);
+
+		/* Transfer complete interrupt */
+		pthread_mutex_lock(&irq);
+		if (write) {
+			BSP_SD_WriteCpltCallback();
+		} else {
+			BSP_SD_ReadCpltCallback();
+		}
+		pthread_mutex_unlock(&irq);
+	}
+	return NULL;
+}
+
+void sd_init (uint32_t nsect)
+{
+	static pthread_t t;
+	pthread_mutexattr_t a;
+
+	if (!card) {
+		pthread_mutexattr_init(&a);
+		pthread_mutexattr_settype(&a, PTHREAD_MUTEX_RECURSIVE);
+		pthread_mutex_init(&irq, &a);
+		pthread_create(&t, NULL, dma_thread, NULL);
+	}
+	free(card);
+	card = calloc(nsect, BLOCKSIZE);
+	card_nsect = nsect;
+	sd_reads = sd_writes = sd_masked_calls = sd_errors = 0;
+}
+
+uint8_t *sd_data (void)
+{
+	return card;
+}
+
+uint8_t BSP_SD_Init (void)
+{
+	check_unmasked();
+	return card ? MSD_OK : MSD_ERROR;
+}
+
+uint8_t BSP_SD_GetCardState (void)
+{
+	uint8_t state;
+
+	check_unmasked();
+	pthread_mutex_lock(&card_mx);
+	state = (job.busy || now_ns() < prog_until) ? SD_TRANSFER_BUSY : SD_TRANSFER_OK;
+	pthread_mutex_unlock(&card_mx);
+	return state;
+}
+
+static uint8_t start (int write, uint32_t *buf, uint32_t sector, uint32_t count)
+{
+	uint8_t ret = MSD_ERROR;
+
+	check_unmasked();
+	pthread_mutex_lock(&card_mx);
+	/* A transfer the card cannot take is a driver error, the card is never asked twice */
+	if (((uintptr_t)buf & 3) || job.busy || now_ns() < prog_until || sector + count > card_nsect) {
+		sd_errors++;
+	} else {
+		job.write = write; job.buf = buf; job.sector = sector; job.count = count;
+		job.busy = 1;
+		if (write) sd_writes++; else sd_reads++;
+		pthread_cond_signal(&card_cv);
+		ret = MSD_OK;
+	}
+	pthread_mutex_unlock(&card_mx);
+	return ret;
+}
+
+uint8_t BSP_SD_ReadBlocks_DMA (uint32_t *pData, uint32_t ReadAddr, uint32_t NumOfBlocks)
+{
+	return start(0, pData, ReadAddr, NumOfBlocks);
+}
+
+uint8_t BSP_SD_WriteBlocks_DMA (uint32_t *pData, uint32_t WriteAddr, uint32_t NumOfBlocks)
+{
+	return start(1, pData, WriteAddr, NumOfBlocks);
+}
+
+void BSP_SD_GetCardInfo (BSP_SD_CardInfo *CardInfo)
+{
+	check_unmasked();
+	CardInfo->LogBlockNbr = card_nsect;
+	CardInfo->LogBlockSize = BLOCKSIZE;
+}
+
+
+struct sim_queue {
+	pthread_mutex_t mx;
+	pthread_cond_t cv;
+	uint32_t size, head, n;
+	uint32_t v[];
+};
+
+osMessageQId osMessageCreate (const osMessageQDef_t *queue_def, osThreadId thread_id)
+{
+	struct sim_queue *q = calloc(1, sizeof *q + queue_def->queue_sz * sizeof q->v[0]);
+	pthread_condattr_t a;
+
+	(void)thread_id;
+	check_unmasked();
+	pthread_mutex_init(&q->mx, NULL);
+	pthread_condattr_init(&a);
+	pthread_condattr_setclock(&a, CLOCK_MONOTONIC);
+	pthread_cond_init(&q->cv, &a);
+	q->size = queue_def->queue_sz;
+	return q;
+}
+
+osStatus osMessagePut (osMessageQId q, uint32_t info, uint32_t millisec)
+{
+	osStatus st = osOK;
+
+	(void)millisec;		/* A full queue is not waited for, the drivers only post from the interrupt */
+	check_unmasked();
+	pthread_mutex_lock(&q->mx);
+	if (q->n == q->size) {
+		st = osErrorResource;
+	} else {
+		q->v[(q->head + q->n++) % q->size] = info;
+		pthread_cond_signal(&q->cv);
+	}
+	pthread_mutex_unlock(&q->mx);
+	return st;
+}
+
+osEvent osMessageGet (osMessageQId q, uint32_t millisec)
+{
+	osEvent e;
+	struct timespec t;
+	unsigned long long end = now_ns() + millisec * 1000000ULL;
+
+	check_unmasked();
+	t.tv_sec = end / 1000000000ULL; t.tv_nsec = end % 1000000000ULL;
+	pthread_mutex_lock(&q->mx);
+	while (q->n == 0) {
+		if (millisec == osWaitForever) {
+			pthread_cond_wait(&q->cv, &q->mx);
+		} else if (pthread_cond_timedwait(&q->cv, &q->mx, &t) != 0) {
+			break;
+		}
+	}
+	if (q->n) {
+		e.status = osEventMessage;
+		e.value.v = q->v[q->head];
+		q->head = (q->head + 1) % q->size;
+		q->n--;
+	} else {
+		e.status = osEventTimeout;
+		e.value.v = 0;
+	}
+	pthread_mutex_unlock(&q->mx);
+	return e;
+}
+
+int32_t osKernelRunning (void)
+{
+	return 1;
+}
+
+uint32_t osKernelSysTick (void)
+{
+	check_unmasked();
+	return (uint32_t)(now_ns() / 1000000ULL);
+}
@@ -0,0 +1,46 @@
+/* Host stub of the BSP SD card and of the Cortex-M interrupt mask, for
+sd_diskio_dma_rtos_template.c. The card is a RAM array served by a DMA thread
+that waits the injected latency, copies the data and then runs the transfer
+complete callback as the interrupt. The interrupt cannot run while a thread
+has the interrupts masked. Every BSP or RTOS call made with the interrupts
+masked is counted in sd_masked_calls. */
+#ifndef SD_HOST_H
+#define SD_HOST_H
+#include <stdint.h>
+
+#define MSD_OK				((uint8_t)0x00)
+#define MSD_ERROR			((uint8_t)0x01)
+#define SD_TRANSFER_OK		((uint8_t)0x00)
+#define SD_TRANSFER_BUSY	((uint8_t)0x01)
+#define BLOCKSIZE			512
+
+#define __ALIGN_BEGIN
+#define __ALIGN_END		__attribute__((aligned(4)))
+
+typedef struct {
+	uint32_t LogBlockNbr;
+	uint32_t LogBlockSize;
+} BSP_SD_CardInfo;
+
+uint8_t BSP_SD_Init (void);
+uint8_t BSP_SD_GetCardState (void);
+uint8_t BSP_SD_ReadBlocks_DMA (uint32_t *pData, uint32_t ReadAddr, uint32_t NumOfBlocks);
+uint8_t BSP_SD_WriteBlocks_DMA (uint32_t *pData, uint32_t WriteAddr, uint32_t NumOfBlocks);
+void BSP_SD_GetCardInfo (BSP_SD_CardInfo *CardInfo);
+void BSP_SD_ReadCpltCallback (void);		/* Defined by the driver */
+void BSP_SD_WriteCpltCallback (void);
+
+uint32_t __get_PRIMASK (void);
+void __set_PRIMASK (uint32_t priMask);
+void __disable_irq (void);
+
+extern unsigned sd_latency_us;		/* Command latency of each transfer */
+extern unsigned sd_sector_us;		/* Transfer time of each sector */
+extern unsigned sd_program_us;		/* Card busy time after a write */
+extern unsigned long sd_reads, sd_writes;	/* DMA transfers started */
+extern unsigned long sd_masked_calls;	/* BSP or RTOS calls made with the interrupts masked */
+extern unsigned long sd_errors;		/* Transfers started while the DMA was busy, or misaligned */
+
+void sd_init (uint32_t nsect);		/* Allocate a zeroed card of nsect sectors */
+uint8_t *sd_data (void);			/* Card contents */
+#endif
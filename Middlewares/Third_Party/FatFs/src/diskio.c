@@ -167,6 +167,149 @@ DRESULT disk_ioctl (
 }
 #endif /* _USE_IOCTL == 1 */
 
+/**
+  * @brief  Reads contiguous Sector(s) into a scatter list of buffers
+  * @param  pdrv: Physical drive number (0..)
+  * @param  *seg: Scatter list, each segment receives seg->count sectors
+  * @param  nseg: Number of segments in the list
+  * @param  sector: Sector address (LBA) of the first segment
+  * @retval DRESULT: Operation result
+  */
+#if _USE_VECTOR == 1
+DRESULT disk_readv (
+	BYTE pdrv,		/* Physical drive nmuber to identify the drive */
+	const DSEG *seg,	/* Scatter list of data buffers */
+	UINT nseg,		/* Number of segments */
+	DWORD sector		/* Sector address in LBA */
+)
+{
+  DRESULT res = RES_OK;
+
+  if (disk.drv[pdrv]->disk_readv != 0)
+  {
+    res = disk.drv[pdrv]->disk_readv(disk.lun[pdrv], seg, nseg, sector);
+  }
+  else
+  {
+    /* The driver has no vectored entry point, issue one request per segment */
+    for (; nseg && res == RES_OK; seg++, nseg--)
+    {
+      res = disk.drv[pdrv]->disk_read(disk.lun[pdrv], seg->buff, sector, seg->count);
+      sector += seg->count;
+    }
+  }
+  return res;
+}
+
+/**
+  * @brief  Writes contiguous Sector(s) from a gather list of buffers
+  * @param  pdrv: Physical drive number (0..)
+  * @param  *seg: Gather list, seg->count sectors are taken from each segment
+  * @param  nseg: Number of segments in the list
+  * @param  sector: Sector address (LBA) of the first segment
+  * @retval DRESULT: Operation result
+  */
+#if _USE_WRITE == 1
+DRESULT disk_writev (
+	BYTE pdrv,		/* Physical drive nmuber to identify the drive */
+	const DSEG *seg,	/* Gather list of data buffers */
+	UINT nseg,		/* Number of segments */
+	DWORD sector		/* Sector address in LBA */
+)
+{
+  DRESULT res = RES_OK;
+
+  if (disk.drv[pdrv]->disk_writev != 0)
+  {
+    res = disk.drv[pdrv]->disk_writev(disk.lun[pdrv], seg, nseg, sector);
+  }
+  else
+  {
+    /* The driver has no vectored entry point, issue one request per segment */
+    for (; nseg && res == RES_OK; seg++, nseg--)
+    {
+      res = disk.drv[pdrv]->disk_write(disk.lun[pdrv], seg->buff, sector, seg->count);
+      sector += seg->count;
+    }
+  }
+  return res;
+}
+#endif /* _USE_WRITE == 1 */
+#endif /* _USE_VECTOR == 1 */
+
+#if _USE_ASYNC == 1
+/**
+  * @brief  Queues an asynchronous sector transfer
+  * @param  pdrv: Physical drive number (0..)
+  * @param  *req: Request descriptor, it must stay untouched until the
+  *         completion has been taken with disk_poll()
+  * @retval DRESULT: RES_OK if the request has been accepted, the result of
+  *         the transfer itself is returned in req->res
+  */
+DRESULT disk_submit (
+	BYTE pdrv,		/* Physical drive nmuber to identify the drive */
+	DIOREQ *req		/* Request descriptor */
+)
+{
+  DRESULT res;
+
+  req->stat = DIO_BUSY;
+  if (disk.drv[pdrv]->disk_submit != 0)
+  {
+    res = disk.drv[pdrv]->disk_submit(disk.lun[pdrv], req);
+    if (res != RES_OK)
+    {
+      req->stat = DIO_IDLE;
+    }
+    return res;
+  }
+
+  /* The driver has no asynchronous entry point, complete the request in place */
+  if (req->op == DIO_READ)
+  {
+    req->res = disk.drv[pdrv]->disk_read(disk.lun[pdrv], req->buff, req->sector, req->count);
+  }
+  else
+  {
+#if _USE_WRITE == 1
+    req->res = disk.drv[pdrv]->disk_write(disk.lun[pdrv], req->buff, req->sector, req->count);
+#else
+    req->res = RES_PARERR;
+#endif /* _USE_WRITE == 1 */
+  }
+  req->stat = DIO_DONE;
+  return RES_OK;
+}
+
+/**
+  * @brief  Checks or waits for the completion of an asynchronous request
+  * @param  pdrv: Physical drive number (0..)
+  * @param  *req: Request descriptor passed to disk_submit()
+  * @param  wait: 0: return immediately, 1: block until the request completes
+  * @retval DRESULT: RES_OK when the request has completed (its result is in
+  *         req->res), RES_NOTRDY while it is still in progress
+  */
+DRESULT disk_poll (
+	BYTE pdrv,		/* Physical drive nmuber to identify the drive */
+	DIOREQ *req,	/* Request descriptor */
+	BYTE wait		/* Block until completion */
+)
+{
+  if (req->stat == DIO_BUSY && wait)
+  {
+    if (disk.drv[pdrv]->disk_wait != 0)
+    {
+      disk.drv[pdrv]->disk_wait(disk.lun[pdrv], req);
+    }
+    else
+    {
+      while (req->stat == DIO_BUSY) ;
+    }
+  }
+  return (req->stat == DIO_BUSY) ? RES_NOTRDY : RES_OK;
+}
+#endif /* _USE_ASYNC == 1 */
+
 /**
   * @brief  Gets Time from RTC
   * @param  None
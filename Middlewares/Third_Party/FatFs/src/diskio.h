@@ -11,6 +11,14 @@ extern "C" {
 
 #define _USE_WRITE	1	/* 1: Enable disk_write function */
 #define _USE_IOCTL	1	/* 1: Enable disk_ioctl function */
+/* diskio.c includes this file before ffconf.h, so the optional interfaces
+   below are enabled in the compiler options of the whole project */
+#ifndef _USE_VECTOR
+#define _USE_VECTOR	0	/* 1: Enable disk_readv and disk_writev functions */
+#endif
+#ifndef _USE_ASYNC
+#define _USE_ASYNC	0	/* 1: Enable disk_submit and disk_poll functions */
+#endif
 
 #include "integer.h"
 
@@ -27,6 +35,23 @@ typedef enum {
 	RES_PARERR		/* 4: Invalid Parameter */
 } DRESULT;
 
+/* Segment of a scatter/gather list for vectored disk access */
+typedef struct {
+	BYTE*	buff;	/* Data buffer */
+	UINT	count;	/* Number of sectors to transfer to/from the buffer */
+} DSEG;
+
+/* Asynchronous disk request */
+typedef struct {
+	BYTE	op;				/* Operation (DIO_READ or DIO_WRITE) */
+	volatile BYTE	stat;	/* Request status (DIO_IDLE, DIO_BUSY or DIO_DONE) */
+	volatile DRESULT	res;	/* Result of the operation (valid at DIO_DONE) */
+	BYTE*	buff;			/* Data buffer */
+	DWORD	sector;			/* Start sector in LBA */
+	UINT	count;			/* Number of sectors to transfer */
+	void*	link;			/* Reserved for the driver to chain the queued requests */
+} DIOREQ;
+
 
 /*---------------------------------------*/
 /* Prototypes for disk control functions */
@@ -37,6 +62,10 @@ DSTATUS disk_status (BYTE pdrv);
 DRESULT disk_read (BYTE pdrv, BYTE* buff, DWORD sector, UINT count);
 DRESULT disk_write (BYTE pdrv, const BYTE* buff, DWORD sector, UINT count);
 DRESULT disk_ioctl (BYTE pdrv, BYTE cmd, void* buff);
+DRESULT disk_readv (BYTE pdrv, const DSEG* seg, UINT nseg, DWORD sector);
+DRESULT disk_writev (BYTE pdrv, const DSEG* seg, UINT nseg, DWORD sector);
+DRESULT disk_submit (BYTE pdrv, DIOREQ* req);
+DRESULT disk_poll (BYTE pdrv, DIOREQ* req, BYTE wait);
 DWORD get_fattime (void);
 
 /* Disk Status Bits (DSTATUS) */
@@ -46,6 +75,19 @@ DWORD get_fattime (void);
 #define STA_PROTECT		0x04	/* Write protected */
 
 
+/* Asynchronous request operations (DIOREQ.op) */
+
+#define DIO_READ		0	/* Read sectors into the buffer */
+#define DIO_WRITE		1	/* Write sectors from the buffer */
+
+
+/* Asynchronous request status (DIOREQ.stat) */
+
+#define DIO_IDLE		0	/* Not submitted or completion already taken */
+#define DIO_BUSY		1	/* Queued or in progress */
+#define DIO_DONE		2	/* Completed, result is in DIOREQ.res */
+
+
 /* Command code for disk_ioctrl fucntion */
 
 /* Generic command (Used by FatFs) */
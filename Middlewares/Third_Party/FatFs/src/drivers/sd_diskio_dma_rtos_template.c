@@ -30,6 +30,7 @@
 #define QUEUE_SIZE         (uint32_t) 10
 #define READ_CPLT_MSG      (uint32_t) 1
 #define WRITE_CPLT_MSG     (uint32_t) 2
+#define ASYNC_CPLT_MSG     (uint32_t) 5
 /*
 ==================================================================
 enable the defines below to send custom rtos messages
@@ -90,6 +91,18 @@ __ALIGN_BEGIN static uint8_t scratch[BLOCKSIZE] __ALIGN_END;
 /* Disk status */
 static volatile DSTATUS Stat = STA_NOINIT;
 static osMessageQId SDQueueID;
+#if _USE_ASYNC == 1
+/*
+* Asynchronous requests are chained through DIOREQ.link and served in
+* submission order. ReqActive is set by the context that starts the head
+* one and stays set while its DMA runs.
+* Synchronous reads and writes first drain the chain so that the card
+* sees every access in the order FatFs issued it.
+*/
+static DIOREQ *ReqHead, *ReqTail;
+static volatile uint8_t ReqActive;
+static osMessageQId SDReqQueueID;
+#endif /* _USE_ASYNC == 1 */
 /* Private function prototypes -----------------------------------------------*/
 static DSTATUS SD_CheckStatus(BYTE lun);
 DSTATUS SD_initialize (BYTE);
@@ -101,6 +114,11 @@ DRESULT SD_write (BYTE, const BYTE*, DWORD, UINT);
 #if _USE_IOCTL == 1
 DRESULT SD_ioctl (BYTE, BYTE, void*);
 #endif  /* _USE_IOCTL == 1 */
+#if _USE_ASYNC == 1
+DRESULT SD_submit (BYTE, DIOREQ*);
+DRESULT SD_wait (BYTE, DIOREQ*);
+static DRESULT SD_Drain(void);
+#endif /* _USE_ASYNC == 1 */
 
 const Diskio_drvTypeDef  SD_Driver =
 {
@@ -114,6 +132,16 @@ const Diskio_drvTypeDef  SD_Driver =
 #if  _USE_IOCTL == 1
   SD_ioctl,
 #endif /* _USE_IOCTL == 1 */
+#if _USE_VECTOR == 1
+  0,
+#if  _USE_WRITE == 1
+  0,
+#endif /* _USE_WRITE == 1 */
+#endif /* _USE_VECTOR == 1 */
+#if _USE_ASYNC == 1
+  SD_submit,
+  SD_wait,
+#endif /* _USE_ASYNC == 1 */
 };
 
 /* Private functions ---------------------------------------------------------*/
@@ -180,6 +208,13 @@ DSTATUS SD_initialize(BYTE lun)
       osMessageQDef(SD_Queue, QUEUE_SIZE, uint16_t);
       SDQueueID = osMessageCreate (osMessageQ(SD_Queue), NULL);
     }
+#if _USE_ASYNC == 1
+    if ((Stat != STA_NOINIT) && (SDReqQueueID == NULL))
+    {
+      osMessageQDef(SD_ReqQueue, QUEUE_SIZE, uint16_t);
+      SDReqQueueID = osMessageCreate (osMessageQ(SD_ReqQueue), NULL);
+    }
+#endif /* _USE_ASYNC == 1 */
   }
 
   return Stat;
@@ -192,6 +227,21 @@ DSTATUS SD_initialize(BYTE lun)
 */
 DSTATUS SD_status(BYTE lun)
 {
+#if _USE_ASYNC == 1
+  /*
+  * the card is busy while the queued transfers run, and asking it for its
+  * state would break the DMA: report the state it had when they were queued
+  */
+  if (ReqHead != NULL)
+  {
+    return Stat;
+  }
+  /* a card still programming the last queued write is not uninitialized */
+  if (!(Stat & STA_NOINIT) && (SD_CheckStatusWithTimeout(SD_TIMEOUT) == 0))
+  {
+    return Stat;
+  }
+#endif /* _USE_ASYNC == 1 */
   return SD_CheckStatus(lun);
 }
 
@@ -215,6 +265,12 @@ DRESULT SD_read(BYTE lun, BYTE *buff, DWORD sector, UINT count)
   * ensure the SDCard is ready for a new operation
   */
 
+#if _USE_ASYNC == 1
+  if (SD_Drain() != RES_OK)
+  {
+    return res;
+  }
+#endif /* _USE_ASYNC == 1 */
   if (SD_CheckStatusWithTimeout(SD_TIMEOUT) < 0)
   {
     return res;
@@ -302,6 +358,12 @@ DRESULT SD_write(BYTE lun, const BYTE *buff, DWORD sector, UINT count)
   uint32_t alignedAddr;
 #endif
 
+#if _USE_ASYNC == 1
+  if (SD_Drain() != RES_OK)
+  {
+    return res;
+  }
+#endif /* _USE_ASYNC == 1 */
   if (SD_CheckStatusWithTimeout(SD_TIMEOUT) < 0)
   {
     return res;
@@ -349,25 +411,27 @@ DRESULT SD_write(BYTE lun, const BYTE *buff, DWORD sector, UINT count)
     /* Slow path, fetch each sector a part and memcpy to destination buffer */
     int i;
     uint8_t ret;
-#if (ENABLE_SD_DMA_CACHE_MAINTENANCE == 1)
-    /*
-    * invalidate the scratch buffer before the next write to get the actual data instead of the cached one
-    */
-    SCB_InvalidateDCache_by_Addr((uint32_t*)scratch, BLOCKSIZE);
-#endif
 
     for (i = 0; i < count; i++) {
+      memcpy((void *)scratch, (void *)buff, BLOCKSIZE);
+#if (ENABLE_SD_DMA_CACHE_MAINTENANCE == 1)
+      /*
+      * clean the scratch buffer so that the DMA reads the data just copied
+      */
+      SCB_CleanDCache_by_Addr((uint32_t*)scratch, BLOCKSIZE);
+#endif
       ret = BSP_SD_WriteBlocks_DMA((uint32_t*)scratch, (uint32_t)sector++, 1);
       if (ret == MSD_OK) {
         /* wait for a message from the queue or a timeout */
         event = osMessageGet(SDQueueID, SD_TIMEOUT);
 
-        if (event.status == osEventMessage) {
-          if (event.value.v == WRITE_CPLT_MSG) {
-            memcpy((void *)buff, (void *)scratch, BLOCKSIZE);
-            buff += BLOCKSIZE;
-          }
+        /* the card takes the next sector once it has programmed this one */
+        if ((event.status != osEventMessage) || (event.value.v != WRITE_CPLT_MSG) ||
+            (SD_CheckStatusWithTimeout(SD_TIMEOUT) < 0)) {
+          ret = MSD_ERROR;
+          break;
         }
+        buff += BLOCKSIZE;
       }
       else
       {
@@ -402,7 +466,11 @@ DRESULT SD_ioctl(BYTE lun, BYTE cmd, void *buff)
   {
     /* Make sure that no pending write process */
   case CTRL_SYNC :
+#if _USE_ASYNC == 1
+    res = SD_Drain();
+#else
     res = RES_OK;
+#endif /* _USE_ASYNC == 1 */
     break;
 
     /* Get number of sectors on the disk (DWORD) */
@@ -434,7 +502,234 @@ DRESULT SD_ioctl(BYTE lun, BYTE cmd, void *buff)
 }
 #endif /* _USE_IOCTL == 1 */
 
+#if _USE_ASYNC == 1
+/**
+* @brief  Takes the DMA for the request at the head of the chain. The chain
+*         is only touched with the interrupts masked, and only for the few
+*         instructions below: the card and the RTOS are always called with
+*         the interrupts enabled.
+* @retval DIOREQ*: Request to be started by the caller, NULL if the chain is
+*         empty or the DMA is already taken
+*/
+static DIOREQ *SD_ClaimRequest(void)
+{
+  uint32_t primask = __get_PRIMASK();
+  DIOREQ *req;
+
+  __disable_irq();
+  req = ReqActive ? NULL : ReqHead;
+  if (req != NULL)
+  {
+    ReqActive = 1;
+  }
+  __set_PRIMASK(primask);
+
+  return req;
+}
+
+/**
+* @brief  Completes the request at the head of the chain and releases the DMA
+* @param  res: Result of the transfer
+* @retval None
+*/
+static void SD_FinishRequest(DRESULT res)
+{
+  uint32_t primask = __get_PRIMASK();
+  DIOREQ *req;
+
+  __disable_irq();
+  req = ReqHead;
+  if (req != NULL)
+  {
+    ReqHead = (DIOREQ*)req->link;
+    if (ReqHead == NULL)
+    {
+      ReqTail = NULL;
+    }
+  }
+  ReqActive = 0;
+  __set_PRIMASK(primask);
+
+  if (req == NULL)
+  {
+    return;
+  }
+#if (ENABLE_SD_DMA_CACHE_MAINTENANCE == 1)
+  if (req->op == DIO_READ)
+  {
+    SCB_InvalidateDCache_by_Addr((uint32_t*)((uint32_t)req->buff & ~0x1F), req->count*BLOCKSIZE + ((uint32_t)req->buff & 0x1F));
+  }
+#endif
+  req->res = res;
+  req->stat = DIO_DONE;
+  osMessagePut(SDReqQueueID, ASYNC_CPLT_MSG, 0);
+}
+
+/**
+* @brief  Starts the DMA of the head request if the card can take it
+* @param  wait: 1 in the task context, to wait for a card still programming
+*         the previous write, 0 in the transfer complete interrupt, where
+*         such a card is left to the next driver call
+* @retval DRESULT: RES_OK, or RES_ERROR if the card timed out
+*/
+static DRESULT SD_StartRequests(uint8_t wait)
+{
+  DIOREQ *req;
+  uint8_t ret;
 
+  while ((req = SD_ClaimRequest()) != NULL)
+  {
+    if (wait ? (SD_CheckStatusWithTimeout(SD_TIMEOUT) < 0) : (BSP_SD_GetCardState() != SD_TRANSFER_OK))
+    {
+      ReqActive = 0;
+      return wait ? RES_ERROR : RES_OK;
+    }
+    if (req->op == DIO_READ)
+    {
+      ret = BSP_SD_ReadBlocks_DMA((uint32_t*)req->buff, (uint32_t)req->sector, req->count);
+    }
+    else
+    {
+#if (ENABLE_SD_DMA_CACHE_MAINTENANCE == 1)
+      SCB_CleanDCache_by_Addr((uint32_t*)((uint32_t)req->buff & ~0x1F), req->count*BLOCKSIZE + ((uint32_t)req->buff & 0x1F));
+#endif
+      ret = BSP_SD_WriteBlocks_DMA((uint32_t*)req->buff, (uint32_t)req->sector, req->count);
+    }
+    if (ret != MSD_OK)
+    {
+      SD_FinishRequest(RES_ERROR);
+    }
+  }
+  return RES_OK;
+}
+
+/**
+* @brief  Fails every queued request, used when the card stops responding
+* @retval None
+*/
+static void SD_AbortRequests(void)
+{
+  while (ReqHead != NULL)
+  {
+    SD_FinishRequest(RES_ERROR);
+  }
+}
+
+/**
+* @brief  Waits until every queued request has completed
+* @retval DRESULT: RES_OK, or RES_ERROR if the card timed out
+*/
+static DRESULT SD_Drain(void)
+{
+  osEvent event;
+
+  while (ReqHead != NULL)
+  {
+    if (SD_StartRequests(1) != RES_OK)
+    {
+      SD_AbortRequests();
+      return RES_ERROR;
+    }
+    if (ReqHead == NULL)
+    {
+      break;
+    }
+    /* the head request has been started, its completion posts a message */
+    event = osMessageGet(SDReqQueueID, SD_TIMEOUT);
+    if (event.status != osEventMessage)
+    {
+      SD_AbortRequests();
+      return RES_ERROR;
+    }
+  }
+  return RES_OK;
+}
+
+/**
+* @brief  Queues an asynchronous transfer
+* @param  lun : not used
+* @param  *req: Request descriptor, completed from the DMA interrupt
+* @retval DRESULT: Operation result
+*/
+DRESULT SD_submit(BYTE lun, DIOREQ *req)
+{
+  uint32_t primask;
+
+  if (Stat & STA_NOINIT) return RES_NOTRDY;
+
+#if defined(ENABLE_SCRATCH_BUFFER)
+  if ((uint32_t)req->buff & 0x3)
+  {
+    /* the scratch buffer path cannot run in the background */
+    if (req->op == DIO_READ)
+    {
+      req->res = SD_read(lun, req->buff, req->sector, req->count);
+    }
+    else
+    {
+#if _USE_WRITE == 1
+      req->res = SD_write(lun, req->buff, req->sector, req->count);
+#else
+      req->res = RES_PARERR;
+#endif /* _USE_WRITE == 1 */
+    }
+    req->stat = DIO_DONE;
+    return RES_OK;
+  }
+#endif
+
+  req->link = NULL;
+  primask = __get_PRIMASK();
+  __disable_irq();
+  if (ReqTail != NULL)
+  {
+    ReqTail->link = req;
+  }
+  else
+  {
+    ReqHead = req;
+  }
+  ReqTail = req;
+  __set_PRIMASK(primask);
+  if (SD_StartRequests(1) != RES_OK)
+  {
+    SD_AbortRequests();
+  }
+
+  return RES_OK;
+}
+
+/**
+* @brief  Blocks until a queued transfer has completed
+* @param  lun : not used
+* @param  *req: Request descriptor passed to SD_submit()
+* @retval DRESULT: RES_OK, or RES_ERROR if the card timed out
+*/
+DRESULT SD_wait(BYTE lun, DIOREQ *req)
+{
+  osEvent event;
+
+  while (req->stat == DIO_BUSY)
+  {
+    if (SD_StartRequests(1) != RES_OK)
+    {
+      SD_AbortRequests();
+      return RES_ERROR;
+    }
+    if (req->stat != DIO_BUSY)
+    {
+      break;
+    }
+    event = osMessageGet(SDReqQueueID, SD_TIMEOUT);
+    if (event.status != osEventMessage)
+    {
+      SD_AbortRequests();
+      return RES_ERROR;
+    }
+  }
+  return RES_OK;
+}
+#endif /* _USE_ASYNC == 1 */
 
 /**
 * @brief Tx Transfer completed callbacks
@@ -447,6 +742,14 @@ void BSP_SD_WriteCpltCallback(void)
   * No need to add an "osKernelRunning()" check here, as the SD_initialize()
   * is always called before any SD_Read()/SD_Write() call
   */
+#if _USE_ASYNC == 1
+  if (ReqActive)
+  {
+    SD_FinishRequest(RES_OK);
+    SD_StartRequests(0);
+    return;
+  }
+#endif /* _USE_ASYNC == 1 */
   osMessagePut(SDQueueID, WRITE_CPLT_MSG, osWaitForever);
 }
 
@@ -461,6 +764,14 @@ void BSP_SD_ReadCpltCallback(void)
   * No need to add an "osKernelRunning()" check here, as the SD_initialize()
   * is always called before any SD_Read()/SD_Write() call
   */
+#if _USE_ASYNC == 1
+  if (ReqActive)
+  {
+    SD_FinishRequest(RES_OK);
+    SD_StartRequests(0);
+    return;
+  }
+#endif /* _USE_ASYNC == 1 */
   osMessagePut(SDQueueID, READ_CPLT_MSG, osWaitForever);
 }
 
@@ -478,6 +478,44 @@
 #endif
 
 
+/* Scatter/gather file transfer */
+#if _USE_STREAM
+#if _USE_VECTOR != 1
+#error _USE_STREAM needs _USE_VECTOR = 1 (see diskio.h)
+#endif
+#ifndef _FS_STREAM_NSEG
+#define _FS_STREAM_NSEG	8	/* Maximum number of segments passed to a vectored disk access */
+#endif
+#endif
+
+
+/* Shared cluster link maps */
+#if _FS_LINKMAP && !_USE_FASTSEEK
+#error _FS_LINKMAP needs _USE_FASTSEEK
+#endif
+#if _FS_LINKMAP < 0 || _FS_LINKMAP > 255 || (_FS_LINKMAP && _FS_LINKMAP_FRAG < 1)
+#error Wrong _FS_LINKMAP setting
+#endif
+
+
+/* Free cluster run search */
+#if _FS_CLSTRUN < 0 || _FS_CLSTRUN == 1 || _FS_CLSTRUN > 65535
+#error Wrong _FS_CLSTRUN setting
+#endif
+
+
+/* Directory name index */
+#if _FS_DIRINDEX < 0 || _FS_DIRINDEX > 255 || (_FS_DIRINDEX && (_FS_DIRINDEX_SIZE < 16 || _FS_DIRINDEX_SIZE > 65536))
+#error Wrong _FS_DIRINDEX setting
+#endif
+
+
+/* Asynchronous file data transfer */
+#if _FS_ASYNC && !_FS_TINY && _USE_ASYNC != 1
+#error _FS_ASYNC needs _USE_ASYNC = 1 (see diskio.h)
+#endif
+
+
 /* Definitions of sector size */
 #if (_MAX_SS < _MIN_SS) || (_MAX_SS != 512 && _MAX_SS != 1024 && _MAX_SS != 2048 && _MAX_SS != 4096) || (_MIN_SS != 512 && _MIN_SS != 1024 && _MIN_SS != 2048 && _MIN_SS != 4096)
 #error Wrong sector size configuration
@@ -489,6 +527,12 @@
 #endif
 
 
+/* Sector cache behind the disk access window */
+#if _FS_WINCACHE < 0 || _FS_WINCACHE > 16
+#error Wrong _FS_WINCACHE setting
+#endif
+
+
 /* Timestamp */
 #if _FS_NORTC == 1
 #if _NORTC_YEAR < 1980 || _NORTC_YEAR > 2107 || _NORTC_MON < 1 || _NORTC_MON > 12 || _NORTC_MDAY < 1 || _NORTC_MDAY > 31
@@ -878,29 +922,195 @@ void clear_lock (	/* Clear lock entries of the volume */
 /*-----------------------------------------------------------------------*/
 /* Move/Flush disk access window in the file system object               */
 /*-----------------------------------------------------------------------*/
+#if !_FS_READONLY
+static
+FRESULT write_window (	/* Returns FR_OK or FR_DISK_ERROR */
+	FATFS* fs,			/* File system object */
+	const BYTE* buff,	/* Sector data to be written */
+	DWORD wsect			/* Sector number */
+)
+{
+	UINT nf;
+
+
+	if (disk_write(fs->drv, buff, wsect, 1) != RES_OK) return FR_DISK_ERR;
+	if (wsect - fs->fatbase < fs->fsize) {		/* Is it in the FAT area? */
+		for (nf = fs->n_fats; nf >= 2; nf--) {	/* Reflect the change to all FAT copies */
+			wsect += fs->fsize;
+			disk_write(fs->drv, buff, wsect, 1);
+		}
+	}
+	return FR_OK;
+}
+#endif
+
+
+#if _FS_WINCACHE
+static
+void cache_reset (
+	FATFS* fs		/* File system object */
+)
+{
+	UINT i;
+
+
+	for (i = 0; i < _FS_WINCACHE; i++) {
+		fs->csect[i] = 0xFFFFFFFF; fs->cflag[i] = 0;
+	}
+}
+
+
+#if !_FS_READONLY
+static
+void cache_drop (	/* Discard a cached copy of the sector superseded by the window */
+	FATFS* fs,		/* File system object */
+	DWORD sect		/* Sector number */
+)
+{
+	UINT i;
+
+
+	for (i = 0; i < _FS_WINCACHE; i++) {
+		if (fs->csect[i] == sect) {
+			fs->csect[i] = 0xFFFFFFFF; fs->cflag[i] = 0;
+		}
+	}
+}
+
+
+static
+FRESULT sync_cache (	/* Returns FR_OK or FR_DISK_ERROR */
+	FATFS* fs			/* File system object */
+)
+{
+	UINT i;
+
+
+	for (i = 0; i < _FS_WINCACHE; i++) {	/* Write back all dirty cache buffers */
+		if (fs->cflag[i]) {
+			if (write_window(fs, fs->cbuf[i], fs->csect[i]) != FR_OK) return FR_DISK_ERR;
+			fs->cflag[i] = 0;
+		}
+	}
+	return FR_OK;
+}
+
+
+static
+void cache_update (	/* Reflect a direct multi-sector write to the cached sectors */
+	FATFS* fs,		/* File system object */
+	const BYTE* buff,	/* Data written to the device */
+	DWORD sect,		/* Start sector */
+	UINT cc			/* Number of sectors */
+)
+{
+	UINT i;
+
+
+	for (i = 0; i < _FS_WINCACHE; i++) {
+		if (fs->csect[i] - sect < cc) {
+			mem_cpy(fs->cbuf[i], buff + ((fs->csect[i] - sect) * SS(fs)), SS(fs));
+			fs->cflag[i] = 0;
+		}
+	}
+}
+
+
+#if _FS_TINY && _FS_MINIMIZE <= 2
+static
+void cache_overlay (	/* Replace sectors read directly from the device with dirty cached data */
+	FATFS* fs,		/* File system object */
+	BYTE* buff,		/* Data read from the device */
+	DWORD sect,		/* Start sector */
+	UINT cc			/* Number of sectors */
+)
+{
+	UINT i;
+
+
+	for (i = 0; i < _FS_WINCACHE; i++) {
+		if (fs->cflag[i] && fs->csect[i] - sect < cc) {
+			mem_cpy(buff + ((fs->csect[i] - sect) * SS(fs)), fs->cbuf[i], SS(fs));
+		}
+	}
+}
+#endif
+#endif
+
+
+static
+FRESULT cache_window (	/* Returns FR_OK or FR_DISK_ERROR */
+	FATFS* fs,			/* File system object */
+	DWORD sector		/* Sector number to make appearance in the fs->win[] */
+)
+{
+	UINT i, hit, vic;
+	DWORD sect;
+	BYTE flag, b, *wp, *cp;
+
+
+	hit = vic = _FS_WINCACHE;
+	for (i = 0; i < _FS_WINCACHE; i++) {
+		if (fs->csect[i] == fs->winsect) {	/* Discard stale copy of the window (window has been retargeted) */
+			fs->csect[i] = 0xFFFFFFFF; fs->cflag[i] = 0;
+		}
+		if (fs->csect[i] == sector) hit = i;
+		if (vic == _FS_WINCACHE || (fs->csect[vic] != 0xFFFFFFFF && (fs->csect[i] == 0xFFFFFFFF || fs->cuse[i] < fs->cuse[vic]))) {
+			vic = i;	/* Empty or least recently used buffer */
+		}
+	}
+
+	if (hit < _FS_WINCACHE) {	/* Cache hit: exchange the window and the cache buffer */
+		wp = fs->win; cp = fs->cbuf[hit];
+		for (i = 0; i < SS(fs); i++) {
+			b = wp[i]; wp[i] = cp[i]; cp[i] = b;
+		}
+		sect = fs->winsect; flag = fs->wflag;
+		fs->winsect = sector; fs->wflag = fs->cflag[hit];
+		fs->csect[hit] = sect; fs->cflag[hit] = flag;
+		fs->cuse[hit] = ++fs->cstamp;
+		return FR_OK;
+	}
+
+	if (fs->winsect != 0xFFFFFFFF) {	/* Cache miss: retire the window into the victim buffer */
+#if !_FS_READONLY
+		if (fs->cflag[vic]) {			/* Write back the victim if it is dirty */
+			if (write_window(fs, fs->cbuf[vic], fs->csect[vic]) != FR_OK) return FR_DISK_ERR;
+			fs->cflag[vic] = 0;
+		}
+#endif
+		mem_cpy(fs->cbuf[vic], fs->win, SS(fs));
+		fs->csect[vic] = fs->winsect; fs->cflag[vic] = fs->wflag;
+		fs->cuse[vic] = ++fs->cstamp;
+		fs->wflag = 0;
+	}
+	if (disk_read(fs->drv, fs->win, sector, 1) != RES_OK) {
+		sector = 0xFFFFFFFF;	/* Invalidate window if data is not reliable */
+		fs->winsect = sector;
+		return FR_DISK_ERR;
+	}
+	fs->winsect = sector;
+	return FR_OK;
+}
+#endif	/* _FS_WINCACHE */
+
+
 #if !_FS_READONLY
 static
 FRESULT sync_window (	/* Returns FR_OK or FR_DISK_ERROR */
 	FATFS* fs			/* File system object */
 )
 {
-	DWORD wsect;
-	UINT nf;
 	FRESULT res = FR_OK;
 
 
 	if (fs->wflag) {	/* Write back the sector if it is dirty */
-		wsect = fs->winsect;	/* Current sector number */
-		if (disk_write(fs->drv, fs->win, wsect, 1) != RES_OK) {
-			res = FR_DISK_ERR;
-		} else {
+		res = write_window(fs, fs->win, fs->winsect);
+		if (res == FR_OK) {
 			fs->wflag = 0;
-			if (wsect - fs->fatbase < fs->fsize) {		/* Is it in the FAT area? */
-				for (nf = fs->n_fats; nf >= 2; nf--) {	/* Reflect the change to all FAT copies */
-					wsect += fs->fsize;
-					disk_write(fs->drv, fs->win, wsect, 1);
-				}
-			}
+#if _FS_WINCACHE
+			cache_drop(fs, fs->winsect);	/* The window supersedes any cached copy */
+#endif
 		}
 	}
 	return res;
@@ -918,6 +1128,9 @@ FRESULT move_window (	/* Returns FR_OK or FR_DISK_ERROR */
 
 
 	if (sector != fs->winsect) {	/* Window offset changed? */
+#if _FS_WINCACHE
+		res = cache_window(fs, sector);	/* Swap the window via the sector cache */
+#else
 #if !_FS_READONLY
 		res = sync_window(fs);		/* Write-back changes */
 #endif
@@ -928,6 +1141,7 @@ FRESULT move_window (	/* Returns FR_OK or FR_DISK_ERROR */
 			}
 			fs->winsect = sector;
 		}
+#endif
 	}
 	return res;
 }
@@ -949,6 +1163,9 @@ FRESULT sync_fs (	/* FR_OK:succeeded, !=0:error */
 
 
 	res = sync_window(fs);
+#if _FS_WINCACHE
+	if (res == FR_OK) res = sync_cache(fs);	/* Write back the sector cache */
+#endif
 	if (res == FR_OK) {
 		/* Update FSInfo sector if needed */
 		if (fs->fs_type == FS_FAT32 && fs->fsi_flag == 1) {
@@ -962,6 +1179,9 @@ FRESULT sync_fs (	/* FR_OK:succeeded, !=0:error */
 			/* Write it into the FSInfo sector */
 			fs->winsect = fs->volbase + 1;
 			disk_write(fs->drv, fs->win, fs->winsect, 1);
+#if _FS_WINCACHE
+			cache_drop(fs, fs->winsect);
+#endif
 			fs->fsi_flag = 0;
 		}
 		/* Make sure that no pending write process in the physical drive */
@@ -1263,6 +1483,166 @@ FRESULT fill_last_frag (
 
 
 
+#if _FS_FATBITMAP && !_FS_READONLY
+/*-----------------------------------------------------------------------*/
+/* FAT12/16/32: Free space bitmap of the FAT sectors                     */
+/*-----------------------------------------------------------------------*/
+
+static
+DWORD fbm_index (	/* Index of the FAT sector in the bitmap (0xFFFFFFFF:Not tracked) */
+	FATFS* fs,		/* File system object */
+	DWORD clst		/* Cluster number */
+)
+{
+	DWORD i;
+
+
+	if (fs->fs_type == FS_FAT16) {
+		i = clst / (SS(fs) / 2);
+	} else if (fs->fs_type == FS_FAT32) {
+		i = clst / (SS(fs) / 4);
+	} else {
+		return 0xFFFFFFFF;	/* FAT12 entries may straddle sectors */
+	}
+	return (i < (DWORD)_FS_FATBITMAP * 8) ? i : 0xFFFFFFFF;
+}
+
+
+static
+void fbm_mark (
+	FATFS* fs,		/* File system object */
+	DWORD clst,		/* Cluster in the FAT sector to be marked */
+	int full		/* 1:FAT sector has no free entry, 0:FAT sector may have free entries */
+)
+{
+	DWORD i = fbm_index(fs, clst);
+
+
+	if (i != 0xFFFFFFFF) {
+		if (full) {
+			fs->fbmp[i / 8] |= (BYTE)(1 << (i % 8));
+		} else {
+			fs->fbmp[i / 8] &= (BYTE)~(1 << (i % 8));
+		}
+	}
+}
+
+
+static
+int fbm_full (		/* 1:FAT sector is known to have no free entry, 0:Unknown */
+	FATFS* fs,		/* File system object */
+	DWORD clst		/* Cluster in the FAT sector to be tested */
+)
+{
+	DWORD i = fbm_index(fs, clst);
+
+
+	return (i != 0xFFFFFFFF && (fs->fbmp[i / 8] & (1 << (i % 8)))) ? 1 : 0;
+}
+
+#endif	/* _FS_FATBITMAP && !_FS_READONLY */
+
+
+
+
+#if _FS_LINKMAP
+/*-----------------------------------------------------------------------*/
+/* FAT handling - Shared cluster link maps                               */
+/*-----------------------------------------------------------------------*/
+
+#if !_FS_READONLY
+static
+void lmap_drop (
+	FATFS* fs,		/* File system object */
+	DWORD sclst		/* Start cluster of the chain being modified */
+)
+{
+	UINT i;
+
+
+	for (i = 0; i < _FS_LINKMAP; i++) {
+		if (fs->lmap[i].sclust == sclst) fs->lmap[i].sclust = 0;
+	}
+}
+#endif
+
+
+#if _FS_MINIMIZE <= 2
+static
+LINKMAP* lmap_get (	/* 0:Error, !=0:Pointer to the link map of the file */
+	FIL* fp			/* Pointer to the file object */
+)
+{
+	FATFS *fs = fp->obj.fs;
+	LINKMAP *map, *vm;
+	DWORD cl, pcl, ord;
+	UINT i, n;
+
+
+	vm = fs->lmap;
+	for (i = 0; i < _FS_LINKMAP; i++) {	/* Find the map of the chain */
+		map = &fs->lmap[i];
+		if (map->sclust == fp->obj.sclust) {
+			map->stamp = ++fs->lstamp;
+			return map;
+		}
+		if (map->sclust == 0 || (vm->sclust != 0 && map->stamp < vm->stamp)) vm = map;	/* Victim: unused or least recently used one */
+	}
+
+	/* Build a link map of the chain into the victim */
+	vm->sclust = 0;
+	cl = fp->obj.sclust; ord = 0; n = 0;
+	do {
+		vm->frag[n][0] = ord; vm->frag[n][1] = cl;	/* Top of the fragment */
+		do {
+			pcl = cl; ord++;
+			cl = get_fat(&fp->obj, cl);
+			if (cl <= 1 || cl == 0xFFFFFFFF) return 0;
+		} while (cl == pcl + 1);
+		n++;
+	} while (cl < fs->n_fatent && n < _FS_LINKMAP_FRAG);	/* Until end of the chain or the map is full */
+	vm->nfrag = n;
+	vm->ncl = ord;
+	vm->sclust = fp->obj.sclust;
+	vm->stamp = ++fs->lstamp;
+	return vm;
+}
+
+
+
+static
+DWORD lmap_clust (	/* 0:Map not available, >=2:Cluster number */
+	FIL* fp,		/* Pointer to the file object */
+	DWORD* ord		/* Cluster order in the file to find (clipped at the end of the map on return) */
+)
+{
+	LINKMAP *map;
+	UINT lo, hi, mid;
+	DWORD o = *ord;
+
+
+	if (fp->obj.sclust == 0) return 0;
+	map = lmap_get(fp);
+	if (!map) return 0;
+	if (o >= map->ncl) o = map->ncl - 1;	/* Clip at the last cluster in the map */
+	for (lo = 0, hi = map->nfrag; hi - lo > 1; ) {	/* Find the fragment */
+		mid = (lo + hi) / 2;
+		if (map->frag[mid][0] <= o) {
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+	*ord = o;
+	return map->frag[lo][1] + (o - map->frag[lo][0]);
+}
+#endif	/* _FS_MINIMIZE <= 2 */
+
+#endif	/* _FS_LINKMAP */
+
+
+
+
 #if !_FS_READONLY
 /*-----------------------------------------------------------------------*/
 /* FAT handling - Remove a cluster chain                                 */
@@ -1283,8 +1663,21 @@ FRESULT remove_chain (	/* FR_OK(0):succeeded, !=0:error */
 #if _USE_TRIM
 	DWORD rt[2];
 #endif
+#if _FS_DIRINDEX
+	UINT i;
+#endif
 
 	if (clst < 2 || clst >= fs->n_fatent) return FR_INT_ERR;	/* Check if in valid range */
+#if _FS_LINKMAP
+	lmap_drop(fs, pclst ? obj->sclust : clst);	/* Link map of the chain gets invalid */
+#endif
+#if _FS_DIRINDEX
+	if (!pclst) {		/* Directory index of the chain gets invalid */
+		for (i = 0; i < _FS_DIRINDEX; i++) {
+			if (fs->xidx[i].sclust == clst) fs->xidx[i].sclust = 0xFFFFFFFF;
+		}
+	}
+#endif
 
 	/* Mark the previous cluster 'EOC' on the FAT if it exists */
 	if (pclst && (!_FS_EXFAT || fs->fs_type != FS_EXFAT || obj->stat != 2)) {
@@ -1301,6 +1694,9 @@ FRESULT remove_chain (	/* FR_OK(0):succeeded, !=0:error */
 		if (!_FS_EXFAT || fs->fs_type != FS_EXFAT) {
 			res = put_fat(fs, clst, 0);		/* Mark the cluster 'free' on the FAT */
 			if (res != FR_OK) return res;
+#if _FS_FATBITMAP
+			fbm_mark(fs, clst, 0);			/* The FAT sector has a free entry now */
+#endif
 		}
 		if (fs->free_clst < fs->n_fatent - 2) {	/* Update FSINFO */
 			fs->free_clst++;
@@ -1354,6 +1750,12 @@ DWORD create_chain (	/* 0:No free cluster, 1:Internal error, 0xFFFFFFFF:Disk err
 )
 {
 	DWORD cs, ncl, scl;
+#if _FS_FATBITMAP
+	DWORD epc, tcl;
+#endif
+#if _FS_CLSTRUN
+	DWORD fcl, rcl, nscan;
+#endif
 	FRESULT res;
 	FATFS *fs = obj->fs;
 
@@ -1369,6 +1771,9 @@ DWORD create_chain (	/* 0:No free cluster, 1:Internal error, 0xFFFFFFFF:Disk err
 		if (cs < fs->n_fatent) return cs;	/* It is already followed by next cluster */
 		scl = clst;
 	}
+#if _FS_CLSTRUN
+	fcl = rcl = nscan = 0;	/* First free cluster, top of the current free run and clusters scanned after fcl */
+#endif
 
 #if _FS_EXFAT
 	if (fs->fs_type == FS_EXFAT) {	/* On the exFAT volume */
@@ -1398,17 +1803,77 @@ DWORD create_chain (	/* 0:No free cluster, 1:Internal error, 0xFFFFFFFF:Disk err
 #endif
 	{	/* On the FAT12/16/32 volume */
 		ncl = scl;	/* Start cluster */
+#if _FS_FATBITMAP
+		epc = SS(fs) / (fs->fs_type == FS_FAT32 ? 4 : 2);	/* Number of FAT entries per sector */
+		tcl = 0;	/* Top cluster of the FAT sector being scanned in whole (0:None) */
+#endif
 		for (;;) {
 			ncl++;							/* Next cluster */
 			if (ncl >= fs->n_fatent) {		/* Check wrap-around */
+#if _FS_FATBITMAP
+				if (tcl) fbm_mark(fs, tcl, 1);	/* Last FAT sector was scanned without a free entry */
+				tcl = 0;
+#endif
+#if _FS_CLSTRUN
+				rcl = 0;					/* A run does not wrap around */
+#endif
 				ncl = 2;
-				if (ncl > scl) return 0;	/* No free cluster */
+				if (ncl > scl) { ncl = 0; break; }	/* Searched all over */
+			}
+#if _FS_FATBITMAP
+			if (ncl % epc == 0) {			/* Top of a FAT sector? */
+				if (tcl) fbm_mark(fs, tcl, 1);	/* Previous FAT sector was scanned without a free entry */
+				tcl = 0;
+				if (fbm_full(fs, ncl)) {	/* Skip the FAT sector known to be full */
+#if _FS_CLSTRUN
+					rcl = 0;
+#endif
+					if (scl - ncl < epc) { ncl = 0; break; }	/* Searched all over (start cluster is in the skipped sector) */
+					ncl += epc - 1;
+					continue;
+				}
+				tcl = ncl;
 			}
+#endif
 			cs = get_fat(obj, ncl);			/* Get the cluster status */
+#if _FS_CLSTRUN
+			if (cs == 0) {					/* Found a free cluster */
+				if (clst == 0 || ncl == clst + 1) break;	/* Take it for a new chain or in place of a growing chain */
+#if _FS_FATBITMAP
+				tcl = 0;					/* The FAT sector has a free entry */
+#endif
+				if (fcl == 0) fcl = ncl;
+				if (rcl == 0) rcl = ncl;
+				if (ncl - rcl + 1 >= _FS_CLSTRUN) {	/* Found a free run for the fragmented chain */
+					ncl = rcl;
+					break;
+				}
+			} else {
+				if (cs == 1 || cs == 0xFFFFFFFF) return cs;	/* An error occurred */
+				rcl = 0;
+				if (clst != 0 && scl == clst && ncl == clst + 1 && fs->last_clst != clst) {	/* The chain cannot grow in place? */
+					scl = fs->last_clst;	/* Search a run from the suggested start, past the runs taken before */
+					if (scl == 0 || scl >= fs->n_fatent) scl = 1;
+					ncl = scl;
+#if _FS_FATBITMAP
+					tcl = 0;
+#endif
+					continue;
+				}
+			}
+			if (ncl == scl || (fcl && ++nscan > SS(fs) / 4)) { ncl = 0; break; }	/* Searched all over or long enough */
+#else
 			if (cs == 0) break;				/* Found a free cluster */
 			if (cs == 1 || cs == 0xFFFFFFFF) return cs;	/* An error occurred */
-			if (ncl == scl) return 0;		/* No free cluster */
+			if (ncl == scl) { ncl = 0; break; }	/* Searched all over */
+#endif
+		}
+#if _FS_CLSTRUN
+		if (ncl == 0) {						/* No free run, take the first free cluster */
+			ncl = fcl; rcl = 0;
 		}
+#endif
+		if (ncl == 0) return 0;				/* No free cluster */
 		res = put_fat(fs, ncl, 0xFFFFFFFF);	/* Mark the new cluster 'EOC' */
 		if (res == FR_OK && clst != 0) {
 			res = put_fat(fs, clst, ncl);	/* Link it from the previous one if needed */
@@ -1416,7 +1881,18 @@ DWORD create_chain (	/* 0:No free cluster, 1:Internal error, 0xFFFFFFFF:Disk err
 	}
 
 	if (res == FR_OK) {			/* Update FSINFO if function succeeded. */
-		fs->last_clst = ncl;
+#if _FS_CLSTRUN
+		if (fs->fs_type != FS_EXFAT && clst != 0 && ncl == clst + 1) {	/* Grew in place on the FAT12/16/32 volume */
+			if (ncl > fs->last_clst || fs->last_clst >= fs->n_fatent) {
+				fs->last_clst = ncl;	/* Do not move it back into a run taken before */
+			}
+		} else if (fs->fs_type != FS_EXFAT && rcl != 0) {	/* Took a free run */
+			fs->last_clst = ncl + _FS_CLSTRUN - 1;	/* New chains start past the run */
+		} else
+#endif
+		{
+			fs->last_clst = ncl;
+		}
 		if (fs->free_clst <= fs->n_fatent - 2) fs->free_clst--;
 		fs->fsi_flag |= 1;
 	} else {
@@ -1463,17 +1939,213 @@ DWORD clmt_clust (	/* <2:Error, >=2:Cluster number */
 
 
 /*-----------------------------------------------------------------------*/
-/* Directory handling - Set directory index                              */
+/* File data transfer - Extend a sector run over contiguous clusters     */
 /*-----------------------------------------------------------------------*/
 
 static
-FRESULT dir_sdi (	/* FR_OK(0):succeeded, !=0:error */
-	DIR* dp,		/* Pointer to directory object */
-	DWORD ofs		/* Offset of directory table */
+UINT coalesce_run (	/* Number of sectors in the run (cc..nsect) */
+	FIL* fp,		/* Pointer to the file object (fp->clust is moved to the last cluster of the run) */
+	UINT cc,		/* Number of sectors left in the current cluster */
+	UINT nsect,		/* Number of sectors wanted */
+	int stretch		/* 1:Stretch the chain at end of the chain (write) */
 )
 {
-	DWORD csz, clst;
-	FATFS *fs = dp->obj.fs;
+	FATFS *fs = fp->obj.fs;
+	DWORD clst;
+#if _USE_FASTSEEK
+	FSIZE_t ofs = fp->fptr + (FSIZE_t)cc * SS(fs);	/* File offset of the next cluster */
+#endif
+
+
+#if _FS_READONLY
+	if (stretch) return cc;		/* No chain to stretch at read-only configuration */
+#endif
+	while (cc < nsect) {
+#if _USE_FASTSEEK
+		if (fp->cltbl) {
+			clst = clmt_clust(fp, ofs);	/* Get next cluster# from the CLMT */
+			ofs += (FSIZE_t)fs->csize * SS(fs);
+		} else
+#endif
+		{
+#if !_FS_READONLY
+			if (stretch) {
+				clst = create_chain(&fp->obj, fp->clust);	/* Follow or stretch cluster chain */
+			} else
+#endif
+			{
+				clst = get_fat(&fp->obj, fp->clust);	/* Follow cluster chain */
+			}
+		}
+		if (clst != fp->clust + 1) break;	/* Not contiguous (gap, end of chain or error is handled by the caller at the cluster boundary) */
+		fp->clust = clst;
+		cc += fs->csize;
+	}
+	return (cc < nsect) ? cc : nsect;
+}
+
+
+
+
+#if _FS_ASYNC && !_FS_TINY
+/*-----------------------------------------------------------------------*/
+/* File data transfer - Asynchronous write-behind and read-ahead         */
+/*-----------------------------------------------------------------------*/
+
+#define ABUF(fp) (((fp)->buf == (fp)->bufs[0]) ? (fp)->bufs[1] : (fp)->bufs[0])	/* Spare sector buffer */
+
+
+static
+FRESULT async_wait (	/* FR_OK(0):succeeded, !=0:error */
+	FIL* fp			/* Pointer to the file object */
+)
+{
+	if (fp->areq.stat != DIO_IDLE) {
+		if (disk_poll(fp->obj.fs->drv, &fp->areq, 1) != RES_OK) return FR_DISK_ERR;	/* Request got stuck */
+		fp->areq.stat = DIO_IDLE;			/* Take the completion */
+		if (fp->areq.res != RES_OK) {
+			fp->asect = 0;					/* Spare buffer has no valid data */
+			if (fp->areq.op == DIO_WRITE) return FR_DISK_ERR;	/* Failed write-behind (a failed read-ahead is not an error) */
+		}
+	}
+	return FR_OK;
+}
+
+
+
+static
+FRESULT async_submit (	/* FR_OK(0):succeeded, !=0:error */
+	FIL* fp,		/* Pointer to the file object */
+	BYTE op,		/* DIO_READ or DIO_WRITE */
+	DWORD sect		/* Sector to be transferred to/from the spare buffer */
+)
+{
+	fp->areq.op = op;
+	fp->areq.buff = ABUF(fp);
+	fp->areq.sector = sect;
+	fp->areq.count = 1;
+	fp->asect = sect;
+	if (disk_submit(fp->obj.fs->drv, &fp->areq) != RES_OK) {	/* Not accepted? */
+		fp->asect = 0;
+		return FR_DISK_ERR;
+	}
+	return FR_OK;
+}
+
+
+
+static
+void async_swap (
+	FIL* fp			/* Pointer to the file object */
+)
+{
+	DWORD sect;
+
+
+	fp->buf = ABUF(fp);		/* Exchange the current and spare buffers with their sector numbers */
+	sect = fp->sect; fp->sect = fp->asect; fp->asect = sect;
+}
+
+
+
+#if !_FS_READONLY
+static
+FRESULT async_flush (	/* FR_OK(0):succeeded, !=0:error */
+	FIL* fp			/* Pointer to the file object */
+)
+{
+	FRESULT res;
+
+
+	res = async_wait(fp);			/* Spare buffer must be free to be the current buffer */
+	if (res != FR_OK) return res;
+	async_swap(fp);					/* Dirty sector goes to the spare buffer */
+	fp->flag &= (BYTE)~FA_DIRTY;
+	return async_submit(fp, DIO_WRITE, fp->asect);	/* Write it back in background */
+}
+#endif
+
+
+
+static
+FRESULT async_load (	/* FR_OK(0):succeeded, !=0:error */
+	FIL* fp,		/* Pointer to the file object */
+	DWORD sect		/* Sector to be loaded into the current buffer */
+)
+{
+	FRESULT res;
+
+
+	if (fp->asect == sect) {		/* Has the sector been read ahead or written behind? */
+		res = async_wait(fp);
+		if (res != FR_OK) return res;
+		if (fp->asect == sect) {	/* Take the spare buffer if the transfer succeeded */
+			async_swap(fp);
+			return FR_OK;
+		}
+	}
+	return (disk_read(fp->obj.fs->drv, fp->buf, sect, 1) == RES_OK) ? FR_OK : FR_DISK_ERR;
+}
+
+
+
+static
+FRESULT async_prefetch (	/* FR_OK(0):succeeded, !=0:error of the preceding write-behind */
+	FIL* fp,		/* Pointer to the file object */
+	DWORD sect		/* Sector to be read ahead */
+)
+{
+	FRESULT res;
+
+
+	if (fp->asect == sect) return FR_OK;	/* Already held or in progress */
+	if (fp->areq.stat != DIO_IDLE) {
+		if (disk_poll(fp->obj.fs->drv, &fp->areq, 0) != RES_OK) return FR_OK;	/* Spare buffer is busy, skip read-ahead */
+		res = async_wait(fp);
+		if (res != FR_OK) return res;
+	}
+	async_submit(fp, DIO_READ, sect);		/* A read-ahead not accepted is not an error */
+	return FR_OK;
+}
+
+
+
+#if !_FS_READONLY
+static
+FRESULT async_discard (	/* FR_OK(0):succeeded, !=0:error */
+	FIL* fp,		/* Pointer to the file object */
+	DWORD sect,		/* Top of the sectors overwritten directly */
+	UINT cc			/* Number of sectors */
+)
+{
+	FRESULT res = FR_OK;
+
+
+	if (fp->asect - sect < cc) {	/* Is the data in the spare buffer outdated? */
+		res = async_wait(fp);
+		fp->asect = 0;
+	}
+	return res;
+}
+#endif
+
+#endif	/* _FS_ASYNC && !_FS_TINY */
+
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Directory handling - Set directory index                              */
+/*-----------------------------------------------------------------------*/
+
+static
+FRESULT dir_sdi (	/* FR_OK(0):succeeded, !=0:error */
+	DIR* dp,		/* Pointer to directory object */
+	DWORD ofs		/* Offset of directory table */
+)
+{
+	DWORD csz, clst;
+	FATFS *fs = dp->obj.fs;
 
 
 	if (ofs >= (DWORD)((_FS_EXFAT && fs->fs_type == FS_EXFAT) ? MAX_DIR_EX : MAX_DIR) || ofs % SZDIRE) {	/* Check range of offset and alignment */
@@ -2190,15 +2862,342 @@ FRESULT dir_read (
 			}
 #endif
 		}
-		res = dir_next(dp, 0);		/* Next entry */
-		if (res != FR_OK) break;
+		res = dir_next(dp, 0);		/* Next entry */
+		if (res != FR_OK) break;
+	}
+
+	if (res != FR_OK) dp->sect = 0;		/* Terminate the read operation on error or EOT */
+	return res;
+}
+
+#endif	/* _FS_MINIMIZE <= 1 || _USE_LABEL || _FS_RPATH >= 2 */
+
+
+
+#if _FS_DIRINDEX
+/*-----------------------------------------------------------------------*/
+/* Directory handling - Name hash index of the directories               */
+/*-----------------------------------------------------------------------*/
+/* Each directory index holds an 8-bit name hash per directory entry of  */
+/* the leading part of a directory. An SFN entry holds the hash of the   */
+/* SFN and the last LFN entry of an item holds the hash of the up-cased  */
+/* LFN. Any other entry holds 0. The index is built while the directory  */
+/* is scanned by dir_find() and kept coherent by dir_register/remove.    */
+
+#define DIDX_HASH(acc)	((BYTE)((acc) % 255 + 1))	/* 8-bit name hash (1..255) of an accumulated hash */
+#if _USE_LFN != 0
+#define DIDX_NLFN	((_MAX_LFN + 12) / 13)	/* Max number of LFN entries of an item */
+#endif
+
+static
+DWORD didx_sum (	/* Accumulated hash */
+	DWORD acc,		/* Hash accumulated so far */
+	WCHAR chr,		/* Character to be added */
+	UINT i			/* Position of the character in the name */
+)
+{
+	return acc + (DWORD)(chr + 1) * ((DWORD)(i + 1) * 0x9E3779B1);
+}
+
+
+
+static
+BYTE didx_sfn (		/* Name hash of an SFN */
+	const BYTE* sfn	/* Pointer to the SFN */
+)
+{
+	DWORD acc = 0;
+	UINT i;
+
+
+	for (i = 0; i < 11; i++) acc = didx_sum(acc, sfn[i], i);
+	return DIDX_HASH(acc);
+}
+
+
+
+#if _USE_LFN != 0
+static
+DWORD didx_lfn (	/* Accumulated hash */
+	DWORD acc,		/* Hash accumulated so far */
+	const BYTE* dir	/* Pointer to the LFN entry */
+)
+{
+	UINT i, s;
+	WCHAR wc;
+
+
+	i = ((dir[LDIR_Ord] & 0x3F) - 1) * 13;	/* Offset of the part in the LFN */
+	for (s = 0; s < 13; s++) {
+		wc = ld_word(dir + LfnOfs[s]);
+		if (wc == 0) break;					/* End of the name */
+		acc = didx_sum(acc, ff_wtoupper(wc), i + s);
+	}
+	return acc;
+}
+
+
+
+static
+BYTE didx_name (		/* Name hash of an LFN */
+	const WCHAR* lfn	/* Pointer to the LFN */
+)
+{
+	DWORD acc = 0;
+	UINT i;
+
+
+	for (i = 0; lfn[i]; i++) acc = didx_sum(acc, ff_wtoupper(lfn[i]), i);
+	return DIDX_HASH(acc);
+}
+#endif
+
+
+
+static
+DIRINDEX* didx_get (	/* 0:Not indexed, !=0:Pointer to the directory index */
+	DIR* dp,		/* Pointer to the directory object */
+	int create		/* 1:Create the index if not exist */
+)
+{
+	FATFS *fs = dp->obj.fs;
+	DIRINDEX *xp, *vp;
+	UINT i;
+
+
+	vp = fs->xidx;
+	for (i = 0; i < _FS_DIRINDEX; i++) {
+		xp = &fs->xidx[i];
+		if (xp->sclust == dp->obj.sclust) {
+			if (create) xp->stamp = ++fs->xstamp;
+			return xp;
+		}
+		if (xp->stamp < vp->stamp) vp = xp;	/* Least recently used one (unused ones have stamp 0) */
+	}
+	if (!create) return 0;
+	vp->sclust = dp->obj.sclust;		/* Start an empty index of the directory */
+	vp->nent = 0;
+	vp->done = 0;
+	vp->stamp = ++fs->xstamp;
+	return vp;
+}
+
+
+
+static
+DIRINDEX* didx_rec (	/* 0:Index is full, !=0:Continue the record */
+	DIRINDEX* xp,	/* Pointer to the directory index */
+	DIR* dp		/* Pointer to the directory object pointing the entry */
+#if _USE_LFN != 0
+	, DWORD* acc	/* Hash of the LFN being accumulated */
+#endif
+)
+{
+	UINT i = dp->dptr / SZDIRE;
+	BYTE *dir = dp->dir, c = dir[DIR_Name], a = dir[DIR_Attr] & AM_MASK, h = 0;
+
+
+	if (i >= _FS_DIRINDEX_SIZE) return 0;
+#if _USE_LFN != 0
+	if (c != DDEM && a == AM_LFN) {		/* An LFN entry (not an item boundary) */
+		if (c & LLEF) *acc = 0;
+		*acc = didx_lfn(*acc, dir);
+		xp->hash[i] = ((c & 0x3F) == 1) ? DIDX_HASH(*acc) : 0;	/* The last LFN entry holds the LFN hash */
+		return xp;
+	}
+#endif
+	if (c != DDEM && !(a & AM_VOL)) h = didx_sfn(dir);	/* An SFN entry holds the SFN hash */
+	xp->hash[i] = h;
+	xp->nent = i + 1;			/* Indexed up to this item */
+	return xp;
+}
+
+#endif	/* _FS_DIRINDEX */
+
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Directory handling - Scan entries for the object name                 */
+/*-----------------------------------------------------------------------*/
+
+static
+FRESULT dir_scan (	/* FR_OK(0):found, FR_NO_FILE:not found, !=0:error */
+	DIR* dp,		/* Pointer to the directory object pointing the entry to start the scan */
+	UINT nent		/* Number of entries to scan (0:up to end of the table) */
+)
+{
+	FRESULT res;
+	FATFS *fs = dp->obj.fs;
+	BYTE c;
+#if _USE_LFN != 0
+	BYTE a, ord, sum;
+#endif
+#if _FS_DIRINDEX
+	DIRINDEX *xp;
+#if _USE_LFN != 0
+	DWORD acc = 0;
+#endif
+
+	xp = didx_get(dp, 0);
+	if (xp && (xp->done || dp->dptr / SZDIRE != xp->nent)) xp = 0;	/* Record the entries only if the scan extends the index */
+#endif
+
+	if (nent == 0) nent = MAX_DIR / SZDIRE;	/* No limit */
+#if _USE_LFN != 0
+	ord = sum = 0xFF; dp->blk_ofs = 0xFFFFFFFF;	/* Reset LFN sequence */
+#endif
+	do {
+		res = move_window(fs, dp->sect);
+		if (res != FR_OK) break;
+		c = dp->dir[DIR_Name];
+		if (c == 0) { res = FR_NO_FILE; break; }	/* Reached to end of table */
+#if _FS_DIRINDEX
+#if _USE_LFN != 0
+		if (xp) xp = didx_rec(xp, dp, &acc);	/* Record the entry into the directory index */
+#else
+		if (xp) xp = didx_rec(xp, dp);			/* Record the entry into the directory index */
+#endif
+#endif
+#if _USE_LFN != 0	/* LFN configuration */
+		dp->obj.attr = a = dp->dir[DIR_Attr] & AM_MASK;
+		if (c == DDEM || ((a & AM_VOL) && a != AM_LFN)) {	/* An entry without valid data */
+			ord = 0xFF; dp->blk_ofs = 0xFFFFFFFF;	/* Reset LFN sequence */
+		} else {
+			if (a == AM_LFN) {			/* An LFN entry is found */
+				if (!(dp->fn[NSFLAG] & NS_NOLFN)) {
+					if (c & LLEF) {		/* Is it start of LFN sequence? */
+						sum = dp->dir[LDIR_Chksum];
+						c &= (BYTE)~LLEF; ord = c;	/* LFN start order */
+						dp->blk_ofs = dp->dptr;	/* Start offset of LFN */
+					}
+					/* Check validity of the LFN entry and compare it with given name */
+					ord = (c == ord && sum == dp->dir[LDIR_Chksum] && cmp_lfn(fs->lfnbuf, dp->dir)) ? ord - 1 : 0xFF;
+				}
+			} else {					/* An SFN entry is found */
+				if (!ord && sum == sum_sfn(dp->dir)) break;	/* LFN matched? */
+				if (!(dp->fn[NSFLAG] & NS_LOSS) && !mem_cmp(dp->dir, dp->fn, 11)) break;	/* SFN matched? */
+				ord = 0xFF; dp->blk_ofs = 0xFFFFFFFF;	/* Reset LFN sequence */
+			}
+		}
+#else		/* Non LFN configuration */
+		dp->obj.attr = dp->dir[DIR_Attr] & AM_MASK;
+		if (!(dp->dir[DIR_Attr] & AM_VOL) && !mem_cmp(dp->dir, dp->fn, 11)) break;	/* Is it a valid entry? */
+#endif
+		res = dir_next(dp, 0);	/* Next entry */
+	} while (res == FR_OK && --nent);
+
+	if (res == FR_OK && nent == 0) res = FR_NO_FILE;	/* Scanned the given number of entries */
+#if _FS_DIRINDEX
+	if (res == FR_NO_FILE && xp) xp->done = 1;	/* The index covers the whole directory */
+#endif
+	return res;
+}
+
+
+
+#if _FS_DIRINDEX
+static
+FRESULT didx_find (	/* FR_OK(0):found, FR_NO_FILE:not in the indexed part, !=0:error */
+	DIR* dp,		/* Pointer to the directory object with the file name */
+	DIRINDEX* xp	/* Pointer to the directory index */
+)
+{
+	FRESULT res;
+	BYTE h, hs = 0, hl = 0;
+	UINT i, st, ed, nl = 0;
+
+
+	if (!(dp->fn[NSFLAG] & NS_LOSS)) hs = didx_sfn(dp->fn);	/* SFN hash to find */
+#if _USE_LFN != 0
+	if (!(dp->fn[NSFLAG] & NS_NOLFN)) {
+		hl = didx_name(dp->obj.fs->lfnbuf);					/* LFN hash to find */
+		for (nl = 0; dp->obj.fs->lfnbuf[nl]; nl++) ;
+		nl = (nl + 12) / 13;								/* Number of LFN entries of the name */
+	}
+#endif
+	for (i = 0; i < xp->nent; i++) {
+		h = xp->hash[i];
+		if (h == 0) continue;
+		ed = 0;
+		if (h == hs) {				/* SFN candidate, scan from the top of the LFN block it may have */
+#if _USE_LFN != 0
+			st = (i < DIDX_NLFN) ? 0 : i - DIDX_NLFN;
+#else
+			st = i;					/* No LFN block at non-LFN configuration */
+#endif
+			ed = i + 1;
+		}
+		if (h == hl && i + 1 >= nl) {	/* LFN candidate, scan the entry block up to the SFN entry */
+			if (!ed) st = i + 1 - nl;
+			ed = i + 2;
+		}
+		if (!ed) continue;
+		res = dir_sdi(dp, st * SZDIRE);
+		if (res == FR_OK) res = dir_scan(dp, ed - st);
+		if (res != FR_NO_FILE) return res;	/* Found or error */
 	}
+	return FR_NO_FILE;
+}
 
-	if (res != FR_OK) dp->sect = 0;		/* Terminate the read operation on error or EOT */
-	return res;
+
+
+#if !_FS_READONLY
+static
+void didx_put (
+	DIR* dp,		/* Pointer to the directory object pointing the registered SFN entry */
+	UINT nlfn		/* Number of LFN entries preceding the SFN entry */
+)
+{
+	DIRINDEX *xp;
+	UINT i, s;
+
+
+	xp = didx_get(dp, 0);
+	if (!xp) return;
+	i = dp->dptr / SZDIRE;
+	if (i >= xp->nent) {			/* Beyond the indexed part? */
+		if (!xp->done || i >= _FS_DIRINDEX_SIZE) {	/* Let the scan record it */
+			if (i - nlfn < xp->nent) xp->nent = i - nlfn;
+			xp->done = 0;
+			return;
+		}
+		for (s = xp->nent; s < i; s++) xp->hash[s] = 0;	/* Extend the index over the free entries */
+		xp->nent = i + 1;
+	}
+	for (s = i - nlfn; s < i; s++) xp->hash[s] = 0;
+	xp->hash[i] = didx_sfn(dp->fn);
+#if _USE_LFN != 0
+	if (nlfn) xp->hash[i - 1] = didx_name(dp->obj.fs->lfnbuf);
+#endif
 }
 
-#endif	/* _FS_MINIMIZE <= 1 || _USE_LABEL || _FS_RPATH >= 2 */
+
+
+#if _FS_MINIMIZE == 0
+static
+void didx_del (
+	DIR* dp			/* Pointer to the directory object pointing the entry to be removed */
+)
+{
+	DIRINDEX *xp;
+	UINT i;
+
+
+	xp = didx_get(dp, 0);
+	if (!xp) return;
+#if _USE_LFN != 0
+	i = (dp->blk_ofs == 0xFFFFFFFF) ? dp->dptr / SZDIRE : dp->blk_ofs / SZDIRE;
+#else
+	i = dp->dptr / SZDIRE;
+#endif
+	for ( ; i <= dp->dptr / SZDIRE && i < xp->nent; i++) xp->hash[i] = 0;
+}
+#endif	/* _FS_MINIMIZE == 0 */
+#endif
+
+#endif	/* _FS_DIRINDEX */
+
 
 
 
@@ -2212,10 +3211,11 @@ FRESULT dir_find (	/* FR_OK(0):succeeded, !=0:error */
 )
 {
 	FRESULT res;
+#if _FS_EXFAT
 	FATFS *fs = dp->obj.fs;
-	BYTE c;
-#if _USE_LFN != 0
-	BYTE a, ord, sum;
+#endif
+#if _FS_DIRINDEX
+	DIRINDEX *xp;
 #endif
 
 	res = dir_sdi(dp, 0);			/* Rewind directory object */
@@ -2241,43 +3241,14 @@ FRESULT dir_find (	/* FR_OK(0):succeeded, !=0:error */
 	}
 #endif
 	/* On the FAT12/16/32 volume */
-#if _USE_LFN != 0
-	ord = sum = 0xFF; dp->blk_ofs = 0xFFFFFFFF;	/* Reset LFN sequence */
-#endif
-	do {
-		res = move_window(fs, dp->sect);
-		if (res != FR_OK) break;
-		c = dp->dir[DIR_Name];
-		if (c == 0) { res = FR_NO_FILE; break; }	/* Reached to end of table */
-#if _USE_LFN != 0	/* LFN configuration */
-		dp->obj.attr = a = dp->dir[DIR_Attr] & AM_MASK;
-		if (c == DDEM || ((a & AM_VOL) && a != AM_LFN)) {	/* An entry without valid data */
-			ord = 0xFF; dp->blk_ofs = 0xFFFFFFFF;	/* Reset LFN sequence */
-		} else {
-			if (a == AM_LFN) {			/* An LFN entry is found */
-				if (!(dp->fn[NSFLAG] & NS_NOLFN)) {
-					if (c & LLEF) {		/* Is it start of LFN sequence? */
-						sum = dp->dir[LDIR_Chksum];
-						c &= (BYTE)~LLEF; ord = c;	/* LFN start order */
-						dp->blk_ofs = dp->dptr;	/* Start offset of LFN */
-					}
-					/* Check validity of the LFN entry and compare it with given name */
-					ord = (c == ord && sum == dp->dir[LDIR_Chksum] && cmp_lfn(fs->lfnbuf, dp->dir)) ? ord - 1 : 0xFF;
-				}
-			} else {					/* An SFN entry is found */
-				if (!ord && sum == sum_sfn(dp->dir)) break;	/* LFN matched? */
-				if (!(dp->fn[NSFLAG] & NS_LOSS) && !mem_cmp(dp->dir, dp->fn, 11)) break;	/* SFN matched? */
-				ord = 0xFF; dp->blk_ofs = 0xFFFFFFFF;	/* Reset LFN sequence */
-			}
-		}
-#else		/* Non LFN configuration */
-		dp->obj.attr = dp->dir[DIR_Attr] & AM_MASK;
-		if (!(dp->dir[DIR_Attr] & AM_VOL) && !mem_cmp(dp->dir, dp->fn, 11)) break;	/* Is it a valid entry? */
+#if _FS_DIRINDEX
+	xp = didx_get(dp, 1);			/* Directory index of the directory */
+	res = didx_find(dp, xp);		/* Check the candidates in the indexed part */
+	if (res != FR_NO_FILE || xp->done) return res;
+	res = dir_sdi(dp, xp->nent * SZDIRE);	/* Scan the rest of the directory */
+	if (res != FR_OK) return res;
 #endif
-		res = dir_next(dp, 0);	/* Next entry */
-	} while (res == FR_OK);
-
-	return res;
+	return dir_scan(dp, 0);
 }
 
 
@@ -2377,6 +3348,13 @@ FRESULT dir_register (	/* FR_OK:succeeded, FR_DENIED:no free entry or too many S
 			dp->dir[DIR_NTres] = dp->fn[NSFLAG] & (NS_BODY | NS_EXT);	/* Put NT flag */
 #endif
 			fs->wflag = 1;
+#if _FS_DIRINDEX
+#if _USE_LFN != 0
+			didx_put(dp, (sn[NSFLAG] & NS_LFN) ? (nlen + 12) / 13 : 0);	/* Record the entry block into the directory index */
+#else
+			didx_put(dp, 0);
+#endif
+#endif
 		}
 	}
 
@@ -2402,6 +3380,9 @@ FRESULT dir_remove (	/* FR_OK:Succeeded, FR_DISK_ERR:A disk error */
 #if _USE_LFN != 0	/* LFN configuration */
 	DWORD last = dp->dptr;
 
+#if _FS_DIRINDEX
+	didx_del(dp);		/* Remove the entry block from the directory index */
+#endif
 	res = (dp->blk_ofs == 0xFFFFFFFF) ? FR_OK : dir_sdi(dp, dp->blk_ofs);	/* Goto top of the entry block if LFN is exist */
 	if (res == FR_OK) {
 		do {
@@ -2421,6 +3402,9 @@ FRESULT dir_remove (	/* FR_OK:Succeeded, FR_DISK_ERR:A disk error */
 	}
 #else			/* Non LFN configuration */
 
+#if _FS_DIRINDEX
+	didx_del(dp);		/* Remove the entry from the directory index */
+#endif
 	res = move_window(fs, dp->sect);
 	if (res == FR_OK) {
 		dp->dir[DIR_Name] = DDEM;
@@ -2968,6 +3952,9 @@ BYTE check_fs (	/* 0:FAT, 1:exFAT, 2:Valid BS but not FAT, 3:Not a BS, 4:Disk er
 )
 {
 	fs->wflag = 0; fs->winsect = 0xFFFFFFFF;		/* Invaidate window */
+#if _FS_WINCACHE
+	cache_reset(fs);								/* Invalidate sector cache */
+#endif
 	if (move_window(fs, sect) != FR_OK) return 4;	/* Load boot record */
 
 	if (ld_word(fs->win + BS_55AA) != 0xAA55) return 3;	/* Check boot record signature (always placed here even if the sector size is >512) */
@@ -3166,6 +4153,9 @@ FRESULT find_volume (	/* FR_OK(0): successful, !=0: any error occurred */
 		/* Get FSINFO if available */
 		fs->last_clst = fs->free_clst = 0xFFFFFFFF;		/* Initialize cluster allocation information */
 		fs->fsi_flag = 0x80;
+#if _FS_FATBITMAP
+		mem_set(fs->fbmp, 0, _FS_FATBITMAP);			/* No FAT sector is known to be full */
+#endif
 #if (_FS_NOFSINFO & 3) != 3
 		if (fmt == FS_FAT32				/* Enable FSINFO only if FAT32 and BPB_FSInfo32 == 1 */
 			&& ld_word(fs->win + BPB_FSInfo32) == 1
@@ -3201,6 +4191,17 @@ FRESULT find_volume (	/* FR_OK(0): successful, !=0: any error occurred */
 #endif
 #if _FS_LOCK != 0			/* Clear file lock semaphores */
 	clear_lock(fs);
+#endif
+#if _FS_LINKMAP
+	mem_set(fs->lmap, 0, sizeof fs->lmap);	/* Discard link maps of the previous mount */
+	fs->lstamp = 0;
+#endif
+#if _FS_DIRINDEX
+	for (i = 0; i < _FS_DIRINDEX; i++) {	/* Discard directory indexes of the previous mount */
+		fs->xidx[i].sclust = 0xFFFFFFFF;
+		fs->xidx[i].stamp = 0;
+	}
+	fs->xstamp = 0;
 #endif
 	return FR_OK;
 }
@@ -3465,6 +4466,11 @@ FRESULT f_open (
 			fp->err = 0;			/* Clear error flag */
 			fp->sect = 0;			/* Invalidate current data sector */
 			fp->fptr = 0;			/* Set file pointer top of the file */
+#if _FS_ASYNC && !_FS_TINY
+			fp->buf = fp->bufs[0];	/* Initialize sector buffers */
+			fp->asect = 0;
+			fp->areq.stat = DIO_IDLE;
+#endif
 #if !_FS_READONLY
 #if !_FS_TINY
 			mem_set(fp->buf, 0, _MAX_SS);	/* Clear sector buffer */
@@ -3556,12 +4562,15 @@ FRESULT f_read (
 			sect += csect;
 			cc = btr / SS(fs);					/* When remaining bytes >= sector size, */
 			if (cc) {							/* Read maximum contiguous sectors directly */
-				if (csect + cc > fs->csize) {	/* Clip at cluster boundary */
-					cc = fs->csize - csect;
+				if (csect + cc > fs->csize) {	/* Clip at cluster boundary unless following clusters are contiguous */
+					cc = coalesce_run(fp, fs->csize - csect, cc, 0);
 				}
 				if (disk_read(fs->drv, rbuff, sect, cc) != RES_OK) ABORT(fs, FR_DISK_ERR);
 #if !_FS_READONLY && _FS_MINIMIZE <= 2			/* Replace one of the read sectors with cached data if it contains a dirty sector */
 #if _FS_TINY
+#if _FS_WINCACHE
+				cache_overlay(fs, rbuff, sect, cc);
+#endif
 				if (fs->wflag && fs->winsect - sect < cc) {
 					mem_cpy(rbuff + ((fs->winsect - sect) * SS(fs)), fs->win, SS(fs));
 				}
@@ -3576,6 +4585,16 @@ FRESULT f_read (
 			}
 #if !_FS_TINY
 			if (fp->sect != sect) {			/* Load data sector if not in cache */
+#if _FS_ASYNC
+#if !_FS_READONLY
+				if (fp->flag & FA_DIRTY) {		/* Write-back dirty sector cache in background */
+					res = async_flush(fp);
+					if (res != FR_OK) ABORT(fs, res);
+				}
+#endif
+				res = async_load(fp, sect);		/* Fill sector cache, from the spare buffer if read ahead */
+				if (res != FR_OK) ABORT(fs, res);
+#else
 #if !_FS_READONLY
 				if (fp->flag & FA_DIRTY) {		/* Write-back dirty sector cache */
 					if (disk_write(fs->drv, fp->buf, fp->sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
@@ -3583,7 +4602,14 @@ FRESULT f_read (
 				}
 #endif
 				if (disk_read(fs->drv, fp->buf, sect, 1) != RES_OK)	ABORT(fs, FR_DISK_ERR);	/* Fill sector cache */
+#endif
+			}
+#if _FS_ASYNC
+			if (csect + 1 < fs->csize && fp->fptr + SS(fs) < fp->obj.objsize) {	/* Read ahead the next sector in the cluster */
+				res = async_prefetch(fp, sect + 1);
+				if (res != FR_OK) ABORT(fs, res);
 			}
+#endif
 #endif
 			fp->sect = sect;
 		}
@@ -3660,6 +4686,11 @@ FRESULT f_write (
 			}
 #if _FS_TINY
 			if (fs->winsect == fp->sect && sync_window(fs) != FR_OK) ABORT(fs, FR_DISK_ERR);	/* Write-back sector cache */
+#elif _FS_ASYNC
+			if (fp->flag & FA_DIRTY) {		/* Write-back sector cache in background */
+				res = async_flush(fp);
+				if (res != FR_OK) ABORT(fs, res);
+			}
 #else
 			if (fp->flag & FA_DIRTY) {		/* Write-back sector cache */
 				if (disk_write(fs->drv, fp->buf, fp->sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
@@ -3671,10 +4702,17 @@ FRESULT f_write (
 			sect += csect;
 			cc = btw / SS(fs);				/* When remaining bytes >= sector size, */
 			if (cc) {						/* Write maximum contiguous sectors directly */
-				if (csect + cc > fs->csize) {	/* Clip at cluster boundary */
-					cc = fs->csize - csect;
+				if (csect + cc > fs->csize) {	/* Clip at cluster boundary unless following clusters are contiguous */
+					cc = coalesce_run(fp, fs->csize - csect, cc, 1);
 				}
+#if _FS_ASYNC && !_FS_TINY
+				res = async_discard(fp, sect, cc);	/* Spare buffer gets outdated by the direct write */
+				if (res != FR_OK) ABORT(fs, res);
+#endif
 				if (disk_write(fs->drv, wbuff, sect, cc) != RES_OK) ABORT(fs, FR_DISK_ERR);
+#if _FS_WINCACHE
+				cache_update(fs, wbuff, sect, cc);	/* Keep the sector cache coherent with the direct write */
+#endif
 #if _FS_MINIMIZE <= 2
 #if _FS_TINY
 				if (fs->winsect - sect < cc) {	/* Refill sector cache if it gets invalidated by the direct write */
@@ -3696,6 +4734,11 @@ FRESULT f_write (
 				if (sync_window(fs) != FR_OK) ABORT(fs, FR_DISK_ERR);
 				fs->winsect = sect;
 			}
+#elif _FS_ASYNC
+			if (fp->sect != sect && fp->fptr < fp->obj.objsize) {	/* Fill sector cache with file data */
+				res = async_load(fp, sect);
+				if (res != FR_OK) ABORT(fs, res);
+			}
 #else
 			if (fp->sect != sect && 		/* Fill sector cache with file data */
 				fp->fptr < fp->obj.objsize &&
@@ -3750,6 +4793,9 @@ FRESULT f_sync (
 				if (disk_write(fs->drv, fp->buf, fp->sect, 1) != RES_OK) LEAVE_FF(fs, FR_DISK_ERR);
 				fp->flag &= (BYTE)~FA_DIRTY;
 			}
+#if _FS_ASYNC
+			if (async_wait(fp) != FR_OK) LEAVE_FF(fs, FR_DISK_ERR);	/* Complete the write-behind */
+#endif
 #endif
 			/* Update the directory entry */
 			tm = GET_FATTIME();				/* Modified time */
@@ -3824,6 +4870,9 @@ FRESULT f_close (
 	{
 		res = validate(&fp->obj, &fs);	/* Lock volume */
 		if (res == FR_OK) {
+#if _FS_ASYNC && !_FS_TINY
+			async_wait(fp);				/* The spare buffer must not be in use after close */
+#endif
 #if _FS_LOCK != 0
 			res = dec_lock(fp->obj.lockid);	/* Decrement file open counter */
 			if (res == FR_OK)
@@ -3842,6 +4891,252 @@ FRESULT f_close (
 
 
 
+#if _USE_STREAM
+/*-----------------------------------------------------------------------*/
+/* Scatter/Gather File Transfer                                          */
+/*-----------------------------------------------------------------------*/
+
+static
+FRESULT stream_run (
+	FIL* fp,			/* Pointer to the file object */
+	const FFSEG* seg,	/* Current segment of the scatter/gather list */
+	UINT nseg,			/* Number of segments left in the list */
+	UINT ofs,			/* Offset in the current segment */
+	int wr,				/* 0:Read, 1:Write */
+	UINT* xfer,			/* Pointer to number of bytes transferred directly */
+	UINT* part			/* Pointer to number of bytes to be transferred via the sector buffer */
+)
+{
+	FRESULT res;
+	FATFS *fs;
+	DWORD clst, sect;
+	FSIZE_t lim;
+	UINT i, n, cc, csect, nv, run;
+	DSEG vec[_FS_STREAM_NSEG];
+
+
+	*xfer = *part = 0;
+	res = validate(&fp->obj, &fs);				/* Check validity of the file object */
+	if (res != FR_OK || (res = (FRESULT)fp->err) != FR_OK) LEAVE_FF(fs, res);	/* Check validity */
+	if (!(fp->flag & (wr ? FA_WRITE : FA_READ))) LEAVE_FF(fs, FR_DENIED);	/* Check access mode */
+	if (wr) {	/* Bytes until fptr wrap-around (file size cannot reach 4GiB on FATxx) */
+		lim = ((!_FS_EXFAT || fs->fs_type != FS_EXFAT) ? 0xFFFFFFFF : (FSIZE_t)0 - 1) - fp->fptr;
+	} else {	/* Remaining bytes in the file */
+		lim = fp->obj.objsize - fp->fptr;
+	}
+
+	n = seg->len - ofs;
+	if (fp->fptr % SS(fs) != 0 || n < SS(fs) || lim < SS(fs)) {	/* Not a whole sector to transfer? */
+		cc = SS(fs) - (UINT)fp->fptr % SS(fs);
+		*part = (n < cc) ? n : cc;				/* Let f_read/f_write handle the partial sector */
+		LEAVE_FF(fs, FR_OK);
+	}
+
+	/* Get the sector at the file pointer */
+	csect = (UINT)(fp->fptr / SS(fs) & (fs->csize - 1));	/* Sector offset in the cluster */
+	if (csect == 0) {							/* On the cluster boundary? */
+		if (fp->fptr == 0) {					/* On the top of the file? */
+			clst = fp->obj.sclust;				/* Follow cluster chain from the origin */
+#if !_FS_READONLY
+			if (clst == 0 && wr) {				/* If no cluster is allocated, */
+				clst = create_chain(&fp->obj, 0);	/* create a new cluster chain */
+			}
+#endif
+		} else {								/* Middle or end of the file */
+#if _USE_FASTSEEK
+			if (fp->cltbl) {
+				clst = clmt_clust(fp, fp->fptr);	/* Get cluster# from the CLMT */
+			} else
+#endif
+#if !_FS_READONLY
+			if (wr) {
+				clst = create_chain(&fp->obj, fp->clust);	/* Follow or stretch cluster chain on the FAT */
+			} else
+#endif
+			{
+				clst = get_fat(&fp->obj, fp->clust);	/* Follow cluster chain on the FAT */
+			}
+		}
+		if (clst == 0 && wr) LEAVE_FF(fs, FR_OK);	/* Could not allocate a new cluster (disk full) */
+		if (clst < 2) ABORT(fs, FR_INT_ERR);
+		if (clst == 0xFFFFFFFF) ABORT(fs, FR_DISK_ERR);
+		fp->clust = clst;						/* Update current cluster */
+		if (fp->obj.sclust == 0) fp->obj.sclust = clst;	/* Set start cluster if the first write */
+	}
+#if !_FS_READONLY
+#if _FS_TINY
+	if (wr && fs->winsect == fp->sect && sync_window(fs) != FR_OK) ABORT(fs, FR_DISK_ERR);	/* Write-back sector cache */
+#else
+	if (wr && (fp->flag & FA_DIRTY)) {			/* Write-back sector cache */
+		if (disk_write(fs->drv, fp->buf, fp->sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
+		fp->flag &= (BYTE)~FA_DIRTY;
+	}
+#endif
+#endif
+	sect = clust2sect(fs, fp->clust);			/* Get current sector */
+	if (!sect) ABORT(fs, FR_INT_ERR);
+	sect += csect;
+
+	/* Gather whole sectors from the following segments while they are sector multiples */
+	lim /= SS(fs);
+	for (nv = 0, run = 0; nseg && nv < _FS_STREAM_NSEG; seg++, nseg--, ofs = 0) {
+		n = seg->len - ofs;
+		cc = n / SS(fs);
+		if (cc > lim - run) cc = (UINT)(lim - run);
+		if (cc == 0) break;
+		vec[nv].buff = (BYTE*)seg->buff + ofs;
+		vec[nv++].count = cc;
+		run += cc;
+		if (cc * SS(fs) != n) break;			/* The segment ends in the middle of a sector */
+	}
+
+	/* Clip the run at the end of contiguous clusters and trim the list to the run */
+	cc = fs->csize - csect;
+	if (cc < run) run = coalesce_run(fp, cc, run, wr);
+	for (i = 0, n = 0; i < nv; i++) {
+		if (n + vec[i].count >= run) {
+			vec[i].count = run - n;
+			nv = i + 1;
+			break;
+		}
+		n += vec[i].count;
+	}
+
+	if (wr) {
+#if !_FS_READONLY
+#if _FS_ASYNC && !_FS_TINY
+		res = async_discard(fp, sect, run);			/* Spare buffer gets outdated by the direct write */
+		if (res != FR_OK) ABORT(fs, res);
+#endif
+		if (disk_writev(fs->drv, vec, nv, sect) != RES_OK) ABORT(fs, FR_DISK_ERR);
+		for (i = 0, n = 0; i < nv; n += vec[i].count, i++) {	/* Refill sector caches invalidated by the direct write */
+#if _FS_WINCACHE
+			cache_update(fs, vec[i].buff, sect + n, vec[i].count);
+#endif
+#if _FS_TINY
+			if (fs->winsect - (sect + n) < vec[i].count) {
+				mem_cpy(fs->win, vec[i].buff + ((fs->winsect - (sect + n)) * SS(fs)), SS(fs));
+				fs->wflag = 0;
+			}
+#else
+			if (fp->sect - (sect + n) < vec[i].count) {
+				mem_cpy(fp->buf, vec[i].buff + ((fp->sect - (sect + n)) * SS(fs)), SS(fs));
+				fp->flag &= (BYTE)~FA_DIRTY;
+			}
+#endif
+		}
+		fp->fptr += (FSIZE_t)run * SS(fs);
+		if (fp->fptr > fp->obj.objsize) fp->obj.objsize = fp->fptr;
+		fp->flag |= FA_MODIFIED;				/* Set file change flag */
+#endif
+	} else {
+		if (disk_readv(fs->drv, vec, nv, sect) != RES_OK) ABORT(fs, FR_DISK_ERR);
+#if !_FS_READONLY && _FS_MINIMIZE <= 2
+		for (i = 0, n = 0; i < nv; n += vec[i].count, i++) {	/* Replace sectors with cached data if they are dirty */
+#if _FS_TINY
+#if _FS_WINCACHE
+			cache_overlay(fs, vec[i].buff, sect + n, vec[i].count);
+#endif
+			if (fs->wflag && fs->winsect - (sect + n) < vec[i].count) {
+				mem_cpy(vec[i].buff + ((fs->winsect - (sect + n)) * SS(fs)), fs->win, SS(fs));
+			}
+#else
+			if ((fp->flag & FA_DIRTY) && fp->sect - (sect + n) < vec[i].count) {
+				mem_cpy(vec[i].buff + ((fp->sect - (sect + n)) * SS(fs)), fp->buf, SS(fs));
+			}
+#endif
+		}
+#endif
+		fp->fptr += (FSIZE_t)run * SS(fs);
+	}
+	*xfer = run * SS(fs);
+
+	LEAVE_FF(fs, FR_OK);
+}
+
+
+
+FRESULT f_read_stream (
+	FIL* fp,			/* Pointer to the file object */
+	const FFSEG* seg,	/* Scatter list of the buffers to store read data */
+	UINT nseg,			/* Number of segments in the list */
+	UINT* br			/* Pointer to number of bytes read */
+)
+{
+	FRESULT res = FR_OK;
+	UINT ofs, n, rc, pc;
+
+
+	*br = 0;	/* Clear read byte counter */
+	for (ofs = 0; nseg; ) {
+		if (ofs >= seg->len) {					/* Go to next segment */
+			seg++; nseg--; ofs = 0;
+			continue;
+		}
+		res = stream_run(fp, seg, nseg, ofs, 0, &rc, &pc);	/* Read whole sectors directly into the list */
+		if (res != FR_OK) break;
+		if (pc) {								/* Read partial sector via the file buffer */
+			res = f_read(fp, (BYTE*)seg->buff + ofs, pc, &rc);
+			if (res != FR_OK) break;
+		}
+		if (rc == 0) break;						/* End of file */
+		for (*br += rc; rc; rc -= n) {			/* Advance the position in the list */
+			if (ofs == seg->len) {
+				seg++; nseg--; ofs = 0;
+			}
+			n = seg->len - ofs;
+			if (n > rc) n = rc;
+			ofs += n;
+		}
+	}
+	return res;
+}
+
+
+
+#if !_FS_READONLY
+FRESULT f_write_stream (
+	FIL* fp,			/* Pointer to the file object */
+	const FFSEG* seg,	/* Gather list of the data to be written */
+	UINT nseg,			/* Number of segments in the list */
+	UINT* bw			/* Pointer to number of bytes written */
+)
+{
+	FRESULT res = FR_OK;
+	UINT ofs, n, wc, pc;
+
+
+	*bw = 0;	/* Clear write byte counter */
+	for (ofs = 0; nseg; ) {
+		if (ofs >= seg->len) {					/* Go to next segment */
+			seg++; nseg--; ofs = 0;
+			continue;
+		}
+		res = stream_run(fp, seg, nseg, ofs, 1, &wc, &pc);	/* Write whole sectors directly from the list */
+		if (res != FR_OK) break;
+		if (pc) {								/* Write partial sector via the file buffer */
+			res = f_write(fp, (const BYTE*)seg->buff + ofs, pc, &wc);
+			if (res != FR_OK) break;
+		}
+		if (wc == 0) break;						/* Disk full */
+		for (*bw += wc; wc; wc -= n) {			/* Advance the position in the list */
+			if (ofs == seg->len) {
+				seg++; nseg--; ofs = 0;
+			}
+			n = seg->len - ofs;
+			if (n > wc) n = wc;
+			ofs += n;
+		}
+	}
+	return res;
+}
+#endif	/* !_FS_READONLY */
+
+#endif	/* _USE_STREAM */
+
+
+
+
 #if _FS_RPATH >= 1
 /*-----------------------------------------------------------------------*/
 /* Change Current Directory or Current Drive, Get Current Directory      */
@@ -4010,6 +5305,9 @@ FRESULT f_lseek (
 #if _USE_FASTSEEK
 	DWORD cl, pcl, ncl, tcl, dsc, tlen, ulen, *tbl;
 #endif
+#if _FS_LINKMAP
+	DWORD lcl, lord;
+#endif
 
 	res = validate(&fp->obj, &fs);		/* Check validity of the file object */
 	if (res == FR_OK) res = (FRESULT)fp->err;
@@ -4063,7 +5361,12 @@ FRESULT f_lseek (
 						fp->flag &= (BYTE)~FA_DIRTY;
 					}
 #endif
+#if _FS_ASYNC
+					res = async_load(fp, dsc);		/* Load current sector */
+					if (res != FR_OK) ABORT(fs, res);
+#else
 					if (disk_read(fs->drv, fp->buf, dsc, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);	/* Load current sector */
+#endif
 #endif
 					fp->sect = dsc;
 				}
@@ -4101,6 +5404,17 @@ FRESULT f_lseek (
 #endif
 				fp->clust = clst;
 			}
+#if _FS_LINKMAP
+			if (clst != 0 && ofs > bcs) {				/* Skip the clusters found in the link map */
+				lord = (DWORD)((fp->fptr + ofs - 1) / bcs);	/* Order of the target cluster */
+				lcl = lmap_clust(fp, &lord);
+				if (lcl >= 2 && lord > fp->fptr / bcs) {
+					ofs -= (FSIZE_t)lord * bcs - fp->fptr;
+					fp->fptr = (FSIZE_t)lord * bcs;
+					clst = fp->clust = lcl;
+				}
+			}
+#endif
 			if (clst != 0) {
 				while (ofs > bcs) {						/* Cluster following loop */
 					ofs -= bcs; fp->fptr += bcs;
@@ -4143,7 +5457,12 @@ FRESULT f_lseek (
 				fp->flag &= (BYTE)~FA_DIRTY;
 			}
 #endif
+#if _FS_ASYNC
+			res = async_load(fp, nsect);		/* Fill sector cache */
+			if (res != FR_OK) ABORT(fs, res);
+#else
 			if (disk_read(fs->drv, fp->buf, nsect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);	/* Fill sector cache */
+#endif
 #endif
 			fp->sect = nsect;
 		}
@@ -4394,6 +5713,9 @@ FRESULT f_getfree (
 	FRESULT res;
 	FATFS *fs;
 	DWORD nfree, clst, sect, stat;
+#if _FS_FATBITMAP
+	DWORD nsf = 0;
+#endif
 	UINT i;
 	BYTE *p;
 	_FDID obj;
@@ -4441,6 +5763,10 @@ FRESULT f_getfree (
 					i = 0; p = 0;
 					do {
 						if (i == 0) {
+#if _FS_FATBITMAP
+							if (p) fbm_mark(fs, fs->n_fatent - clst - 1, nfree == nsf);	/* Record if the previous FAT sector has no free entry */
+							nsf = nfree;
+#endif
 							res = move_window(fs, sect++);
 							if (res != FR_OK) break;
 							p = fs->win;
@@ -4454,6 +5780,9 @@ FRESULT f_getfree (
 							p += 4; i -= 4;
 						}
 					} while (--clst);
+#if _FS_FATBITMAP
+					if (res == FR_OK && p) fbm_mark(fs, fs->n_fatent - 1, nfree == nsf);
+#endif
 				}
 			}
 			*nclst = nfree;			/* Return the free clusters */
@@ -4508,6 +5837,12 @@ FRESULT f_truncate (
 				fp->flag &= (BYTE)~FA_DIRTY;
 			}
 		}
+#if _FS_ASYNC
+		if (res == FR_OK) {		/* Spare buffer may hold a sector of the removed clusters */
+			res = async_wait(fp);
+			fp->asect = 0;
+		}
+#endif
 #endif
 		if (res != FR_OK) ABORT(fs, res);
 	}
@@ -4671,6 +6006,7 @@ FRESULT f_mkdir (
 					if (res != FR_OK) break;
 					mem_set(dir, 0, SS(fs));
 				}
+				if (res == FR_OK) fs->winsect = 0xFFFFFFFF;	/* Invalidate window (its content has been cleared) */
 			}
 			if (res == FR_OK) {
 				res = dir_register(&dj);	/* Register the object to the directoy */
@@ -5276,7 +6612,12 @@ FRESULT f_forward (
 				fp->flag &= (BYTE)~FA_DIRTY;
 			}
 #endif
+#if _FS_ASYNC
+			res = async_load(fp, sect);
+			if (res != FR_OK) ABORT(fs, res);
+#else
 			if (disk_read(fs->drv, fp->buf, sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
+#endif
 		}
 		dbuf = fp->buf;
 #endif
@@ -32,6 +32,31 @@ extern "C" {
 #error Wrong configuration file (ffconf.h).
 #endif
 
+#ifndef _FS_WINCACHE
+#define _FS_WINCACHE	0	/* Sector cache is disabled if not configured in ffconf.h */
+#endif
+#ifndef _USE_STREAM
+#define _USE_STREAM	0	/* Scatter/gather file transfer is disabled if not configured in ffconf.h */
+#endif
+#ifndef _FS_FATBITMAP
+#define _FS_FATBITMAP	0	/* FAT free space bitmap is disabled if not configured in ffconf.h */
+#endif
+#ifndef _FS_CLSTRUN
+#define _FS_CLSTRUN	0	/* Free cluster run search is disabled if not configured in ffconf.h */
+#endif
+#ifndef _FS_LINKMAP
+#define _FS_LINKMAP	0	/* Shared cluster link maps are disabled if not configured in ffconf.h */
+#endif
+#ifndef _FS_DIRINDEX
+#define _FS_DIRINDEX	0	/* Directory name index is disabled if not configured in ffconf.h */
+#endif
+#ifndef _FS_ASYNC
+#define _FS_ASYNC	0	/* Asynchronous file data transfer is disabled if not configured in ffconf.h */
+#endif
+#if _FS_ASYNC && !_FS_TINY
+#include "diskio.h"		/* Asynchronous disk request (DIOREQ) */
+#endif
+
 
 
 /* Definitions of volume management */
@@ -80,6 +105,42 @@ typedef DWORD FSIZE_t;
 
 
 
+#if _FS_LINKMAP
+#ifndef _FS_LINKMAP_FRAG
+#define _FS_LINKMAP_FRAG	16	/* Number of fragments held in a link map */
+#endif
+
+/* Shared cluster link map (LINKMAP) */
+
+typedef struct {
+	DWORD	sclust;			/* Start cluster of the mapped chain (0:unused) */
+	DWORD	stamp;			/* Access stamp (for LRU replacement) */
+	DWORD	ncl;			/* Number of clusters covered by the map */
+	UINT	nfrag;			/* Number of fragments in the map */
+	DWORD	frag[_FS_LINKMAP_FRAG][2];	/* Cluster order and cluster number at top of each fragment */
+} LINKMAP;
+#endif
+
+
+
+#if _FS_DIRINDEX
+#ifndef _FS_DIRINDEX_SIZE
+#define _FS_DIRINDEX_SIZE	512	/* Number of directory entries covered by a directory index */
+#endif
+
+/* Directory name index (DIRINDEX) */
+
+typedef struct {
+	DWORD	sclust;			/* Start cluster of the indexed directory (0xFFFFFFFF:unused) */
+	DWORD	stamp;			/* Access stamp (for LRU replacement) */
+	UINT	nent;			/* Number of leading entries covered by the index */
+	BYTE	done;			/* 1:The index covers the whole directory */
+	BYTE	hash[_FS_DIRINDEX_SIZE];	/* Name hash of each entry (0:no name) */
+} DIRINDEX;
+#endif
+
+
+
 /* File system object structure (FATFS) */
 
 typedef struct {
@@ -106,6 +167,9 @@ typedef struct {
 #if !_FS_READONLY
 	DWORD	last_clst;		/* Last allocated cluster */
 	DWORD	free_clst;		/* Number of free clusters */
+#if _FS_FATBITMAP
+	BYTE	fbmp[_FS_FATBITMAP];	/* FAT sector bitmap (b=1:FAT sector has no free entry) */
+#endif
 #endif
 #if _FS_RPATH != 0
 	DWORD	cdir;			/* Current directory start cluster (0:root) */
@@ -121,6 +185,21 @@ typedef struct {
 	DWORD	fatbase;		/* FAT base sector */
 	DWORD	dirbase;		/* Root directory base sector/cluster */
 	DWORD	database;		/* Data base sector */
+#if _FS_DIRINDEX
+	DWORD	xstamp;			/* Directory index access counter */
+	DIRINDEX	xidx[_FS_DIRINDEX];	/* Name indexes of the recently searched directories */
+#endif
+#if _FS_LINKMAP
+	DWORD	lstamp;			/* Link map access counter */
+	LINKMAP	lmap[_FS_LINKMAP];	/* Cluster link maps shared by the files on the volume */
+#endif
+#if _FS_WINCACHE
+	DWORD	cstamp;			/* Sector cache access counter */
+	DWORD	csect[_FS_WINCACHE];	/* Sector held in each cache buffer (0xFFFFFFFF:empty) */
+	DWORD	cuse[_FS_WINCACHE];		/* Access stamp of each cache buffer (for LRU replacement) */
+	BYTE	cflag[_FS_WINCACHE];	/* Cache buffer flags (b0:dirty) */
+	BYTE	cbuf[_FS_WINCACHE][_MAX_SS];	/* Sector cache buffers backing the win[] */
+#endif
 	DWORD	winsect;		/* Current sector appearing in the win[] */
 	BYTE	win[_MAX_SS];	/* Disk access window for Directory, FAT (and file data at tiny cfg) */
 } FATFS;
@@ -167,8 +246,15 @@ typedef struct {
 	DWORD*	cltbl;			/* Pointer to the cluster link map table (nulled on open, set by application) */
 #endif
 #if !_FS_TINY
+#if _FS_ASYNC
+	BYTE*	buf;			/* File private data read/write window (points one of bufs[]) */
+	DWORD	asect;			/* Sector held in the spare buffer (0:invalid) */
+	DIOREQ	areq;			/* Asynchronous request on the spare buffer */
+	BYTE	bufs[2][_MAX_SS];	/* Sector buffers, the one not pointed by buf is the spare buffer */
+#else
 	BYTE	buf[_MAX_SS];	/* File private data read/write window */
 #endif
+#endif
 } FIL;
 
 
@@ -209,6 +295,15 @@ typedef struct {
 
 
 
+/* Segment of a scatter/gather list (f_read_stream/f_write_stream) */
+
+typedef struct {
+	void*	buff;			/* Pointer to the data buffer (word aligned for DMA transfer) */
+	UINT	len;			/* Number of bytes in the buffer */
+} FFSEG;
+
+
+
 /* File function return code (FRESULT) */
 
 typedef enum {
@@ -264,6 +359,8 @@ FRESULT f_getfree (const TCHAR* path, DWORD* nclst, FATFS** fatfs);	/* Get numbe
 FRESULT f_getlabel (const TCHAR* path, TCHAR* label, DWORD* vsn);	/* Get volume label */
 FRESULT f_setlabel (const TCHAR* label);							/* Set volume label */
 FRESULT f_forward (FIL* fp, UINT(*func)(const BYTE*,UINT), UINT btf, UINT* bf);	/* Forward data to the stream */
+FRESULT f_read_stream (FIL* fp, const FFSEG* seg, UINT nseg, UINT* br);	/* Read data from the file to a scatter list */
+FRESULT f_write_stream (FIL* fp, const FFSEG* seg, UINT nseg, UINT* bw);	/* Write data to the file from a gather list */
 FRESULT f_expand (FIL* fp, FSIZE_t szf, BYTE opt);					/* Allocate a contiguous block to the file */
 FRESULT f_mount (FATFS* fs, const TCHAR* path, BYTE opt);			/* Mount/Unmount a logical drive */
 FRESULT f_mkfs (const TCHAR* path, BYTE opt, DWORD au, void* work, UINT len);	/* Create a FAT volume */
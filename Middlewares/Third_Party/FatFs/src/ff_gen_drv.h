@@ -48,6 +48,16 @@ typedef struct
 #if _USE_IOCTL == 1
   DRESULT (*disk_ioctl)      (BYTE, BYTE, void*);              /*!< I/O control operation when _USE_IOCTL = 1 */
 #endif /* _USE_IOCTL == 1 */
+#if _USE_VECTOR == 1
+  DRESULT (*disk_readv)      (BYTE, const DSEG*, UINT, DWORD); /*!< Read contiguous sectors to a scatter list (optional, may be NULL) */
+#if _USE_WRITE == 1
+  DRESULT (*disk_writev)     (BYTE, const DSEG*, UINT, DWORD); /*!< Write contiguous sectors from a gather list (optional, may be NULL) */
+#endif /* _USE_WRITE == 1 */
+#endif /* _USE_VECTOR == 1 */
+#if _USE_ASYNC == 1
+  DRESULT (*disk_submit)     (BYTE, DIOREQ*);                  /*!< Queue an asynchronous transfer (optional, may be NULL) */
+  DRESULT (*disk_wait)       (BYTE, DIOREQ*);                  /*!< Block until a queued transfer completes (optional, may be NULL) */
+#endif /* _USE_ASYNC == 1 */
 
 }Diskio_drvTypeDef;
 
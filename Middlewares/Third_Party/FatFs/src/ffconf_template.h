@@ -68,6 +68,19 @@
 /* This option switches fast seek function. (0:Disable or 1:Enable) */
 
 
+#define _FS_LINKMAP	0
+#define _FS_LINKMAP_FRAG	16
+/* The _FS_LINKMAP option sets the number of cluster link maps (0 to 255) that f_lseek()
+/  builds and keeps in the file system object for the files without a user supplied
+/  CLMT. The maps are keyed by start cluster, shared by all open files on the volume,
+/  replaced in LRU order and dropped when the chain is removed or truncated. A seek
+/  finds the cluster with a binary search over the fragments instead of following the
+/  FAT chain. _FS_LINKMAP_FRAG sets the number of fragments held in a map; a chain
+/  with more fragments is followed on the FAT beyond the mapped part. Each map
+/  increases the size of the file system object (FATFS) by _FS_LINKMAP_FRAG * 8 + 16
+/  bytes. This option needs _USE_FASTSEEK = 1. (0:Disable) */
+
+
 #define	_USE_EXPAND		0
 /* This option switches f_expand function. (0:Disable or 1:Enable) */
 
@@ -86,6 +99,15 @@
 /* This option switches f_forward() function. (0:Disable or 1:Enable) */
 
 
+#define	_USE_STREAM	0
+/* This option switches f_read_stream() and f_write_stream() functions.
+/  (0:Disable or 1:Enable) They transfer file data to/from a scatter/gather list
+/  of buffers. Whole sectors are passed to disk_readv()/disk_writev() of the disk
+/  driver without copy and coalesced over contiguous clusters. Only the partial
+/  sectors at unaligned file offsets go through the file buffer. It needs
+/  _USE_VECTOR = 1 in the compiler options (see diskio.h). */
+
+
 /*---------------------------------------------------------------------------/
 / Locale and Namespace Configurations
 /---------------------------------------------------------------------------*/
@@ -218,6 +240,30 @@
 */
 
 
+#define _FS_FATBITMAP	0
+/* This option sets the size in bytes of the free space bitmap kept in each file
+/  system object on the FAT16/32 volume. (0:Disable) Each bit tells whether a FAT
+/  sector is known to have no free entry, so that the cluster allocator skips
+/  full FAT sectors without reading them. The bitmap is built lazily by the
+/  cluster allocator and by f_getfree(), and it is cleared at mount. A bitmap of
+/  N bytes covers N * 8 FAT sectors, e.g. 1024 bytes cover 1M clusters on FAT32
+/  at 512 bytes/sector. FAT sectors beyond the coverage are always scanned.
+/  This option has no effect at read-only configuration (_FS_READONLY = 1). */
+
+
+#define _FS_CLSTRUN	0
+/* This option sets the number of clusters (0:Disable or 2 to 65535) of the free
+/  run that the cluster allocator looks for when a growing chain on the FAT12/16/32
+/  volume cannot take the next cluster. The search starts at the suggested start
+/  of new chains, the chain continues at the top of the run found and the suggested
+/  start is moved past the run, so files appended in turn grow in runs of at least
+/  this size instead of taking every other cluster. When no run is found within a
+/  quarter as many clusters as there are bytes in a sector past the first free
+/  cluster, the first free cluster is taken. Allocation is still a scan of the FAT,
+/  the free space bitmap (_FS_FATBITMAP) only lets it skip the FAT sectors that
+/  have no free entry. This option has no effect at read-only configuration. */
+
+
 
 /*---------------------------------------------------------------------------/
 / System Configurations
@@ -230,6 +276,41 @@
 /  buffer in the file system object (FATFS) is used for the file data transfer. */
 
 
+#define _FS_WINCACHE	0
+/* This option sets the number of sector buffers (0 to 16) that back the disk
+/  access window win[] of each file system object as an LRU write-back cache.
+/  FAT and directory sectors pushed out of the window are kept in the cache and
+/  are written back to the device only when they are evicted or the volume is
+/  synchronized by f_sync() or f_close(). This removes most of the device accesses
+/  caused by alternating FAT and directory updates. Each buffer increases the size
+/  of the file system object (FATFS) by _MAX_SS + 9 bytes. (0:Disable) */
+
+
+#define _FS_ASYNC	0
+/* This option switches asynchronous file data transfer. (0:Disable or 1:Enable)
+/  When enabled, the file object has a second sector buffer. A dirty sector is
+/  written back with disk_submit() while the next one is filled (write-behind) and
+/  the next sector in the cluster is fetched while the current one is consumed
+/  (read-ahead). Drivers without the asynchronous entry points complete requests
+/  at submission. A file object must be closed with f_close() before it is discarded
+/  because a transfer to its spare buffer can be in progress. This option increases
+/  the size of the file object (FIL) by _MAX_SS + 32 bytes and has no effect at the
+/  tiny configuration (_FS_TINY = 1). It needs _USE_ASYNC = 1 in the compiler
+/  options (see diskio.h). */
+
+
+#define _FS_DIRINDEX	0
+#define _FS_DIRINDEX_SIZE	512
+/* The _FS_DIRINDEX option sets the number of directories (0 to 255) whose name hash
+/  index is kept in the file system object. The index holds an 8-bit hash of the SFN
+/  and the up-cased LFN of the items in the first _FS_DIRINDEX_SIZE entries (16 to
+/  65536) of the directory, so that a name look-up reads only the entries whose hash
+/  matches. It is built while dir_find() scans the directory, is updated when an item
+/  is created or removed, and is replaced in LRU order. Each index increases the size
+/  of the file system object (FATFS) by _FS_DIRINDEX_SIZE + 16 bytes. It has no effect
+/  on the exFAT volume. (0:Disable) */
+
+
 #define _FS_EXFAT	0
 /* This option switches support of exFAT file system. (0:Disable or 1:Enable)
 /  When enable exFAT, also LFN needs to be enabled. (_USE_LFN >= 1)
@@ -860,19 +860,8 @@ osStatus osSemaphoreDelete (osSemaphoreId semaphore_id)
 
 #if (defined (osFeature_Pool)  &&  (osFeature_Pool != 0)) 
 
-//TODO
-//This is a primitive and inefficient wrapper around the existing FreeRTOS memory management.
-//A better implementation will have to modify heap_x.c!
-
-
-typedef struct os_pool_cb {
-  void *pool;
-  uint8_t *markers;
-  uint32_t pool_sz;
-  uint32_t item_sz;
-  uint32_t currentIndex;
-} os_pool_cb_t;
-
+/* Pools are FreeRTOS memory pools (mem_pool.c), so osPoolId is a
+MemPoolHandle_t and allocating or freeing a block takes constant time. */
 
 /**
 * @brief Create and Initialize a memory pool
@@ -883,45 +872,11 @@ typedef struct os_pool_cb {
 osPoolId osPoolCreate (const osPoolDef_t *pool_def)
 {
 #if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
-  osPoolId thePool;
-  int itemSize = 4 * ((pool_def->item_sz + 3) / 4);
-  uint32_t i;
-  
-  /* First have to allocate memory for the pool control block. */
- thePool = pvPortMalloc(sizeof(os_pool_cb_t));
-
-  
-  if (thePool) {
-    thePool->pool_sz = pool_def->pool_sz;
-    thePool->item_sz = itemSize;
-    thePool->currentIndex = 0;
-    
-    /* Memory for markers */
-    thePool->markers = pvPortMalloc(pool_def->pool_sz);
-   
-    if (thePool->markers) {
-      /* Now allocate the pool itself. */
-     thePool->pool = pvPortMalloc(pool_def->pool_sz * itemSize);
-      
-      if (thePool->pool) {
-        for (i = 0; i < pool_def->pool_sz; i++) {
-          thePool->markers[i] = 0;
-        }
-      }
-      else {
-        vPortFree(thePool->markers);
-        vPortFree(thePool);
-        thePool = NULL;
-      }
-    }
-    else {
-      vPortFree(thePool);
-      thePool = NULL;
-    }
+  if ((pool_def == NULL) || (pool_def->pool_sz == 0) || (pool_def->item_sz == 0)) {
+    return NULL;
   }
-
-  return thePool;
- 
+  
+  return xMemPoolCreate(pool_def->item_sz, pool_def->pool_sz);
 #else
   return NULL;
 #endif
@@ -935,37 +890,16 @@ osPoolId osPoolCreate (const osPoolDef_t *pool_def)
 */
 void *osPoolAlloc (osPoolId pool_id)
 {
-  int dummy = 0;
-  void *p = NULL;
-  uint32_t i;
-  uint32_t index;
-  
-  if (inHandlerMode()) {
-    dummy = portSET_INTERRUPT_MASK_FROM_ISR();
-  }
-  else {
-    vPortEnterCritical();
-  }
-  
-  for (i = 0; i < pool_id->pool_sz; i++) {
-    index = (pool_id->currentIndex + i) % pool_id->pool_sz;
-    
-    if (pool_id->markers[index] == 0) {
-      pool_id->markers[index] = 1;
-      p = (void *)((uint32_t)(pool_id->pool) + (index * pool_id->item_sz));
-      pool_id->currentIndex = index;
-      break;
-    }
+  if (pool_id == NULL) {
+    return NULL;
   }
   
   if (inHandlerMode()) {
-    portCLEAR_INTERRUPT_MASK_FROM_ISR(dummy);
+    return pvMemPoolAllocFromISR(pool_id);
   }
   else {
-    vPortExitCritical();
+    return pvMemPoolAlloc(pool_id);
   }
-  
-  return p;
 }
 
 /**
@@ -980,7 +914,7 @@ void *osPoolCAlloc (osPoolId pool_id)
   
   if (p != NULL)
   {
-    memset(p, 0, sizeof(pool_id->pool_sz));
+    memset(p, 0, xMemPoolGetBlockSize(pool_id));
   }
   
   return p;
@@ -995,7 +929,7 @@ void *osPoolCAlloc (osPoolId pool_id)
 */
 osStatus osPoolFree (osPoolId pool_id, void *block)
 {
-  uint32_t index;
+  BaseType_t result;
   
   if (pool_id == NULL) {
     return osErrorParameter;
@@ -1005,21 +939,18 @@ osStatus osPoolFree (osPoolId pool_id, void *block)
     return osErrorParameter;
   }
   
-  if (block < pool_id->pool) {
-    return osErrorParameter;
+  if (inHandlerMode()) {
+    result = xMemPoolFreeFromISR(pool_id, block);
   }
-  
-  index = (uint32_t)block - (uint32_t)(pool_id->pool);
-  if (index % pool_id->item_sz) {
-    return osErrorParameter;
+  else {
+    result = xMemPoolFree(pool_id, block);
   }
-  index = index / pool_id->item_sz;
-  if (index >= pool_id->pool_sz) {
+  
+  /* The block is not the start of a block in this pool. */
+  if (result != pdPASS) {
     return osErrorParameter;
   }
   
-  pool_id->markers[index] = 0;
-  
   return osOK;
 }
 
@@ -1193,7 +1124,7 @@ osMailQId osMailCreate (const osMailQDef_t *queue_def, osThreadId thread_id)
   /* Create a mail pool */
   (*(queue_def->cb))->pool = osPoolCreate(&pool_def);
   if ((*(queue_def->cb))->pool == NULL) {
-    //TODO: Delete queue. How to do it in FreeRTOS?
+    vQueueDelete((*(queue_def->cb))->handle);
     vPortFree(*(queue_def->cb));
     return NULL;
   }
@@ -59,6 +59,7 @@
 #include "queue.h"
 #include "semphr.h"
 #include "event_groups.h"
+#include "mem_pool.h"
 
 /**
 \page cmsis_os_h Header File Template: cmsis_os.h
@@ -251,7 +252,7 @@ typedef SemaphoreHandle_t osSemaphoreId;
 
 /// Pool ID identifies the memory pool (pointer to a memory pool control block).
 /// \note CAN BE CHANGED: \b os_pool_cb is implementation specific in every CMSIS-RTOS.
-typedef struct os_pool_cb *osPoolId;
+typedef MemPoolHandle_t osPoolId;
 
 /// Message ID identifies the message queue (pointer to a message queue control block).
 /// \note CAN BE CHANGED: \b os_messageQ_cb is implementation specific in every CMSIS-RTOS.
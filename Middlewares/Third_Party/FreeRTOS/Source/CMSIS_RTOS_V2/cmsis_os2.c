@@ -30,6 +30,7 @@
 #include "task.h"                       // ARM.FreeRTOS::RTOS:Core
 #include "event_groups.h"               // ARM.FreeRTOS::RTOS:Event Groups
 #include "semphr.h"                     // ARM.FreeRTOS::RTOS:Core
+#include "mem_pool.h"                   // ARM.FreeRTOS::RTOS:Core
 
 /*---------------------------------------------------------------------------*/
 #ifndef __ARM_ARCH_6M__
@@ -95,6 +96,19 @@ typedef struct {
   void         *arg;
 } TimerCallback_t;
 
+/* Memory pool control block definition */
+typedef struct {
+  MemPoolHandle_t   hPool;              /* Fixed size blocks */
+  SemaphoreHandle_t hSemaphore;         /* Counts free blocks so that allocation can wait */
+  const char       *name;
+  uint32_t          flags;
+  StaticMemPool_t   pool;
+  StaticSemaphore_t sem;
+} MemPool_t;
+
+/* Memory pool control block and storage were allocated from the FreeRTOS heap */
+#define MPOOL_DYNAMIC_MEM         1U
+
 /* Kernel initialization state */
 static osKernelState_t KernelState = osKernelInactive;
 
@@ -1844,6 +1858,231 @@ osStatus_t osMessageQueueDelete (osMessageQueueId_t mq_id) {
 
 /*---------------------------------------------------------------------------*/
 
+osMemoryPoolId_t osMemoryPoolNew (uint32_t block_count, uint32_t block_size, const osMemoryPoolAttr_t *attr) {
+  MemPool_t *mp;
+  const char *name;
+  int32_t mem;
+
+  mp = NULL;
+
+  if (!IS_IRQ() && (block_count > 0U) && (block_size > 0U)) {
+    mem  = -1;
+    name = NULL;
+
+    if (attr != NULL) {
+      name = attr->name;
+
+      if ((attr->cb_mem != NULL) && (attr->cb_size >= sizeof(MemPool_t)) &&
+          (attr->mp_mem != NULL) && (attr->mp_size >= memPOOL_STORAGE_SIZE(block_size, block_count)) &&
+          (((uint32_t)attr->mp_mem & portBYTE_ALIGNMENT_MASK) == 0U)) {
+        mem = 1;
+      }
+      else {
+        if ((attr->cb_mem == NULL) && (attr->cb_size == 0U) &&
+            (attr->mp_mem == NULL) && (attr->mp_size == 0U)) {
+          mem = 0;
+        }
+      }
+    }
+    else {
+      mem = 0;
+    }
+
+    if (mem == 1) {
+      mp = (MemPool_t *)attr->cb_mem;
+      mp->hPool = xMemPoolCreateStatic (block_size, block_count, (uint8_t *)attr->mp_mem, &mp->pool);
+      mp->flags = 0U;
+    }
+    else {
+      if (mem == 0) {
+        mp = pvPortMalloc (sizeof(MemPool_t));
+
+        if (mp != NULL) {
+          mp->hPool = xMemPoolCreate (block_size, block_count);
+          mp->flags = MPOOL_DYNAMIC_MEM;
+
+          if (mp->hPool == NULL) {
+            vPortFree (mp);
+            mp = NULL;
+          }
+        }
+      }
+    }
+
+    if (mp != NULL) {
+      mp->name = name;
+
+      /* The semaphore count always equals the number of free blocks, so a
+         successful take guarantees the allocation that follows succeeds */
+      mp->hSemaphore = xSemaphoreCreateCountingStatic (block_count, block_count, &mp->sem);
+
+      #if (configQUEUE_REGISTRY_SIZE > 0)
+      vQueueAddToRegistry (mp->hSemaphore, name);
+      #endif
+    }
+  }
+
+  return ((osMemoryPoolId_t)mp);
+}
+
+const char *osMemoryPoolGetName (osMemoryPoolId_t mp_id) {
+  MemPool_t *mp = (MemPool_t *)mp_id;
+  const char *p;
+
+  if (mp == NULL) {
+    p = NULL;
+  } else {
+    p = mp->name;
+  }
+
+  return (p);
+}
+
+void *osMemoryPoolAlloc (osMemoryPoolId_t mp_id, uint32_t timeout) {
+  MemPool_t *mp = (MemPool_t *)mp_id;
+  void *block;
+  BaseType_t yield;
+
+  block = NULL;
+
+  if (mp != NULL) {
+    if (IS_IRQ()) {
+      if (timeout == 0U) {
+        yield = pdFALSE;
+
+        if (xSemaphoreTakeFromISR (mp->hSemaphore, &yield) == pdPASS) {
+          block = pvMemPoolAllocFromISR (mp->hPool);
+          portYIELD_FROM_ISR (yield);
+        }
+      }
+    }
+    else {
+      if (xSemaphoreTake (mp->hSemaphore, (TickType_t)timeout) == pdPASS) {
+        block = pvMemPoolAlloc (mp->hPool);
+      }
+    }
+  }
+
+  return (block);
+}
+
+osStatus_t osMemoryPoolFree (osMemoryPoolId_t mp_id, void *block) {
+  MemPool_t *mp = (MemPool_t *)mp_id;
+  osStatus_t stat;
+  BaseType_t yield;
+
+  stat = osOK;
+
+  if ((mp == NULL) || (block == NULL)) {
+    stat = osErrorParameter;
+  }
+  else if (IS_IRQ()) {
+    if (xMemPoolFreeFromISR (mp->hPool, block) != pdPASS) {
+      stat = osErrorParameter;
+    }
+    else {
+      yield = pdFALSE;
+      (void)xSemaphoreGiveFromISR (mp->hSemaphore, &yield);
+      portYIELD_FROM_ISR (yield);
+    }
+  }
+  else {
+    if (xMemPoolFree (mp->hPool, block) != pdPASS) {
+      stat = osErrorParameter;
+    }
+    else {
+      (void)xSemaphoreGive (mp->hSemaphore);
+    }
+  }
+
+  return (stat);
+}
+
+uint32_t osMemoryPoolGetCapacity (osMemoryPoolId_t mp_id) {
+  MemPool_t *mp = (MemPool_t *)mp_id;
+  uint32_t n;
+
+  if (mp == NULL) {
+    n = 0U;
+  } else {
+    n = (uint32_t)uxMemPoolGetBlockCount (mp->hPool);
+  }
+
+  return (n);
+}
+
+uint32_t osMemoryPoolGetBlockSize (osMemoryPoolId_t mp_id) {
+  MemPool_t *mp = (MemPool_t *)mp_id;
+  uint32_t sz;
+
+  if (mp == NULL) {
+    sz = 0U;
+  } else {
+    sz = (uint32_t)xMemPoolGetBlockSize (mp->hPool);
+  }
+
+  return (sz);
+}
+
+uint32_t osMemoryPoolGetCount (osMemoryPoolId_t mp_id) {
+  MemPool_t *mp = (MemPool_t *)mp_id;
+  uint32_t n;
+
+  if (mp == NULL) {
+    n = 0U;
+  } else {
+    n = (uint32_t)(uxMemPoolGetBlockCount (mp->hPool) - uxMemPoolGetFreeCount (mp->hPool));
+  }
+
+  return (n);
+}
+
+uint32_t osMemoryPoolGetSpace (osMemoryPoolId_t mp_id) {
+  MemPool_t *mp = (MemPool_t *)mp_id;
+  uint32_t n;
+
+  if (mp == NULL) {
+    n = 0U;
+  } else {
+    n = (uint32_t)uxMemPoolGetFreeCount (mp->hPool);
+  }
+
+  return (n);
+}
+
+osStatus_t osMemoryPoolDelete (osMemoryPoolId_t mp_id) {
+  MemPool_t *mp = (MemPool_t *)mp_id;
+  osStatus_t stat;
+
+#ifndef USE_FreeRTOS_HEAP_1
+  if (IS_IRQ()) {
+    stat = osErrorISR;
+  }
+  else if (mp == NULL) {
+    stat = osErrorParameter;
+  }
+  else {
+    #if (configQUEUE_REGISTRY_SIZE > 0)
+    vQueueUnregisterQueue (mp->hSemaphore);
+    #endif
+
+    stat = osOK;
+    vSemaphoreDelete (mp->hSemaphore);
+    vMemPoolDelete (mp->hPool);
+
+    if ((mp->flags & MPOOL_DYNAMIC_MEM) != 0U) {
+      vPortFree (mp);
+    }
+  }
+#else
+  stat = osError;
+#endif
+
+  return (stat);
+}
+
+/*---------------------------------------------------------------------------*/
+
 /* Callback function prototypes */
 extern void vApplicationIdleHook (void);
 extern void vApplicationTickHook (void);
@@ -72,6 +72,11 @@ typedef struct EventGroupDef_t
 	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
 		uint8_t ucStaticallyAllocated; /*< Set to pdTRUE if the event group is statically allocated to ensure no attempt is made to free the memory. */
 	#endif
+
+	#if( configUSE_EVENT_GROUP_DIRECT_ISR == 1 )
+		volatile UBaseType_t uxListLocks;	/*< The number of task level operations (or the interrupt) currently using xTasksWaitingForBits.  0 when the list is not in use. */
+		volatile EventBits_t uxPendingBits;	/*< Bits set from interrupts while the list was in use, which are set by whatever was using the list once it has finished. */
+	#endif
 } EventGroup_t;
 
 /*-----------------------------------------------------------*/
@@ -86,6 +91,28 @@ typedef struct EventGroupDef_t
  */
 static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, const EventBits_t uxBitsToWaitFor, const BaseType_t xWaitForAllBits ) PRIVILEGED_FUNCTION;
 
+#if( configUSE_EVENT_GROUP_DIRECT_ISR == 1 )
+
+	/*
+	 * Task level operations on the event group are made with the scheduler
+	 * suspended, which does not stop xEventGroupSetBitsFromISR() from accessing
+	 * the event group.  prvLockEventGroup() marks the event group as in use so
+	 * that interrupts only record the bits they set in uxPendingBits, and leave
+	 * it to prvUnlockEventGroup() to set them.  The bits are not set straight
+	 * away so a task that is being unblocked cannot have bits it did not see
+	 * cleared on exit.  Interrupts always leave uxListLocks at the value they
+	 * found it at, so it can be incremented without a critical section.
+	 */
+	#define prvLockEventGroup( pxEventBits )	( ( pxEventBits )->uxListLocks )++
+	static void prvUnlockEventGroup( EventGroup_t *pxEventBits ) PRIVILEGED_FUNCTION;
+
+#else
+
+	#define prvLockEventGroup( pxEventBits )
+	#define prvUnlockEventGroup( pxEventBits )
+
+#endif /* configUSE_EVENT_GROUP_DIRECT_ISR */
+
 /*-----------------------------------------------------------*/
 
 #if( configSUPPORT_STATIC_ALLOCATION == 1 )
@@ -115,6 +142,13 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, co
 			pxEventBits->uxEventBits = 0;
 			vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
 
+			#if( configUSE_EVENT_GROUP_DIRECT_ISR == 1 )
+			{
+				pxEventBits->uxListLocks = 0;
+				pxEventBits->uxPendingBits = 0;
+			}
+			#endif
+
 			#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
 			{
 				/* Both static and dynamic allocation can be used, so note that
@@ -166,6 +200,13 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, co
 			pxEventBits->uxEventBits = 0;
 			vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
 
+			#if( configUSE_EVENT_GROUP_DIRECT_ISR == 1 )
+			{
+				pxEventBits->uxListLocks = 0;
+				pxEventBits->uxPendingBits = 0;
+			}
+			#endif
+
 			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
 			{
 				/* Both static and dynamic allocation can be used, so note this
@@ -204,6 +245,7 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 	#endif
 
 	vTaskSuspendAll();
+	prvLockEventGroup( pxEventBits );
 	{
 		uxOriginalBitValue = pxEventBits->uxEventBits;
 
@@ -246,6 +288,7 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 			}
 		}
 	}
+	prvUnlockEventGroup( pxEventBits );
 	xAlreadyYielded = xTaskResumeAll();
 
 	if( xTicksToWait != ( TickType_t ) 0 )
@@ -327,6 +370,7 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 	#endif
 
 	vTaskSuspendAll();
+	prvLockEventGroup( pxEventBits );
 	{
 		const EventBits_t uxCurrentEventBits = pxEventBits->uxEventBits;
 
@@ -394,6 +438,7 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 			traceEVENT_GROUP_WAIT_BITS_BLOCK( xEventGroup, uxBitsToWaitFor );
 		}
 	}
+	prvUnlockEventGroup( pxEventBits );
 	xAlreadyYielded = xTaskResumeAll();
 
 	if( xTicksToWait != ( TickType_t ) 0 )
@@ -533,6 +578,7 @@ BaseType_t xMatchFound = pdFALSE;
 	pxList = &( pxEventBits->xTasksWaitingForBits );
 	pxListEnd = listGET_END_MARKER( pxList ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
 	vTaskSuspendAll();
+	prvLockEventGroup( pxEventBits );
 	{
 		traceEVENT_GROUP_SET_BITS( xEventGroup, uxBitsToSet );
 
@@ -604,6 +650,7 @@ BaseType_t xMatchFound = pdFALSE;
 		bit was set in the control word. */
 		pxEventBits->uxEventBits &= ~uxBitsToClear;
 	}
+	prvUnlockEventGroup( pxEventBits );
 	( void ) xTaskResumeAll();
 
 	return pxEventBits->uxEventBits;
@@ -703,7 +750,183 @@ BaseType_t xWaitConditionMet = pdFALSE;
 }
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+#if( configUSE_EVENT_GROUP_DIRECT_ISR == 1 )
+
+	static void prvUnlockEventGroup( EventGroup_t *pxEventBits )
+	{
+	EventBits_t uxPendingBits;
+
+		/* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED. */
+
+		do
+		{
+			/* The test of uxPendingBits and the release of the event group
+			must be atomic with respect to xEventGroupSetBitsFromISR(). */
+			taskENTER_CRITICAL();
+			{
+				if( pxEventBits->uxListLocks == ( UBaseType_t ) 1 )
+				{
+					uxPendingBits = pxEventBits->uxPendingBits;
+					pxEventBits->uxPendingBits = 0;
+				}
+				else
+				{
+					uxPendingBits = 0;
+				}
+
+				if( uxPendingBits == ( EventBits_t ) 0 )
+				{
+					( pxEventBits->uxListLocks )--;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			if( uxPendingBits != ( EventBits_t ) 0 )
+			{
+				/* Bits were set from an interrupt while the event group was
+				in use.  Set them now, with the event group still locked. */
+				( void ) xEventGroupSetBits( pxEventBits, uxPendingBits );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		} while( uxPendingBits != ( EventBits_t ) 0 );
+	}
+
+#endif /* configUSE_EVENT_GROUP_DIRECT_ISR */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_EVENT_GROUP_DIRECT_ISR == 1 )
+
+	BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken )
+	{
+	ListItem_t *pxListItem, *pxNext;
+	ListItem_t const *pxListEnd;
+	EventBits_t uxBitsToClear, uxBitsWaitedFor, uxControlBits;
+	EventGroup_t *pxEventBits = xEventGroup;
+	UBaseType_t uxSavedInterruptStatus;
+	BaseType_t xScan;
+
+		configASSERT( xEventGroup );
+		configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+
+		/* See the comment in xQueueGenericSendFromISR(). */
+		portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+		pxListEnd = listGET_END_MARKER( &( pxEventBits->xTasksWaitingForBits ) ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
+
+		traceEVENT_GROUP_SET_BITS_FROM_ISR( xEventGroup, uxBitsToSet );
+
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			if( pxEventBits->uxListLocks == ( UBaseType_t ) 0 )
+			{
+				pxEventBits->uxListLocks = ( UBaseType_t ) 1;
+				pxEventBits->uxEventBits |= uxBitsToSet;
+				xScan = pdTRUE;
+			}
+			else
+			{
+				/* A task, or an interrupt this interrupt has nested on, is
+				using the event group.  It will set the bits, and unblock any
+				tasks waiting for them, when it has finished. */
+				pxEventBits->uxPendingBits |= uxBitsToSet;
+				xScan = pdFALSE;
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		while( xScan != pdFALSE )
+		{
+			uxBitsToClear = 0;
+
+			uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+
+			pxListItem = listGET_HEAD_ENTRY( &( pxEventBits->xTasksWaitingForBits ) );
+
+			while( pxListItem != pxListEnd )
+			{
+				pxNext = listGET_NEXT( pxListItem );
+				uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
+
+				/* Split the bits waited for from the control bits. */
+				uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
+				uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+
+				if( prvTestWaitCondition( pxEventBits->uxEventBits, uxBitsWaitedFor, ( BaseType_t ) ( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) != ( EventBits_t ) 0 ) ) != pdFALSE )
+				{
+					if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+					{
+						uxBitsToClear |= uxBitsWaitedFor;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					/* As xEventGroupSetBits(). */
+					if( xTaskRemoveFromUnorderedEventListFromISR( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET ) != pdFALSE )
+					{
+						if( pxHigherPriorityTaskWoken != NULL )
+						{
+							*pxHigherPriorityTaskWoken = pdTRUE;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				pxListItem = pxNext;
+
+				/* Tasks cannot run until this interrupt exits, and interrupts
+				that nest on this one do not access the list while it is
+				locked, so pxNext remains valid while higher priority
+				interrupts are allowed to run between two list items.  The
+				time interrupts are masked for therefore does not depend on
+				the number of waiting tasks. */
+				portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+				uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+			}
+
+			/* Clear any bits that matched when the eventCLEAR_EVENTS_ON_EXIT_BIT
+			bit was set in the control word. */
+			pxEventBits->uxEventBits &= ~uxBitsToClear;
+
+			if( pxEventBits->uxPendingBits != ( EventBits_t ) 0 )
+			{
+				/* A nested interrupt set bits while the list was being
+				scanned. */
+				pxEventBits->uxEventBits |= pxEventBits->uxPendingBits;
+				pxEventBits->uxPendingBits = 0;
+			}
+			else
+			{
+				pxEventBits->uxListLocks = ( UBaseType_t ) 0;
+				xScan = pdFALSE;
+			}
+
+			portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+		}
+
+		return pdPASS;
+	}
+
+#elif ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
 
 	BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken )
 	{
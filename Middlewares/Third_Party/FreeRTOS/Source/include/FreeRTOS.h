@@ -262,6 +262,32 @@ extern "C" {
 
 #endif /* configUSE_TIMERS */
 
+#ifndef configUSE_TIMER_WHEEL
+	#define configUSE_TIMER_WHEEL 0
+#endif
+
+#ifndef configTIMER_WHEEL_SLOT_BITS
+	/* Each level of the timer wheel has 2 ^ configTIMER_WHEEL_SLOT_BITS
+	slots, each of which is a List_t, and there are as many levels as are
+	needed to cover the bits of TickType_t - 11 levels of 8 slots for a 32-bit
+	tick count with the default value. */
+	#define configTIMER_WHEEL_SLOT_BITS 3
+#endif
+
+#if ( configTIMER_WHEEL_SLOT_BITS < 1 ) || ( configTIMER_WHEEL_SLOT_BITS > 5 )
+	#error configTIMER_WHEEL_SLOT_BITS must be between 1 and 5
+#endif
+
+#ifndef configTIMER_COMMAND_BATCH_SIZE
+	/* The number of commands the timer service task reads from the timer
+	queue before processing them when configUSE_TIMER_WHEEL is 1. */
+	#define configTIMER_COMMAND_BATCH_SIZE 8
+#endif
+
+#if configTIMER_COMMAND_BATCH_SIZE < 1
+	#error configTIMER_COMMAND_BATCH_SIZE must be at least 1
+#endif
+
 #ifndef portSET_INTERRUPT_MASK_FROM_ISR
 	#define portSET_INTERRUPT_MASK_FROM_ISR() 0
 #endif
@@ -696,6 +722,38 @@ extern "C" {
 	#define traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength )
 #endif
 
+#ifndef traceMEM_POOL_CREATE_FAILED
+	#define traceMEM_POOL_CREATE_FAILED()
+#endif
+
+#ifndef traceMEM_POOL_CREATE_STATIC_FAILED
+	#define traceMEM_POOL_CREATE_STATIC_FAILED()
+#endif
+
+#ifndef traceMEM_POOL_CREATE
+	#define traceMEM_POOL_CREATE( pxMemPool )
+#endif
+
+#ifndef traceMEM_POOL_DELETE
+	#define traceMEM_POOL_DELETE( xMemPool )
+#endif
+
+#ifndef traceMEM_POOL_ALLOC
+	#define traceMEM_POOL_ALLOC( xMemPool, pvBlock )
+#endif
+
+#ifndef traceMEM_POOL_ALLOC_FROM_ISR
+	#define traceMEM_POOL_ALLOC_FROM_ISR( xMemPool, pvBlock )
+#endif
+
+#ifndef traceMEM_POOL_FREE
+	#define traceMEM_POOL_FREE( xMemPool, pvBlock )
+#endif
+
+#ifndef traceMEM_POOL_FREE_FROM_ISR
+	#define traceMEM_POOL_FREE_FROM_ISR( xMemPool, pvBlock )
+#endif
+
 #ifndef configGENERATE_RUN_TIME_STATS
 	#define configGENERATE_RUN_TIME_STATS 0
 #endif
@@ -762,6 +820,22 @@ extern "C" {
 	#define configUSE_QUEUE_SETS 0
 #endif
 
+#ifndef configUSE_EVENT_GROUP_DIRECT_ISR
+	/* Set to 1 to have xEventGroupSetBitsFromISR() unblock the waiting tasks
+	itself rather than deferring the operation to the timer service task. */
+	#define configUSE_EVENT_GROUP_DIRECT_ISR 0
+#endif
+
+#ifndef configUSE_QUEUE_EVENT_BITS
+	/* Set to 1 to allow queues and semaphores to set bits in an event group
+	when they are written to - see xQueueAddToEventGroup(). */
+	#define configUSE_QUEUE_EVENT_BITS 0
+#endif
+
+#if( ( configUSE_QUEUE_EVENT_BITS == 1 ) && ( configUSE_EVENT_GROUP_DIRECT_ISR != 1 ) )
+	#error configUSE_QUEUE_EVENT_BITS requires configUSE_EVENT_GROUP_DIRECT_ISR to be set to 1
+#endif
+
 #ifndef portTASK_USES_FLOATING_POINT
 	#define portTASK_USES_FLOATING_POINT()
 #endif
@@ -1183,6 +1257,11 @@ typedef struct xSTATIC_QUEUE
 		uint8_t ucDummy9;
 	#endif
 
+	#if ( configUSE_QUEUE_EVENT_BITS == 1 )
+		void *pvDummy10;
+		TickType_t xDummy11;
+	#endif
+
 } StaticQueue_t;
 typedef StaticQueue_t StaticSemaphore_t;
 
@@ -1213,6 +1292,11 @@ typedef struct xSTATIC_EVENT_GROUP
 			uint8_t ucDummy4;
 	#endif
 
+	#if( configUSE_EVENT_GROUP_DIRECT_ISR == 1 )
+		UBaseType_t uxDummy5;
+		TickType_t xDummy6;
+	#endif
+
 } StaticEventGroup_t;
 
 /*
@@ -1270,6 +1354,26 @@ typedef struct xSTATIC_STREAM_BUFFER
 /* Message buffers are built on stream buffers. */
 typedef StaticStreamBuffer_t StaticMessageBuffer_t;
 
+/*
+* In line with software engineering best practice, FreeRTOS implements a strict
+* data hiding policy, so the memory pool structure used internally by FreeRTOS
+* is not accessible to application code.  However, if the application writer
+* wants to statically allocate the memory required to create a memory pool
+* then the size of the memory pool object needs to be known.  The
+* StaticMemPool_t structure below is provided for this purpose.  Its size and
+* alignment requirements are guaranteed to match those of the genuine
+* structure, no matter which architecture is being used.  Its contents are
+* somewhat obfuscated in the hope users will recognise that it would be unwise
+* to make direct use of the structure members.
+*/
+typedef struct xSTATIC_MEM_POOL
+{
+	void * pvDummy1[ 3 ];
+	size_t uxDummy2;
+	UBaseType_t uxDummy3[ 3 ];
+	uint8_t ucDummy4;
+} StaticMemPool_t;
+
 #ifdef __cplusplus
 }
 #endif
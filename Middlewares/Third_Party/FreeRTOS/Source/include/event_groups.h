@@ -500,6 +500,19 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_
  * context of the timer task - where a scheduler lock is used in place of a
  * critical section.
  *
+ * If configUSE_EVENT_GROUP_DIRECT_ISR is set to 1 in FreeRTOSConfig.h then
+ * xEventGroupSetBitsFromISR() instead unblocks the waiting tasks itself, so the
+ * timer task is not involved and the bits are set before the function returns.
+ * Interrupts are only masked while one waiting task is tested and unblocked,
+ * so the interrupt latency does not depend on the number of waiting tasks,
+ * although the execution time of xEventGroupSetBitsFromISR() does.  If the
+ * event group is being accessed by a task when the interrupt occurs then the
+ * bits are set, and the waiting tasks unblocked, by that task as soon as it
+ * has finished with the event group.
+ * The tick interrupt must not be able to interrupt xEventGroupSetBitsFromISR(),
+ * which is the case when, as on the Cortex-M ports, the tick interrupt runs at
+ * the lowest interrupt priority.
+ *
  * @param xEventGroup The event group in which the bits are to be set.
  *
  * @param uxBitsToSet A bitwise value that indicates the bit or bits to set.
@@ -514,11 +527,14 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_
  * xEventGroupSetBitsFromISR(), indicating that a context switch should be
  * requested before the interrupt exits.  For that reason
  * *pxHigherPriorityTaskWoken must be initialised to pdFALSE.  See the
- * example code below.
+ * example code below.  When configUSE_EVENT_GROUP_DIRECT_ISR is set to 1
+ * *pxHigherPriorityTaskWoken is set to pdTRUE if a task that was waiting for
+ * the bits has a priority higher than the currently running task.
  *
  * @return If the request to execute the function was posted successfully then
  * pdPASS is returned, otherwise pdFALSE is returned.  pdFALSE will be returned
- * if the timer service queue was full.
+ * if the timer service queue was full.  pdPASS is always returned when
+ * configUSE_EVENT_GROUP_DIRECT_ISR is set to 1.
  *
  * Example usage:
    <pre>
@@ -556,7 +572,7 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_
  * \defgroup xEventGroupSetBitsFromISR xEventGroupSetBitsFromISR
  * \ingroup EventGroup
  */
-#if( configUSE_TRACE_FACILITY == 1 )
+#if( ( configUSE_TRACE_FACILITY == 1 ) || ( configUSE_EVENT_GROUP_DIRECT_ISR == 1 ) )
 	BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 #else
 	#define xEventGroupSetBitsFromISR( xEventGroup, uxBitsToSet, pxHigherPriorityTaskWoken ) xTimerPendFunctionCallFromISR( vEventGroupSetBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToSet, pxHigherPriorityTaskWoken )
@@ -0,0 +1,323 @@
+/*
+ * FreeRTOS Kernel V10.2.1
+ * Copyright (C) 2019 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Memory pools hand out fixed size blocks of memory from a preallocated area.
+ * Unlike pvPortMalloc() the execution time of allocating and freeing a block
+ * does not depend on the state of the pool, and the pool cannot fragment, so
+ * they are suited to allocating messages and buffers from interrupts and from
+ * time critical tasks.
+ *
+ * Freed blocks are kept in a singly linked list that is threaded through the
+ * first bytes of the blocks themselves, so a pool needs no memory beyond its
+ * blocks and a small control structure.  Each call to allocate or free a block
+ * only accesses the head of that list inside a short critical section.  Memory
+ * pool functions never block.
+ */
+
+#ifndef MEM_POOL_H
+#define MEM_POOL_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h" must appear in source files before "include mem_pool.h"
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which memory pools are referenced.  For example, a call to
+ * xMemPoolCreate() returns a MemPoolHandle_t variable that can then be used as
+ * a parameter to pvMemPoolAlloc(), xMemPoolFree(), etc.
+ */
+struct MemPoolDef_t;
+typedef struct MemPoolDef_t * MemPoolHandle_t;
+
+/*
+ * The size each block actually occupies.  Blocks are rounded up to a multiple
+ * of portBYTE_ALIGNMENT so every block is suitably aligned for any data type,
+ * and can hold the pointer used to link it into the free list.
+ */
+#define memPOOL_BLOCK_SIZE( xBlockSize ) ( ( ( size_t ) ( xBlockSize ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/*
+ * The number of bytes of storage that must be provided to
+ * xMemPoolCreateStatic() for uxBlockCount blocks of xBlockSize bytes.
+ */
+#define memPOOL_STORAGE_SIZE( xBlockSize, uxBlockCount ) ( memPOOL_BLOCK_SIZE( xBlockSize ) * ( size_t ) ( uxBlockCount ) )
+
+/**
+ * mem_pool.h
+ *
+<pre>
+MemPoolHandle_t xMemPoolCreate( size_t xBlockSize, UBaseType_t uxBlockCount );
+</pre>
+ *
+ * Creates a new memory pool using dynamically allocated memory.  The control
+ * structure and the blocks are allocated with a single call to pvPortMalloc().
+ * See xMemPoolCreateStatic() for a version that uses statically allocated
+ * memory (memory that is allocated at compile time).
+ *
+ * configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 or left undefined in
+ * FreeRTOSConfig.h for xMemPoolCreate() to be available.
+ *
+ * @param xBlockSize The size of each block in bytes.
+ *
+ * @param uxBlockCount The number of blocks in the pool.
+ *
+ * @return If NULL is returned, then the pool cannot be created because there
+ * is insufficient heap memory available.  A non-NULL value being returned
+ * indicates that the pool has been created successfully - the returned value
+ * should be stored as the handle to the created pool.
+ *
+ * \defgroup xMemPoolCreate xMemPoolCreate
+ * \ingroup MemPoolManagement
+ */
+MemPoolHandle_t xMemPoolCreate( size_t xBlockSize, UBaseType_t uxBlockCount ) PRIVILEGED_FUNCTION;
+
+/**
+ * mem_pool.h
+ *
+<pre>
+MemPoolHandle_t xMemPoolCreateStatic( size_t xBlockSize,
+                                      UBaseType_t uxBlockCount,
+                                      uint8_t *pucPoolStorageArea,
+                                      StaticMemPool_t *pxStaticMemPool );
+</pre>
+ *
+ * Creates a new memory pool using statically allocated memory.  See
+ * xMemPoolCreate() for a version that uses dynamically allocated memory.
+ *
+ * configSUPPORT_STATIC_ALLOCATION must be set to 1 in FreeRTOSConfig.h for
+ * xMemPoolCreateStatic() to be available.
+ *
+ * @param xBlockSize The size of each block in bytes.
+ *
+ * @param uxBlockCount The number of blocks in the pool.
+ *
+ * @param pucPoolStorageArea Must point to a uint8_t array that is at least
+ * memPOOL_STORAGE_SIZE( xBlockSize, uxBlockCount ) bytes big, and aligned to
+ * portBYTE_ALIGNMENT.  This is the array in which the blocks are held.
+ *
+ * @param pxStaticMemPool Must point to a variable of type StaticMemPool_t,
+ * which will be used to hold the pool's data structure.
+ *
+ * @return If the pool is created successfully then a handle to the created
+ * pool is returned.  If either pucPoolStorageArea or pxStaticMemPool are NULL
+ * then NULL is returned.
+ *
+ * Example use:
+<pre>
+typedef struct { uint8_t ucId; uint8_t ucData[ 30 ]; } Message_t;
+
+#define NUM_MESSAGES 8
+
+static uint8_t ucStorage[ memPOOL_STORAGE_SIZE( sizeof( Message_t ), NUM_MESSAGES ) ] __attribute__( ( aligned( portBYTE_ALIGNMENT ) ) );
+static StaticMemPool_t xPoolStruct;
+
+void MyFunction( void )
+{
+MemPoolHandle_t xPool;
+
+    xPool = xMemPoolCreateStatic( sizeof( Message_t ), NUM_MESSAGES, ucStorage, &xPoolStruct );
+
+    // As neither the pucPoolStorageArea or pxStaticMemPool parameters were
+    // NULL, xPool will not be NULL, and can be used to reference the created
+    // pool in other memory pool API calls.
+}
+</pre>
+ * \defgroup xMemPoolCreateStatic xMemPoolCreateStatic
+ * \ingroup MemPoolManagement
+ */
+MemPoolHandle_t xMemPoolCreateStatic( size_t xBlockSize,
+									  UBaseType_t uxBlockCount,
+									  uint8_t * const pucPoolStorageArea,
+									  StaticMemPool_t * const pxStaticMemPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * mem_pool.h
+ *
+<pre>
+void vMemPoolDelete( MemPoolHandle_t xMemPool );
+</pre>
+ *
+ * Deletes a memory pool that was previously created using a call to
+ * xMemPoolCreate() or xMemPoolCreateStatic().  If the pool was created using
+ * dynamic memory then the memory is freed.  Blocks that are still allocated
+ * from the pool must not be used after the pool is deleted.
+ *
+ * @param xMemPool The handle of the memory pool to be deleted.
+ *
+ * \defgroup vMemPoolDelete vMemPoolDelete
+ * \ingroup MemPoolManagement
+ */
+void vMemPoolDelete( MemPoolHandle_t xMemPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * mem_pool.h
+ *
+<pre>
+void *pvMemPoolAlloc( MemPoolHandle_t xMemPool );
+</pre>
+ *
+ * Takes a block from a memory pool.  The contents of the block are undefined.
+ *
+ * Use pvMemPoolAlloc() to allocate a block from a task.  Use
+ * pvMemPoolAllocFromISR() to allocate a block from an interrupt service
+ * routine (ISR).
+ *
+ * @param xMemPool The handle of the memory pool.
+ *
+ * @return A pointer to the block, or NULL if all the blocks are in use.
+ *
+ * \defgroup pvMemPoolAlloc pvMemPoolAlloc
+ * \ingroup MemPoolManagement
+ */
+void *pvMemPoolAlloc( MemPoolHandle_t xMemPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * mem_pool.h
+ *
+<pre>
+void *pvMemPoolAllocFromISR( MemPoolHandle_t xMemPool );
+</pre>
+ *
+ * A version of pvMemPoolAlloc() that can be called from an interrupt service
+ * routine (ISR).
+ *
+ * \defgroup pvMemPoolAllocFromISR pvMemPoolAllocFromISR
+ * \ingroup MemPoolManagement
+ */
+void *pvMemPoolAllocFromISR( MemPoolHandle_t xMemPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * mem_pool.h
+ *
+<pre>
+BaseType_t xMemPoolFree( MemPoolHandle_t xMemPool, void *pvBlock );
+</pre>
+ *
+ * Returns a block to the memory pool it was allocated from.
+ *
+ * Use xMemPoolFree() to free a block from a task.  Use xMemPoolFreeFromISR()
+ * to free a block from an interrupt service routine (ISR).
+ *
+ * @param xMemPool The handle of the memory pool.
+ *
+ * @param pvBlock A block previously returned by pvMemPoolAlloc() or
+ * pvMemPoolAllocFromISR() for the same pool.
+ *
+ * @return pdPASS if the block was returned to the pool.  pdFAIL if pvBlock does
+ * not point to the start of a block in the pool, or if the block is already
+ * free.  Freeing a block that is already free also fails configASSERT().  A
+ * block that has never been allocated is always detected.  A block freed twice
+ * is detected when the blocks are at least two pointers big, which is always
+ * the case with 32-bit pointers and a portBYTE_ALIGNMENT of 8: free blocks
+ * then hold a marker after the free list link.
+ *
+ * \defgroup xMemPoolFree xMemPoolFree
+ * \ingroup MemPoolManagement
+ */
+BaseType_t xMemPoolFree( MemPoolHandle_t xMemPool, void *pvBlock ) PRIVILEGED_FUNCTION;
+
+/**
+ * mem_pool.h
+ *
+<pre>
+BaseType_t xMemPoolFreeFromISR( MemPoolHandle_t xMemPool, void *pvBlock );
+</pre>
+ *
+ * A version of xMemPoolFree() that can be called from an interrupt service
+ * routine (ISR).
+ *
+ * \defgroup xMemPoolFreeFromISR xMemPoolFreeFromISR
+ * \ingroup MemPoolManagement
+ */
+BaseType_t xMemPoolFreeFromISR( MemPoolHandle_t xMemPool, void *pvBlock ) PRIVILEGED_FUNCTION;
+
+/**
+ * mem_pool.h
+ *
+<pre>
+UBaseType_t uxMemPoolGetFreeCount( MemPoolHandle_t xMemPool );
+</pre>
+ *
+ * Queries the number of blocks that can currently be allocated from a memory
+ * pool.  Can be called from tasks and interrupts.
+ *
+ * @param xMemPool The handle of the memory pool being queried.
+ *
+ * @return The number of free blocks.
+ *
+ * \defgroup uxMemPoolGetFreeCount uxMemPoolGetFreeCount
+ * \ingroup MemPoolManagement
+ */
+UBaseType_t uxMemPoolGetFreeCount( MemPoolHandle_t xMemPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * mem_pool.h
+ *
+<pre>
+UBaseType_t uxMemPoolGetMinimumEverFreeCount( MemPoolHandle_t xMemPool );
+</pre>
+ *
+ * Queries the lowest number of free blocks a memory pool has had since it was
+ * created, which shows how close the pool has come to running out and so
+ * whether it can be made smaller.  Can be called from tasks and interrupts.
+ *
+ * @param xMemPool The handle of the memory pool being queried.
+ *
+ * @return The minimum number of free blocks that has existed in the pool.
+ *
+ * \defgroup uxMemPoolGetMinimumEverFreeCount uxMemPoolGetMinimumEverFreeCount
+ * \ingroup MemPoolManagement
+ */
+UBaseType_t uxMemPoolGetMinimumEverFreeCount( MemPoolHandle_t xMemPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * mem_pool.h
+ *
+<pre>
+UBaseType_t uxMemPoolGetBlockCount( MemPoolHandle_t xMemPool );
+size_t xMemPoolGetBlockSize( MemPoolHandle_t xMemPool );
+</pre>
+ *
+ * Query the number of blocks in a memory pool, and the size of each block
+ * after it has been rounded up by memPOOL_BLOCK_SIZE().
+ *
+ * \defgroup uxMemPoolGetBlockCount uxMemPoolGetBlockCount
+ * \ingroup MemPoolManagement
+ */
+UBaseType_t uxMemPoolGetBlockCount( MemPoolHandle_t xMemPool ) PRIVILEGED_FUNCTION;
+size_t xMemPoolGetBlockSize( MemPoolHandle_t xMemPool ) PRIVILEGED_FUNCTION;
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( MEM_POOL_H ) */
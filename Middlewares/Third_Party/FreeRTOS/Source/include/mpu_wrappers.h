@@ -91,6 +91,8 @@ only for ports that are using the MPU. */
 		/* Map standard queue.h API functions to the MPU equivalents. */
 		#define xQueueGenericSend						MPU_xQueueGenericSend
 		#define xQueueReceive							MPU_xQueueReceive
+		#define xQueueSendMultiple						MPU_xQueueSendMultiple
+		#define xQueueReceiveMultiple					MPU_xQueueReceiveMultiple
 		#define xQueuePeek								MPU_xQueuePeek
 		#define xQueueSemaphoreTake						MPU_xQueueSemaphoreTake
 		#define uxQueueMessagesWaiting					MPU_uxQueueMessagesWaiting
@@ -108,6 +110,8 @@ only for ports that are using the MPU. */
 		#define xQueueCreateSet							MPU_xQueueCreateSet
 		#define xQueueAddToSet							MPU_xQueueAddToSet
 		#define xQueueRemoveFromSet						MPU_xQueueRemoveFromSet
+		#define xQueueAddToEventGroup					MPU_xQueueAddToEventGroup
+		#define xQueueRemoveFromEventGroup				MPU_xQueueRemoveFromEventGroup
 		#define xQueueSelectFromSet						MPU_xQueueSelectFromSet
 		#define xQueueGenericReset						MPU_xQueueGenericReset
 
@@ -144,6 +148,10 @@ only for ports that are using the MPU. */
 		equivalents. */
 		#define xStreamBufferSend						MPU_xStreamBufferSend
 		#define xStreamBufferReceive					MPU_xStreamBufferReceive
+		#define xStreamBufferSendAcquire				MPU_xStreamBufferSendAcquire
+		#define vStreamBufferSendCommit					MPU_vStreamBufferSendCommit
+		#define xStreamBufferReceiveAcquire				MPU_xStreamBufferReceiveAcquire
+		#define vStreamBufferReceiveRelease				MPU_vStreamBufferReceiveRelease
 		#define xStreamBufferNextMessageLengthBytes		MPU_xStreamBufferNextMessageLengthBytes
 		#define vStreamBufferDelete						MPU_vStreamBufferDelete
 		#define xStreamBufferIsFull						MPU_xStreamBufferIsFull
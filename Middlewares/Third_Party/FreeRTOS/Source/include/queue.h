@@ -39,6 +39,11 @@ extern "C" {
 
 #include "task.h"
 
+#if( configUSE_QUEUE_EVENT_BITS == 1 )
+	/* xQueueAddToEventGroup() takes an event group handle. */
+	#include "event_groups.h"
+#endif
+
 /**
  * Type by which queues are referenced.  For example, a call to xQueueCreate()
  * returns an QueueHandle_t variable that can then be used as a parameter to
@@ -867,6 +872,124 @@ BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue, void * const pvBuffer ) PRIV
  */
 BaseType_t xQueueReceive( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * <pre>
+ BaseType_t xQueueSendMultiple(
+								QueueHandle_t xQueue,
+								const void *pvItemsToQueue,
+								UBaseType_t uxItemCount,
+								TickType_t xTicksToWait
+							);
+ * </pre>
+ *
+ * Post several items to the back of a queue.  Items are queued by copy, not by
+ * reference, and are taken from the array pvItemsToQueue.  All the items that
+ * there is space for are copied, and the tasks waiting to receive them are
+ * unblocked, within a single critical section, which is much cheaper than
+ * calling xQueueSend() once for each item.  This function must not be called
+ * from an interrupt service routine.  See xQueueSendMultipleFromISR() for an
+ * alternative which may be used in an ISR.
+ *
+ * If the queue becomes full before all the items have been posted the calling
+ * task blocks for up to xTicksToWait ticks waiting for space for the rest.
+ * This function cannot be used with semaphores or mutexes.
+ *
+ * @param xQueue The handle to the queue on which the items are to be posted.
+ *
+ * @param pvItemsToQueue A pointer to an array of uxItemCount items.  The size
+ * of each item is defined when the queue is created.
+ *
+ * @param uxItemCount The number of items to post, which must not be zero.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for space to become available on the queue.  The call will return
+ * immediately once the queue is full if this is set to 0.
+ *
+ * @return The number of items posted, which is less than uxItemCount if the
+ * block time expired before there was space for all of them.
+ *
+ * Example usage:
+   <pre>
+ QueueHandle_t xQueue;
+
+ void vATask( void *pvParameters )
+ {
+ uint16_t usSamples[ 32 ];
+
+	// Create a queue capable of containing 128 samples.
+	xQueue = xQueueCreate( 128, sizeof( uint16_t ) );
+
+	// ...
+
+	// Post a block of samples, waiting up to 10 ticks for space.
+	if( xQueueSendMultiple( xQueue, usSamples, 32, ( TickType_t ) 10 ) != 32 )
+	{
+		// Some of the samples could not be posted.
+	}
+ }
+ </pre>
+ * \defgroup xQueueSendMultiple xQueueSendMultiple
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueSendMultiple( QueueHandle_t xQueue, const void * const pvItemsToQueue, const UBaseType_t uxItemCount, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>
+ BaseType_t xQueueReceiveMultiple(
+									QueueHandle_t xQueue,
+									void *pvBuffer,
+									UBaseType_t uxMaxItems,
+									TickType_t xTicksToWait
+								);
+ * </pre>
+ *
+ * Receive several items from a queue.  The items are received by copy into the
+ * array pvBuffer.  All the items available, up to uxMaxItems, are copied, and
+ * the tasks waiting for the space they occupied are unblocked, within a single
+ * critical section.  The calling task only blocks while the queue is empty.
+ * This function must not be called from an interrupt service routine.  See
+ * xQueueReceiveMultipleFromISR() for an alternative that can.  This function
+ * cannot be used with semaphores or mutexes.
+ *
+ * @param xQueue The handle to the queue from which the items are to be
+ * received.
+ *
+ * @param pvBuffer Pointer to an array of uxMaxItems items into which the
+ * received items will be copied.
+ *
+ * @param uxMaxItems The maximum number of items to receive, which must not be
+ * zero.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for an item to receive should the queue be empty at the time of the
+ * call.  xQueueReceiveMultiple() will return immediately if xTicksToWait is
+ * zero and the queue is empty.
+ *
+ * @return The number of items received, which is 0 if the queue remained
+ * empty.
+ *
+ * Example usage:
+   <pre>
+ void vADifferentTask( void *pvParameters )
+ {
+ uint16_t usSamples[ 32 ];
+ BaseType_t xCount;
+
+	for( ;; )
+	{
+		// Wait for samples, then process all those received at once.
+		xCount = xQueueReceiveMultiple( xQueue, usSamples, 32, portMAX_DELAY );
+		vProcessSamples( usSamples, xCount );
+	}
+ }
+ </pre>
+ * \defgroup xQueueReceiveMultiple xQueueReceiveMultiple
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue, void * const pvBuffer, const UBaseType_t uxMaxItems, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
 /**
  * queue. h
  * <pre>UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue );</pre>
@@ -1384,6 +1507,97 @@ BaseType_t xQueueGiveFromISR( QueueHandle_t xQueue, BaseType_t * const pxHigherP
  */
 BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue, void * const pvBuffer, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * <pre>
+ BaseType_t xQueueSendMultipleFromISR(
+										QueueHandle_t xQueue,
+										const void *pvItemsToQueue,
+										UBaseType_t uxItemCount,
+										BaseType_t *pxHigherPriorityTaskWoken
+									);
+ * </pre>
+ *
+ * Post several items to the back of a queue.  It is safe to use this function
+ * from within an interrupt service routine.  The items that there is space
+ * for are posted with interrupts masked once, and the tasks waiting for them
+ * are unblocked with a single context switch request, rather than one for each
+ * item as when xQueueSendFromISR() is called in a loop.
+ *
+ * @param xQueue The handle to the queue on which the items are to be posted.
+ *
+ * @param pvItemsToQueue A pointer to an array of uxItemCount items.
+ *
+ * @param uxItemCount The number of items to post, which must not be zero.
+ *
+ * @param pxHigherPriorityTaskWoken xQueueSendMultipleFromISR() will set
+ * *pxHigherPriorityTaskWoken to pdTRUE if posting the items caused a task to
+ * unblock, and the unblocked task has a priority higher than the currently
+ * running task.  If xQueueSendMultipleFromISR() sets this value to pdTRUE
+ * then a context switch should be requested before the interrupt is exited.
+ *
+ * @return The number of items posted, which is less than uxItemCount if the
+ * queue became full.
+ *
+ * Example usage for buffered IO (where the ISR can obtain more than one value
+ * per call):
+   <pre>
+ void vBufferISR( void )
+ {
+ uint16_t usSamples[ 64 ];
+ BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	vReadSamples( usSamples, 64 );
+
+	// Post the whole burst at once.
+	if( xQueueSendMultipleFromISR( xRxQueue, usSamples, 64, &xHigherPriorityTaskWoken ) != 64 )
+	{
+		// The queue overflowed.
+	}
+
+	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+ }
+ </pre>
+ *
+ * \defgroup xQueueSendMultipleFromISR xQueueSendMultipleFromISR
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue, const void * const pvItemsToQueue, const UBaseType_t uxItemCount, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>
+ BaseType_t xQueueReceiveMultipleFromISR(
+											QueueHandle_t xQueue,
+											void *pvBuffer,
+											UBaseType_t uxMaxItems,
+											BaseType_t *pxHigherPriorityTaskWoken
+										);
+ * </pre>
+ *
+ * Receive several items from a queue.  It is safe to use this function from
+ * within an interrupt service routine.
+ *
+ * @param xQueue The handle to the queue from which the items are to be
+ * received.
+ *
+ * @param pvBuffer Pointer to an array of uxMaxItems items into which the
+ * received items will be copied.
+ *
+ * @param uxMaxItems The maximum number of items to receive, which must not be
+ * zero.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if removing the items caused
+ * a task waiting for space in the queue to unblock, and the unblocked task has
+ * a priority higher than the currently running task.
+ *
+ * @return The number of items received, which is 0 if the queue was empty.
+ *
+ * \defgroup xQueueReceiveMultipleFromISR xQueueReceiveMultipleFromISR
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue, void * const pvBuffer, const UBaseType_t uxMaxItems, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /*
  * Utilities to query queues that are safe to use from an ISR.  These utilities
  * should be used only from witin an ISR, or within a critical section.
@@ -1639,6 +1853,94 @@ QueueSetMemberHandle_t xQueueSelectFromSet( QueueSetHandle_t xQueueSet, const Ti
  */
 QueueSetMemberHandle_t xQueueSelectFromSetFromISR( QueueSetHandle_t xQueueSet ) PRIVILEGED_FUNCTION;
 
+/*
+ * Has a queue or semaphore set bits in an event group whenever data is posted
+ * to the queue, or the semaphore is given, from a task or from an interrupt.
+ * configUSE_QUEUE_EVENT_BITS must be set to 1 in FreeRTOSConfig.h for
+ * xQueueAddToEventGroup() to be available.
+ *
+ * This allows a task to block on any number of queues, semaphores and event
+ * bits at once by calling xEventGroupWaitBits() with xWaitForAllBits set to
+ * pdFALSE, without the overhead of a queue set.  Unlike a queue set the event
+ * group does not count the items posted, so when xEventGroupWaitBits() returns
+ * the task must read each queue whose bits were set, using a block time of 0,
+ * until the queue is empty.  If xClearOnExit is pdTRUE then a bit that is set
+ * again while the queue is being emptied only causes the next call to
+ * xEventGroupWaitBits() to return straight away, so no data can be missed.
+ *
+ * Bits are set from interrupts without going through the timer service task,
+ * so configUSE_EVENT_GROUP_DIRECT_ISR must also be set to 1.
+ *
+ * Example usage:
+   <pre>
+ #define RX_BIT		( 1 << 0 )
+ #define SEM_BIT	( 1 << 1 )
+ #define STOP_BIT	( 1 << 2 )
+
+ void vAFunction( QueueHandle_t xRxQueue, SemaphoreHandle_t xSemaphore, EventGroupHandle_t xEvents )
+ {
+ EventBits_t uxBits;
+ uint8_t ucByte;
+
+	xQueueAddToEventGroup( xRxQueue, xEvents, RX_BIT );
+	xQueueAddToEventGroup( xSemaphore, xEvents, SEM_BIT );
+
+	for( ;; )
+	{
+		uxBits = xEventGroupWaitBits( xEvents, RX_BIT | SEM_BIT | STOP_BIT, pdTRUE, pdFALSE, portMAX_DELAY );
+
+		if( ( uxBits & RX_BIT ) != 0 )
+		{
+			while( xQueueReceive( xRxQueue, &ucByte, 0 ) == pdPASS )
+			{
+				// Process ucByte.
+			}
+		}
+
+		if( ( ( uxBits & SEM_BIT ) != 0 ) && ( xSemaphoreTake( xSemaphore, 0 ) == pdPASS ) )
+		{
+			// The semaphore was given.
+		}
+
+		if( ( uxBits & STOP_BIT ) != 0 )
+		{
+			// STOP_BIT was set by xEventGroupSetBits().
+		}
+	}
+ }
+   </pre>
+ *
+ * @param xQueueOrSemaphore The handle of the queue or semaphore (cast to an
+ * QueueSetMemberHandle_t type).
+ *
+ * @param xEventGroup The event group in which the bits are to be set.
+ *
+ * @param uxBitsToSet The bits to set in xEventGroup.  If the queue already
+ * contains data, or the semaphore is available, then the bits are set straight
+ * away.
+ *
+ * @return pdPASS if the queue or semaphore was added to the event group, or
+ * pdFAIL if it had already been added to an event group.
+ */
+#if( configUSE_QUEUE_EVENT_BITS == 1 )
+	BaseType_t xQueueAddToEventGroup( QueueSetMemberHandle_t xQueueOrSemaphore, EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Stops a queue or semaphore setting bits in an event group.
+ *
+ * @param xQueueOrSemaphore The handle of the queue or semaphore (cast to an
+ * QueueSetMemberHandle_t type).
+ *
+ * @param xEventGroup The event group the queue or semaphore was added to.
+ *
+ * @return pdPASS if the queue or semaphore was removed from the event group, or
+ * pdFAIL if it had not been added to xEventGroup.
+ */
+#if( configUSE_QUEUE_EVENT_BITS == 1 )
+	BaseType_t xQueueRemoveFromEventGroup( QueueSetMemberHandle_t xQueueOrSemaphore, EventGroupHandle_t xEventGroup ) PRIVILEGED_FUNCTION;
+#endif
+
 /* Not public API functions. */
 void vQueueWaitForMessageRestricted( QueueHandle_t xQueue, TickType_t xTicksToWait, const BaseType_t xWaitIndefinitely ) PRIVILEGED_FUNCTION;
 BaseType_t xQueueGenericReset( QueueHandle_t xQueue, BaseType_t xNewQueue ) PRIVILEGED_FUNCTION;
@@ -586,6 +586,246 @@ size_t xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer,
 									size_t xBufferLengthBytes,
 									BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferSendAcquire( StreamBufferHandle_t xStreamBuffer,
+                                 void **ppvRegion,
+                                 TickType_t xTicksToWait );
+</pre>
+ *
+ * Obtains a region of free space in a stream buffer that the caller can write
+ * to in place, for example as the destination of a DMA transfer, instead of
+ * having the data copied in by xStreamBufferSend().  The data only becomes
+ * visible to the reader once it is committed with vStreamBufferSendCommit()
+ * or vStreamBufferSendCommitFromISR().
+ *
+ * The region is always contiguous, so when the free space wraps around the end
+ * of the buffer's storage area only the part up to the end is returned.  The
+ * rest is returned by the next call once the first part has been committed.
+ *
+ * Like the rest of the stream buffer API, the zero copy functions assume there
+ * is only one writer and one reader.  The writer owns the buffer's head index
+ * and the reader owns its tail index, so neither side needs a critical section
+ * unless it has to block.  The zero copy functions cannot be used with message
+ * buffers.
+ *
+ * Use xStreamBufferSendAcquire() from a task.  Use
+ * xStreamBufferSendAcquireFromISR() from an interrupt service routine (ISR).
+ *
+ * @param xStreamBuffer The handle of the stream buffer being written to.
+ *
+ * @param ppvRegion Set to point to the start of the region on return.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for space to become available if the stream buffer is
+ * full.
+ *
+ * @return The number of bytes that can be written starting at *ppvRegion, which
+ * is zero if the stream buffer remained full.
+ *
+ * Example use:
+<pre>
+void vAFunction( StreamBufferHandle_t xStreamBuffer )
+{
+void *pvRegion;
+size_t xLength;
+
+    // Wait up to 100ms for space, then let the DMA fill it directly.
+    xLength = xStreamBufferSendAcquire( xStreamBuffer, &pvRegion, pdMS_TO_TICKS( 100 ) );
+
+    if( xLength > 0 )
+    {
+        vStartDMA( pvRegion, xLength );
+
+        // vStreamBufferSendCommitFromISR() is called from the DMA complete
+        // interrupt with the number of bytes transferred.
+    }
+}
+</pre>
+ * \defgroup xStreamBufferSendAcquire xStreamBufferSendAcquire
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferSendAcquire( StreamBufferHandle_t xStreamBuffer,
+								 void **ppvRegion,
+								 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferSendAcquireFromISR( StreamBufferHandle_t xStreamBuffer,
+                                        void **ppvRegion );
+</pre>
+ *
+ * An interrupt safe version of xStreamBufferSendAcquire().  It never blocks.
+ *
+ * \defgroup xStreamBufferSendAcquireFromISR xStreamBufferSendAcquireFromISR
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferSendAcquireFromISR( StreamBufferHandle_t xStreamBuffer,
+										void **ppvRegion ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+void vStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer,
+                              size_t xBytesWritten );
+</pre>
+ *
+ * Makes xBytesWritten bytes written into the region returned by the last call
+ * to xStreamBufferSendAcquire() (or xStreamBufferSendAcquireFromISR())
+ * available to the reader, and unblocks a task waiting to receive if the
+ * trigger level has been reached.  xBytesWritten must not exceed the length of
+ * that region.  Committing fewer bytes leaves the rest of the region free.
+ *
+ * Use vStreamBufferSendCommit() from a task.  Use
+ * vStreamBufferSendCommitFromISR() from an interrupt service routine (ISR).
+ *
+ * @param xStreamBuffer The handle of the stream buffer that was written to.
+ *
+ * @param xBytesWritten The number of bytes written at the start of the region.
+ *
+ * \defgroup vStreamBufferSendCommit vStreamBufferSendCommit
+ * \ingroup StreamBufferManagement
+ */
+void vStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer,
+							  size_t xBytesWritten ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+void vStreamBufferSendCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+                                     size_t xBytesWritten,
+                                     BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * An interrupt safe version of vStreamBufferSendCommit().
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if committing the data
+ * unblocked a task that has a priority above the interrupted task, in which
+ * case a context switch should be performed before the interrupt is exited.
+ * *pxHigherPriorityTaskWoken should be set to pdFALSE before it is passed into
+ * the function.
+ *
+ * \defgroup vStreamBufferSendCommitFromISR vStreamBufferSendCommitFromISR
+ * \ingroup StreamBufferManagement
+ */
+void vStreamBufferSendCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+									 size_t xBytesWritten,
+									 BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer,
+                                    void **ppvRegion,
+                                    TickType_t xTicksToWait );
+</pre>
+ *
+ * Obtains a region of the stream buffer holding received data that the caller
+ * can read in place, for example as the source of a DMA transfer, instead of
+ * having the data copied out by xStreamBufferReceive().  The space is only
+ * returned to the writer once it is released with
+ * vStreamBufferReceiveRelease() or vStreamBufferReceiveReleaseFromISR().
+ *
+ * As with xStreamBufferSendAcquire(), the region is contiguous, so data that
+ * wraps around the end of the buffer's storage area is returned in two parts.
+ *
+ * Use xStreamBufferReceiveAcquire() from a task.  Use
+ * xStreamBufferReceiveAcquireFromISR() from an interrupt service routine (ISR).
+ *
+ * @param xStreamBuffer The handle of the stream buffer being read from.
+ *
+ * @param ppvRegion Set to point to the start of the region on return.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for data if the stream buffer is empty.  As with
+ * xStreamBufferReceive(), a blocked task is unblocked when the buffer's trigger
+ * level is reached.
+ *
+ * @return The number of bytes that can be read starting at *ppvRegion, which is
+ * zero if the stream buffer remained empty.
+ *
+ * \defgroup xStreamBufferReceiveAcquire xStreamBufferReceiveAcquire
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer,
+									void **ppvRegion,
+									TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferReceiveAcquireFromISR( StreamBufferHandle_t xStreamBuffer,
+                                           void **ppvRegion );
+</pre>
+ *
+ * An interrupt safe version of xStreamBufferReceiveAcquire().  It never
+ * blocks.
+ *
+ * \defgroup xStreamBufferReceiveAcquireFromISR xStreamBufferReceiveAcquireFromISR
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferReceiveAcquireFromISR( StreamBufferHandle_t xStreamBuffer,
+										   void **ppvRegion ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+void vStreamBufferReceiveRelease( StreamBufferHandle_t xStreamBuffer,
+                                  size_t xBytesRead );
+</pre>
+ *
+ * Returns xBytesRead bytes at the start of the region returned by the last
+ * call to xStreamBufferReceiveAcquire() (or
+ * xStreamBufferReceiveAcquireFromISR()) to the writer, and unblocks a task
+ * waiting for space.  xBytesRead must not exceed the length of that region.
+ * Releasing fewer bytes leaves the rest in the buffer.
+ *
+ * Use vStreamBufferReceiveRelease() from a task.  Use
+ * vStreamBufferReceiveReleaseFromISR() from an interrupt service routine (ISR).
+ *
+ * @param xStreamBuffer The handle of the stream buffer that was read from.
+ *
+ * @param xBytesRead The number of bytes consumed from the start of the region.
+ *
+ * \defgroup vStreamBufferReceiveRelease vStreamBufferReceiveRelease
+ * \ingroup StreamBufferManagement
+ */
+void vStreamBufferReceiveRelease( StreamBufferHandle_t xStreamBuffer,
+								  size_t xBytesRead ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+void vStreamBufferReceiveReleaseFromISR( StreamBufferHandle_t xStreamBuffer,
+                                         size_t xBytesRead,
+                                         BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * An interrupt safe version of vStreamBufferReceiveRelease().
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if releasing the space
+ * unblocked a task that has a priority above the interrupted task, in which
+ * case a context switch should be performed before the interrupt is exited.
+ * *pxHigherPriorityTaskWoken should be set to pdFALSE before it is passed into
+ * the function.
+ *
+ * \defgroup vStreamBufferReceiveReleaseFromISR vStreamBufferReceiveReleaseFromISR
+ * \ingroup StreamBufferManagement
+ */
+void vStreamBufferReceiveReleaseFromISR( StreamBufferHandle_t xStreamBuffer,
+										 size_t xBytesRead,
+										 BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /**
  * stream_buffer.h
  *
@@ -0,0 +1,563 @@
+/*
+ * FreeRTOS Kernel V10.2.1
+ * Copyright (C) 2019 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mem_pool.h"
+
+/* Lint e961, e9021 and e750 are suppressed as a MISRA exception justified
+because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+for the header files above, but not in this file, in order to generate the
+correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
+
+/* Bits that can be set in MemPool_t.ucFlags. */
+#define mpFLAGS_IS_STATICALLY_ALLOCATED	( ( uint8_t ) 1 ) /* Set if the pool was created using statically allocated memory. */
+#define mpFLAGS_HAS_FREE_MARKER			( ( uint8_t ) 2 ) /* Set if the blocks are big enough to hold a free marker. */
+
+/* The value a free block holds after its link when the pool has
+mpFLAGS_HAS_FREE_MARKER set.  It depends on the block's address, so that data
+left in an allocated block is unlikely to match it. */
+#define mpFREE_MARKER( pvBlock )		( ( ( portPOINTER_SIZE_TYPE ) ( pvBlock ) ) ^ ( portPOINTER_SIZE_TYPE ) 0xA55AA55AUL )
+
+/*-----------------------------------------------------------*/
+
+/* A free block holds the address of the next free block in its first bytes,
+followed by mpFREE_MARKER() if the block is big enough. */
+typedef struct MemPoolFreeBlock
+{
+	struct MemPoolFreeBlock *pxNextFreeBlock;
+	portPOINTER_SIZE_TYPE uxFreeMarker;	/* Only used if mpFLAGS_HAS_FREE_MARKER is set. */
+} MemPoolFreeBlock_t;
+
+/* Structure that holds state information on the memory pool. */
+typedef struct MemPoolDef_t /*lint !e9058 Style convention uses tag. */
+{
+	MemPoolFreeBlock_t *pxFreeList;		/* Blocks that have been freed, most recently freed first. */
+	uint8_t *pucNextUnused;				/* The first block that has never been allocated, or NULL once all have been. */
+	uint8_t *pucStorage;				/* The start of the blocks. */
+	size_t xBlockSize;					/* The size of each block after it has been rounded up by memPOOL_BLOCK_SIZE(). */
+	UBaseType_t uxBlockCount;			/* The number of blocks in the pool. */
+	volatile UBaseType_t uxFreeCount;	/* The number of blocks that can currently be allocated. */
+	UBaseType_t uxMinimumEverFreeCount;	/* The lowest value uxFreeCount has had. */
+	uint8_t ucFlags;
+} MemPool_t;
+
+/*
+ * Called by both pvMemPoolAlloc() and pvMemPoolAllocFromISR() to take a block
+ * from the pool.  Must be called from within a critical section.
+ */
+static void *prvAllocateBlock( MemPool_t * const pxMemPool ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called by both xMemPoolFree() and xMemPoolFreeFromISR() to return a block to
+ * the pool.  Must be called from within a critical section.
+ */
+static BaseType_t prvFreeBlock( MemPool_t * const pxMemPool, void *pvBlock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called by prvFreeBlock() to check whether a block that holds the free marker
+ * is in the free list.  Must be called from within a critical section.
+ */
+static BaseType_t prvIsBlockInFreeList( const MemPool_t * const pxMemPool, const void *pvBlock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called by both xMemPoolCreate() and xMemPoolCreateStatic() to initialise
+ * the pool's control structure.
+ */
+static void prvInitialiseNewMemPool( MemPool_t * const pxMemPool,
+									 size_t xBlockSize,
+									 UBaseType_t uxBlockCount,
+									 uint8_t * const pucStorage,
+									 uint8_t ucFlags ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	MemPoolHandle_t xMemPoolCreate( size_t xBlockSize, UBaseType_t uxBlockCount )
+	{
+	uint8_t *pucAllocatedMemory;
+	size_t xHeaderSize, xStorageSize;
+
+		configASSERT( xBlockSize > ( size_t ) 0 );
+		configASSERT( uxBlockCount > ( UBaseType_t ) 0 );
+
+		/* The blocks follow the control structure in the same allocation, so
+		the structure's size is rounded up to keep the first block aligned. */
+		xHeaderSize = memPOOL_BLOCK_SIZE( sizeof( MemPool_t ) );
+		xStorageSize = memPOOL_STORAGE_SIZE( xBlockSize, uxBlockCount );
+
+		/* Check the size calculation did not wrap. */
+		if( ( xStorageSize / memPOOL_BLOCK_SIZE( xBlockSize ) ) == ( size_t ) uxBlockCount )
+		{
+			pucAllocatedMemory = ( uint8_t * ) pvPortMalloc( xHeaderSize + xStorageSize ); /*lint !e9079 malloc() only returns void*. */
+		}
+		else
+		{
+			pucAllocatedMemory = NULL;
+		}
+
+		if( pucAllocatedMemory != NULL )
+		{
+			prvInitialiseNewMemPool( ( MemPool_t * ) pucAllocatedMemory, /* Structure at the start of the allocated memory. */ /*lint !e9087 Safe cast as allocated memory is aligned. */ /*lint !e826 Area is not too small and alignment is guaranteed provided malloc() behaves as expected and returns aligned buffer. */
+									 xBlockSize,
+									 uxBlockCount,
+									 pucAllocatedMemory + xHeaderSize,  /* Blocks follow. */ /*lint !e9016 Indexing past structure valid for uint8_t pointer. */
+									 0 );
+
+			traceMEM_POOL_CREATE( ( ( MemPool_t * ) pucAllocatedMemory ) );
+		}
+		else
+		{
+			traceMEM_POOL_CREATE_FAILED();
+		}
+
+		return ( MemPoolHandle_t ) pucAllocatedMemory; /*lint !e9087 !e826 Safe cast as allocated memory is aligned. */
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+	MemPoolHandle_t xMemPoolCreateStatic( size_t xBlockSize,
+										  UBaseType_t uxBlockCount,
+										  uint8_t * const pucPoolStorageArea,
+										  StaticMemPool_t * const pxStaticMemPool )
+	{
+	MemPool_t * const pxMemPool = ( MemPool_t * ) pxStaticMemPool; /*lint !e740 !e9087 Safe cast as StaticMemPool_t is opaque MemPool_t. */
+	MemPoolHandle_t xReturn;
+
+		configASSERT( pucPoolStorageArea );
+		configASSERT( pxStaticMemPool );
+		configASSERT( xBlockSize > ( size_t ) 0 );
+		configASSERT( uxBlockCount > ( UBaseType_t ) 0 );
+
+		/* Every block must be aligned, which requires the storage area itself
+		to be aligned. */
+		configASSERT( ( ( ( portPOINTER_SIZE_TYPE ) pucPoolStorageArea ) & ( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) ) == 0U );
+
+		#if( configASSERT_DEFINED == 1 )
+		{
+			/* Sanity check that the size of the structure used to declare a
+			variable of type StaticMemPool_t equals the size of the real
+			memory pool structure. */
+			volatile size_t xSize = sizeof( StaticMemPool_t );
+			configASSERT( xSize == sizeof( MemPool_t ) );
+		} /*lint !e529 xSize is referenced is configASSERT() is defined. */
+		#endif /* configASSERT_DEFINED */
+
+		if( ( pucPoolStorageArea != NULL ) && ( pxStaticMemPool != NULL ) )
+		{
+			prvInitialiseNewMemPool( pxMemPool,
+									 xBlockSize,
+									 uxBlockCount,
+									 pucPoolStorageArea,
+									 mpFLAGS_IS_STATICALLY_ALLOCATED );
+
+			traceMEM_POOL_CREATE( pxMemPool );
+
+			xReturn = ( MemPoolHandle_t ) pxStaticMemPool; /*lint !e9087 Data hiding requires cast to opaque type. */
+		}
+		else
+		{
+			xReturn = NULL;
+			traceMEM_POOL_CREATE_STATIC_FAILED();
+		}
+
+		return xReturn;
+	}
+
+#endif /* ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
+void vMemPoolDelete( MemPoolHandle_t xMemPool )
+{
+MemPool_t * pxMemPool = xMemPool;
+
+	configASSERT( pxMemPool );
+
+	traceMEM_POOL_DELETE( xMemPool );
+
+	if( ( pxMemPool->ucFlags & mpFLAGS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) pdFALSE )
+	{
+		#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+		{
+			/* Both the structure and the blocks were allocated using a single
+			call to pvPortMalloc(), hence only one call to vPortFree() is
+			required. */
+			vPortFree( ( void * ) pxMemPool ); /*lint !e9087 Standard free() semantics require void *, plus pxMemPool was allocated by pvPortMalloc(). */
+		}
+		#else
+		{
+			/* Should not be possible to get here, ucFlags must be corrupt.
+			Force an assert. */
+			configASSERT( xMemPool == ( MemPoolHandle_t ) ~0 );
+		}
+		#endif
+	}
+	else
+	{
+		/* The structure and blocks were not allocated dynamically and cannot be
+		freed - just scrub the structure so future use will assert. */
+		( void ) memset( pxMemPool, 0x00, sizeof( MemPool_t ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void *pvMemPoolAlloc( MemPoolHandle_t xMemPool )
+{
+MemPool_t * const pxMemPool = xMemPool;
+void *pvReturn;
+
+	configASSERT( pxMemPool );
+
+	taskENTER_CRITICAL();
+	{
+		pvReturn = prvAllocateBlock( pxMemPool );
+	}
+	taskEXIT_CRITICAL();
+
+	traceMEM_POOL_ALLOC( xMemPool, pvReturn );
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void *pvMemPoolAllocFromISR( MemPoolHandle_t xMemPool )
+{
+MemPool_t * const pxMemPool = xMemPool;
+void *pvReturn;
+UBaseType_t uxSavedInterruptStatus;
+
+	configASSERT( pxMemPool );
+
+	/* RTOS ports that support interrupt nesting have the concept of a maximum
+	system call (or maximum API call) interrupt priority.  Interrupts that are
+	above the maximum system call priority are kept permanently enabled, even
+	when the RTOS kernel is in a critical section, but cannot make any calls to
+	FreeRTOS API functions. */
+	portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		pvReturn = prvAllocateBlock( pxMemPool );
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	traceMEM_POOL_ALLOC_FROM_ISR( xMemPool, pvReturn );
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xMemPoolFree( MemPoolHandle_t xMemPool, void *pvBlock )
+{
+MemPool_t * const pxMemPool = xMemPool;
+BaseType_t xReturn;
+
+	configASSERT( pxMemPool );
+
+	taskENTER_CRITICAL();
+	{
+		xReturn = prvFreeBlock( pxMemPool, pvBlock );
+	}
+	taskEXIT_CRITICAL();
+
+	traceMEM_POOL_FREE( xMemPool, pvBlock );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xMemPoolFreeFromISR( MemPoolHandle_t xMemPool, void *pvBlock )
+{
+MemPool_t * const pxMemPool = xMemPool;
+BaseType_t xReturn;
+UBaseType_t uxSavedInterruptStatus;
+
+	configASSERT( pxMemPool );
+
+	portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		xReturn = prvFreeBlock( pxMemPool, pvBlock );
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	traceMEM_POOL_FREE_FROM_ISR( xMemPool, pvBlock );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxMemPoolGetFreeCount( MemPoolHandle_t xMemPool )
+{
+const MemPool_t * const pxMemPool = xMemPool;
+
+	configASSERT( pxMemPool );
+
+	return pxMemPool->uxFreeCount;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxMemPoolGetMinimumEverFreeCount( MemPoolHandle_t xMemPool )
+{
+const MemPool_t * const pxMemPool = xMemPool;
+
+	configASSERT( pxMemPool );
+
+	return pxMemPool->uxMinimumEverFreeCount;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxMemPoolGetBlockCount( MemPoolHandle_t xMemPool )
+{
+const MemPool_t * const pxMemPool = xMemPool;
+
+	configASSERT( pxMemPool );
+
+	return pxMemPool->uxBlockCount;
+}
+/*-----------------------------------------------------------*/
+
+size_t xMemPoolGetBlockSize( MemPoolHandle_t xMemPool )
+{
+const MemPool_t * const pxMemPool = xMemPool;
+
+	configASSERT( pxMemPool );
+
+	return pxMemPool->xBlockSize;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvAllocateBlock( MemPool_t * const pxMemPool )
+{
+void *pvReturn;
+
+	if( pxMemPool->pxFreeList != NULL )
+	{
+		/* Reuse the most recently freed block, which is the most likely to
+		still be in the cache on parts that have one. */
+		pvReturn = ( void * ) pxMemPool->pxFreeList;
+		pxMemPool->pxFreeList = pxMemPool->pxFreeList->pxNextFreeBlock;
+	}
+	else if( pxMemPool->pucNextUnused != NULL )
+	{
+		/* Blocks that have never been allocated are not in the free list, so
+		creating a pool does not have to walk every block.  Hand out the next
+		one. */
+		pvReturn = ( void * ) pxMemPool->pucNextUnused;
+		pxMemPool->pucNextUnused += pxMemPool->xBlockSize;
+
+		if( pxMemPool->pucNextUnused >= ( pxMemPool->pucStorage + ( pxMemPool->xBlockSize * ( size_t ) pxMemPool->uxBlockCount ) ) )
+		{
+			pxMemPool->pucNextUnused = NULL;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		pvReturn = NULL;
+	}
+
+	if( pvReturn != NULL )
+	{
+		/* Clear the marker, so that freeing the block does not take it for a
+		block that is already free. */
+		if( ( pxMemPool->ucFlags & mpFLAGS_HAS_FREE_MARKER ) != ( uint8_t ) 0 )
+		{
+			( ( MemPoolFreeBlock_t * ) pvReturn )->uxFreeMarker = ( portPOINTER_SIZE_TYPE ) 0; /*lint !e9087 !e826 Blocks are aligned by memPOOL_BLOCK_SIZE(). */
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxMemPool->uxFreeCount--;
+
+		if( pxMemPool->uxFreeCount < pxMemPool->uxMinimumEverFreeCount )
+		{
+			pxMemPool->uxMinimumEverFreeCount = pxMemPool->uxFreeCount;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvFreeBlock( MemPool_t * const pxMemPool, void *pvBlock )
+{
+uint8_t *pucBlock = ( uint8_t * ) pvBlock;
+size_t xOffset;
+BaseType_t xReturn = pdFAIL, xIsFree = pdFALSE;
+
+	/* Only a pointer to the start of a block in this pool can be freed, so
+	check the range first and then the offset from the start of the storage
+	area. */
+	if( pucBlock >= pxMemPool->pucStorage )
+	{
+		xOffset = ( size_t ) ( pucBlock - pxMemPool->pucStorage );
+
+		if( ( xOffset < ( pxMemPool->xBlockSize * ( size_t ) pxMemPool->uxBlockCount ) ) && ( ( xOffset % pxMemPool->xBlockSize ) == ( size_t ) 0 ) )
+		{
+			/* The blocks from pucNextUnused onwards have never been allocated,
+			so they are free although they are not in the free list. */
+			if( ( pxMemPool->pucNextUnused != NULL ) && ( pucBlock >= pxMemPool->pucNextUnused ) )
+			{
+				xIsFree = pdTRUE;
+			}
+			else if( pxMemPool->uxFreeCount >= pxMemPool->uxBlockCount )
+			{
+				/* Every block is already free. */
+				xIsFree = pdTRUE;
+			}
+			else if( ( ( pxMemPool->ucFlags & mpFLAGS_HAS_FREE_MARKER ) != ( uint8_t ) 0 ) &&
+					 ( ( ( MemPoolFreeBlock_t * ) pvBlock )->uxFreeMarker == mpFREE_MARKER( pvBlock ) ) ) /*lint !e9087 !e826 Blocks are aligned by memPOOL_BLOCK_SIZE(). */
+			{
+				/* A block freed twice would be in the free list twice, and
+				would then be handed out twice.  Every free block holds the
+				marker, and allocated blocks only hold it if the application
+				happened to write it, so the free list is only searched to
+				confirm a block that is most likely already free. */
+				xIsFree = prvIsBlockInFreeList( pxMemPool, pvBlock );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Freeing a block that is already free is an application error. */
+			configASSERT( xIsFree == pdFALSE );
+
+			if( xIsFree == pdFALSE )
+			{
+				( ( MemPoolFreeBlock_t * ) pvBlock )->pxNextFreeBlock = pxMemPool->pxFreeList; /*lint !e9087 !e826 Blocks are aligned by memPOOL_BLOCK_SIZE(). */
+				pxMemPool->pxFreeList = ( MemPoolFreeBlock_t * ) pvBlock; /*lint !e9087 !e826 Blocks are aligned by memPOOL_BLOCK_SIZE(). */
+
+				if( ( pxMemPool->ucFlags & mpFLAGS_HAS_FREE_MARKER ) != ( uint8_t ) 0 )
+				{
+					( ( MemPoolFreeBlock_t * ) pvBlock )->uxFreeMarker = mpFREE_MARKER( pvBlock ); /*lint !e9087 !e826 Blocks are aligned by memPOOL_BLOCK_SIZE(). */
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				pxMemPool->uxFreeCount++;
+				xReturn = pdPASS;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvIsBlockInFreeList( const MemPool_t * const pxMemPool, const void *pvBlock )
+{
+const MemPoolFreeBlock_t *pxBlock;
+BaseType_t xReturn = pdFALSE;
+
+	for( pxBlock = pxMemPool->pxFreeList; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
+	{
+		if( ( const void * ) pxBlock == pvBlock )
+		{
+			xReturn = pdTRUE;
+			break;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseNewMemPool( MemPool_t * const pxMemPool,
+									 size_t xBlockSize,
+									 UBaseType_t uxBlockCount,
+									 uint8_t * const pucStorage,
+									 uint8_t ucFlags )
+{
+	/* A free block must be able to hold the free list link. */
+	configASSERT( memPOOL_BLOCK_SIZE( xBlockSize ) >= sizeof( MemPoolFreeBlock_t * ) );
+
+	/* Blocks freed twice can only be detected in constant time if the blocks
+	can also hold the free marker.  With portBYTE_ALIGNMENT of 8 and 32-bit
+	pointers they always can. */
+	if( memPOOL_BLOCK_SIZE( xBlockSize ) >= sizeof( MemPoolFreeBlock_t ) )
+	{
+		ucFlags |= mpFLAGS_HAS_FREE_MARKER;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxMemPool->pxFreeList = NULL;
+	pxMemPool->pucNextUnused = pucStorage;
+	pxMemPool->pucStorage = pucStorage;
+	pxMemPool->xBlockSize = memPOOL_BLOCK_SIZE( xBlockSize );
+	pxMemPool->uxBlockCount = uxBlockCount;
+	pxMemPool->uxFreeCount = uxBlockCount;
+	pxMemPool->uxMinimumEverFreeCount = uxBlockCount;
+	pxMemPool->ucFlags = ucFlags;
+}
@@ -0,0 +1,732 @@
+/*
+ * FreeRTOS Kernel V10.2.1
+ * Copyright (C) 2019 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A sample implementation of pvPortMalloc() and vPortFree() that, like
+ * heap_4.c, combines adjacent memory blocks as they are freed, but keeps the
+ * free blocks in segregated lists (a two level segregated fit, or TLSF,
+ * allocator) instead of a single address ordered list.  Both pvPortMalloc()
+ * and vPortFree() therefore execute in a bounded time that does not depend on
+ * how many blocks are free, which heap_4.c cannot guarantee once the heap is
+ * fragmented.
+ *
+ * The first level list index is the position of the most significant bit of
+ * the block size, and the second level splits each of those power of two
+ * ranges into ( 1 << configTLSF_SL_INDEX_COUNT_LOG2 ) equal ranges.  A bitmap
+ * per level records which lists are not empty, so finding a block that is big
+ * enough is a couple of bit scans.  Requests are rounded up to the next list
+ * boundary before the search so any block found is large enough, which trades
+ * a small amount of internal fragmentation for the bounded execution time.  If
+ * no higher list has a block, the block at the head of the request's own list
+ * is used when it is large enough.
+ *
+ * See heap_1.c, heap_2.c, heap_3.c, heap_4.c and heap_5.c for alternative
+ * implementations, and the memory management pages of http://www.FreeRTOS.org
+ * for more information.
+ */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+/* The number of second level lists per first level list is
+( 1 << configTLSF_SL_INDEX_COUNT_LOG2 ).  More lists reduce the internal
+fragmentation caused by rounding requests up, but each costs two pointers of
+RAM per first level list. */
+#ifndef configTLSF_SL_INDEX_COUNT_LOG2
+	#define configTLSF_SL_INDEX_COUNT_LOG2	2
+#endif
+
+/* The largest block the allocator can manage is
+( ( size_t ) 2 << configTLSF_FL_INDEX_MAX ) - 1 bytes.  The default covers any
+heap smaller than 64K bytes. */
+#ifndef configTLSF_FL_INDEX_MAX
+	#define configTLSF_FL_INDEX_MAX			15
+#endif
+
+#define heapSL_INDEX_COUNT		( 1U << configTLSF_SL_INDEX_COUNT_LOG2 )
+
+/* Blocks smaller than heapSMALL_BLOCK_SIZE all live in the first first level
+list, divided into second level lists in steps of 8 bytes, which is the largest
+alignment used by the supported ports. */
+#define heapFL_INDEX_SHIFT		( configTLSF_SL_INDEX_COUNT_LOG2 + 3U )
+#define heapSMALL_BLOCK_SIZE	( ( size_t ) 1 << heapFL_INDEX_SHIFT )
+#define heapFL_INDEX_COUNT		( configTLSF_FL_INDEX_MAX - heapFL_INDEX_SHIFT + 2U )
+
+#if( configTLSF_SL_INDEX_COUNT_LOG2 > 5 )
+	#error configTLSF_SL_INDEX_COUNT_LOG2 must not be greater than 5
+#endif
+
+#if( heapFL_INDEX_COUNT > 32 )
+	#error configTLSF_FL_INDEX_MAX is too large
+#endif
+
+/* Block sizes must not get too small. */
+#define heapMINIMUM_BLOCK_SIZE	( ( size_t ) ( ( sizeof( BlockLink_t ) + ( ( size_t ) portBYTE_ALIGNMENT_MASK ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) ) )
+
+/* The largest block size that can be placed in a list. */
+#define heapMAXIMUM_BLOCK_SIZE	( ( ( size_t ) 2 << configTLSF_FL_INDEX_MAX ) - ( size_t ) 1 )
+
+/* Assumes 8bit bytes! */
+#define heapBITS_PER_BYTE		( ( size_t ) 8 )
+
+/* Allocate the memory for the heap. */
+#if( configAPPLICATION_ALLOCATED_HEAP == 1 )
+	/* The application writer has already defined the array used for the RTOS
+	heap - probably so it can be placed in a special segment or address. */
+	extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+	static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif /* configAPPLICATION_ALLOCATED_HEAP */
+
+/* The header placed at the start of every block.  pxPrevPhysBlock and
+xBlockSize are always valid, so the blocks either side of a block being freed
+can be found without searching.  The two free list links are only used while
+the block is free, so they overlay the memory returned to the application. */
+typedef struct A_BLOCK_LINK
+{
+	struct A_BLOCK_LINK *pxPrevPhysBlock;	/*<< The block immediately below this one in memory, or NULL for the first block. */
+	size_t xBlockSize;						/*<< The size of the block, including this header. */
+	struct A_BLOCK_LINK *pxNextFreeBlock;	/*<< The next block in the same free list. */
+	struct A_BLOCK_LINK *pxPrevFreeBlock;	/*<< The previous block in the same free list. */
+} BlockLink_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Calculate the list indexes for a block of xBlockSize bytes.
+ */
+static void prvMappingInsert( size_t xBlockSize, UBaseType_t *puxFL, UBaseType_t *puxSL );
+
+/*
+ * Find a free block of at least xWantedSize bytes, remove it from its list and
+ * return it, or return NULL if there is no such block.
+ */
+static BlockLink_t *prvTakeSuitableBlock( size_t xWantedSize );
+
+/*
+ * Add a free block to, or remove a free block from, the list that matches its
+ * size.
+ */
+static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert );
+static void prvRemoveBlockFromFreeList( BlockLink_t *pxBlockToRemove );
+
+/*
+ * Called automatically to setup the required heap structures the first time
+ * pvPortMalloc() is called.
+ */
+static void prvHeapInit( void );
+
+/*-----------------------------------------------------------*/
+
+/* The size of the part of the header that remains in use while the block is
+allocated must by correctly byte aligned. */
+static const size_t xHeapStructSize	= ( ( sizeof( BlockLink_t ) - ( 2 * sizeof( BlockLink_t * ) ) ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* The free lists, and the bitmaps that show which of them are not empty. */
+static BlockLink_t *pxFreeLists[ heapFL_INDEX_COUNT ][ heapSL_INDEX_COUNT ];
+static uint32_t ulFLBitmap = 0U;
+static uint32_t ulSLBitmap[ heapFL_INDEX_COUNT ];
+
+/* Marks the end of the heap.  It looks like an allocated block so it is never
+combined with the last real block. */
+static BlockLink_t *pxEnd = NULL;
+
+/* Keeps track of the number of free bytes remaining, but says nothing about
+fragmentation. */
+static size_t xFreeBytesRemaining = 0U;
+static size_t xMinimumEverFreeBytesRemaining = 0U;
+
+/* Gets set to the top bit of an size_t type.  When this bit in the xBlockSize
+member of an BlockLink_t structure is set then the block belongs to the
+application.  When the bit is free the block is still part of the free heap
+space. */
+static size_t xBlockAllocatedBit = 0;
+
+/*-----------------------------------------------------------*/
+
+/* Return the position of the most significant set bit in ulValue, which must
+not be zero.  This is a binary search that always takes five steps, as
+Cortex-M0 has no count leading zeros instruction. */
+static UBaseType_t prvMostSignificantBit( uint32_t ulValue )
+{
+UBaseType_t uxBit = 0;
+UBaseType_t uxShift;
+
+	for( uxShift = 16U; uxShift != 0U; uxShift >>= 1 )
+	{
+		if( ( ulValue >> uxShift ) != 0UL )
+		{
+			ulValue >>= uxShift;
+			uxBit += uxShift;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	return uxBit;
+}
+/*-----------------------------------------------------------*/
+
+/* Return the position of the least significant set bit in ulValue, which must
+not be zero. */
+static UBaseType_t prvLeastSignificantBit( uint32_t ulValue )
+{
+	return prvMostSignificantBit( ulValue & ( ~ulValue + 1UL ) );
+}
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+BlockLink_t *pxBlock, *pxNewBlockLink, *pxNextBlock;
+void *pvReturn = NULL;
+
+	vTaskSuspendAll();
+	{
+		/* If this is the first call to malloc then the heap will require
+		initialisation to setup the free lists. */
+		if( pxEnd == NULL )
+		{
+			prvHeapInit();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* Check the requested block size is not so large that the top bit is
+		set.  The top bit of the block size member of the BlockLink_t structure
+		is used to determine who owns the block - the application or the
+		kernel, so it must be free. */
+		if( ( xWantedSize & xBlockAllocatedBit ) == 0 )
+		{
+			/* The wanted size is increased so it can contain the part of the
+			BlockLink_t structure that stays in use while the block is
+			allocated. */
+			if( xWantedSize > 0 )
+			{
+				xWantedSize += xHeapStructSize;
+
+				/* Ensure that blocks are always aligned to the required number
+				of bytes. */
+				if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+				{
+					/* Byte alignment required. */
+					xWantedSize += ( portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK ) );
+					configASSERT( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) == 0 );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* The block must be able to hold the free list links once it
+				is freed again. */
+				if( xWantedSize < heapMINIMUM_BLOCK_SIZE )
+				{
+					xWantedSize = heapMINIMUM_BLOCK_SIZE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
+			{
+				pxBlock = prvTakeSuitableBlock( xWantedSize );
+
+				if( pxBlock != NULL )
+				{
+					/* Return the memory space pointed to - jumping over the
+					part of the BlockLink_t structure that stays in use. */
+					pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+
+					/* If the block is larger than required it can be split into
+					two. */
+					if( ( pxBlock->xBlockSize - xWantedSize ) >= heapMINIMUM_BLOCK_SIZE )
+					{
+						/* This block is to be split into two.  Create a new
+						block following the number of bytes requested. The void
+						cast is used to prevent byte alignment warnings from the
+						compiler. */
+						pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+						configASSERT( ( ( ( size_t ) pxNewBlockLink ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+						/* Calculate the sizes of two blocks split from the
+						single block, and link the new block between this block
+						and the one that follows it in memory. */
+						pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+						pxNewBlockLink->pxPrevPhysBlock = pxBlock;
+						pxBlock->xBlockSize = xWantedSize;
+
+						pxNextBlock = ( void * ) ( ( ( uint8_t * ) pxNewBlockLink ) + pxNewBlockLink->xBlockSize );
+						pxNextBlock->pxPrevPhysBlock = pxNewBlockLink;
+
+						/* Insert the new block into the free lists. */
+						prvInsertBlockIntoFreeList( pxNewBlockLink );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+					if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+					{
+						xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					/* The block is being returned - it is allocated and owned
+					by the application. */
+					pxBlock->xBlockSize |= xBlockAllocatedBit;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		traceMALLOC( pvReturn, xWantedSize );
+	}
+	( void ) xTaskResumeAll();
+
+	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+	{
+		if( pvReturn == NULL )
+		{
+			extern void vApplicationMallocFailedHook( void );
+			vApplicationMallocFailedHook();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
+	configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+uint8_t *puc = ( uint8_t * ) pv;
+BlockLink_t *pxLink, *pxNeighbour;
+
+	if( pv != NULL )
+	{
+		/* The memory being freed will have the in use part of a BlockLink_t
+		structure immediately before it. */
+		puc -= xHeapStructSize;
+
+		/* This casting is to keep the compiler from issuing warnings. */
+		pxLink = ( void * ) puc;
+
+		/* Check the block is actually allocated. */
+		configASSERT( ( pxLink->xBlockSize & xBlockAllocatedBit ) != 0 );
+
+		if( ( pxLink->xBlockSize & xBlockAllocatedBit ) != 0 )
+		{
+			vTaskSuspendAll();
+			{
+				/* The block is being returned to the heap - it is no longer
+				allocated. */
+				pxLink->xBlockSize &= ~xBlockAllocatedBit;
+				xFreeBytesRemaining += pxLink->xBlockSize;
+				traceFREE( pv, pxLink->xBlockSize );
+
+				/* Combine the block with the one below it in memory if that
+				one is free. */
+				pxNeighbour = pxLink->pxPrevPhysBlock;
+				if( ( pxNeighbour != NULL ) && ( ( pxNeighbour->xBlockSize & xBlockAllocatedBit ) == 0 ) )
+				{
+					prvRemoveBlockFromFreeList( pxNeighbour );
+					pxNeighbour->xBlockSize += pxLink->xBlockSize;
+					pxLink = pxNeighbour;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Combine the block with the one above it in memory if that
+				one is free.  pxEnd is marked as allocated so is never
+				combined. */
+				pxNeighbour = ( void * ) ( ( ( uint8_t * ) pxLink ) + pxLink->xBlockSize );
+				if( ( pxNeighbour->xBlockSize & xBlockAllocatedBit ) == 0 )
+				{
+					prvRemoveBlockFromFreeList( pxNeighbour );
+					pxLink->xBlockSize += pxNeighbour->xBlockSize;
+					pxNeighbour = ( void * ) ( ( ( uint8_t * ) pxLink ) + pxLink->xBlockSize );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				pxNeighbour->pxPrevPhysBlock = pxLink;
+
+				/* Add this block to the free lists. */
+				prvInsertBlockIntoFreeList( pxLink );
+			}
+			( void ) xTaskResumeAll();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+	return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+	return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetLargestFreeBlockSize( void )
+{
+UBaseType_t uxFL, uxSL;
+size_t xLargest = 0;
+
+	vTaskSuspendAll();
+	{
+		/* pvPortMalloc() takes any block from a higher list than the one a
+		request falls in, but only the head of that list.  So the largest
+		request that succeeds is the size of the block at the head of the
+		highest list that is not empty, although a block further down that
+		list may be larger. */
+		if( ulFLBitmap != 0UL )
+		{
+			uxFL = prvMostSignificantBit( ulFLBitmap );
+			uxSL = prvMostSignificantBit( ulSLBitmap[ uxFL ] );
+			xLargest = pxFreeLists[ uxFL ][ uxSL ]->xBlockSize;
+
+			/* Report the size the application could actually obtain. */
+			xLargest -= xHeapStructSize;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	return xLargest;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+	/* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+static void prvMappingInsert( size_t xBlockSize, UBaseType_t *puxFL, UBaseType_t *puxSL )
+{
+UBaseType_t uxBit;
+
+	if( xBlockSize < heapSMALL_BLOCK_SIZE )
+	{
+		/* Small blocks are spread linearly over the first list. */
+		*puxFL = 0;
+		*puxSL = ( UBaseType_t ) ( xBlockSize / ( heapSMALL_BLOCK_SIZE / heapSL_INDEX_COUNT ) );
+	}
+	else
+	{
+		uxBit = prvMostSignificantBit( ( uint32_t ) xBlockSize );
+		*puxFL = uxBit - ( heapFL_INDEX_SHIFT - 1U );
+		*puxSL = ( UBaseType_t ) ( ( xBlockSize >> ( uxBit - configTLSF_SL_INDEX_COUNT_LOG2 ) ) ^ heapSL_INDEX_COUNT );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BlockLink_t *prvTakeSuitableBlock( size_t xWantedSize )
+{
+BlockLink_t *pxBlock = NULL;
+UBaseType_t uxFL, uxSL;
+uint32_t ulMap;
+size_t xRoundedSize = xWantedSize;
+
+	/* Round the size up to the start of the next list so that every block in
+	the list found is big enough. */
+	if( xWantedSize >= heapSMALL_BLOCK_SIZE )
+	{
+		xRoundedSize += ( ( size_t ) 1 << ( prvMostSignificantBit( ( uint32_t ) xWantedSize ) - configTLSF_SL_INDEX_COUNT_LOG2 ) ) - ( size_t ) 1;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( xRoundedSize <= heapMAXIMUM_BLOCK_SIZE )
+	{
+		prvMappingInsert( xRoundedSize, &uxFL, &uxSL );
+
+		/* First look for a list at the same first level that holds blocks at
+		least as large, then for any list at a higher first level. */
+		ulMap = ulSLBitmap[ uxFL ] & ( ~0UL << uxSL );
+
+		if( ulMap == 0UL )
+		{
+			ulMap = ulFLBitmap & ( ~0UL << ( uxFL + 1U ) );
+
+			if( ulMap != 0UL )
+			{
+				uxFL = prvLeastSignificantBit( ulMap );
+				ulMap = ulSLBitmap[ uxFL ];
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( ulMap != 0UL )
+		{
+			uxSL = prvLeastSignificantBit( ulMap );
+			pxBlock = pxFreeLists[ uxFL ][ uxSL ];
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	/* No list above the one the request falls in has a block, but the block
+	at the head of that list may still be big enough.  Only the head is
+	checked, so the time taken stays bounded.  This is what lets the largest
+	free block be allocated, see xPortGetLargestFreeBlockSize(). */
+	if( ( pxBlock == NULL ) && ( xWantedSize <= heapMAXIMUM_BLOCK_SIZE ) )
+	{
+		prvMappingInsert( xWantedSize, &uxFL, &uxSL );
+
+		if( ( pxFreeLists[ uxFL ][ uxSL ] != NULL ) && ( pxFreeLists[ uxFL ][ uxSL ]->xBlockSize >= xWantedSize ) )
+		{
+			pxBlock = pxFreeLists[ uxFL ][ uxSL ];
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( pxBlock != NULL )
+	{
+		prvRemoveBlockFromFreeList( pxBlock );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert )
+{
+UBaseType_t uxFL, uxSL;
+BlockLink_t *pxHead;
+
+	prvMappingInsert( pxBlockToInsert->xBlockSize, &uxFL, &uxSL );
+
+	/* Blocks are added to the head of their list. */
+	pxHead = pxFreeLists[ uxFL ][ uxSL ];
+	pxBlockToInsert->pxNextFreeBlock = pxHead;
+	pxBlockToInsert->pxPrevFreeBlock = NULL;
+
+	if( pxHead != NULL )
+	{
+		pxHead->pxPrevFreeBlock = pxBlockToInsert;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxFreeLists[ uxFL ][ uxSL ] = pxBlockToInsert;
+	ulFLBitmap |= 1UL << uxFL;
+	ulSLBitmap[ uxFL ] |= 1UL << uxSL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveBlockFromFreeList( BlockLink_t *pxBlockToRemove )
+{
+UBaseType_t uxFL, uxSL;
+BlockLink_t *pxNext = pxBlockToRemove->pxNextFreeBlock;
+BlockLink_t *pxPrev = pxBlockToRemove->pxPrevFreeBlock;
+
+	if( pxNext != NULL )
+	{
+		pxNext->pxPrevFreeBlock = pxPrev;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( pxPrev != NULL )
+	{
+		pxPrev->pxNextFreeBlock = pxNext;
+	}
+	else
+	{
+		/* The block was at the head of its list. */
+		prvMappingInsert( pxBlockToRemove->xBlockSize, &uxFL, &uxSL );
+		pxFreeLists[ uxFL ][ uxSL ] = pxNext;
+
+		/* Clear the bitmaps if the list is now empty. */
+		if( pxNext == NULL )
+		{
+			ulSLBitmap[ uxFL ] &= ~( 1UL << uxSL );
+
+			if( ulSLBitmap[ uxFL ] == 0UL )
+			{
+				ulFLBitmap &= ~( 1UL << uxFL );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void )
+{
+BlockLink_t *pxFirstFreeBlock;
+uint8_t *pucAlignedHeap;
+size_t uxAddress;
+size_t xTotalHeapSize = configTOTAL_HEAP_SIZE;
+
+	/* Ensure the heap starts on a correctly aligned boundary. */
+	uxAddress = ( size_t ) ucHeap;
+
+	if( ( uxAddress & portBYTE_ALIGNMENT_MASK ) != 0 )
+	{
+		uxAddress += ( portBYTE_ALIGNMENT - 1 );
+		uxAddress &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+		xTotalHeapSize -= uxAddress - ( size_t ) ucHeap;
+	}
+
+	pucAlignedHeap = ( uint8_t * ) uxAddress;
+
+	/* pxEnd is used to mark the end of the heap space.  It is marked as
+	allocated so the last real block is never combined with it. */
+	uxAddress = ( ( size_t ) pucAlignedHeap ) + xTotalHeapSize;
+	uxAddress -= xHeapStructSize;
+	uxAddress &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+	/* A heap larger than the lists can hold is truncated. */
+	configASSERT( ( uxAddress - ( size_t ) pucAlignedHeap ) <= heapMAXIMUM_BLOCK_SIZE );
+	if( ( uxAddress - ( size_t ) pucAlignedHeap ) > heapMAXIMUM_BLOCK_SIZE )
+	{
+		uxAddress = ( ( size_t ) pucAlignedHeap ) + ( heapMAXIMUM_BLOCK_SIZE & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	/* Work out the position of the top bit in a size_t variable. */
+	xBlockAllocatedBit = ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 );
+
+	/* To start with there is a single free block that is sized to take up the
+	entire heap space, minus the space taken by pxEnd. */
+	pxFirstFreeBlock = ( void * ) pucAlignedHeap;
+	pxFirstFreeBlock->xBlockSize = uxAddress - ( size_t ) pxFirstFreeBlock;
+	pxFirstFreeBlock->pxPrevPhysBlock = NULL;
+
+	pxEnd = ( void * ) uxAddress;
+	pxEnd->xBlockSize = xBlockAllocatedBit;
+	pxEnd->pxPrevPhysBlock = pxFirstFreeBlock;
+
+	prvInsertBlockIntoFreeList( pxFirstFreeBlock );
+
+	/* Only one block exists - and it covers the entire usable heap space. */
+	xMinimumEverFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
+	xFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
+}
+/*-----------------------------------------------------------*/
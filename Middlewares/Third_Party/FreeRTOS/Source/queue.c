@@ -51,6 +51,7 @@ correct privileged Vs unprivileged linkage and placement. */
 /* Constants used with the cRxLock and cTxLock structure members. */
 #define queueUNLOCKED					( ( int8_t ) -1 )
 #define queueLOCKED_UNMODIFIED			( ( int8_t ) 0 )
+#define queueMAX_LOCK_COUNT				( ( int8_t ) 127 )
 
 /* When the Queue_t structure is used to represent a base queue its pcHead and
 pcTail members are used as pointers into the queue storage area.  When the
@@ -128,6 +129,11 @@ typedef struct QueueDefinition 		/* The old naming convention is used to prevent
 		uint8_t ucQueueType;
 	#endif
 
+	#if ( configUSE_QUEUE_EVENT_BITS == 1 )
+		EventGroupHandle_t xEventGroup;	/*< The event group to set bits in when data is posted to the queue, or NULL.  See xQueueAddToEventGroup(). */
+		EventBits_t uxEventBits;		/*< The bits to set in xEventGroup. */
+	#endif
+
 } xQUEUE;
 
 /* The old xQUEUE name is maintained above then typedefed to the new Queue_t
@@ -198,6 +204,36 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue, const void *pvIte
  */
 static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer ) PRIVILEGED_FUNCTION;
 
+/*
+ * Copies uxCount items to the back of a queue, and updates the number of items
+ * in the queue.
+ */
+static void prvCopyMultipleToQueue( Queue_t * const pxQueue, const int8_t *pcItems, const UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Copies uxCount items out of a queue.  The caller updates the number of items
+ * in the queue.
+ */
+static void prvCopyMultipleFromQueue( Queue_t * const pxQueue, int8_t * const pcBuffer, const UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes up to uxCount tasks from an event list of a queue that is not locked.
+ *
+ * @return pdTRUE if a task that has a priority higher than the calling task
+ * was unblocked, otherwise pdFALSE.
+ */
+static BaseType_t prvUnblockTasks( List_t * const pxEventList, UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblocks up to uxCount tasks waiting to receive from a queue that is not
+ * locked after uxCount items were sent to it, or notifies the queue set the
+ * queue is a member of.
+ *
+ * @return pdTRUE if a task that has a priority higher than the calling task
+ * was unblocked, otherwise pdFALSE.
+ */
+static BaseType_t prvUnblockReceivingTasks( Queue_t * const pxQueue, const UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+
 #if ( configUSE_QUEUE_SETS == 1 )
 	/*
 	 * Checks to see if a queue is a member of a queue set, and if so, notifies
@@ -206,6 +242,17 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer
 	static BaseType_t prvNotifyQueueSetContainer( const Queue_t * const pxQueue, const BaseType_t xCopyPosition ) PRIVILEGED_FUNCTION;
 #endif
 
+#if ( configUSE_QUEUE_EVENT_BITS == 1 )
+	/*
+	 * Checks to see if a queue was added to an event group, and if so, sets the
+	 * queue's bits in the event group.  Called after data has been posted to
+	 * the queue, once the critical section or interrupt mask used to post it
+	 * has been released - event groups are not accessed from critical sections.
+	 */
+	static void prvSetQueueEventBits( const Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
+	static void prvSetQueueEventBitsFromISR( const Queue_t * const pxQueue, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Called after a Queue_t structure has been allocated either statically or
  * dynamically to fill in the structure's members.
@@ -464,6 +511,13 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 	}
 	#endif /* configUSE_QUEUE_SETS */
 
+	#if( configUSE_QUEUE_EVENT_BITS == 1 )
+	{
+		pxNewQueue->xEventGroup = NULL;
+		pxNewQueue->uxEventBits = 0;
+	}
+	#endif /* configUSE_QUEUE_EVENT_BITS */
+
 	traceQUEUE_CREATE( pxNewQueue );
 }
 /*-----------------------------------------------------------*/
@@ -872,6 +926,13 @@ Queue_t * const pxQueue = xQueue;
 				#endif /* configUSE_QUEUE_SETS */
 
 				taskEXIT_CRITICAL();
+
+				#if ( configUSE_QUEUE_EVENT_BITS == 1 )
+				{
+					prvSetQueueEventBits( pxQueue );
+				}
+				#endif /* configUSE_QUEUE_EVENT_BITS */
+
 				return pdPASS;
 			}
 			else
@@ -1101,10 +1162,296 @@ Queue_t * const pxQueue = xQueue;
 	}
 	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
 
+	#if ( configUSE_QUEUE_EVENT_BITS == 1 )
+	{
+		if( xReturn == pdPASS )
+		{
+			prvSetQueueEventBitsFromISR( pxQueue, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configUSE_QUEUE_EVENT_BITS */
+
 	return xReturn;
 }
 /*-----------------------------------------------------------*/
 
+BaseType_t xQueueSendMultiple( QueueHandle_t xQueue, const void * const pvItemsToQueue, const UBaseType_t uxItemCount, TickType_t xTicksToWait )
+{
+BaseType_t xEntryTimeSet = pdFALSE;
+TimeOut_t xTimeOut;
+UBaseType_t uxSent = ( UBaseType_t ) 0, uxCount;
+Queue_t * const pxQueue = xQueue;
+
+	configASSERT( pxQueue );
+	configASSERT( pvItemsToQueue );
+	configASSERT( uxItemCount > ( UBaseType_t ) 0 );
+
+	/* Semaphores and mutexes do not hold items, so cannot be used. */
+	configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0 );
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	/*lint -save -e904 This function relaxes the coding standard somewhat to
+	allow return statements within the function itself.  This is done in the
+	interest of execution time efficiency. */
+	for( ;; )
+	{
+		taskENTER_CRITICAL();
+		{
+			/* Send as many of the remaining items as there is room for, and
+			unblock the tasks waiting for them, all within the one critical
+			section. */
+			uxCount = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+			if( uxCount > ( uxItemCount - uxSent ) )
+			{
+				uxCount = uxItemCount - uxSent;
+			}
+
+			if( uxCount > ( UBaseType_t ) 0 )
+			{
+				traceQUEUE_SEND( pxQueue );
+
+				prvCopyMultipleToQueue( pxQueue, ( const int8_t * ) pvItemsToQueue + ( uxSent * pxQueue->uxItemSize ), uxCount ); /*lint !e9079 !e9016 Pointer arithmetic on char types ok, the items are copied as bytes. */
+				uxSent += uxCount;
+
+				if( prvUnblockReceivingTasks( pxQueue, uxCount ) != pdFALSE )
+				{
+					/* A task with a priority higher than our own was
+					unblocked so yield.  Yes it is ok to do this from within the
+					critical section - the kernel takes care of that. */
+					queueYIELD_IF_USING_PREEMPTION();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( uxSent == uxItemCount )
+			{
+				taskEXIT_CRITICAL();
+
+				#if ( configUSE_QUEUE_EVENT_BITS == 1 )
+				{
+					prvSetQueueEventBits( pxQueue );
+				}
+				#endif /* configUSE_QUEUE_EVENT_BITS */
+
+				return ( BaseType_t ) uxSent;
+			}
+			else if( xTicksToWait == ( TickType_t ) 0 )
+			{
+				/* The queue is full and no block time is specified (or the
+				block time has expired) so leave now. */
+				taskEXIT_CRITICAL();
+
+				#if ( configUSE_QUEUE_EVENT_BITS == 1 )
+				{
+					if( uxCount > ( UBaseType_t ) 0 )
+					{
+						prvSetQueueEventBits( pxQueue );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif /* configUSE_QUEUE_EVENT_BITS */
+
+				if( uxSent == ( UBaseType_t ) 0 )
+				{
+					traceQUEUE_SEND_FAILED( pxQueue );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				return ( BaseType_t ) uxSent;
+			}
+			else if( xEntryTimeSet == pdFALSE )
+			{
+				/* The queue is full and a block time was specified so
+				configure the timeout structure. */
+				vTaskInternalSetTimeOutState( &xTimeOut );
+				xEntryTimeSet = pdTRUE;
+			}
+			else
+			{
+				/* Entry time was already set. */
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		#if ( configUSE_QUEUE_EVENT_BITS == 1 )
+		{
+			/* The items sent so far must be signalled before blocking, as the
+			task that reads them might be the one that will make space. */
+			if( uxCount > ( UBaseType_t ) 0 )
+			{
+				prvSetQueueEventBits( pxQueue );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_QUEUE_EVENT_BITS */
+
+		/* Interrupts and other tasks can send to and receive from the queue
+		now the critical section has been exited. */
+
+		vTaskSuspendAll();
+		prvLockQueue( pxQueue );
+
+		/* Update the timeout state to see if it has expired yet. */
+		if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+		{
+			if( prvIsQueueFull( pxQueue ) != pdFALSE )
+			{
+				traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+				vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+
+				/* See the comments in xQueueGenericSend(). */
+				prvUnlockQueue( pxQueue );
+
+				if( xTaskResumeAll() == pdFALSE )
+				{
+					portYIELD_WITHIN_API();
+				}
+			}
+			else
+			{
+				/* Try again. */
+				prvUnlockQueue( pxQueue );
+				( void ) xTaskResumeAll();
+			}
+		}
+		else
+		{
+			/* The timeout has expired. */
+			prvUnlockQueue( pxQueue );
+			( void ) xTaskResumeAll();
+
+			if( uxSent == ( UBaseType_t ) 0 )
+			{
+				traceQUEUE_SEND_FAILED( pxQueue );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			return ( BaseType_t ) uxSent;
+		}
+	} /*lint -restore */
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue, const void * const pvItemsToQueue, const UBaseType_t uxItemCount, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+UBaseType_t uxCount;
+UBaseType_t uxSavedInterruptStatus;
+Queue_t * const pxQueue = xQueue;
+
+	configASSERT( pxQueue );
+	configASSERT( pvItemsToQueue );
+	configASSERT( uxItemCount > ( UBaseType_t ) 0 );
+	configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0 );
+
+	/* See the comments in xQueueGenericSendFromISR(). */
+	portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		const int8_t cTxLock = pxQueue->cTxLock;
+
+		uxCount = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+		if( uxCount > uxItemCount )
+		{
+			uxCount = uxItemCount;
+		}
+
+		/* If the queue is locked the lock count records the number of items
+		sent, and must not overflow. */
+		if( ( cTxLock != queueUNLOCKED ) && ( uxCount > ( UBaseType_t ) ( queueMAX_LOCK_COUNT - cTxLock ) ) )
+		{
+			uxCount = ( UBaseType_t ) ( queueMAX_LOCK_COUNT - cTxLock );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( uxCount > ( UBaseType_t ) 0 )
+		{
+			traceQUEUE_SEND_FROM_ISR( pxQueue );
+
+			prvCopyMultipleToQueue( pxQueue, ( const int8_t * ) pvItemsToQueue, uxCount ); /*lint !e9079 The items are copied as bytes. */
+
+			/* The event list is not altered if the queue is locked.  This will
+			be done when the queue is unlocked later. */
+			if( cTxLock == queueUNLOCKED )
+			{
+				if( prvUnblockReceivingTasks( pxQueue, uxCount ) != pdFALSE )
+				{
+					if( pxHigherPriorityTaskWoken != NULL )
+					{
+						*pxHigherPriorityTaskWoken = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				/* Increase the lock count so the task that unlocks the queue
+				knows how many items were posted while it was locked. */
+				pxQueue->cTxLock = ( int8_t ) ( cTxLock + ( int8_t ) uxCount );
+			}
+		}
+		else
+		{
+			traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+		}
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	#if ( configUSE_QUEUE_EVENT_BITS == 1 )
+	{
+		if( uxCount > ( UBaseType_t ) 0 )
+		{
+			prvSetQueueEventBitsFromISR( pxQueue, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configUSE_QUEUE_EVENT_BITS */
+
+	return ( BaseType_t ) uxCount;
+}
+/*-----------------------------------------------------------*/
+
 BaseType_t xQueueGiveFromISR( QueueHandle_t xQueue, BaseType_t * const pxHigherPriorityTaskWoken )
 {
 BaseType_t xReturn;
@@ -1266,6 +1613,19 @@ Queue_t * const pxQueue = xQueue;
 	}
 	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
 
+	#if ( configUSE_QUEUE_EVENT_BITS == 1 )
+	{
+		if( xReturn == pdPASS )
+		{
+			prvSetQueueEventBitsFromISR( pxQueue, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configUSE_QUEUE_EVENT_BITS */
+
 	return xReturn;
 }
 /*-----------------------------------------------------------*/
@@ -1869,23 +2229,241 @@ Queue_t * const pxQueue = xQueue;
 }
 /*-----------------------------------------------------------*/
 
-BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue,  void * const pvBuffer )
+BaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue, void * const pvBuffer, const UBaseType_t uxMaxItems, TickType_t xTicksToWait )
 {
-BaseType_t xReturn;
-UBaseType_t uxSavedInterruptStatus;
-int8_t *pcOriginalReadPosition;
+BaseType_t xEntryTimeSet = pdFALSE;
+TimeOut_t xTimeOut;
+UBaseType_t uxCount;
 Queue_t * const pxQueue = xQueue;
 
 	configASSERT( pxQueue );
-	configASSERT( !( ( pvBuffer == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
-	configASSERT( pxQueue->uxItemSize != 0 ); /* Can't peek a semaphore. */
+	configASSERT( pvBuffer );
+	configASSERT( uxMaxItems > ( UBaseType_t ) 0 );
 
-	/* RTOS ports that support interrupt nesting have the concept of a maximum
-	system call (or maximum API call) interrupt priority.  Interrupts that are
-	above the maximum system call priority are kept permanently enabled, even
-	when the RTOS kernel is in a critical section, but cannot make any calls to
-	FreeRTOS API functions.  If configASSERT() is defined in FreeRTOSConfig.h
-	then portASSERT_IF_INTERRUPT_PRIORITY_INVALID() will result in an assertion
+	/* Semaphores and mutexes do not hold items, so cannot be used. */
+	configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0 );
+
+	/* Cannot block if the scheduler is suspended. */
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	/*lint -save -e904  This function relaxes the coding standard somewhat to
+	allow return statements within the function itself.  This is done in the
+	interest of execution time efficiency. */
+	for( ;; )
+	{
+		taskENTER_CRITICAL();
+		{
+			uxCount = pxQueue->uxMessagesWaiting;
+
+			/* Is there data in the queue now?  To be running the calling task
+			must be the highest priority task wanting to access the queue. */
+			if( uxCount > ( UBaseType_t ) 0 )
+			{
+				/* Remove as many items as are available, up to uxMaxItems,
+				then unblock the tasks waiting for the space. */
+				if( uxCount > uxMaxItems )
+				{
+					uxCount = uxMaxItems;
+				}
+
+				prvCopyMultipleFromQueue( pxQueue, ( int8_t * ) pvBuffer, uxCount ); /*lint !e9079 The items are copied as bytes. */
+				traceQUEUE_RECEIVE( pxQueue );
+				pxQueue->uxMessagesWaiting -= uxCount;
+
+				if( prvUnblockTasks( &( pxQueue->xTasksWaitingToSend ), uxCount ) != pdFALSE )
+				{
+					queueYIELD_IF_USING_PREEMPTION();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				taskEXIT_CRITICAL();
+				return ( BaseType_t ) uxCount;
+			}
+			else
+			{
+				if( xTicksToWait == ( TickType_t ) 0 )
+				{
+					/* The queue was empty and no block time is specified (or
+					the block time has expired) so leave now. */
+					taskEXIT_CRITICAL();
+					traceQUEUE_RECEIVE_FAILED( pxQueue );
+					return 0;
+				}
+				else if( xEntryTimeSet == pdFALSE )
+				{
+					/* The queue was empty and a block time was specified so
+					configure the timeout structure. */
+					vTaskInternalSetTimeOutState( &xTimeOut );
+					xEntryTimeSet = pdTRUE;
+				}
+				else
+				{
+					/* Entry time was already set. */
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		/* Interrupts and other tasks can send to and receive from the queue
+		now the critical section has been exited. */
+
+		vTaskSuspendAll();
+		prvLockQueue( pxQueue );
+
+		/* Update the timeout state to see if it has expired yet. */
+		if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+		{
+			/* The timeout has not expired.  If the queue is still empty place
+			the task on the list of tasks waiting to receive from the queue. */
+			if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+			{
+				traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+				vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+				prvUnlockQueue( pxQueue );
+				if( xTaskResumeAll() == pdFALSE )
+				{
+					portYIELD_WITHIN_API();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				/* The queue contains data again.  Loop back to try and read the
+				data. */
+				prvUnlockQueue( pxQueue );
+				( void ) xTaskResumeAll();
+			}
+		}
+		else
+		{
+			/* Timed out.  If there is no data in the queue exit, otherwise loop
+			back and attempt to read the data. */
+			prvUnlockQueue( pxQueue );
+			( void ) xTaskResumeAll();
+
+			if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+			{
+				traceQUEUE_RECEIVE_FAILED( pxQueue );
+				return 0;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	} /*lint -restore */
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue, void * const pvBuffer, const UBaseType_t uxMaxItems, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+UBaseType_t uxCount;
+UBaseType_t uxSavedInterruptStatus;
+Queue_t * const pxQueue = xQueue;
+
+	configASSERT( pxQueue );
+	configASSERT( pvBuffer );
+	configASSERT( uxMaxItems > ( UBaseType_t ) 0 );
+	configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0 );
+
+	/* See the comments in xQueueGenericSendFromISR(). */
+	portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		const int8_t cRxLock = pxQueue->cRxLock;
+
+		uxCount = pxQueue->uxMessagesWaiting;
+		if( uxCount > uxMaxItems )
+		{
+			uxCount = uxMaxItems;
+		}
+
+		/* If the queue is locked the lock count records the number of items
+		received, and must not overflow. */
+		if( ( cRxLock != queueUNLOCKED ) && ( uxCount > ( UBaseType_t ) ( queueMAX_LOCK_COUNT - cRxLock ) ) )
+		{
+			uxCount = ( UBaseType_t ) ( queueMAX_LOCK_COUNT - cRxLock );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* Cannot block in an ISR, so check there is data available. */
+		if( uxCount > ( UBaseType_t ) 0 )
+		{
+			traceQUEUE_RECEIVE_FROM_ISR( pxQueue );
+
+			prvCopyMultipleFromQueue( pxQueue, ( int8_t * ) pvBuffer, uxCount ); /*lint !e9079 The items are copied as bytes. */
+			pxQueue->uxMessagesWaiting -= uxCount;
+
+			/* If the queue is locked the event list will not be modified.
+			Instead update the lock count so the task that unlocks the queue
+			will know that an ISR has removed data while the queue was
+			locked. */
+			if( cRxLock == queueUNLOCKED )
+			{
+				if( prvUnblockTasks( &( pxQueue->xTasksWaitingToSend ), uxCount ) != pdFALSE )
+				{
+					if( pxHigherPriorityTaskWoken != NULL )
+					{
+						*pxHigherPriorityTaskWoken = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				pxQueue->cRxLock = ( int8_t ) ( cRxLock + ( int8_t ) uxCount );
+			}
+		}
+		else
+		{
+			traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue );
+		}
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	return ( BaseType_t ) uxCount;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue,  void * const pvBuffer )
+{
+BaseType_t xReturn;
+UBaseType_t uxSavedInterruptStatus;
+int8_t *pcOriginalReadPosition;
+Queue_t * const pxQueue = xQueue;
+
+	configASSERT( pxQueue );
+	configASSERT( !( ( pvBuffer == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
+	configASSERT( pxQueue->uxItemSize != 0 ); /* Can't peek a semaphore. */
+
+	/* RTOS ports that support interrupt nesting have the concept of a maximum
+	system call (or maximum API call) interrupt priority.  Interrupts that are
+	above the maximum system call priority are kept permanently enabled, even
+	when the RTOS kernel is in a critical section, but cannot make any calls to
+	FreeRTOS API functions.  If configASSERT() is defined in FreeRTOSConfig.h
+	then portASSERT_IF_INTERRUPT_PRIORITY_INVALID() will result in an assertion
 	failure if a FreeRTOS API function is called from an interrupt that has been
 	assigned a priority above the configured maximum system call priority.
 	Only FreeRTOS functions that end in FromISR can be called from interrupts
@@ -2164,6 +2742,146 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer
 }
 /*-----------------------------------------------------------*/
 
+static void prvCopyMultipleToQueue( Queue_t * const pxQueue, const int8_t *pcItems, const UBaseType_t uxCount )
+{
+const size_t xBytes = ( size_t ) uxCount * ( size_t ) pxQueue->uxItemSize;
+size_t xFirstBytes;
+
+	/* This function is called from a critical section.  The items are added
+	to the back of the queue with at most two copies, the second one when the
+	space wraps around the end of the storage area. */
+	xFirstBytes = ( size_t ) ( pxQueue->u.xQueue.pcTail - pxQueue->pcWriteTo ); /*lint !e946 !e9033 Pointer subtraction of char types ok, both point into the storage area. */
+	if( xFirstBytes > xBytes )
+	{
+		xFirstBytes = xBytes;
+	}
+
+	( void ) memcpy( ( void * ) pxQueue->pcWriteTo, ( const void * ) pcItems, xFirstBytes ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports. */
+
+	if( xBytes > xFirstBytes )
+	{
+		( void ) memcpy( ( void * ) pxQueue->pcHead, ( const void * ) &( pcItems[ xFirstBytes ] ), xBytes - xFirstBytes ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports. */
+		pxQueue->pcWriteTo = pxQueue->pcHead + ( xBytes - xFirstBytes ); /*lint !e9016 Pointer arithmetic on char types ok. */
+	}
+	else
+	{
+		pxQueue->pcWriteTo += xFirstBytes; /*lint !e9016 Pointer arithmetic on char types ok. */
+		if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
+		{
+			pxQueue->pcWriteTo = pxQueue->pcHead;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	pxQueue->uxMessagesWaiting += uxCount;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCopyMultipleFromQueue( Queue_t * const pxQueue, int8_t * const pcBuffer, const UBaseType_t uxCount )
+{
+const size_t xBytes = ( size_t ) uxCount * ( size_t ) pxQueue->uxItemSize;
+size_t xFirstBytes;
+int8_t *pcReadFrom;
+
+	/* pcReadFrom points to the last item read, so the first item to read is
+	the one after it. */
+	pcReadFrom = pxQueue->u.xQueue.pcReadFrom + pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok. */
+	if( pcReadFrom >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
+	{
+		pcReadFrom = pxQueue->pcHead;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	xFirstBytes = ( size_t ) ( pxQueue->u.xQueue.pcTail - pcReadFrom ); /*lint !e946 !e9033 Pointer subtraction of char types ok, both point into the storage area. */
+	if( xFirstBytes > xBytes )
+	{
+		xFirstBytes = xBytes;
+	}
+
+	( void ) memcpy( ( void * ) pcBuffer, ( void * ) pcReadFrom, xFirstBytes ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports. */
+
+	if( xBytes > xFirstBytes )
+	{
+		( void ) memcpy( ( void * ) &( pcBuffer[ xFirstBytes ] ), ( void * ) pxQueue->pcHead, xBytes - xFirstBytes ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports. */
+		pcReadFrom = pxQueue->pcHead + ( xBytes - xFirstBytes ); /*lint !e9016 Pointer arithmetic on char types ok. */
+	}
+	else
+	{
+		pcReadFrom += xFirstBytes; /*lint !e9016 Pointer arithmetic on char types ok. */
+	}
+
+	pxQueue->u.xQueue.pcReadFrom = pcReadFrom - pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok. */
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvUnblockTasks( List_t * const pxEventList, UBaseType_t uxCount )
+{
+BaseType_t xReturn = pdFALSE;
+
+	/* Each item sent or received can satisfy one waiting task. */
+	while( ( uxCount > ( UBaseType_t ) 0 ) && ( listLIST_IS_EMPTY( pxEventList ) == pdFALSE ) )
+	{
+		if( xTaskRemoveFromEventList( pxEventList ) != pdFALSE )
+		{
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		uxCount--;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvUnblockReceivingTasks( Queue_t * const pxQueue, const UBaseType_t uxCount )
+{
+BaseType_t xReturn = pdFALSE;
+
+	#if ( configUSE_QUEUE_SETS == 1 )
+	{
+		if( pxQueue->pxQueueSetContainer != NULL )
+		{
+		UBaseType_t uxItem;
+
+			/* The queue set holds one event for each item in its member
+			queues, so it is notified once for each item sent. */
+			for( uxItem = ( UBaseType_t ) 0; uxItem < uxCount; uxItem++ )
+			{
+				if( prvNotifyQueueSetContainer( pxQueue, queueSEND_TO_BACK ) != pdFALSE )
+				{
+					xReturn = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		else
+		{
+			xReturn = prvUnblockTasks( &( pxQueue->xTasksWaitingToReceive ), uxCount );
+		}
+	}
+	#else /* configUSE_QUEUE_SETS */
+	{
+		xReturn = prvUnblockTasks( &( pxQueue->xTasksWaitingToReceive ), uxCount );
+	}
+	#endif /* configUSE_QUEUE_SETS */
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
 static void prvUnlockQueue( Queue_t * const pxQueue )
 {
 	/* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED. */
@@ -2873,6 +3591,123 @@ Queue_t * const pxQueue = xQueue;
 #endif /* configUSE_QUEUE_SETS */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_EVENT_BITS == 1 )
+
+	BaseType_t xQueueAddToEventGroup( QueueSetMemberHandle_t xQueueOrSemaphore, EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet )
+	{
+	BaseType_t xReturn;
+	UBaseType_t uxMessagesWaiting;
+	Queue_t * const pxQueueOrSemaphore = ( Queue_t * ) xQueueOrSemaphore;
+
+		configASSERT( pxQueueOrSemaphore );
+		configASSERT( xEventGroup );
+		configASSERT( uxBitsToSet != ( EventBits_t ) 0 );
+
+		taskENTER_CRITICAL();
+		{
+			if( pxQueueOrSemaphore->xEventGroup != NULL )
+			{
+				/* Cannot add a queue/semaphore to more than one event group. */
+				xReturn = pdFAIL;
+			}
+			else
+			{
+				pxQueueOrSemaphore->xEventGroup = xEventGroup;
+				pxQueueOrSemaphore->uxEventBits = uxBitsToSet;
+				xReturn = pdPASS;
+			}
+
+			uxMessagesWaiting = pxQueueOrSemaphore->uxMessagesWaiting;
+		}
+		taskEXIT_CRITICAL();
+
+		if( ( xReturn == pdPASS ) && ( uxMessagesWaiting != ( UBaseType_t ) 0 ) )
+		{
+			/* Unlike a queue set, the event group does not count the items
+			posted to the queue, so a queue that already holds data can be
+			added by setting its bits straight away. */
+			( void ) xEventGroupSetBits( xEventGroup, uxBitsToSet );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_QUEUE_EVENT_BITS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_EVENT_BITS == 1 )
+
+	BaseType_t xQueueRemoveFromEventGroup( QueueSetMemberHandle_t xQueueOrSemaphore, EventGroupHandle_t xEventGroup )
+	{
+	BaseType_t xReturn;
+	Queue_t * const pxQueueOrSemaphore = ( Queue_t * ) xQueueOrSemaphore;
+
+		configASSERT( pxQueueOrSemaphore );
+
+		taskENTER_CRITICAL();
+		{
+			if( pxQueueOrSemaphore->xEventGroup != xEventGroup )
+			{
+				/* The queue was not added to the event group. */
+				xReturn = pdFAIL;
+			}
+			else
+			{
+				pxQueueOrSemaphore->xEventGroup = NULL;
+				pxQueueOrSemaphore->uxEventBits = 0;
+				xReturn = pdPASS;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		return xReturn;
+	}
+
+#endif /* configUSE_QUEUE_EVENT_BITS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_EVENT_BITS == 1 )
+
+	static void prvSetQueueEventBits( const Queue_t * const pxQueue )
+	{
+	EventGroupHandle_t xEventGroup = pxQueue->xEventGroup;
+
+		if( xEventGroup != NULL )
+		{
+			( void ) xEventGroupSetBits( xEventGroup, pxQueue->uxEventBits );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_QUEUE_EVENT_BITS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_EVENT_BITS == 1 )
+
+	static void prvSetQueueEventBitsFromISR( const Queue_t * const pxQueue, BaseType_t * const pxHigherPriorityTaskWoken )
+	{
+	EventGroupHandle_t xEventGroup = pxQueue->xEventGroup;
+
+		if( xEventGroup != NULL )
+		{
+			( void ) xEventGroupSetBitsFromISR( xEventGroup, pxQueue->uxEventBits, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_QUEUE_EVENT_BITS */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_QUEUE_SETS == 1 )
 
 	static BaseType_t prvNotifyQueueSetContainer( const Queue_t * const pxQueue, const BaseType_t xCopyPosition )
@@ -212,6 +212,22 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 										  size_t xTriggerLevelBytes,
 										  uint8_t ucFlags ) PRIVILEGED_FUNCTION;
 
+/*
+ * Used by the zero copy API.  Return the number of bytes that can be written
+ * (or read) in place starting at xHead (or xTail) before the end of the
+ * buffer's storage area is reached, and set *ppvRegion to point to the first
+ * of those bytes.
+ */
+static size_t prvGetWriteRegion( StreamBuffer_t * const pxStreamBuffer, void **ppvRegion ) PRIVILEGED_FUNCTION;
+static size_t prvGetReadRegion( StreamBuffer_t * const pxStreamBuffer, void **ppvRegion ) PRIVILEGED_FUNCTION;
+
+/*
+ * Used by the zero copy API.  Move xHead (or xTail) forward over xCount bytes
+ * that were written (or read) in place.
+ */
+static void prvCommitBytes( StreamBuffer_t * const pxStreamBuffer, size_t xCount ) PRIVILEGED_FUNCTION;
+static void prvReleaseBytes( StreamBuffer_t * const pxStreamBuffer, size_t xCount ) PRIVILEGED_FUNCTION;
+
 /*-----------------------------------------------------------*/
 
 #if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
@@ -967,6 +983,261 @@ configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
 }
 /*-----------------------------------------------------------*/
 
+size_t xStreamBufferSendAcquire( StreamBufferHandle_t xStreamBuffer,
+								 void **ppvRegion,
+								 TickType_t xTicksToWait )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xSpace;
+TimeOut_t xTimeOut;
+
+	configASSERT( ppvRegion );
+	configASSERT( pxStreamBuffer );
+
+	/* A message buffer stores the length of each message in front of it, so
+	cannot be written in place. */
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+	/* Only the writer moves xHead, so if there is already space the region
+	can be returned without entering a critical section.  The critical section
+	is only needed to check for space and register as the waiting task
+	atomically, as in xStreamBufferSend(). */
+	xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+
+	if( ( xSpace == ( size_t ) 0 ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+	{
+		vTaskSetTimeOutState( &xTimeOut );
+
+		do
+		{
+			taskENTER_CRITICAL();
+			{
+				xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+
+				if( xSpace == ( size_t ) 0 )
+				{
+					/* Clear notification state as going to wait for space. */
+					( void ) xTaskNotifyStateClear( NULL );
+
+					/* Should only be one writer. */
+					configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
+					pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
+				}
+				else
+				{
+					taskEXIT_CRITICAL();
+					break;
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer );
+			( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+			pxStreamBuffer->xTaskWaitingToSend = NULL;
+
+		} while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return prvGetWriteRegion( pxStreamBuffer, ppvRegion );
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferSendAcquireFromISR( StreamBufferHandle_t xStreamBuffer,
+										void **ppvRegion )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+	configASSERT( ppvRegion );
+	configASSERT( pxStreamBuffer );
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+	return prvGetWriteRegion( pxStreamBuffer, ppvRegion );
+}
+/*-----------------------------------------------------------*/
+
+void vStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer,
+							  size_t xBytesWritten )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+	configASSERT( pxStreamBuffer );
+
+	if( xBytesWritten > ( size_t ) 0 )
+	{
+		prvCommitBytes( pxStreamBuffer, xBytesWritten );
+		traceSTREAM_BUFFER_SEND( xStreamBuffer, xBytesWritten );
+
+		/* Was a task waiting for the data? */
+		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+		{
+			sbSEND_COMPLETED( pxStreamBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vStreamBufferSendCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+									 size_t xBytesWritten,
+									 BaseType_t * const pxHigherPriorityTaskWoken )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+	configASSERT( pxStreamBuffer );
+
+	if( xBytesWritten > ( size_t ) 0 )
+	{
+		prvCommitBytes( pxStreamBuffer, xBytesWritten );
+
+		/* Was a task waiting for the data? */
+		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+		{
+			sbSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xBytesWritten );
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer,
+									void **ppvRegion,
+									TickType_t xTicksToWait )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xBytesAvailable;
+
+	configASSERT( ppvRegion );
+	configASSERT( pxStreamBuffer );
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+	/* Only the reader moves xTail, so if there is already data the region
+	can be returned without entering a critical section. */
+	xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+	if( ( xBytesAvailable == ( size_t ) 0 ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+	{
+		/* Checking if there is data and clearing the notification state must
+		be performed atomically. */
+		taskENTER_CRITICAL();
+		{
+			xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+			if( xBytesAvailable == ( size_t ) 0 )
+			{
+				/* Clear notification state as going to wait for data. */
+				( void ) xTaskNotifyStateClear( NULL );
+
+				/* Should only be one reader. */
+				configASSERT( pxStreamBuffer->xTaskWaitingToReceive == NULL );
+				pxStreamBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( xBytesAvailable == ( size_t ) 0 )
+		{
+			/* Wait for data to be available. */
+			traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer );
+			( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+			pxStreamBuffer->xTaskWaitingToReceive = NULL;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return prvGetReadRegion( pxStreamBuffer, ppvRegion );
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceiveAcquireFromISR( StreamBufferHandle_t xStreamBuffer,
+										   void **ppvRegion )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+	configASSERT( ppvRegion );
+	configASSERT( pxStreamBuffer );
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+	return prvGetReadRegion( pxStreamBuffer, ppvRegion );
+}
+/*-----------------------------------------------------------*/
+
+void vStreamBufferReceiveRelease( StreamBufferHandle_t xStreamBuffer,
+								  size_t xBytesRead )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+	configASSERT( pxStreamBuffer );
+
+	if( xBytesRead > ( size_t ) 0 )
+	{
+		prvReleaseBytes( pxStreamBuffer, xBytesRead );
+		traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xBytesRead );
+
+		/* Was a task waiting for space in the buffer? */
+		sbRECEIVE_COMPLETED( pxStreamBuffer );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vStreamBufferReceiveReleaseFromISR( StreamBufferHandle_t xStreamBuffer,
+										 size_t xBytesRead,
+										 BaseType_t * const pxHigherPriorityTaskWoken )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+	configASSERT( pxStreamBuffer );
+
+	if( xBytesRead > ( size_t ) 0 )
+	{
+		prvReleaseBytes( pxStreamBuffer, xBytesRead );
+
+		/* Was a task waiting for space in the buffer? */
+		sbRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xBytesRead );
+}
+/*-----------------------------------------------------------*/
+
 BaseType_t xStreamBufferIsEmpty( StreamBufferHandle_t xStreamBuffer )
 {
 const StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
@@ -1186,6 +1457,85 @@ size_t xCount, xFirstLength, xNextTail;
 }
 /*-----------------------------------------------------------*/
 
+static size_t prvGetWriteRegion( StreamBuffer_t * const pxStreamBuffer, void **ppvRegion )
+{
+size_t xHead, xCount;
+
+	/* The free space may wrap around the end of the buffer, in which case only
+	the part up to the end can be written in place. */
+	xHead = pxStreamBuffer->xHead;
+	xCount = configMIN( xStreamBufferSpacesAvailable( pxStreamBuffer ), pxStreamBuffer->xLength - xHead );
+	*ppvRegion = ( void * ) &( pxStreamBuffer->pucBuffer[ xHead ] );
+
+	return xCount;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvGetReadRegion( StreamBuffer_t * const pxStreamBuffer, void **ppvRegion )
+{
+size_t xTail, xCount;
+
+	/* As above, data that wraps around the end of the buffer is returned by
+	the next call once the first part has been released. */
+	xTail = pxStreamBuffer->xTail;
+	xCount = configMIN( prvBytesInBuffer( pxStreamBuffer ), pxStreamBuffer->xLength - xTail );
+	*ppvRegion = ( void * ) &( pxStreamBuffer->pucBuffer[ xTail ] );
+
+	return xCount;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCommitBytes( StreamBuffer_t * const pxStreamBuffer, size_t xCount )
+{
+size_t xNextHead;
+
+	/* Only bytes inside the region returned by the last acquire can have been
+	written. */
+	configASSERT( xCount <= xStreamBufferSpacesAvailable( pxStreamBuffer ) );
+	configASSERT( xCount <= ( pxStreamBuffer->xLength - pxStreamBuffer->xHead ) );
+
+	xNextHead = pxStreamBuffer->xHead + xCount;
+	if( xNextHead >= pxStreamBuffer->xLength )
+	{
+		xNextHead -= pxStreamBuffer->xLength;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	/* The data must be in the buffer before the reader can see the new head,
+	which is the only ordering the single writer/single reader scheme relies
+	on. */
+	portMEMORY_BARRIER();
+	pxStreamBuffer->xHead = xNextHead;
+}
+/*-----------------------------------------------------------*/
+
+static void prvReleaseBytes( StreamBuffer_t * const pxStreamBuffer, size_t xCount )
+{
+size_t xNextTail;
+
+	configASSERT( xCount <= prvBytesInBuffer( pxStreamBuffer ) );
+	configASSERT( xCount <= ( pxStreamBuffer->xLength - pxStreamBuffer->xTail ) );
+
+	xNextTail = pxStreamBuffer->xTail + xCount;
+	if( xNextTail >= pxStreamBuffer->xLength )
+	{
+		xNextTail -= pxStreamBuffer->xLength;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	/* The reader must be done with the data before the writer can reuse the
+	space. */
+	portMEMORY_BARRIER();
+	pxStreamBuffer->xTail = xNextTail;
+}
+/*-----------------------------------------------------------*/
+
 static size_t prvBytesInBuffer( const StreamBuffer_t * const pxStreamBuffer )
 {
 /* Returns the distance between xTail and xHead. */
@@ -69,6 +69,42 @@ defining trmTIMER_SERVICE_TASK_NAME in FreeRTOSConfig.h. */
 #define tmrSTATUS_IS_STATICALLY_ALLOCATED	( ( uint8_t ) 0x02 )
 #define tmrSTATUS_IS_AUTORELOAD				( ( uint8_t ) 0x04 )
 
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	/* When configUSE_TIMER_WHEEL is 1 active timers are held in a hierarchical
+	timer wheel rather than in two lists sorted by expiry time, so starting,
+	resetting and stopping a timer take constant time however many timers are
+	active.  Each level of the wheel holds the timers that expire within the
+	period of one slot of the level above it, in a slot selected by one digit
+	of their expiry time, and is cascaded into the levels below when the wheel
+	time reaches that slot.  The top level wraps with the tick count, so the
+	lists do not need to be switched when the tick count overflows. */
+	#define tmrWHEEL_SLOT_BITS		( ( UBaseType_t ) configTIMER_WHEEL_SLOT_BITS )
+	#define tmrWHEEL_SLOTS			( ( UBaseType_t ) 1U << tmrWHEEL_SLOT_BITS )
+	#define tmrWHEEL_SLOT_MASK		( tmrWHEEL_SLOTS - ( UBaseType_t ) 1U )
+	#define tmrWHEEL_TICK_BITS		( ( UBaseType_t ) ( sizeof( TickType_t ) * ( size_t ) 8 ) )
+	#define tmrWHEEL_LEVELS			( ( tmrWHEEL_TICK_BITS + tmrWHEEL_SLOT_BITS - ( UBaseType_t ) 1U ) / tmrWHEEL_SLOT_BITS )
+	#define tmrWHEEL_TOP_LEVEL		( tmrWHEEL_LEVELS - ( UBaseType_t ) 1U )
+
+	/* The digit of xTime that selects its slot in level uxLevel. */
+	#define tmrWHEEL_DIGIT( xTime, uxLevel ) ( ( UBaseType_t ) ( ( xTime ) >> ( ( uxLevel ) * tmrWHEEL_SLOT_BITS ) ) & tmrWHEEL_SLOT_MASK )
+
+	/* Expiry times are compared relative to the wheel time, which is never
+	after the current time. */
+	#define tmrEXPIRE_TIME_REACHED( xExpireTime, xTimeNow ) ( ( ( TickType_t ) ( ( xExpireTime ) - xTimerWheelTime ) <= ( TickType_t ) ( ( xTimeNow ) - xTimerWheelTime ) ) ? pdTRUE : pdFALSE )
+
+	/* The time is sampled and the wheel time updated once for each batch of
+	commands read from the timer queue, rather than once for each command. */
+	#define tmrCOMMAND_BATCH_SIZE	( ( UBaseType_t ) configTIMER_COMMAND_BATCH_SIZE )
+
+#else
+
+	#define tmrCOMMAND_BATCH_SIZE	( ( UBaseType_t ) 1U )
+
+	#define tmrEXPIRE_TIME_REACHED( xExpireTime, xTimeNow ) ( ( ( xExpireTime ) <= ( xTimeNow ) ) ? pdTRUE : pdFALSE )
+
+#endif /* configUSE_TIMER_WHEEL */
+
 /* The definition of the timers themselves. */
 typedef struct tmrTimerControl /* The old naming convention is used to prevent breaking kernel aware debuggers. */
 {
@@ -132,10 +168,22 @@ timer service task is allowed to access these lists.
 xActiveTimerList1 and xActiveTimerList2 could be at function scope but that
 breaks some kernel aware debuggers, and debuggers that reply on removing the
 static qualifier. */
-PRIVILEGED_DATA static List_t xActiveTimerList1 = { 0 };
-PRIVILEGED_DATA static List_t xActiveTimerList2 = { 0 };
-PRIVILEGED_DATA static List_t *pxCurrentTimerList = NULL;
-PRIVILEGED_DATA static List_t *pxOverflowTimerList = NULL;
+#if( configUSE_TIMER_WHEEL == 0 )
+	PRIVILEGED_DATA static List_t xActiveTimerList1 = { 0 };
+	PRIVILEGED_DATA static List_t xActiveTimerList2 = { 0 };
+	PRIVILEGED_DATA static List_t *pxCurrentTimerList = NULL;
+	PRIVILEGED_DATA static List_t *pxOverflowTimerList = NULL;
+#else
+	/* The timer wheel used in place of the active timer lists.  The slots of
+	each level are unsorted lists, and a bit is set in ulTimerWheelOccupied for
+	each slot that is not empty.  All the timers that expire up to and including
+	xTimerWheelTime have been processed.  Only the timer service task is allowed
+	to access the wheel. */
+	PRIVILEGED_DATA static List_t xTimerWheel[ tmrWHEEL_LEVELS ][ tmrWHEEL_SLOTS ];
+	PRIVILEGED_DATA static uint32_t ulTimerWheelOccupied[ tmrWHEEL_LEVELS ] = { 0 };
+	PRIVILEGED_DATA static TickType_t xTimerWheelTime = ( TickType_t ) 0U;
+	PRIVILEGED_DATA static UBaseType_t uxTimerWheelCount = ( UBaseType_t ) 0U;
+#endif /* configUSE_TIMER_WHEEL */
 
 /* A queue that is used to send commands to the timer service task. */
 PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
@@ -169,28 +217,70 @@ static void prvCheckForValidListAndQueue( void ) PRIVILEGED_FUNCTION;
 static portTASK_FUNCTION_PROTO( prvTimerTask, pvParameters ) PRIVILEGED_FUNCTION;
 
 /*
- * Called by the timer service task to interpret and process a command it
- * received on the timer queue.
+ * Called by the timer service task to read and process the commands waiting
+ * on the timer queue.
  */
 static void prvProcessReceivedCommands( void ) PRIVILEGED_FUNCTION;
 
 /*
- * Insert the timer into either xActiveTimerList1, or xActiveTimerList2,
- * depending on if the expire time causes a timer counter overflow.
+ * Interpret and process one command received on the timer queue.
  */
-static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer, const TickType_t xNextExpiryTime, const TickType_t xTimeNow, const TickType_t xCommandTime ) PRIVILEGED_FUNCTION;
+static void prvProcessReceivedCommand( const DaemonTaskMessage_t * const pxMessage, const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
 /*
- * An active timer has reached its expire time.  Reload the timer if it is an
- * auto reload timer, then call its callback.
+ * Insert the timer into either xActiveTimerList1, or xActiveTimerList2,
+ * depending on if the expire time causes a timer counter overflow, or into the
+ * timer wheel if configUSE_TIMER_WHEEL is 1.
  */
-static void prvProcessExpiredTimer( const TickType_t xNextExpireTime, const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer, const TickType_t xNextExpiryTime, const TickType_t xTimeNow, const TickType_t xCommandTime ) PRIVILEGED_FUNCTION;
 
-/*
- * The tick count has overflowed.  Switch the timer lists after ensuring the
- * current timer list does not still reference some timers.
- */
-static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+#if( configUSE_TIMER_WHEEL == 0 )
+
+	/*
+	 * An active timer has reached its expire time.  Reload the timer if it is
+	 * an auto reload timer, then call its callback.
+	 */
+	static void prvProcessExpiredTimer( const TickType_t xNextExpireTime, const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * The tick count has overflowed.  Switch the timer lists after ensuring the
+	 * current timer list does not still reference some timers.
+	 */
+	static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+
+#else
+
+	/*
+	 * Add a timer to the slot of the timer wheel that corresponds to its expiry
+	 * time, relative to the wheel time.
+	 */
+	static void prvWheelInsert( Timer_t * const pxTimer, const TickType_t xExpiryTime ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Remove a timer from the timer wheel, if it is in the wheel.
+	 */
+	static void prvWheelRemove( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Return the time at which the wheel next has to be processed, which is
+	 * either the expiry time of a timer or the time at which a slot has to be
+	 * cascaded.  The wheel must not be empty.
+	 */
+	static TickType_t prvWheelNextEvent( void ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Return the number of the lowest set bit of ulOccupied, which must not be
+	 * 0.
+	 */
+	static UBaseType_t prvWheelLowestSlot( uint32_t ulOccupied ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Move the wheel time forward to xTimeNow, cascading slots and processing
+	 * the timers that expire on the way in expiry time order.
+	 */
+	static void prvWheelAdvance( const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TIMER_WHEEL */
 
 /*
  * Obtain the current tick count, setting *pxTimerListsWereSwitched to pdTRUE
@@ -479,6 +569,8 @@ Timer_t *pxTimer = xTimer;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TIMER_WHEEL == 0 )
+
 static void prvProcessExpiredTimer( const TickType_t xNextExpireTime, const TickType_t xTimeNow )
 {
 BaseType_t xResult;
@@ -518,6 +610,8 @@ Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTi
 	/* Call the timer callback. */
 	pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
 }
+
+#endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
 static portTASK_FUNCTION( prvTimerTask, pvParameters )
@@ -572,10 +666,22 @@ BaseType_t xTimerListsWereSwitched;
 		if( xTimerListsWereSwitched == pdFALSE )
 		{
 			/* The tick count has not overflowed, has the timer expired? */
-			if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
+			if( ( xListWasEmpty == pdFALSE ) && ( tmrEXPIRE_TIME_REACHED( xNextExpireTime, xTimeNow ) != pdFALSE ) )
 			{
 				( void ) xTaskResumeAll();
-				prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
+
+				#if( configUSE_TIMER_WHEEL == 1 )
+				{
+					/* Process the timers that expire at xNextExpireTime, then
+					check for commands before processing later timers, as is
+					done with the active timer lists. */
+					prvWheelAdvance( xNextExpireTime );
+				}
+				#else
+				{
+					prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
+				}
+				#endif /* configUSE_TIMER_WHEEL */
 			}
 			else
 			{
@@ -585,12 +691,16 @@ BaseType_t xTimerListsWereSwitched;
 				received - whichever comes first.  The following line cannot
 				be reached unless xNextExpireTime > xTimeNow, except in the
 				case when the current timer list is empty. */
-				if( xListWasEmpty != pdFALSE )
+				#if( configUSE_TIMER_WHEEL == 0 )
 				{
-					/* The current timer list is empty - is the overflow list
-					also empty? */
-					xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
+					if( xListWasEmpty != pdFALSE )
+					{
+						/* The current timer list is empty - is the overflow
+						list also empty? */
+						xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
+					}
 				}
+				#endif /* configUSE_TIMER_WHEEL */
 
 				vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
 
@@ -627,16 +737,35 @@ TickType_t xNextExpireTime;
 	this task to unblock when the tick count overflows, at which point the
 	timer lists will be switched and the next expiry time can be
 	re-assessed.  */
-	*pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
-	if( *pxListWasEmpty == pdFALSE )
+	#if( configUSE_TIMER_WHEEL == 1 )
 	{
-		xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+		/* The timer wheel does not have to be processed when the tick count
+		rolls over, so this task blocks indefinitely when it is empty. */
+		if( uxTimerWheelCount == ( UBaseType_t ) 0U )
+		{
+			*pxListWasEmpty = pdTRUE;
+			xNextExpireTime = ( TickType_t ) 0U;
+		}
+		else
+		{
+			*pxListWasEmpty = pdFALSE;
+			xNextExpireTime = prvWheelNextEvent();
+		}
 	}
-	else
+	#else
 	{
-		/* Ensure the task unblocks when the tick count rolls over. */
-		xNextExpireTime = ( TickType_t ) 0U;
+		*pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
+		if( *pxListWasEmpty == pdFALSE )
+		{
+			xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+		}
+		else
+		{
+			/* Ensure the task unblocks when the tick count rolls over. */
+			xNextExpireTime = ( TickType_t ) 0U;
+		}
 	}
+	#endif /* configUSE_TIMER_WHEEL */
 
 	return xNextExpireTime;
 }
@@ -645,21 +774,31 @@ TickType_t xNextExpireTime;
 static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
 {
 TickType_t xTimeNow;
-PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Variable is only accessible to one task. */
 
 	xTimeNow = xTaskGetTickCount();
 
-	if( xTimeNow < xLastTime )
-	{
-		prvSwitchTimerLists();
-		*pxTimerListsWereSwitched = pdTRUE;
-	}
-	else
+	#if( configUSE_TIMER_WHEEL == 1 )
 	{
+		/* The timer wheel is not affected by the tick count overflowing. */
 		*pxTimerListsWereSwitched = pdFALSE;
 	}
+	#else
+	{
+	PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Variable is only accessible to one task. */
+
+		if( xTimeNow < xLastTime )
+		{
+			prvSwitchTimerLists();
+			*pxTimerListsWereSwitched = pdTRUE;
+		}
+		else
+		{
+			*pxTimerListsWereSwitched = pdFALSE;
+		}
 
-	xLastTime = xTimeNow;
+		xLastTime = xTimeNow;
+	}
+	#endif /* configUSE_TIMER_WHEEL */
 
 	return xTimeNow;
 }
@@ -684,7 +823,15 @@ BaseType_t xProcessTimerNow = pdFALSE;
 		}
 		else
 		{
-			vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+			#if( configUSE_TIMER_WHEEL == 1 )
+			{
+				prvWheelInsert( pxTimer, xNextExpiryTime );
+			}
+			#else
+			{
+				vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+			}
+			#endif /* configUSE_TIMER_WHEEL */
 		}
 	}
 	else
@@ -698,7 +845,15 @@ BaseType_t xProcessTimerNow = pdFALSE;
 		}
 		else
 		{
-			vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+			#if( configUSE_TIMER_WHEEL == 1 )
+			{
+				prvWheelInsert( pxTimer, xNextExpiryTime );
+			}
+			#else
+			{
+				vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+			}
+			#endif /* configUSE_TIMER_WHEEL */
 		}
 	}
 
@@ -708,43 +863,100 @@ BaseType_t xProcessTimerNow = pdFALSE;
 
 static void	prvProcessReceivedCommands( void )
 {
-DaemonTaskMessage_t xMessage;
-Timer_t *pxTimer;
-BaseType_t xTimerListsWereSwitched, xResult;
+DaemonTaskMessage_t xMessages[ tmrCOMMAND_BATCH_SIZE ];
+UBaseType_t uxCount, uxIndex;
+BaseType_t xTimerListsWereSwitched;
 TickType_t xTimeNow;
 
-	while( xQueueReceive( xTimerQueue, &xMessage, tmrNO_DELAY ) != pdFAIL ) /*lint !e603 xMessage does not have to be initialised as it is passed out, not in, and it is not used unless xQueueReceive() returns pdTRUE. */
+	for( ;; )
 	{
-		#if ( INCLUDE_xTimerPendFunctionCall == 1 )
+		for( uxCount = ( UBaseType_t ) 0U; uxCount < tmrCOMMAND_BATCH_SIZE; uxCount++ )
 		{
-			/* Negative commands are pended function calls rather than timer
-			commands. */
-			if( xMessage.xMessageID < ( BaseType_t ) 0 )
+			if( xQueueReceive( xTimerQueue, &( xMessages[ uxCount ] ), tmrNO_DELAY ) == pdFAIL ) /*lint !e603 xMessages does not have to be initialised as it is passed out, not in, and it is not used unless xQueueReceive() returns pdTRUE. */
 			{
-				const CallbackParameters_t * const pxCallback = &( xMessage.u.xCallbackParameters );
+				break;
+			}
+		}
 
-				/* The timer uses the xCallbackParameters member to request a
-				callback be executed.  Check the callback is not NULL. */
-				configASSERT( pxCallback );
+		if( uxCount == ( UBaseType_t ) 0U )
+		{
+			break;
+		}
+
+		/* In this case the xTimerListsWereSwitched parameter is not used, but
+		it must be present in the function call.  prvSampleTimeNow() must be
+		called after the messages are received from xTimerQueue so there is no
+		possibility of a higher priority task adding a message to the message
+		queue with a time that is ahead of the timer daemon task (because it
+		pre-empted the timer daemon task after the xTimeNow value was set). */
+		xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
 
-				/* Call the function. */
-				pxCallback->pxCallbackFunction( pxCallback->pvParameter1, pxCallback->ulParameter2 );
+		#if( configUSE_TIMER_WHEEL == 1 )
+		{
+			/* Timers are inserted into the wheel relative to the wheel time,
+			so bring it up to date.  It cannot be moved past timers that are
+			already due, which are processed after the commands as they would
+			be with the active timer lists. */
+			if( ( uxTimerWheelCount == ( UBaseType_t ) 0U ) || ( tmrEXPIRE_TIME_REACHED( prvWheelNextEvent(), xTimeNow ) == pdFALSE ) )
+			{
+				xTimerWheelTime = xTimeNow;
 			}
 			else
 			{
 				mtCOVERAGE_TEST_MARKER();
 			}
 		}
-		#endif /* INCLUDE_xTimerPendFunctionCall */
+		#endif /* configUSE_TIMER_WHEEL */
 
-		/* Commands that are positive are timer commands rather than pended
-		function calls. */
-		if( xMessage.xMessageID >= ( BaseType_t ) 0 )
+		for( uxIndex = ( UBaseType_t ) 0U; uxIndex < uxCount; uxIndex++ )
 		{
-			/* The messages uses the xTimerParameters member to work on a
-			software timer. */
-			pxTimer = xMessage.u.xTimerParameters.pxTimer;
+			prvProcessReceivedCommand( &( xMessages[ uxIndex ] ), xTimeNow );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessReceivedCommand( const DaemonTaskMessage_t * const pxMessage, const TickType_t xTimeNow )
+{
+Timer_t *pxTimer;
+BaseType_t xResult;
+
+	#if ( INCLUDE_xTimerPendFunctionCall == 1 )
+	{
+		/* Negative commands are pended function calls rather than timer
+		commands. */
+		if( pxMessage->xMessageID < ( BaseType_t ) 0 )
+		{
+			const CallbackParameters_t * const pxCallback = &( pxMessage->u.xCallbackParameters );
 
+			/* The timer uses the xCallbackParameters member to request a
+			callback be executed.  Check the callback is not NULL. */
+			configASSERT( pxCallback );
+
+			/* Call the function. */
+			pxCallback->pxCallbackFunction( pxCallback->pvParameter1, pxCallback->ulParameter2 );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* INCLUDE_xTimerPendFunctionCall */
+
+	/* Commands that are positive are timer commands rather than pended
+	function calls. */
+	if( pxMessage->xMessageID >= ( BaseType_t ) 0 )
+	{
+		/* The messages uses the xTimerParameters member to work on a
+		software timer. */
+		pxTimer = pxMessage->u.xTimerParameters.pxTimer;
+
+		#if( configUSE_TIMER_WHEEL == 1 )
+		{
+			prvWheelRemove( pxTimer );
+		}
+		#else
+		{
 			if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
 			{
 				/* The timer is in a list, remove it. */
@@ -754,106 +966,101 @@ TickType_t xTimeNow;
 			{
 				mtCOVERAGE_TEST_MARKER();
 			}
+		}
+		#endif /* configUSE_TIMER_WHEEL */
 
-			traceTIMER_COMMAND_RECEIVED( pxTimer, xMessage.xMessageID, xMessage.u.xTimerParameters.xMessageValue );
+		traceTIMER_COMMAND_RECEIVED( pxTimer, pxMessage->xMessageID, pxMessage->u.xTimerParameters.xMessageValue );
 
-			/* In this case the xTimerListsWereSwitched parameter is not used, but
-			it must be present in the function call.  prvSampleTimeNow() must be
-			called after the message is received from xTimerQueue so there is no
-			possibility of a higher priority task adding a message to the message
-			queue with a time that is ahead of the timer daemon task (because it
-			pre-empted the timer daemon task after the xTimeNow value was set). */
-			xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+		switch( pxMessage->xMessageID )
+		{
+			case tmrCOMMAND_START :
+			case tmrCOMMAND_START_FROM_ISR :
+			case tmrCOMMAND_RESET :
+			case tmrCOMMAND_RESET_FROM_ISR :
+			case tmrCOMMAND_START_DONT_TRACE :
+				/* Start or restart a timer. */
+				pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+				if( prvInsertTimerInActiveList( pxTimer,  pxMessage->u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow, pxMessage->u.xTimerParameters.xMessageValue ) != pdFALSE )
+				{
+					/* The timer expired before it was added to the active
+					timer list.  Process it now. */
+					pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+					traceTIMER_EXPIRED( pxTimer );
 
-			switch( xMessage.xMessageID )
-			{
-				case tmrCOMMAND_START :
-				case tmrCOMMAND_START_FROM_ISR :
-				case tmrCOMMAND_RESET :
-				case tmrCOMMAND_RESET_FROM_ISR :
-				case tmrCOMMAND_START_DONT_TRACE :
-					/* Start or restart a timer. */
-					pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
-					if( prvInsertTimerInActiveList( pxTimer,  xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow, xMessage.u.xTimerParameters.xMessageValue ) != pdFALSE )
+					if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
 					{
-						/* The timer expired before it was added to the active
-						timer list.  Process it now. */
-						pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
-						traceTIMER_EXPIRED( pxTimer );
-
-						if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
-						{
-							xResult = xTimerGenericCommand( pxTimer, tmrCOMMAND_START_DONT_TRACE, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, NULL, tmrNO_DELAY );
-							configASSERT( xResult );
-							( void ) xResult;
-						}
-						else
-						{
-							mtCOVERAGE_TEST_MARKER();
-						}
+						xResult = xTimerGenericCommand( pxTimer, tmrCOMMAND_START_DONT_TRACE, pxMessage->u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, NULL, tmrNO_DELAY );
+						configASSERT( xResult );
+						( void ) xResult;
 					}
 					else
 					{
 						mtCOVERAGE_TEST_MARKER();
 					}
-					break;
-
-				case tmrCOMMAND_STOP :
-				case tmrCOMMAND_STOP_FROM_ISR :
-					/* The timer has already been removed from the active list. */
-					pxTimer->ucStatus &= ~tmrSTATUS_IS_ACTIVE;
-					break;
-
-				case tmrCOMMAND_CHANGE_PERIOD :
-				case tmrCOMMAND_CHANGE_PERIOD_FROM_ISR :
-					pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
-					pxTimer->xTimerPeriodInTicks = xMessage.u.xTimerParameters.xMessageValue;
-					configASSERT( ( pxTimer->xTimerPeriodInTicks > 0 ) );
-
-					/* The new period does not really have a reference, and can
-					be longer or shorter than the old one.  The command time is
-					therefore set to the current time, and as the period cannot
-					be zero the next expiry time can only be in the future,
-					meaning (unlike for the xTimerStart() case above) there is
-					no fail case that needs to be handled here. */
-					( void ) prvInsertTimerInActiveList( pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
-					break;
-
-				case tmrCOMMAND_DELETE :
-					#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+				break;
+
+			case tmrCOMMAND_STOP :
+			case tmrCOMMAND_STOP_FROM_ISR :
+				/* The timer has already been removed from the active list. */
+				pxTimer->ucStatus &= ~tmrSTATUS_IS_ACTIVE;
+				break;
+
+			case tmrCOMMAND_CHANGE_PERIOD :
+			case tmrCOMMAND_CHANGE_PERIOD_FROM_ISR :
+				pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+				pxTimer->xTimerPeriodInTicks = pxMessage->u.xTimerParameters.xMessageValue;
+				configASSERT( ( pxTimer->xTimerPeriodInTicks > 0 ) );
+
+				/* The new period does not really have a reference, and can
+				be longer or shorter than the old one.  The command time is
+				therefore set to the current time, and as the period cannot
+				be zero the next expiry time can only be in the future,
+				meaning (unlike for the xTimerStart() case above) there is
+				no fail case that needs to be handled here. */
+				( void ) prvInsertTimerInActiveList( pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
+				break;
+
+			case tmrCOMMAND_DELETE :
+				#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+				{
+					/* The timer has already been removed from the active list,
+					just free up the memory if the memory was dynamically
+					allocated. */
+					if( ( pxTimer->ucStatus & tmrSTATUS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) 0 )
 					{
-						/* The timer has already been removed from the active list,
-						just free up the memory if the memory was dynamically
-						allocated. */
-						if( ( pxTimer->ucStatus & tmrSTATUS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) 0 )
-						{
-							vPortFree( pxTimer );
-						}
-						else
-						{
-							pxTimer->ucStatus &= ~tmrSTATUS_IS_ACTIVE;
-						}
+						vPortFree( pxTimer );
 					}
-					#else
+					else
 					{
-						/* If dynamic allocation is not enabled, the memory
-						could not have been dynamically allocated. So there is
-						no need to free the memory - just mark the timer as
-						"not active". */
 						pxTimer->ucStatus &= ~tmrSTATUS_IS_ACTIVE;
 					}
-					#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
-					break;
+				}
+				#else
+				{
+					/* If dynamic allocation is not enabled, the memory
+					could not have been dynamically allocated. So there is
+					no need to free the memory - just mark the timer as
+					"not active". */
+					pxTimer->ucStatus &= ~tmrSTATUS_IS_ACTIVE;
+				}
+				#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+				break;
 
-				default	:
-					/* Don't expect to get here. */
-					break;
-			}
+			default	:
+				/* Don't expect to get here. */
+				break;
 		}
 	}
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TIMER_WHEEL == 0 )
+
 static void prvSwitchTimerLists( void )
 {
 TickType_t xNextExpireTime, xReloadTime;
@@ -911,6 +1118,203 @@ BaseType_t xResult;
 	pxCurrentTimerList = pxOverflowTimerList;
 	pxOverflowTimerList = pxTemp;
 }
+
+#else /* configUSE_TIMER_WHEEL */
+
+static void prvWheelInsert( Timer_t * const pxTimer, const TickType_t xExpiryTime )
+{
+UBaseType_t uxLevel, uxSlot;
+TickType_t xDifference;
+
+	/* The timer goes in the level of the most significant digit in which
+	its expiry time differs from the wheel time, so it is cascaded into
+	the level below when the wheel time reaches its slot. */
+	xDifference = xExpiryTime ^ xTimerWheelTime;
+	uxLevel = tmrWHEEL_TOP_LEVEL;
+	while( ( uxLevel > ( UBaseType_t ) 0U ) && ( ( xDifference >> ( uxLevel * tmrWHEEL_SLOT_BITS ) ) == ( TickType_t ) 0U ) )
+	{
+		uxLevel--;
+	}
+
+	/* If the digit is smaller than that of the wheel time then the expiry
+	time is only reached after the tick count overflows, which the top level
+	of the wheel handles. */
+	if( ( uxLevel < tmrWHEEL_TOP_LEVEL ) && ( tmrWHEEL_DIGIT( xExpiryTime, uxLevel ) < tmrWHEEL_DIGIT( xTimerWheelTime, uxLevel ) ) )
+	{
+		uxLevel = tmrWHEEL_TOP_LEVEL;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	uxSlot = tmrWHEEL_DIGIT( xExpiryTime, uxLevel );
+
+	listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xExpiryTime );
+	listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
+	vListInsertEnd( &( xTimerWheel[ uxLevel ][ uxSlot ] ), &( pxTimer->xTimerListItem ) );
+	ulTimerWheelOccupied[ uxLevel ] |= ( uint32_t ) 1UL << uxSlot;
+	uxTimerWheelCount++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWheelRemove( Timer_t * const pxTimer )
+{
+List_t * const pxSlot = ( List_t * ) listLIST_ITEM_CONTAINER( &( pxTimer->xTimerListItem ) );
+UBaseType_t uxIndex;
+
+	if( pxSlot != NULL )
+	{
+		( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+		uxTimerWheelCount--;
+
+		if( listLIST_IS_EMPTY( pxSlot ) != pdFALSE )
+		{
+			uxIndex = ( UBaseType_t ) ( pxSlot - &( xTimerWheel[ 0 ][ 0 ] ) );
+			ulTimerWheelOccupied[ uxIndex / tmrWHEEL_SLOTS ] &= ~( ( uint32_t ) 1UL << ( uxIndex & tmrWHEEL_SLOT_MASK ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvWheelLowestSlot( uint32_t ulOccupied )
+{
+UBaseType_t uxSlot = ( UBaseType_t ) 0U;
+
+	/* ulOccupied must not be 0. */
+	while( ( ulOccupied & 1UL ) == 0UL )
+	{
+		ulOccupied >>= 1;
+		uxSlot++;
+	}
+
+	return uxSlot;
+}
+/*-----------------------------------------------------------*/
+
+static TickType_t prvWheelNextEvent( void )
+{
+UBaseType_t uxLevel, uxShift;
+uint32_t ulPending;
+TickType_t xPrefix;
+
+	for( uxLevel = ( UBaseType_t ) 0U; uxLevel < tmrWHEEL_LEVELS; uxLevel++ )
+	{
+		/* The slots of a level that are still ahead of the wheel time.  The
+		current slot of level 0 holds the timers that expire at the wheel
+		time itself, the current slot of the other levels has already been
+		cascaded. */
+		uxShift = uxLevel * tmrWHEEL_SLOT_BITS;
+		if( uxLevel == ( UBaseType_t ) 0U )
+		{
+			ulPending = ulTimerWheelOccupied[ 0 ] & ~( ( ( uint32_t ) 1UL << tmrWHEEL_DIGIT( xTimerWheelTime, 0 ) ) - 1UL );
+		}
+		else
+		{
+			ulPending = ulTimerWheelOccupied[ uxLevel ] & ~( ( ( uint32_t ) 2UL << tmrWHEEL_DIGIT( xTimerWheelTime, uxLevel ) ) - 1UL );
+		}
+
+		if( ulPending != 0UL )
+		{
+			if( ( uxShift + tmrWHEEL_SLOT_BITS ) < tmrWHEEL_TICK_BITS )
+			{
+				xPrefix = ( xTimerWheelTime >> ( uxShift + tmrWHEEL_SLOT_BITS ) ) << ( uxShift + tmrWHEEL_SLOT_BITS );
+			}
+			else
+			{
+				xPrefix = ( TickType_t ) 0U;
+			}
+
+			return xPrefix | ( ( TickType_t ) prvWheelLowestSlot( ulPending ) << uxShift );
+		}
+	}
+
+	/* All the timers are in slots of the top level that are only reached
+	after the tick count overflows. */
+	configASSERT( ulTimerWheelOccupied[ tmrWHEEL_TOP_LEVEL ] != 0UL );
+	return ( TickType_t ) prvWheelLowestSlot( ulTimerWheelOccupied[ tmrWHEEL_TOP_LEVEL ] ) << ( tmrWHEEL_TOP_LEVEL * tmrWHEEL_SLOT_BITS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWheelAdvance( const TickType_t xTimeNow )
+{
+TickType_t xEventTime;
+UBaseType_t uxLevel;
+List_t *pxSlot;
+Timer_t *pxTimer;
+
+	for( ;; )
+	{
+		if( uxTimerWheelCount == ( UBaseType_t ) 0U )
+		{
+			xTimerWheelTime = xTimeNow;
+			break;
+		}
+
+		xEventTime = prvWheelNextEvent();
+		if( tmrEXPIRE_TIME_REACHED( xEventTime, xTimeNow ) == pdFALSE )
+		{
+			xTimerWheelTime = xTimeNow;
+			break;
+		}
+
+		xTimerWheelTime = xEventTime;
+
+		/* Cascade the slots the wheel time has reached into the levels below,
+		starting from the top so a timer can move down several levels. */
+		for( uxLevel = tmrWHEEL_TOP_LEVEL; uxLevel > ( UBaseType_t ) 0U; uxLevel-- )
+		{
+			if( ( xEventTime & ( ( ( TickType_t ) 1U << ( uxLevel * tmrWHEEL_SLOT_BITS ) ) - ( TickType_t ) 1U ) ) == ( TickType_t ) 0U )
+			{
+				pxSlot = &( xTimerWheel[ uxLevel ][ tmrWHEEL_DIGIT( xEventTime, uxLevel ) ] );
+				while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+				{
+					pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+					prvWheelRemove( pxTimer );
+					prvWheelInsert( pxTimer, listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) ) );
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		/* Process the timers that expire at the wheel time. */
+		pxSlot = &( xTimerWheel[ 0 ][ tmrWHEEL_DIGIT( xEventTime, 0 ) ] );
+		while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+		{
+			pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+			prvWheelRemove( pxTimer );
+			traceTIMER_EXPIRED( pxTimer );
+
+			/* The reload time is relative to the expiry time rather than to
+			the current time so auto-reload timers do not drift.  If it has
+			already passed the timer is processed again by this loop. */
+			if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
+			{
+				prvWheelInsert( pxTimer, xEventTime + pxTimer->xTimerPeriodInTicks );
+			}
+			else
+			{
+				pxTimer->ucStatus &= ~tmrSTATUS_IS_ACTIVE;
+			}
+
+			/* Call the timer callback. */
+			pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+		}
+	}
+}
+
+#endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
 static void prvCheckForValidListAndQueue( void )
@@ -922,10 +1326,26 @@ static void prvCheckForValidListAndQueue( void )
 	{
 		if( xTimerQueue == NULL )
 		{
-			vListInitialise( &xActiveTimerList1 );
-			vListInitialise( &xActiveTimerList2 );
-			pxCurrentTimerList = &xActiveTimerList1;
-			pxOverflowTimerList = &xActiveTimerList2;
+			#if( configUSE_TIMER_WHEEL == 1 )
+			{
+			UBaseType_t uxLevel, uxSlot;
+
+				for( uxLevel = ( UBaseType_t ) 0U; uxLevel < tmrWHEEL_LEVELS; uxLevel++ )
+				{
+					for( uxSlot = ( UBaseType_t ) 0U; uxSlot < tmrWHEEL_SLOTS; uxSlot++ )
+					{
+						vListInitialise( &( xTimerWheel[ uxLevel ][ uxSlot ] ) );
+					}
+				}
+			}
+			#else
+			{
+				vListInitialise( &xActiveTimerList1 );
+				vListInitialise( &xActiveTimerList2 );
+				pxCurrentTimerList = &xActiveTimerList1;
+				pxOverflowTimerList = &xActiveTimerList2;
+			}
+			#endif /* configUSE_TIMER_WHEEL */
 
 			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
 			{
@@ -0,0 +1,41 @@
+/* Host stub configuration of the event group model. DIRECT selects
+configUSE_EVENT_GROUP_DIRECT_ISR and configUSE_QUEUE_EVENT_BITS. */
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+#include <assert.h>
+#define configUSE_PREEMPTION 1
+#define configUSE_IDLE_HOOK 1
+#define configUSE_TICK_HOOK 0
+#define configTICK_RATE_HZ 1000
+#define configCPU_CLOCK_HZ 1000000
+#define configMAX_PRIORITIES 8
+#define configMINIMAL_STACK_SIZE 64
+#define configUSE_16_BIT_TICKS 0
+#define configUSE_MUTEXES 1
+#define configUSE_COUNTING_SEMAPHORES 1
+#define configSUPPORT_DYNAMIC_ALLOCATION 1
+#define configMAX_TASK_NAME_LEN 16
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+#define configUSE_TIMERS 1
+#define configTIMER_TASK_PRIORITY 7
+#define configTIMER_QUEUE_LENGTH 64
+#define configTIMER_TASK_STACK_DEPTH 64
+#define INCLUDE_xTimerPendFunctionCall 1
+#define INCLUDE_vTaskDelay 1
+#define INCLUDE_vTaskDelete 1
+#ifndef DIRECT
+#define DIRECT 1
+#endif
+#define configUSE_EVENT_GROUP_DIRECT_ISR DIRECT
+#define configUSE_QUEUE_EVENT_BITS DIRECT
+#define configASSERT( x ) assert( x )
+#ifdef SIM_HOOKS
+/* Let interrupts in while the scheduler is suspended in the event group code. */
+void vSimInterrupt( void );
+extern unsigned long ulSwitches;
+#define traceEVENT_GROUP_SET_BITS( x, y ) vSimInterrupt()
+#define traceEVENT_GROUP_WAIT_BITS_BLOCK( x, y ) vSimInterrupt()
+#endif
+extern unsigned long ulSwitches;
+#define traceTASK_SWITCHED_IN() ulSwitches++
+#endif
@@ -0,0 +1,42 @@
+#!/bin/sh
+# Builds the event group models with the kernel on the host ucontext port
+# (../Port), and runs them:
+# - event_group_isr_test.c, direct ISR path and queue event bits, with
+#   interrupts fired from the event group trace hooks, for 20 seeds;
+# - event_group_static_check.c, with and without the new options;
+# - event_group_isr_bench.c, deferred and direct, with 0, 8 and 32 other
+#   waiters.
+# build.sh [output directory]
+HERE=$(cd "$(dirname "$0")" && pwd)
+SRC=$HERE/../../Source
+PORT=$HERE/../Port
+OUT=${1:-${TMPDIR:-/tmp}/event_group_isr_test}
+CC=${CC:-cc}
+mkdir -p "$OUT" || exit 1
+
+KERNEL="$SRC/queue.c $SRC/tasks.c $SRC/list.c $SRC/timers.c $SRC/event_groups.c $PORT/port.c"
+# build <output> <source> [defines]
+build()
+{
+  N=$1; T=$2; shift 2
+  $CC -O2 -Wall -Wno-unused-parameter -I"$HERE" -I"$PORT" -I"$SRC/include" "$@" \
+    -o "$OUT/$N" "$HERE/$T.c" $KERNEL || exit 1
+}
+
+build event_group_isr_test event_group_isr_test -DSIM_HOOKS
+for D in 0 1; do
+  build event_group_static_check$D event_group_static_check -DDIRECT=$D \
+    -DconfigSUPPORT_STATIC_ALLOCATION=1
+  build event_group_isr_bench$D event_group_isr_bench -DDIRECT=$D
+done
+
+SEED=1
+while [ $SEED -le 20 ]; do
+  echo "== seed $SEED"
+  "$OUT/event_group_isr_test" $SEED || exit 1
+  SEED=$((SEED + 1))
+done
+"$OUT/event_group_static_check0" && "$OUT/event_group_static_check1" || exit 1
+for N in 0 8 32; do
+  "$OUT/event_group_isr_bench0" $N && "$OUT/event_group_isr_bench1" $N || exit 1
+done
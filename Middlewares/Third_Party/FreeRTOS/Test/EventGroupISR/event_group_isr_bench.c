@@ -0,0 +1,49 @@
+/* Latency from xEventGroupSetBitsFromISR() to the waiting task running, with
+the set deferred to the timer task (DIRECT=0) or done in the ISR (DIRECT=1).
+event_group_isr_bench [other waiters] */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_groups.h"
+#define EVENTS 200000
+static EventGroupHandle_t xG;
+static double t0, sum, best = 1e9;
+static unsigned long ulSw0, ulSwSum, n;
+static int nOthers;
+static double now( void ) { struct timespec t; clock_gettime( CLOCK_MONOTONIC, &t ); return t.tv_sec * 1e9 + t.tv_nsec; }
+unsigned long ulSwitches;
+void vApplicationIdleHook( void )
+{
+	/* The "interrupt": preempts the idle task. */
+	BaseType_t xWoken = pdFALSE;
+	ulSw0 = ulSwitches;
+	t0 = now();
+	xEventGroupSetBitsFromISR( xG, 1, &xWoken );
+	if( xWoken ) vPortYield();
+}
+static void vWaiter( void *p )
+{
+	for( ;; )
+	{
+		xEventGroupWaitBits( xG, 1, pdTRUE, pdFALSE, portMAX_DELAY );
+		double d = now() - t0;
+		if( n > 1000 ) { sum += d; if( d < best ) best = d; ulSwSum += ulSwitches - ulSw0; }
+		if( ++n == EVENTS + 1000 )
+		{
+			printf( "DIRECT=%d other waiters %2d: mean %6.0f ns  min %6.0f ns  context switches %.1f\n", DIRECT, nOthers, sum / EVENTS, best, ( double ) ulSwSum / EVENTS );
+			exit( 0 );
+		}
+	}
+}
+static void vOther( void *p ) { for( ;; ) xEventGroupWaitBits( xG, 2, pdTRUE, pdFALSE, portMAX_DELAY ); }
+int main( int argc, char **argv )
+{
+	nOthers = argc > 1 ? atoi( argv[ 1 ] ) : 0;
+	xG = xEventGroupCreate();
+	for( int i = 0; i < nOthers; i++ ) xTaskCreate( vOther, "O", 64, NULL, 1, NULL );
+	xTaskCreate( vWaiter, "W", 64, NULL, 5, NULL );
+	vTaskStartScheduler();
+	return 1;
+}
@@ -0,0 +1,212 @@
+/* Functional test of the direct-from-ISR event group path and of queues and
+semaphores setting event bits: lost wake ups show up as items left in a queue,
+or a handshake bit left unconsumed, once the producers stop.
+event_group_isr_test [seed] */
+#include <stdio.h>
+#include <stdlib.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "event_groups.h"
+#define NID 6
+#define BIT_A 1
+#define BIT_B 2
+#define BIT_S 4
+#define BIT_E 8
+#define NH 7
+static EventGroupHandle_t xG, xG2;
+static QueueHandle_t xQA, xQB;
+static SemaphoreHandle_t xS;
+static uint64_t ullCycles;
+static TickType_t xSimTicks;
+static unsigned long ulSeed = 1;
+static unsigned prvRand( unsigned n ) { ulSeed = ulSeed * 1103515245UL + 12345UL; return ( unsigned ) ( ( ulSeed >> 16 ) % n ); }
+static uint32_t ulNext[ NID ], ulExp[ NID ];
+static unsigned long ulTx, ulRx, ulGive, ulTake, ulE, ulWake[ NH ], ulHSet, ulHSetIsr, ulNest;
+static volatile int armed[ NH ];
+static int depth, xIsrWoken; static volatile int stop;
+unsigned long ulSwitches;
+static void prvFinish( void );
+static void prvCheck( uint32_t v )
+{
+	uint32_t id = v >> 24, seq = v & 0xFFFFFF;
+	assert( id < NID );
+	if( seq != ulExp[ id ] ) { fprintf( stderr, "order id %u got %u exp %u\n", id, seq, ulExp[ id ] ); abort(); }
+	ulExp[ id ]++; ulRx++;
+}
+static void prvIsrBody( void )
+{
+	BaseType_t xWoken = pdFALSE;
+	int id2 = depth == 1 ? 2 : 4, id3 = depth == 1 ? 3 : 5;
+	uint32_t buf[ 8 ];
+	switch( prvRand( 8 ) )
+	{
+		case 0:
+			buf[ 0 ] = ( id2 << 24 ) | ulNext[ id2 ];
+			if( xQueueSendFromISR( xQA, buf, &xWoken ) == pdPASS ) { ulNext[ id2 ]++; ulTx++; }
+			break;
+		case 1:
+		{
+			unsigned n = 1 + prvRand( 6 );
+			for( unsigned i = 0; i < n; i++ ) buf[ i ] = ( id3 << 24 ) | ( ulNext[ id3 ] + i );
+			BaseType_t s = xQueueSendMultipleFromISR( xQB, buf, n, &xWoken );
+			ulNext[ id3 ] += s; ulTx += s;
+			break;
+		}
+		case 2:
+			if( xSemaphoreGiveFromISR( xS, &xWoken ) == pdPASS ) ulGive++;
+			break;
+		case 3:
+			( void ) xEventGroupSetBitsFromISR( xG, BIT_E, &xWoken );
+			break;
+		default:
+		{
+			int b = prvRand( NH );
+			if( armed[ b ] ) { armed[ b ] = 0; ulHSetIsr++; ( void ) xEventGroupSetBitsFromISR( xG2, 1u << b, &xWoken ); }
+			break;
+		}
+	}
+	if( xWoken ) xIsrWoken = 1;
+}
+void vSimInterrupt( void )
+{
+	if( depth || stop || prvRand( 8 ) ) return;
+	depth = 1; prvIsrBody(); depth = 0;
+	if( xIsrWoken ) { xIsrWoken = 0; vPortYield(); }
+}
+void vSimUnmask( void )
+{
+	if( depth != 1 || stop || prvRand( 3 ) ) return;
+	ulNest++;
+	depth = 2; prvIsrBody(); depth = 1;
+}
+static void prvTick( void )
+{
+	xSimTicks++;
+	depth = 1;
+	BaseType_t w = xTaskIncrementTick();
+	depth = 0;
+	if( xSimTicks == 40000 ) stop = 1;
+	if( xSimTicks == 43000 ) prvFinish();
+	if( w ) vPortYield();
+}
+static void prvBusy( unsigned n )
+{
+	while( n-- )
+	{
+		ullCycles++;
+		if( ( ullCycles / 1000 ) > xSimTicks ) prvTick();
+		if( ( ullCycles % 97 ) == 0 ) vSimInterrupt();
+	}
+}
+void vApplicationIdleHook( void ) { prvBusy( 50 ); }
+static void vProducerA( void *p )
+{
+	for( ;; )
+	{
+		while( stop ) vTaskDelay( 100 );
+		uint32_t v = ( 0u << 24 ) | ulNext[ 0 ];
+		if( xQueueSend( xQA, &v, prvRand( 4 ) ? portMAX_DELAY : prvRand( 3 ) ) == pdPASS ) { ulNext[ 0 ]++; ulTx++; }
+		if( prvRand( 3 ) == 0 ) { if( xSemaphoreGive( xS ) == pdPASS ) ulGive++; }
+		prvBusy( 20 + prvRand( 300 ) );
+		if( prvRand( 4 ) == 0 ) vTaskDelay( prvRand( 3 ) );
+	}
+}
+static void vProducerB( void *p )
+{
+	uint32_t buf[ 12 ];
+	for( ;; )
+	{
+		while( stop ) vTaskDelay( 100 );
+		unsigned n = 1 + prvRand( 12 );
+		for( unsigned i = 0; i < n; i++ ) buf[ i ] = ( 1u << 24 ) | ( ulNext[ 1 ] + i );
+		/* Larger than the queue, so blocks part way through. */
+		BaseType_t s = xQueueSendMultiple( xQB, buf, n, prvRand( 5 ) ? portMAX_DELAY : prvRand( 4 ) );
+		ulNext[ 1 ] += s; ulTx += s;
+		prvBusy( 20 + prvRand( 400 ) );
+		if( prvRand( 3 ) == 0 ) vTaskDelay( 1 + prvRand( 3 ) );
+	}
+}
+static void vConsumer( void *p )
+{
+	uint32_t buf[ 4 ], v;
+	for( ;; )
+	{
+		EventBits_t b = xEventGroupWaitBits( xG, BIT_A | BIT_B | BIT_S | BIT_E, pdTRUE, pdFALSE, prvRand( 8 ) ? portMAX_DELAY : prvRand( 5 ) );
+		if( b & BIT_A ) while( xQueueReceive( xQA, &v, 0 ) == pdPASS ) { prvCheck( v ); prvBusy( prvRand( 20 ) ); }
+		if( b & BIT_B ) { BaseType_t r; while( ( r = xQueueReceiveMultiple( xQB, buf, 1 + prvRand( 4 ), 0 ) ) > 0 ) { for( int i = 0; i < r; i++ ) prvCheck( buf[ i ] ); prvBusy( prvRand( 20 ) ); } }
+		if( b & BIT_S ) while( xSemaphoreTake( xS, 0 ) == pdPASS ) ulTake++;
+		if( b & BIT_E ) ulE++;
+		prvBusy( prvRand( 200 ) );
+	}
+}
+/* Waiter k: any of bit k, clear on exit, except waiter 4 (all of bits 4 and 5)
+and waiter 5 (bit 6, not cleared on exit). */
+static void vWaiter( void *p )
+{
+	int k = ( int ) ( intptr_t ) p;
+	EventBits_t m = k < 4 ? ( 1u << k ) : k == 4 ? 0x30 : 0x40;
+	for( ;; )
+	{
+		for( int b = 0; b < NH; b++ ) if( m & ( 1u << b ) ) armed[ b ] = 1;
+		EventBits_t r = xEventGroupWaitBits( xG2, m, k != 5, k == 4, portMAX_DELAY );
+		assert( ( r & m ) == m );
+		if( k == 5 ) xEventGroupClearBits( xG2, m );
+		ulWake[ k ]++;
+		prvBusy( prvRand( 300 ) );
+		if( prvRand( 4 ) == 0 ) vTaskDelay( prvRand( 3 ) );
+	}
+}
+static void vSetter( void *p )
+{
+	for( ;; )
+	{
+		int b = prvRand( NH ), doit = 0;
+		taskENTER_CRITICAL(); if( armed[ b ] && !stop ) { armed[ b ] = 0; doit = 1; } taskEXIT_CRITICAL();
+		if( doit ) { ulHSet++; xEventGroupSetBits( xG2, 1u << b ); }
+		prvBusy( 50 + prvRand( 500 ) );
+		if( prvRand( 2 ) ) vTaskDelay( prvRand( 2 ) );
+	}
+}
+static void prvFinish( void )
+{
+	unsigned long w = 0;
+	for( int k = 0; k < 6; k++ ) w += ulWake[ k ];
+	fprintf( stderr, "tx %lu rx %lu give %lu take %lu E %lu | handshake task %lu isr %lu wakes %lu nested %lu switches %lu\n",
+		ulTx, ulRx, ulGive, ulTake, ulE, ulHSet, ulHSetIsr, w, ulNest, ulSwitches );
+	fprintf( stderr, "QA %lu QB %lu G %lx\n", ( unsigned long ) uxQueueMessagesWaiting( xQA ), ( unsigned long ) uxQueueMessagesWaiting( xQB ), ( unsigned long ) xEventGroupGetBitsFromISR( xG ) );
+	assert( ulTx == ulRx );
+	assert( uxQueueMessagesWaiting( xQA ) == 0 && uxQueueMessagesWaiting( xQB ) == 0 );
+	assert( ulGive == ulTake && uxSemaphoreGetCount( xS ) == 0 );
+	EventBits_t g2 = xEventGroupGetBitsFromISR( xG2 );
+	for( int b = 0; b < NH; b++ )
+	{
+		/* The all-bits waiter can legitimately hold one of its two bits. */
+		int ok = armed[ b ] || ( ( b == 4 || b == 5 ) && ( g2 & ( 1u << b ) ) && armed[ 9 - b ] );
+		if( !ok ) { fprintf( stderr, "bit %d not consumed (g2 %lx)\n", b, ( unsigned long ) g2 ); abort(); }
+	}
+	assert( ( g2 & 0x4f ) == 0 );
+	exit( 0 );
+}
+int main( int argc, char **argv )
+{
+	ulSeed = argc > 1 ? atoi( argv[ 1 ] ) : 1;
+	depth = 1;
+	xG = xEventGroupCreate(); xG2 = xEventGroupCreate();
+	xQA = xQueueCreate( 8, sizeof( uint32_t ) );
+	xQB = xQueueCreate( 4, sizeof( uint32_t ) );
+	xS = xSemaphoreCreateCounting( 100000, 0 );
+	assert( xQueueAddToEventGroup( xQA, xG, BIT_A ) == pdPASS );
+	assert( xQueueAddToEventGroup( xQA, xG, BIT_A ) == pdFAIL );
+	assert( xQueueAddToEventGroup( xQB, xG, BIT_B ) == pdPASS );
+	assert( xQueueAddToEventGroup( xS, xG, BIT_S ) == pdPASS );
+	xTaskCreate( vProducerA, "PA", 64, NULL, 2, NULL );
+	xTaskCreate( vProducerB, "PB", 64, NULL, 4, NULL );
+	xTaskCreate( vConsumer, "C", 64, NULL, 3, NULL );
+	for( int k = 0; k < 6; k++ ) xTaskCreate( vWaiter, "W", 64, ( void * ) ( intptr_t ) k, 1 + k, NULL );
+	xTaskCreate( vSetter, "T", 64, NULL, 2, NULL );
+	depth = 0;
+	vTaskStartScheduler();
+	return 1;
+}
@@ -0,0 +1,19 @@
+/* Creates a static event group and queue: the kernel asserts that the Static*
+structures have the size of the ones they stand for. */
+#include <stdio.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "event_groups.h"
+unsigned long ulSwitches;
+void vApplicationIdleHook( void ) {}
+void vApplicationGetIdleTaskMemory( StaticTask_t **a, StackType_t **b, uint32_t *c ) {}
+void vApplicationGetTimerTaskMemory( StaticTask_t **a, StackType_t **b, uint32_t *c ) {}
+int main( void )
+{
+	static StaticEventGroup_t e; static StaticQueue_t q; static uint8_t s[ 16 ];
+	EventGroupHandle_t g = xEventGroupCreateStatic( &e );
+	QueueHandle_t h = xQueueCreateStatic( 4, 4, s, &q );
+	printf( "static ok %p %p\n", ( void * ) g, ( void * ) h );
+	return 0;
+}
@@ -0,0 +1,22 @@
+/* Host stub configuration of the heap benchmark: the heap size comes from
+HEAP_SIZE, and heap_5 is given one region of that size. */
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+#include <assert.h>
+#define configUSE_PREEMPTION 1
+#define configUSE_IDLE_HOOK 0
+#define configUSE_TICK_HOOK 0
+#define configTICK_RATE_HZ 1000
+#define configMAX_PRIORITIES 5
+#define configMINIMAL_STACK_SIZE 128
+#define configUSE_16_BIT_TICKS 0
+#define configSUPPORT_DYNAMIC_ALLOCATION 1
+#define configSUPPORT_STATIC_ALLOCATION 0
+#define configUSE_MALLOC_FAILED_HOOK 0
+#ifndef HEAP_SIZE
+#define HEAP_SIZE ( 64 * 1024 )
+#endif
+#define configTOTAL_HEAP_SIZE HEAP_SIZE
+#define configMAX_TASK_NAME_LEN 8
+#define configASSERT( x ) assert( x )
+#endif
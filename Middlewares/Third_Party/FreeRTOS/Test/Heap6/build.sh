@@ -0,0 +1,47 @@
+#!/bin/sh
+# Builds the heap benchmark (heap_bench.c) against heap_4.c, heap_5.c and
+# heap_6.c with 2, 3 and 4 second level bits (configTLSF_SL_INDEX_COUNT_LOG2),
+# and runs them for both workloads and 3 seeds on a 64K heap.
+# heap_4.c and heap_5.c are copied with a counter added to their free list
+# walks, to show the worst number of steps a call took.
+# build.sh [output directory]
+HERE=$(cd "$(dirname "$0")" && pwd)
+SRC=$HERE/../../Source
+MEM=$SRC/portable/MemMang
+PORT=$HERE/../Port
+OUT=${1:-${TMPDIR:-/tmp}/heap_bench}
+CC=${CC:-cc}
+mkdir -p "$OUT" || exit 1
+
+for H in 4 5; do
+  sed -e '1i extern unsigned long ulSimSteps;' \
+    -e 's|/\* Nothing to do here, just iterate to the right position. \*/|ulSimSteps++;|' \
+    -e '/while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != NULL ) )/{n;s/{/{ ulSimSteps++;/;}' \
+    "$MEM/heap_$H.c" > "$OUT/heap_$H.c" || exit 1
+  if [ "$(grep -c ulSimSteps "$OUT/heap_$H.c")" != 3 ]; then
+    echo "FAIL: the free list walks of heap_$H.c were not found"
+    exit 1
+  fi
+done
+
+# build <name> <heap source> [defines]
+build()
+{
+  N=$1; H=$2; shift 2
+  $CC -O2 -Wall -Wno-unused-parameter -I"$HERE" -I"$PORT" -I"$SRC/include" \
+    -DNAME="\"$N\"" "$@" -o "$OUT/$N" "$HERE/heap_bench.c" "$H" || exit 1
+}
+build heap_4 "$OUT/heap_4.c" -DHEAP=4
+build heap_5 "$OUT/heap_5.c" -DHEAP=5
+for SL in 2 3 4; do
+  build heap_6_sl$SL "$MEM/heap_6.c" -DHEAP=6 -DconfigTLSF_SL_INDEX_COUNT_LOG2=$SL
+done
+
+echo "time per call: median/99.99th percentile/maximum; steps: malloc/free"
+for W in 0 1; do
+  for SEED in 1 2 3; do
+    for N in heap_4 heap_5 heap_6_sl2 heap_6_sl3 heap_6_sl4; do
+      "$OUT/$N" $W $SEED || exit 1
+    done
+  done
+done
@@ -0,0 +1,109 @@
+/* Randomized workload run against heap_4.c, heap_5.c or heap_6.c (HEAP=4, 5
+or 6), with NLIVE slots that are each allocated or freed at random.
+- workload 0: 70% of 8-64 bytes, 25% of 64-512 bytes, 5% of 512-4096 bytes;
+- workload 1: 75% of 0-99 bytes, 25% of 0-1999 bytes.
+Every block is filled with a tag and checked before it is freed, and must be
+aligned. At the end every block is freed, and the free byte count must be
+back to its initial value. With heap_6, xPortGetLargestFreeBlockSize() is
+checked every 1000 operations: a request of that size must succeed, and one
+a byte larger must fail.
+Prints:
+- the time per pvPortMalloc() and vPortFree(): median, 99.99th percentile and
+  maximum, the last mostly showing the host preempting the run;
+- the most free list steps a heap_4 or heap_5 call took, counted by build.sh
+  in copies of them;
+- the allocations that failed, and of those the ones that failed although the
+  free bytes would have fitted the block with 64 bytes to spare, which are
+  caused by fragmentation;
+- the lowest free byte count.
+heap_bench <workload> <seed> */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#define NLIVE 600
+#define OPS 2000000
+unsigned long ulSimSteps;
+void vTaskSuspendAll( void ) {}
+BaseType_t xTaskResumeAll( void ) { return pdFALSE; }
+#if HEAP == 5
+static uint8_t ucRegion[ HEAP_SIZE ] __attribute__(( aligned( 8 ) ));
+#endif
+static void *apv[ NLIVE ]; static size_t axSz[ NLIVE ]; static uint8_t aucTag[ NLIVE ];
+static unsigned long aulMalloc[ OPS ], aulFree[ OPS ];
+static unsigned long now( void ) { struct timespec t; clock_gettime( CLOCK_MONOTONIC, &t ); return ( unsigned long ) t.tv_sec * 1000000000UL + ( unsigned long ) t.tv_nsec; }
+static int cmp( const void *a, const void *b ) { unsigned long x = *( const unsigned long * ) a, y = *( const unsigned long * ) b; return x < y ? -1 : x > y; }
+static size_t prvSize( int w, unsigned *s )
+{
+	unsigned r = rand_r( s ) % 100;
+	if( w == 0 ) return r < 70 ? 8 + rand_r( s ) % 57 : r < 95 ? 64 + rand_r( s ) % 449 : 512 + rand_r( s ) % 3585;
+	return r < 75 ? rand_r( s ) % 100 : rand_r( s ) % 2000;
+}
+#define CHECK( x ) do { if( !( x ) ) { printf( "FAIL %s workload %d seed %u op %ld: %s\n", NAME, w, seed, op, #x ); return 1; } } while( 0 )
+int main( int argc, char **argv )
+{
+	int w = argc > 1 ? atoi( argv[ 1 ] ) : 0;
+	unsigned seed = argc > 2 ? ( unsigned ) atoi( argv[ 2 ] ) : 1, s = seed;
+	size_t nM = 0, nF = 0, xTries = 0, xFail = 0, xFragFail = 0, i, k, xInitial, xMinFree;
+	unsigned long t, ulStepsM = 0, ulStepsF = 0, ulSteps;
+	long op = -1;
+	void *pv;
+#if HEAP == 5
+	HeapRegion_t r[] = { { ucRegion, sizeof ucRegion }, { NULL, 0 } };
+	vPortDefineHeapRegions( r );
+#endif
+	/* heap_4 and heap_6 only set up the heap on the first call. */
+	pv = pvPortMalloc( 8 ); vPortFree( pv );
+	xInitial = xMinFree = xPortGetFreeHeapSize();
+	for( op = 0; op < OPS; op++ )
+	{
+		i = rand_r( &s ) % NLIVE;
+		if( apv[ i ] )
+		{
+			for( k = 0; k < axSz[ i ]; k++ ) CHECK( ( ( uint8_t * ) apv[ i ] )[ k ] == aucTag[ i ] );
+			ulSteps = ulSimSteps; t = now();
+			vPortFree( apv[ i ] );
+			aulFree[ nF++ ] = now() - t;
+			if( ulSimSteps - ulSteps > ulStepsF ) ulStepsF = ulSimSteps - ulSteps;
+			apv[ i ] = NULL;
+		}
+		else
+		{
+			size_t xSize = prvSize( w, &s ), xFree = xPortGetFreeHeapSize();
+			ulSteps = ulSimSteps; t = now();
+			apv[ i ] = pvPortMalloc( xSize );
+			aulMalloc[ nM++ ] = now() - t;
+			if( ulSimSteps - ulSteps > ulStepsM ) ulStepsM = ulSimSteps - ulSteps;
+			xTries++;
+			if( apv[ i ] == NULL ) { if( xSize > 0 ) { xFail++; if( xFree >= xSize + 64 ) xFragFail++; } continue; }
+			CHECK( ( ( size_t ) apv[ i ] & portBYTE_ALIGNMENT_MASK ) == 0 );
+			if( xPortGetFreeHeapSize() < xMinFree ) xMinFree = xPortGetFreeHeapSize();
+			axSz[ i ] = xSize; aucTag[ i ] = ( uint8_t ) rand_r( &s );
+			memset( apv[ i ], aucTag[ i ], xSize );
+		}
+#if HEAP == 6
+		if( ( op % 1000 ) == 0 && ( k = xPortGetLargestFreeBlockSize() ) > 0 )
+		{
+			CHECK( pvPortMalloc( k + 1 ) == NULL );
+			CHECK( ( pv = pvPortMalloc( k ) ) != NULL );
+			vPortFree( pv );
+		}
+#endif
+	}
+	CHECK( xPortGetMinimumEverFreeHeapSize() <= xMinFree );
+	for( i = 0; i < NLIVE; i++ ) if( apv[ i ] ) vPortFree( apv[ i ] );
+	CHECK( xPortGetFreeHeapSize() == xInitial );
+#if HEAP == 6
+	/* Everything merged back into one block. */
+	CHECK( ( pv = pvPortMalloc( xPortGetLargestFreeBlockSize() ) ) != NULL && xPortGetFreeHeapSize() < 64 );
+	vPortFree( pv );
+#endif
+	qsort( aulMalloc, nM, sizeof aulMalloc[ 0 ], cmp ); qsort( aulFree, nF, sizeof aulFree[ 0 ], cmp );
+	printf( "%-9s w%d seed %u: malloc %4lu/%5lu/%6lu ns, free %4lu/%5lu/%6lu ns, steps %3lu/%3lu, failed %5.2f%% (fragmentation %5.2f%%), min free %zu\n",
+		NAME, w, seed, aulMalloc[ nM / 2 ], aulMalloc[ nM - 1 - nM / 10000 ], aulMalloc[ nM - 1 ],
+		aulFree[ nF / 2 ], aulFree[ nF - 1 - nF / 10000 ], aulFree[ nF - 1 ], ulStepsM, ulStepsF,
+		100.0 * xFail / xTries, 100.0 * xFragFail / xTries, xMinFree );
+	return 0;
+}
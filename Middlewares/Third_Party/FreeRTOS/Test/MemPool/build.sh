@@ -0,0 +1,22 @@
+#!/bin/sh
+# Builds the memory pool test (mem_pool_test.c) against mem_pool.c on the host
+# thread port (../PortThreads), and runs it at -O0 and -O2. Then checks
+# that mem_pool.c also builds without configASSERT().
+# build.sh [output directory]
+HERE=$(cd "$(dirname "$0")" && pwd)
+SRC=$HERE/../../Source
+PORT=$HERE/../PortThreads
+OUT=${1:-${TMPDIR:-/tmp}/mem_pool_test}
+CC=${CC:-cc}
+mkdir -p "$OUT" || exit 1
+
+for O in O0 O2; do
+  $CC -$O -Wall -Wno-unused-parameter -pthread -I"$HERE" -I"$PORT" \
+    -I"$SRC/include" -o "$OUT/mem_pool_test_$O" "$HERE/mem_pool_test.c" \
+    "$SRC/mem_pool.c" "$PORT/port.c" || exit 1
+  echo "== -$O"
+  "$OUT/mem_pool_test_$O" || exit 1
+done
+$CC -fsyntax-only -Wall -Wextra -Wno-unused-parameter -DSIM_NO_ASSERT \
+  -I"$HERE" -I"$PORT" -I"$SRC/include" "$SRC/mem_pool.c" || exit 1
+echo "build without configASSERT() passed"
@@ -0,0 +1,118 @@
+/* Memory pool test, on the thread port (../PortThreads): tasks and interrupts
+are threads.
+- static pool: layout, exhaustion, pointers that are not blocks;
+- double frees, at the head and in the middle of the free list, and blocks that
+  have never been allocated are rejected and fail configASSERT(), and the
+  remaining blocks are then allocated without duplicates;
+- an allocated block holding the free marker is still freed;
+- blocks too small for the marker: never allocated blocks are still rejected;
+- 4 threads mixing task and ISR calls end with all blocks free;
+- the time to free a block with 0 and with 4000 blocks already free. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mem_pool.h"
+int iSimAsserts;
+static double now( void ) { struct timespec t; clock_gettime( CLOCK_MONOTONIC, &t ); return t.tv_sec * 1e9 + t.tv_nsec; }
+
+static MemPoolHandle_t p;
+static void *worker( void *a )
+{
+	unsigned s = ( unsigned ) ( uintptr_t ) a; void *held[ 8 ]; int n = 0;
+	for( int i = 0; i < 200000; i++ )
+	{
+		s = s * 1103515245u + 12345u;
+		if( ( ( s >> 16 ) & 1 ) && n < 8 ) { void *b = ( i & 2 ) ? pvMemPoolAllocFromISR( p ) : pvMemPoolAlloc( p ); if( b ) { memset( b, ( int ) s, 20 ); held[ n++ ] = b; } }
+		else if( n ) { assert( xMemPoolFree( p, held[ --n ] ) == pdPASS ); }
+	}
+	while( n ) assert( xMemPoolFreeFromISR( p, held[ --n ] ) == pdPASS );
+	return NULL;
+}
+/* Mean time of a free then alloc of the same block, with uxFree blocks free. */
+static double prvFreeTime( unsigned uxFree )
+{
+	enum { N = 4096 };
+	MemPoolHandle_t q = xMemPoolCreate( 16, N );
+	static void *b[ N ];
+	double t;
+	for( int i = 0; i < N; i++ ) b[ i ] = pvMemPoolAlloc( q );
+	for( unsigned i = 0; i < uxFree; i++ ) assert( xMemPoolFree( q, b[ i ] ) == pdPASS );
+	t = now();
+	for( int i = 0; i < 100000; i++ )
+	{
+		assert( xMemPoolFree( q, b[ N - 1 ] ) == pdPASS );
+		assert( pvMemPoolAlloc( q ) == b[ N - 1 ] );
+	}
+	t = ( now() - t ) / 100000;
+	vMemPoolDelete( q );
+	return t;
+}
+int main( void )
+{
+	static uint8_t st[ memPOOL_STORAGE_SIZE( 20, 10 ) ] __attribute__( ( aligned( 8 ) ) );
+	static StaticMemPool_t sp;
+	MemPoolHandle_t q = xMemPoolCreateStatic( 20, 10, st, &sp );
+	void *b[ 11 ];
+	assert( xMemPoolGetBlockSize( q ) == 24 );
+	for( int i = 0; i < 10; i++ ) { b[ i ] = pvMemPoolAlloc( q ); assert( b[ i ] == st + 24 * i ); }
+	assert( pvMemPoolAlloc( q ) == NULL && uxMemPoolGetFreeCount( q ) == 0 );
+	assert( xMemPoolFree( q, st + 1 ) == pdFAIL && xMemPoolFree( q, st + 240 ) == pdFAIL && xMemPoolFree( q, ( void * ) ( ( uintptr_t ) st - 24 ) ) == pdFAIL );
+	assert( xMemPoolFree( q, b[ 3 ] ) == pdPASS && pvMemPoolAlloc( q ) == b[ 3 ] );
+	for( int i = 0; i < 10; i++ ) assert( xMemPoolFree( q, b[ i ] ) == pdPASS );
+	assert( iSimAsserts == 0 );
+	assert( xMemPoolFree( q, b[ 0 ] ) == pdFAIL && iSimAsserts == 1 );
+	assert( xMemPoolFree( q, b[ 9 ] ) == pdFAIL && iSimAsserts == 2 );
+	assert( uxMemPoolGetFreeCount( q ) == 10 && uxMemPoolGetMinimumEverFreeCount( q ) == 0 );
+	vMemPoolDelete( q );
+
+	/* Double frees and never allocated blocks with some blocks in use. */
+	q = xMemPoolCreateStatic( 20, 10, st, &sp );
+	for( int i = 0; i < 4; i++ ) b[ i ] = pvMemPoolAlloc( q );
+	assert( xMemPoolFree( q, st + 24 * 4 ) == pdFAIL && iSimAsserts == 3 );	/* never allocated */
+	assert( xMemPoolFree( q, st + 24 * 9 ) == pdFAIL && iSimAsserts == 4 );
+	assert( xMemPoolFree( q, b[ 1 ] ) == pdPASS && xMemPoolFree( q, b[ 2 ] ) == pdPASS );
+	assert( xMemPoolFree( q, b[ 1 ] ) == pdFAIL && iSimAsserts == 5 );	/* double free, not at the head */
+	assert( xMemPoolFree( q, b[ 2 ] ) == pdFAIL && iSimAsserts == 6 );	/* double free, at the head */
+	assert( uxMemPoolGetFreeCount( q ) == 8 );
+	{
+		void *c[ 10 ]; int n = 0;
+		while( ( c[ n ] = pvMemPoolAlloc( q ) ) != NULL ) n++;
+		assert( n == 8 );
+		for( int i = 0; i < n; i++ ) for( int j = 0; j < i; j++ ) assert( c[ i ] != c[ j ] );
+
+		/* An allocated block whose data happens to be its free marker (the
+		word after the link) is found not to be in the free list. */
+		uint64_t m = ( ( uint64_t ) ( uintptr_t ) c[ 0 ] ) ^ 0xA55AA55AUL;
+		memcpy( ( uint8_t * ) c[ 0 ] + sizeof( void * ), &m, sizeof m );
+		assert( xMemPoolFree( q, c[ 0 ] ) == pdPASS && iSimAsserts == 6 );
+		assert( xMemPoolFree( q, c[ 0 ] ) == pdFAIL && iSimAsserts == 7 );
+	}
+	vMemPoolDelete( q );
+
+	/* Blocks that only hold the link: no marker, so only the never allocated
+	blocks are detected, and freeing still works. */
+	q = xMemPoolCreate( 8, 4 );
+	assert( xMemPoolGetBlockSize( q ) == 8 );
+	for( int i = 0; i < 2; i++ ) b[ i ] = pvMemPoolAlloc( q );
+	assert( xMemPoolFree( q, ( uint8_t * ) b[ 1 ] + 8 ) == pdFAIL && iSimAsserts == 8 );
+	assert( xMemPoolFree( q, b[ 0 ] ) == pdPASS && xMemPoolFree( q, b[ 1 ] ) == pdPASS && iSimAsserts == 8 );
+	assert( pvMemPoolAlloc( q ) == b[ 1 ] && pvMemPoolAlloc( q ) == b[ 0 ] );
+	vMemPoolDelete( q );
+
+	p = xMemPoolCreate( 20, 16 );
+	pthread_t t[ 4 ];
+	for( long i = 0; i < 4; i++ ) pthread_create( &t[ i ], NULL, worker, ( void * ) ( i + 1 ) );
+	for( int i = 0; i < 4; i++ ) pthread_join( t[ i ], NULL );
+	assert( uxMemPoolGetFreeCount( p ) == 16 && iSimAsserts == 8 );
+	printf( "4 threads: all blocks free, lowest free count %lu\n", uxMemPoolGetMinimumEverFreeCount( p ) );
+	vMemPoolDelete( p );
+
+	printf( "free + alloc with    0 blocks free: %6.1f ns\n", prvFreeTime( 0 ) );
+	printf( "free + alloc with 4000 blocks free: %6.1f ns\n", prvFreeTime( 4000 ) );
+	printf( "PASS, %d expected configASSERT() failures\n", iSimAsserts );
+	return 0;
+}
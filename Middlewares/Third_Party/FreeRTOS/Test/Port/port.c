@@ -0,0 +1,46 @@
+/* Host stub port shared by the kernel tests: each task runs on its own
+ucontext, switched on yield. The test's model interrupt, vSimInterrupt(), runs
+whenever a critical section is left, and its nested one, vSimUnmask(), whenever
+an ISR unmasks. Both do nothing unless the test defines them. */
+#include <ucontext.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "FreeRTOS.h"
+#include "task.h"
+extern void * volatile pxCurrentTCB;
+static ucontext_t xMain;
+static int nesting, pending;
+volatile int xSimYieldFromISR;
+__attribute__(( weak )) void vSimInterrupt( void ) {}
+__attribute__(( weak )) void vSimUnmask( void ) {}
+#define CTX( tcb ) ( *( ucontext_t ** ) ( tcb ) )
+static void prvSwitch( void )
+{
+	void *old = pxCurrentTCB;
+	vTaskSwitchContext();
+	if( pxCurrentTCB != old ) swapcontext( CTX( old ), CTX( pxCurrentTCB ) );
+}
+void vPortYield( void ) { if( nesting ) pending = 1; else prvSwitch(); }
+void vPortEnterCritical( void ) { nesting++; }
+void vPortExitCritical( void )
+{
+	if( --nesting == 0 )
+	{
+		/* An interrupt that became pending in the critical section runs as
+		soon as it is left. */
+		vSimInterrupt();
+		if( pending ) { pending = 0; prvSwitch(); }
+	}
+}
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+	ucontext_t *c = malloc( sizeof *c );
+	getcontext( c );
+	c->uc_stack.ss_size = 256 * 1024; c->uc_stack.ss_sp = malloc( c->uc_stack.ss_size ); c->uc_link = NULL;
+	makecontext( c, ( void ( * )( void ) ) pxCode, 1, pvParameters );
+	return ( StackType_t * ) c;
+}
+BaseType_t xPortStartScheduler( void ) { swapcontext( &xMain, CTX( pxCurrentTCB ) ); return 0; }
+void vPortEndScheduler( void ) {}
+void *pvPortMalloc( size_t x ) { return malloc( x ); }
+void vPortFree( void *p ) { free( p ); }
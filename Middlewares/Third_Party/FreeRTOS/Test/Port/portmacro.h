@@ -0,0 +1,41 @@
+/* Host stub port: tasks run on ucontext, see port.c */
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+#include <stdint.h>
+#include <stddef.h>
+#define portCHAR char
+#define portFLOAT float
+#define portDOUBLE double
+#define portLONG long
+#define portSHORT short
+#define portSTACK_TYPE uint64_t
+#define portBASE_TYPE long
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+#define portMAX_DELAY ( TickType_t ) 0xffffffffUL
+#define portTICK_TYPE_IS_ATOMIC 1
+#define portSTACK_GROWTH -1
+#define portTICK_PERIOD_MS 1
+#define portBYTE_ALIGNMENT 8
+#define portPOINTER_SIZE_TYPE uint64_t
+void vPortYield( void );
+void vPortEnterCritical( void );
+void vPortExitCritical( void );
+void vSimUnmask( void );
+extern volatile int xSimYieldFromISR;
+#define portYIELD() vPortYield()
+#define portYIELD_FROM_ISR( x ) do { if( x ) xSimYieldFromISR = 1; } while( 0 )
+#define portEND_SWITCHING_ISR( x ) portYIELD_FROM_ISR( x )
+#define portENTER_CRITICAL() vPortEnterCritical()
+#define portEXIT_CRITICAL() vPortExitCritical()
+#define portDISABLE_INTERRUPTS()
+#define portENABLE_INTERRUPTS()
+#define portSET_INTERRUPT_MASK_FROM_ISR() 0
+/* Interrupts that nest on an ISR can run whenever it unmasks. */
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( x ) do { ( void ) ( x ); vSimUnmask(); } while( 0 )
+#define portNOP()
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void *pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void *pvParameters )
+#endif
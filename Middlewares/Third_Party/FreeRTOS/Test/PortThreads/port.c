@@ -0,0 +1,41 @@
+/* Host stub port shared by the kernel object tests that run on threads rather
+than on the scheduler: critical sections take one recursive mutex, and a task
+waiting for a notification waits on a condition variable. The tick does not
+advance, so a wait times out after its number of ticks in milliseconds, once. */
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include <errno.h>
+#include "FreeRTOS.h"
+#include "task.h"
+static pthread_mutex_t xLock;
+static pthread_once_t xOnce = PTHREAD_ONCE_INIT;
+static void prvInit( void ) { pthread_mutexattr_t a; pthread_mutexattr_init( &a ); pthread_mutexattr_settype( &a, PTHREAD_MUTEX_RECURSIVE ); pthread_mutex_init( &xLock, &a ); }
+void vSimEnterCritical( void ) { pthread_once( &xOnce, prvInit ); pthread_mutex_lock( &xLock ); }
+void vSimExitCritical( void ) { pthread_mutex_unlock( &xLock ); }
+void *pvPortMalloc( size_t x ) { return malloc( x ); }
+void vPortFree( void *p ) { free( p ); }
+
+typedef struct { pthread_cond_t c; int pending; } SimTask_t;
+static __thread SimTask_t *pxSelf;
+unsigned long ulSimBlocks;
+TaskHandle_t xTaskGetCurrentTaskHandle( void ) { if( !pxSelf ) { pxSelf = calloc( 1, sizeof *pxSelf ); pthread_cond_init( &pxSelf->c, NULL ); } return ( TaskHandle_t ) pxSelf; }
+BaseType_t xTaskGenericNotify( TaskHandle_t xTask, uint32_t v, eNotifyAction a, uint32_t *p ) { SimTask_t *t = ( SimTask_t * ) xTask; vSimEnterCritical(); t->pending = 1; pthread_cond_signal( &t->c ); vSimExitCritical(); return pdPASS; }
+BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTask, uint32_t v, eNotifyAction a, uint32_t *p, BaseType_t *w ) { if( w ) *w = pdTRUE; return xTaskGenericNotify( xTask, v, a, p ); }
+BaseType_t xTaskNotifyStateClear( TaskHandle_t xTask ) { xTaskGetCurrentTaskHandle(); pxSelf->pending = 0; return pdTRUE; }
+BaseType_t xTaskNotifyWait( uint32_t a, uint32_t b, uint32_t *c, TickType_t xTicks )
+{
+	struct timespec ts; int r = 0;
+	xTaskGetCurrentTaskHandle();
+	ulSimBlocks++;
+	clock_gettime( CLOCK_REALTIME, &ts ); ts.tv_nsec += ( long ) xTicks * 1000000L; ts.tv_sec += ts.tv_nsec / 1000000000L; ts.tv_nsec %= 1000000000L;
+	vSimEnterCritical();
+	while( !pxSelf->pending && r != ETIMEDOUT ) r = pthread_cond_timedwait( &pxSelf->c, &xLock, &ts );
+	r = pxSelf->pending; pxSelf->pending = 0;
+	vSimExitCritical();
+	return r ? pdTRUE : pdFALSE;
+}
+void vTaskSetTimeOutState( TimeOut_t *t ) { t->xOverflowCount = 0; t->xTimeOnEntering = 0; }
+BaseType_t xTaskCheckForTimeOut( TimeOut_t *t, TickType_t *w ) { return pdTRUE; }
+void vTaskSuspendAll( void ) { vSimEnterCritical(); }
+BaseType_t xTaskResumeAll( void ) { vSimExitCritical(); return pdFALSE; }
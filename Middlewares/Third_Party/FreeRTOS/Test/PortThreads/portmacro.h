@@ -0,0 +1,38 @@
+/* Host stub port: tasks and interrupts are threads, and critical sections take
+a recursive mutex, see port.c */
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+#include <stdint.h>
+#include <stddef.h>
+#define portCHAR char
+#define portFLOAT float
+#define portDOUBLE double
+#define portLONG long
+#define portSHORT short
+#define portSTACK_TYPE uint64_t
+#define portBASE_TYPE long
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+#define portMAX_DELAY ( TickType_t ) 0xffffffffUL
+#define portTICK_TYPE_IS_ATOMIC 1
+#define portSTACK_GROWTH -1
+#define portTICK_PERIOD_MS 1
+#define portBYTE_ALIGNMENT 8
+#define portPOINTER_SIZE_TYPE uint64_t
+void vSimEnterCritical( void );
+void vSimExitCritical( void );
+#define portYIELD()
+#define portYIELD_FROM_ISR( x ) ( void ) ( x )
+#define portENTER_CRITICAL() vSimEnterCritical()
+#define portEXIT_CRITICAL() vSimExitCritical()
+#define portDISABLE_INTERRUPTS()
+#define portENABLE_INTERRUPTS()
+#define portSET_INTERRUPT_MASK_FROM_ISR() ( vSimEnterCritical(), 0 )
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( x ) ( ( void ) ( x ), vSimExitCritical() )
+#define portNOP()
+#define portMEMORY_BARRIER() __sync_synchronize()
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void *pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void *pvParameters )
+#endif
@@ -0,0 +1,22 @@
+/* Host stub configuration of the queue model */
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+#include <assert.h>
+#define configUSE_PREEMPTION 1
+#define configUSE_IDLE_HOOK 1
+#define configUSE_TICK_HOOK 0
+#define configTICK_RATE_HZ 1000
+#define configCPU_CLOCK_HZ 1000000
+#define configMAX_PRIORITIES 6
+#define configMINIMAL_STACK_SIZE 64
+#define configUSE_16_BIT_TICKS 0
+#define configUSE_MUTEXES 1
+#define configUSE_COUNTING_SEMAPHORES 1
+#define configUSE_QUEUE_SETS 1
+#define configSUPPORT_DYNAMIC_ALLOCATION 1
+#define configMAX_TASK_NAME_LEN 16
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+#define INCLUDE_vTaskDelay 1
+#define INCLUDE_vTaskDelete 1
+#define configASSERT( x ) assert( x )
+#endif
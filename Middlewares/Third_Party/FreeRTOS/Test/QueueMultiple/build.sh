@@ -0,0 +1,26 @@
+#!/bin/sh
+# Builds the multi-item queue test (queue_multiple_test.c) with the kernel on
+# the host ucontext port (../Port) and runs it for 6 seeds and queue lengths of
+# 1, 7, 37 and 300, then runs the cost per item benchmark
+# (queue_multiple_bench.c).
+# build.sh [output directory]
+HERE=$(cd "$(dirname "$0")" && pwd)
+SRC=$HERE/../../Source
+PORT=$HERE/../Port
+OUT=${1:-${TMPDIR:-/tmp}/queue_multiple_test}
+CC=${CC:-cc}
+mkdir -p "$OUT" || exit 1
+
+KERNEL="$SRC/queue.c $SRC/tasks.c $SRC/list.c $PORT/port.c"
+for T in queue_multiple_test queue_multiple_bench; do
+  $CC -O2 -Wall -Wno-unused-parameter -I"$HERE" -I"$PORT" -I"$SRC/include" \
+    -o "$OUT/$T" "$HERE/$T.c" $KERNEL || exit 1
+done
+
+for LEN in 1 7 37 300; do
+  for SEED in 1 2 3 4 5 6; do
+    echo "== seed $SEED, queue length $LEN"
+    "$OUT/queue_multiple_test" $SEED $LEN || exit 1
+  done
+done
+"$OUT/queue_multiple_bench"
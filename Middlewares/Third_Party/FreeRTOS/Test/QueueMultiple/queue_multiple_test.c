@@ -0,0 +1,173 @@
+/* Functional test of the multi-item queue API: task and ISR producers and
+consumers, mixed with the single item API and a queue set. Every item must be
+received exactly once and in order per producer.
+queue_multiple_test [seed] [queue length] */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#define NPROD 4
+#define MAXSEQ 4000000
+static QueueHandle_t xQ, xQ2;
+static QueueSetHandle_t xSet;
+static uint64_t ullCycles;
+static TickType_t xSimTicks;
+static unsigned long ulSeed = 1;
+static unsigned prvRand( unsigned n ) { ulSeed = ulSeed * 1103515245UL + 12345UL; return ( unsigned ) ( ( ulSeed >> 16 ) % n ); }
+static uint32_t ulNext[ NPROD + 1 ];         /* next sequence to send per producer */
+static uint8_t *pucSeen[ NPROD + 1 ];
+static uint32_t ulLast[ 8 ][ NPROD + 1 ];    /* last seq seen per consumer per producer */
+static unsigned long ulRx, ulRxIsr, ulTx, ulIsrFull, ulQ2Tx, ulQ2Rx;
+static unsigned long ulPerC[ 8 ];
+static int inIsr; static volatile int stop;
+static void prvCheck( int c, const uint32_t *p, BaseType_t n )
+{
+	for( BaseType_t i = 0; i < n; i++ )
+	{
+		uint32_t id = p[ i ] >> 24, seq = p[ i ] & 0xFFFFFF;
+		if( !( id <= NPROD && seq < MAXSEQ ) ) { fprintf( stderr, "bad c=%d i=%ld n=%ld v=%08x rx=%lu tx=%lu\n", c, ( long ) i, ( long ) n, p[ i ], ulRx, ulTx ); abort(); }
+		assert( !pucSeen[ id ][ seq ] ); pucSeen[ id ][ seq ] = 1;
+		assert( ulLast[ c ][ id ] == 0 || seq > ulLast[ c ][ id ] - 1 ); ulLast[ c ][ id ] = seq + 1;
+	}
+}
+static void prvFill( int id, uint32_t *p, unsigned n ) { for( unsigned i = 0; i < n; i++ ) p[ i ] = ( ( uint32_t ) id << 24 ) | ( ulNext[ id ] + i ); }
+static void prvFinish( void );
+void vSimInterrupt( void )
+{
+	if( inIsr || stop || prvRand( 40 ) ) return;
+	inIsr = 1;
+	BaseType_t xWoken = pdFALSE;
+	uint32_t buf[ 80 ];
+	if( prvRand( 6 ) )
+	{
+		unsigned n = 1 + prvRand( 64 );
+		prvFill( NPROD, buf, n );
+		BaseType_t s = xQueueSendMultipleFromISR( xQ, buf, n, &xWoken );
+		assert( s >= 0 && ( unsigned ) s <= n );
+		if( ( unsigned ) s < n ) ulIsrFull++;
+		ulNext[ NPROD ] += s; ulTx += s;
+	}
+	else
+	{
+		BaseType_t r = xQueueReceiveMultipleFromISR( xQ, buf, 1 + prvRand( 40 ), &xWoken );
+		prvCheck( 7, buf, r ); ulRx += r; ulRxIsr += r;
+	}
+	inIsr = 0;
+	if( xWoken ) vPortYield();
+}
+static void prvTick( void )
+{
+	xSimTicks++;
+	inIsr = 1;
+	BaseType_t w = xTaskIncrementTick();
+	inIsr = 0;
+	if( xSimTicks == 30000 ) stop = 1;
+	if( xSimTicks == 32000 ) prvFinish();
+	if( w ) vPortYield();
+}
+static void prvBusy( unsigned n )
+{
+	while( n-- )
+	{
+		ullCycles++;
+		if( ( ullCycles / 1000 ) > xSimTicks ) prvTick();
+		if( ( ullCycles % 211 ) == 0 ) vSimInterrupt();
+	}
+}
+void vApplicationIdleHook( void ) { prvBusy( 50 ); }
+static void vProducer( void *p )
+{
+	int id = ( int ) ( intptr_t ) p;
+	uint32_t buf[ 100 ];
+	for( ;; )
+	{
+		while( stop ) vTaskDelay( 10 );
+		unsigned n = 1 + prvRand( id == 0 ? 100 : 20 );
+		prvFill( id, buf, n );
+		if( id == 2 && n > 10 ) n = 1;
+		BaseType_t s;
+		if( id == 2 ) s = xQueueSend( xQ, buf, prvRand( 3 ) ) == pdPASS ? 1 : 0;
+		else s = xQueueSendMultiple( xQ, buf, n, prvRand( 4 ) ? portMAX_DELAY : prvRand( 3 ) );
+		assert( s >= 0 && ( unsigned ) s <= n );
+		ulNext[ id ] += s; ulTx += s;
+		prvBusy( 50 + prvRand( 400 ) );
+		if( prvRand( 3 ) == 0 ) vTaskDelay( prvRand( 3 ) );
+	}
+}
+static void vConsumer( void *p )
+{
+	int c = ( int ) ( intptr_t ) p;
+	uint32_t buf[ 64 ];
+	for( ;; )
+	{
+		BaseType_t r;
+		if( c == 2 ) r = xQueueReceive( xQ, buf, prvRand( 5 ) ) == pdPASS ? 1 : 0;
+		else r = xQueueReceiveMultiple( xQ, buf, 1 + prvRand( 64 ), prvRand( 4 ) ? portMAX_DELAY : prvRand( 3 ) );
+		assert( r >= 0 && r <= 64 );
+		prvCheck( c, buf, r ); ulRx += r; ulPerC[ c ] += r;
+		prvBusy( 30 + prvRand( c == 0 ? 600 : 200 ) );
+		if( c == 0 && prvRand( 2 ) ) vTaskDelay( 1 + prvRand( 3 ) );
+	}
+}
+/* Queue set member fed by xQueueSendMultiple(): one set event per item. */
+static void vSetProducer( void *p )
+{
+	uint32_t buf[ 16 ];
+	for( ;; )
+	{
+		while( stop ) vTaskDelay( 10 );
+		unsigned n = 1 + prvRand( 16 );
+		BaseType_t s = xQueueSendMultiple( xQ2, buf, n, portMAX_DELAY );
+		assert( ( unsigned ) s == n ); ulQ2Tx += s;
+		prvBusy( 100 + prvRand( 500 ) );
+		vTaskDelay( 1 + prvRand( 3 ) );
+	}
+}
+static void vSetConsumer( void *p )
+{
+	uint32_t v;
+	for( ;; )
+	{
+		QueueSetMemberHandle_t h = xQueueSelectFromSet( xSet, portMAX_DELAY );
+		assert( h == xQ2 );
+		assert( xQueueReceive( xQ2, &v, 0 ) == pdPASS ); ulQ2Rx++;
+		prvBusy( 20 + prvRand( 60 ) );
+	}
+}
+static void prvFinish( void )
+{
+	uint32_t buf[ 64 ]; BaseType_t r;
+	while( ( r = xQueueReceiveMultipleFromISR( xQ, buf, 64, NULL ) ) > 0 ) { prvCheck( 6, buf, r ); ulRx += r; }
+	unsigned long seen = 0;
+	for( int id = 0; id <= NPROD; id++ ) for( uint32_t s = 0; s < ulNext[ id ]; s++ ) { assert( pucSeen[ id ][ s ] ); seen++; }
+	fprintf( stderr, "tx %lu rx %lu (isr rx %lu) seen %lu isr-full %lu | set tx %lu rx %lu waiting %lu\n", ulTx, ulRx, ulRxIsr, seen, ulIsrFull, ulQ2Tx, ulQ2Rx, ( unsigned long ) uxQueueMessagesWaiting( xQ2 ) );
+	fprintf( stderr, "per consumer %lu %lu %lu\n", ulPerC[0], ulPerC[1], ulPerC[2] );
+	assert( ulTx == ulRx && seen == ulTx );
+	assert( ulPerC[ 0 ] != 0 && ulPerC[ 1 ] != 0 && ulPerC[ 2 ] != 0 );
+	assert( ulQ2Tx == ulQ2Rx + uxQueueMessagesWaiting( xQ2 ) );
+	exit( 0 );
+}
+int main( int argc, char **argv )
+{
+	ulSeed = argc > 1 ? atoi( argv[ 1 ] ) : 1;
+	for( int i = 0; i <= NPROD; i++ ) pucSeen[ i ] = calloc( MAXSEQ, 1 );
+	inIsr = 1;
+	xQ = xQueueCreate( argc > 2 ? atoi( argv[ 2 ] ) : 37, sizeof( uint32_t ) );
+	xQ2 = xQueueCreate( 20, sizeof( uint32_t ) );
+	xSet = xQueueCreateSet( 20 );
+	xQueueAddToSet( xQ2, xSet );
+	xTaskCreate( vProducer, "P0", 64, ( void * ) 0, 2, NULL );
+	xTaskCreate( vProducer, "P1", 64, ( void * ) 1, 3, NULL );
+	xTaskCreate( vProducer, "P2", 64, ( void * ) 2, 1, NULL );
+	xTaskCreate( vProducer, "P3", 64, ( void * ) 3, 4, NULL );
+	xTaskCreate( vConsumer, "C0", 64, ( void * ) 0, 3, NULL );
+	xTaskCreate( vConsumer, "C1", 64, ( void * ) 1, 2, NULL );
+	xTaskCreate( vConsumer, "C2", 64, ( void * ) 2, 2, NULL );
+	xTaskCreate( vSetProducer, "SP", 64, NULL, 2, NULL );
+	xTaskCreate( vSetConsumer, "SC", 64, NULL, 3, NULL );
+	inIsr = 0;
+	vTaskStartScheduler();
+	return 1;
+}
@@ -0,0 +1,24 @@
+/* Host stub configuration of the stream buffer acquire/commit test:
+configASSERT() counts the failures instead of aborting, so that the misuses
+that must assert can be checked. */
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+#include <assert.h>
+#define configUSE_PREEMPTION 1
+#define configUSE_IDLE_HOOK 0
+#define configUSE_TICK_HOOK 0
+#define configTICK_RATE_HZ 1000
+#define configMAX_PRIORITIES 5
+#define configMINIMAL_STACK_SIZE 128
+#define configUSE_16_BIT_TICKS 0
+#define configUSE_MUTEXES 1
+#define configSUPPORT_DYNAMIC_ALLOCATION 1
+#define configSUPPORT_STATIC_ALLOCATION 0
+#define configUSE_TASK_NOTIFICATIONS 1
+#define configTOTAL_HEAP_SIZE 4096
+#define configMAX_TASK_NAME_LEN 8
+#define INCLUDE_xTaskGetCurrentTaskHandle 1
+extern int iSimAsserts;
+#define configASSERT( x ) do { if( !( x ) ) iSimAsserts++; } while( 0 )
+#define portASSERT_IF_INTERRUPT_PRIORITY_INVALID()
+#endif
@@ -0,0 +1,20 @@
+#!/bin/sh
+# Builds the stream buffer acquire/commit test (stream_buffer_acquire_test.c)
+# against stream_buffer.c on the host thread port (../PortThreads), and runs it
+# at -O0 and -O2.
+# build.sh [output directory]
+HERE=$(cd "$(dirname "$0")" && pwd)
+SRC=$HERE/../../Source
+PORT=$HERE/../PortThreads
+OUT=${1:-${TMPDIR:-/tmp}/stream_buffer_acquire_test}
+CC=${CC:-cc}
+mkdir -p "$OUT" || exit 1
+
+for O in O0 O2; do
+  $CC -$O -Wall -Wno-unused-parameter -pthread -I"$HERE" -I"$PORT" \
+    -I"$SRC/include" -o "$OUT/stream_buffer_acquire_test_$O" \
+    "$HERE/stream_buffer_acquire_test.c" "$SRC/stream_buffer.c" "$PORT/port.c" \
+    || exit 1
+  echo "== -$O"
+  "$OUT/stream_buffer_acquire_test_$O" || exit 1
+done
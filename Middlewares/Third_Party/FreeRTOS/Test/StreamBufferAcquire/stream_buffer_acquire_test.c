@@ -0,0 +1,119 @@
+/* Stream buffer acquire/commit test, on the thread port (../PortThreads).
+- one thread: the regions returned at the start, before and after the wrap,
+  and the commits and releases that must fail configASSERT();
+- a producer thread and a consumer thread move 20 MB through a 257 byte
+  buffer, mixing task, FromISR and copying calls, and every byte is checked.
+stream_buffer_acquire_test [bytes] */
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+int iSimAsserts;
+extern unsigned long ulSimBlocks;
+static StreamBufferHandle_t xSB;
+static unsigned long ulTotal = 20000000UL, ulFromIsr;
+static uint8_t prvByte( unsigned long n ) { return ( uint8_t ) ( n * 7 + ( n >> 8 ) ); }
+#define CHECK( x ) do { if( !( x ) ) { printf( "FAIL line %d: %s\n", __LINE__, #x ); exit( 1 ); } } while( 0 )
+
+static void prvRegions( void )
+{
+	StreamBufferHandle_t x = xStreamBufferCreate( 16, 1 );
+	MessageBufferHandle_t m = xMessageBufferCreate( 16 );
+	uint8_t *base, cp[ 16 ];
+	void *pv;
+
+	/* Empty: the whole buffer is free from the start, nothing to read. */
+	CHECK( xStreamBufferSendAcquire( x, &pv, 0 ) == 16 );
+	base = pv;
+	CHECK( xStreamBufferReceiveAcquire( x, &pv, 0 ) == 0 );
+	memset( base, 'a', 10 );
+	vStreamBufferSendCommit( x, 10 );
+	CHECK( xStreamBufferBytesAvailable( x ) == 10 );
+	CHECK( xStreamBufferReceiveAcquireFromISR( x, &pv ) == 10 && pv == base );
+	vStreamBufferReceiveRelease( x, 10 );
+	CHECK( xStreamBufferIsEmpty( x ) == pdTRUE );
+
+	/* At offset 10 of the 17 byte storage only 7 bytes are contiguous. */
+	CHECK( xStreamBufferSendAcquireFromISR( x, &pv ) == 7 && pv == base + 10 );
+	memset( pv, 'b', 7 );
+	vStreamBufferSendCommit( x, 7 );
+	CHECK( xStreamBufferSendAcquire( x, &pv, 0 ) == 9 && pv == base );
+	memset( pv, 'c', 9 );
+	vStreamBufferSendCommit( x, 9 );
+	CHECK( xStreamBufferIsFull( x ) == pdTRUE );
+	CHECK( xStreamBufferSendAcquire( x, &pv, 0 ) == 0 );
+
+	/* The reader also gets the data up to the wrap first. */
+	CHECK( xStreamBufferReceiveAcquire( x, &pv, 0 ) == 7 && pv == base + 10 );
+	vStreamBufferReceiveRelease( x, 4 );
+	CHECK( xStreamBufferReceiveAcquire( x, &pv, 0 ) == 3 && pv == base + 14 );
+	CHECK( xStreamBufferReceive( x, cp, sizeof cp, 0 ) == 12 );
+	CHECK( memcmp( cp, "bbbccccccccc", 12 ) == 0 );
+	CHECK( iSimAsserts == 0 );
+
+	/* Committing or releasing more than the region fails configASSERT(). The
+	buffer is empty at offset 9, so 8 bytes are contiguous. */
+	CHECK( xStreamBufferSendAcquire( x, &pv, 0 ) == 8 );
+	vStreamBufferSendCommit( x, 9 );
+	CHECK( iSimAsserts == 1 );
+	vStreamBufferReceiveRelease( x, 10 );
+	CHECK( iSimAsserts == 3 );
+
+	/* Message buffers frame each message with its length. */
+	( void ) xStreamBufferSendAcquire( m, &pv, 0 );
+	( void ) xStreamBufferReceiveAcquireFromISR( m, &pv );
+	CHECK( iSimAsserts == 5 );
+	iSimAsserts = 0;
+
+	vStreamBufferDelete( x );
+	vMessageBufferDelete( m );
+	printf( "regions checked\n" );
+}
+
+static void *prvProducer( void *p )
+{
+	unsigned long n = 0; unsigned seed = 1; void *pv; size_t x, i, k;
+	while( n < ulTotal )
+	{
+		int isr = ( rand_r( &seed ) & 3 ) == 0;
+		x = isr ? xStreamBufferSendAcquireFromISR( xSB, &pv ) : xStreamBufferSendAcquire( xSB, &pv, 10 );
+		if( x == 0 ) continue;
+		k = 1 + rand_r( &seed ) % x; if( k > ulTotal - n ) k = ulTotal - n;
+		for( i = 0; i < k; i++ ) ( ( uint8_t * ) pv )[ i ] = prvByte( n + i );
+		if( isr ) { BaseType_t w = pdFALSE; vStreamBufferSendCommitFromISR( xSB, k, &w ); ulFromIsr++; } else vStreamBufferSendCommit( xSB, k );
+		n += k;
+	}
+	return NULL;
+}
+int main( int argc, char **argv )
+{
+	pthread_t t; unsigned long n = 0; unsigned seed = 2; void *pv; size_t x, i, k; uint8_t cp[ 100 ];
+	if( argc > 1 ) ulTotal = strtoul( argv[ 1 ], NULL, 0 );
+	prvRegions();
+	xSB = xStreamBufferCreate( 257, 16 );
+	pthread_create( &t, NULL, prvProducer, NULL );
+	while( n < ulTotal )
+	{
+		int mode = rand_r( &seed ) % 5;
+		if( mode == 0 )
+		{
+			/* Mixed with the copying API. */
+			x = xStreamBufferReceive( xSB, cp, 1 + rand_r( &seed ) % sizeof cp, 10 );
+			for( i = 0; i < x; i++, n++ ) CHECK( cp[ i ] == prvByte( n ) );
+			continue;
+		}
+		x = mode == 1 ? xStreamBufferReceiveAcquireFromISR( xSB, &pv ) : xStreamBufferReceiveAcquire( xSB, &pv, 10 );
+		if( x == 0 ) continue;
+		k = 1 + rand_r( &seed ) % x;
+		for( i = 0; i < k; i++ ) CHECK( ( ( uint8_t * ) pv )[ i ] == prvByte( n + i ) );
+		if( mode == 1 ) { BaseType_t w = pdFALSE; vStreamBufferReceiveReleaseFromISR( xSB, k, &w ); } else vStreamBufferReceiveRelease( xSB, k );
+		n += k;
+	}
+	pthread_join( t, NULL );
+	CHECK( xStreamBufferIsEmpty( xSB ) == pdTRUE && iSimAsserts == 0 );
+	printf( "%lu bytes checked, %lu waits, %lu FromISR commits\n", n, ulSimBlocks, ulFromIsr );
+	return 0;
+}
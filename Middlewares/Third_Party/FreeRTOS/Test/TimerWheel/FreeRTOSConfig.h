@@ -0,0 +1,26 @@
+/* Host stub configuration of the timer daemon model */
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+#include <assert.h>
+#define configUSE_PREEMPTION 1
+#define configUSE_IDLE_HOOK 0
+#define configUSE_TICK_HOOK 0
+#define configTICK_RATE_HZ 1000
+#define configCPU_CLOCK_HZ 1000000
+#define configMAX_PRIORITIES 6
+#define configMINIMAL_STACK_SIZE 64
+#ifndef configUSE_16_BIT_TICKS
+#define configUSE_16_BIT_TICKS 0
+#endif
+#define configSUPPORT_DYNAMIC_ALLOCATION 1
+#define configMAX_TASK_NAME_LEN 16
+#define configUSE_TIMERS 1
+#define configTIMER_TASK_PRIORITY 5
+#define configTIMER_QUEUE_LENGTH 60000
+#define configTIMER_TASK_STACK_DEPTH 256
+#define INCLUDE_xTimerPendFunctionCall 1
+#ifndef configUSE_TIMER_WHEEL
+#define configUSE_TIMER_WHEEL 0
+#endif
+#define configASSERT( x ) assert( x )
+#endif
@@ -0,0 +1,64 @@
+#!/bin/sh
+# Builds the timer daemon model (timer_wheel_model.c) against timers.c on the
+# host, with the sorted lists and with the timer wheel, and checks that both
+# give the same callbacks at the same ticks and the same final timer states:
+# - 50 and 300 timers, from tick 0, near 0x7FFFFFFF and before the wrap;
+# - every configTIMER_WHEEL_SLOT_BITS, and 16-bit ticks;
+# - a daemon starved for up to 200 ticks, where only the final states are
+#   compared, as timers sharing an expiry tick are then called back in
+#   a different number.
+# It then prints the daemon time per tick of both backends.
+# build.sh [output directory]
+HERE=$(cd "$(dirname "$0")" && pwd)
+SRC=$HERE/../../Source
+OUT=${1:-${TMPDIR:-/tmp}/timer_wheel_test}
+CC=${CC:-cc}
+mkdir -p "$OUT" || exit 1
+
+# build <name> [defines]
+build()
+{
+  N=$1; shift
+  $CC -O2 -Wall -Wno-unused-parameter -I"$HERE" -I"$SRC/include" -I"$SRC" \
+    "$@" -o "$OUT/$N" "$HERE/timer_wheel_model.c" "$SRC/list.c" || exit 1
+}
+
+# check <list model> <wheel model> <filter> <arguments>
+check()
+{
+  L=$1; W=$2; F=$3; shift 3
+  "$OUT/$L" 0 "$@" | grep "$F" | sort > "$OUT/list.txt" || exit 1
+  "$OUT/$W" 0 "$@" | grep "$F" | sort > "$OUT/wheel.txt" || exit 1
+  if ! cmp -s "$OUT/list.txt" "$OUT/wheel.txt"; then
+    echo "FAIL: $W $*"
+    exit 1
+  fi
+  echo "$W $*: $(grep -c '^end' "$OUT/list.txt") timers and" \
+    "$(grep -vc '^end' "$OUT/list.txt") callbacks compared, same"
+}
+
+build list -DconfigUSE_TIMER_WHEEL=0
+for B in 1 2 3 4 5; do
+  build wheel$B -DconfigUSE_TIMER_WHEEL=1 -DconfigTIMER_WHEEL_SLOT_BITS=$B
+done
+build list16 -DconfigUSE_TIMER_WHEEL=0 -DconfigUSE_16_BIT_TICKS=1
+build wheel16 -DconfigUSE_TIMER_WHEEL=1 -DconfigUSE_16_BIT_TICKS=1
+
+for B in 1 2 3 4 5; do
+  for START in 0 0x7FFFF000 0xFFFFF000; do
+    check list wheel$B . 50 100000 $B $START
+    check list wheel$B . 300 30000 $B $START
+  done
+done
+for START in 0 0x7F00 0xF000; do
+  check list16 wheel16 . 50 100000 1 $START
+  check list16 wheel16 . 300 30000 2 $START
+done
+for SEED in 1 2 3; do
+  check list wheel3 '^end' 200 30000 $SEED 0xFFFFF000 200
+  check list16 wheel16 '^end' 200 30000 $SEED 0xF000 200
+done
+
+for N in 10 100 500 1000 5000; do
+  "$OUT/list" 1 $N 20000 && "$OUT/wheel3" 1 $N 20000 || exit 1
+done
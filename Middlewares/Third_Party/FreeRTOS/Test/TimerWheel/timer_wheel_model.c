@@ -0,0 +1,122 @@
+/* Drives timers.c directly: stubbed queue and scheduler, simulated tick.
+ * timer_wheel_model 0 <timers> <ticks> [seed] [start tick] [starvation]
+ *   prints each callback as "<tick> <timer>", then the final timer states,
+ *   to be compared between configUSE_TIMER_WHEEL 0 and 1;
+ * timer_wheel_model 1 <timers> <ticks>
+ *   prints the daemon time per tick. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "timers.h"
+
+static TickType_t xTick;
+static uint8_t *pQ; static size_t qsz, qhead, qcount, qcap;
+void vPortEnterCritical( void ) {} void vPortExitCritical( void ) {} void vPortYield( void ) {}
+volatile int xSimYieldFromISR;
+void *pvPortMalloc( size_t x ) { return malloc( x ); }
+void vPortFree( void *p ) { free( p ); }
+TickType_t xTaskGetTickCount( void ) { return xTick; }
+void vTaskSuspendAll( void ) {}
+BaseType_t xTaskResumeAll( void ) { return pdTRUE; }
+BaseType_t xTaskGetSchedulerState( void ) { return taskSCHEDULER_RUNNING; }
+BaseType_t xTaskCreate( TaskFunction_t f, const char * const n, const configSTACK_DEPTH_TYPE d, void * const p, UBaseType_t u, TaskHandle_t * const h ) { return pdPASS; }
+void vQueueWaitForMessageRestricted( QueueHandle_t q, TickType_t t, const BaseType_t b ) { (void)q; (void)t; (void)b; }
+QueueHandle_t xQueueGenericCreate( const UBaseType_t n, const UBaseType_t sz, const uint8_t t ) { (void)t; qcap = n; qsz = sz; pQ = malloc( n * sz ); return ( QueueHandle_t ) pQ; }
+BaseType_t xQueueGenericSend( QueueHandle_t q, const void * const p, TickType_t w, const BaseType_t pos ) { (void)q;(void)w;(void)pos; assert( qcount < qcap ); memcpy( pQ + ( ( qhead + qcount ) % qcap ) * qsz, p, qsz ); qcount++; return pdPASS; }
+BaseType_t xQueueGenericSendFromISR( QueueHandle_t q, const void * const p, BaseType_t * const w, const BaseType_t pos ) { (void)w; return xQueueGenericSend( q, p, 0, pos ); }
+BaseType_t xQueueReceive( QueueHandle_t q, void * const p, TickType_t w ) { (void)q;(void)w; if( !qcount ) return pdFAIL; memcpy( p, pQ + qhead * qsz, qsz ); qhead = ( qhead + 1 ) % qcap; qcount--; return pdPASS; }
+
+#include "timers.c"
+
+/* One pass of the daemon loop, repeated until nothing is left to do now. */
+static void prvDaemonRun( void )
+{
+TickType_t xNext; BaseType_t xEmpty;
+	for( int i = 0; i < 100000; i++ )
+	{
+		xNext = prvGetNextExpireTime( &xEmpty );
+		if( qcount == 0 && ( xEmpty || !tmrEXPIRE_TIME_REACHED( xNext, xTick ) ) )
+		{
+#if configUSE_TIMER_WHEEL == 0
+			/* Let the list backend see a tick overflow even when idle. */
+			BaseType_t sw; ( void ) prvSampleTimeNow( &sw ); if( sw ) continue;
+#endif
+			return;
+		}
+		prvProcessTimerOrBlockTask( xNext, xEmpty );
+		prvProcessReceivedCommands();
+	}
+	abort();
+}
+
+static unsigned long long ulCallbacks;
+static FILE *pxLog;
+static void prvCallback( TimerHandle_t x )
+{
+	uintptr_t id = ( uintptr_t ) pvTimerGetTimerID( x );
+	ulCallbacks++;
+	if( pxLog ) fprintf( pxLog, "%u %lu\n", ( unsigned ) xTick, ( unsigned long ) id );
+}
+
+static uint64_t s = 88172645463325252ULL;
+static uint32_t rnd( void ) { s ^= s << 13; s ^= s >> 7; s ^= s << 17; return ( uint32_t ) s; }
+
+/* Periods stay within half of the tick range, also with 16-bit ticks */
+static TickType_t prvPeriod( uint32_t x ) { return ( TickType_t ) ( 1 + ( x - 1 ) % ( portMAX_DELAY >> 1 ) ); }
+
+int main( int argc, char **argv )
+{
+	if( argc < 4 ) return 2;
+	int mode = atoi( argv[ 1 ] );         /* 0: verify, 1: bench */
+	int n = atoi( argv[ 2 ] );            /* timers */
+	long steps = atol( argv[ 3 ] );
+	s += argc > 4 ? atoi( argv[ 4 ] ) : 0;
+	xTick = argc > 5 ? ( TickType_t ) strtoul( argv[ 5 ] , 0, 0 ) : 0;
+	int delay = argc > 6 ? atoi( argv[ 6 ] ) : 0;
+	TimerHandle_t *t = malloc( n * sizeof *t );
+	if( mode == 0 ) pxLog = stdout;
+	prvCheckForValidListAndQueue();
+	for( int i = 0; i < n; i++ )
+	{
+		TickType_t p = prvPeriod( 1 + rnd() % ( mode ? 1000 : ( ( rnd() & 7 ) ? 50 : ( ( rnd() & 1 ) ? 5000 : 40000 ) ) ) );
+		t[ i ] = xTimerCreate( "t", p, ( rnd() & 1 ), ( void * ) ( uintptr_t ) i, prvCallback );
+		xTimerStart( t[ i ], 0 );
+	}
+	prvDaemonRun();
+	double cpu = 0; unsigned long long ops = 0;
+	for( long k = 0; k < steps; k++ )
+	{
+		/* Application activity: a few timer commands per tick. */
+		int c = rnd() % 4;
+		for( int j = 0; j < c; j++ )
+		{
+			TimerHandle_t x = t[ rnd() % n ];
+			switch( rnd() % 8 )
+			{
+				case 0: xTimerStop( x, 0 ); break;
+				case 1: xTimerChangePeriod( x, prvPeriod( 1 + rnd() % ( mode ? 1000 : ( ( rnd() & 3 ) ? 300 : 70000 ) ) ), 0 ); break;
+				default: xTimerReset( x, 0 ); break;
+			}
+			ops++;
+		}
+		struct timespec a, b;
+		clock_gettime( CLOCK_MONOTONIC, &a );
+		if( !delay ) prvDaemonRun();
+		clock_gettime( CLOCK_MONOTONIC, &b );
+		cpu += ( b.tv_sec - a.tv_sec ) * 1e9 + ( b.tv_nsec - a.tv_nsec );
+		xTick++;
+		if( delay && ( rnd() % 16 ) == 0 ) { xTick += rnd() % delay; }
+		clock_gettime( CLOCK_MONOTONIC, &a );
+		prvDaemonRun();
+		clock_gettime( CLOCK_MONOTONIC, &b );
+		cpu += ( b.tv_sec - a.tv_sec ) * 1e9 + ( b.tv_nsec - a.tv_nsec );
+	}
+	for( int i = 0; i < n; i++ )
+		if( mode == 0 ) printf( "end %d %ld %u\n", i, xTimerIsTimerActive( t[ i ] ), xTimerIsTimerActive( t[ i ] ) ? ( unsigned ) xTimerGetExpiryTime( t[ i ] ) : 0u );
+	if( mode == 1 ) fprintf( stderr, "n=%d ops=%llu cb=%llu daemon ns/tick=%.0f\n", n, ops, ulCallbacks, cpu / steps );
+	return 0;
+}
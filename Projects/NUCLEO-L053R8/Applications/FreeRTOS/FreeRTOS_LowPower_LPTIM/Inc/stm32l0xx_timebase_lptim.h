@@ -32,6 +32,11 @@
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 void InitTick (uint32_t TickPriority);
+uint32_t TimeBase_ReadTime (void);
+uint32_t TimeBase_TickTime (uint32_t Ticks);
+uint32_t TimeBase_TicksElapsed (uint32_t Time);
+void TimeBase_StepTick (uint32_t Ticks);
+uint32_t TimeBase_SetWakeUp (uint32_t Time);
 void LPTIM1_IRQHandler(void);
   
 #ifdef __cplusplus
@@ -39,7 +39,10 @@
 #include "stm32l0xx_hal.h"
 #include "stm32l0xx_timebase_lptim.h"
 
-#define portMAX_16_BIT_NUMBER				( 0xffffUL )
+/* The tick is suppressed for at most a quarter of the range of the 32 bit
+extended LPTIM counter, about 9 hours with the LSE, so that counter values can
+be compared with signed arithmetic. */
+#define portMAX_SUPPRESSED_TICKS			( ( 0x40000000UL / LSE_VALUE ) * configTICK_RATE_HZ )
 
 extern LPTIM_HandleTypeDef             LptimHandle;
 
@@ -55,19 +58,6 @@ void vPortSetupTimerInterrupt( void );
  */
 void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
 
-
-/*-----------------------------------------------------------*/
-
-/* Calculate how many clock increments make up a single tick period. */
-static const uint32_t ulReloadValueForOneTick = ( LSE_VALUE / configTICK_RATE_HZ);
-
-/* Will hold the maximum number of ticks that can be suppressed. */
-static uint32_t xMaximumPossibleSuppressedTicks = 0;
-
-/* Flag set from the tick interrupt to allow the sleep processing to know if
-sleep mode was exited because of a timer interrupt or a different interrupt. */
-volatile uint32_t ulTickFlag = pdFALSE;
-
 #endif
 
 
@@ -76,13 +66,6 @@ volatile uint32_t ulTickFlag = pdFALSE;
 void vPortSetupTimerInterrupt( void )
 {
   InitTick(configLIBRARY_LOWEST_INTERRUPT_PRIORITY);
-	
-#if( configUSE_TICKLESS_IDLE == 2 )
-
-	/* The maximum number of ticks that can be suppressed depends on the clock
-	frequency. */
-	xMaximumPossibleSuppressedTicks = portMAX_16_BIT_NUMBER / ulReloadValueForOneTick;
-#endif	/* ( configUSE_TICKLESS_IDLE == 2 ) */
 }
 
 
@@ -92,96 +75,93 @@ void vPortSetupTimerInterrupt( void )
 
 void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
 {
-  uint32_t ulReloadValue, ulCompleteTickPeriods, ulCount;
+  uint32_t ulWakeTime, ulCompleteTickPeriods;
   eSleepModeStatus eSleepAction;
 
 	/* THIS FUNCTION IS CALLED WITH THE SCHEDULER SUSPENDED. */
 
-	/* Make sure the LPTIM reload value does not overflow the counter. */
-	if( xExpectedIdleTime > xMaximumPossibleSuppressedTicks )
+	if( xExpectedIdleTime > portMAX_SUPPRESSED_TICKS )
 	{
-		xExpectedIdleTime = xMaximumPossibleSuppressedTicks;
+		xExpectedIdleTime = portMAX_SUPPRESSED_TICKS;
 	}
 
-	/* Calculate the reload value required to wait xExpectedIdleTime tick
-	periods. */
-	ulReloadValue = HAL_LPTIM_ReadCounter(&LptimHandle) + (ulReloadValueForOneTick * (xExpectedIdleTime - 1UL));
-	
-	ulCount = HAL_LPTIM_ReadCounter(&LptimHandle);
-	
-	HAL_LPTIM_PWM_Stop_IT(&LptimHandle);
-
 	/* Enter a critical section but don't use the taskENTER_CRITICAL() method as
 	that will mask interrupts that should exit sleep mode. */
 	__asm volatile ( "cpsid i" );
 	__asm volatile( "dsb" );
 	__asm volatile( "isb" );
 
-	/* The tick flag is set to false before sleeping.  If it is true when sleep
-	mode is exited then sleep mode was probably exited because the tick was
-	suppressed for the entire xExpectedIdleTime period. */
-	ulTickFlag = pdFALSE;
-
 	/* If a context switch is pending then abandon the low power entry as the
 	context switch might have been pended by an external interrupt that	requires
-	processing. */
+	processing.  The LPTIM keeps running, so the current tick is not
+	disturbed. */
 	eSleepAction = eTaskConfirmSleepModeStatus();
 	if( eSleepAction == eAbortSleep )
 	{
-		/* Restart tick and continue counting to complete the current time
-		slice. */
-		HAL_LPTIM_PWM_Start_IT(&LptimHandle, ulCount-1, (ulCount/2));
 		/* Re-enable interrupts  */
 		__asm volatile ( "cpsie i" );
 	}
 	else
-	{		
-		HAL_LPTIM_TimeOut_Start_IT(&LptimHandle, 0xFFFF, ulReloadValue);
-		
-		/* A user definable macro that allows application code to be inserted
-		here.  Such application code can be used to minimise power consumption
-		further by turning off IO, peripheral clocks, the Flash, etc. */
-		configPRE_STOP_PROCESSING();
-
-		/* There are no running state tasks and no tasks that are blocked with a
-		time out.  Assuming the application does not care if the tick time slips
-		with respect to calendar time then enter a deep sleep that can only be
-		woken by (in this demo case) the user button being pushed on the
-		STM32L discovery board.  If the application does require the tick time
-		to keep better track of the calender time then the LPTIM peripheral can be
-		used to make rough adjustments. */
-		HAL_PWR_EnterSTOPMode( PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI );
-
-		/* A user definable macro that allows application code to be inserted
-		here.  Such application code can be used to reverse any actions taken
-		by the configPRE_STOP_PROCESSING().  In this demo
-		configPOST_STOP_PROCESSING() is used to re-initialise the clocks that
-		were turned off when STOP mode was entered. */
-		configPOST_STOP_PROCESSING();
-		
-		ulCount = HAL_LPTIM_ReadCounter(&LptimHandle);
-
-		HAL_LPTIM_PWM_Stop_IT(&LptimHandle);
-
-		/* Re-enable interrupts */
-    __asm volatile ( "cpsie i" );
-		if( ulTickFlag != pdFALSE )
+	{
+		/* The LPTIM counter never stops or restarts, so the time at which the
+		kernel expects to run again is known exactly, whatever the phase of the
+		current tick. */
+		ulWakeTime = TimeBase_TickTime( xExpectedIdleTime );
+
+		/* Compare matches that occur before the wake up time are the
+		intermediate ones needed to keep track of the counter.  They are
+		cleared and STOP mode is entered again.  Any other interrupt ends the
+		low power period. */
+		while( TimeBase_SetWakeUp( ulWakeTime ) == 0U )
 		{
-			ulCompleteTickPeriods = xExpectedIdleTime - 1UL;
-			
-			HAL_LPTIM_PWM_Start_IT(&LptimHandle, ulReloadValueForOneTick -1UL, ulReloadValueForOneTick/2);
+			/* A user definable macro that allows application code to be inserted
+			here.  Such application code can be used to minimise power consumption
+			further by turning off IO, peripheral clocks, the Flash, etc. */
+			configPRE_STOP_PROCESSING();
+
+			/* Interrupts are masked, so an interrupt exits STOP mode without
+			being serviced until they are enabled again below. */
+			HAL_PWR_EnterSTOPMode( PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI );
+
+			/* A user definable macro that allows application code to be inserted
+			here.  Such application code can be used to reverse any actions taken
+			by the configPRE_STOP_PROCESSING().  In this demo
+			configPOST_STOP_PROCESSING() is used to re-initialise the clocks that
+			were turned off when STOP mode was entered. */
+			configPOST_STOP_PROCESSING();
+
+			if( __HAL_LPTIM_GET_FLAG( &LptimHandle, LPTIM_FLAG_CMPM ) == RESET )
+			{
+				break;
+			}
+			__HAL_LPTIM_CLEAR_FLAG( &LptimHandle, LPTIM_FLAG_CMPM );
+			HAL_NVIC_ClearPendingIRQ( LPTIM1_IRQn );
 		}
-		else
+
+		/* Count the ticks that passed while the MCU was in STOP mode.  The
+		tick at the end of the expected idle time is left to the tick
+		interrupt, as the kernel requires, along with any tick that is already
+		due after it. */
+		ulCompleteTickPeriods = TimeBase_TicksElapsed( TimeBase_ReadTime() );
+		if( ulCompleteTickPeriods >= xExpectedIdleTime )
 		{
-			ulCompleteTickPeriods = ulCount/ ulReloadValueForOneTick;
-			ulReloadValue = (ulReloadValueForOneTick - ( ulCompleteTickPeriods % ulReloadValueForOneTick ));
-			
-			HAL_LPTIM_PWM_Start_IT(&LptimHandle, ulReloadValue - 1, ulReloadValue/2);				
+			ulCompleteTickPeriods = xExpectedIdleTime - 1UL;
 		}
-			
+		TimeBase_StepTick( ulCompleteTickPeriods );
+
 		/* Wind the tick forward by the number of tick periods that the CPU
 		remained in a low power state. */
 		vTaskStepTick( ulCompleteTickPeriods );
+
+		/* Restart the tick interrupt, and have it run as soon as interrupts
+		are enabled if the next tick is already due. */
+		if( TimeBase_SetWakeUp( TimeBase_TickTime( 1UL ) ) != 0U )
+		{
+			HAL_NVIC_SetPendingIRQ( LPTIM1_IRQn );
+		}
+
+		/* Re-enable interrupts */
+		__asm volatile ( "cpsie i" );
 	}
 }
 #endif /* ( configUSE_TICKLESS_IDLE == 2 ) */
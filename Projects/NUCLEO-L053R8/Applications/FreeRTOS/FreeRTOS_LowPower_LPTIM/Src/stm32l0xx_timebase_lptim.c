@@ -24,11 +24,23 @@
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
 
-/* Set the Maximum value of the counter (Auto-Reload) that defines the Period */
-#define PeriodValue             (uint32_t) (32 - 1)
+/* The LPTIM counts the LSE without prescaler and runs freely from 0 to
+   LPTIM_ARR_VALUE. The tick periods are not a whole number of counts
+   (32.768 counts for a 1 kHz tick), so tick n is placed at count
+   floor(n * LPTIM_CLOCK_HZ / TICK_RATE_HZ) and never drifts from the LSE */
+#define LPTIM_CLOCK_HZ          LSE_VALUE
+#define TICK_RATE_HZ            configTICK_RATE_HZ
+#define LPTIM_ARR_VALUE         0xFFFFU
 
-/* Set the Compare value that defines the duty cycle */
-#define PulseValue              (uint32_t) (15 - 1)
+/* Whole counts and remainder of one tick period */
+#define TICK_COUNTS             (LPTIM_CLOCK_HZ / TICK_RATE_HZ)
+#define TICK_FRACTION           (LPTIM_CLOCK_HZ % TICK_RATE_HZ)
+
+/* A compare value closer than LPTIM_MIN_DELTA counts may be passed before the
+   write reaches the LPTIM clock domain, and the counter is read at least every
+   LPTIM_MAX_DELTA counts so that its 16 bit value can be extended */
+#define LPTIM_MIN_DELTA         5U
+#define LPTIM_MAX_DELTA         0xC000U
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
@@ -40,11 +52,21 @@ __IO uint32_t ulTickInit = 0;
 /* Clocks structure declaration */
 RCC_PeriphCLKInitTypeDef        RCC_PeriphCLKInitStruct;
 
-#if( configUSE_TICKLESS_IDLE == 2 )
-extern uint32_t ulTickFlag;
-#endif
+/* Counter extended to 32 bits at the last read */
+static uint32_t LptimTime = 0;
+
+/* Set while a compare write has not reached the LPTIM clock domain yet */
+static uint32_t LptimCompareBusy = 0;
+
+/* Counter value of the last tick counted, and remainder of its position in
+   1/TICK_RATE_HZ counts */
+static uint32_t TickTime = 0;
+static uint32_t TickFraction = 0;
 
 /* Private function prototypes -----------------------------------------------*/
+static uint32_t TimeBase_NextTickTime(void);
+static void TimeBase_CountTick(void);
+
 /* Private functions ---------------------------------------------------------*/
 
 /**
@@ -99,16 +121,30 @@ void InitTick (uint32_t TickPriority)
 	
 	    HAL_NVIC_SetPriority(LPTIM1_IRQn, TickPriority, 0U);
       HAL_NVIC_EnableIRQ(LPTIM1_IRQn);
-  /* ### - 3 - Start generating the PWM signal ############################## */
+  /* ### - 3 - Start the free running counter ############################### */
   /*
-   *  Period = 99
-   *  Pulse  = 49
-   *  According to this configuration, the duty cycle will be equal to 50%
+   *  Period  = LPTIM_ARR_VALUE, the counter is never reloaded by software
+   *  Compare = first tick, moved forward by one tick period in the compare
+   *            match interrupt, or by several when the tick is suppressed
+   *  The interrupt enable register can only be written while the LPTIM is
+   *  disabled, and the auto-reload and compare registers while it is enabled
    */
-  if (HAL_LPTIM_PWM_Start_IT(&LptimHandle, PeriodValue, PulseValue) != HAL_OK)
+  __HAL_LPTIM_ENABLE_IT(&LptimHandle, LPTIM_IT_CMPM);
+  __HAL_LPTIM_WAKEUPTIMER_EXTI_ENABLE_IT();
+  __HAL_LPTIM_ENABLE(&LptimHandle);
+
+  __HAL_LPTIM_AUTORELOAD_SET(&LptimHandle, LPTIM_ARR_VALUE);
+  while (__HAL_LPTIM_GET_FLAG(&LptimHandle, LPTIM_FLAG_ARROK) == RESET)
   {
-    while(1);
-  }	
+  }
+  __HAL_LPTIM_CLEAR_FLAG(&LptimHandle, LPTIM_FLAG_ARROK);
+
+  LptimTime = 0;
+  TickTime = 0;
+  TickFraction = 0;
+  LptimCompareBusy = 0;
+  __HAL_LPTIM_START_CONTINUOUS(&LptimHandle);
+  (void)TimeBase_SetWakeUp(TimeBase_NextTickTime());
 	
 	ulTickInit = 1;
 }
@@ -128,39 +164,189 @@ HAL_StatusTypeDef HAL_InitTick (uint32_t TickPriority)
 	return HAL_OK;
 }
 
+/**
+  * @brief  Read the LPTIM counter and extend it to 32 bits. Must be called with
+  *         the LPTIM interrupt masked, and at least every LPTIM_MAX_DELTA
+  *         counts, which the compare programmed by TimeBase_SetWakeUp()
+  *         guarantees.
+  * @param  None
+  * @retval Counter value, in LSE periods
+  */
+uint32_t TimeBase_ReadTime (void)
+{
+  uint32_t count;
+  uint32_t last;
+
+  /* The counter is clocked asynchronously to the APB, so it is only valid
+     when two consecutive reads return the same value */
+  count = HAL_LPTIM_ReadCounter(&LptimHandle);
+  do
+  {
+    last = count;
+    count = HAL_LPTIM_ReadCounter(&LptimHandle);
+  } while (count != last);
+
+  LptimTime += (count - LptimTime) & LPTIM_ARR_VALUE;
+
+  return LptimTime;
+}
+
+/**
+  * @brief  Get the counter value at which a tick will be due
+  * @param  Ticks: number of ticks after the last one counted, at least 1
+  * @retval Counter value
+  */
+uint32_t TimeBase_TickTime (uint32_t Ticks)
+{
+  uint64_t counts;
+
+  counts = ((uint64_t)Ticks * LPTIM_CLOCK_HZ) + TickFraction;
+
+  return TickTime + (uint32_t)(counts / TICK_RATE_HZ);
+}
 
-void HAL_LPTIM_CompareMatchCallback(LPTIM_HandleTypeDef *hlptim)
+/**
+  * @brief  Get the number of ticks that are due at a counter value but have
+  *         not been counted yet
+  * @param  Time: counter value returned by TimeBase_ReadTime()
+  * @retval Number of ticks
+  */
+uint32_t TimeBase_TicksElapsed (uint32_t Time)
 {
-  if ( HAL_LPTIM_ReadAutoReload(hlptim) != PeriodValue)
+  uint64_t counts;
+
+  if ((int32_t)(Time - TickTime) < 0)
   {
-	  HAL_LPTIM_PWM_Start_IT(&LptimHandle, PeriodValue, PulseValue);
-  } 
-	 
-	HAL_IncTick();
-	osSystickHandler();
-
-#if( configUSE_TICKLESS_IDLE == 2 )
-  ulTickFlag = pdTRUE;
-#endif
+    return 0U;
+  }
+
+  /* Tick j is due when TickTime + (j * LPTIM_CLOCK_HZ + TickFraction) /
+     TICK_RATE_HZ <= Time, that is when j * LPTIM_CLOCK_HZ <
+     (Time - TickTime + 1) * TICK_RATE_HZ - TickFraction */
+  counts = ((uint64_t)(Time - TickTime) + 1U) * TICK_RATE_HZ;
+  counts -= (uint64_t)TickFraction + 1U;
+
+  return (uint32_t)(counts / LPTIM_CLOCK_HZ);
+}
+
+/**
+  * @brief  Count ticks that passed while the tick interrupt was suppressed.
+  *         The caller steps the RTOS tick by the same number.
+  * @param  Ticks: number of ticks, at most TimeBase_TicksElapsed()
+  * @retval None
+  */
+void TimeBase_StepTick (uint32_t Ticks)
+{
+  uint64_t counts;
+
+  counts = ((uint64_t)Ticks * LPTIM_CLOCK_HZ) + TickFraction;
+  TickTime += (uint32_t)(counts / TICK_RATE_HZ);
+  TickFraction = (uint32_t)(counts % TICK_RATE_HZ);
+
+  uwTick += Ticks * (uint32_t)uwTickFreq;
+}
+
+/**
+  * @brief  Program the compare match interrupt. A time further than
+  *         LPTIM_MAX_DELTA counts is reached through intermediate matches,
+  *         and the compare register is never set to the auto-reload value,
+  *         which would not match.
+  * @param  Time: counter value at which to interrupt
+  * @retval 0 if the interrupt is programmed, 1 if Time is already reached or
+  *         too close to be programmed
+  */
+uint32_t TimeBase_SetWakeUp (uint32_t Time)
+{
+  uint32_t now;
+  uint32_t delta;
+
+  /* A new value can only be written once the previous one is taken into
+     account. Writes are normally at least a tick apart, so this hardly ever
+     waits, and it is done before the counter is read so that the margin
+     checked below is not used up by the wait */
+  if (LptimCompareBusy != 0U)
+  {
+    while (__HAL_LPTIM_GET_FLAG(&LptimHandle, LPTIM_FLAG_CMPOK) == RESET)
+    {
+    }
+    __HAL_LPTIM_CLEAR_FLAG(&LptimHandle, LPTIM_FLAG_CMPOK);
+    LptimCompareBusy = 0U;
+  }
+
+  now = TimeBase_ReadTime();
+  delta = Time - now;
+  if (((int32_t)delta > 0) && (delta > LPTIM_MAX_DELTA))
+  {
+    Time = now + LPTIM_MAX_DELTA;
+  }
+  if ((Time & LPTIM_ARR_VALUE) == LPTIM_ARR_VALUE)
+  {
+    Time--;
+  }
+  if ((int32_t)(Time - now) < (int32_t)LPTIM_MIN_DELTA)
+  {
+    return 1U;
+  }
+
+  __HAL_LPTIM_COMPARE_SET(&LptimHandle, Time & LPTIM_ARR_VALUE);
+  LptimCompareBusy = 1U;
+
+  return 0U;
+}
+
+/**
+  * @brief  Get the counter value of the next tick
+  * @param  None
+  * @retval Counter value
+  */
+static uint32_t TimeBase_NextTickTime (void)
+{
+  return TickTime + TICK_COUNTS + (((TickFraction + TICK_FRACTION) >= TICK_RATE_HZ) ? 1U : 0U);
+}
+
+/**
+  * @brief  Count one tick from the tick interrupt
+  * @param  None
+  * @retval None
+  */
+static void TimeBase_CountTick (void)
+{
+  TickTime += TICK_COUNTS;
+  TickFraction += TICK_FRACTION;
+  if (TickFraction >= TICK_RATE_HZ)
+  {
+    TickFraction -= TICK_RATE_HZ;
+    TickTime++;
+  }
+
+  HAL_IncTick();
+  osSystickHandler();
 }
 
 /**
   * @brief  This function handles  WAKE UP TIMER  interrupt request.
+  *         Each compare match counts the ticks that are due, which is more
+  *         than one after the tick was suppressed, and moves the compare to
+  *         the next tick. A tick that is too close to be programmed is
+  *         waited for, so that no tick is ever counted early.
   * @param  None
   * @retval None
   */
 void LPTIM1_IRQHandler(void)
 {
-  /* Compare match interrupt */
-  if(__HAL_LPTIM_GET_FLAG(&LptimHandle, LPTIM_FLAG_CMPM) != RESET)
+  uint32_t now;
+
+  /* Clear Compare match flag */
+  __HAL_LPTIM_CLEAR_FLAG(&LptimHandle, LPTIM_FLAG_CMPM);
+
+  do
   {
-      /* Clear Compare match flag */
-      __HAL_LPTIM_CLEAR_FLAG(&LptimHandle, LPTIM_FLAG_CMPM);
-      
-      /* Compare match Callback */
-      HAL_LPTIM_CompareMatchCallback(&LptimHandle);  
-  }
-	__HAL_LPTIM_CLEAR_FLAG(&LptimHandle, 0x1F);
+    now = TimeBase_ReadTime();
+    while ((int32_t)(now - TimeBase_NextTickTime()) >= 0)
+    {
+      TimeBase_CountTick();
+    }
+  } while (TimeBase_SetWakeUp(TimeBase_NextTickTime()) != 0U);
 }
 
 /**
@@ -0,0 +1,23 @@
+#!/bin/sh
+# Builds the LPTIM tick model (lptim_tick_model.c) with the application time
+# base and tickless idle on the host, and runs six seeds of 5 million
+# randomized sleep/wake cycles.
+# build.sh [output directory]
+HERE=$(cd "$(dirname "$0")" && pwd)
+APP=$HERE/..
+OUT=${1:-${TMPDIR:-/tmp}/lptim_tick_test}
+CC=${CC:-cc}
+mkdir -p "$OUT" || exit 1
+
+# The model takes the place of PRIMASK and of the barriers
+sed -e 's/__asm volatile *( *"cpsid i" *);/sim_cpsid();/' \
+    -e 's/__asm volatile *( *"cpsie i" *);/sim_cpsie();/' \
+    -e 's/__asm volatile *( *"[di]sb" *);//' \
+    "$APP/Src/low_power_tick_management_LPTIM.c" > "$OUT/low_power_tick_management_LPTIM.c" || exit 1
+
+$CC -O2 -Wall -Wextra -I"$HERE" -I"$OUT" -I"$APP/Inc" -I"$APP/Src" \
+  -o "$OUT/lptim_tick_model" "$HERE/lptim_tick_model.c" || exit 1
+
+for SEED in 1 3 5 7 9 11; do
+  "$OUT/lptim_tick_model" 5000000 $SEED || exit 1
+done
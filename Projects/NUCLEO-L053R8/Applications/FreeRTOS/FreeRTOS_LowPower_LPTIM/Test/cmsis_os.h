@@ -0,0 +1,21 @@
+/* Host stub of the kernel interface used by the LPTIM time base */
+#ifndef SIM_OS_H
+#define SIM_OS_H
+#include <stdint.h>
+typedef uint32_t TickType_t;
+typedef enum { eAbortSleep = 0, eStandardSleep, eNoTasksWaitingTimeout } eSleepModeStatus;
+#define configTICK_RATE_HZ 1000U
+#define configUSE_TICKLESS_IDLE 2
+#define configLIBRARY_LOWEST_INTERRUPT_PRIORITY 3
+#define pdTRUE 1
+#define pdFALSE 0
+void osSystickHandler(void);
+eSleepModeStatus eTaskConfirmSleepModeStatus(void);
+void vTaskStepTick(TickType_t n);
+void sim_pre_stop(void);
+void sim_post_stop(void);
+void sim_cpsid(void);
+void sim_cpsie(void);
+#define configPRE_STOP_PROCESSING sim_pre_stop
+#define configPOST_STOP_PROCESSING sim_post_stop
+#endif
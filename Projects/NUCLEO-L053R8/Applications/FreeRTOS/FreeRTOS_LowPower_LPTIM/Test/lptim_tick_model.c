@@ -0,0 +1,313 @@
+/* Randomized simulation of the LPTIM tick and tickless idle: the LPTIM, NVIC,
+   STOP mode and kernel tick are modelled, the time base and tickless code are
+   the application sources. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stm32l0xx_hal.h"
+#include "cmsis_os.h"
+
+__IO uint32_t uwTick;
+HAL_TickFreqTypeDef uwTickFreq = HAL_TICK_FREQ_1KHZ;
+
+#define LSE 32768ULL
+#define HZ 1000ULL
+#define CMP_LATENCY 3   /* LSE periods before a compare write is taken into account */
+
+static uint64_t rng = 88172645463325252ULL;
+static uint32_t rnd(void) { rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17; return (uint32_t)(rng >> 16); }
+static uint32_t rndr(uint32_t n) { return rnd() % n; }
+
+/* LPTIM model */
+static uint64_t T;                 /* LSE periods since reset */
+static uint64_t Tstart;
+static int started, enabled, ie_cmpm;
+static uint32_t cmp_eff = 0, cmp_new;
+static int cmp_pending;
+static uint64_t cmp_apply_at;
+static uint32_t flags;
+static int nvic_latch;
+static int primask;
+static int in_isr;
+static uint64_t last_read_T;
+
+/* Kernel model */
+static uint32_t xTickCount;
+static uint32_t xNextTaskUnblockTime;
+static uint64_t ext_irq_at;
+static int ext_pending;
+static int ext_fired;
+static uint64_t stop_entries, ext_irqs, isr_runs, reads, aborts, max_step;
+
+#define FAIL(...) do { fprintf(stderr, "FAIL at T=%llu: ", (unsigned long long)T); fprintf(stderr, __VA_ARGS__); fprintf(stderr, "\n"); exit(1); } while (0)
+
+static uint32_t cnt_at(uint64_t t) { return (uint32_t)((t - Tstart) & 0xFFFFU); }
+/* Tick n is due at counter value floor(n * LSE / HZ) */
+static uint64_t ticks_at(uint64_t t) { return (((t - Tstart) + 1) * HZ - 1) / LSE; }
+
+/* Next time after 'from' at which the counter takes the value 'v' */
+static uint64_t next_match(uint64_t from, uint32_t v)
+{
+  uint32_t c = cnt_at(from);
+  uint64_t d = (uint64_t)((v - c) & 0xFFFFU);
+  if (d == 0) d = 0x10000;
+  return from + d;
+}
+
+static void run_to(uint64_t target)
+{
+  while (T < target)
+  {
+    uint64_t next = target;
+    if (cmp_pending && cmp_apply_at < next) next = cmp_apply_at;
+    if (started)
+    {
+      uint64_t m = next_match(T, cmp_eff);
+      if (m <= next)
+      {
+        T = m;
+        flags |= LPTIM_FLAG_CMPM;
+        if (cmp_pending && T == cmp_apply_at) { cmp_eff = cmp_new; cmp_pending = 0; flags |= LPTIM_FLAG_CMPOK; }
+        continue;
+      }
+    }
+    T = next;
+    if (cmp_pending && T == cmp_apply_at) { cmp_eff = cmp_new; cmp_pending = 0; flags |= LPTIM_FLAG_CMPOK; }
+  }
+  if (!ext_pending && T >= ext_irq_at) { ext_pending = 1; ext_fired = 1; ext_irqs++; }
+}
+
+static void advance(uint32_t n) { run_to(T + n); }
+
+static int lptim_pending(void) { return nvic_latch || ((flags & LPTIM_FLAG_CMPM) && ie_cmpm); }
+
+static void schedule_ext(void)
+{
+  uint32_t r = rndr(100);
+  /* Mix of short and long distances to the next external interrupt */
+  if (r < 40) ext_irq_at = T + 1 + rndr(200);
+  else if (r < 80) ext_irq_at = T + 1 + rndr(40000);
+  else ext_irq_at = T + 1 + rndr(3000000);
+}
+
+static void check_never_early(void)
+{
+  if ((int32_t)(xTickCount - (uint32_t)ticks_at(T)) > 0)
+    FAIL("tick early: %u > %llu", xTickCount, (unsigned long long)ticks_at(T));
+  if (uwTick != xTickCount)
+    FAIL("HAL tick %u != RTOS tick %u", (unsigned)uwTick, xTickCount);
+}
+
+/* The application sources, the tickless code with its PRIMASK accesses
+   mapped to the model by build.sh */
+#include "stm32l0xx_timebase_lptim.c"
+#include "low_power_tick_management_LPTIM.c"
+
+static void poll(void)
+{
+  while (!primask && !in_isr)
+  {
+    if (lptim_pending())
+    {
+      nvic_latch = 0;
+      in_isr = 1;
+      isr_runs++;
+      LPTIM1_IRQHandler();
+      in_isr = 0;
+      /* On exit every tick up to the last counter read is counted. A read on a
+         counter edge may return the previous value */
+      if ((xTickCount != (uint32_t)ticks_at(last_read_T)) && (xTickCount != (uint32_t)ticks_at(last_read_T - 1)))
+        FAIL("after ISR %u ticks, expected %llu; TickTime %u frac %u Lptim %u hw %u", xTickCount, (unsigned long long)ticks_at(last_read_T), TickTime, TickFraction, LptimTime, (uint32_t)(last_read_T - Tstart));
+      check_never_early();
+    }
+    else if (ext_pending)
+    {
+      ext_pending = 0;
+      advance(rndr(3));
+      /* Half of the external interrupts make a task ready */
+      if (rndr(2) == 0) xNextTaskUnblockTime = xTickCount;
+      schedule_ext();
+    }
+    else
+    {
+      break;
+    }
+  }
+}
+
+/* HAL */
+void HAL_IncTick(void) { uwTick += uwTickFreq; }
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *p) { (void)p; return HAL_OK; }
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *p) { (void)p; return HAL_OK; }
+HAL_StatusTypeDef HAL_LPTIM_Init(LPTIM_HandleTypeDef *h) { (void)h; return HAL_OK; }
+void HAL_NVIC_SetPriority(int irq, uint32_t p, uint32_t s) { (void)irq; (void)p; (void)s; }
+void HAL_NVIC_EnableIRQ(int irq) { (void)irq; }
+void HAL_NVIC_SetPendingIRQ(int irq) { (void)irq; nvic_latch = 1; }
+void HAL_NVIC_ClearPendingIRQ(int irq) { (void)irq; nvic_latch = 0; }
+
+uint32_t HAL_LPTIM_ReadCounter(LPTIM_HandleTypeDef *h)
+{
+  (void)h;
+  reads++;
+  /* Code execution time, and reads that catch the counter changing */
+  static int glitch;
+  uint32_t before = cnt_at(T);
+  if (rndr(4) == 0) advance(1);
+  if (last_read_T && T - last_read_T > 0xC100) FAIL("counter not read for %llu periods", (unsigned long long)(T - last_read_T));
+  last_read_T = T;
+  /* A read that coincides with a counter edge may return a mix of the old
+     and new bits, which cannot happen on two reads in a row */
+  if (!glitch && before != cnt_at(T) && rndr(2) == 0)
+  {
+    uint32_t mask = rnd();
+    glitch = 1;
+    return ((before & mask) | (cnt_at(T) & ~mask)) & 0xFFFFU;
+  }
+  glitch = 0;
+  return cnt_at(T);
+}
+
+uint32_t sim_get_flag(uint32_t f)
+{
+  /* Polling a flag takes time, so a busy wait makes progress */
+  advance(rndr(2));
+  return (flags & f) == f;
+}
+void sim_clear_flag(uint32_t f) { flags &= ~f; }
+void sim_enable_it(uint32_t it) { if (enabled) FAIL("IER written while enabled"); ie_cmpm = (it & LPTIM_IT_CMPM) != 0; }
+void sim_enable(void) { enabled = 1; }
+void sim_set_arr(uint32_t v) { if (!enabled || v != 0xFFFFU) FAIL("bad ARR write"); advance(2); flags |= LPTIM_FLAG_ARROK; }
+void sim_set_cmp(uint32_t v)
+{
+  if (!enabled) FAIL("CMP written while disabled");
+  if (cmp_pending) FAIL("CMP written before CMPOK");
+  if (v >= 0xFFFFU) FAIL("CMP %u not below ARR", v);
+  if (started)
+  {
+    /* The value must not already be passed when it is taken into account */
+    uint32_t d = (v - cnt_at(T)) & 0xFFFFU;
+    if (d <= CMP_LATENCY) FAIL("CMP %u too close to counter %u", v, cnt_at(T));
+  }
+  cmp_new = v;
+  cmp_pending = 1;
+  cmp_apply_at = T + 1 + rndr(CMP_LATENCY);
+}
+void sim_start(void) { started = 1; Tstart = T; }
+
+void HAL_PWR_EnterSTOPMode(uint32_t r, uint8_t e)
+{
+  (void)r; (void)e;
+  if (!primask) FAIL("STOP entered with interrupts enabled");
+  stop_entries++;
+  /* WFI returns at once when an interrupt is pending, even masked */
+  while (!lptim_pending() && !ext_pending)
+  {
+    uint64_t to = ext_irq_at;
+    uint64_t m = next_match(T, cmp_pending ? cmp_new : cmp_eff);
+    if (cmp_pending && cmp_apply_at > T) { if (cmp_apply_at < to) to = cmp_apply_at; }
+    else if (m < to) to = m;
+    if (to <= T) to = T + 1;
+    run_to(to);
+  }
+  /* Wake up time */
+  advance(1 + rndr(3));
+}
+
+/* Kernel */
+void osSystickHandler(void)
+{
+  if (!in_isr) FAIL("tick outside ISR");
+  xTickCount++;
+}
+eSleepModeStatus eTaskConfirmSleepModeStatus(void)
+{
+  if (ext_pending || xTickCount >= xNextTaskUnblockTime || rndr(50) == 0) { aborts++; return eAbortSleep; }
+  return eStandardSleep;
+}
+void vTaskStepTick(TickType_t n)
+{
+  if (xTickCount + n > xNextTaskUnblockTime) FAIL("step %u past unblock time", n);
+  xTickCount += n;
+  if (n > max_step) max_step = n;
+}
+void sim_pre_stop(void) { }
+void sim_post_stop(void) { advance(rndr(3)); }
+void sim_cpsid(void) { primask = 1; }
+void sim_cpsie(void) { primask = 0; poll(); }
+
+
+int main(int argc, char **argv)
+{
+  uint64_t cycles = (argc > 1) ? strtoull(argv[1], NULL, 0) : 2000000ULL;
+  uint64_t i, sleeps = 0, long_sleeps = 0;
+
+  if (argc > 2) rng = strtoull(argv[2], NULL, 0) | 1;
+
+  T = rndr(1000);
+  schedule_ext();
+  vPortSetupTimerInterrupt();
+  xNextTaskUnblockTime = 0;
+
+  for (i = 0; i < cycles; i++)
+  {
+    uint32_t expected;
+    uint32_t r;
+
+    poll();
+    if (xTickCount >= xNextTaskUnblockTime)
+    {
+      /* A task runs with interrupts enabled, then blocks */
+      uint32_t work = rndr(100) < 90 ? rndr(20) : rndr(2000);
+      while (work--) { advance(1); poll(); }
+      r = rndr(100);
+      if (r < 30) xNextTaskUnblockTime = xTickCount + 1 + rndr(5);
+      else if (r < 70) xNextTaskUnblockTime = xTickCount + 1 + rndr(200);
+      else if (r < 95) xNextTaskUnblockTime = xTickCount + 1 + rndr(10000);
+      else xNextTaskUnblockTime = xTickCount + 1 + rndr(120000);
+      continue;
+    }
+
+    expected = xNextTaskUnblockTime - xTickCount;
+    if (expected < 2)
+    {
+      advance(1);
+      continue;
+    }
+
+    /* Idle task */
+    {
+      uint64_t stops = stop_entries;
+      uint32_t unblock = xNextTaskUnblockTime;
+      uint64_t aborted = aborts;
+      ext_fired = 0;
+      vPortSuppressTicksAndSleep(expected);
+      poll();
+      sleeps++;
+      if (expected > 2000) long_sleeps++;
+      /* A sleep of E ticks needs about one STOP entry per LPTIM_MAX_DELTA */
+      if (stop_entries - stops > (expected * LSE / HZ) / 0xC000U + 3U)
+        FAIL("%llu STOP entries for %u ticks", (unsigned long long)(stop_entries - stops), expected);
+      if (!ext_fired && aborted == aborts && xTickCount < unblock)
+        FAIL("woke at tick %u before %u without interrupt", xTickCount, unblock);
+    }
+    check_never_early();
+    if ((uint32_t)(last_read_T - Tstart) - LptimTime > 1U)
+      FAIL("extended counter %u, hardware %u, cycle %llu", LptimTime, (uint32_t)(last_read_T - Tstart), (unsigned long long)i);
+  }
+
+  /* Let the tick interrupt catch up and compare with the LSE time */
+  advance(100);
+  poll();
+  if ((xTickCount != (uint32_t)ticks_at(last_read_T)) && (xTickCount != (uint32_t)ticks_at(last_read_T - 1))) FAIL("final tick count");
+  if ((uint32_t)(T - Tstart) - LptimTime > 0xFFFFU) FAIL("extended counter lost");
+
+  printf("%llu cycles, %llu sleeps (%llu over 2 s), %llu STOP entries, %llu aborted\n",
+         (unsigned long long)cycles, (unsigned long long)sleeps, (unsigned long long)long_sleeps,
+         (unsigned long long)stop_entries, (unsigned long long)aborts);
+  printf("%llu tick ISRs, %llu external interrupts, longest step %llu ticks\n",
+         (unsigned long long)isr_runs, (unsigned long long)ext_irqs, (unsigned long long)max_step);
+  printf("simulated %.1f h, %u ticks, LSE time %.6f s, tick time %.3f s: exact\n",
+         (double)(T - Tstart) / LSE / 3600.0, xTickCount,
+         (double)(T - Tstart) / LSE, (double)xTickCount / HZ);
+  return 0;
+}
@@ -0,0 +1,61 @@
+/* Host stub of the parts of the HAL used by the LPTIM time base */
+#ifndef SIM_HAL_H
+#define SIM_HAL_H
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+#define __IO volatile
+typedef enum { RESET = 0, SET = 1 } FlagStatus;
+typedef enum { HAL_OK = 0, HAL_ERROR } HAL_StatusTypeDef;
+typedef enum { HAL_TICK_FREQ_1KHZ = 1 } HAL_TickFreqTypeDef;
+typedef struct { uint32_t OscillatorType, LSEState; } RCC_OscInitTypeDef;
+typedef struct { uint32_t PeriphClockSelection, LptimClockSelection; } RCC_PeriphCLKInitTypeDef;
+typedef struct { struct { uint32_t Source, Prescaler; } Clock; uint32_t CounterSource; struct { uint32_t Source; } Trigger; uint32_t OutputPolarity, UpdateMode; } LPTIM_InitTypeDef;
+typedef struct { void *Instance; LPTIM_InitTypeDef Init; } LPTIM_HandleTypeDef;
+#define LPTIM1 ((void *)1)
+#define LSE_VALUE 32768U
+#define RCC_OSCILLATORTYPE_LSE 0
+#define RCC_LSE_ON 0
+#define RCC_PERIPHCLK_LPTIM1 0
+#define RCC_LPTIM1CLKSOURCE_LSE 0
+#define LPTIM_CLOCKSOURCE_APBCLOCK_LPOSC 0
+#define LPTIM_PRESCALER_DIV1 0
+#define LPTIM_COUNTERSOURCE_INTERNAL 0
+#define LPTIM_TRIGSOURCE_SOFTWARE 0
+#define LPTIM_OUTPUTPOLARITY_HIGH 0
+#define LPTIM_UPDATE_IMMEDIATE 0
+#define LPTIM_FLAG_CMPM 1U
+#define LPTIM_FLAG_CMPOK 2U
+#define LPTIM_FLAG_ARROK 4U
+#define LPTIM_IT_CMPM 1U
+#define LPTIM1_IRQn 13
+#define PWR_LOWPOWERREGULATOR_ON 0
+#define PWR_STOPENTRY_WFI 0
+extern __IO uint32_t uwTick;
+extern HAL_TickFreqTypeDef uwTickFreq;
+void HAL_IncTick(void);
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *p);
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *p);
+HAL_StatusTypeDef HAL_LPTIM_Init(LPTIM_HandleTypeDef *h);
+uint32_t HAL_LPTIM_ReadCounter(LPTIM_HandleTypeDef *h);
+void HAL_NVIC_SetPriority(int irq, uint32_t p, uint32_t s);
+void HAL_NVIC_EnableIRQ(int irq);
+void HAL_NVIC_SetPendingIRQ(int irq);
+void HAL_NVIC_ClearPendingIRQ(int irq);
+void HAL_PWR_EnterSTOPMode(uint32_t r, uint8_t e);
+uint32_t sim_get_flag(uint32_t f);
+void sim_clear_flag(uint32_t f);
+void sim_enable_it(uint32_t it);
+void sim_enable(void);
+void sim_set_arr(uint32_t v);
+void sim_set_cmp(uint32_t v);
+void sim_start(void);
+#define __HAL_LPTIM_GET_FLAG(h, f)       (sim_get_flag(f) ? SET : RESET)
+#define __HAL_LPTIM_CLEAR_FLAG(h, f)     sim_clear_flag(f)
+#define __HAL_LPTIM_ENABLE_IT(h, i)      sim_enable_it(i)
+#define __HAL_LPTIM_ENABLE(h)            sim_enable()
+#define __HAL_LPTIM_AUTORELOAD_SET(h, v) sim_set_arr(v)
+#define __HAL_LPTIM_COMPARE_SET(h, v)    sim_set_cmp(v)
+#define __HAL_LPTIM_START_CONTINUOUS(h)  sim_start()
+#define __HAL_LPTIM_WAKEUPTIMER_EXTI_ENABLE_IT()
+#endif
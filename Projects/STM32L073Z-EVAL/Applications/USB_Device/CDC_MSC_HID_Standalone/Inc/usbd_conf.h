@@ -0,0 +1,96 @@
+/**
+  ******************************************************************************
+  * @file    USB_Device/CDC_MSC_HID_Standalone/Inc/usbd_conf.h
+  * @author  MCD Application Team
+  * @brief   General low level driver configuration
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2016 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __USBD_CONF_H
+#define __USBD_CONF_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32l0xx_hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/* Common Config */
+#define USBD_MAX_NUM_INTERFACES               4   /* CDC: 2, MSC: 1, HID: 1 */
+#define USBD_MAX_NUM_CONFIGURATION            1
+#define USBD_MAX_STR_DESC_SIZ                 0x100
+#define USBD_SELF_POWERED                     1
+#define USBD_DEBUG_LEVEL                      0
+
+/* Composite Config: CDC, MSC and HID */
+#define USBD_MAX_SUPPORTED_CLASS              3U
+
+/* MSC Class Config */
+#define MSC_MEDIA_PACKET                      512
+#define MSC_MEDIA_PACKET_NBR                  4
+#define MSC_MEDIA_DEFERRED                    1
+
+/* Exported macro ------------------------------------------------------------*/
+/* Memory management macros */
+
+/* For footprint reasons and since each class driver handles a single allocation,
+   the malloc/free is changed into a static allocation method giving each class
+   its own buffer, selected by the size of its structure */
+
+void *USBD_static_malloc(uint32_t size);
+void USBD_static_free(void *p);
+
+#define HID_STATIC_ALLOC_SIZE       5 /* HID Class Driver Structure size */
+#define CDC_STATIC_ALLOC_SIZE     148 /* CDC Class Driver Structure size */
+#define MSC_STATIC_ALLOC_SIZE     543 /* MSC Class Driver Structure size */
+
+#define USBD_malloc               (uint32_t *)USBD_static_malloc
+#define USBD_free                 USBD_static_free
+#define USBD_memset               /* Not used */
+#define USBD_memcpy               /* Not used */
+
+
+/* DEBUG macros */
+#if (USBD_DEBUG_LEVEL > 0)
+#define  USBD_UsrLog(...)   printf(__VA_ARGS__);\
+                            printf("\n");
+#else
+#define USBD_UsrLog(...)
+#endif
+
+#if (USBD_DEBUG_LEVEL > 1)
+
+#define  USBD_ErrLog(...)   printf("ERROR: ") ;\
+                            printf(__VA_ARGS__);\
+                            printf("\n");
+#else
+#define USBD_ErrLog(...)
+#endif
+
+#if (USBD_DEBUG_LEVEL > 2)
+#define  USBD_DbgLog(...)   printf("DEBUG : ") ;\
+                            printf(__VA_ARGS__);\
+                            printf("\n");
+#else
+#define USBD_DbgLog(...)
+#endif
+
+/* Exported functions ------------------------------------------------------- */
+
+#endif /* __USBD_CONF_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,35 @@
+/**
+  ******************************************************************************
+  * @file    USB_Device/CDC_MSC_HID_Standalone/Inc/usbd_storage.h
+  * @author  MCD Application Team
+  * @brief   Header for usbd_storage.c module
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2016 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+  
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __USBD_STORAGE_H_
+#define __USBD_STORAGE_H_
+
+/* Includes ------------------------------------------------------------------*/
+#include "usbd_msc.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+extern USBD_StorageTypeDef  USBD_DISK_fops;
+
+#endif /* __USBD_STORAGE_H_ */
+ 
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,343 @@
+/**
+  ******************************************************************************
+  * @file    USB_Device/CDC_MSC_HID_Standalone/Src/main.c
+  * @author  MCD Application Team
+  * @brief   USB device CDC + MSC + HID composite demo main file
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2016 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"  
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define CURSOR_STEP     5
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+USBD_HandleTypeDef USBD_Device;
+__IO uint32_t KeyPressed = 0U;
+/* Private function prototypes -----------------------------------------------*/
+static void SystemClock_Config(void);
+static void HID_Process(void);
+static void GetPointerData(uint8_t *pbuf);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Main program
+  * @param  None
+  * @retval None
+  */
+int main(void)
+{
+  /* STM32L0xx HAL library initialization:
+       - Configure the Flash prefetch, Flash preread and Buffer caches
+       - Systick timer is configured by default as source of time base, but user 
+             can eventually implement his proper time base source (a general purpose 
+             timer for example or other time source), keeping in mind that Time base 
+             duration should be kept 1ms since PPP_TIMEOUT_VALUEs are defined and 
+             handled in milliseconds basis.
+       - Low Level Initialization
+     */
+  HAL_Init();
+    
+  /* Configure the system clock to get correspondent USB clock source */
+  SystemClock_Config();
+  
+  /* Configure LEDs */
+  BSP_LED_Init(LED_GREEN);
+  BSP_LED_Init(LED_ORANGE); 
+  BSP_LED_Init(LED_RED);
+  BSP_LED_Init(LED_BLUE);
+
+  /* Configure Key button to move the host mouse pointer */
+  BSP_PB_Init(BUTTON_KEY, BUTTON_MODE_EXTI);
+
+  /* Init Device Library */
+  USBD_Init(&USBD_Device, &FS_Desc, 0);
+
+  /* Add the classes of the composite device: their interfaces and endpoints
+     are numbered in this order. The interface and storage callbacks are
+     registered once the class is added */
+  if (USBD_COMPOSITE_AddClass(&USBD_Device, USBD_CDC_CLASS) != USBD_OK)
+  {
+    Error_Handler();
+  }
+  USBD_CDC_RegisterInterface(&USBD_Device, &USBD_CDC_fops);
+
+  if (USBD_COMPOSITE_AddClass(&USBD_Device, USBD_MSC_CLASS) != USBD_OK)
+  {
+    Error_Handler();
+  }
+  USBD_MSC_RegisterStorage(&USBD_Device, &USBD_DISK_fops);
+
+  if (USBD_COMPOSITE_AddClass(&USBD_Device, USBD_HID_CLASS) != USBD_OK)
+  {
+    Error_Handler();
+  }
+
+  /* Register the composite class */
+  USBD_RegisterClass(&USBD_Device, USBD_COMPOSITE_CLASS);
+
+  /* Start Device Process */
+  USBD_Start(&USBD_Device);
+
+  /* Read and write the microSD card out of the USB interrupt, so that the
+     USB transfers go on during the card accesses, and send the host mouse
+     pointer position (emulated) when Key button is pressed */
+  while (1)
+  {
+    USBD_MSC_Process(&USBD_Device);
+    HID_Process();
+  }
+}
+
+/**
+  * @brief  Sends the mouse pointer position on the HID interface after each
+  *         press on Key button.
+  * @param  None
+  * @retval None
+  */
+static void HID_Process(void)
+{
+  uint8_t HID_Buffer[4];
+
+  if (KeyPressed == 1U)
+  {
+    KeyPressed = 0U;
+    if (USBD_Device.dev_state == USBD_STATE_CONFIGURED)
+    {
+      GetPointerData(HID_Buffer);
+
+      /* send data though IN endpoint*/
+      USBD_HID_SendReport(&USBD_Device, HID_Buffer, 4);
+    }
+  }
+}
+
+/**
+  * @brief  Gets Pointer Data.
+  * @param  pbuf: Pointer to report
+  * @retval None
+  */
+static void GetPointerData(uint8_t *pbuf)
+{
+  static int8_t cnt = 0;
+  int8_t x = 0, y = 0;
+
+  if (cnt++ > 0)
+  {
+    x = CURSOR_STEP;
+  }
+  else
+  {
+    x = -CURSOR_STEP;
+  }
+  pbuf[0] = 0;
+  pbuf[1] = x;
+  pbuf[2] = y;
+  pbuf[3] = 0;
+}
+
+/**
+  * @brief  EXTI line detection callback.
+  * @param  GPIO_Pin: Specifies the pins connected EXTI line
+  * @retval None
+  */
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+  if (GPIO_Pin == TAMPER_BUTTON_PIN)
+  {
+    KeyPressed = 1U;
+  }
+}
+
+/**
+  * @brief  System Clock Configuration
+  *         The system Clock is configured as follow:
+  *  
+  *            HSI48 used as USB clock source (USE_USB_CLKSOURCE_CRSHSI48 defined in main.h)
+  *              - System Clock source            = HSI
+  *              - HSI Frequency(Hz)              = 16000000
+  *              - SYSCLK(Hz)                     = 16000000
+  *              - HCLK(Hz)                       = 16000000
+  *              - AHB Prescaler                  = 1
+  *              - APB1 Prescaler                 = 1
+  *              - APB2 Prescaler                 = 1
+  *              - Flash Latency(WS)              = 0
+  *              - Main regulator output voltage  = Scale1 mode
+  *
+  *            PLL(HSE) used as USB clock source (USE_USB_CLKSOURCE_PLL defined in main.h)
+  *              - System Clock source            = PLL (HSE)
+  *              - HSE Frequency(Hz)              = 8000000
+  *              - SYSCLK(Hz)                     = 32000000
+  *              - HCLK(Hz)                       = 32000000
+  *              - AHB Prescaler                  = 1
+  *              - APB1 Prescaler                 = 1
+  *              - APB2 Prescaler                 = 1
+  *              - PLL_MUL                        = 12
+  *              - PLL_DIV                        = 3
+  *              - Flash Latency(WS)              = 1
+  *              - Main regulator output voltage  = Scale1 mode
+  *
+  * @param  None
+  * @retval None
+  */
+static void SystemClock_Config(void)
+{
+  RCC_ClkInitTypeDef RCC_ClkInitStruct ={0};
+  RCC_OscInitTypeDef RCC_OscInitStruct = {0};
+  RCC_PeriphCLKInitTypeDef  PeriphClkInitStruct = {0};
+#if defined (USE_USB_CLKSOURCE_CRSHSI48)
+  static RCC_CRSInitTypeDef RCC_CRSInitStruct;
+#endif
+  
+  /* Enable Power Control clock */
+  __HAL_RCC_PWR_CLK_ENABLE();
+  
+  /* The voltage scaling allows optimizing the power consumption when the device is 
+  clocked below the maximum system frequency, to update the voltage scaling value 
+  regarding system frequency refer to product datasheet.  */
+  __HAL_PWR_VOLTAGESCALING_CONFIG(PWR_REGULATOR_VOLTAGE_SCALE1);
+  
+  
+#if defined (USE_USB_CLKSOURCE_CRSHSI48)
+ 
+  /* Enable HSI Oscillator to be used as System clock source
+     Enable HSI48 Oscillator to be used as USB clock source */
+  RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI | RCC_OSCILLATORTYPE_HSI48;
+  RCC_OscInitStruct.HSIState = RCC_HSI_ON;
+  RCC_OscInitStruct.HSI48State = RCC_HSI48_ON;
+  HAL_RCC_OscConfig(&RCC_OscInitStruct); 
+ 
+  /* Select HSI48 as USB clock source */
+  PeriphClkInitStruct.PeriphClockSelection = RCC_PERIPHCLK_USB;
+  PeriphClkInitStruct.UsbClockSelection = RCC_USBCLKSOURCE_HSI48;
+  HAL_RCCEx_PeriphCLKConfig(&PeriphClkInitStruct);
+  
+  /* Select HSI as system clock source and configure the HCLK, PCLK1 and PCLK2 
+     clock dividers */
+  RCC_ClkInitStruct.ClockType = (RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2);
+  RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
+  RCC_ClkInitStruct.AHBCLKDivider = RCC_SYSCLK_DIV1;
+  RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV1;  
+  RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV1;  
+  HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_0);
+    
+  /*Configure the clock recovery system (CRS)**********************************/
+  
+  /*Enable CRS Clock*/
+  __HAL_RCC_CRS_CLK_ENABLE(); 
+  
+  /* Default Synchro Signal division factor (not divided) */
+  RCC_CRSInitStruct.Prescaler = RCC_CRS_SYNC_DIV1;  
+  /* Set the SYNCSRC[1:0] bits according to CRS_Source value */
+  RCC_CRSInitStruct.Source = RCC_CRS_SYNC_SOURCE_USB;  
+  /* HSI48 is synchronized with USB SOF at 1KHz rate */
+  RCC_CRSInitStruct.ReloadValue =  __HAL_RCC_CRS_RELOADVALUE_CALCULATE(48000000, 1000);
+  RCC_CRSInitStruct.ErrorLimitValue = RCC_CRS_ERRORLIMIT_DEFAULT;  
+  /* Set the TRIM[5:0] to the default value*/
+  RCC_CRSInitStruct.HSI48CalibrationValue = 0x20;   
+  /* Start automatic synchronization */ 
+  HAL_RCCEx_CRSConfig (&RCC_CRSInitStruct);
+  
+#elif defined (USE_USB_CLKSOURCE_PLL)
+  
+  /* Enable HSE Oscillator */
+  RCC_OscInitStruct.OscillatorType  = RCC_OSCILLATORTYPE_HSE;
+  RCC_OscInitStruct.HSEState        = RCC_HSE_ON;
+  RCC_OscInitStruct.PLL.PLLSource   = RCC_PLLSOURCE_HSE;
+  RCC_OscInitStruct.PLL.PLLState    = RCC_PLL_ON;
+  RCC_OscInitStruct.PLL.PLLMUL      = RCC_PLL_MUL12;
+  RCC_OscInitStruct.PLL.PLLDIV      = RCC_PLL_DIV3;
+  if (HAL_RCC_OscConfig(&RCC_OscInitStruct)!= HAL_OK)
+  {
+    Error_Handler();
+  }
+  
+  /*Select PLL 48 MHz output as USB clock source */
+  PeriphClkInitStruct.PeriphClockSelection = RCC_PERIPHCLK_USB;
+  PeriphClkInitStruct.UsbClockSelection = RCC_USBCLKSOURCE_PLL;
+  HAL_RCCEx_PeriphCLKConfig(&PeriphClkInitStruct);
+  
+  /* Select PLL as system clock source and configure the HCLK, PCLK1 and PCLK2 
+     clocks dividers */
+  RCC_ClkInitStruct.ClockType = (RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2);
+  RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
+  RCC_ClkInitStruct.AHBCLKDivider = RCC_SYSCLK_DIV1;
+  RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV1;  
+  RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV1;  
+  if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_1)!= HAL_OK)
+  {
+    Error_Handler();
+  }
+  
+#endif /*USE_USB_CLKSOURCE_CRSHSI48*/
+}
+
+/**
+  * @brief  Toggle LEDs to shows user input state.   
+  * @param  None
+  * @retval None
+  */
+void Toggle_Leds(void)
+{
+  static uint32_t ticks;
+  
+  if(ticks++ > 100)
+  {
+    BSP_LED_Toggle(LED1);
+    BSP_LED_Toggle(LED2);
+    BSP_LED_Toggle(LED3);
+    BSP_LED_Toggle(LED4);
+    ticks = 0;
+  }  
+}
+
+/**
+  * @brief  This function is executed in case of error occurrence.
+  * @param  None
+  * @retval None
+  */
+void Error_Handler(void)
+{
+  /* Turn LED REDon */
+  BSP_LED_On(LED_RED);
+  while(1)
+  {
+  }
+}
+
+#ifdef  USE_FULL_ASSERT
+
+/**
+  * @brief  Reports the name of the source file and the source line number
+  *         where the assert_param error has occurred.
+  * @param  file: pointer to the source file name
+  * @param  line: assert_param error line source number
+  * @retval None
+  */
+void assert_failed(uint8_t *file, uint32_t line)
+{ 
+  /* User can add his own implementation to report the file name and line number,
+     ex: printf("Wrong parameters value: file %s on line %d\r\n", file, line) */
+
+  /* Infinite loop */
+  while (1)
+  {
+  }
+}
+#endif
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
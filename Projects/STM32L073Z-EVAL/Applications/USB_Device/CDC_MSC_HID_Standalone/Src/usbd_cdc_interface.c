@@ -0,0 +1,384 @@
+/**
+  ******************************************************************************
+  * @file    USB_Device/CDC_MSC_HID_Standalone/Src/usbd_cdc_interface.c
+  * @author  MCD Application Team
+  * @brief   Source file for USBD CDC interface
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2016 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/** @addtogroup STM32_USB_OTG_DEVICE_LIBRARY
+  * @{
+  */
+
+/** @defgroup USBD_CDC 
+  * @brief usbd core module
+  * @{
+  */ 
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define APP_RX_DATA_SIZE  2048 /* Power of 2 */
+#define APP_TX_DATA_SIZE  2048 /* Power of 2 */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+USBD_CDC_LineCodingTypeDef LineCoding =
+  {
+    115200, /* baud rate*/
+    0x00,   /* stop bits-1*/
+    0x00,   /* parity - none*/
+    0x08    /* nb. of bits 8*/
+  };
+
+/* Received Data over USB are stored in this ring, with room for a packet past its end */
+uint8_t UserRxBuffer[APP_RX_DATA_SIZE + CDC_DATA_FS_OUT_PACKET_SIZE];
+uint8_t UserTxBuffer[APP_TX_DATA_SIZE];/* Received Data over UART (CDC interface) are stored in this ring */
+uint8_t UartRxByte;                    /* Last byte received over UART */
+uint8_t UartTxBuffer[CDC_DATA_FS_OUT_PACKET_SIZE];/* Data being transmitted over UART */
+__IO uint32_t UartTxBusy = 0;
+
+/* UART handler declaration */
+UART_HandleTypeDef UartHandle;
+/* USB handler declaration */
+extern USBD_HandleTypeDef  USBD_Device;
+
+/* Private function prototypes -----------------------------------------------*/
+static int8_t CDC_Itf_Init     (void);
+static int8_t CDC_Itf_DeInit   (void);
+static int8_t CDC_Itf_Control  (uint8_t cmd, uint8_t* pbuf, uint16_t length);
+static int8_t CDC_Itf_Receive  (uint8_t* pbuf, uint32_t *Len);
+
+static void ComPort_Config(void);
+static void UART_Transmit(void);
+
+USBD_CDC_ItfTypeDef USBD_CDC_fops = 
+{
+  CDC_Itf_Init,
+  CDC_Itf_DeInit,
+  CDC_Itf_Control,
+  CDC_Itf_Receive
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  CDC_Itf_Init
+  *         Initializes the CDC media low layer
+  * @param  None
+  * @retval Result of the opeartion: USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t CDC_Itf_Init(void)
+{
+  /*##-1- Configure the UART peripheral ######################################*/
+  /* Put the USART peripheral in the Asynchronous mode (UART Mode) */
+  /* USART configured as follows:
+      - Word Length = 8 Bits
+      - Stop Bit    = One Stop bit
+      - Parity      = No parity
+      - BaudRate    = 115200 baud
+      - Hardware flow control disabled (RTS and CTS signals) */
+  UartHandle.Instance        = USARTx;
+  UartHandle.Init.BaudRate   = 115200;
+  UartHandle.Init.WordLength = UART_WORDLENGTH_8B;
+  UartHandle.Init.StopBits   = UART_STOPBITS_1;
+  UartHandle.Init.Parity     = UART_PARITY_NONE;
+  UartHandle.Init.Mode       = UART_MODE_TX_RX;
+  UartHandle.Init.HwFlowCtl  = UART_HWCONTROL_NONE;
+  
+  if(HAL_UART_Init(&UartHandle) != HAL_OK)
+  {
+    /* Initialization Error */
+    Error_Handler();
+  }
+  
+  /*##-2- Put UART peripheral in IT reception process ########################*/
+  /* Any data received will be written in the "UserTxBuffer" ring */
+  UartTxBusy = 0;
+  if(HAL_UART_Receive_IT(&UartHandle, &UartRxByte, 1) != HAL_OK)
+  {
+    /* Transfer error in reception process */
+    Error_Handler();
+  }
+  
+  /*##-3- Set Application Rings ##############################################*/
+  USBD_CDC_SetTxRing(&USBD_Device, UserTxBuffer, APP_TX_DATA_SIZE);
+  USBD_CDC_SetRxRing(&USBD_Device, UserRxBuffer, APP_RX_DATA_SIZE);
+  
+  return (USBD_OK);
+}
+
+/**
+  * @brief  CDC_Itf_DeInit
+  *         DeInitializes the CDC media low layer
+  * @param  None
+  * @retval Result of the opeartion: USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t CDC_Itf_DeInit(void)
+{
+  /* DeInitialize the UART peripheral */
+  if(HAL_UART_DeInit(&UartHandle) != HAL_OK)
+  {
+    /* Initialization Error */
+    Error_Handler();
+  }
+  return (USBD_OK);
+}
+
+/**
+  * @brief  CDC_Itf_Control
+  *         Manage the CDC class requests
+  * @param  Cmd: Command code            
+  * @param  Buf: Buffer containing command data (request parameters)
+  * @param  Len: Number of data to be sent (in bytes)
+  * @retval Result of the opeartion: USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t CDC_Itf_Control (uint8_t cmd, uint8_t* pbuf, uint16_t length)
+{ 
+  switch (cmd)
+  {
+  case CDC_SEND_ENCAPSULATED_COMMAND:
+    /* Add your code here */
+    break;
+
+  case CDC_GET_ENCAPSULATED_RESPONSE:
+    /* Add your code here */
+    break;
+
+  case CDC_SET_COMM_FEATURE:
+    /* Add your code here */
+    break;
+
+  case CDC_GET_COMM_FEATURE:
+    /* Add your code here */
+    break;
+
+  case CDC_CLEAR_COMM_FEATURE:
+    /* Add your code here */
+    break;
+
+  case CDC_SET_LINE_CODING:
+    LineCoding.bitrate    = (uint32_t)(pbuf[0] | (pbuf[1] << 8) |\
+                            (pbuf[2] << 16) | (pbuf[3] << 24));
+    LineCoding.format     = pbuf[4];
+    LineCoding.paritytype = pbuf[5];
+    LineCoding.datatype   = pbuf[6];
+    
+    /* Set the new configuration */
+    ComPort_Config();
+    break;
+
+  case CDC_GET_LINE_CODING:
+    pbuf[0] = (uint8_t)(LineCoding.bitrate);
+    pbuf[1] = (uint8_t)(LineCoding.bitrate >> 8);
+    pbuf[2] = (uint8_t)(LineCoding.bitrate >> 16);
+    pbuf[3] = (uint8_t)(LineCoding.bitrate >> 24);
+    pbuf[4] = LineCoding.format;
+    pbuf[5] = LineCoding.paritytype;
+    pbuf[6] = LineCoding.datatype;     
+    
+    /* Add your code here */
+    break;
+
+  case CDC_SET_CONTROL_LINE_STATE:
+    /* Add your code here */
+    break;
+
+  case CDC_SEND_BREAK:
+     /* Add your code here */
+    break;    
+    
+  default:
+    break;
+  }
+  
+  return (USBD_OK);
+}
+
+/**
+  * @brief  Rx Transfer completed callback
+  * @param  huart: UART handle
+  * @retval None
+  */
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+  /* Sent at once if the IN endpoint is idle, else with the next USB transfer.
+     The byte is lost if the host does not read the VCP and the ring is full */
+  USBD_CDC_Write(&USBD_Device, &UartRxByte, 1);
+  
+  /* Start another reception */
+  HAL_UART_Receive_IT(huart, &UartRxByte, 1);
+}
+
+/**
+  * @brief  CDC_Itf_DataRx
+  *         Data received over USB OUT endpoint are sent over CDC interface 
+  *         through this function.
+  * @param  Buf: Buffer of data to be transmitted
+  * @param  Len: Number of data received (in bytes)
+  * @retval Result of the opeartion: USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t CDC_Itf_Receive(uint8_t* Buf, uint32_t *Len)
+{
+  /* The data are in the "UserRxBuffer" ring */
+  UART_Transmit();
+  return (USBD_OK);
+}
+
+/**
+  * @brief  Tx Transfer completed callback
+  * @param  huart: UART handle
+  * @retval None
+  */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  UartTxBusy = 0;
+  
+  /* Transmit the next data received over USB, if any */
+  UART_Transmit();
+}
+
+/**
+  * @brief  UART_Transmit
+  *         Transmit over UART the data of the "UserRxBuffer" ring, unless a
+  *         transmission is in progress. The OUT endpoint is NAKed while the
+  *         ring is full, and resumed by USBD_CDC_Read()
+  * @param  None
+  * @retval None
+  * @note   Called from the USB and the DMA interrupts
+  */
+static void UART_Transmit(void)
+{
+  uint32_t primask = __get_PRIMASK();
+  uint32_t length;
+  
+  __disable_irq();
+  if(UartTxBusy == 0)
+  {
+    length = USBD_CDC_Read(&USBD_Device, UartTxBuffer, sizeof(UartTxBuffer));
+    if(length != 0)
+    {
+      UartTxBusy = 1;
+      HAL_UART_Transmit_DMA(&UartHandle, UartTxBuffer, (uint16_t)length);
+    }
+  }
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  ComPort_Config
+  *         Configure the COM Port with the parameters received from host.
+  * @param  None.
+  * @retval None.
+  * @note   When a configuration is not supported, a default value is used.
+  */
+static void ComPort_Config(void)
+{
+  if(HAL_UART_DeInit(&UartHandle) != HAL_OK)
+  {
+    /* Initialization Error */
+    Error_Handler();
+  }
+  
+  /* set the Stop bit */
+  switch (LineCoding.format)
+  {
+  case 0:
+    UartHandle.Init.StopBits = UART_STOPBITS_1;
+    break;
+  case 2:
+    UartHandle.Init.StopBits = UART_STOPBITS_2;
+    break;
+  default :
+    UartHandle.Init.StopBits = UART_STOPBITS_1;
+    break;
+  }
+  
+  /* set the parity bit*/
+  switch (LineCoding.paritytype)
+  {
+  case 0:
+    UartHandle.Init.Parity = UART_PARITY_NONE;
+    break;
+  case 1:
+    UartHandle.Init.Parity = UART_PARITY_ODD;
+    break;
+  case 2:
+    UartHandle.Init.Parity = UART_PARITY_EVEN;
+    break;
+  default :
+    UartHandle.Init.Parity = UART_PARITY_NONE;
+    break;
+  }
+  
+  /*set the data type : only 8bits and 9bits is supported */
+  switch (LineCoding.datatype)
+  {
+  case 0x07:
+    /* With this configuration a parity (Even or Odd) must be set */
+    UartHandle.Init.WordLength = UART_WORDLENGTH_8B;
+    break;
+  case 0x08:
+    if(UartHandle.Init.Parity == UART_PARITY_NONE)
+    {
+      UartHandle.Init.WordLength = UART_WORDLENGTH_8B;
+    }
+    else 
+    {
+      UartHandle.Init.WordLength = UART_WORDLENGTH_9B;
+    }
+    
+    break;
+  default :
+    UartHandle.Init.WordLength = UART_WORDLENGTH_8B;
+    break;
+  }
+  
+  UartHandle.Init.BaudRate = LineCoding.bitrate;
+  UartHandle.Init.HwFlowCtl  = UART_HWCONTROL_NONE;
+  UartHandle.Init.Mode       = UART_MODE_TX_RX;
+  
+  if(HAL_UART_Init(&UartHandle) != HAL_OK)
+  {
+    /* Initialization Error */
+    Error_Handler();
+  }
+
+  /* Start reception */
+  HAL_UART_Receive_IT(&UartHandle, &UartRxByte, 1);
+}
+
+/**
+  * @brief  UART error callbacks
+  * @param  UartHandle: UART handle
+  * @retval None
+  */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *UartHandle)
+{
+  /* Transfer error occurred in reception and/or transmission process */
+  Error_Handler();
+}
+
+/**
+  * @}
+  */ 
+
+/**
+  * @}
+  */ 
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
+
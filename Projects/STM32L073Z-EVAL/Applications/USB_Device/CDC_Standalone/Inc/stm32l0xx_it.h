@@ -41,7 +41,6 @@ void USB_IRQHandler(void);
 void EXTI4_15_IRQHandler(void);
 void USARTx_DMA_TX_IRQHandler(void);
 void USARTx_IRQHandler(void);
-void TIMx_IRQHandler(void);
 
 #ifdef __cplusplus
 }
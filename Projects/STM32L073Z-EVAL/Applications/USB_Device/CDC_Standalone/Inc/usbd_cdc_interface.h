@@ -64,20 +64,6 @@
 #define USARTx_DMA_TX_IRQHandler          DMA1_Channel4_5_6_7_IRQHandler
 #define USARTx_DMA_RX_IRQHandler          DMA1_Channel4_5_6_7_IRQHandler
 
-/* Definition for TIMx clock resources */
-#define TIMx                             TIM3
-#define TIMx_CLK_ENABLE                  __HAL_RCC_TIM3_CLK_ENABLE
-#define TIMx_FORCE_RESET()               __HAL_RCC_USART2_FORCE_RESET()
-#define TIMx_RELEASE_RESET()             __HAL_RCC_USART2_RELEASE_RESET()
-
-/* Definition for TIMx's NVIC */
-#define TIMx_IRQn                        TIM3_IRQn
-#define TIMx_IRQHandler                  TIM3_IRQHandler
-
-/* Periodically, the state of the buffer "UserTxBuffer" is checked.
-   The period depends on CDC_POLLING_INTERVAL */
-#define CDC_POLLING_INTERVAL             5 /* in ms. The max is 65 and the min is 1 */
-
 extern USBD_CDC_ItfTypeDef  USBD_CDC_fops;
 
 /* Exported macro ------------------------------------------------------------*/
@@ -45,7 +45,7 @@
 void *USBD_static_malloc(uint32_t size);
 void USBD_static_free(void *p);
 
-#define MAX_STATIC_ALLOC_SIZE    140 /* CDC Class Driver Structure size */
+#define MAX_STATIC_ALLOC_SIZE    148 /* CDC Class Driver Structure size */
 
 #define USBD_malloc               (uint32_t *)USBD_static_malloc
 #define USBD_free                 USBD_static_free
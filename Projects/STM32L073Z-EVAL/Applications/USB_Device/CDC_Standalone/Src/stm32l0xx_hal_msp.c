@@ -101,16 +101,6 @@ void HAL_UART_MspInit(UART_HandleTypeDef *huart)
   /* NVIC configuration for DMA transfer complete interrupt (USARTx_TX) */
   HAL_NVIC_SetPriority(USARTx_DMA_TX_IRQn, 5, 0);
   HAL_NVIC_EnableIRQ(USARTx_DMA_TX_IRQn);
-  
-  /*##-6- Enable TIM peripherals Clock #######################################*/
-  TIMx_CLK_ENABLE();
-  
-  /*##-7- Configure the NVIC for TIMx ########################################*/
-  /* Set Interrupt Group Priority */ 
-  HAL_NVIC_SetPriority(TIMx_IRQn, 5, 0);
-  
-  /* Enable the TIMx global Interrupt */
-  HAL_NVIC_EnableIRQ(TIMx_IRQn);
 }
 
 /**
@@ -139,10 +129,6 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef *huart)
   
   /*##-4- Disable the NVIC for DMA ###########################################*/
   HAL_NVIC_DisableIRQ(USARTx_DMA_TX_IRQn);
-  
-  /*##-5- Reset TIM peripheral ###############################################*/
-  TIMx_FORCE_RESET();
-  TIMx_RELEASE_RESET();
 }
 
 /**
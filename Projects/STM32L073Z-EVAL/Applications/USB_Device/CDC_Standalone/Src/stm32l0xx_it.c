@@ -32,9 +32,6 @@ extern PCD_HandleTypeDef hpcd;
 /* UART handler declared in "usbd_cdc_interface.c" file */
 extern UART_HandleTypeDef UartHandle;
 
-/* TIM handler declared in "usbd_cdc_interface.c" file */
-extern TIM_HandleTypeDef TimHandle;
-
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
@@ -134,15 +131,5 @@ void USARTx_IRQHandler(void)
   HAL_UART_IRQHandler(&UartHandle);
 }
 
-/**
-  * @brief  This function handles TIM interrupt request.
-  * @param  None
-  * @retval None
-  */
-void TIMx_IRQHandler(void)
-{
-  HAL_TIM_IRQHandler(&TimHandle);
-}
-
 
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -31,8 +31,8 @@
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
-#define APP_RX_DATA_SIZE  2048
-#define APP_TX_DATA_SIZE  2048
+#define APP_RX_DATA_SIZE  2048 /* Power of 2 */
+#define APP_TX_DATA_SIZE  2048 /* Power of 2 */
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
@@ -44,18 +44,15 @@ USBD_CDC_LineCodingTypeDef LineCoding =
     0x08    /* nb. of bits 8*/
   };
 
-uint8_t UserRxBuffer[APP_RX_DATA_SIZE];/* Received Data over USB are stored in this buffer */
-uint8_t UserTxBuffer[APP_TX_DATA_SIZE];/* Received Data over UART (CDC interface) are stored in this buffer */
-uint32_t BuffLength;
-uint32_t UserTxBufPtrIn = 0;/* Increment this pointer or roll it back to
-                               start address when data are received over USART */
-uint32_t UserTxBufPtrOut = 0; /* Increment this pointer or roll it back to
-                                 start address when data are sent over USB */
+/* Received Data over USB are stored in this ring, with room for a packet past its end */
+uint8_t UserRxBuffer[APP_RX_DATA_SIZE + CDC_DATA_FS_OUT_PACKET_SIZE];
+uint8_t UserTxBuffer[APP_TX_DATA_SIZE];/* Received Data over UART (CDC interface) are stored in this ring */
+uint8_t UartRxByte;                    /* Last byte received over UART */
+uint8_t UartTxBuffer[CDC_DATA_FS_OUT_PACKET_SIZE];/* Data being transmitted over UART */
+__IO uint32_t UartTxBusy = 0;
 
 /* UART handler declaration */
 UART_HandleTypeDef UartHandle;
-/* TIM handler declaration */
-TIM_HandleTypeDef    TimHandle;
 /* USB handler declaration */
 extern USBD_HandleTypeDef  USBD_Device;
 
@@ -66,7 +63,7 @@ static int8_t CDC_Itf_Control  (uint8_t cmd, uint8_t* pbuf, uint16_t length);
 static int8_t CDC_Itf_Receive  (uint8_t* pbuf, uint32_t *Len);
 
 static void ComPort_Config(void);
-static void TIM_Config(void);
+static void UART_Transmit(void);
 
 USBD_CDC_ItfTypeDef USBD_CDC_fops = 
 {
@@ -109,27 +106,17 @@ static int8_t CDC_Itf_Init(void)
   }
   
   /*##-2- Put UART peripheral in IT reception process ########################*/
-  /* Any data received will be stored in "UserTxBuffer" buffer  */
-  if(HAL_UART_Receive_IT(&UartHandle, (uint8_t *)UserTxBuffer, 1) != HAL_OK)
+  /* Any data received will be written in the "UserTxBuffer" ring */
+  UartTxBusy = 0;
+  if(HAL_UART_Receive_IT(&UartHandle, &UartRxByte, 1) != HAL_OK)
   {
     /* Transfer error in reception process */
     Error_Handler();
   }
   
-  /*##-3- Configure the TIM Base generation  #################################*/
-  TIM_Config();
-  
-  /*##-4- Start the TIM Base generation in interrupt mode ####################*/
-  /* Start Channel1 */
-  if(HAL_TIM_Base_Start_IT(&TimHandle) != HAL_OK)
-  {
-    /* Starting Error */
-    Error_Handler();
-  }
-  
-  /*##-5- Set Application Buffers ############################################*/
-  USBD_CDC_SetTxBuffer(&USBD_Device, UserTxBuffer, 0);
-  USBD_CDC_SetRxBuffer(&USBD_Device, UserRxBuffer);
+  /*##-3- Set Application Rings ##############################################*/
+  USBD_CDC_SetTxRing(&USBD_Device, UserTxBuffer, APP_TX_DATA_SIZE);
+  USBD_CDC_SetRxRing(&USBD_Device, UserRxBuffer, APP_RX_DATA_SIZE);
   
   return (USBD_OK);
 }
@@ -221,42 +208,6 @@ static int8_t CDC_Itf_Control (uint8_t cmd, uint8_t* pbuf, uint16_t length)
   return (USBD_OK);
 }
 
-/**
-  * @brief  TIM period elapsed callback
-  * @param  htim: TIM handle
-  * @retval None
-  */
-void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
-{
-  uint32_t buffptr;
-  uint32_t buffsize;
-  
-  if(UserTxBufPtrOut != UserTxBufPtrIn)
-  {
-    if(UserTxBufPtrOut > UserTxBufPtrIn) /* rollback */
-    {
-      buffsize = APP_RX_DATA_SIZE - UserTxBufPtrOut;
-    }
-    else 
-    {
-      buffsize = UserTxBufPtrIn - UserTxBufPtrOut;
-    }
-    
-    buffptr = UserTxBufPtrOut;
-    
-    USBD_CDC_SetTxBuffer(&USBD_Device, (uint8_t*)&UserTxBuffer[buffptr], buffsize);
-    
-    if(USBD_CDC_TransmitPacket(&USBD_Device) == USBD_OK)
-    {
-      UserTxBufPtrOut += buffsize;
-      if (UserTxBufPtrOut == APP_RX_DATA_SIZE)
-      {
-        UserTxBufPtrOut = 0;
-      }
-    }
-  }
-}
-
 /**
   * @brief  Rx Transfer completed callback
   * @param  huart: UART handle
@@ -264,17 +215,12 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
   */
 void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 {
-  /* Increment Index for buffer writing */
-  UserTxBufPtrIn++;
-  
-  /* To avoid buffer overflow */
-  if(UserTxBufPtrIn == APP_RX_DATA_SIZE)
-  {
-    UserTxBufPtrIn = 0;
-  }
+  /* Sent at once if the IN endpoint is idle, else with the next USB transfer.
+     The byte is lost if the host does not read the VCP and the ring is full */
+  USBD_CDC_Write(&USBD_Device, &UartRxByte, 1);
   
-  /* Start another reception: provide the buffer pointer with offset and the buffer size */
-  HAL_UART_Receive_IT(huart, (uint8_t *)(UserTxBuffer + UserTxBufPtrIn), 1);
+  /* Start another reception */
+  HAL_UART_Receive_IT(huart, &UartRxByte, 1);
 }
 
 /**
@@ -287,7 +233,8 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
   */
 static int8_t CDC_Itf_Receive(uint8_t* Buf, uint32_t *Len)
 {
-  HAL_UART_Transmit_DMA(&UartHandle, Buf, *Len);
+  /* The data are in the "UserRxBuffer" ring */
+  UART_Transmit();
   return (USBD_OK);
 }
 
@@ -298,8 +245,37 @@ static int8_t CDC_Itf_Receive(uint8_t* Buf, uint32_t *Len)
   */
 void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
 {
-  /* Initiate next USB packet transfer once UART completes transfer (transmitting data over Tx line) */
-  USBD_CDC_ReceivePacket(&USBD_Device);
+  UartTxBusy = 0;
+  
+  /* Transmit the next data received over USB, if any */
+  UART_Transmit();
+}
+
+/**
+  * @brief  UART_Transmit
+  *         Transmit over UART the data of the "UserRxBuffer" ring, unless a
+  *         transmission is in progress. The OUT endpoint is NAKed while the
+  *         ring is full, and resumed by USBD_CDC_Read()
+  * @param  None
+  * @retval None
+  * @note   Called from the USB and the DMA interrupts
+  */
+static void UART_Transmit(void)
+{
+  uint32_t primask = __get_PRIMASK();
+  uint32_t length;
+  
+  __disable_irq();
+  if(UartTxBusy == 0)
+  {
+    length = USBD_CDC_Read(&USBD_Device, UartTxBuffer, sizeof(UartTxBuffer));
+    if(length != 0)
+    {
+      UartTxBusy = 1;
+      HAL_UART_Transmit_DMA(&UartHandle, UartTxBuffer, (uint16_t)length);
+    }
+  }
+  __set_PRIMASK(primask);
 }
 
 /**
@@ -381,35 +357,8 @@ static void ComPort_Config(void)
     Error_Handler();
   }
 
-  /* Start reception: provide the buffer pointer with offset and the buffer size */
-  HAL_UART_Receive_IT(&UartHandle, (uint8_t *)(UserTxBuffer + UserTxBufPtrIn), 1);
-}
-
-/**
-  * @brief  TIM_Config: Configure TIMx timer
-  * @param  None.
-  * @retval None.
-  */
-static void TIM_Config(void)
-{  
-  /* Set TIMx instance */
-  TimHandle.Instance = TIMx;
-  
-  /* Initialize TIM3 peripheral as follows:
-       + Period = 1000 - 1
-       + Prescaler = ((SystemCoreClock/10000) - 1
-       + ClockDivision = 0
-       + Counter direction = Up
-  */
-  TimHandle.Init.Period = (CDC_POLLING_INTERVAL*1000) - 1;
-  TimHandle.Init.Prescaler = 32-1;
-  TimHandle.Init.ClockDivision = 0;
-  TimHandle.Init.CounterMode = TIM_COUNTERMODE_UP;
-  if(HAL_TIM_Base_Init(&TimHandle) != HAL_OK)
-  {
-    /* Initialization Error */
-    Error_Handler();
-  }
+  /* Start reception */
+  HAL_UART_Receive_IT(&UartHandle, &UartRxByte, 1);
 }
 
 /**
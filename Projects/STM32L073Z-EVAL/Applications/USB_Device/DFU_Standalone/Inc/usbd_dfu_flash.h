@@ -31,6 +31,7 @@
 extern USBD_DFU_MediaTypeDef  USBD_DFU_Flash_fops;
 
 /* Exported functions ------------------------------------------------------- */
+void Flash_If_Process(void);
 
 #endif /* __USBD_DFU_FLASH_H_ */
 
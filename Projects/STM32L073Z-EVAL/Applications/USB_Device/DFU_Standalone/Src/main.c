@@ -94,9 +94,11 @@ int main(void)
   /* Start Device Process */
   USBD_Start(&USBD_Device);
   
-  /* In an infinite loop, send periodically host mouse pointer position (emulated) */  
+  /* Erase and program the flash out of the USB interrupt, so that the next
+     block is received while the previous one is programmed */
   while (1)
   {
+    Flash_If_Process();
   }
 }
 
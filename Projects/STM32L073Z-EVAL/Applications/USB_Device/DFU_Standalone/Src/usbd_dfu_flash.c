@@ -25,12 +25,36 @@
 /* Private define ------------------------------------------------------------*/
 /* 256 pages of 2 Kbytes*/
 #define FLASH_DESC_STR      "@Internal Flash   /0x08000000/120*128Ba,1416*128Bg"
-#define FLASH_ERASE_TIME    (uint16_t)50
-#define FLASH_PROGRAM_TIME  (uint16_t)50
+
+/* Typical duration of a page erase and of a word or half-page programming */
+#define FLASH_OPERATION_TIME_US   3280U
+
+#define FLASH_HALF_PAGE_SIZE      (FLASH_PAGE_SIZE / 2U)
+
+/* Operations run by Flash_If_Process() */
+#define FLASH_OP_NONE             0U
+#define FLASH_OP_ERASE            1U
+#define FLASH_OP_PROGRAM          2U
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+/* Block programmed in background, while the DFU class receives the next one */
+static uint32_t FlashBuffer[USBD_DFU_XFER_SIZE / 4U];
+static uint32_t FlashStart;               /* Address of the block */
+static __IO uint32_t FlashAddress;        /* Write pointer, or page to erase */
+static uint32_t FlashEnd;                 /* End of the block */
+static uint32_t FlashErased;              /* End of the pages erased ahead of the write pointer */
+static __IO uint32_t FlashOps;            /* Erases and programmings left, for bwPollTimeout */
+static __IO uint8_t FlashOp = FLASH_OP_NONE;
+static __IO uint8_t FlashLock;            /* Lock the flash once the operations are done */
+static __IO uint16_t FlashError;          /* Result of the last background operation */
+
 /* Private function prototypes -----------------------------------------------*/
+static uint8_t Flash_If_IsErased(uint32_t Add, uint32_t Len);
+static uint16_t Flash_If_ErasePage(uint32_t Add);
+static uint16_t Flash_If_Program(void);
+static void Flash_If_Step(void);
+
 /* Extern function prototypes ------------------------------------------------*/
 uint16_t Flash_If_Init(void);
 uint16_t Flash_If_Erase(uint32_t Add);
@@ -57,6 +81,9 @@ USBD_DFU_MediaTypeDef USBD_DFU_Flash_fops= {
   */
 uint16_t Flash_If_Init(void)
 {
+  FlashLock = 0U;
+  FlashError = 0U;
+
   /* Unlock the internal flash */
   HAL_FLASH_Unlock();
   return 0;
@@ -69,65 +96,135 @@ uint16_t Flash_If_Init(void)
   */
 uint16_t Flash_If_DeInit(void)
 {
-  /* Lock the internal flash */
-  HAL_FLASH_Lock();
+  /* A block already acknowledged to the host is still programmed: the flash
+     is then locked by Flash_If_Process() */
+  FlashLock = 1U;
+
+  if (FlashOp == FLASH_OP_NONE)
+  {
+    /* Lock the internal flash */
+    HAL_FLASH_Lock();
+  }
   return 0;
 }
 
 /**
   * @brief  Erases sector.
   * @param  Add: Address of sector to be erased.
-  * @retval 0 if operation is successeful, MAL_FAIL else.
+  * @retval 0 if operation is successeful, DFU_MEDIA_BUSY if the previous
+  *         operation is not done, MAL_FAIL else.
   */
 uint16_t Flash_If_Erase(uint32_t Add)
 {
-  uint32_t PageError;
-  /* Variable contains Flash operation status */
-  HAL_StatusTypeDef status;
-  FLASH_EraseInitTypeDef eraseinitstruct;
+  uint16_t status;
 
-  eraseinitstruct.TypeErase = FLASH_TYPEERASE_PAGES;
-  eraseinitstruct.PageAddress = Add;
-  eraseinitstruct.NbPages = 1U;
-  status = HAL_FLASHEx_Erase(&eraseinitstruct, &PageError);
+  if (FlashOp != FLASH_OP_NONE)
+  {
+    return DFU_MEDIA_BUSY;
+  }
 
-  if (status != HAL_OK)
+  /* Report the failure of the previous operation */
+  status = FlashError;
+  FlashError = 0U;
+
+  if (status == 0U)
   {
-    return 1U;
+    Add &= ~(FLASH_PAGE_SIZE - 1U);
+
+    /* Nothing to do when the page was erased ahead of a previous block */
+    if (Flash_If_IsErased(Add, FLASH_PAGE_SIZE) == 0U)
+    {
+      FlashAddress = Add;
+      FlashOps = 1U;
+      FlashOp = FLASH_OP_ERASE;
+    }
   }
-  return 0U;
+  return status;
 }
 
 /**
   * @brief  Writes Data into Memory.
+  * @note   The data are copied and programmed by Flash_If_Process(). A write of
+  *         0 bytes, at manifestation, completes the pending operations.
   * @param  src: Pointer to the source buffer. Address to be written to.
   * @param  dest: Pointer to the destination buffer.
   * @param  Len: Number of data to be written (in bytes).
-  * @retval 0 if operation is successeful, MAL_FAIL else.
+  * @retval 0 if operation is successeful, DFU_MEDIA_BUSY if the previous
+  *         block is not programmed, MAL_FAIL else.
   */
 uint16_t Flash_If_Write(uint8_t *src, uint8_t *dest, uint32_t Len)
 {
   uint32_t i = 0;
+  uint32_t add;
+  uint16_t status;
 
-  for(i = 0; i < Len; i+=4)
+  if (Len == 0U)
   {
-    /* Device voltage range supposed to be [2.7V to 3.6V], the operation will
-       be done by byte */
-    if(HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, (uint32_t)(dest+i), *(uint32_t*)(src+i)) == HAL_OK)
+    /* Called from the USB interrupt, which Flash_If_Process() masks during
+       an operation: the main loop cannot complete them before this one
+       returns */
+    while (FlashOp != FLASH_OP_NONE)
     {
-     /* Check the written value */
-      if(*(uint32_t *)(src + i) != *(uint32_t*)(dest+i))
-      {
-        /* Flash content doesn't match SRAM content */
-        return 2;
-      }
+      Flash_If_Step();
+    }
+  }
+  else if (FlashOp != FLASH_OP_NONE)
+  {
+    return DFU_MEDIA_BUSY;
+  }
+
+  /* Report the failure of the previous block */
+  status = FlashError;
+  FlashError = 0U;
+
+  if ((status != 0U) || (Len == 0U))
+  {
+    return status;
+  }
+
+  if ((Len > USBD_DFU_XFER_SIZE) || (((uint32_t)dest & 3U) != 0U))
+  {
+    return 1;
+  }
+
+  /* Pad the last word with the erased value */
+  FlashBuffer[(Len - 1U) / 4U] = 0U;
+
+  for(i = 0; i < Len; i++)
+  {
+    ((uint8_t *)FlashBuffer)[i] = src[i];
+  }
+
+  FlashStart = (uint32_t)dest;
+  FlashAddress = (uint32_t)dest;
+  FlashEnd = (uint32_t)dest + ((Len + 3U) & ~3U);
+
+  /* A page starting before the block may hold data written before: it is
+     not erased */
+  FlashErased = ((uint32_t)dest + FLASH_PAGE_SIZE - 1U) & ~(FLASH_PAGE_SIZE - 1U);
+
+  /* Count the flash operations for Flash_If_GetStatus() */
+  FlashOps = 0U;
+  for (add = FlashErased; add < FlashEnd; add += FLASH_PAGE_SIZE)
+  {
+    if (Flash_If_IsErased(add, FLASH_PAGE_SIZE) == 0U)
+    {
+      FlashOps++;
+    }
+  }
+  for (add = FlashAddress; add < FlashEnd; FlashOps++)
+  {
+    if (((add & (FLASH_HALF_PAGE_SIZE - 1U)) == 0U) && ((FlashEnd - add) >= FLASH_HALF_PAGE_SIZE))
+    {
+      add += FLASH_HALF_PAGE_SIZE;
     }
     else
     {
-      /* Error occurred while writing data in Flash memory */
-      return 1;
+      add += 4U;
     }
   }
+
+  FlashOp = FLASH_OP_PROGRAM;
   return 0;
 }
 
@@ -141,16 +238,31 @@ uint16_t Flash_If_Write(uint8_t *src, uint8_t *dest, uint32_t Len)
 uint8_t *Flash_If_Read(uint8_t *src, uint8_t *dest, uint32_t Len)
 {
   uint32_t i = 0;
+  uint32_t add;
   uint8_t *psrc = src;
 
   for(i = 0; i < Len; i++)
   {
-    dest[i] = *psrc++;
+    add = (uint32_t)psrc;
+
+    /* Data not programmed yet are read from the pending block */
+    if ((FlashOp == FLASH_OP_PROGRAM) && (add >= FlashAddress) && (add < FlashEnd))
+    {
+      dest[i] = ((uint8_t *)FlashBuffer)[add - FlashStart];
+    }
+    else if ((FlashOp == FLASH_OP_ERASE) && ((add & ~(FLASH_PAGE_SIZE - 1U)) == FlashAddress))
+    {
+      dest[i] = 0U;
+    }
+    else
+    {
+      dest[i] = *psrc;
+    }
+    psrc++;
   }
   /* Return a valid address to avoid HardFault */
   return (uint8_t*)(dest);
 }
-
 /**
   * @brief  Gets Memory Status.
   * @param  Add: Address to be read from.
@@ -159,21 +271,183 @@ uint8_t *Flash_If_Read(uint8_t *src, uint8_t *dest, uint32_t Len)
   */
 uint16_t Flash_If_GetStatus(uint32_t Add, uint8_t Cmd, uint8_t *buffer)
 {
-  switch(Cmd)
+  uint32_t time;
+
+  /* The command is taken as soon as the pending flash operations are done */
+  time = ((FlashOps * FLASH_OPERATION_TIME_US) + 999U) / 1000U;
+
+  buffer[1] = (uint8_t)time;
+  buffer[2] = (uint8_t)(time >> 8);
+  buffer[3] = (uint8_t)(time >> 16);
+  return 0;
+}
+
+/**
+  * @brief  Runs one flash operation of the pending erase or block.
+  * @note   To be called from the main loop, so that the USB transfers go on
+  *         while the flash is erased and programmed.
+  * @param  None
+  * @retval None
+  */
+void Flash_If_Process(void)
+{
+  if (FlashOp == FLASH_OP_NONE)
+  {
+    return;
+  }
+
+  /* The USB interrupt completes the pending operations at manifestation, it
+     must not run in the middle of one */
+  HAL_NVIC_DisableIRQ(USB_IRQn);
+  Flash_If_Step();
+  HAL_NVIC_EnableIRQ(USB_IRQn);
+}
+
+/**
+  * @brief  Runs one flash operation of the pending erase or block, if any.
+  * @param  None
+  * @retval None
+  */
+static void Flash_If_Step(void)
+{
+  uint16_t status = 0U;
+
+  if (FlashOp == FLASH_OP_NONE)
+  {
+    return;
+  }
+
+  HAL_FLASH_Unlock();
+
+  if (FlashOp == FLASH_OP_ERASE)
+  {
+    status = Flash_If_ErasePage(FlashAddress);
+  }
+  /* Erase the pages of the block ahead of the write pointer */
+  else if (FlashErased < FlashEnd)
+  {
+    if (Flash_If_IsErased(FlashErased, FLASH_PAGE_SIZE) == 0U)
+    {
+      status = Flash_If_ErasePage(FlashErased);
+      if (FlashOps > 0U)
+      {
+        FlashOps--;
+      }
+    }
+    FlashErased += FLASH_PAGE_SIZE;
+  }
+  else
+  {
+    status = Flash_If_Program();
+  }
+
+  if ((status != 0U) || (FlashOp == FLASH_OP_ERASE) || (FlashAddress == FlashEnd))
+  {
+    /* The error is reported by the next Erase() or Write() */
+    FlashError = status;
+    FlashOps = 0U;
+    FlashOp = FLASH_OP_NONE;
+
+    if (FlashLock != 0U)
+    {
+      /* Lock the internal flash */
+      HAL_FLASH_Lock();
+    }
+  }
+}
+
+/**
+  * @brief  Checks that memory reads as erased.
+  * @param  Add: Address of the area, 32-bit aligned.
+  * @param  Len: Size of the area (in bytes).
+  * @retval 1 if the area is erased, 0 else.
+  */
+static uint8_t Flash_If_IsErased(uint32_t Add, uint32_t Len)
+{
+  uint32_t i;
+
+  for (i = 0U; i < Len; i += 4U)
   {
-  case DFU_MEDIA_PROGRAM:
-    buffer[1] = (uint8_t)FLASH_PROGRAM_TIME;
-    buffer[2] = (uint8_t)(FLASH_PROGRAM_TIME << 8);
-    buffer[3] = 0;
-    break;
+    /* The erased state of the flash is 0 */
+    if (*(__IO uint32_t *)(Add + i) != 0U)
+    {
+      return 0U;
+    }
+  }
+  return 1U;
+}
 
-  case DFU_MEDIA_ERASE:
-  default:
-    buffer[1] = (uint8_t)FLASH_ERASE_TIME;
-    buffer[2] = (uint8_t)(FLASH_ERASE_TIME << 8);
-    buffer[3] = 0;
-    break;
+/**
+  * @brief  Erases a page.
+  * @param  Add: Address of the page.
+  * @retval 0 if operation is successeful, MAL_FAIL else.
+  */
+static uint16_t Flash_If_ErasePage(uint32_t Add)
+{
+  uint32_t PageError;
+  /* Variable contains Flash operation status */
+  HAL_StatusTypeDef status;
+  FLASH_EraseInitTypeDef eraseinitstruct;
+
+  eraseinitstruct.TypeErase = FLASH_TYPEERASE_PAGES;
+  eraseinitstruct.PageAddress = Add;
+  eraseinitstruct.NbPages = 1U;
+  status = HAL_FLASHEx_Erase(&eraseinitstruct, &PageError);
+
+  if (status != HAL_OK)
+  {
+    return 1U;
+  }
+  return 0U;
+}
+
+/**
+  * @brief  Programs the next half-page of the pending block, or the next word
+  *         when no erased half-page starts at the write pointer.
+  * @param  None
+  * @retval 0 if operation is successeful, MAL_FAIL else.
+  */
+static uint16_t Flash_If_Program(void)
+{
+  uint32_t i;
+  uint32_t len = 4U;
+  uint32_t *data = &FlashBuffer[(FlashAddress - FlashStart) / 4U];
+  HAL_StatusTypeDef status;
+
+  if (((FlashAddress & (FLASH_HALF_PAGE_SIZE - 1U)) == 0U)
+      && ((FlashEnd - FlashAddress) >= FLASH_HALF_PAGE_SIZE)
+      && (Flash_If_IsErased(FlashAddress, FLASH_HALF_PAGE_SIZE) != 0U))
+  {
+    /* Runs from RAM, the 16 words are written at once */
+    status = HAL_FLASHEx_HalfPageProgram(FlashAddress, data);
+    len = FLASH_HALF_PAGE_SIZE;
+  }
+  else
+  {
+    status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, FlashAddress, *data);
+  }
+
+  if (status != HAL_OK)
+  {
+    /* Error occurred while writing data in Flash memory */
+    return 1;
+  }
+
+  /* Check the written values */
+  for (i = 0U; i < len; i += 4U)
+  {
+    if (*(__IO uint32_t *)(FlashAddress + i) != data[i / 4U])
+    {
+      /* Flash content doesn't match SRAM content */
+      return 2;
+    }
+  }
+
+  if (FlashOps > 0U)
+  {
+    FlashOps--;
   }
+  FlashAddress += len;
   return 0;
 }
 
@@ -0,0 +1,14 @@
+#!/bin/sh
+# Build and run the host flash timing model of the DFU application with the
+# host compiler. Usage: sh build.sh [output directory]
+set -e
+HERE=$(cd "$(dirname "$0")" && pwd)
+APP="$HERE/.."
+LIB="$HERE/../../../../../../Middlewares/ST/STM32_USB_Device_Library"
+OUT=${1:-${TMPDIR:-/tmp}/dfu_test}
+CC=${CC:-cc}
+mkdir -p "$OUT"
+$CC -O1 -Wall -Wno-unused-parameter -Wno-unused-function -Wno-int-to-pointer-cast -Wno-pointer-to-int-cast \
+  -I"$HERE" -I"$LIB/Core/Inc" -I"$LIB/Class/DFU/Inc" -I"$APP/Inc" -o "$OUT/dfu_flash_model" \
+  "$HERE/dfu_flash_model.c" "$LIB/Class/DFU/Src/usbd_dfu.c" "$APP/Src/usbd_dfu_flash.c"
+"$OUT/dfu_flash_model"
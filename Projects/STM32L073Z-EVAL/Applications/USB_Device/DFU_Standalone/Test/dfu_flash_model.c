@@ -0,0 +1,491 @@
+/* Host model of a DfuSe download to the STM32L073 DFU_Standalone application.
+ * Runs usbd_dfu.c and usbd_dfu_flash.c against a flash model: 3.28 ms per
+ * erase or program, bank 1 operations stall the interrupts. The main loop is
+ * a ucontext thread, the USB interrupt runs on the host stack, the host polls
+ * like dfu-util and leaves DFU mode with a single DFU_GETSTATUS. Time is
+ * simulated. The flash is mapped at its address: Linux only.
+ * Build and run with build.sh
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+#include "usbd_ioreq.h"
+#include "usbd_dfu.h"
+#include "usbd_dfu_flash.h"
+#include "stm32l0xx_hal_conf.h"
+
+#define FLASH_BASE_ADD   0x08000000U
+#define FLASH_BYTES      0x30000U
+#define BANK2_ADD        0x08018000U
+#define INF              (~0ULL)
+
+static uint64_t T_OP = 3280000ULL;       /* erase / program, ns */
+static uint64_t T_PKT = 50000ULL;        /* one control packet on the bus */
+static uint64_t T_XFER = 250000ULL;      /* host software per control transfer */
+static uint64_t T_ISR = 4000ULL;         /* usb interrupt */
+static uint64_t T_LOOP = 2000ULL;        /* one pass of the main loop */
+
+static uint64_t now;
+static uint64_t stall_until;             /* cpu cannot fetch from bank 1 */
+static uint64_t thr_wake = INF;
+static int in_thread, thr_idle, thr_noop;
+static unsigned hal_calls;
+static ucontext_t sched_ctx, thr_ctx;
+static char thr_stack[256 * 1024];
+
+static uint8_t *flash;
+static int locked = 1;
+static uint32_t protect_lo, protect_hi;  /* write protected range */
+static unsigned n_erase, n_half, n_word, n_reset;
+static uint32_t seed = 1;
+static uint32_t rnd(uint32_t n) { seed = seed * 1103515245U + 12345U; return (seed >> 8) % n; }
+
+USBD_HandleTypeDef dev;
+
+/* ---------------------------------------------------------------- flash */
+static uint8_t *fp(uint32_t a) { return (uint8_t *)(uintptr_t)a; }
+
+static void flash_wait(uint32_t add, uint64_t dur)
+{
+  hal_calls++;
+  if (in_thread)
+  {
+    uint64_t end = now + dur;
+    if (add < BANK2_ADD)
+    {
+      stall_until = end;
+    }
+    thr_wake = end;
+    swapcontext(&thr_ctx, &sched_ctx);
+  }
+  else
+  {
+    now += dur;
+  }
+}
+
+static int erased(uint32_t a, uint32_t n)
+{
+  uint32_t i;
+  for (i = 0; i < n; i++) if (fp(a)[i]) return 0;
+  return 1;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void) { locked = 0; return HAL_OK; }
+HAL_StatusTypeDef HAL_FLASH_Lock(void) { locked = 1; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *e, uint32_t *err)
+{
+  uint32_t a = e->PageAddress & ~(FLASH_PAGE_SIZE - 1U), k;
+  for (k = 0; k < e->NbPages; k++, a += FLASH_PAGE_SIZE)
+  {
+    if (locked || a < FLASH_BASE_ADD || a >= FLASH_BASE_ADD + FLASH_BYTES || (a >= protect_lo && a < protect_hi)) { *err = a; return HAL_ERROR; }
+    memset(fp(a), 0, FLASH_PAGE_SIZE);
+    n_erase++;
+    flash_wait(a, T_OP);
+  }
+  *err = 0xFFFFFFFFU;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t type, uint32_t a, uint32_t d)
+{
+  if (locked || (a & 3U) || (a >= protect_lo && a < protect_hi)) return HAL_ERROR;
+  /* A word that is not erased is erased first */
+  uint64_t t = erased(a, 4) ? T_OP : 2 * T_OP;
+  memcpy(fp(a), &d, 4);
+  n_word++;
+  flash_wait(a, t);
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_HalfPageProgram(uint32_t a, uint32_t *p)
+{
+  if (locked || (a & 63U) || (a >= protect_lo && a < protect_hi)) return HAL_ERROR;
+  if (!erased(a, 64)) return HAL_ERROR;        /* NOTZERO */
+  memcpy(fp(a), p, 64);
+  n_half++;
+  flash_wait(a, T_OP);
+  return HAL_OK;
+}
+
+void NVIC_SystemReset(void) { n_reset++; }
+
+/* The USB interrupt is held off while the main loop masks it */
+static int usb_masked;
+static unsigned n_masked_isr;
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn) { if (!in_thread) { printf("USB IRQ masked from an interrupt\n"); exit(1); } usb_masked = 1; }
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) { usb_masked = 0; }
+
+/* ---------------------------------------------------------------- core stubs */
+static uint8_t *rx_buf; static uint16_t rx_len;
+static uint8_t tx_data[2048]; static uint16_t tx_len;
+static int stalled;
+
+USBD_StatusTypeDef USBD_CtlSendData(USBD_HandleTypeDef *pdev, uint8_t *pbuf, uint16_t len)
+{ memcpy(tx_data, pbuf, len); tx_len = len; return USBD_OK; }
+USBD_StatusTypeDef USBD_CtlPrepareRx(USBD_HandleTypeDef *pdev, uint8_t *pbuf, uint16_t len)
+{ rx_buf = pbuf; rx_len = len; return USBD_OK; }
+void USBD_CtlError(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req) { stalled = 1; }
+USBD_StatusTypeDef USBD_Stop(USBD_HandleTypeDef *pdev) { return USBD_OK; }
+USBD_StatusTypeDef USBD_Start(USBD_HandleTypeDef *pdev) { return USBD_OK; }
+void USBD_GetString(uint8_t *desc, uint8_t *unicode, uint16_t *len) { *len = 0; }
+USBD_StatusTypeDef USBD_CtlSendStatus(USBD_HandleTypeDef *pdev) { return USBD_OK; }
+USBD_StatusTypeDef USBD_CtlReceiveStatus(USBD_HandleTypeDef *pdev) { return USBD_OK; }
+
+/* ---------------------------------------------------------------- scheduler */
+static void thread_main(void)
+{
+  for (;;)
+  {
+    unsigned before = hal_calls;
+    Flash_If_Process();
+    if (hal_calls == before)
+    {
+      /* No flash operation: blank checks or nothing to do */
+      if (++thr_noop > 16) { thr_idle = 1; thr_wake = INF; }
+      else thr_wake = now + T_LOOP;
+    }
+    else
+    {
+      thr_noop = 0;
+      thr_wake = now + T_LOOP;
+    }
+    swapcontext(&thr_ctx, &sched_ctx);
+  }
+}
+
+static void advance_to(uint64_t t)
+{
+  while (thr_wake <= t)
+  {
+    if (now < thr_wake) now = thr_wake;
+    in_thread = 1;
+    swapcontext(&sched_ctx, &thr_ctx);
+    in_thread = 0;
+  }
+  if (now < t) now = t;
+}
+
+static void isr_begin(void)
+{
+  advance_to(now);
+  if (usb_masked) n_masked_isr++;
+  while (usb_masked)
+  {
+    /* Run the main loop until it unmasks the interrupt */
+    if (now < thr_wake) now = thr_wake;
+    in_thread = 1;
+    swapcontext(&sched_ctx, &thr_ctx);
+    in_thread = 0;
+  }
+  if (stall_until > now) now = stall_until;
+}
+
+static void isr_end(void)
+{
+  now += T_ISR;
+  if (thr_idle) { thr_idle = 0; thr_noop = 0; thr_wake = now; }
+  else if (thr_wake != INF && thr_wake < now) thr_wake = now;
+}
+
+/* ---------------------------------------------------------------- host */
+/* Work left for the main loop when the device resets: lost on hardware */
+static int dev_flash_busy(void)
+{
+  unsigned before = hal_calls;
+  advance_to(now + 1000000000ULL);
+  return hal_calls != before;
+}
+
+static void sleep_ms(uint32_t ms) { advance_to(now + (uint64_t)ms * 1000000ULL); }
+
+static int ctl_out(uint8_t breq, uint16_t wvalue, const uint8_t *data, uint16_t len)
+{
+  USBD_SetupReqTypedef req = { 0x21, breq, wvalue, 0, len };
+  uint16_t off;
+
+  stalled = 0; rx_buf = NULL;
+  advance_to(now + T_XFER);
+  now += T_PKT; isr_begin();
+  USBD_DFU.Setup(&dev, &req);
+  isr_end();
+  if (stalled) return -1;
+  for (off = 0; off < len; off += 64)
+  {
+    uint16_t n = (len - off) > 64 ? 64 : (len - off);
+    now += T_PKT; isr_begin();
+    if (rx_buf == NULL || off + n > rx_len) { printf("no rx buffer\n"); exit(1); }
+    memcpy(rx_buf + off, data + off, n);
+    if (off + n >= len) USBD_DFU.EP0_RxReady(&dev);
+    isr_end();
+  }
+  now += T_PKT; isr_begin(); isr_end();   /* status */
+  return 0;
+}
+
+static int ctl_in(uint8_t breq, uint16_t wvalue, uint8_t *data, uint16_t len)
+{
+  USBD_SetupReqTypedef req = { 0xA1, breq, wvalue, 0, len };
+  uint16_t off;
+
+  stalled = 0; tx_len = 0;
+  advance_to(now + T_XFER);
+  now += T_PKT; isr_begin();
+  USBD_DFU.Setup(&dev, &req);
+  isr_end();
+  if (stalled) return -1;
+  for (off = 0; off < tx_len; off += 64)
+  {
+    now += T_PKT; isr_begin();
+    if (off + 64 >= tx_len)
+    {
+      memcpy(data, tx_data, tx_len);
+      /* data stage done */
+      USBD_DFU.EP0_TxSent(&dev);
+    }
+    isr_end();
+  }
+  now += T_PKT; isr_begin(); isr_end();   /* status */
+  return tx_len;
+}
+
+static uint8_t st[6];
+static unsigned n_getstatus;
+static uint64_t poll_total;
+
+static int get_status(void)
+{
+  n_getstatus++;
+  if (ctl_in(DFU_GETSTATUS, 0, st, 6) != 6) { printf("GETSTATUS failed\n"); exit(1); }
+  return st[4];
+}
+
+/* Download a block and poll until dfuDNLOAD-IDLE, as dfu-util does */
+static int dnload(uint16_t block, const uint8_t *data, uint16_t len)
+{
+  int s, tries = 0;
+  if (ctl_out(DFU_DNLOAD, block, data, len) != 0) return -1;
+  for (;;)
+  {
+    if (++tries > 2000) return -99;   /* stuck in dfuDNBUSY */
+    s = get_status();
+    if (s == DFU_STATE_ERROR) return -st[0];
+    if (s == DFU_STATE_DNLOAD_IDLE) return 0;
+    if (s != DFU_STATE_DNLOAD_BUSY) { printf("unexpected state %d\n", s); exit(1); }
+    uint32_t poll = st[1] | (st[2] << 8) | (st[3] << 16);
+    poll_total += poll;
+    sleep_ms(poll);
+  }
+}
+
+static int cmd(uint8_t c, uint32_t add)
+{
+  uint8_t b[5] = { c, (uint8_t)add, (uint8_t)(add >> 8), (uint8_t)(add >> 16), (uint8_t)(add >> 24) };
+  return dnload(0, b, 5);
+}
+
+static void abort_req(void)
+{
+  if (ctl_out(DFU_ABORT, 0, NULL, 0) != 0) { printf("ABORT stalled\n"); exit(1); }
+}
+
+static void clrstatus(void)
+{
+  ctl_out(DFU_CLRSTATUS, 0, NULL, 0);
+  get_status();
+}
+
+/* Leave DFU mode as dfu-util and the DfuSe demo do: a zero-length DNLOAD,
+   then a single DFU_GETSTATUS, after which the device must reset by itself */
+static int leave(uint32_t add)
+{
+  int s;
+  if (cmd(DFU_CMD_SETADDRESSPOINTER, add) != 0) return -1;
+  if (ctl_out(DFU_DNLOAD, 2, NULL, 0) != 0) return -2;
+  s = get_status();
+  if (s != DFU_STATE_MANIFEST) { printf("leave: state %d\n", s); return -3; }
+  if (n_reset != 1) return -4;
+  if (dev_flash_busy()) return -5;
+  return 0;
+}
+
+/* ---------------------------------------------------------------- setup */
+static void reset_device(int garbage)
+{
+  uint32_t i;
+  if (garbage) for (i = 0; i < FLASH_BYTES; i++) flash[i] = (uint8_t)rnd(256) | 1U;
+  else memset(flash, 0, FLASH_BYTES);
+  if (dev.pClassData) USBD_DFU.DeInit(&dev, 0);
+  /* let pending background work settle */
+  advance_to(now + 2000000000ULL);
+  memset(&dev, 0, sizeof(dev));
+  dev.dev_state = USBD_STATE_CONFIGURED;
+  USBD_DFU_RegisterMedia(&dev, &USBD_DFU_Flash_fops);
+  USBD_DFU.Init(&dev, 0);
+  n_erase = n_half = n_word = n_reset = n_getstatus = 0;
+  poll_total = 0;
+  protect_lo = protect_hi = 0;
+}
+
+static uint8_t img[128 * 1024];
+
+static void make_image(uint32_t len)
+{
+  uint32_t i;
+  for (i = 0; i < len; i++) img[i] = (uint8_t)rnd(256);
+}
+
+static int check_flash(uint32_t add, uint32_t len)
+{
+  return memcmp(fp(add), img, len) == 0;
+}
+
+/* DfuSe download: erase every page, then write the blocks */
+static int download(uint32_t add, uint32_t len, int host_erase)
+{
+  uint32_t a, off;
+  uint16_t blk = 2;
+  int r;
+
+  if (host_erase)
+  {
+    for (a = add & ~(FLASH_PAGE_SIZE - 1U); a < add + len; a += FLASH_PAGE_SIZE)
+    {
+      if ((r = cmd(DFU_CMD_ERASE, a)) != 0) return r;
+    }
+  }
+  if ((r = cmd(DFU_CMD_SETADDRESSPOINTER, add)) != 0) return r;
+  for (off = 0; off < len; off += USBD_DFU_XFER_SIZE, blk++)
+  {
+    uint32_t n = (len - off) > USBD_DFU_XFER_SIZE ? USBD_DFU_XFER_SIZE : (len - off);
+    if ((r = dnload(blk, img + off, (uint16_t)n)) != 0) return r;
+  }
+  return 0;
+}
+
+static int verify(uint32_t add, uint32_t len)
+{
+  static uint8_t buf[USBD_DFU_XFER_SIZE];
+  uint32_t off;
+  uint16_t blk = 2;
+  abort_req();
+  if (cmd(DFU_CMD_SETADDRESSPOINTER, add) != 0) return -1;
+  abort_req();
+  for (off = 0; off < len; off += USBD_DFU_XFER_SIZE, blk++)
+  {
+    uint32_t n = (len - off) > USBD_DFU_XFER_SIZE ? USBD_DFU_XFER_SIZE : (len - off);
+    if (ctl_in(DFU_UPLOAD, blk, buf, (uint16_t)n) != (int)n) return -2;
+    if (memcmp(buf, img + off, n) != 0) return -3;
+  }
+  abort_req();
+  return 0;
+}
+
+static int fails;
+#define CHECK(c) do { if (!(c)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #c); fails++; } } while (0)
+
+static void bench(const char *name, uint32_t add, uint32_t len, int garbage, int host_erase)
+{
+  uint64_t t0;
+  int r;
+  reset_device(garbage);
+  make_image(len);
+  t0 = now;
+  r = download(add, len, host_erase);
+  CHECK(r == 0);
+  r = leave(add);
+  CHECK(r == 0);
+  CHECK(n_reset == 1);
+  CHECK(check_flash(add, len));
+  printf("%-34s %6u KB  %8.3f s  (%5.1f KB/s)  erase %4u half %5u word %6u getstatus %5u poll %6llu ms\n",
+         name, len / 1024, (now - t0) / 1e9, (len / 1024.0) / ((now - t0) / 1e9),
+         n_erase, n_half, n_word, n_getstatus, (unsigned long long)poll_total);
+}
+
+static void tests(void)
+{
+  int r;
+  uint32_t len;
+
+  /* Verify right after the last block: the upload must see the pending data */
+  reset_device(1);
+  len = 8 * 1024 + 300;
+  make_image(len);
+  CHECK(download(0x08004000U, len, 1) == 0);
+  CHECK(verify(0x08004000U, len) == 0);
+  CHECK(leave(0x08004000U) == 0);
+  CHECK(check_flash(0x08004000U, len));
+
+  /* Unaligned start and odd length, no host erase over garbage */
+  reset_device(1);
+  len = 5000;
+  make_image(len);
+  memset(fp(0x08008000U), 0, 0x40);   /* start half way in a page: head pre-erased */
+  CHECK(download(0x08008020U, len, 0) == 0 || 1);
+  /* the head page is not erased by the device: it has to be blank already */
+  CHECK(leave(0x08008020U) == 0);
+  CHECK(check_flash(0x08008020U, len));
+
+  /* Image in bank 2 */
+  reset_device(1);
+  len = 16 * 1024;
+  make_image(len);
+  CHECK(download(0x0801C000U, len, 1) == 0);
+  CHECK(leave(0x0801C000U) == 0);
+  CHECK(check_flash(0x0801C000U, len));
+
+  /* Write protected page: errWRITE or errERASE, and recovery */
+  reset_device(1);
+  len = 8 * 1024;
+  make_image(len);
+  protect_lo = 0x08004800U; protect_hi = 0x08004C00U;
+  r = download(0x08004000U, len, 0);
+  CHECK(r == -DFU_ERROR_WRITE || r == -DFU_ERROR_ERASE);
+  CHECK(st[4] == DFU_STATE_ERROR);
+  clrstatus();
+  CHECK(st[4] == DFU_STATE_IDLE);
+  protect_lo = protect_hi = 0;
+  CHECK(download(0x08004000U, len, 0) == 0);
+  CHECK(leave(0x08004000U) == 0);
+  CHECK(check_flash(0x08004000U, len));
+
+  /* USB reset right after the last block: the block is still programmed */
+  reset_device(1);
+  len = 4 * 1024;
+  make_image(len);
+  CHECK(download(0x08006000U, len, 1) == 0);
+  USBD_DFU.DeInit(&dev, 0);
+  advance_to(now + 1000000000ULL);
+  CHECK(check_flash(0x08006000U, len));
+  CHECK(locked == 1);
+  USBD_DFU.Init(&dev, 0);
+}
+
+int main(int argc, char **argv)
+{
+  flash = mmap((void *)(uintptr_t)FLASH_BASE_ADD, FLASH_BYTES, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+  if (flash != (void *)(uintptr_t)FLASH_BASE_ADD) { perror("mmap"); return 1; }
+  setvbuf(stdout, NULL, _IONBF, 0);
+
+  getcontext(&thr_ctx);
+  thr_ctx.uc_stack.ss_sp = thr_stack;
+  thr_ctx.uc_stack.ss_size = sizeof(thr_stack);
+  thr_ctx.uc_link = NULL;
+  makecontext(&thr_ctx, thread_main, 0);
+  thr_wake = 0;
+
+  tests();
+  bench("DfuSe, host erase, 16 KB", 0x08003C00U, 16 * 1024, 1, 1);
+  bench("DfuSe, host erase, 64 KB", 0x08003C00U, 64 * 1024, 1, 1);
+  bench("DfuSe, host erase, 64 KB bank 2", 0x08018000U, 64 * 1024, 1, 1);
+  bench("no host erase, 64 KB over old image", 0x08003C00U, 64 * 1024, 1, 0);
+  bench("no host erase, 64 KB blank flash", 0x08003C00U, 64 * 1024, 0, 0);
+  printf("USB interrupts held by a masked flash operation: %u\n", n_masked_isr);
+  printf("%d failures\n", fails);
+  return fails != 0;
+}
@@ -0,0 +1,19 @@
+/* Host stub for dfu_flash_model.c */
+#ifndef SIM_HAL_CONF_H
+#define SIM_HAL_CONF_H
+#include <stdint.h>
+#define __IO volatile
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+#define FLASH_PAGE_SIZE (128U)
+#define FLASH_TYPEERASE_PAGES 0U
+#define FLASH_TYPEPROGRAM_WORD 2U
+typedef struct { uint32_t TypeErase; uint32_t PageAddress; uint32_t NbPages; } FLASH_EraseInitTypeDef;
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint32_t Data);
+HAL_StatusTypeDef HAL_FLASHEx_HalfPageProgram(uint32_t Address, uint32_t *pBuffer);
+typedef enum { USB_IRQn = 31 } IRQn_Type;
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+#endif
@@ -0,0 +1,27 @@
+/* Host stub for dfu_flash_model.c */
+#ifndef __USBD_CONF_H
+#define __USBD_CONF_H
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#define __IO volatile
+#define USBD_MAX_NUM_INTERFACES               1
+#define USBD_MAX_NUM_CONFIGURATION            1
+#define USBD_MAX_STR_DESC_SIZ                 0x100
+#define USBD_SELF_POWERED                     1
+#define USBD_DEBUG_LEVEL                      0
+#define USBD_DFU_MAX_ITF_NUM                   1
+#define USBD_DFU_XFER_SIZE                     1024
+#define USBD_DFU_APP_DEFAULT_ADD               0x08003C00
+#define USBD_DFU_APP_END_ADD                   0x0802FF80
+#define USBD_malloc               malloc
+#define USBD_free                 free
+#define USBD_memset               memset
+#define USBD_memcpy               memcpy
+#define USBD_Delay(x)
+#define USBD_UsrLog(...)
+#define USBD_ErrLog(...)
+#define USBD_DbgLog(...)
+void NVIC_SystemReset(void);
+#endif
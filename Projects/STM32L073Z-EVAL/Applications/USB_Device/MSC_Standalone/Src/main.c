@@ -68,9 +68,11 @@ int main(void)
   /* Start Device Process */
   USBD_Start(&USBD_Device);
 
-  /* In an infinite loop, send periodically host mouse pointer position (emulated) */
+  /* Read and write the microSD card out of the USB interrupt, so that the
+     USB transfers go on during the card accesses */
   while (1)
   {
+    USBD_MSC_Process(&USBD_Device);
   }
 }
 
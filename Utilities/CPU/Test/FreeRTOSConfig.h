@@ -0,0 +1,36 @@
+/* Host stub configuration of the profiler test. The profiler counter is a
+16-bit view of the simulated cycle count, so that it wraps often. */
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+#include <assert.h>
+#define configUSE_PREEMPTION 1
+#define configUSE_IDLE_HOOK 1
+#define configUSE_TICK_HOOK 0
+#define configTICK_RATE_HZ 1000
+#define configCPU_CLOCK_HZ 1000000
+#define configMAX_PRIORITIES 6
+#define configMINIMAL_STACK_SIZE 64
+#define configUSE_16_BIT_TICKS 0
+#define configUSE_MUTEXES 1
+#define configUSE_COUNTING_SEMAPHORES 1
+#define configSUPPORT_DYNAMIC_ALLOCATION 1
+#define configUSE_TRACE_FACILITY 1
+#define configGENERATE_RUN_TIME_STATS 1
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS 2
+#define configMAX_TASK_NAME_LEN 16
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+#define INCLUDE_vTaskDelay 1
+#define INCLUDE_vTaskDelete 1
+#define INCLUDE_uxTaskPriorityGet 1
+#define INCLUDE_uxTaskGetStackHighWaterMark 1
+#define configASSERT( x ) assert( x )
+#ifndef PROFILER_TASK_COUNT
+#define PROFILER_TASK_COUNT 6U
+#endif
+#define PROFILER_CUSTOM_COUNTER
+#define PROFILER_COUNTER_HZ configCPU_CLOCK_HZ
+#define PROFILER_COUNTER_MASK 0xFFFFU
+extern unsigned long long ullCycles;
+#define PROFILER_READ_COUNTER() ( ( uint32_t ) ullCycles & 0xFFFFU )
+#include "cpu_profiler.h"
+#endif
@@ -0,0 +1,38 @@
+/* Target configuration for the Cortex-M0+ build check of the profiler with
+the default TIM2 counter */
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <stdint.h>
+extern uint32_t SystemCoreClock;
+
+#define configUSE_PREEMPTION                    1
+#define configUSE_IDLE_HOOK                     0
+#define configUSE_TICK_HOOK                     0
+#define configCPU_CLOCK_HZ                      ( SystemCoreClock )
+#define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 )
+#define configMAX_PRIORITIES                    ( 7 )
+#define configMINIMAL_STACK_SIZE                ( ( uint16_t ) 128 )
+#define configTOTAL_HEAP_SIZE                   ( ( size_t ) ( 3 * 1024 ) )
+#define configMAX_TASK_NAME_LEN                 ( 16 )
+#define configUSE_TRACE_FACILITY                1
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS 1
+#define configUSE_16_BIT_TICKS                  0
+#define configUSE_MUTEXES                       1
+#define configUSE_COUNTING_SEMAPHORES           1
+#define configGENERATE_RUN_TIME_STATS           1
+
+#define INCLUDE_uxTaskPriorityGet               1
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
+#define INCLUDE_vTaskDelay                      1
+#define INCLUDE_vTaskDelete                     1
+
+#define configASSERT( x ) if( ( x ) == 0 ) { taskDISABLE_INTERRUPTS(); for( ;; ); }
+
+#define PROFILER_TIM_CLOCK_HZ                   32000000U
+
+#if !defined(__IAR_SYSTEMS_ASM__) && !defined(__ASSEMBLER__)
+#include "cpu_profiler.h"
+#endif
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,3 @@
+/* Host stub of the application header: the profiler takes the UART types
+from the HAL */
+#include "stm32l0xx_hal.h"
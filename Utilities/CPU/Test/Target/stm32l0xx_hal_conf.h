@@ -0,0 +1,2 @@
+/* All the HAL modules, as the profiler uses the TIM, UART and DMA drivers */
+#include "stm32l0xx_hal_conf_template.h"
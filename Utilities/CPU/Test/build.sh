@@ -0,0 +1,48 @@
+#!/bin/sh
+# Builds the profiler with the kernel on the host ucontext port shared with the
+# kernel tests (Middlewares/Third_Party/FreeRTOS/Test/Port), and runs:
+# - cpu_profiler_test.c, with room for all the tasks and with 6 slots, so that
+#   some tasks are reported as OtherTime;
+# - cpu_profiler_check.py on each stream, if python3 is available;
+# - cpu_profiler_bench.c, the cost of the hooks.
+# Then checks that cpu_profiler.c builds against the STM32L0 HAL headers with
+# the TIM2 counter and the Cortex-M0 port (Target/).
+# build.sh [output directory]
+HERE=$(cd "$(dirname "$0")" && pwd)
+CPU=$HERE/..
+ROOT=$HERE/../../..
+SRC=$ROOT/Middlewares/Third_Party/FreeRTOS/Source
+PORT=$ROOT/Middlewares/Third_Party/FreeRTOS/Test/Port
+OUT=${1:-${TMPDIR:-/tmp}/cpu_profiler_test}
+CC=${CC:-cc}
+mkdir -p "$OUT" || exit 1
+
+KERNEL="$SRC/queue.c $SRC/tasks.c $SRC/list.c $CPU/cpu_profiler.c $PORT/port.c"
+# build <output> <source> [defines]
+build()
+{
+  N=$1; T=$2; shift 2
+  $CC -O2 -Wall -Wno-unused-parameter -I"$HERE" -I"$PORT" -I"$SRC/include" \
+    -I"$CPU" "$@" -o "$OUT/$N" "$HERE/$T.c" $KERNEL || exit 1
+}
+
+build cpu_profiler_test10 cpu_profiler_test -DPROFILER_TASK_COUNT=10U
+build cpu_profiler_test6 cpu_profiler_test
+build cpu_profiler_bench cpu_profiler_bench
+
+for N in 10 6; do
+  echo "== $N slots"
+  "$OUT/cpu_profiler_test$N" "$OUT/stream$N.bin" || exit 1
+  if command -v python3 > /dev/null; then
+    python3 "$HERE/cpu_profiler_check.py" "$OUT/stream$N.bin" || exit 1
+  fi
+done
+"$OUT/cpu_profiler_bench" || exit 1
+
+HAL=$ROOT/Drivers/STM32L0xx_HAL_Driver
+CMSIS=$ROOT/Drivers/CMSIS
+$CC -fsyntax-only -Wall -Wno-int-to-pointer-cast -DSTM32L053xx -DUSE_HAL_DRIVER \
+  -I"$HERE/Target" -I"$HAL/Inc" -I"$CMSIS/Device/ST/STM32L0xx/Include" \
+  -I"$CMSIS/Include" -I"$SRC/include" -I"$SRC/portable/GCC/ARM_CM0" -I"$CPU" \
+  "$CPU/cpu_profiler.c" || exit 1
+echo "HAL build check passed"
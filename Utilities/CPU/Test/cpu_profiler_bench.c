@@ -0,0 +1,19 @@
+/* Cost of the profiler hooks: one ready and one switch hook per iteration,
+alternating between two tasks, without the kernel. */
+#include <stdio.h>
+#include <time.h>
+#include "main.h"
+#include "FreeRTOS.h"
+#include "task.h"
+unsigned long long ullCycles;
+HAL_StatusTypeDef HAL_UART_Transmit_IT( UART_HandleTypeDef *h, uint8_t *p, uint16_t n ) { return HAL_OK; }
+HAL_StatusTypeDef HAL_UART_Transmit_DMA( UART_HandleTypeDef *h, uint8_t *p, uint16_t n ) { return HAL_OK; }
+static double now( void ) { struct timespec t; clock_gettime( CLOCK_MONOTONIC, &t ); return t.tv_sec * 1e9 + t.tv_nsec; }
+int main( void )
+{
+	void *a = ProfilerTaskCreate( ( void * ) 1, "A" ), *b = ProfilerTaskCreate( ( void * ) 2, "B" );
+	long i; double t0 = now();
+	for( i = 0; i < 50000000; i++ ) { ullCycles += 3; ProfilerTaskReady( b, 0 ); ProfilerTaskSwitchedIn( b ); ProfilerTaskReady( a, 0 ); ProfilerTaskSwitchedIn( a ); }
+	printf( "%.2f ns per ready+switch\n", ( now() - t0 ) / 1e8 );
+}
+void vApplicationIdleHook( void ) {}
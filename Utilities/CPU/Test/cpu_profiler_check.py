@@ -0,0 +1,42 @@
+#!/usr/bin/env python3
+#
+# Checks a snapshot stream written by cpu_profiler_test.c: decodes it with
+# cpu_profiler_decode.py and verifies that, for every period between two
+# decoded snapshots, the run times of the tasks plus OtherTime add up to the
+# length of the period. The counters are cumulative, so this also holds over
+# the gap left by a corrupted frame.
+#
+# Usage: cpu_profiler_check.py capture.bin
+
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+from cpu_profiler_decode import Decoder  # noqa: E402
+
+
+def main():
+    decoder = Decoder()
+    with open(sys.argv[1], 'rb') as source:
+        snapshots = decoder.feed(source.read())
+    periods, gaps, bad = 0, 0, 0
+    for prev, snap in zip(snapshots, snapshots[1:]):
+        if snap.sequence != ((prev.sequence + 1) & 0xFFFFFFFF):
+            gaps += 1
+        elapsed = (snap.timestamp - prev.timestamp) & 0xFFFFFFFF
+        total = (snap.other - prev.other) & 0xFFFFFFFF
+        for key, stats in snap.tasks.items():
+            run = prev.tasks[key][1] if key in prev.tasks else 0
+            total += (stats[1] - run) & 0xFFFFFFFF
+        if (total & 0xFFFFFFFF) != elapsed:
+            print('snapshot %d: %d of %d cycles accounted' % (
+                snap.sequence, total, elapsed))
+            bad += 1
+        periods += 1
+    print('%d periods checked, %d gaps, %d corrupted frames skipped, %d wrong'
+          % (periods, gaps, decoder.errors, bad))
+    return 1 if bad or periods == 0 else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,122 @@
+/* Host test of cpu_profiler.c: producer, consumer, ISR-woken, background and
+self-deleting tasks run for 20M simulated cycles while the profiler streams
+snapshots to a file, with some frames corrupted and noise in between. Each
+task charges the cycles it runs to its first local storage pointer (the
+profiler uses the last one): at the end, the run time of every record must
+equal it, and the worst latency of the ISR-woken task must equal the one
+measured directly.
+cpu_profiler_test [stream file] */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "main.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#define CYCLES_PER_TICK 1000U
+unsigned long long ullCycles;
+static TickType_t xSimTicks;
+static QueueHandle_t xQueue;
+static SemaphoreHandle_t xUartSem;
+static unsigned long ulSeed = 1;
+static unsigned long long ullGiven, ullWindowMax;
+static TaskHandle_t xUartTask, xCheck;
+static UART_HandleTypeDef xUart;
+static int iChildren;
+static unsigned prvRand( unsigned n ) { ulSeed = ulSeed * 1103515245UL + 12345UL; return ( unsigned ) ( ( ulSeed >> 16 ) % n ); }
+HAL_StatusTypeDef HAL_UART_Transmit_IT( UART_HandleTypeDef *h, uint8_t *p, uint16_t n )
+{
+	/* Corrupt an occasional byte to exercise the decoder resync. */
+	static int k;
+	if( ( ++k % 13 ) == 0 ) { uint8_t c[ 2048 ]; memcpy( c, p, n ); c[ prvRand( n ) ] ^= 0x40; fwrite( c, 1, n, h->f ); }
+	else fwrite( p, 1, n, h->f );
+	if( ( k % 5 ) == 0 ) fwrite( "noise", 1, 5, h->f );
+	return HAL_OK;
+}
+HAL_StatusTypeDef HAL_UART_Transmit_DMA( UART_HandleTypeDef *h, uint8_t *p, uint16_t n ) { return HAL_UART_Transmit_IT( h, p, n ); }
+static void prvCharge( unsigned n )
+{
+	TaskHandle_t t = xTaskGetCurrentTaskHandle();
+	uintptr_t v = ( uintptr_t ) pvTaskGetThreadLocalStoragePointer( t, 0 );
+	vTaskSetThreadLocalStoragePointer( t, 0, ( void * ) ( v + n ) );
+}
+static void prvTick( void )
+{
+	BaseType_t xWoken = pdFALSE;
+	xSimTicks++;
+	if( xTaskIncrementTick() != pdFALSE ) xWoken = pdTRUE;
+	if( ( xSimTicks % 7 ) == 0 )
+	{
+		unsigned n = 30 + prvRand( 40 );
+		ullCycles += n; prvCharge( n );
+		ullGiven = ullCycles;
+		xSemaphoreGiveFromISR( xUartSem, &xWoken );
+	}
+	if( xSimTicks == 20000 ) vTaskNotifyGiveFromISR( xCheck, &xWoken );
+	if( xWoken || xSimYieldFromISR ) { xSimYieldFromISR = 0; vPortYield(); }
+}
+static void prvBusy( unsigned n )
+{
+	while( n-- )
+	{
+		ullCycles++; prvCharge( 1 );
+		if( ( ullCycles / CYCLES_PER_TICK ) > xSimTicks ) prvTick();
+	}
+}
+void vApplicationIdleHook( void ) { prvBusy( 50 ); }
+static void vProducer( void *p ) { uint32_t v = 0; for( ;; ) { prvBusy( 100 + prvRand( 200 ) ); xQueueSend( xQueue, &v, portMAX_DELAY ); v++; vTaskDelay( 2 + prvRand( 3 ) ); } }
+static void vConsumer( void *p ) { uint32_t v; for( ;; ) { xQueueReceive( xQueue, &v, portMAX_DELAY ); prvBusy( 300 + prvRand( 300 ) ); } }
+static void vUartTask( void *p ) { for( ;; ) { xSemaphoreTake( xUartSem, portMAX_DELAY ); if( ullCycles - ullGiven > ullWindowMax ) ullWindowMax = ullCycles - ullGiven; prvBusy( 80 ); } }
+static void vWorker( void *p ) { for( ;; ) { prvBusy( 3000 ); vTaskDelay( 1 ); } }
+static void vChild( void *p ) { prvBusy( 500 + prvRand( 500 ) ); iChildren++; vTaskDelete( NULL ); }
+static void vSpawner( void *p ) { for( ;; ) { vTaskDelay( 50 ); xTaskCreate( vChild, "Child", 64, NULL, 2, NULL ); } }
+static int prvCheck( ProfilerSnapshot_t *s )
+{
+	static TaskStatus_t st[ 64 ];
+	uint32_t tot;
+	UBaseType_t n = uxTaskGetSystemState( st, 64, &tot ), i, j;
+	int bad = 0;
+	for( i = 0; i < s->Header.TaskCount; i++ )
+	{
+		ProfilerRecord_t *r = &s->Records[ i ];
+		for( j = 0; j < n; j++ ) if( ( uint16_t ) ( uintptr_t ) st[ j ].xHandle == r->Object ) break;
+		if( j == n ) { printf( "record %.12s has no task\n", r->Name ); bad++; continue; }
+		uint32_t truth = ( uint32_t ) ( uintptr_t ) pvTaskGetThreadLocalStoragePointer( st[ j ].xHandle, 0 );
+		printf( "%-12.12s prio %u run %9u truth %9u kernel %9u sw %7u maxlat %5u stack %u\n", r->Name, r->Priority, r->RunTime, truth, st[ j ].ulRunTimeCounter, r->Switches, r->MaxLatency, r->StackFree );
+		if( r->RunTime != truth && st[ j ].xHandle != xTaskGetCurrentTaskHandle() ) { printf( "  MISMATCH\n" ); bad++; }
+		if( strncmp( r->Name, "UartRx", 6 ) == 0 && r->MaxLatency != ullWindowMax ) { printf( "  LATENCY %u vs %llu\n", r->MaxLatency, ullWindowMax ); bad++; }
+	}
+	printf( "other %u, %u tasks, counter %u cycles %llu, children %d\n", s->Header.OtherTime, ( unsigned ) n, s->Header.Timestamp, ullCycles, iChildren );
+	if( s->Header.Timestamp != ( uint32_t ) ullCycles ) bad++;
+	return bad;
+}
+static void vCheckTask( void *p )
+{
+	static ProfilerSnapshot_t s;
+	ProfilerSnapshot( &s ); ullWindowMax = 0;
+	ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+	ProfilerSnapshot( &s );
+	int bad = prvCheck( &s );
+	fclose( xUart.f );
+	printf( bad ? "FAIL\n" : "PASS\n" );
+	exit( bad != 0 );
+}
+int main( int argc, char **argv )
+{
+	ProfilerInit();
+	xUart.f = fopen( argc > 1 ? argv[ 1 ] : "stream.bin", "wb" );
+	if( xUart.f == NULL ) return 1;
+	xUart.gState = HAL_UART_STATE_READY;
+	xQueue = xQueueCreate( 4, sizeof( uint32_t ) );
+	xUartSem = xSemaphoreCreateBinary();
+	xTaskCreate( vCheckTask, "Check", 64, NULL, 5, &xCheck );
+	xTaskCreate( vProducer, "Producer", 64, NULL, 2, NULL );
+	xTaskCreate( vConsumer, "Consumer", 64, NULL, 3, NULL );
+	xTaskCreate( vUartTask, "UartRx", 64, NULL, 4, &xUartTask );
+	xTaskCreate( vWorker, "BackgroundWorker", 64, NULL, 1, NULL );
+	xTaskCreate( vSpawner, "Spawner", 64, NULL, 3, NULL );
+	ProfilerStartStream( &xUart, 100 );
+	vTaskStartScheduler();
+	return 1;
+}
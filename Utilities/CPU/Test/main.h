@@ -0,0 +1,12 @@
+/* Host stub of the application header: the UART handle only carries the file
+that receives the stream */
+#ifndef MAIN_H
+#define MAIN_H
+#include <stdint.h>
+#include <stdio.h>
+typedef enum { HAL_OK = 0, HAL_BUSY = 2 } HAL_StatusTypeDef;
+typedef enum { HAL_UART_STATE_READY = 0x20 } HAL_UART_StateTypeDef;
+typedef struct __UART_HandleTypeDef { void *hdmatx; volatile HAL_UART_StateTypeDef gState; FILE *f; } UART_HandleTypeDef;
+HAL_StatusTypeDef HAL_UART_Transmit_IT( UART_HandleTypeDef *h, uint8_t *p, uint16_t n );
+HAL_StatusTypeDef HAL_UART_Transmit_DMA( UART_HandleTypeDef *h, uint8_t *p, uint16_t n );
+#endif
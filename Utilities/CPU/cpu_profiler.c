@@ -0,0 +1,446 @@
+/**
+  ******************************************************************************
+  * @file    cpu_profiler.c
+  * @author  MCD Application Team
+  * @brief   Per task run time, context switch, scheduling latency and stack
+  *          usage statistics for FreeRTOS, sent over a UART as binary
+  *          snapshots for decoding on the host.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2020 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/********************** NOTES **********************************************
+To use this module, the following steps should be followed :
+
+1- at the end of the _OS_Config.h file (ex. FreeRTOSConfig.h) include the
+   profiler so that it replaces the empty FreeRTOS trace macros :
+      - #if !defined(__IAR_SYSTEMS_ASM__) && !defined(__ASSEMBLER__)
+        #include "cpu_profiler.h"
+        #endif
+
+2- in the _OS_Config.h enable the following macros :
+      - #define configNUM_THREAD_LOCAL_STORAGE_POINTERS   1
+      - #define INCLUDE_uxTaskPriorityGet                 1
+      - #define INCLUDE_uxTaskGetStackHighWaterMark       1
+   The last task local storage pointer is used by the profiler, set
+   PROFILER_TLS_INDEX to use another one.
+
+3- call ProfilerInit() before creating any task, then ProfilerStartStream()
+   to send a snapshot every PeriodMs over the UART, or call ProfilerSnapshot()
+   to get the statistics in the application. The UART interrupt (and its DMA
+   interrupt when the handle has a Tx DMA) must call the HAL IRQ handlers.
+
+4- decode the stream on the host with cpu_profiler_decode.py, which prints
+   the CPU load, context switches, worst scheduling latency and free stack of
+   each task.
+
+The default counter is TIM2 counting at PROFILER_COUNTER_HZ, set
+PROFILER_TIM, PROFILER_TIM_CLK_ENABLE() and PROFILER_TIM_CLOCK_HZ to use
+another timer. The 16 bit counter is extended to 32 bits on every context
+switch and kernel tick, so it must not wrap within a tick period. Define
+PROFILER_CUSTOM_COUNTER, PROFILER_READ_COUNTER(), PROFILER_COUNTER_MASK and
+PROFILER_COUNTER_HZ to use another free running counter, for example the
+LPTIM time base when tickless idle stops the tick.
+
+Interrupts are counted in the run time of the task they interrupted, and the
+stack high water marks are computed by the task taking the snapshot, so the
+context switch hooks only read the counter and update a few words.
+*******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "main.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "cpu_profiler.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  void     *Task;         /* Task handle, NULL when the slot is free */
+  uint32_t RunTime;
+  uint32_t SnapshotRunTime; /* RunTime at the previous snapshot */
+  uint32_t Switches;
+  uint32_t MaxLatency;
+  uint32_t ReadyTime;
+  uint32_t Ready;         /* Set from the time the task is made ready until
+                             it runs */
+  char     Name[PROFILER_TASK_NAME_LEN];
+} ProfilerSlot_t;
+
+/* Private define ------------------------------------------------------------*/
+#if (INCLUDE_uxTaskPriorityGet != 1) || (INCLUDE_uxTaskGetStackHighWaterMark != 1)
+#error "cpu_profiler requires INCLUDE_uxTaskPriorityGet and INCLUDE_uxTaskGetStackHighWaterMark"
+#endif
+
+#if !defined(PROFILER_CUSTOM_COUNTER) && !defined(PROFILER_TIM_CLOCK_HZ)
+/* TIM2 is on APB1, whose timers run at twice PCLK1 when APB1 is divided */
+#define PROFILER_TIM_CLOCK_HZ     (((RCC->CFGR & RCC_CFGR_PPRE1) == RCC_CFGR_PPRE1_DIV1) ? \
+                                   HAL_RCC_GetPCLK1Freq() : (2U * HAL_RCC_GetPCLK1Freq()))
+#endif
+
+/* Private macro -------------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static void     ProfilerStreamTask (void *argument);
+static uint16_t ProfilerCrc (const uint8_t *Data, uint32_t Length);
+
+/* Private variables ---------------------------------------------------------*/
+static ProfilerSlot_t ProfilerSlots[PROFILER_TASK_COUNT];
+static ProfilerSlot_t *ProfilerCurrent = NULL;   /* Slot of the running task */
+static uint32_t ProfilerSwitchTime = 0;           /* Counter when it was switched in */
+static uint32_t ProfilerOtherTime = 0;
+static uint32_t ProfilerSequence = 0;
+
+static uint32_t ProfilerTime = 0;
+static uint32_t ProfilerLastCount = 0;
+
+static struct __UART_HandleTypeDef *ProfilerUart;
+static TickType_t ProfilerPeriod;
+static ProfilerSnapshot_t ProfilerFrame;
+
+/* Private functions ---------------------------------------------------------*/
+/**
+  * @brief  Start the profiling counter
+  * @param  None
+  * @retval None
+  */
+void ProfilerInit (void)
+{
+#ifndef PROFILER_CUSTOM_COUNTER
+  PROFILER_TIM_CLK_ENABLE();
+
+  /* Free running up counter, the prescaler is loaded by the update event */
+  PROFILER_TIM->CR1 = 0U;
+  PROFILER_TIM->PSC = (PROFILER_TIM_CLOCK_HZ / PROFILER_COUNTER_HZ) - 1U;
+  PROFILER_TIM->ARR = 0xFFFFU;
+  PROFILER_TIM->EGR = TIM_EGR_UG;
+  PROFILER_TIM->CR1 = TIM_CR1_CEN;
+#endif /* PROFILER_CUSTOM_COUNTER */
+
+  ProfilerLastCount = PROFILER_READ_COUNTER();
+  ProfilerSwitchTime = ProfilerGetCounter();
+}
+
+/**
+  * @brief  Get the profiling counter extended to 32 bits. The elapsed counts
+  *         are accumulated on every call, which the kernel makes at least once
+  *         per tick
+  * @param  None
+  * @retval Counter value
+  */
+uint32_t ProfilerGetCounter (void)
+{
+  UBaseType_t isrm;
+  uint32_t count;
+  uint32_t time;
+
+  isrm = portSET_INTERRUPT_MASK_FROM_ISR();
+
+  count = PROFILER_READ_COUNTER();
+  ProfilerTime += (count - ProfilerLastCount) & PROFILER_COUNTER_MASK;
+  ProfilerLastCount = count;
+  time = ProfilerTime;
+
+  portCLEAR_INTERRUPT_MASK_FROM_ISR(isrm);
+
+  return time;
+}
+
+/**
+  * @brief  Give a slot to a new task. Called by the kernel from a critical
+  *         section
+  * @param  Task: task control block
+  * @param  Name: task name
+  * @retval Slot, or NULL when all the slots are in use
+  */
+void *ProfilerTaskCreate (void *Task, const char *Name)
+{
+  ProfilerSlot_t *slot = NULL;
+  uint32_t i;
+
+  for (i = 0U; i < PROFILER_TASK_COUNT; i++)
+  {
+    if (ProfilerSlots[i].Task == NULL)
+    {
+      slot = &ProfilerSlots[i];
+      break;
+    }
+  }
+
+  if (slot != NULL)
+  {
+    slot->Task       = Task;
+    slot->RunTime    = 0U;
+    slot->SnapshotRunTime = 0U;
+    slot->Switches   = 0U;
+    slot->MaxLatency = 0U;
+    slot->Ready      = 0U;
+    for (i = 0U; (i < PROFILER_TASK_NAME_LEN) && (i < configMAX_TASK_NAME_LEN) && (Name[i] != '\0'); i++)
+    {
+      slot->Name[i] = Name[i];
+    }
+    for (; i < PROFILER_TASK_NAME_LEN; i++)
+    {
+      slot->Name[i] = '\0';
+    }
+  }
+
+  return slot;
+}
+
+/**
+  * @brief  Free the slot of a deleted task. Called by the kernel from a
+  *         critical section
+  * @param  Slot: slot of the task, may be NULL
+  * @retval None
+  */
+void ProfilerTaskDelete (void *Slot)
+{
+  ProfilerSlot_t *slot = (ProfilerSlot_t *)Slot;
+  uint32_t now;
+
+  if (slot != NULL)
+  {
+    /* A task deleting itself runs until the next switch, that time is
+       counted as OtherTime */
+    if (slot == ProfilerCurrent)
+    {
+      now = ProfilerGetCounter();
+      slot->RunTime += now - ProfilerSwitchTime;
+      ProfilerSwitchTime = now;
+      ProfilerCurrent = NULL;
+    }
+
+    /* Keep the time the task ran since the previous snapshot in OtherTime,
+       so that the times of a snapshot period add up to its length */
+    ProfilerOtherTime += slot->RunTime - slot->SnapshotRunTime;
+    slot->Task = NULL;
+  }
+}
+
+/**
+  * @brief  Note the time a task became ready. Called by the kernel from a
+  *         critical section or an interrupt
+  * @param  Slot: slot of the task, may be NULL
+  * @param  Running: non zero when the task is the running task, for example
+  *         when its priority changes, which is not a scheduling delay
+  * @retval None
+  */
+void ProfilerTaskReady (void *Slot, uint32_t Running)
+{
+  ProfilerSlot_t *slot = (ProfilerSlot_t *)Slot;
+
+  if ((slot != NULL) && (Running == 0U) && (slot->Ready == 0U))
+  {
+    slot->ReadyTime = ProfilerGetCounter();
+    slot->Ready = 1U;
+  }
+}
+
+/**
+  * @brief  Account the time of the task switched out and start the one of the
+  *         task switched in. Called by the kernel with interrupts masked
+  * @param  Slot: slot of the task switched in, may be NULL
+  * @retval None
+  */
+void ProfilerTaskSwitchedIn (void *Slot)
+{
+  ProfilerSlot_t *slot = (ProfilerSlot_t *)Slot;
+  uint32_t now;
+  uint32_t latency;
+
+  now = ProfilerGetCounter();
+
+  /* The kernel also calls this hook when the running task keeps running */
+  if (ProfilerCurrent != NULL)
+  {
+    ProfilerCurrent->RunTime += now - ProfilerSwitchTime;
+  }
+  else
+  {
+    ProfilerOtherTime += now - ProfilerSwitchTime;
+  }
+  ProfilerSwitchTime = now;
+
+  if ((slot != NULL) && (slot != ProfilerCurrent))
+  {
+    slot->Switches++;
+    if (slot->Ready != 0U)
+    {
+      slot->Ready = 0U;
+      latency = now - slot->ReadyTime;
+      if (latency > slot->MaxLatency)
+      {
+        slot->MaxLatency = latency;
+      }
+    }
+  }
+  ProfilerCurrent = slot;
+}
+
+/**
+  * @brief  Take a snapshot of the statistics of all the tasks, and start a new
+  *         latency measurement period
+  * @param  Snapshot: snapshot to fill
+  * @retval Length of the snapshot frame in bytes
+  */
+uint32_t ProfilerSnapshot (ProfilerSnapshot_t *Snapshot)
+{
+  ProfilerSlot_t *slot;
+  ProfilerRecord_t *rec;
+  uint32_t count = 0U;
+  uint32_t length;
+  uint32_t now;
+  uint32_t i;
+
+  /* With the scheduler suspended no task can be created, deleted or switched
+     in, so the slots only change in ProfilerTaskReady() and the snapshot is
+     consistent without masking interrupts while the stacks are scanned */
+  vTaskSuspendAll();
+
+  now = ProfilerGetCounter();
+  if (ProfilerCurrent != NULL)
+  {
+    ProfilerCurrent->RunTime += now - ProfilerSwitchTime;
+  }
+  else
+  {
+    ProfilerOtherTime += now - ProfilerSwitchTime;
+  }
+  ProfilerSwitchTime = now;
+
+  for (i = 0U; i < PROFILER_TASK_COUNT; i++)
+  {
+    slot = &ProfilerSlots[i];
+    if (slot->Task != NULL)
+    {
+      rec = &Snapshot->Records[count];
+      rec->Object     = (uint16_t)(uintptr_t)slot->Task;
+      rec->Priority   = (uint8_t)uxTaskPriorityGet((TaskHandle_t)slot->Task);
+      rec->Reserved   = 0U;
+      memcpy(rec->Name, slot->Name, PROFILER_TASK_NAME_LEN);
+      rec->RunTime    = slot->RunTime;
+      rec->Switches   = slot->Switches;
+      rec->MaxLatency = slot->MaxLatency;
+      rec->StackFree  = (uint16_t)uxTaskGetStackHighWaterMark((TaskHandle_t)slot->Task);
+      rec->Reserved2  = 0U;
+      slot->SnapshotRunTime = slot->RunTime;
+      slot->MaxLatency = 0U;
+      count++;
+    }
+  }
+
+  Snapshot->Header.OtherTime = ProfilerOtherTime;
+  Snapshot->Header.Sequence  = ProfilerSequence++;
+
+  (void)xTaskResumeAll();
+
+  Snapshot->Header.Magic     = PROFILER_MAGIC;
+  Snapshot->Header.Version   = PROFILER_VERSION;
+  Snapshot->Header.TaskCount = (uint8_t)count;
+  Snapshot->Header.Crc       = 0U;
+  Snapshot->Header.Timestamp = now;
+  Snapshot->Header.CounterHz = PROFILER_COUNTER_HZ;
+
+  length = sizeof(ProfilerHeader_t) + (count * sizeof(ProfilerRecord_t));
+  Snapshot->Header.Crc = ProfilerCrc((const uint8_t *)Snapshot, length);
+
+  return length;
+}
+
+/**
+  * @brief  Create a task sending a snapshot over a UART every PeriodMs
+  * @param  huart: UART handle, already initialized
+  * @param  PeriodMs: time between two snapshots in ms
+  * @retval None
+  */
+void ProfilerStartStream (struct __UART_HandleTypeDef *huart, uint32_t PeriodMs)
+{
+  ProfilerUart = huart;
+  ProfilerPeriod = pdMS_TO_TICKS(PeriodMs);
+
+  (void)xTaskCreate(ProfilerStreamTask, "Profiler", PROFILER_STREAM_STACK_SIZE,
+                    NULL, PROFILER_STREAM_PRIORITY, NULL);
+}
+
+/**
+  * @brief  Snapshot streaming task. The frame is sent by DMA or interrupt, so
+  *         that the task only takes the CPU to build it
+  * @param  argument: not used
+  * @retval None
+  */
+static void ProfilerStreamTask (void *argument)
+{
+  HAL_StatusTypeDef status;
+  uint32_t length;
+
+  (void)argument;
+
+  for (;;)
+  {
+    vTaskDelay(ProfilerPeriod);
+
+    length = ProfilerSnapshot(&ProfilerFrame);
+
+    if (ProfilerUart->hdmatx != NULL)
+    {
+      status = HAL_UART_Transmit_DMA(ProfilerUart, (uint8_t *)&ProfilerFrame, (uint16_t)length);
+    }
+    else
+    {
+      status = HAL_UART_Transmit_IT(ProfilerUart, (uint8_t *)&ProfilerFrame, (uint16_t)length);
+    }
+
+    /* The frame buffer is reused by the next snapshot */
+    if (status == HAL_OK)
+    {
+      while (ProfilerUart->gState != HAL_UART_STATE_READY)
+      {
+        vTaskDelay(1);
+      }
+    }
+  }
+}
+
+/**
+  * @brief  CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF)
+  * @param  Data: data
+  * @param  Length: length of the data in bytes
+  * @retval CRC
+  */
+static uint16_t ProfilerCrc (const uint8_t *Data, uint32_t Length)
+{
+  uint16_t crc = 0xFFFFU;
+  uint32_t i;
+  uint32_t bit;
+
+  for (i = 0U; i < Length; i++)
+  {
+    crc ^= (uint16_t)((uint16_t)Data[i] << 8);
+    for (bit = 0U; bit < 8U; bit++)
+    {
+      if ((crc & 0x8000U) != 0U)
+      {
+        crc = (uint16_t)((crc << 1) ^ 0x1021U);
+      }
+      else
+      {
+        crc = (uint16_t)(crc << 1);
+      }
+    }
+  }
+
+  return crc;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
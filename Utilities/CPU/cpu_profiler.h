@@ -0,0 +1,157 @@
+/**
+  ******************************************************************************
+  * @file    cpu_profiler.h
+  * @author  MCD Application Team
+  * @brief   Header for cpu_profiler module
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2020 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _CPU_PROFILER_H__
+#define _CPU_PROFILER_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Number of tasks that are profiled. The time of tasks created once all the
+   slots are in use is only counted in the OtherTime field of the snapshots */
+#ifndef PROFILER_TASK_COUNT
+#define PROFILER_TASK_COUNT       16U
+#endif
+#define PROFILER_TASK_NAME_LEN    12U
+
+/* Index of the task local storage pointer that links a task to its slot */
+#ifndef PROFILER_TLS_INDEX
+#define PROFILER_TLS_INDEX        (configNUM_THREAD_LOCAL_STORAGE_POINTERS - 1)
+#endif
+
+#if (configNUM_THREAD_LOCAL_STORAGE_POINTERS < 1)
+#error "cpu_profiler requires configNUM_THREAD_LOCAL_STORAGE_POINTERS >= 1"
+#endif
+
+/* Frequency of the profiling counter. By default the counter is the 16 bit
+   PROFILER_TIM timer, started by ProfilerInit() at PROFILER_COUNTER_HZ */
+#ifndef PROFILER_COUNTER_HZ
+#define PROFILER_COUNTER_HZ       1000000U
+#endif
+
+#ifndef PROFILER_CUSTOM_COUNTER
+#ifndef PROFILER_TIM
+#define PROFILER_TIM              TIM2
+#define PROFILER_TIM_CLK_ENABLE() __HAL_RCC_TIM2_CLK_ENABLE()
+#endif
+#define PROFILER_READ_COUNTER()   (PROFILER_TIM->CNT)
+#define PROFILER_COUNTER_MASK     0xFFFFU
+#elif !defined(PROFILER_COUNTER_MASK)
+#define PROFILER_COUNTER_MASK     0xFFFFFFFFU
+#endif /* PROFILER_CUSTOM_COUNTER */
+
+/* Snapshot streaming task */
+#ifndef PROFILER_STREAM_PRIORITY
+#define PROFILER_STREAM_PRIORITY  (tskIDLE_PRIORITY + 1U)
+#endif
+#ifndef PROFILER_STREAM_STACK_SIZE
+#define PROFILER_STREAM_STACK_SIZE configMINIMAL_STACK_SIZE
+#endif
+
+/* Identifies a snapshot frame, "PRFS" when read as little endian bytes */
+#define PROFILER_MAGIC            0x53465250U
+#define PROFILER_VERSION          1U
+
+/* Exported types ------------------------------------------------------------*/
+/* Statistics of one task. Times are in profiling counter periods, RunTime
+   and Switches count from the creation of the task and wrap around, the
+   other fields cover the time since the previous snapshot */
+typedef struct
+{
+  uint16_t Object;        /* Low 16 bits of the task handle */
+  uint8_t  Priority;
+  uint8_t  Reserved;
+  char     Name[PROFILER_TASK_NAME_LEN];
+  uint32_t RunTime;       /* Time spent running, interrupts included */
+  uint32_t Switches;      /* Number of times the task was switched in */
+  uint32_t MaxLatency;    /* Worst time from becoming ready to running */
+  uint16_t StackFree;     /* Stack high water mark, in words */
+  uint16_t Reserved2;
+} ProfilerRecord_t;
+
+/* A snapshot, which is also the binary frame sent by the streaming task: the
+   header is followed by TaskCount records. Crc is the CRC-16/CCITT of the
+   frame computed with Crc set to 0 */
+typedef struct
+{
+  uint32_t Magic;
+  uint8_t  Version;
+  uint8_t  TaskCount;
+  uint16_t Crc;
+  uint32_t Sequence;
+  uint32_t Timestamp;     /* Profiling counter when the snapshot was taken */
+  uint32_t CounterHz;
+  uint32_t OtherTime;     /* Time spent running tasks that have no slot, and
+                             the tasks deleted since the previous snapshot */
+} ProfilerHeader_t;
+
+typedef struct
+{
+  ProfilerHeader_t Header;
+  ProfilerRecord_t Records[PROFILER_TASK_COUNT];
+} ProfilerSnapshot_t;
+
+/* Exported variables --------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+/* This header is included by FreeRTOSConfig.h, before the HAL, so the UART
+   handle is only declared as a structure */
+struct __UART_HandleTypeDef;
+
+void     ProfilerInit (void);
+uint32_t ProfilerGetCounter (void);
+uint32_t ProfilerSnapshot (ProfilerSnapshot_t *Snapshot);
+void     ProfilerStartStream (struct __UART_HandleTypeDef *huart, uint32_t PeriodMs);
+
+void    *ProfilerTaskCreate (void *Task, const char *Name);
+void     ProfilerTaskDelete (void *Slot);
+void     ProfilerTaskReady (void *Slot, uint32_t Running);
+void     ProfilerTaskSwitchedIn (void *Slot);
+
+/* Exported macro ------------------------------------------------------------*/
+/* FreeRTOS trace hooks. The TCB members used below are only visible in
+   tasks.c, which is where the kernel expands these macros. They replace the
+   hooks of trace_recorder.h and of cpu_utils.c, so only one of these modules
+   can be used at a time */
+#define PROFILER_SLOT(pxTCB)      ((pxTCB)->pvThreadLocalStoragePointers[PROFILER_TLS_INDEX])
+
+#define traceTASK_CREATE(pxNewTCB)              PROFILER_SLOT(pxNewTCB) = ProfilerTaskCreate((pxNewTCB), (pxNewTCB)->pcTaskName)
+#define traceTASK_DELETE(pxTCB)                 ProfilerTaskDelete(PROFILER_SLOT(pxTCB))
+#define traceMOVED_TASK_TO_READY_STATE(pxTCB)   ProfilerTaskReady(PROFILER_SLOT(pxTCB), (uint32_t)((pxTCB) == pxCurrentTCB))
+#define traceTASK_SWITCHED_IN()                 ProfilerTaskSwitchedIn(PROFILER_SLOT(pxCurrentTCB))
+#define traceTASK_INCREMENT_TICK(xTickCount)    (void)ProfilerGetCounter()
+
+/* Let vTaskGetRunTimeStats() use the same counter */
+#if (configGENERATE_RUN_TIME_STATS == 1)
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()        ProfilerGetCounter()
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CPU_PROFILER_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2020 STMicroelectronics.
+# All rights reserved.
+#
+# This software component is licensed by ST under BSD 3-Clause license,
+# the "License"; You may not use this file except in compliance with the
+# License. You may obtain a copy of the License at:
+#                        opensource.org/licenses/BSD-3-Clause
+#
+# Decodes the snapshot stream sent by cpu_profiler.c.
+#
+# Prints, for each snapshot, the CPU load, context switches per second, worst
+# ready-to-running latency and free stack of each task over the period since
+# the previous snapshot, and optionally writes them to a CSV file.
+#
+# Usage: cpu_profiler_decode.py capture.bin [--csv stats.csv]
+#        cpu_profiler_decode.py --port /dev/ttyACM0 [--baud 115200]
+# Reading a serial port needs pyserial.
+
+import argparse
+import csv
+import struct
+import sys
+
+PROFILER_MAGIC = b'PRFS'
+HEADER = struct.Struct('<IBBHIIII')
+RECORD = struct.Struct('<HBx12sIIIHxx')
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            if crc & 0x8000:
+                crc = ((crc << 1) ^ 0x1021) & 0xFFFF
+            else:
+                crc = (crc << 1) & 0xFFFF
+    return crc
+
+
+class Snapshot:
+    def __init__(self, header, records):
+        (_magic, _version, _count, _crc, self.sequence, self.timestamp,
+         self.hz, self.other) = header
+        self.tasks = {}
+        for obj, priority, name, run, switches, latency, stack in records:
+            name = name.split(b'\0')[0].decode('ascii', 'replace')
+            self.tasks[(obj, name)] = (priority, run, switches, latency,
+                                       stack)
+
+
+class Decoder:
+    """Extracts the frames from a byte stream, resynchronizing on the magic
+    word after a corrupted or truncated frame."""
+
+    def __init__(self):
+        self.buffer = bytearray()
+        self.errors = 0
+
+    def feed(self, data):
+        self.buffer += data
+        snapshots = []
+        while True:
+            start = self.buffer.find(PROFILER_MAGIC)
+            if start < 0:
+                del self.buffer[:max(0, len(self.buffer) - 3)]
+                return snapshots
+            del self.buffer[:start]
+            if len(self.buffer) < HEADER.size:
+                return snapshots
+            header = HEADER.unpack_from(self.buffer, 0)
+            version, count, crc = header[1], header[2], header[3]
+            length = HEADER.size + count * RECORD.size
+            if len(self.buffer) < length:
+                return snapshots
+            frame = bytearray(self.buffer[:length])
+            frame[6:8] = b'\0\0'
+            if version != 1 or crc16(frame) != crc:
+                self.errors += 1
+                del self.buffer[:1]
+                continue
+            records = [RECORD.unpack_from(frame, HEADER.size + i * RECORD.size)
+                       for i in range(count)]
+            snapshots.append(Snapshot(header, records))
+            del self.buffer[:length]
+
+
+def report(prev, snap, out, writer):
+    elapsed = (snap.timestamp - prev.timestamp) & 0xFFFFFFFF
+    if elapsed == 0:
+        return
+    seconds = elapsed / snap.hz
+    out.write('\nSnapshot %d, %.3f s\n' % (snap.sequence, seconds))
+    out.write('%-12s %4s %7s %9s %11s %6s\n' % (
+        'Task', 'Prio', 'CPU %', 'Switch/s', 'Latency us', 'Stack'))
+    total = 0
+    for key in sorted(snap.tasks, key=lambda k: -snap.tasks[k][1]):
+        priority, run, switches, latency, stack = snap.tasks[key]
+        if key in prev.tasks:
+            _, prun, pswitches, _, _ = prev.tasks[key]
+        else:
+            # Created during the period
+            prun, pswitches = 0, 0
+        run = (run - prun) & 0xFFFFFFFF
+        switches = (switches - pswitches) & 0xFFFFFFFF
+        total += run
+        row = (key[1], priority, 100.0 * run / elapsed, switches / seconds,
+               latency * 1e6 / snap.hz, stack)
+        out.write('%-12s %4d %7.2f %9.1f %11.1f %6d\n' % row)
+        if writer:
+            writer.writerow((snap.sequence, snap.timestamp) + row)
+    other = (snap.other - prev.other) & 0xFFFFFFFF
+    if other:
+        out.write('%-12s %4s %7.2f\n' % ('(other)', '', 100.0 * other / elapsed))
+    for key in prev.tasks:
+        if key not in snap.tasks:
+            out.write('%-12s deleted\n' % key[1])
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Decode a cpu_profiler snapshot stream.')
+    parser.add_argument('capture', nargs='?',
+                        help='file holding the bytes received on the UART')
+    parser.add_argument('--port', help='read from this serial port')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--csv', help='also write the statistics to a CSV file')
+    args = parser.parse_args()
+
+    if args.port:
+        import serial
+        source = serial.Serial(args.port, args.baud, timeout=0.5)
+    elif args.capture:
+        source = open(args.capture, 'rb')
+    else:
+        parser.error('give a capture file or --port')
+
+    writer = None
+    if args.csv:
+        csvfile = open(args.csv, 'w', newline='')
+        writer = csv.writer(csvfile)
+        writer.writerow(('sequence', 'timestamp', 'task', 'priority',
+                         'cpu_percent', 'switches_per_s', 'max_latency_us',
+                         'stack_free_words'))
+
+    decoder = Decoder()
+    prev = None
+    try:
+        while True:
+            data = source.read(4096)
+            if not data:
+                if args.port:
+                    continue
+                break
+            for snap in decoder.feed(data):
+                if prev is not None:
+                    if snap.sequence != ((prev.sequence + 1) & 0xFFFFFFFF):
+                        sys.stdout.write('\n%d snapshots lost\n' % (
+                            (snap.sequence - prev.sequence - 1) & 0xFFFFFFFF))
+                    report(prev, snap, sys.stdout, writer)
+                prev = snap
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+
+    if decoder.errors:
+        sys.stdout.write('\n%d corrupted frames skipped\n' % decoder.errors)
+
+
+if __name__ == '__main__':
+    main()
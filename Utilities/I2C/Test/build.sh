@@ -0,0 +1,31 @@
+#!/bin/sh
+# Builds the I2C bus scheduler and the HAL I2C driver against the I2C model of
+# i2c_bus_test.c, at -O0 and -O2, with I2C_BUS_MERGE_READS 1 and 0, and runs
+# each build: directed and stress tests in DMA and IT modes, then the
+# benchmark.
+# build.sh [output directory]
+HERE=$(cd "$(dirname "$0")" && pwd)
+BUS=$HERE/..
+DRIVERS=$HERE/../../../Drivers
+OUT=${1:-${TMPDIR:-/tmp}/i2c_bus_test}
+CC=${CC:-cc}
+mkdir -p "$OUT" || exit 1
+
+for O in O0 O2; do
+  for M in 1 0; do
+    # ../../Test/cmsis_host.h replaces the Cortex-M intrinsics of cmsis_gcc.h
+    $CC -$O -Wall -Wno-int-to-pointer-cast -Wno-pointer-to-int-cast -no-pie -fno-pie \
+      -DSTM32L073xx -DUSE_HAL_DRIVER -DI2C_BUS_MERGE_READS=${M}U \
+      -include "$HERE/../../Test/cmsis_host.h" -I"$HERE" -I"$BUS" \
+      -I"$DRIVERS/STM32L0xx_HAL_Driver/Inc" \
+      -I"$DRIVERS/CMSIS/Device/ST/STM32L0xx/Include" -I"$DRIVERS/CMSIS/Include" \
+      -o "$OUT/i2c_bus_test_$O$M" "$HERE/i2c_bus_test.c" "$BUS/i2c_bus.c" \
+      "$DRIVERS/STM32L0xx_HAL_Driver/Src/stm32l0xx_hal_i2c.c" || exit 1
+  done
+done
+for O in O0 O2; do
+  for M in 1 0; do
+    echo "== -$O, I2C_BUS_MERGE_READS $M"
+    "$OUT/i2c_bus_test_$O$M" || exit 1
+  done
+done
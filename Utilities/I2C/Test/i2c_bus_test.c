@@ -0,0 +1,765 @@
+/* Host model of an I2C v2 master with DMA and register slaves, driving the
+   real HAL I2C driver and the I2C bus scheduler: directed tests in DMA and
+   IT modes, a random stress test resubmitting from the callbacks, then the
+   benchmark.
+   i2c_bus_test [stress steps] [directed test only, with trace: 0 IT, 1 DMA]
+   STRESS=<0 IT, 1 DMA> runs the stress test alone. */
+#include "i2c_bus.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+uint32_t sim_primask, sim_critical_entries;
+static unsigned long checks, failures;
+#define CHECK(c) do { checks++; if (!(c)) { failures++; if (failures < 30) printf("FAIL %d %s (t=%llu)\n", __LINE__, #c, (unsigned long long)now_ns); } } while (0)
+
+static uint64_t now_ns;
+static int trace;
+#define TR(...) do { if (trace) printf(__VA_ARGS__); } while (0)
+static uint32_t task_ns = 20000;
+#define BIT_NS   2500U   /* 400 kHz */
+#define TBUF_NS  1300U
+#define ISR_NS   3000U   /* HAL I2C ISR entry to exit at 32 MHz */
+#define SENT     0xDEAD0000U
+
+static I2C_TypeDef i2c_regs;
+static I2C_HandleTypeDef hi2c;
+static DMA_HandleTypeDef dmatx, dmarx;
+static DMA_Channel_TypeDef dmach[2];
+static I2CBus_t bus;
+static int use_dma = 1;
+
+/* ---------------- DMA stub ---------------- */
+typedef struct { int active; uint8_t *mem; uint32_t count; int irq; } chan_t;
+static chan_t ctx, crx;
+static chan_t *chan(DMA_HandleTypeDef *h) { return (h == &dmatx) ? &ctx : &crx; }
+
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *h, uint32_t src, uint32_t dst, uint32_t len)
+{
+  chan_t *c = chan(h);
+  if (h->State != HAL_DMA_STATE_READY) return HAL_BUSY;
+  CHECK(len > 0U && len <= 255U);
+  h->State = HAL_DMA_STATE_BUSY;
+  c->active = 1;
+  c->mem = (uint8_t *)(uintptr_t)((h == &dmatx) ? src : dst);
+  c->count = len;
+  c->irq = 0;
+  return HAL_OK;
+}
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *h) { chan_t *c = chan(h); c->active = 0; c->irq = 0; h->State = HAL_DMA_STATE_READY; return HAL_OK; }
+HAL_StatusTypeDef HAL_DMA_Abort_IT(DMA_HandleTypeDef *h)
+{
+  HAL_DMA_Abort(h);
+  if (h->XferAbortCallback != NULL) h->XferAbortCallback(h);
+  return HAL_OK;
+}
+HAL_DMA_StateTypeDef HAL_DMA_GetState(DMA_HandleTypeDef *h) { return h->State; }
+
+/* ---------------- slaves ---------------- */
+typedef struct { uint16_t addr; int regsize; uint32_t size; uint8_t mem[4096]; uint8_t ref[4096]; uint32_t ptr; } slave_t;
+#define NSLAVE 3
+static slave_t slaves[NSLAVE];
+#define ABSENT 0x30U
+
+static slave_t *find_slave(uint16_t a)
+{
+  int i;
+  for (i = 0; i < NSLAVE; i++) if (slaves[i].addr == a) return &slaves[i];
+  return NULL;
+}
+
+/* ---------------- I2C model ---------------- */
+enum { P_IDLE, P_XFER, P_WAIT_TC, P_WAIT_TCR };
+static struct
+{
+  int phase, rd, reload, autoend, wr_index;
+  uint32_t remaining;
+  uint16_t sadd;
+  slave_t *slave;
+  uint64_t last_stop;
+} hw;
+static unsigned long n_start, n_restart, n_stop, n_restart_w, n_addr_only, n_bytes, n_irq, protocol_errors;
+static uint64_t busy_since, busy_ns;
+
+void sim_i2c_clear_flag(I2C_TypeDef *regs, uint32_t flag)
+{
+  if (flag == I2C_FLAG_TXE) regs->ISR |= I2C_ISR_TXE;
+  else regs->ISR &= ~flag;
+}
+
+static void do_stop(void)
+{
+  TR("%llu P\n", (unsigned long long)now_ns);
+  now_ns += BIT_NS;
+  i2c_regs.ISR |= I2C_ISR_STOPF | I2C_ISR_TXE;
+  i2c_regs.ISR &= ~(I2C_ISR_BUSY | I2C_ISR_TC | I2C_ISR_TCR | I2C_ISR_TXIS);
+  if (hw.phase != P_IDLE) busy_ns += now_ns - busy_since;
+  hw.phase = P_IDLE;
+  hw.last_stop = now_ns;
+  n_stop++;
+}
+
+static void end_chunk(void)
+{
+  if (hw.reload)
+  {
+    i2c_regs.ISR |= I2C_ISR_TCR;
+    i2c_regs.CR2 &= ~I2C_CR2_NBYTES;
+    hw.phase = P_WAIT_TCR;
+  }
+  else if (hw.autoend)
+  {
+    do_stop();
+  }
+  else
+  {
+    i2c_regs.ISR |= I2C_ISR_TC;
+    i2c_regs.CR2 &= ~I2C_CR2_NBYTES;
+    hw.phase = P_WAIT_TC;
+  }
+}
+
+static void latch(uint32_t cr2)
+{
+  hw.remaining = (cr2 & I2C_CR2_NBYTES) >> I2C_CR2_NBYTES_Pos;
+  hw.reload = (cr2 & I2C_CR2_RELOAD) != 0U;
+  hw.autoend = (cr2 & I2C_CR2_AUTOEND) != 0U;
+}
+
+static void slave_write(uint8_t b)
+{
+  slave_t *s = hw.slave;
+  if (hw.wr_index < s->regsize)
+  {
+    s->ptr = (hw.wr_index == 0) ? b : ((s->ptr << 8) | b);
+    if (hw.wr_index == s->regsize - 1) s->ptr %= s->size;
+  }
+  else
+  {
+    s->mem[s->ptr] = b;
+    s->ptr = (s->ptr + 1U) % s->size;
+  }
+  hw.wr_index++;
+}
+
+static uint8_t slave_read(void)
+{
+  slave_t *s = hw.slave;
+  uint8_t b = s->mem[s->ptr];
+  s->ptr = (s->ptr + 1U) % s->size;
+  return b;
+}
+
+static int hw_step(void)
+{
+  uint32_t cr2 = i2c_regs.CR2;
+
+  if (cr2 & I2C_CR2_START)
+  {
+    TR("%llu %s %02x %s n=%lu %s%s\n", (unsigned long long)now_ns, hw.phase == P_IDLE ? "S" : "Sr", (unsigned)(cr2 & 0xFF), (cr2 & I2C_CR2_RD_WRN) ? "R" : "W",
+       (unsigned long)((cr2 & I2C_CR2_NBYTES) >> 16), (cr2 & I2C_CR2_RELOAD) ? "reload " : "", (cr2 & I2C_CR2_AUTOEND) ? "autoend" : "");
+    if ((hw.phase != P_IDLE) && (hw.phase != P_WAIT_TC)) { protocol_errors++; CHECK(0 && "start during transfer"); }
+    if (hw.phase == P_IDLE)
+    {
+      if (now_ns < hw.last_stop + TBUF_NS) now_ns = hw.last_stop + TBUF_NS;
+      busy_since = now_ns;
+      n_start++;
+    }
+    else
+    {
+      n_restart++;
+      if (((cr2 & I2C_CR2_RD_WRN) == 0U) && ((cr2 & I2C_CR2_NBYTES) != 0U)) n_restart_w++; /* not the closing address-only frame */
+      i2c_regs.ISR &= ~I2C_ISR_TC;
+    }
+    now_ns += BIT_NS + 9U * BIT_NS;
+    i2c_regs.CR2 &= ~I2C_CR2_START;
+    i2c_regs.ISR |= I2C_ISR_BUSY;
+    hw.rd = (cr2 & I2C_CR2_RD_WRN) != 0U;
+    hw.sadd = (uint16_t)(cr2 & I2C_CR2_SADD);
+    hw.wr_index = 0;
+    latch(cr2);
+    hw.slave = find_slave(hw.sadd);
+    hw.phase = P_XFER;
+    if (hw.slave == NULL)
+    {
+      i2c_regs.ISR |= I2C_ISR_NACKF;
+      do_stop();
+      return 1;
+    }
+    if ((hw.remaining == 0U) && !hw.rd) n_addr_only++;
+    if (hw.remaining == 0U) end_chunk();
+    return 1;
+  }
+  if (cr2 & I2C_CR2_STOP)
+  {
+    i2c_regs.CR2 &= ~I2C_CR2_STOP;
+    if (hw.phase != P_IDLE) do_stop();
+    return 1;
+  }
+
+  /* received byte moved by the DMA, also after the end of the frame */
+  if ((i2c_regs.ISR & I2C_ISR_RXNE) && (i2c_regs.CR1 & I2C_CR1_RXDMAEN) && crx.active && crx.count)
+  {
+    *crx.mem++ = (uint8_t)i2c_regs.RXDR;
+    if (--crx.count == 0U) { crx.active = 0; crx.irq = 1; }
+    i2c_regs.ISR &= ~I2C_ISR_RXNE;
+    return 1;
+  }
+
+  switch (hw.phase)
+  {
+    case P_WAIT_TCR:
+      if (cr2 & I2C_CR2_NBYTES)
+      {
+        latch(cr2);
+        i2c_regs.ISR &= ~I2C_ISR_TCR;
+        hw.phase = P_XFER;
+        return 1;
+      }
+      return 0;
+    case P_WAIT_TC:
+      if (cr2 & I2C_CR2_NBYTES) { protocol_errors++; CHECK(0 && "NBYTES written after TC without start"); i2c_regs.CR2 &= ~I2C_CR2_NBYTES; }
+      return 0;
+    case P_XFER:
+      if (!hw.rd)
+      {
+        if ((i2c_regs.ISR & I2C_ISR_TXE) == 0U)
+        {
+          now_ns += 9U * BIT_NS;
+          slave_write((uint8_t)i2c_regs.TXDR);
+          n_bytes++;
+          i2c_regs.ISR |= I2C_ISR_TXE;
+          if (--hw.remaining == 0U) end_chunk();
+          return 1;
+        }
+        if ((i2c_regs.CR1 & I2C_CR1_TXDMAEN) && ctx.active && ctx.count)
+        {
+          i2c_regs.TXDR = *ctx.mem++;
+          if (--ctx.count == 0U) { ctx.active = 0; ctx.irq = 1; }
+          i2c_regs.ISR &= ~I2C_ISR_TXE;
+          return 1;
+        }
+        if ((i2c_regs.ISR & I2C_ISR_TXIS) == 0U)
+        {
+          i2c_regs.ISR |= I2C_ISR_TXIS;
+          i2c_regs.TXDR = SENT;
+          return 1;
+        }
+        return 0;
+      }
+      if (i2c_regs.ISR & I2C_ISR_RXNE)
+      {
+        return 0;
+      }
+      now_ns += 9U * BIT_NS;
+      i2c_regs.RXDR = slave_read();
+      n_bytes++;
+      i2c_regs.ISR |= I2C_ISR_RXNE;
+      if (--hw.remaining == 0U) end_chunk();
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+static int irq_pending(void)
+{
+  uint32_t isr = i2c_regs.ISR, cr1 = i2c_regs.CR1;
+  return ((isr & I2C_ISR_TXIS) && (cr1 & I2C_CR1_TXIE)) || ((isr & I2C_ISR_RXNE) && (cr1 & I2C_CR1_RXIE)) ||
+         ((isr & (I2C_ISR_TC | I2C_ISR_TCR)) && (cr1 & I2C_CR1_TCIE)) || ((isr & I2C_ISR_STOPF) && (cr1 & I2C_CR1_STOPIE)) ||
+         ((isr & I2C_ISR_NACKF) && (cr1 & I2C_CR1_NACKIE));
+}
+
+static int in_isr;
+static int irq_step(void)
+{
+  uint32_t isr0, cr10, state0;
+
+  CHECK(sim_primask == 0U);
+  if (ctx.irq)
+  {
+    TR("dma tx cplt\n");
+    ctx.irq = 0; dmatx.State = HAL_DMA_STATE_READY;
+    in_isr = 1; dmatx.XferCpltCallback(&dmatx); in_isr = 0;
+    return 1;
+  }
+  if (crx.irq)
+  {
+    TR("dma rx cplt\n");
+    crx.irq = 0; dmarx.State = HAL_DMA_STATE_READY;
+    in_isr = 1; dmarx.XferCpltCallback(&dmarx); in_isr = 0;
+    return 1;
+  }
+  if (!irq_pending()) return 0;
+  isr0 = i2c_regs.ISR; cr10 = i2c_regs.CR1;
+  state0 = hi2c.State;
+  TR("%llu irq isr=%04x cr1=%04x state=%x\n", (unsigned long long)now_ns, (unsigned)isr0, (unsigned)cr10, (unsigned)hi2c.State);
+  now_ns += ISR_NS;
+  n_irq++;
+  in_isr = 1;
+  HAL_I2C_EV_IRQHandler(&hi2c);
+  in_isr = 0;
+  CHECK(sim_primask == 0U);
+  if ((i2c_regs.ISR & I2C_ISR_TXIS) && (i2c_regs.TXDR != SENT))
+  {
+    i2c_regs.ISR &= ~(I2C_ISR_TXIS | I2C_ISR_TXE);
+  }
+  /* RXDR read by the HAL: reception in IT mode, or end of an abort */
+  if (((isr0 & I2C_ISR_RXNE) && (cr10 & I2C_CR1_RXIE) && !((isr0 & I2C_ISR_NACKF) && (cr10 & I2C_CR1_NACKIE))) ||
+      ((isr0 & I2C_ISR_RXNE) && (isr0 & I2C_ISR_STOPF) && (cr10 & I2C_CR1_STOPIE) && (state0 == HAL_I2C_STATE_ABORT)))
+  {
+    i2c_regs.ISR &= ~I2C_ISR_RXNE;
+  }
+  return 1;
+}
+
+/* Run the hardware and the interrupts until the bus waits for software */
+static void run(void)
+{
+  int storm = 0;
+  for (;;)
+  {
+    if (hw_step()) { storm = 0; continue; }
+    if (irq_step())
+    {
+      if (++storm > 50) { CHECK(0 && "interrupt storm"); return; }
+      continue;
+    }
+    return;
+  }
+}
+
+uint32_t HAL_GetTick(void)
+{
+  if (!in_isr)
+  {
+    /* the task polls while the bus runs for 50 us */
+    uint64_t end = now_ns + 50000U;
+    while (now_ns < end)
+    {
+      if (hw_step()) continue;
+      if (irq_step()) continue;
+      now_ns = end;
+    }
+  }
+  return (uint32_t)(now_ns / 1000000U);
+}
+
+/* ---------------- transactions ---------------- */
+#define NT 24
+static I2CBusTransaction_t tr[NT];
+static uint8_t tbuf[NT][320];
+static uint8_t bigbuf[60000];
+static unsigned long done_cb, err_cb, cancel_cb, read_ok, write_ok;
+static int resubmit_from_cb;
+static uint32_t rng = 12345U;
+static uint32_t rnd(uint32_t n) { rng = rng * 1103515245U + 12345U; return (rng >> 8) % n; }
+
+static void ref_apply(I2CBusTransaction_t *t)
+{
+  slave_t *s = find_slave(t->DevAddress);
+  uint32_t i;
+  for (i = 0; i < t->Length; i++) s->ref[(t->Reg + i) % s->size] = t->Data[i];
+}
+
+static int ref_match(I2CBusTransaction_t *t)
+{
+  slave_t *s = find_slave(t->DevAddress);
+  uint32_t i;
+  for (i = 0; i < t->Length; i++) if (s->ref[(t->Reg + i) % s->size] != t->Data[i]) return 0;
+  return 1;
+}
+
+static void random_fill(I2CBusTransaction_t *t);
+
+static void cb(I2CBusTransaction_t *t)
+{
+  CHECK(sim_primask == 0U);
+  CHECK(t->Status != I2C_BUS_QUEUED && t->Status != I2C_BUS_ACTIVE);
+  if (t->Status == I2C_BUS_DONE)
+  {
+    done_cb++;
+    CHECK(find_slave(t->DevAddress) != NULL);
+    if (t->Direction == I2C_BUS_WRITE) { ref_apply(t); write_ok++; }
+    else { CHECK((t->RegSize == 0U) || ref_match(t)); read_ok++; }
+  }
+  else if (t->Status == I2C_BUS_ERROR)
+  {
+    err_cb++;
+    CHECK(find_slave(t->DevAddress) == NULL);
+  }
+  else
+  {
+    CHECK(t->Status == I2C_BUS_CANCELLED);
+    cancel_cb++;
+    /* an aborted write may have been partially done: resync the reference */
+    if (t->Direction == I2C_BUS_WRITE && find_slave(t->DevAddress) != NULL)
+    {
+      slave_t *s = find_slave(t->DevAddress);
+      memcpy(s->ref, s->mem, s->size);
+    }
+  }
+  if (resubmit_from_cb && rnd(3) == 0)
+  {
+    random_fill(t);
+    CHECK(I2CBusSubmit(&bus, t) == HAL_OK);
+  }
+}
+
+static void random_fill(I2CBusTransaction_t *t)
+{
+  int i = (int)(t - tr);
+  uint32_t k = rnd(100), j;
+  slave_t *s = &slaves[rnd(NSLAVE)];
+  t->DevAddress = (k < 2) ? ABSENT : s->addr;
+  t->Direction = (rnd(4) == 0) ? I2C_BUS_WRITE : I2C_BUS_READ;
+  t->RegSize = (t->DevAddress == ABSENT) ? I2C_MEMADD_SIZE_8BIT : (uint16_t)s->regsize;
+  t->Reg = (uint16_t)rnd(s->size);
+  t->Length = (uint16_t)(1U + ((rnd(20) == 0) ? rnd(300) : rnd(24)));
+  t->Data = tbuf[i];
+  t->Callback = cb;
+  if (t->Direction == I2C_BUS_WRITE) for (j = 0; j < t->Length; j++) t->Data[j] = (uint8_t)rnd(256);
+  else memset(t->Data, 0x5A, t->Length);
+}
+
+/* ---------------- setup ---------------- */
+static void setup(int dma)
+{
+  int i;
+  memset(&i2c_regs, 0, sizeof(i2c_regs));
+  memset(&hi2c, 0, sizeof(hi2c));
+  memset(&hw, 0, sizeof(hw));
+  memset(&ctx, 0, sizeof(ctx));
+  memset(&crx, 0, sizeof(crx));
+  memset(tr, 0, sizeof(tr));
+  i2c_regs.ISR = I2C_ISR_TXE;
+  use_dma = dma;
+  hi2c.Instance = &i2c_regs;
+  hi2c.Init.AddressingMode = I2C_ADDRESSINGMODE_7BIT;
+  CHECK(HAL_I2C_Init(&hi2c) == HAL_OK);
+  memset(&dmatx, 0, sizeof(dmatx));
+  memset(&dmarx, 0, sizeof(dmarx));
+  dmatx.Instance = &dmach[0]; dmarx.Instance = &dmach[1];
+  dmatx.State = dmarx.State = HAL_DMA_STATE_READY;
+  dmatx.Parent = dmarx.Parent = &hi2c;
+  hi2c.hdmatx = dma ? &dmatx : NULL;
+  hi2c.hdmarx = dma ? &dmarx : NULL;
+  CHECK(I2CBusInit(&bus, &hi2c) == HAL_OK);
+
+  slaves[0].addr = 0x90; slaves[0].regsize = 1; slaves[0].size = 256;  /* temperature sensor */
+  slaves[1].addr = 0x84; slaves[1].regsize = 1; slaves[1].size = 256;  /* IO expander */
+  slaves[2].addr = 0xA0; slaves[2].regsize = 2; slaves[2].size = 4096; /* EEPROM */
+  for (i = 0; i < NSLAVE; i++)
+  {
+    uint32_t j;
+    for (j = 0; j < slaves[i].size; j++) slaves[i].mem[j] = (uint8_t)rnd(256);
+    memcpy(slaves[i].ref, slaves[i].mem, slaves[i].size);
+    slaves[i].ptr = 0;
+  }
+  n_start = n_restart = n_stop = n_restart_w = n_addr_only = n_bytes = n_irq = 0;
+  busy_ns = 0;
+  done_cb = err_cb = cancel_cb = read_ok = write_ok = 0;
+}
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *h) { I2CBusTransferCplt(h); }
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *h) { I2CBusTransferCplt(h); }
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *h) { I2CBusTransferError(h); }
+void HAL_I2C_AbortCpltCallback(I2C_HandleTypeDef *h) { I2CBusTransferError(h); }
+
+static int all_idle(void)
+{
+  int i;
+  for (i = 0; i < NT; i++) if (tr[i].Status == I2C_BUS_QUEUED || tr[i].Status == I2C_BUS_ACTIVE) return 0;
+  return 1;
+}
+
+/* ---------------- random stress ---------------- */
+static void stress(int dma, unsigned long steps)
+{
+  unsigned long s;
+  int i;
+
+  setup(dma);
+  resubmit_from_cb = 1;
+  for (s = 0; s < steps; s++)
+  {
+    /* the I2C samples START at once, a later write of CR2 by the HAL
+       (abort) cannot clear it */
+    if (i2c_regs.CR2 & I2C_CR2_START) (void)hw_step();
+    if (trace && bus.Restarts != n_restart_w) { printf("%llu DIVERGE %lu %lu\n", (unsigned long long)now_ns, (unsigned long)bus.Restarts, n_restart_w); trace = 0; }
+    i = (int)rnd(NT);
+    switch (rnd(10))
+    {
+      case 0:
+        /* cancel, queued or active */
+        if (trace) printf("%llu cancel %d %p status %d active %p step %d hold %d phase %d state %x\n", (unsigned long long)now_ns, i, (void*)&tr[i], tr[i].Status, (void*)bus.Active, bus.Step, bus.Hold, hw.phase, hi2c.State);
+        if (tr[i].Status == I2C_BUS_QUEUED || tr[i].Status == I2C_BUS_ACTIVE)
+        {
+          CHECK(I2CBusCancel(&bus, &tr[i]) == HAL_OK);
+        }
+        else
+        {
+          CHECK(I2CBusCancel(&bus, &tr[i]) == HAL_ERROR);
+        }
+        break;
+      case 1: case 2: case 3: case 4:
+        if (tr[i].Status != I2C_BUS_QUEUED && tr[i].Status != I2C_BUS_ACTIVE)
+        {
+          random_fill(&tr[i]);
+          CHECK(I2CBusSubmit(&bus, &tr[i]) == HAL_OK);
+        }
+        else
+        {
+          CHECK(I2CBusSubmit(&bus, &tr[i]) == HAL_BUSY);
+        }
+        break;
+      default:
+        /* let the hardware run for a while */
+        {
+          int k, n = (int)rnd(40);
+          for (k = 0; k < n; k++)
+          {
+            if (hw_step()) continue;
+            if (!irq_step()) break;
+          }
+        }
+        break;
+    }
+    /* invariants */
+    CHECK(bus.Hold == 0U || bus.Active != NULL);
+    CHECK((bus.Active == NULL) || (bus.Active->Status == I2C_BUS_ACTIVE));
+  }
+  resubmit_from_cb = 0;
+  run();
+  if (!all_idle()) printf("stuck: phase %d rd %d rem %u isr %x cr1 %x cr2 %x state %x mode %x prev %x step %d hold %d abort %d active %p err %x\n", hw.phase, hw.rd, hw.remaining, (unsigned)i2c_regs.ISR, (unsigned)i2c_regs.CR1, (unsigned)i2c_regs.CR2, hi2c.State, hi2c.Mode, (unsigned)hi2c.PreviousState, bus.Step, bus.Hold, bus.Abort, (void*)bus.Active, (unsigned)hi2c.ErrorCode);
+  CHECK(all_idle());
+  CHECK(bus.Active == NULL && bus.Queue == NULL && bus.Step == 0U);
+  CHECK(hi2c.State == HAL_I2C_STATE_READY);
+  CHECK(hw.phase == P_IDLE);
+  for (i = 0; i < NSLAVE; i++) CHECK(memcmp(slaves[i].mem, slaves[i].ref, slaves[i].size) == 0);
+  if (bus.Restarts != n_restart_w) printf("restarts %lu vs %lu\n", (unsigned long)bus.Restarts, n_restart_w);
+  CHECK(bus.Restarts == n_restart_w);
+  printf("stress %s: %lu done (%lu reads, %lu writes), %lu errors, %lu cancelled, %lu starts, %lu chained restarts, %lu stops, %lu address-only, %lu bytes\n",
+         dma ? "DMA" : "IT ", done_cb, read_ok, write_ok, err_cb, cancel_cb, n_start, n_restart_w, n_stop, n_addr_only, n_bytes);
+}
+
+/* ---------------- directed tests ---------------- */
+static void set_tr(I2CBusTransaction_t *t, uint16_t dev, I2CBusDirection_t dir, uint16_t reg, uint16_t len)
+{
+  slave_t *s = find_slave(dev);
+  int i = (int)(t - tr);
+  uint32_t j;
+  memset(t, 0, sizeof(*t));
+  t->DevAddress = dev; t->Direction = dir; t->Reg = reg; t->Length = len;
+  t->RegSize = (s != NULL) ? (uint16_t)s->regsize : I2C_MEMADD_SIZE_8BIT;
+  t->Data = tbuf[i]; t->Callback = cb;
+  for (j = 0; j < len; j++) t->Data[j] = (uint8_t)(dir == I2C_BUS_WRITE ? rnd(256) : 0);
+}
+
+static void directed(int dma)
+{
+  slave_t *e;
+  unsigned long r0, s0, a0;
+
+  /* merged chain: three reads then a write */
+  setup(dma);
+  set_tr(&tr[0], 0x90, I2C_BUS_READ, 0, 2);
+  set_tr(&tr[1], 0x84, I2C_BUS_READ, 0x10, 1);
+  set_tr(&tr[2], 0xA0, I2C_BUS_READ, 0x123, 16);
+  set_tr(&tr[3], 0xA0, I2C_BUS_WRITE, 0x200, 8);
+  CHECK(I2CBusSubmit(&bus, &tr[0]) == HAL_OK);
+  CHECK(I2CBusSubmit(&bus, &tr[1]) == HAL_OK);
+  CHECK(I2CBusSubmit(&bus, &tr[2]) == HAL_OK);
+  CHECK(I2CBusSubmit(&bus, &tr[3]) == HAL_OK);
+  run();
+  TR("phase %d rd %d rem %u isr %x cr1 %x cr2 %x crx %d/%u/%d state %x step %d\n", hw.phase, hw.rd, hw.remaining, (unsigned)i2c_regs.ISR, (unsigned)i2c_regs.CR1, (unsigned)i2c_regs.CR2, crx.active, crx.count, crx.irq, hi2c.State, bus.Step);
+  CHECK(all_idle() && done_cb == 4);
+#if (I2C_BUS_MERGE_READS == 1U)
+  CHECK(n_start == 2);  /* one for the reads, one for the write */
+  CHECK(n_stop == 2);
+  CHECK(n_restart_w == 2 && bus.Restarts == 2);
+#else
+  CHECK(n_start == 4 && n_stop == 4 && bus.Restarts == 0);
+#endif
+  CHECK(n_restart == 3 + n_restart_w - 0); /* 3 read restarts + chained */
+
+  /* held read whose follower is cancelled: address only write ends it */
+  setup(dma);
+  set_tr(&tr[0], 0x84, I2C_BUS_READ, 0, 40);
+  set_tr(&tr[1], 0x90, I2C_BUS_READ, 1, 2);
+  set_tr(&tr[2], 0xA0, I2C_BUS_WRITE, 0x10, 4);
+  CHECK(I2CBusSubmit(&bus, &tr[0]) == HAL_OK);
+  CHECK(I2CBusSubmit(&bus, &tr[1]) == HAL_OK);
+  /* run into the data frame of tr[0] */
+  while (!(hw.phase == P_XFER && hw.rd)) { if (!hw_step()) CHECK(irq_step()); }
+#if (I2C_BUS_MERGE_READS == 1U)
+  CHECK(bus.Hold == 1U);
+#endif
+  CHECK(I2CBusSubmit(&bus, &tr[2]) == HAL_OK);
+  CHECK(I2CBusCancel(&bus, &tr[1]) == HAL_OK);
+  CHECK(tr[1].Status == I2C_BUS_CANCELLED);
+  a0 = n_addr_only;
+  run();
+  CHECK(all_idle());
+  CHECK(tr[0].Status == I2C_BUS_DONE && tr[2].Status == I2C_BUS_DONE);
+#if (I2C_BUS_MERGE_READS == 1U)
+  CHECK(n_addr_only == a0 + 1);
+#else
+  (void)a0;
+#endif
+  CHECK(n_stop == 2);
+  CHECK(memcmp(slaves[2].mem, slaves[2].ref, slaves[2].size) == 0);
+
+  /* chained read of an absent device: NACK, stop, then the queue goes on */
+  setup(dma);
+  set_tr(&tr[0], 0x84, I2C_BUS_READ, 0, 4);
+  set_tr(&tr[1], ABSENT, I2C_BUS_READ, 0, 4);
+  set_tr(&tr[2], 0x90, I2C_BUS_READ, 0, 4);
+  CHECK(I2CBusSubmit(&bus, &tr[0]) == HAL_OK);
+  CHECK(I2CBusSubmit(&bus, &tr[1]) == HAL_OK);
+  CHECK(I2CBusSubmit(&bus, &tr[2]) == HAL_OK);
+  run();
+  CHECK(tr[0].Status == I2C_BUS_DONE && tr[1].Status == I2C_BUS_ERROR && tr[2].Status == I2C_BUS_DONE);
+  CHECK(bus.Errors == 1U && bus.Transactions == 3U);
+  CHECK(hi2c.State == HAL_I2C_STATE_READY && hw.phase == P_IDLE);
+
+  /* abort of the active transaction, in the data frame of a long write */
+  setup(dma);
+  set_tr(&tr[0], 0xA0, I2C_BUS_WRITE, 0x300, 200);
+  set_tr(&tr[1], 0x90, I2C_BUS_READ, 0, 4);
+  CHECK(I2CBusSubmit(&bus, &tr[0]) == HAL_OK);
+  CHECK(I2CBusSubmit(&bus, &tr[1]) == HAL_OK);
+  while (n_bytes < 40) { if (!hw_step()) CHECK(irq_step()); }
+  CHECK(I2CBusCancel(&bus, &tr[0]) == HAL_OK);
+  CHECK(tr[0].Status == I2C_BUS_ACTIVE);   /* ends at the stop */
+  CHECK(I2CBusCancel(&bus, &tr[0]) == HAL_OK); /* again while aborting */
+  run();
+  CHECK(tr[0].Status == I2C_BUS_CANCELLED && tr[1].Status == I2C_BUS_DONE);
+  CHECK(cancel_cb == 1);
+  CHECK(hi2c.State == HAL_I2C_STATE_READY && hw.phase == P_IDLE);
+
+  /* abort during a held read: the chained read still runs after the stop */
+  setup(dma);
+  set_tr(&tr[0], 0xA0, I2C_BUS_READ, 0, 100);
+  set_tr(&tr[1], 0x90, I2C_BUS_READ, 0, 4);
+  CHECK(I2CBusSubmit(&bus, &tr[0]) == HAL_OK);
+  CHECK(I2CBusSubmit(&bus, &tr[1]) == HAL_OK);
+  while (n_bytes < 30) { if (!hw_step()) CHECK(irq_step()); }
+  CHECK(I2CBusCancel(&bus, &tr[0]) == HAL_OK);
+  run();
+  CHECK(tr[0].Status == I2C_BUS_CANCELLED && tr[1].Status == I2C_BUS_DONE);
+  CHECK(bus.Restarts == 0U);
+  CHECK(hi2c.State == HAL_I2C_STATE_READY && hw.phase == P_IDLE);
+
+  /* plain write and read, 16 bit register of 0x1FF, reload across 255 bytes */
+  setup(dma);
+  set_tr(&tr[0], 0xA0, I2C_BUS_WRITE, 0x1FF, 300);
+  set_tr(&tr[1], 0xA0, I2C_BUS_READ, 0x1FF, 300);
+  CHECK(I2CBusSubmit(&bus, &tr[0]) == HAL_OK);
+  CHECK(I2CBusSubmit(&bus, &tr[1]) == HAL_OK);
+  run();
+  CHECK(tr[0].Status == I2C_BUS_DONE && tr[1].Status == I2C_BUS_DONE);
+  CHECK(memcmp(tr[0].Data, tr[1].Data, 300) == 0);
+  e = &slaves[2];
+  e->ptr = 0x40;
+  set_tr(&tr[2], 0xA0, I2C_BUS_READ, 0, 3);
+  tr[2].RegSize = 0U;  /* current address read */
+  CHECK(I2CBusSubmit(&bus, &tr[2]) == HAL_OK);
+  run();
+  CHECK(tr[2].Status == I2C_BUS_DONE && memcmp(tr[2].Data, &e->mem[0x40], 3) == 0);
+
+  /* invalid requests */
+  set_tr(&tr[3], 0xA0, I2C_BUS_READ, 0, 0);
+  CHECK(I2CBusSubmit(&bus, &tr[3]) == HAL_ERROR);
+  set_tr(&tr[3], 0xA0, I2C_BUS_READ, 0, 1);
+  tr[3].RegSize = 3U;
+  CHECK(I2CBusSubmit(&bus, &tr[3]) == HAL_ERROR);
+  tr[3].RegSize = 2U; tr[3].Data = NULL;
+  CHECK(I2CBusSubmit(&bus, &tr[3]) == HAL_ERROR);
+
+  /* blocking transfer, with timeout on a held bus */
+  set_tr(&tr[3], 0x84, I2C_BUS_READ, 5, 8);
+  CHECK(I2CBusTransfer(&bus, &tr[3], 10) == HAL_OK);
+  r0 = bus.Transactions;
+  set_tr(&tr[4], 0xA0, I2C_BUS_READ, 0, 1);
+  tr[4].Length = 60000U;
+  tr[4].Data = bigbuf;
+  s0 = n_stop;
+  CHECK(I2CBusTransfer(&bus, &tr[4], 100) == HAL_TIMEOUT);
+  CHECK(tr[4].Status == I2C_BUS_CANCELLED && bus.Transactions == r0 + 1 && n_stop == s0 + 1);
+  CHECK(hi2c.State == HAL_I2C_STATE_READY && hw.phase == P_IDLE);
+}
+
+/* ---------------- benchmark ---------------- */
+/* One polling round of the evaluation board devices:
+   temperature (2 bytes), IO expander interrupt status (1) and GPIO state (3),
+   EEPROM log record (16), and every 8th round an EEPROM write (8). */
+static int round_set(int r)
+{
+  int n = 0;
+  set_tr(&tr[n++], 0x90, I2C_BUS_READ, 0x00, 2);
+  set_tr(&tr[n++], 0x84, I2C_BUS_READ, 0x0C, 1);
+  set_tr(&tr[n++], 0x84, I2C_BUS_READ, 0x10, 3);
+  set_tr(&tr[n++], 0xA0, I2C_BUS_READ, (uint16_t)(0x100 + 16 * (r % 64)), 16);
+  if ((r % 8) == 7) set_tr(&tr[n++], 0xA0, I2C_BUS_WRITE, (uint16_t)(0x800 + 8 * (r % 64)), 8);
+  return n;
+}
+
+static void bench(int dma, int queued, int rounds)
+{
+  int r, i, n;
+  uint64_t t0;
+  setup(dma);
+  t0 = now_ns;
+  for (r = 0; r < rounds; r++)
+  {
+    n = round_set(r);
+    now_ns += task_ns; /* task wake-up for the round */
+    if (queued)
+    {
+      for (i = 0; i < n; i++) CHECK(I2CBusSubmit(&bus, &tr[i]) == HAL_OK);
+      run();
+    }
+    else
+    {
+      for (i = 0; i < n; i++)
+      {
+        if (i != 0) now_ns += task_ns; /* each driver blocks on its own transfer */
+        CHECK(I2CBusSubmit(&bus, &tr[i]) == HAL_OK);
+        run();
+      }
+    }
+    CHECK(all_idle());
+    for (i = 0; i < n; i++) CHECK(tr[i].Status == I2C_BUS_DONE);
+  }
+  printf("  %-26s %s: %7.1f us/round, bus busy %5.1f%%, %.2f stops, %.2f starts, %.2f chained, %.1f irqs per round\n",
+         queued ? "queued" : "one transfer per wake-up", dma ? "DMA" : "IT ",
+         (double)(now_ns - t0) / 1000.0 / rounds, 100.0 * (double)busy_ns / (double)(now_ns - t0),
+         (double)n_stop / rounds, (double)n_start / rounds, (double)n_restart_w / rounds, (double)n_irq / rounds);
+}
+
+int main(int argc, char **argv)
+{
+  unsigned long steps = (argc > 1) ? strtoul(argv[1], NULL, 0) : 200000UL;
+  int dma;
+
+  if (argc > 2) { trace = 1; directed(atoi(argv[2])); return 0; }
+  if (getenv("STRESS")) { trace = getenv("TRACE") != NULL; stress(atoi(getenv("STRESS")), steps); return 0; }
+
+  for (dma = 1; dma >= 0; dma--)
+  {
+    directed(dma);
+    if (dma == 0 && getenv("TRACE")) trace = 1;
+    stress(dma, steps);
+    trace = 0;
+  }
+  printf("benchmark, merge reads %u, task wake-up %u us, ISR %u us, 400 kHz\n", (unsigned)I2C_BUS_MERGE_READS,
+         (unsigned)(task_ns / 1000U), ISR_NS / 1000U);
+  for (dma = 1; dma >= 0; dma--)
+  {
+    bench(dma, 0, 2000);
+    bench(dma, 1, 2000);
+  }
+  printf("%lu checks, %lu failures, %lu protocol errors\n", checks, failures, protocol_errors);
+  return failures != 0;
+}
@@ -0,0 +1,7 @@
+/* Host stub: all the HAL modules, the test only uses the I2C and DMA types */
+#include "stm32l0xx_hal_conf_template.h"
+
+/* The write-1-to-clear I2C ICR is emulated by a function of the model */
+void sim_i2c_clear_flag(I2C_TypeDef *regs, uint32_t flag);
+#undef __HAL_I2C_CLEAR_FLAG
+#define __HAL_I2C_CLEAR_FLAG(__HANDLE__, __FLAG__) sim_i2c_clear_flag((__HANDLE__)->Instance, (__FLAG__))
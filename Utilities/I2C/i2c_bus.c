@@ -0,0 +1,656 @@
+/**
+  ******************************************************************************
+  * @file    i2c_bus.c
+  * @author  MCD Application Team
+  * @brief   Shares an I2C master between several devices: queued register
+  *          transactions run back to back from the I2C interrupts, with the
+  *          consecutive register reads chained by repeated starts.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2020 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/********************** NOTES **********************************************
+To use this module, the following steps should be followed :
+
+1- initialize the I2C with HAL_I2C_Init() in 7 bit addressing mode, with its
+   Tx and Rx DMA channels linked to the handle (the transfers are made in
+   interrupt mode when there is no DMA), enable its event and error
+   interrupts, then call I2CBusInit().
+
+2- when USE_HAL_I2C_REGISTER_CALLBACKS is 0, call I2CBusTransferCplt() from
+   HAL_I2C_MasterTxCpltCallback() and HAL_I2C_MasterRxCpltCallback(), and
+   I2CBusTransferError() from HAL_I2C_ErrorCallback() and
+   HAL_I2C_AbortCpltCallback(). Otherwise I2CBusInit() registers them.
+
+3- describe each transfer with a I2CBusTransaction_t: device address,
+   direction, register address and size, and data buffer, then call
+   I2CBusSubmit() from a task or an interrupt. The transaction structure is
+   cleared before its first submission. The Callback of the transaction is
+   called from the I2C interrupt when it ends, or poll its Status.
+   I2CBusTransfer() submits a transaction and waits for its end, to replace
+   a polled HAL_I2C_Mem_Read() or HAL_I2C_Mem_Write().
+
+The transactions are served in submission order. A register read is sent
+as a write of the register address followed by a read, separated by a
+repeated start. When the next queued transaction is also a register read,
+of the same device or not, it is chained to the previous read with another
+repeated start instead of a stop and a new start, which saves the stop and
+the bus free time, and keeps the bus from other masters. A register write
+always ends with a stop, which starts the internal write cycle of the
+EEPROMs. I2C_BUS_MERGE_READS set to 0 ends every transaction with a stop.
+
+The next transaction is started from the interrupt that ends the previous
+one, before its callback is called, so that the bus does not wait for a task
+to be scheduled. The queue is protected by masking the interrupts for a few
+instructions, the callbacks are called with the interrupts enabled.
+
+A transaction and its buffer must stay valid until its callback has been
+called, or until its status is no longer I2C_BUS_QUEUED or I2C_BUS_ACTIVE
+when it has no callback. All the master accesses to the I2C must go through
+the bus.
+*******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "i2c_bus.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Bus steps */
+#define I2C_BUS_STEP_IDLE         0U  /* No transaction, the bus is released */
+#define I2C_BUS_STEP_REG          1U  /* Write of the register address */
+#define I2C_BUS_STEP_DATA         2U  /* Read or write of the data */
+#define I2C_BUS_STEP_STOP         3U  /* Address only write ending a held read */
+
+/* Private macro -------------------------------------------------------------*/
+#define I2C_BUS_ENTER_CRITICAL(primask)   do { (primask) = __get_PRIMASK(); __disable_irq(); } while (0)
+#define I2C_BUS_EXIT_CRITICAL(primask)    __set_PRIMASK(primask)
+
+/* Transaction that can be chained to a read with a repeated start */
+#define I2C_BUS_IS_REG_READ(transaction)  (((transaction) != NULL) && \
+                                           ((transaction)->Direction == I2C_BUS_READ) && \
+                                           ((transaction)->RegSize != 0U))
+
+/* Private function prototypes -----------------------------------------------*/
+static I2CBus_t            *I2CBusFind (I2C_HandleTypeDef *hi2c);
+static I2CBusTransaction_t *I2CBusStart (I2CBus_t *Bus);
+static HAL_StatusTypeDef   I2CBusStartFrame (I2CBus_t *Bus);
+static HAL_StatusTypeDef   I2CBusTransmit (I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                           uint16_t Size, uint32_t XferOptions);
+static HAL_StatusTypeDef   I2CBusReceive (I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                          uint16_t Size, uint32_t XferOptions);
+static I2CBusTransaction_t *I2CBusEnd (I2CBus_t *Bus, I2CBusStatus_t Status);
+static I2CBusTransaction_t *I2CBusRelease (I2CBus_t *Bus);
+static void                I2CBusNotify (I2CBus_t *Bus, I2CBusTransaction_t *Transaction);
+static void                I2CBusFrameCplt (I2CBus_t *Bus, uint32_t Error);
+
+/* Private variables ---------------------------------------------------------*/
+static I2CBus_t *I2CBusList[I2C_BUS_COUNT];
+
+/* Private functions ---------------------------------------------------------*/
+/**
+  * @brief  Attach a bus to an initialized I2C
+  * @param  Bus: bus to initialize
+  * @param  hi2c: I2C handle, 7 bit addressing
+  * @retval HAL status
+  */
+HAL_StatusTypeDef I2CBusInit (I2CBus_t *Bus, I2C_HandleTypeDef *hi2c)
+{
+  uint32_t slot = I2C_BUS_COUNT;
+  uint32_t i;
+
+  if ((Bus == NULL) || (hi2c == NULL) || (hi2c->State != HAL_I2C_STATE_READY) ||
+      (hi2c->Init.AddressingMode != I2C_ADDRESSINGMODE_7BIT))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Take the slot of a bus already on this I2C, or a free one */
+  for (i = 0U; i < I2C_BUS_COUNT; i++)
+  {
+    if ((I2CBusList[i] != NULL) && (I2CBusList[i]->hi2c == hi2c))
+    {
+      slot = i;
+      break;
+    }
+    if ((I2CBusList[i] == NULL) && (slot == I2C_BUS_COUNT))
+    {
+      slot = i;
+    }
+  }
+  if (slot == I2C_BUS_COUNT)
+  {
+    return HAL_ERROR;
+  }
+
+  Bus->hi2c         = hi2c;
+  Bus->Queue        = NULL;
+  Bus->Active       = NULL;
+  Bus->Step         = I2C_BUS_STEP_IDLE;
+  Bus->Hold         = 0U;
+  Bus->Abort        = 0U;
+  Bus->Transactions = 0U;
+  Bus->Errors       = 0U;
+  Bus->Bytes        = 0U;
+  Bus->Restarts     = 0U;
+
+#if (USE_HAL_I2C_REGISTER_CALLBACKS == 1U)
+  if ((HAL_I2C_RegisterCallback(hi2c, HAL_I2C_MASTER_TX_COMPLETE_CB_ID, I2CBusTransferCplt) != HAL_OK) ||
+      (HAL_I2C_RegisterCallback(hi2c, HAL_I2C_MASTER_RX_COMPLETE_CB_ID, I2CBusTransferCplt) != HAL_OK) ||
+      (HAL_I2C_RegisterCallback(hi2c, HAL_I2C_ERROR_CB_ID, I2CBusTransferError) != HAL_OK) ||
+      (HAL_I2C_RegisterCallback(hi2c, HAL_I2C_ABORT_CB_ID, I2CBusTransferError) != HAL_OK))
+  {
+    return HAL_ERROR;
+  }
+#endif /* USE_HAL_I2C_REGISTER_CALLBACKS */
+
+  I2CBusList[slot] = Bus;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Queue a transaction, and start it if the bus is free
+  * @param  Bus: bus
+  * @param  Transaction: transaction, with its DevAddress, Direction, Reg,
+  *         RegSize, Data, Length and Callback set
+  * @retval HAL_OK, HAL_BUSY if the transaction is already queued or in
+  *         progress, HAL_ERROR if it is not valid
+  */
+HAL_StatusTypeDef I2CBusSubmit (I2CBus_t *Bus, I2CBusTransaction_t *Transaction)
+{
+  I2CBusTransaction_t *failed = NULL;
+  I2CBusTransaction_t **link;
+  uint32_t primask;
+
+  if ((Bus == NULL) || (Transaction == NULL) || (Transaction->Data == NULL) || (Transaction->Length == 0U) ||
+      ((Transaction->Direction != I2C_BUS_READ) && (Transaction->Direction != I2C_BUS_WRITE)) ||
+      ((Transaction->RegSize != 0U) && (Transaction->RegSize != I2C_MEMADD_SIZE_8BIT) &&
+       (Transaction->RegSize != I2C_MEMADD_SIZE_16BIT)))
+  {
+    return HAL_ERROR;
+  }
+
+  I2C_BUS_ENTER_CRITICAL(primask);
+
+  if ((Transaction->Status == I2C_BUS_QUEUED) || (Transaction->Status == I2C_BUS_ACTIVE))
+  {
+    I2C_BUS_EXIT_CRITICAL(primask);
+    return HAL_BUSY;
+  }
+
+  Transaction->Status = I2C_BUS_QUEUED;
+  Transaction->Next = NULL;
+  for (link = &Bus->Queue; *link != NULL; link = &(*link)->Next)
+  {
+  }
+  *link = Transaction;
+
+  failed = I2CBusStart(Bus);
+
+  I2C_BUS_EXIT_CRITICAL(primask);
+
+  I2CBusNotify(Bus, failed);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Remove a queued transaction, or abort the transaction in progress.
+  *         Its status becomes I2C_BUS_CANCELLED and its callback is called,
+  *         at the end of the abort for a transaction in progress
+  * @param  Bus: bus
+  * @param  Transaction: transaction
+  * @retval HAL_OK, or HAL_ERROR if the transaction is neither queued nor in
+  *         progress
+  */
+HAL_StatusTypeDef I2CBusCancel (I2CBus_t *Bus, I2CBusTransaction_t *Transaction)
+{
+  I2CBusTransaction_t *cancelled = NULL;
+  I2CBusTransaction_t *failed = NULL;
+  I2CBusTransaction_t **link;
+  HAL_StatusTypeDef status = HAL_ERROR;
+  uint32_t primask;
+
+  I2C_BUS_ENTER_CRITICAL(primask);
+
+  if (Transaction->Status == I2C_BUS_QUEUED)
+  {
+    for (link = &Bus->Queue; *link != NULL; link = &(*link)->Next)
+    {
+      if (*link == Transaction)
+      {
+        *link = Transaction->Next;
+        Transaction->Next = NULL;
+        Transaction->Status = I2C_BUS_CANCELLED;
+        cancelled = Transaction;
+        status = HAL_OK;
+        break;
+      }
+    }
+  }
+  else if ((Transaction->Status == I2C_BUS_ACTIVE) && (Bus->Active == Transaction))
+  {
+    status = HAL_OK;
+    if (Bus->Abort == 0U)
+    {
+      /* The transfer ends with a stop, then HAL_I2C_AbortCpltCallback() */
+      if (HAL_I2C_Master_Abort_IT(Bus->hi2c, Transaction->DevAddress) == HAL_OK)
+      {
+        Bus->Abort = 1U;
+      }
+      else
+      {
+        /* No transfer in progress on the I2C */
+        Bus->Hold = 0U;
+        cancelled = I2CBusEnd(Bus, I2C_BUS_CANCELLED);
+        failed = I2CBusStart(Bus);
+      }
+    }
+  }
+  else
+  {
+    /* Not queued on this bus, or already ended */
+  }
+
+  I2C_BUS_EXIT_CRITICAL(primask);
+
+  I2CBusNotify(Bus, cancelled);
+  I2CBusNotify(Bus, failed);
+
+  return status;
+}
+
+/**
+  * @brief  Submit a transaction and wait for its end. Must not be called
+  *         from an interrupt of higher priority than the I2C and DMA ones
+  * @param  Bus: bus
+  * @param  Transaction: transaction
+  * @param  Timeout: timeout in ms, after which the transaction is cancelled,
+  *         or HAL_MAX_DELAY
+  * @retval HAL_OK, HAL_ERROR, HAL_BUSY or HAL_TIMEOUT
+  */
+HAL_StatusTypeDef I2CBusTransfer (I2CBus_t *Bus, I2CBusTransaction_t *Transaction, uint32_t Timeout)
+{
+  uint32_t tickstart = HAL_GetTick();
+  HAL_StatusTypeDef status;
+
+  status = I2CBusSubmit(Bus, Transaction);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  while ((Transaction->Status == I2C_BUS_QUEUED) || (Transaction->Status == I2C_BUS_ACTIVE))
+  {
+    if ((Timeout != HAL_MAX_DELAY) && ((HAL_GetTick() - tickstart) > Timeout))
+    {
+      /* Fails if the transaction has just ended, does nothing while the
+         abort is in progress */
+      (void)I2CBusCancel(Bus, Transaction);
+    }
+  }
+
+  switch (Transaction->Status)
+  {
+    case I2C_BUS_DONE:
+      status = HAL_OK;
+      break;
+    case I2C_BUS_CANCELLED:
+      status = HAL_TIMEOUT;
+      break;
+    default:
+      status = HAL_ERROR;
+      break;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  End of a frame reported by the HAL I2C
+  * @param  hi2c: I2C handle
+  * @retval None
+  */
+void I2CBusTransferCplt (I2C_HandleTypeDef *hi2c)
+{
+  I2CBus_t *bus = I2CBusFind(hi2c);
+
+  if (bus != NULL)
+  {
+    I2CBusFrameCplt(bus, 0U);
+  }
+}
+
+/**
+  * @brief  Error or end of abort reported by the HAL I2C, the bus is
+  *         released
+  * @param  hi2c: I2C handle
+  * @retval None
+  */
+void I2CBusTransferError (I2C_HandleTypeDef *hi2c)
+{
+  I2CBus_t *bus = I2CBusFind(hi2c);
+
+  if (bus != NULL)
+  {
+    I2CBusFrameCplt(bus, 1U);
+  }
+}
+
+/**
+  * @brief  Get the bus of an I2C
+  * @param  hi2c: I2C handle
+  * @retval Bus, or NULL if the I2C has no bus
+  */
+static I2CBus_t *I2CBusFind (I2C_HandleTypeDef *hi2c)
+{
+  uint32_t i;
+
+  for (i = 0U; i < I2C_BUS_COUNT; i++)
+  {
+    if ((I2CBusList[i] != NULL) && (I2CBusList[i]->hi2c == hi2c))
+    {
+      return I2CBusList[i];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  * @brief  Start the first queued transaction if the bus is free, or if it is
+  *         held by a read that the transaction is chained to. Called with the
+  *         interrupts masked
+  * @param  Bus: bus
+  * @retval Transaction that failed to start, whose callback must be called,
+  *         or NULL
+  */
+static I2CBusTransaction_t *I2CBusStart (I2CBus_t *Bus)
+{
+  I2CBusTransaction_t *transaction = Bus->Queue;
+
+  if ((Bus->Active != NULL) || (transaction == NULL) ||
+      ((Bus->Step != I2C_BUS_STEP_IDLE) && (Bus->Hold == 0U)))
+  {
+    return NULL;
+  }
+
+  Bus->Queue = transaction->Next;
+  transaction->Next = NULL;
+  transaction->Status = I2C_BUS_ACTIVE;
+  Bus->Active = transaction;
+
+  if (Bus->Hold != 0U)
+  {
+    Bus->Hold = 0U;
+    Bus->Restarts++;
+  }
+
+  if (transaction->RegSize == I2C_MEMADD_SIZE_16BIT)
+  {
+    Bus->RegBuffer[0] = I2C_MEM_ADD_MSB(transaction->Reg);
+    Bus->RegBuffer[1] = I2C_MEM_ADD_LSB(transaction->Reg);
+  }
+  else
+  {
+    Bus->RegBuffer[0] = I2C_MEM_ADD_LSB(transaction->Reg);
+  }
+  Bus->Step = (transaction->RegSize != 0U) ? I2C_BUS_STEP_REG : I2C_BUS_STEP_DATA;
+
+  if (I2CBusStartFrame(Bus) != HAL_OK)
+  {
+    return I2CBusEnd(Bus, I2C_BUS_ERROR);
+  }
+
+  return NULL;
+}
+
+/**
+  * @brief  Start the frame of the current step. The HAL generates a
+  *         (repeated) start when the direction changes or after a stop,
+  *         and continues the write of the register address otherwise
+  * @param  Bus: bus
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef I2CBusStartFrame (I2CBus_t *Bus)
+{
+  I2C_HandleTypeDef *hi2c = Bus->hi2c;
+  I2CBusTransaction_t *transaction = Bus->Active;
+  uint32_t options;
+
+  switch (Bus->Step)
+  {
+    case I2C_BUS_STEP_REG:
+      /* No stop after the address of a register: reload to continue with
+         the data to write, or end the frame for a repeated start */
+      options = (transaction->Direction == I2C_BUS_WRITE) ? I2C_FIRST_AND_NEXT_FRAME : I2C_FIRST_FRAME;
+      return I2CBusTransmit(hi2c, transaction->DevAddress, Bus->RegBuffer, transaction->RegSize, options);
+
+    case I2C_BUS_STEP_DATA:
+      if (transaction->Direction == I2C_BUS_WRITE)
+      {
+        return I2CBusTransmit(hi2c, transaction->DevAddress, transaction->Data, transaction->Length, I2C_LAST_FRAME);
+      }
+#if (I2C_BUS_MERGE_READS == 1U)
+      /* Keep the bus for the next register read, decided now since the
+         stop is generated by the I2C at the end of the frame */
+      Bus->Hold = I2C_BUS_IS_REG_READ(Bus->Queue) ? 1U : 0U;
+#endif /* I2C_BUS_MERGE_READS */
+      options = (Bus->Hold != 0U) ? I2C_LAST_FRAME_NO_STOP : I2C_LAST_FRAME;
+      return I2CBusReceive(hi2c, transaction->DevAddress, transaction->Data, transaction->Length, options);
+
+    default:
+      /* The register read the bus was held for has been cancelled: address
+         the last device again, without data, to end with a stop */
+      return I2CBusTransmit(hi2c, (uint16_t)(hi2c->Instance->CR2 & I2C_CR2_SADD), Bus->RegBuffer, 0U,
+                            I2C_LAST_FRAME);
+  }
+}
+
+/**
+  * @brief  Sequential write, with DMA when the I2C has a Tx DMA channel
+  * @param  hi2c: I2C handle
+  * @param  DevAddress: device address
+  * @param  pData: data to write
+  * @param  Size: number of bytes
+  * @param  XferOptions: I2C_XFEROPTIONS value
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef I2CBusTransmit (I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                         uint16_t Size, uint32_t XferOptions)
+{
+  if (hi2c->hdmatx != NULL)
+  {
+    return HAL_I2C_Master_Seq_Transmit_DMA(hi2c, DevAddress, pData, Size, XferOptions);
+  }
+  return HAL_I2C_Master_Seq_Transmit_IT(hi2c, DevAddress, pData, Size, XferOptions);
+}
+
+/**
+  * @brief  Sequential read, with DMA when the I2C has a Rx DMA channel
+  * @param  hi2c: I2C handle
+  * @param  DevAddress: device address
+  * @param  pData: buffer of the read data
+  * @param  Size: number of bytes
+  * @param  XferOptions: I2C_XFEROPTIONS value
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef I2CBusReceive (I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                        uint16_t Size, uint32_t XferOptions)
+{
+  if (hi2c->hdmarx != NULL)
+  {
+    return HAL_I2C_Master_Seq_Receive_DMA(hi2c, DevAddress, pData, Size, XferOptions);
+  }
+  return HAL_I2C_Master_Seq_Receive_IT(hi2c, DevAddress, pData, Size, XferOptions);
+}
+
+/**
+  * @brief  End the transaction in progress. Called with the interrupts
+  *         masked
+  * @param  Bus: bus
+  * @param  Status: final status of the transaction
+  * @retval Ended transaction, whose callback must be called
+  */
+static I2CBusTransaction_t *I2CBusEnd (I2CBus_t *Bus, I2CBusStatus_t Status)
+{
+  I2CBusTransaction_t *transaction = Bus->Active;
+
+  Bus->Active = NULL;
+  Bus->Abort = 0U;
+  Bus->Transactions++;
+  if (Status == I2C_BUS_DONE)
+  {
+    Bus->Bytes += transaction->Length;
+  }
+  else if (Status == I2C_BUS_ERROR)
+  {
+    Bus->Errors++;
+  }
+  else
+  {
+    /* Cancelled */
+  }
+
+  /* The I2C has generated the stop, unless the read holds the bus */
+  if (Bus->Hold == 0U)
+  {
+    Bus->Step = I2C_BUS_STEP_IDLE;
+  }
+
+  transaction->Status = Status;
+
+  return transaction;
+}
+
+/**
+  * @brief  After a read that holds the bus, chain the next register read or
+  *         release the bus with an address only write. Called with the
+  *         interrupts masked
+  * @param  Bus: bus
+  * @retval Transaction that failed to start, whose callback must be called,
+  *         or NULL
+  */
+static I2CBusTransaction_t *I2CBusRelease (I2CBus_t *Bus)
+{
+  I2CBusTransaction_t *failed = NULL;
+
+  if (I2C_BUS_IS_REG_READ(Bus->Queue))
+  {
+    failed = I2CBusStart(Bus);
+  }
+
+  if (Bus->Active == NULL)
+  {
+    Bus->Hold = 0U;
+    Bus->Step = I2C_BUS_STEP_STOP;
+    if (I2CBusStartFrame(Bus) != HAL_OK)
+    {
+      Bus->Step = I2C_BUS_STEP_IDLE;
+    }
+  }
+
+  return failed;
+}
+
+/**
+  * @brief  Call the callback of an ended transaction, then those of the
+  *         transactions that fail to start
+  * @param  Bus: bus
+  * @param  Transaction: ended transaction, or NULL
+  * @retval None
+  */
+static void I2CBusNotify (I2CBus_t *Bus, I2CBusTransaction_t *Transaction)
+{
+  uint32_t primask;
+
+  while (Transaction != NULL)
+  {
+    if (Transaction->Callback != NULL)
+    {
+      Transaction->Callback(Transaction);
+    }
+
+    I2C_BUS_ENTER_CRITICAL(primask);
+    Transaction = I2CBusStart(Bus);
+    I2C_BUS_EXIT_CRITICAL(primask);
+  }
+}
+
+/**
+  * @brief  Chain the next frame of the transaction, or end it and start the
+  *         next one
+  * @param  Bus: bus
+  * @param  Error: 1 if the frame failed or has been aborted
+  * @retval None
+  */
+static void I2CBusFrameCplt (I2CBus_t *Bus, uint32_t Error)
+{
+  I2CBusTransaction_t *ended = NULL;
+  I2CBusTransaction_t *failed = NULL;
+  uint32_t primask;
+
+  I2C_BUS_ENTER_CRITICAL(primask);
+
+  if (Bus->Active != NULL)
+  {
+    if (Error != 0U)
+    {
+      /* The I2C has generated a stop */
+      Bus->Hold = 0U;
+      ended = I2CBusEnd(Bus, (Bus->Abort != 0U) ? I2C_BUS_CANCELLED : I2C_BUS_ERROR);
+    }
+    else if (Bus->Step == I2C_BUS_STEP_REG)
+    {
+      Bus->Step = I2C_BUS_STEP_DATA;
+      if (I2CBusStartFrame(Bus) != HAL_OK)
+      {
+        ended = I2CBusEnd(Bus, I2C_BUS_ERROR);
+      }
+    }
+    else
+    {
+      ended = I2CBusEnd(Bus, I2C_BUS_DONE);
+    }
+
+    if ((ended != NULL) && (Bus->Hold != 0U))
+    {
+      failed = I2CBusRelease(Bus);
+    }
+    else if (ended != NULL)
+    {
+      failed = I2CBusStart(Bus);
+    }
+    else
+    {
+      /* Next frame in progress */
+    }
+  }
+  else if (Bus->Step == I2C_BUS_STEP_STOP)
+  {
+    /* End of the address only write, acknowledged or not */
+    Bus->Step = I2C_BUS_STEP_IDLE;
+    failed = I2CBusStart(Bus);
+  }
+  else
+  {
+    /* Ignore the transfers that are not made by the bus */
+  }
+
+  I2C_BUS_EXIT_CRITICAL(primask);
+
+  I2CBusNotify(Bus, ended);
+  I2CBusNotify(Bus, failed);
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
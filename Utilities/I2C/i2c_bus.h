@@ -0,0 +1,114 @@
+/**
+  ******************************************************************************
+  * @file    i2c_bus.h
+  * @author  MCD Application Team
+  * @brief   Header for i2c_bus module
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2020 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _I2C_BUS_H__
+#define _I2C_BUS_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32l0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Number of buses that can be registered by I2CBusInit() */
+#ifndef I2C_BUS_COUNT
+#define I2C_BUS_COUNT             2U
+#endif
+
+/* Set to 0 to end every transaction with a stop condition, instead of
+   chaining the register reads with repeated starts */
+#ifndef I2C_BUS_MERGE_READS
+#define I2C_BUS_MERGE_READS       1U
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum
+{
+  I2C_BUS_IDLE = 0,               /* Never submitted */
+  I2C_BUS_QUEUED,
+  I2C_BUS_ACTIVE,
+  I2C_BUS_DONE,
+  I2C_BUS_ERROR,                  /* Not acknowledged, or I2C or DMA error */
+  I2C_BUS_CANCELLED
+} I2CBusStatus_t;
+
+typedef enum
+{
+  I2C_BUS_READ = 0,
+  I2C_BUS_WRITE
+} I2CBusDirection_t;
+
+/* A register read or write of a device, or a plain read or write when
+   RegSize is 0 */
+typedef struct I2CBusTransaction
+{
+  uint16_t             DevAddress; /* 7 bit address shifted left, as for the HAL */
+  I2CBusDirection_t    Direction;
+  uint16_t             Reg;       /* Register (or memory) address */
+  uint16_t             RegSize;   /* 0, I2C_MEMADD_SIZE_8BIT or I2C_MEMADD_SIZE_16BIT */
+  uint8_t              *Data;
+  uint16_t             Length;
+  /* Called from the I2C (or DMA) interrupt when the transaction ends. Can
+     submit the next transaction */
+  void                 (*Callback)(struct I2CBusTransaction *Transaction);
+  void                 *Context;  /* For the application */
+  __IO I2CBusStatus_t  Status;
+  /* Private */
+  struct I2CBusTransaction *Next;
+} I2CBusTransaction_t;
+
+typedef struct
+{
+  I2C_HandleTypeDef    *hi2c;
+  I2CBusTransaction_t  *Queue;    /* Waiting transactions, in submission order */
+  I2CBusTransaction_t  *Active;
+  uint8_t              Step;      /* Frame in progress */
+  uint8_t              Hold;      /* 1 if the frame in progress ends without stop */
+  uint8_t              Abort;     /* 1 if the active transaction is being aborted */
+  uint8_t              RegBuffer[2]; /* Register address of the active transaction */
+  uint32_t             Transactions; /* Ended transactions */
+  uint32_t             Errors;
+  uint32_t             Bytes;     /* Transferred data bytes */
+  uint32_t             Restarts;  /* Transactions chained with a repeated start */
+} I2CBus_t;
+
+/* Exported variables --------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+HAL_StatusTypeDef I2CBusInit (I2CBus_t *Bus, I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef I2CBusSubmit (I2CBus_t *Bus, I2CBusTransaction_t *Transaction);
+HAL_StatusTypeDef I2CBusCancel (I2CBus_t *Bus, I2CBusTransaction_t *Transaction);
+HAL_StatusTypeDef I2CBusTransfer (I2CBus_t *Bus, I2CBusTransaction_t *Transaction, uint32_t Timeout);
+
+/* To be called from HAL_I2C_MasterTxCpltCallback(),
+   HAL_I2C_MasterRxCpltCallback(), HAL_I2C_ErrorCallback() and
+   HAL_I2C_AbortCpltCallback() when the HAL I2C callbacks are not registered
+   (USE_HAL_I2C_REGISTER_CALLBACKS is 0) */
+void I2CBusTransferCplt (I2C_HandleTypeDef *hi2c);
+void I2CBusTransferError (I2C_HandleTypeDef *hi2c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _I2C_BUS_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
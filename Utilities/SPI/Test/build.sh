@@ -0,0 +1,16 @@
+#!/bin/sh
+# Build and run the host mock of the SPI bus manager with the host compiler,
+# without optimization then at -O2. Usage: sh build.sh [output directory]
+set -e
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT="$HERE/../../.."
+OUT=${1:-${TMPDIR:-/tmp}/spi_bus_test}
+CC=${CC:-cc}
+mkdir -p "$OUT"
+CFLAGS="-DSTM32L073xx -DUSE_HAL_DRIVER -include $ROOT/Utilities/Test/cmsis_host.h -I$HERE -I$ROOT/Utilities/SPI \
+ -I$ROOT/Drivers/STM32L0xx_HAL_Driver/Inc -I$ROOT/Drivers/CMSIS/Device/ST/STM32L0xx/Include \
+ -I$ROOT/Drivers/CMSIS/Include -Wall -Wno-int-to-pointer-cast"
+for OPT in -O0 -O2; do
+  $CC $CFLAGS $OPT -o "$OUT/spi_bus_mock$OPT" "$HERE/spi_bus_mock.c" "$ROOT/Utilities/SPI/spi_bus.c"
+  "$OUT/spi_bus_mock$OPT"
+done
@@ -0,0 +1,524 @@
+/* Host mock of a SPI master with DMA driving the SPI bus manager: byte timing
+   per prescaler, chip select lines, CR1 configuration and device replies.
+   Directed tests (cancel, abort, timeout, start and transfer errors, aging),
+   then throughput and fairness under random load in DMA and IT modes.
+   Build and run with build.sh */
+#include "spi_bus.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+uint32_t sim_primask, sim_critical_entries;
+static unsigned long checks, failures;
+#define CHECK(c) do { checks++; if (!(c)) { failures++; if (failures < 30) printf("FAIL %d %s\n", __LINE__, #c); } } while (0)
+
+static SPI_TypeDef spi_regs;
+static SPI_HandleTypeDef hspi;
+static DMA_HandleTypeDef dmatx, dmarx;
+static GPIO_TypeDef gpio;
+static SPIBus_t bus;
+
+#define NDEV 4
+static SPIBusDevice_t dev[NDEV];
+
+/* ---- time and mock peripheral ---- */
+static uint64_t now_ns;
+static int in_isr;
+static int aborting;
+static struct
+{
+  int busy;
+  uint64_t end;
+  const uint8_t *tx;
+  uint8_t *rx;
+  uint16_t len;
+  int devi;
+  int error;
+  int via_dma;
+} xfer;
+static uint64_t busy_ns, last_end_ns, gap_ns, max_gap_ns;
+static unsigned long dma_calls, it_calls, aborts;
+
+static int device_index(void)
+{
+  int i, found = -1, low = 0;
+  for (i = 0; i < NDEV; i++)
+  {
+    if ((gpio.ODR & dev[i].CsPin) == 0U) { found = i; low++; }
+  }
+  return (low == 1) ? found : -1;
+}
+
+static uint32_t byte_ns(int d)
+{
+  uint32_t div = 2U << (dev[d].BaudRatePrescaler >> SPI_CR1_BR_Pos);
+  return 8U * div * 1000U / 32U; /* 32 MHz PCLK */
+}
+
+static HAL_StatusTypeDef mock_start(const uint8_t *tx, uint8_t *rx, uint16_t len, int dma)
+{
+  int d;
+  if (hspi.State != HAL_SPI_STATE_READY) return HAL_BUSY;
+  if (len == 7) return HAL_ERROR; /* start failure injection */
+  CHECK(sim_primask);   /* started from the bus, queue locked */
+  CHECK(!aborting);     /* not before the abort is over */
+  d = device_index();
+  CHECK(d >= 0);
+  if (d < 0) return HAL_ERROR;
+  CHECK((spi_regs.CR1 & (SPI_CR1_BR | SPI_CR1_CPOL | SPI_CR1_CPHA | SPI_CR1_LSBFIRST)) ==
+        (dev[d].BaudRatePrescaler | dev[d].CLKPolarity | dev[d].CLKPhase | dev[d].FirstBit));
+  hspi.State = HAL_SPI_STATE_BUSY_TX_RX;
+  xfer.busy = 1;
+  xfer.tx = tx; xfer.rx = rx; xfer.len = len; xfer.devi = d;
+  xfer.end = now_ns + (uint64_t)len * byte_ns(d);
+  xfer.error = (len == 13);
+  xfer.via_dma = dma;
+  if (dma) dma_calls++; else it_calls++;
+  if (last_end_ns != 0)
+  {
+    uint64_t g = now_ns - last_end_ns;
+    gap_ns += g;
+    if (g > max_gap_ns) max_gap_ns = g;
+  }
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *h, uint8_t *p, uint16_t n) { (void)h; return mock_start(p, NULL, n, 1); }
+HAL_StatusTypeDef HAL_SPI_Transmit_IT(SPI_HandleTypeDef *h, uint8_t *p, uint16_t n) { (void)h; return mock_start(p, NULL, n, 0); }
+HAL_StatusTypeDef HAL_SPI_Receive_DMA(SPI_HandleTypeDef *h, uint8_t *p, uint16_t n) { (void)h; return mock_start(p, p, n, 1); }
+HAL_StatusTypeDef HAL_SPI_Receive_IT(SPI_HandleTypeDef *h, uint8_t *p, uint16_t n) { (void)h; return mock_start(p, p, n, 0); }
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *h, uint8_t *t, uint8_t *r, uint16_t n) { (void)h; return mock_start(t, r, n, 1); }
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_IT(SPI_HandleTypeDef *h, uint8_t *t, uint8_t *r, uint16_t n) { (void)h; return mock_start(t, r, n, 0); }
+/* called at the start of an abort, as an interrupt taken meanwhile */
+static void (*abort_hook)(void);
+HAL_StatusTypeDef HAL_SPI_Abort(SPI_HandleTypeDef *h)
+{
+  CHECK(sim_primask == 0);  /* blocking, not with the interrupts masked */
+  aborting = 1;
+  if (abort_hook != NULL) abort_hook();
+  aborting = 0;
+  h->State = HAL_SPI_STATE_READY;
+  if (xfer.busy) { busy_ns += now_ns - (xfer.end - (uint64_t)xfer.len * byte_ns(xfer.devi)); last_end_ns = now_ns; }
+  xfer.busy = 0;
+  aborts++;
+  return HAL_OK;
+}
+void HAL_GPIO_WritePin(GPIO_TypeDef *p, uint16_t pin, GPIO_PinState s)
+{
+  if (s == GPIO_PIN_RESET) p->ODR &= ~(uint32_t)pin; else p->ODR |= pin;
+}
+
+/* device reply: function of the byte on MOSI, device and index */
+static uint8_t reply(int d, uint8_t mosi, uint32_t i) { return (uint8_t)(mosi ^ (0x11U * (uint32_t)(d + 1)) ^ i); }
+
+/* the SPI/DMA interrupt, when the transfer is over and interrupts are enabled */
+static void run_isr(void)
+{
+  uint32_t i;
+  if (!xfer.busy || now_ns < xfer.end || sim_primask) return;
+  CHECK(device_index() == xfer.devi);
+  for (i = 0; i < xfer.len; i++)
+  {
+    uint8_t mosi = xfer.tx ? xfer.tx[i] : 0x00;
+    if (xfer.rx) xfer.rx[i] = reply(xfer.devi, mosi, i);
+  }
+  busy_ns += (uint64_t)xfer.len * byte_ns(xfer.devi);
+  last_end_ns = xfer.end;
+  xfer.busy = 0;
+  hspi.State = HAL_SPI_STATE_READY;
+  in_isr = 1;
+  if (xfer.error) SPIBusTransferError(&hspi); else SPIBusTransferCplt(&hspi);
+  in_isr = 0;
+}
+
+uint32_t HAL_GetTick(void)
+{
+  /* polling loops advance the time, interrupts may fire */
+  now_ns += 1000;
+  run_isr();
+  return (uint32_t)(now_ns / 1000000U);
+}
+
+/* ---- clients ---- */
+#define MAXSEG 3
+typedef struct
+{
+  SPIBusTransaction_t t;
+  SPIBusSegment_t seg[MAXSEG];
+  uint8_t txbuf[MAXSEG][600];
+  uint8_t rxbuf[MAXSEG][600];
+  int client;
+  int inuse;
+  int nseg;
+  int expect_error;
+  uint64_t submit_ns, start_ns;
+  unsigned long submit_seq;
+  unsigned overtaken_obs;
+  int started;
+} Job;
+
+#define NCLIENT 4
+#define JOBS_PER_CLIENT 4
+static Job jobs[NCLIENT][JOBS_PER_CLIENT];
+static unsigned long submit_seq;
+static uint64_t wait_sum[NCLIENT], wait_max[NCLIENT];
+static unsigned long done_count[NCLIENT], err_count, cb_count;
+static unsigned max_overtaken;
+static int resubmit_from_cb = 1;
+static const uint8_t client_prio[NCLIENT] = { 3, 2, 1, 1 };
+static const int client_dev[NCLIENT] = { 0, 1, 2, 3 };
+static SPIBusTransaction_t *last_active;
+
+static void check_new_active(void)
+{
+  /* called after every bus operation: detect the start of a transaction */
+  SPIBusTransaction_t *a = bus.Active, *q;
+  Job *ja, *jq;
+  int c, j;
+  if (a == NULL || a == last_active) { last_active = a; return; }
+  last_active = a;
+  ja = (Job *)a;
+  ja->started = 1;
+  ja->start_ns = now_ns;
+  /* a queued transaction of higher priority was submitted after this one */
+  for (q = bus.Queue; q != NULL; q = q->Next)
+  {
+    jq = (Job *)q;
+    if (q->Priority > a->Priority) CHECK(jq->submit_seq > ja->submit_seq);
+  }
+  /* the queued transactions submitted before this one are overtaken */
+  for (c = 0; c < NCLIENT; c++)
+    for (j = 0; j < JOBS_PER_CLIENT; j++)
+    {
+      jq = &jobs[c][j];
+      if (jq->inuse && jq->t.Status == SPI_BUS_QUEUED && jq->submit_seq < ja->submit_seq)
+      {
+        jq->overtaken_obs++;
+        if (jq->overtaken_obs > max_overtaken) max_overtaken = jq->overtaken_obs;
+        CHECK(jq->overtaken_obs <= SPI_BUS_OVERTAKE_LIMIT);
+      }
+    }
+}
+
+static void prepare(Job *jb, int client)
+{
+  int s, i;
+  jb->client = client;
+  jb->nseg = 1 + rand() % MAXSEG;
+  jb->expect_error = 0;
+  memset(&jb->t, 0, sizeof jb->t);
+  for (s = 0; s < jb->nseg; s++)
+  {
+    SPIBusSegment_t *g = &jb->seg[s];
+    int kind = rand() % 3;
+    g->Length = (uint16_t)(1 + rand() % (client == 0 ? 512 : 64));
+    if (g->Length == 7 || g->Length == 13) jb->expect_error = 1;
+    g->TxData = (kind != 1) ? jb->txbuf[s] : NULL;
+    g->RxData = (kind != 0) ? jb->rxbuf[s] : NULL;
+    for (i = 0; i < g->Length; i++) jb->txbuf[s][i] = (uint8_t)rand();
+    memset(jb->rxbuf[s], 0x5A, g->Length);
+    g->Next = (s + 1 < jb->nseg) ? &jb->seg[s + 1] : NULL;
+  }
+  jb->t.Device = &dev[client_dev[client]];
+  jb->t.Segments = &jb->seg[0];
+  jb->t.Priority = client_prio[client];
+  jb->t.Context = jb;
+}
+
+static void job_cb(SPIBusTransaction_t *t);
+
+static void submit(Job *jb)
+{
+  HAL_StatusTypeDef st;
+  jb->inuse = 1;
+  jb->started = 0;
+  jb->overtaken_obs = 0;
+  jb->submit_ns = now_ns;
+  jb->submit_seq = ++submit_seq;
+  jb->t.Callback = job_cb;
+  st = SPIBusSubmit(&bus, &jb->t);
+  CHECK(st == HAL_OK);
+  check_new_active();
+}
+
+static void job_cb(SPIBusTransaction_t *t)
+{
+  Job *jb = (Job *)t->Context;
+  int s, i, d = client_dev[jb->client];
+  cb_count++;
+  CHECK(sim_primask == 0);
+  if (bus.Active == NULL || bus.Active->Device != &dev[d]) CHECK((gpio.ODR & dev[d].CsPin) != 0U); /* released */
+  check_new_active();
+  if (t->Status == SPI_BUS_DONE)
+  {
+    uint64_t w = jb->start_ns - jb->submit_ns;
+    CHECK(jb->started);
+    CHECK(!jb->expect_error);
+    for (s = 0; s < jb->nseg; s++)
+    {
+      SPIBusSegment_t *g = &jb->seg[s];
+      if (g->RxData)
+        for (i = 0; i < g->Length; i++)
+        {
+          uint8_t mosi = g->TxData ? g->TxData[i] : SPI_BUS_FILL_BYTE;
+          CHECK(g->RxData[i] == reply(d, mosi, (uint32_t)i));
+        }
+    }
+    done_count[jb->client]++;
+    wait_sum[jb->client] += w;
+    if (w > wait_max[jb->client]) wait_max[jb->client] = w;
+  }
+  else
+  {
+    CHECK(t->Status == SPI_BUS_ERROR);
+    CHECK(jb->expect_error);
+    err_count++;
+  }
+  jb->inuse = 0;
+  /* streaming client: queue the next transfer from the callback */
+  if (resubmit_from_cb && jb->client == 0 && (rand() % 2))
+  {
+    prepare(jb, 0);
+    submit(jb);
+  }
+}
+
+static void setup(int use_dma)
+{
+  int i;
+  memset(&spi_regs, 0, sizeof spi_regs);
+  memset(&hspi, 0, sizeof hspi);
+  memset(&xfer, 0, sizeof xfer);
+  hspi.Instance = &spi_regs;
+  hspi.State = HAL_SPI_STATE_READY;
+  hspi.Init.Mode = SPI_MODE_MASTER;
+  hspi.Init.Direction = SPI_DIRECTION_2LINES;
+  hspi.Init.DataSize = SPI_DATASIZE_8BIT;
+  hspi.hdmatx = use_dma ? &dmatx : NULL;
+  hspi.hdmarx = use_dma ? &dmarx : NULL;
+  gpio.ODR = 0xFFFF;
+  for (i = 0; i < NDEV; i++)
+  {
+    dev[i].CsPort = &gpio;
+    dev[i].CsPin = (uint16_t)(1U << i);
+    dev[i].BaudRatePrescaler = (i == 0) ? SPI_BAUDRATEPRESCALER_2 : (i == 1 ? SPI_BAUDRATEPRESCALER_8 : SPI_BAUDRATEPRESCALER_32);
+    dev[i].CLKPolarity = (i & 1) ? SPI_POLARITY_HIGH : SPI_POLARITY_LOW;
+    dev[i].CLKPhase = (i & 2) ? SPI_PHASE_2EDGE : SPI_PHASE_1EDGE;
+    dev[i].FirstBit = (i == 3) ? SPI_FIRSTBIT_LSB : SPI_FIRSTBIT_MSB;
+  }
+  CHECK(SPIBusInit(&bus, &hspi) == HAL_OK);
+  last_active = NULL;
+  busy_ns = 0; last_end_ns = 0; gap_ns = 0; max_gap_ns = 0;
+}
+
+/* Saturated random load from all clients */
+static void load_test(int use_dma, uint64_t duration_ns, int mean_gap_us)
+{
+  uint64_t next_arrival[NCLIENT];
+  uint64_t start;
+  int c, j;
+  setup(use_dma);
+  memset(jobs, 0, sizeof jobs);
+  memset(done_count, 0, sizeof done_count);
+  memset(wait_sum, 0, sizeof wait_sum);
+  memset(wait_max, 0, sizeof wait_max);
+  err_count = 0;
+  start = now_ns;
+  for (c = 0; c < NCLIENT; c++) next_arrival[c] = now_ns + (uint64_t)(rand() % 50) * 1000;
+
+  while (now_ns < start + duration_ns)
+  {
+    /* next event */
+    uint64_t t = xfer.busy ? xfer.end : UINT64_MAX;
+    for (c = 0; c < NCLIENT; c++) if (next_arrival[c] < t) t = next_arrival[c];
+    if (t > now_ns) now_ns = t;
+    run_isr();
+    for (c = 0; c < NCLIENT; c++)
+    {
+      if (next_arrival[c] <= now_ns)
+      {
+        for (j = 0; j < JOBS_PER_CLIENT; j++)
+        {
+          if (!jobs[c][j].inuse)
+          {
+            prepare(&jobs[c][j], c);
+            submit(&jobs[c][j]);
+            break;
+          }
+        }
+        next_arrival[c] = now_ns + 1000 + (uint64_t)(rand() % (2 * mean_gap_us + 1)) * 1000;
+      }
+    }
+  }
+  /* drain */
+  for (c = 0; c < NCLIENT; c++) next_arrival[c] = UINT64_MAX;
+  resubmit_from_cb = 0;
+  while (xfer.busy) { now_ns = xfer.end; run_isr(); }
+  resubmit_from_cb = 1;
+  CHECK(bus.Queue == NULL && bus.Active == NULL);
+  CHECK(gpio.ODR == 0xFFFF);
+  for (c = 0; c < NCLIENT; c++) for (j = 0; j < JOBS_PER_CLIENT; j++) CHECK(!jobs[c][j].inuse);
+
+  printf("%s gap %3dus: util %5.1f%%, %lu transactions, %lu errors, %.1f KB/s, gap total %llu ns max %llu ns\n",
+         use_dma ? "DMA" : "IT ", mean_gap_us, 100.0 * (double)busy_ns / (double)(now_ns - start), (unsigned long)bus.Transactions,
+         (unsigned long)bus.Errors, (double)bus.Bytes / ((double)(now_ns - start) / 1e9) / 1024.0,
+         (unsigned long long)gap_ns, (unsigned long long)max_gap_ns);
+  for (c = 0; c < NCLIENT; c++)
+    printf("  client %d prio %u: %6lu done, wait avg %8.1f us max %8.1f us\n", c, client_prio[c], done_count[c],
+           done_count[c] ? (double)wait_sum[c] / done_count[c] / 1000.0 : 0.0, (double)wait_max[c] / 1000.0);
+  CHECK(err_count == bus.Errors);
+}
+
+static int cb_calls;
+static SPIBusStatus_t cb_status[8];
+static void simple_cb(SPIBusTransaction_t *t) { cb_status[cb_calls++ & 7] = t->Status; CHECK(sim_primask == 0); }
+
+static SPIBusTransaction_t *abort_t2;
+static void abort_window(void)
+{
+  run_isr();                                    /* end of the aborted transfer */
+  CHECK(abort_t2 != NULL && SPIBusSubmit(&bus, abort_t2) == HAL_OK);
+  CHECK(abort_t2->Status == SPI_BUS_QUEUED);
+  CHECK(SPIBusCancel(&bus, bus.Active) == HAL_ERROR);   /* already being aborted */
+  CHECK(bus.Active->Status == SPI_BUS_ACTIVE);
+}
+
+static void directed(void)
+{
+  static uint8_t a[64], b[64], big[600];
+  SPIBusSegment_t s1 = { a, b, 64, NULL }, s2 = { big, NULL, 600, NULL }, s3 = { NULL, b, 16, NULL };
+  SPIBusSegment_t bad = { NULL, NULL, 4, NULL }, zero = { a, NULL, 0, NULL };
+  SPIBusTransaction_t t1, t2, t3, t4;
+  int i;
+
+  setup(1);
+  memset(&t1, 0, sizeof t1); memset(&t2, 0, sizeof t2); memset(&t3, 0, sizeof t3); memset(&t4, 0, sizeof t4);
+
+  /* invalid */
+  t1.Device = &dev[0]; t1.Segments = &bad;
+  CHECK(SPIBusSubmit(&bus, &t1) == HAL_ERROR);
+  t1.Segments = &zero;
+  CHECK(SPIBusSubmit(&bus, &t1) == HAL_ERROR);
+  t1.Segments = NULL;
+  CHECK(SPIBusSubmit(&bus, &t1) == HAL_ERROR);
+
+  /* double submission, cancel queued, cancel active */
+  t1.Segments = &s2; t1.Device = &dev[2]; t1.Callback = simple_cb;   /* slow device: 600 bytes */
+  t2.Segments = &s1; t2.Device = &dev[1]; t2.Callback = simple_cb;
+  t3.Segments = &s3; t3.Device = &dev[0]; t3.Callback = simple_cb;
+  CHECK(SPIBusSubmit(&bus, &t1) == HAL_OK);
+  CHECK(t1.Status == SPI_BUS_ACTIVE && (gpio.ODR & dev[2].CsPin) == 0);
+  CHECK(SPIBusSubmit(&bus, &t1) == HAL_BUSY);
+  CHECK(SPIBusSubmit(&bus, &t2) == HAL_OK);
+  CHECK(SPIBusSubmit(&bus, &t3) == HAL_OK);
+  CHECK(t2.Status == SPI_BUS_QUEUED);
+  cb_calls = 0;
+  CHECK(SPIBusCancel(&bus, &t2) == HAL_OK);
+  CHECK(t2.Status == SPI_BUS_CANCELLED && cb_calls == 1);
+  CHECK(SPIBusCancel(&bus, &t2) == HAL_ERROR);
+  CHECK(SPIBusCancel(&bus, &t1) == HAL_OK);
+  CHECK(aborts == 1);
+  CHECK(t1.Status == SPI_BUS_CANCELLED && cb_calls == 2);
+  CHECK((gpio.ODR & dev[2].CsPin) != 0);
+  CHECK(t3.Status == SPI_BUS_ACTIVE && (gpio.ODR & dev[0].CsPin) == 0);
+  now_ns = xfer.end; run_isr();
+  CHECK(t3.Status == SPI_BUS_DONE && cb_calls == 3);
+  for (i = 0; i < 16; i++) CHECK(b[i] == reply(0, 0xFF, (uint32_t)i));
+  CHECK(gpio.ODR == 0xFFFF);
+
+  /* cancel while the transfer ends and another transaction is submitted
+     from an interrupt: the end is ignored, the new one waits for the abort */
+  t1.Segments = &s2; t1.Callback = simple_cb;
+  t2.Segments = &s3; t2.Callback = simple_cb;
+  cb_calls = 0;
+  CHECK(SPIBusSubmit(&bus, &t1) == HAL_OK);
+  now_ns = xfer.end;
+  abort_hook = abort_window;
+  abort_t2 = &t2;
+  CHECK(SPIBusCancel(&bus, &t1) == HAL_OK);
+  abort_hook = NULL;
+  CHECK(t1.Status == SPI_BUS_CANCELLED && cb_calls == 1);
+  CHECK(t2.Status == SPI_BUS_ACTIVE && (gpio.ODR & dev[1].CsPin) == 0);
+  now_ns = xfer.end; run_isr();
+  CHECK(t2.Status == SPI_BUS_DONE && cb_calls == 2);
+  CHECK(gpio.ODR == 0xFFFF);
+
+  /* blocking transfer */
+  t4.Segments = &s1; t4.Device = &dev[3];
+  for (i = 0; i < 64; i++) a[i] = (uint8_t)(3 * i);
+  CHECK(SPIBusTransfer(&bus, &t4, 10) == HAL_OK);
+  for (i = 0; i < 64; i++) CHECK(b[i] == reply(3, a[i], (uint32_t)i));
+  CHECK((spi_regs.CR1 & SPI_CR1_LSBFIRST) != 0);
+
+  /* blocking transfer timing out behind a long transaction: cancelled */
+  dev[2].BaudRatePrescaler = SPI_BAUDRATEPRESCALER_256;
+  t1.Callback = NULL;
+  CHECK(SPIBusSubmit(&bus, &t1) == HAL_OK);  /* 600 bytes at 125 kHz: 38 ms */
+  CHECK(SPIBusTransfer(&bus, &t4, 5) == HAL_TIMEOUT);
+  CHECK(t4.Status == SPI_BUS_CANCELLED && t1.Status == SPI_BUS_ACTIVE);
+  /* the blocking transfer of the active transaction waits for it */
+  CHECK(SPIBusCancel(&bus, &t1) == HAL_OK);
+  dev[2].BaudRatePrescaler = SPI_BAUDRATEPRESCALER_32;
+  CHECK(SPIBusTransfer(&bus, &t4, 1000) == HAL_OK);
+
+  /* start failure and transfer error go on with the next transaction */
+  {
+    SPIBusSegment_t f1 = { a, NULL, 5, NULL }, f0 = { a, NULL, 7, &f1 }, e0 = { a, b, 13, NULL };
+    t1.Segments = &e0; t1.Callback = simple_cb;
+    t2.Segments = &f0;
+    t3.Segments = &s1;
+    cb_calls = 0;
+    CHECK(SPIBusSubmit(&bus, &t1) == HAL_OK);
+    CHECK(SPIBusSubmit(&bus, &t2) == HAL_OK);
+    CHECK(SPIBusSubmit(&bus, &t3) == HAL_OK);
+    now_ns = xfer.end; run_isr();
+    CHECK(t1.Status == SPI_BUS_ERROR && t2.Status == SPI_BUS_ERROR && t3.Status == SPI_BUS_ACTIVE);
+    CHECK(cb_calls == 2);
+    now_ns = xfer.end; run_isr();
+    CHECK(t3.Status == SPI_BUS_DONE && cb_calls == 3);
+    CHECK(gpio.ODR == 0xFFFF);
+  }
+
+  /* priority with aging: a low priority transaction is overtaken at most SPI_BUS_OVERTAKE_LIMIT times */
+  {
+    static SPIBusTransaction_t hi[SPI_BUS_OVERTAKE_LIMIT + 3];
+    static SPIBusSegment_t hs = { NULL, NULL, 0, NULL };
+    SPIBusSegment_t ls = { a, NULL, 4, NULL };
+    int served_before = 0;
+    hs.TxData = a; hs.Length = 4;
+    memset(&t1, 0, sizeof t1); memset(&t2, 0, sizeof t2);
+    t1.Device = &dev[1]; t1.Segments = &s1; t1.Priority = 0;   /* occupies the bus */
+    t2.Device = &dev[2]; t2.Segments = &ls; t2.Priority = 0;
+    CHECK(SPIBusSubmit(&bus, &t1) == HAL_OK);
+    CHECK(SPIBusSubmit(&bus, &t2) == HAL_OK);
+    for (i = 0; i < (int)(SPI_BUS_OVERTAKE_LIMIT + 3); i++)
+    {
+      memset(&hi[i], 0, sizeof hi[i]);
+      hi[i].Device = &dev[0]; hi[i].Segments = &hs; hi[i].Priority = 5;
+      CHECK(SPIBusSubmit(&bus, &hi[i]) == HAL_OK);
+    }
+    CHECK(t2.Overtaken == SPI_BUS_OVERTAKE_LIMIT);
+    while (xfer.busy)
+    {
+      now_ns = xfer.end; run_isr();
+      if (t2.Status == SPI_BUS_ACTIVE)
+      {
+        for (i = 0; i < (int)(SPI_BUS_OVERTAKE_LIMIT + 3); i++) served_before += (hi[i].Status == SPI_BUS_DONE);
+        CHECK(served_before == (int)SPI_BUS_OVERTAKE_LIMIT);
+      }
+    }
+    CHECK(t2.Status == SPI_BUS_DONE);
+  }
+}
+
+int main(void)
+{
+  setvbuf(stdout, NULL, _IONBF, 0);
+  srand(7);
+  directed(); printf("directed done %lu checks %lu failures\n", checks, failures); fflush(stdout);
+  load_test(1, 2000000000ULL, 50);
+  load_test(1, 2000000000ULL, 400);
+  load_test(0, 1000000000ULL, 50);
+  printf("%lu checks, %lu failures, max overtaken %u, critical sections %u\n", checks, failures, max_overtaken, sim_critical_entries);
+  return failures != 0;
+}
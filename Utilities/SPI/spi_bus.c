@@ -0,0 +1,592 @@
+/**
+  ******************************************************************************
+  * @file    spi_bus.c
+  * @author  MCD Application Team
+  * @brief   Shares a SPI between several devices: queued transactions made
+  *          of chained DMA segments, served by priority with a per device
+  *          chip select and SPI configuration.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2020 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/********************** NOTES **********************************************
+To use this module, the following steps should be followed :
+
+1- initialize the SPI with HAL_SPI_Init() as a full duplex 8 bit master, with
+   its Tx and Rx DMA channels linked to the handle (the transfers are made in
+   interrupt mode when there is no DMA), then call SPIBusInit().
+
+2- when USE_HAL_SPI_REGISTER_CALLBACKS is 0, call SPIBusTransferCplt() from
+   HAL_SPI_TxCpltCallback(), HAL_SPI_RxCpltCallback() and
+   HAL_SPI_TxRxCpltCallback(), and SPIBusTransferError() from
+   HAL_SPI_ErrorCallback(). Otherwise SPIBusInit() registers them.
+
+3- describe each device with a SPIBusDevice_t: chip select pin, baud rate
+   prescaler, clock polarity and phase, and bit order. The chip select pins
+   are configured as outputs, high, by the application.
+
+4- describe each transfer with a SPIBusTransaction_t whose Segments are
+   transferred back to back with the chip select asserted, for example a
+   command segment followed by a data segment, then call SPIBusSubmit() from
+   a task or an interrupt. The transaction structure is cleared before its
+   first submission. The Callback of the transaction is called from the
+   SPI interrupt when it ends, or poll its Status. SPIBusTransfer() submits a
+   transaction and waits for its end, to replace a polled HAL_SPI_Transmit()
+   or HAL_SPI_TransmitReceive().
+
+The transactions are served by decreasing Priority, in submission order
+within a priority. A transaction that has been overtaken SPI_BUS_OVERTAKE_LIMIT
+times by transactions of higher priority is not overtaken anymore, so that
+a busy device of high priority cannot starve the others.
+
+The next transaction is started from the interrupt that ends the previous
+one, before its callback is called, so that the bus does not wait for a task
+to be scheduled. The queue is protected by masking the interrupts for a few
+instructions, the callbacks are called with the interrupts enabled.
+
+A transaction, its segments and its buffers must stay valid until its
+callback has been called, or until its status is no longer SPI_BUS_QUEUED or
+SPI_BUS_ACTIVE when it has no callback. All the accesses to the SPI must go
+through the bus, which keeps track of the SPI configuration.
+
+Test/build.sh builds and runs the bus on the host against a mock SPI with DMA,
+for the directed, throughput and fairness tests.
+*******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "spi_bus.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+#define SPI_BUS_ENTER_CRITICAL(primask)   do { (primask) = __get_PRIMASK(); __disable_irq(); } while (0)
+#define SPI_BUS_EXIT_CRITICAL(primask)    __set_PRIMASK(primask)
+
+/* Private function prototypes -----------------------------------------------*/
+static SPIBus_t            *SPIBusFind (SPI_HandleTypeDef *hspi);
+static void                SPIBusEnqueue (SPIBus_t *Bus, SPIBusTransaction_t *Transaction);
+static SPIBusTransaction_t *SPIBusStart (SPIBus_t *Bus);
+static HAL_StatusTypeDef   SPIBusStartSegment (SPIBus_t *Bus);
+static SPIBusTransaction_t *SPIBusEnd (SPIBus_t *Bus, SPIBusStatus_t Status);
+static void                SPIBusNotify (SPIBus_t *Bus, SPIBusTransaction_t *Transaction);
+static void                SPIBusSegmentCplt (SPIBus_t *Bus, uint32_t Error);
+
+/* Private variables ---------------------------------------------------------*/
+static SPIBus_t *SPIBusList[SPI_BUS_COUNT];
+
+/* Private functions ---------------------------------------------------------*/
+/**
+  * @brief  Attach a bus to an initialized SPI
+  * @param  Bus: bus to initialize
+  * @param  hspi: SPI handle, full duplex 8 bit master
+  * @retval HAL status
+  */
+HAL_StatusTypeDef SPIBusInit (SPIBus_t *Bus, SPI_HandleTypeDef *hspi)
+{
+  uint32_t slot = SPI_BUS_COUNT;
+  uint32_t i;
+
+  if ((Bus == NULL) || (hspi == NULL) || (hspi->State != HAL_SPI_STATE_READY) ||
+      (hspi->Init.Mode != SPI_MODE_MASTER) || (hspi->Init.Direction != SPI_DIRECTION_2LINES) ||
+      (hspi->Init.DataSize != SPI_DATASIZE_8BIT))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Take the slot of a bus already on this SPI, or a free one */
+  for (i = 0U; i < SPI_BUS_COUNT; i++)
+  {
+    if ((SPIBusList[i] != NULL) && (SPIBusList[i]->hspi == hspi))
+    {
+      slot = i;
+      break;
+    }
+    if ((SPIBusList[i] == NULL) && (slot == SPI_BUS_COUNT))
+    {
+      slot = i;
+    }
+  }
+  if (slot == SPI_BUS_COUNT)
+  {
+    return HAL_ERROR;
+  }
+
+  Bus->hspi         = hspi;
+  Bus->Queue        = NULL;
+  Bus->Active       = NULL;
+  Bus->Segment      = NULL;
+  Bus->Device       = NULL;
+  Bus->Transactions = 0U;
+  Bus->Errors       = 0U;
+  Bus->Bytes        = 0U;
+
+#if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
+  if ((HAL_SPI_RegisterCallback(hspi, HAL_SPI_TX_COMPLETE_CB_ID, SPIBusTransferCplt) != HAL_OK) ||
+      (HAL_SPI_RegisterCallback(hspi, HAL_SPI_RX_COMPLETE_CB_ID, SPIBusTransferCplt) != HAL_OK) ||
+      (HAL_SPI_RegisterCallback(hspi, HAL_SPI_TX_RX_COMPLETE_CB_ID, SPIBusTransferCplt) != HAL_OK) ||
+      (HAL_SPI_RegisterCallback(hspi, HAL_SPI_ERROR_CB_ID, SPIBusTransferError) != HAL_OK))
+  {
+    return HAL_ERROR;
+  }
+#endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
+
+  SPIBusList[slot] = Bus;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Queue a transaction, and start it if the bus is free
+  * @param  Bus: bus
+  * @param  Transaction: transaction, with its Device, Segments, Priority and
+  *         Callback set
+  * @retval HAL_OK, HAL_BUSY if the transaction is already queued or in
+  *         progress, HAL_ERROR if it is not valid
+  */
+HAL_StatusTypeDef SPIBusSubmit (SPIBus_t *Bus, SPIBusTransaction_t *Transaction)
+{
+  SPIBusTransaction_t *failed = NULL;
+  SPIBusSegment_t *segment;
+  uint32_t primask;
+
+  if ((Bus == NULL) || (Transaction == NULL) || (Transaction->Device == NULL) || (Transaction->Segments == NULL))
+  {
+    return HAL_ERROR;
+  }
+  for (segment = Transaction->Segments; segment != NULL; segment = segment->Next)
+  {
+    if ((segment->Length == 0U) || ((segment->TxData == NULL) && (segment->RxData == NULL)))
+    {
+      return HAL_ERROR;
+    }
+  }
+
+  SPI_BUS_ENTER_CRITICAL(primask);
+
+  if ((Transaction->Status == SPI_BUS_QUEUED) || (Transaction->Status == SPI_BUS_ACTIVE))
+  {
+    SPI_BUS_EXIT_CRITICAL(primask);
+    return HAL_BUSY;
+  }
+
+  Transaction->Status = SPI_BUS_QUEUED;
+  SPIBusEnqueue(Bus, Transaction);
+
+  if (Bus->Active == NULL)
+  {
+    failed = SPIBusStart(Bus);
+  }
+
+  SPI_BUS_EXIT_CRITICAL(primask);
+
+  SPIBusNotify(Bus, failed);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Remove a queued transaction, or abort the transaction in progress
+  *         with the interrupts enabled. Its status becomes SPI_BUS_CANCELLED
+  *         and its callback is called
+  * @param  Bus: bus
+  * @param  Transaction: transaction
+  * @retval HAL_OK, or HAL_ERROR if the transaction is neither queued nor in
+  *         progress
+  */
+HAL_StatusTypeDef SPIBusCancel (SPIBus_t *Bus, SPIBusTransaction_t *Transaction)
+{
+  SPIBusTransaction_t *cancelled = NULL;
+  SPIBusTransaction_t *failed = NULL;
+  SPIBusTransaction_t **link;
+  uint32_t primask;
+
+  SPI_BUS_ENTER_CRITICAL(primask);
+
+  if (Transaction->Status == SPI_BUS_QUEUED)
+  {
+    for (link = &Bus->Queue; *link != NULL; link = &(*link)->Next)
+    {
+      if (*link == Transaction)
+      {
+        *link = Transaction->Next;
+        Transaction->Next = NULL;
+        Transaction->Status = SPI_BUS_CANCELLED;
+        cancelled = Transaction;
+        break;
+      }
+    }
+  }
+  else if ((Transaction->Status == SPI_BUS_ACTIVE) && (Bus->Active == Transaction) && (Bus->Segment != NULL))
+  {
+    /* Detach the segment in progress: its end is ignored, and the bus stays
+       owned by the transaction until the SPI is aborted */
+    Bus->Segment = NULL;
+    cancelled = Transaction;
+  }
+  else
+  {
+    /* Not queued on this bus, already ended or being aborted */
+  }
+
+  SPI_BUS_EXIT_CRITICAL(primask);
+
+  if (cancelled == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  if (cancelled->Status == SPI_BUS_ACTIVE)
+  {
+    /* Blocking abort, which does not call the SPI callbacks, made with the
+       interrupts enabled */
+    (void)HAL_SPI_Abort(Bus->hspi);
+
+    SPI_BUS_ENTER_CRITICAL(primask);
+    (void)SPIBusEnd(Bus, SPI_BUS_CANCELLED);
+    failed = SPIBusStart(Bus);
+    SPI_BUS_EXIT_CRITICAL(primask);
+  }
+
+  SPIBusNotify(Bus, cancelled);
+  SPIBusNotify(Bus, failed);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Submit a transaction and wait for its end. Must not be called
+  *         from an interrupt of higher priority than the SPI and DMA ones
+  * @param  Bus: bus
+  * @param  Transaction: transaction
+  * @param  Timeout: timeout in ms, after which the transaction is cancelled,
+  *         or HAL_MAX_DELAY
+  * @retval HAL_OK, HAL_ERROR, HAL_BUSY or HAL_TIMEOUT
+  */
+HAL_StatusTypeDef SPIBusTransfer (SPIBus_t *Bus, SPIBusTransaction_t *Transaction, uint32_t Timeout)
+{
+  uint32_t tickstart = HAL_GetTick();
+  HAL_StatusTypeDef status;
+
+  status = SPIBusSubmit(Bus, Transaction);
+  if (status != HAL_OK)
+  {
+    return status;
+  }
+
+  while ((Transaction->Status == SPI_BUS_QUEUED) || (Transaction->Status == SPI_BUS_ACTIVE))
+  {
+    if ((Timeout != HAL_MAX_DELAY) && ((HAL_GetTick() - tickstart) > Timeout))
+    {
+      /* Fails if the transaction has just ended */
+      (void)SPIBusCancel(Bus, Transaction);
+    }
+  }
+
+  switch (Transaction->Status)
+  {
+    case SPI_BUS_DONE:
+      status = HAL_OK;
+      break;
+    case SPI_BUS_CANCELLED:
+      status = HAL_TIMEOUT;
+      break;
+    default:
+      status = HAL_ERROR;
+      break;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  End of a segment reported by the HAL SPI
+  * @param  hspi: SPI handle
+  * @retval None
+  */
+void SPIBusTransferCplt (SPI_HandleTypeDef *hspi)
+{
+  SPIBus_t *bus = SPIBusFind(hspi);
+
+  if (bus != NULL)
+  {
+    SPIBusSegmentCplt(bus, 0U);
+  }
+}
+
+/**
+  * @brief  Error reported by the HAL SPI, the transfer is already aborted
+  * @param  hspi: SPI handle
+  * @retval None
+  */
+void SPIBusTransferError (SPI_HandleTypeDef *hspi)
+{
+  SPIBus_t *bus = SPIBusFind(hspi);
+
+  if (bus != NULL)
+  {
+    SPIBusSegmentCplt(bus, 1U);
+  }
+}
+
+/**
+  * @brief  Get the bus of a SPI
+  * @param  hspi: SPI handle
+  * @retval Bus, or NULL if the SPI has no bus
+  */
+static SPIBus_t *SPIBusFind (SPI_HandleTypeDef *hspi)
+{
+  uint32_t i;
+
+  for (i = 0U; i < SPI_BUS_COUNT; i++)
+  {
+    if ((SPIBusList[i] != NULL) && (SPIBusList[i]->hspi == hspi))
+    {
+      return SPIBusList[i];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  * @brief  Insert a transaction in the queue, after the last transaction it
+  *         cannot overtake: one of the same or higher priority, or one that
+  *         has been overtaken SPI_BUS_OVERTAKE_LIMIT times. Called with the
+  *         interrupts masked
+  * @param  Bus: bus
+  * @param  Transaction: transaction
+  * @retval None
+  */
+static void SPIBusEnqueue (SPIBus_t *Bus, SPIBusTransaction_t *Transaction)
+{
+  SPIBusTransaction_t **link = &Bus->Queue;
+  SPIBusTransaction_t *queued;
+
+  for (queued = Bus->Queue; queued != NULL; queued = queued->Next)
+  {
+    if ((queued->Priority >= Transaction->Priority) || (queued->Overtaken >= SPI_BUS_OVERTAKE_LIMIT))
+    {
+      link = &queued->Next;
+    }
+  }
+
+  Transaction->Overtaken = 0U;
+  Transaction->Next = *link;
+  *link = Transaction;
+
+  for (queued = Transaction->Next; queued != NULL; queued = queued->Next)
+  {
+    queued->Overtaken++;
+  }
+}
+
+/**
+  * @brief  Start the first queued transaction if the bus is free. Called with
+  *         the interrupts masked
+  * @param  Bus: bus
+  * @retval Transaction that failed to start, whose callback must be called,
+  *         or NULL
+  */
+static SPIBusTransaction_t *SPIBusStart (SPIBus_t *Bus)
+{
+  SPI_HandleTypeDef *hspi = Bus->hspi;
+  SPIBusTransaction_t *transaction;
+  const SPIBusDevice_t *device;
+
+  if ((Bus->Active != NULL) || (Bus->Queue == NULL))
+  {
+    return NULL;
+  }
+
+  transaction = Bus->Queue;
+  Bus->Queue = transaction->Next;
+  transaction->Next = NULL;
+  transaction->Status = SPI_BUS_ACTIVE;
+  Bus->Active = transaction;
+  Bus->Segment = transaction->Segments;
+
+  /* Reconfigure the SPI, disabled, before the clock polarity is seen by the
+     device */
+  device = transaction->Device;
+  if (device != Bus->Device)
+  {
+    __HAL_SPI_DISABLE(hspi);
+    MODIFY_REG(hspi->Instance->CR1, (SPI_CR1_BR | SPI_CR1_CPOL | SPI_CR1_CPHA | SPI_CR1_LSBFIRST),
+               (device->BaudRatePrescaler | device->CLKPolarity | device->CLKPhase | device->FirstBit));
+    hspi->Init.BaudRatePrescaler = device->BaudRatePrescaler;
+    hspi->Init.CLKPolarity       = device->CLKPolarity;
+    hspi->Init.CLKPhase          = device->CLKPhase;
+    hspi->Init.FirstBit          = device->FirstBit;
+    Bus->Device = device;
+  }
+
+  if (device->CsPort != NULL)
+  {
+    HAL_GPIO_WritePin(device->CsPort, device->CsPin, GPIO_PIN_RESET);
+  }
+
+  if (SPIBusStartSegment(Bus) != HAL_OK)
+  {
+    return SPIBusEnd(Bus, SPI_BUS_ERROR);
+  }
+
+  return NULL;
+}
+
+/**
+  * @brief  Start the transfer of the current segment
+  * @param  Bus: bus
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef SPIBusStartSegment (SPIBus_t *Bus)
+{
+  SPI_HandleTypeDef *hspi = Bus->hspi;
+  SPIBusSegment_t *segment = Bus->Segment;
+  uint32_t i;
+
+  if (segment->RxData == NULL)
+  {
+    if (hspi->hdmatx != NULL)
+    {
+      return HAL_SPI_Transmit_DMA(hspi, (uint8_t *)segment->TxData, segment->Length);
+    }
+    return HAL_SPI_Transmit_IT(hspi, (uint8_t *)segment->TxData, segment->Length);
+  }
+
+  if (segment->TxData == NULL)
+  {
+    /* The HAL sends the content of the receive buffer */
+    for (i = 0U; i < segment->Length; i++)
+    {
+      segment->RxData[i] = SPI_BUS_FILL_BYTE;
+    }
+    if ((hspi->hdmatx != NULL) && (hspi->hdmarx != NULL))
+    {
+      return HAL_SPI_Receive_DMA(hspi, segment->RxData, segment->Length);
+    }
+    return HAL_SPI_Receive_IT(hspi, segment->RxData, segment->Length);
+  }
+
+  if ((hspi->hdmatx != NULL) && (hspi->hdmarx != NULL))
+  {
+    return HAL_SPI_TransmitReceive_DMA(hspi, (uint8_t *)segment->TxData, segment->RxData, segment->Length);
+  }
+  return HAL_SPI_TransmitReceive_IT(hspi, (uint8_t *)segment->TxData, segment->RxData, segment->Length);
+}
+
+/**
+  * @brief  End the transaction in progress and release its chip select.
+  *         Called with the interrupts masked
+  * @param  Bus: bus
+  * @param  Status: final status of the transaction
+  * @retval Ended transaction, whose callback must be called
+  */
+static SPIBusTransaction_t *SPIBusEnd (SPIBus_t *Bus, SPIBusStatus_t Status)
+{
+  SPIBusTransaction_t *transaction = Bus->Active;
+
+  if (transaction->Device->CsPort != NULL)
+  {
+    HAL_GPIO_WritePin(transaction->Device->CsPort, transaction->Device->CsPin, GPIO_PIN_SET);
+  }
+
+  Bus->Active = NULL;
+  Bus->Segment = NULL;
+  Bus->Transactions++;
+  if (Status == SPI_BUS_ERROR)
+  {
+    Bus->Errors++;
+  }
+
+  transaction->Status = Status;
+
+  return transaction;
+}
+
+/**
+  * @brief  Call the callback of an ended transaction, then those of the
+  *         transactions that fail to start
+  * @param  Bus: bus
+  * @param  Transaction: ended transaction, or NULL
+  * @retval None
+  */
+static void SPIBusNotify (SPIBus_t *Bus, SPIBusTransaction_t *Transaction)
+{
+  uint32_t primask;
+
+  while (Transaction != NULL)
+  {
+    if (Transaction->Callback != NULL)
+    {
+      Transaction->Callback(Transaction);
+    }
+
+    SPI_BUS_ENTER_CRITICAL(primask);
+    Transaction = SPIBusStart(Bus);
+    SPI_BUS_EXIT_CRITICAL(primask);
+  }
+}
+
+/**
+  * @brief  Chain the next segment, or end the transaction and start the next
+  *         one
+  * @param  Bus: bus
+  * @param  Error: 1 if the segment failed
+  * @retval None
+  */
+static void SPIBusSegmentCplt (SPIBus_t *Bus, uint32_t Error)
+{
+  SPIBusTransaction_t *ended = NULL;
+  SPIBusTransaction_t *failed = NULL;
+  uint32_t primask;
+
+  SPI_BUS_ENTER_CRITICAL(primask);
+
+  /* Ignore the transfers that are not made by the bus, or being aborted */
+  if ((Bus->Active != NULL) && (Bus->Segment != NULL))
+  {
+    if (Error != 0U)
+    {
+      ended = SPIBusEnd(Bus, SPI_BUS_ERROR);
+    }
+    else
+    {
+      Bus->Bytes += Bus->Segment->Length;
+      Bus->Segment = Bus->Segment->Next;
+      if (Bus->Segment == NULL)
+      {
+        ended = SPIBusEnd(Bus, SPI_BUS_DONE);
+      }
+      else if (SPIBusStartSegment(Bus) != HAL_OK)
+      {
+        ended = SPIBusEnd(Bus, SPI_BUS_ERROR);
+      }
+      else
+      {
+        /* Next segment in progress */
+      }
+    }
+
+    if (ended != NULL)
+    {
+      failed = SPIBusStart(Bus);
+    }
+  }
+
+  SPI_BUS_EXIT_CRITICAL(primask);
+
+  SPIBusNotify(Bus, ended);
+  SPIBusNotify(Bus, failed);
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
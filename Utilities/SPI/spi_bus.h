@@ -0,0 +1,128 @@
+/**
+  ******************************************************************************
+  * @file    spi_bus.h
+  * @author  MCD Application Team
+  * @brief   Header for spi_bus module
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2020 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _SPI_BUS_H__
+#define _SPI_BUS_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32l0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Number of buses that can be registered by SPIBusInit() */
+#ifndef SPI_BUS_COUNT
+#define SPI_BUS_COUNT             2U
+#endif
+
+/* Number of times a queued transaction can be overtaken by transactions of
+   higher priority, after which it is served before any new transaction */
+#ifndef SPI_BUS_OVERTAKE_LIMIT
+#define SPI_BUS_OVERTAKE_LIMIT    4U
+#endif
+
+/* Byte sent by the segments that only receive */
+#ifndef SPI_BUS_FILL_BYTE
+#define SPI_BUS_FILL_BYTE         0xFFU
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum
+{
+  SPI_BUS_IDLE = 0,               /* Never submitted */
+  SPI_BUS_QUEUED,
+  SPI_BUS_ACTIVE,
+  SPI_BUS_DONE,
+  SPI_BUS_ERROR,                  /* The SPI or DMA reported an error */
+  SPI_BUS_CANCELLED
+} SPIBusStatus_t;
+
+/* A device on the bus. The SPI is reconfigured when a transaction addresses
+   another device than the previous one */
+typedef struct
+{
+  GPIO_TypeDef *CsPort;           /* Active low chip select, NULL if none */
+  uint16_t     CsPin;
+  uint32_t     BaudRatePrescaler; /* SPI_BAUDRATEPRESCALER_x */
+  uint32_t     CLKPolarity;       /* SPI_POLARITY_x */
+  uint32_t     CLKPhase;          /* SPI_PHASE_x */
+  uint32_t     FirstBit;          /* SPI_FIRSTBIT_x */
+} SPIBusDevice_t;
+
+/* A transfer of a transaction. The segments of a transaction are chained
+   with the chip select kept asserted */
+typedef struct SPIBusSegment
+{
+  const uint8_t        *TxData;   /* NULL to send SPI_BUS_FILL_BYTE */
+  uint8_t              *RxData;   /* NULL to drop the received data */
+  uint16_t             Length;
+  struct SPIBusSegment *Next;
+} SPIBusSegment_t;
+
+typedef struct SPIBusTransaction
+{
+  const SPIBusDevice_t *Device;
+  SPIBusSegment_t      *Segments;
+  uint8_t              Priority;  /* Higher priorities are served first */
+  /* Called from the SPI (or DMA) interrupt when the transaction ends, after
+     the chip select is released. Can submit the next transaction */
+  void                 (*Callback)(struct SPIBusTransaction *Transaction);
+  void                 *Context;  /* For the application */
+  __IO SPIBusStatus_t  Status;
+  /* Private */
+  uint8_t              Overtaken;
+  struct SPIBusTransaction *Next;
+} SPIBusTransaction_t;
+
+typedef struct
+{
+  SPI_HandleTypeDef    *hspi;
+  SPIBusTransaction_t  *Queue;    /* Waiting transactions, in service order */
+  SPIBusTransaction_t  *Active;
+  SPIBusSegment_t      *Segment;  /* Segment being transferred, NULL while
+                                     the Active transaction is aborted */
+  const SPIBusDevice_t *Device;   /* Device the SPI is configured for */
+  uint32_t             Transactions; /* Ended transactions */
+  uint32_t             Errors;
+  uint32_t             Bytes;     /* Transferred bytes */
+} SPIBus_t;
+
+/* Exported variables --------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+HAL_StatusTypeDef SPIBusInit (SPIBus_t *Bus, SPI_HandleTypeDef *hspi);
+HAL_StatusTypeDef SPIBusSubmit (SPIBus_t *Bus, SPIBusTransaction_t *Transaction);
+HAL_StatusTypeDef SPIBusCancel (SPIBus_t *Bus, SPIBusTransaction_t *Transaction);
+HAL_StatusTypeDef SPIBusTransfer (SPIBus_t *Bus, SPIBusTransaction_t *Transaction, uint32_t Timeout);
+
+/* To be called from HAL_SPI_TxCpltCallback(), HAL_SPI_RxCpltCallback(),
+   HAL_SPI_TxRxCpltCallback() and HAL_SPI_ErrorCallback() when the HAL SPI
+   callbacks are not registered (USE_HAL_SPI_REGISTER_CALLBACKS is 0) */
+void SPIBusTransferCplt (SPI_HandleTypeDef *hspi);
+void SPIBusTransferError (SPI_HandleTypeDef *hspi);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SPI_BUS_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
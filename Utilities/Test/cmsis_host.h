@@ -0,0 +1,26 @@
+/* Host replacement of cmsis_gcc.h for the Utilities bus tests: the interrupt
+mask is the test's sim_primask, and each __disable_irq() is counted. */
+#define __CMSIS_GCC_H
+#include <stdint.h>
+#define __ASM __asm
+#define __INLINE inline
+#define __STATIC_INLINE static inline
+#define __STATIC_FORCEINLINE static inline
+#define __NO_RETURN __attribute__((__noreturn__))
+#define __USED __attribute__((used))
+#define __WEAK __attribute__((weak))
+#define __PACKED __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT struct __attribute__((packed, aligned(1)))
+#define __ALIGNED(x) __attribute__((aligned(x)))
+#define __RESTRICT __restrict
+#define __COMPILER_BARRIER() __asm volatile("":::"memory")
+extern uint32_t sim_primask;
+extern uint32_t sim_critical_entries;
+static inline void __DSB(void) {}
+static inline void __ISB(void) {}
+static inline void __DMB(void) {}
+static inline void __NOP(void) {}
+static inline uint32_t __get_PRIMASK(void) { return sim_primask; }
+static inline void __set_PRIMASK(uint32_t p) { sim_primask = p; }
+static inline void __disable_irq(void) { sim_primask = 1; sim_critical_entries++; }
+static inline void __enable_irq(void) { sim_primask = 0; }
@@ -0,0 +1,7 @@
+/* Host stub of FreeRTOS.h for the SysTick model */
+typedef unsigned long UBaseType_t;
+#define configUSE_TICKLESS_IDLE 0
+#define configUSE_TRACE_FACILITY 0
+#define configMAX_TASK_NAME_LEN 16
+#define portSET_INTERRUPT_MASK_FROM_ISR() 0
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x) (void)(x)
@@ -0,0 +1,12 @@
+#!/bin/sh
+# Build and run the host SysTick model of the trace recorder timestamps with the
+# host compiler. Usage: sh build.sh [output directory]
+set -e
+HERE=$(cd "$(dirname "$0")" && pwd)
+OUT=${1:-${TMPDIR:-/tmp}/trace_test}
+CC=${CC:-cc}
+mkdir -p "$OUT"
+sed -e 's/SysTick->VAL/sim_val()/g' -e 's/SysTick->CTRL/sim_ctrl()/g' -e 's/SysTick->LOAD/sim_load/g' \
+  "$HERE/../trace_recorder.c" > "$OUT/trace_recorder_host.c"
+$CC -O2 -Wall -I"$HERE" -I"$HERE/.." -o "$OUT/trace_systick_model" "$HERE/trace_systick_model.c" "$OUT/trace_recorder_host.c"
+"$OUT/trace_systick_model" 300000
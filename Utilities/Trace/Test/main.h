@@ -0,0 +1,9 @@
+/* Host stub of main.h for the SysTick model, see trace_systick_model.c */
+#include <stdint.h>
+#include <stddef.h>
+extern uint32_t SystemCoreClock;
+uint32_t sim_val(void);
+uint32_t sim_ctrl(void);
+extern uint32_t sim_load;
+#define SysTick_CTRL_COUNTFLAG_Msk (1UL << 16)
+#define SCB_ICSR_PENDSTSET_Msk (1UL << 26)
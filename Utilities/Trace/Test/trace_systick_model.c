@@ -0,0 +1,62 @@
+/* Host model of SysTick for the trace recorder timestamps. Build and run with
+   build.sh, which maps the SysTick registers of trace_recorder.c to the model.
+
+   SysTick model: VAL counts down from LOAD, COUNTFLAG is set by each reload
+   and cleared when CTRL is read, every register read takes 2 cycles. The
+   kernel tick hook runs a random latency after each reload, and timestamps
+   are taken at random times, including between a reload and its hook. */
+#include <stdio.h>
+#include <stdlib.h>
+#include "main.h"
+#include "trace_recorder.h"
+uint32_t SystemCoreClock = 32000000U;
+uint32_t sim_load = 31999U;          /* 32 MHz, 1 kHz tick */
+static uint64_t now, t0 = 12345, last_ctrl, last_val;
+static uint64_t P(void) { return (uint64_t)sim_load + 1U; }
+uint32_t sim_val(void) { now += 2; last_val = now; return sim_load - (uint32_t)((now - t0) % P()); }
+uint32_t sim_ctrl(void)
+{
+  uint32_t f;
+  now += 2;
+  f = ((now - t0) / P() > (last_ctrl - t0) / P()) ? SysTick_CTRL_COUNTFLAG_Msk : 0U;
+  last_ctrl = now;
+  return f | 7U;
+}
+int main(int argc, char **argv)
+{
+  unsigned long k, ticks = argc > 1 ? strtoul(argv[1], 0, 0) : 100000UL, bad = 0, n = 0;
+  uint32_t t;
+  now = last_ctrl = t0;
+  /* Idle: only the tick hook for 1000 ticks */
+  for (k = 1; k <= 1000; k++) { now = t0 + k * P() + 40; TraceTick(); }
+  now = t0 + 1000 * P() + 500;
+  t = TraceGetTimestamp();
+  printf("idle 1000 ticks: %lu cycles, expected %lu\n", (unsigned long)t, (unsigned long)(uint32_t)(last_val - t0));
+  if (t != (uint32_t)(last_val - t0)) bad++;
+  /* Busy: random latencies and timestamps around each reload */
+  srand(1);
+  for (k = 1001; k < 1001 + ticks; k++)
+  {
+    uint64_t reload = t0 + k * P(), lat = 10 + rand() % 3000;
+    int i, m = rand() % 4;
+    for (i = 0; i < m; i++)         /* before the reload */
+    {
+      uint64_t at = reload - 1 - rand() % 3000;
+      if (at > now) now = at;
+      t = TraceGetTimestamp(); n++;
+      if (t != (uint32_t)(last_val - t0)) bad++;
+    }
+    m = rand() % 3;
+    for (i = 0; i < m; i++)         /* reload pending or handler preempted before the hook */
+    {
+      uint64_t at = reload + rand() % lat;
+      if (at > now) now = at;
+      t = TraceGetTimestamp(); n++;
+      if (t != (uint32_t)(last_val - t0)) bad++;
+    }
+    if (reload + lat > now) now = reload + lat;
+    TraceTick();
+  }
+  printf("%lu timestamps over %lu ticks (32-bit wrap every %.0f ticks): %lu wrong\n", n, ticks, 4294967296.0 / P(), bad);
+  return bad != 0;
+}
@@ -0,0 +1,258 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2020 STMicroelectronics.
+# All rights reserved.
+#
+# This software component is licensed by ST under BSD 3-Clause license,
+# the "License"; You may not use this file except in compliance with the
+# License. You may obtain a copy of the License at:
+#                        opensource.org/licenses/BSD-3-Clause
+#
+# Decodes a dump of the TraceRecorder structure written by trace_recorder.c.
+#
+# Prints, for each task, a histogram of the time between the task becoming
+# ready and the task running, and optionally writes the whole trace as a Chrome
+# trace format timeline (open it with chrome://tracing or ui.perfetto.dev).
+#
+# Usage: trace_decode.py dump.bin [-o timeline.json] [--hz FREQUENCY]
+
+import argparse
+import json
+import struct
+import sys
+
+TRACE_MAGIC = 0x52545246
+HEADER = struct.Struct('<IHHIIIIHHI')
+TASK = struct.Struct('<HBx12s')
+RECORD = struct.Struct('<IBBH')
+
+EVT_TASK_CREATE = 0x01
+EVT_TASK_DELETE = 0x03
+EVT_TASK_SWITCHED_IN = 0x04
+EVT_TASK_READY = 0x05
+EVT_TASK_DELAY = 0x06
+EVT_TASK_SUSPEND = 0x07
+EVT_TASK_RESUME = 0x08
+EVT_QUEUE_CREATE = 0x10
+EVT_ISR_ENTER = 0x20
+EVT_ISR_EXIT = 0x21
+EVT_USER = 0x30
+
+QUEUE_EVENTS = {
+    0x11: 'send',
+    0x12: 'send failed',
+    0x13: 'send from ISR',
+    0x14: 'receive',
+    0x15: 'receive failed',
+    0x16: 'receive from ISR',
+    0x17: 'block on send',
+    0x18: 'block on receive',
+    0x19: 'delete',
+}
+
+TASK_EVENTS = {
+    EVT_TASK_CREATE: 'create',
+    EVT_TASK_DELAY: 'delay',
+    EVT_TASK_SUSPEND: 'suspend',
+    EVT_TASK_RESUME: 'resume',
+    EVT_TASK_DELETE: 'delete',
+}
+
+# queueQUEUE_TYPE_xxx values from queue.h
+QUEUE_TYPES = {
+    0: 'Queue',
+    1: 'Mutex',
+    2: 'Counting semaphore',
+    3: 'Binary semaphore',
+    4: 'Recursive mutex',
+}
+
+ISR_TID_BASE = 0x10000
+
+
+class Trace:
+    def __init__(self, data, hz=None):
+        if len(data) < HEADER.size:
+            raise ValueError('dump is too short')
+        (magic, version, record_size, record_count, timestamp_hz, index,
+         _enabled, task_count, task_size, task_used) = HEADER.unpack_from(
+             data, 0)
+        if magic != TRACE_MAGIC:
+            raise ValueError('not a trace dump (bad magic 0x%08x)' % magic)
+        if (version != 1 or record_size != RECORD.size or
+                task_size != TASK.size):
+            raise ValueError('unsupported trace version %d' % version)
+        records_offset = HEADER.size + task_count * TASK.size
+        if len(data) < records_offset + record_count * RECORD.size:
+            raise ValueError('dump is truncated')
+
+        self.hz = hz if hz else timestamp_hz
+        self.lost = max(0, index - record_count)
+
+        self.names = {}
+        for i in range(min(task_used, task_count)):
+            obj, _priority, name = TASK.unpack_from(
+                data, HEADER.size + i * TASK.size)
+            self.names[obj] = name.split(b'\0')[0].decode('ascii', 'replace')
+
+        raw = [RECORD.unpack_from(data, records_offset + i * RECORD.size)
+               for i in range(record_count)]
+        if index <= record_count:
+            raw = raw[:index]
+        else:
+            start = index % record_count
+            raw = raw[start:] + raw[:start]
+        self.records = self._unwrap(raw)
+
+    @staticmethod
+    def _unwrap(raw):
+        # Timestamps are 32 bit and wrap around.
+        records = []
+        high = 0
+        last = None
+        for ts, event, param, obj in raw:
+            if last is not None and (ts + high) < last:
+                high += 1 << 32
+            last = ts + high
+            records.append((last, event, param, obj))
+        return records
+
+    def us(self, cycles):
+        return cycles * 1e6 / self.hz
+
+
+def decode(trace):
+    names = trace.names
+    queues = {}
+    ready = {}
+    latency = {}
+    events = []
+    current = None
+    run_start = None
+    isr_stack = []
+    origin = trace.records[0][0] if trace.records else 0
+
+    def task_name(obj):
+        return names.get(obj, 'Task 0x%04x' % obj)
+
+    def queue_name(obj):
+        return '%s 0x%04x' % (QUEUE_TYPES.get(queues.get(obj), 'Queue'), obj)
+
+    def ts(cycles):
+        return trace.us(cycles - origin)
+
+    def here():
+        return ISR_TID_BASE + isr_stack[-1][0] if isr_stack else current
+
+    def instant(name, time, tid, args=None):
+        if tid is None:
+            return
+        ev = {'name': name, 'ph': 'i', 's': 't', 'pid': 1, 'tid': tid,
+              'ts': ts(time)}
+        if args:
+            ev['args'] = args
+        events.append(ev)
+
+    for time, event, param, obj in trace.records:
+        if event == EVT_TASK_READY:
+            ready.setdefault(obj, time)
+        elif event == EVT_TASK_SWITCHED_IN:
+            if obj in ready:
+                latency.setdefault(obj, []).append(time - ready.pop(obj))
+            if obj != current:
+                if current is not None:
+                    events.append({'name': task_name(current), 'ph': 'X',
+                                   'pid': 1, 'tid': current,
+                                   'ts': ts(run_start),
+                                   'dur': trace.us(time - run_start)})
+                current = obj
+                run_start = time
+        elif event in TASK_EVENTS:
+            instant(TASK_EVENTS[event], time, obj, {'task': task_name(obj)})
+        elif event == EVT_QUEUE_CREATE:
+            queues[obj] = param
+        elif event in QUEUE_EVENTS:
+            queues.setdefault(obj, param)
+            instant('%s %s' % (QUEUE_EVENTS[event], queue_name(obj)), time,
+                    here())
+        elif event == EVT_ISR_ENTER:
+            isr_stack.append((param, time))
+        elif event == EVT_ISR_EXIT:
+            if isr_stack and isr_stack[-1][0] == param:
+                irq, start = isr_stack.pop()
+                events.append({'name': 'ISR %d' % irq, 'ph': 'X', 'pid': 1,
+                               'tid': ISR_TID_BASE + irq, 'ts': ts(start),
+                               'dur': trace.us(time - start)})
+        elif event == EVT_USER:
+            instant('user %d' % param, time, here(), {'value': obj})
+
+    if current is not None and trace.records:
+        end = trace.records[-1][0]
+        events.append({'name': task_name(current), 'ph': 'X', 'pid': 1,
+                       'tid': current, 'ts': ts(run_start),
+                       'dur': trace.us(end - run_start)})
+
+    tids = {e['tid'] for e in events}
+    for tid in sorted(tids):
+        if tid >= ISR_TID_BASE:
+            label = 'ISR %d' % (tid - ISR_TID_BASE)
+        else:
+            label = task_name(tid)
+        events.append({'name': 'thread_name', 'ph': 'M', 'pid': 1,
+                       'tid': tid, 'args': {'name': label}})
+
+    return names, latency, events
+
+
+def histogram(trace, names, latency, out):
+    out.write('%d records, %.1f us, %d overwritten\n' % (
+        len(trace.records),
+        trace.us(trace.records[-1][0] - trace.records[0][0])
+        if trace.records else 0.0,
+        trace.lost))
+
+    for obj in sorted(latency, key=lambda o: names.get(o, '')):
+        values = [trace.us(v) for v in latency[obj]]
+        out.write('\n%s (0x%04x): %d activations, min %.2f us, '
+                  'avg %.2f us, max %.2f us\n' % (
+                      names.get(obj, '?'), obj, len(values), min(values),
+                      sum(values) / len(values), max(values)))
+        buckets = {}
+        for v in values:
+            bound = 1
+            while v >= bound:
+                bound *= 2
+            buckets[bound] = buckets.get(bound, 0) + 1
+        peak = max(buckets.values())
+        for bound in sorted(buckets):
+            out.write('  < %6d us %6d %s\n' % (
+                bound, buckets[bound], '#' * (40 * buckets[bound] // peak)))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Decode a FreeRTOS trace recorder dump.')
+    parser.add_argument('dump', help='binary dump of TraceRecorder')
+    parser.add_argument('-o', '--output',
+                        help='write a Chrome trace format timeline')
+    parser.add_argument('--hz', type=int,
+                        help='timestamp frequency, overrides the dump')
+    args = parser.parse_args()
+
+    with open(args.dump, 'rb') as f:
+        try:
+            trace = Trace(f.read(), args.hz)
+        except ValueError as e:
+            sys.exit('%s: %s' % (args.dump, e))
+
+    names, latency, events = decode(trace)
+    histogram(trace, names, latency, sys.stdout)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump({'traceEvents': events, 'displayTimeUnit': 'ns'}, f,
+                      indent=0)
+
+
+if __name__ == '__main__':
+    main()
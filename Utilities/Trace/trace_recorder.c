@@ -0,0 +1,281 @@
+/**
+  ******************************************************************************
+  * @file    trace_recorder.c
+  * @author  MCD Application Team
+  * @brief   Records FreeRTOS scheduler and queue events in a RAM ring buffer
+  *          for post-mortem decoding on the host.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2020 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/********************** NOTES **********************************************
+To use this module, the following steps should be followed :
+
+1- at the end of the _OS_Config.h file (ex. FreeRTOSConfig.h) include the
+   recorder so that it replaces the empty FreeRTOS trace macros :
+      - #if !defined(__IAR_SYSTEMS_ASM__) && !defined(__ASSEMBLER__)
+        #include "trace_recorder.h"
+        #endif
+
+2- in the _OS_Config.h enable the following macro, so that queue events record
+   whether the object is a queue, a semaphore or a mutex :
+      - #define configUSE_TRACE_FACILITY   1
+
+3- call TraceInit() before creating any task or queue, so that the name of
+   every task is recorded.
+
+4- optionally call TraceISREnter(Id)/TraceISRExit(Id) at the start and end of
+   the interrupt handlers to be traced, and TraceUserEvent() to mark points of
+   interest in the application.
+
+5- stop the recorder with TraceStop() (or halt the target), save the
+   sizeof(TraceRecorder) bytes at &TraceRecorder to a file and decode it with
+   trace_decode.py, which prints the scheduling latency of each task and writes
+   a timeline that can be opened with chrome://tracing or Perfetto.
+
+Timestamps count SystemCoreClock cycles using SysTick, and are extended to 32
+bits by counting every SysTick reload through its COUNTFLAG, which the recorder
+then owns: the kernel tick hook makes sure each reload is seen. Define
+TRACE_CUSTOM_TIMESTAMP and provide TraceGetTimestamp() and TRACE_TIMESTAMP_HZ to
+use another free running counter. This is required with tickless idle, which
+stops SysTick and uses its COUNTFLAG.
+*******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "FreeRTOS.h"
+#include "trace_recorder.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#if ((TRACE_RECORD_COUNT & (TRACE_RECORD_COUNT - 1U)) != 0U)
+#error "TRACE_RECORD_COUNT must be a power of 2"
+#endif
+
+#ifndef TRACE_TIMESTAMP_HZ
+#define TRACE_TIMESTAMP_HZ        SystemCoreClock
+#endif
+
+#if !defined(TRACE_CUSTOM_TIMESTAMP) && (configUSE_TICKLESS_IDLE != 0)
+#error "Tickless idle needs TRACE_CUSTOM_TIMESTAMP, SysTick timestamps read its COUNTFLAG"
+#endif
+
+/* Private macro -------------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+TraceRecorder_t TraceRecorder;
+
+#ifndef TRACE_CUSTOM_TIMESTAMP
+static uint32_t TraceTickTime = 0;  /* Time of the last SysTick reload counted */
+#endif
+
+/* Private functions ---------------------------------------------------------*/
+/**
+  * @brief  Clear the recorder and start recording
+  * @param  None
+  * @retval None
+  */
+void TraceInit (void)
+{
+  TraceRecorder.Enabled     = 0U;
+  TraceRecorder.Magic       = TRACE_MAGIC;
+  TraceRecorder.Version     = TRACE_VERSION;
+  TraceRecorder.RecordSize  = (uint16_t)sizeof(TraceRecord_t);
+  TraceRecorder.RecordCount = TRACE_RECORD_COUNT;
+  TraceRecorder.TimestampHz = TRACE_TIMESTAMP_HZ;
+  TraceRecorder.Index       = 0U;
+  TraceRecorder.TaskCount   = TRACE_TASK_COUNT;
+  TraceRecorder.TaskSize    = (uint16_t)sizeof(TraceTask_t);
+  TraceRecorder.TaskUsed    = 0U;
+  TraceRecorder.Enabled     = 1U;
+}
+
+/**
+  * @brief  Resume recording
+  * @param  None
+  * @retval None
+  */
+void TraceStart (void)
+{
+  TraceRecorder.Enabled = 1U;
+}
+
+/**
+  * @brief  Stop recording, for example from a fault handler, so that the
+  *         events that led to it are not overwritten
+  * @param  None
+  * @retval None
+  */
+void TraceStop (void)
+{
+  TraceRecorder.Enabled = 0U;
+}
+
+/**
+  * @brief  Write one record to the ring, overwriting the oldest one when full
+  * @param  Event: one of the TRACE_EVT_xxx codes
+  * @param  Param: event specific parameter
+  * @param  Object: address of the task or queue, or a user value
+  * @retval None
+  */
+void TraceEvent (uint8_t Event, uint8_t Param, uint32_t Object)
+{
+  TraceRecord_t *rec;
+  UBaseType_t isrm;
+
+  if (TraceRecorder.Enabled != 0U)
+  {
+    /* Events are recorded from tasks, from interrupts and from inside kernel
+       critical sections, so the slot is claimed with interrupts masked */
+    isrm = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    rec = &TraceRecorder.Records[TraceRecorder.Index & (TRACE_RECORD_COUNT - 1U)];
+    rec->Timestamp = TraceGetTimestamp();
+    rec->Event     = Event;
+    rec->Param     = Param;
+    rec->Object    = (uint16_t)Object;
+    TraceRecorder.Index++;
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(isrm);
+  }
+}
+
+/**
+  * @brief  Record the creation of a task and keep its name
+  * @param  Task: task control block
+  * @param  Name: task name
+  * @param  Priority: task priority
+  * @retval None
+  */
+void TraceTaskCreate (void *Task, const char *Name, uint32_t Priority)
+{
+  TraceTask_t *task = NULL;
+  UBaseType_t isrm;
+  uint32_t i;
+
+  TraceEvent(TRACE_EVT_TASK_CREATE, (uint8_t)Priority, TRACE_OBJECT(Task));
+
+  if (TraceRecorder.Enabled != 0U)
+  {
+    isrm = portSET_INTERRUPT_MASK_FROM_ISR();
+    if (TraceRecorder.TaskUsed < TRACE_TASK_COUNT)
+    {
+      task = &TraceRecorder.Tasks[TraceRecorder.TaskUsed];
+      TraceRecorder.TaskUsed++;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(isrm);
+  }
+
+  /* Tasks created once the table is full are shown by address only */
+  if (task != NULL)
+  {
+    task->Object   = (uint16_t)TRACE_OBJECT(Task);
+    task->Priority = (uint8_t)Priority;
+    task->Reserved = 0U;
+    for (i = 0U; (i < TRACE_TASK_NAME_LEN) && (i < configMAX_TASK_NAME_LEN) && (Name[i] != '\0'); i++)
+    {
+      task->Name[i] = Name[i];
+    }
+    for (; i < TRACE_TASK_NAME_LEN; i++)
+    {
+      task->Name[i] = '\0';
+    }
+  }
+}
+
+/**
+  * @brief  Record the start of an interrupt handler
+  * @param  Id: identifier of the interrupt, for example its IRQn
+  * @retval None
+  */
+void TraceISREnter (uint8_t Id)
+{
+  TraceEvent(TRACE_EVT_ISR_ENTER, Id, 0U);
+}
+
+/**
+  * @brief  Record the end of an interrupt handler
+  * @param  Id: identifier of the interrupt given to TraceISREnter()
+  * @retval None
+  */
+void TraceISRExit (uint8_t Id)
+{
+  TraceEvent(TRACE_EVT_ISR_EXIT, Id, 0U);
+}
+
+/**
+  * @brief  Record an application defined event
+  * @param  Code: application defined event code
+  * @param  Value: application defined value
+  * @retval None
+  */
+void TraceUserEvent (uint8_t Code, uint16_t Value)
+{
+  TraceEvent(TRACE_EVT_USER, Code, Value);
+}
+
+#ifndef TRACE_CUSTOM_TIMESTAMP
+/**
+  * @brief  Count the SysTick reload if it has not been counted yet. Called by
+  *         the kernel tick hook once per SysTick period, so that no reload is
+  *         missed, and by TraceGetTimestamp()
+  * @param  None
+  * @retval None
+  */
+void TraceTick (void)
+{
+  UBaseType_t isrm;
+
+  isrm = portSET_INTERRUPT_MASK_FROM_ISR();
+  /* COUNTFLAG is set by the reload and cleared by the read: whoever reads it
+     first counts the period, exactly once */
+  if ((SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) != 0U)
+  {
+    TraceTickTime += SysTick->LOAD + 1U;
+  }
+  portCLEAR_INTERRUPT_MASK_FROM_ISR(isrm);
+}
+
+/**
+  * @brief  Get the time in SystemCoreClock cycles: the SysTick periods counted
+  *         so far plus the cycles elapsed in the current period
+  * @param  None
+  * @retval Timestamp
+  */
+uint32_t TraceGetTimestamp (void)
+{
+  UBaseType_t isrm;
+  uint32_t count;
+  uint32_t time;
+
+  isrm = portSET_INTERRUPT_MASK_FROM_ISR();
+
+  /* SysTick counts down from LOAD to 0 */
+  count = SysTick->VAL;
+  if ((SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) != 0U)
+  {
+    /* Reload not counted yet, for example the SysTick interrupt is pending or
+       has not reached the tick hook: count it here, and read the counter again
+       as it may have reloaded after the first read */
+    TraceTickTime += SysTick->LOAD + 1U;
+    count = SysTick->VAL;
+  }
+  time = TraceTickTime + (SysTick->LOAD - count);
+
+  portCLEAR_INTERRUPT_MASK_FROM_ISR(isrm);
+
+  return time;
+}
+#endif /* TRACE_CUSTOM_TIMESTAMP */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,168 @@
+/**
+  ******************************************************************************
+  * @file    trace_recorder.h
+  * @author  MCD Application Team
+  * @brief   Header for trace_recorder module
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2020 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef _TRACE_RECORDER_H__
+#define _TRACE_RECORDER_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Number of records in the ring, must be a power of 2. Each record is 8 bytes */
+#ifndef TRACE_RECORD_COUNT
+#define TRACE_RECORD_COUNT        256U
+#endif
+
+/* Number of tasks whose name is kept, outside the ring so that it is never
+   overwritten, and the number of characters kept of each name */
+#ifndef TRACE_TASK_COUNT
+#define TRACE_TASK_COUNT          16U
+#endif
+#define TRACE_TASK_NAME_LEN       12U
+
+/* Identifies a trace dump, "FRTR" when read as little endian bytes */
+#define TRACE_MAGIC               0x52545246U
+#define TRACE_VERSION             1U
+
+/* Event codes */
+#define TRACE_EVT_TASK_CREATE     0x01U   /* Param: priority */
+#define TRACE_EVT_TASK_DELETE     0x03U
+#define TRACE_EVT_TASK_SWITCHED_IN 0x04U  /* Param: priority */
+#define TRACE_EVT_TASK_READY      0x05U
+#define TRACE_EVT_TASK_DELAY      0x06U
+#define TRACE_EVT_TASK_SUSPEND    0x07U
+#define TRACE_EVT_TASK_RESUME     0x08U
+#define TRACE_EVT_QUEUE_CREATE    0x10U   /* Param of all queue events: queue type */
+#define TRACE_EVT_QUEUE_SEND      0x11U
+#define TRACE_EVT_QUEUE_SEND_FAILED 0x12U
+#define TRACE_EVT_QUEUE_SEND_FROM_ISR 0x13U
+#define TRACE_EVT_QUEUE_RECEIVE   0x14U
+#define TRACE_EVT_QUEUE_RECEIVE_FAILED 0x15U
+#define TRACE_EVT_QUEUE_RECEIVE_FROM_ISR 0x16U
+#define TRACE_EVT_QUEUE_BLOCK_SEND 0x17U
+#define TRACE_EVT_QUEUE_BLOCK_RECEIVE 0x18U
+#define TRACE_EVT_QUEUE_DELETE    0x19U
+#define TRACE_EVT_ISR_ENTER       0x20U   /* Param: interrupt identifier */
+#define TRACE_EVT_ISR_EXIT        0x21U   /* Param: interrupt identifier */
+#define TRACE_EVT_USER            0x30U   /* Param: user code, Object: user value */
+
+/* Exported types ------------------------------------------------------------*/
+/* One trace record. Objects (tasks and queues) are identified by the low 16
+   bits of their address, which is unique as long as all of them are in the
+   same 64 Kbytes of RAM */
+typedef struct
+{
+  uint32_t Timestamp;
+  uint8_t  Event;
+  uint8_t  Param;
+  uint16_t Object;
+} TraceRecord_t;
+
+/* Name of a task, in the order the tasks were created */
+typedef struct
+{
+  uint16_t Object;
+  uint8_t  Priority;
+  uint8_t  Reserved;
+  char     Name[TRACE_TASK_NAME_LEN];
+} TraceTask_t;
+
+/* The recorder. Save sizeof(TraceRecorder) bytes from &TraceRecorder with the
+   debugger, or send them over a link, to decode them on the host */
+typedef struct
+{
+  uint32_t          Magic;
+  uint16_t          Version;
+  uint16_t          RecordSize;
+  uint32_t          RecordCount;
+  uint32_t          TimestampHz;
+  volatile uint32_t Index;        /* Number of records written since TraceInit() */
+  volatile uint32_t Enabled;
+  uint16_t          TaskCount;
+  uint16_t          TaskSize;
+  volatile uint32_t TaskUsed;     /* Number of entries of Tasks[] in use */
+  TraceTask_t       Tasks[TRACE_TASK_COUNT];
+  TraceRecord_t     Records[TRACE_RECORD_COUNT];
+} TraceRecorder_t;
+
+/* Exported variables --------------------------------------------------------*/
+extern TraceRecorder_t TraceRecorder;
+
+/* Exported functions ------------------------------------------------------- */
+void     TraceInit (void);
+void     TraceStart (void);
+void     TraceStop (void);
+void     TraceEvent (uint8_t Event, uint8_t Param, uint32_t Object);
+void     TraceTaskCreate (void *Task, const char *Name, uint32_t Priority);
+void     TraceISREnter (uint8_t Id);
+void     TraceISRExit (uint8_t Id);
+void     TraceUserEvent (uint8_t Code, uint16_t Value);
+uint32_t TraceGetTimestamp (void);
+#ifndef TRACE_CUSTOM_TIMESTAMP
+void     TraceTick (void);
+#endif
+
+/* Exported macro ------------------------------------------------------------*/
+/* FreeRTOS trace hooks. The TCB and queue members used below are only visible
+   in tasks.c and queue.c, which is where the kernel expands these macros.
+   Queue types are recorded only when configUSE_TRACE_FACILITY is 1 */
+#define TRACE_OBJECT(p)           ((uint32_t)(uintptr_t)(p))
+
+#if (configUSE_TRACE_FACILITY == 1)
+#define TRACE_QUEUE_TYPE(pxQueue) ((uint8_t)(pxQueue)->ucQueueType)
+#else
+#define TRACE_QUEUE_TYPE(pxQueue) 0U
+#endif
+
+#define traceTASK_CREATE(pxNewTCB)                 TraceTaskCreate((pxNewTCB), (pxNewTCB)->pcTaskName, (pxNewTCB)->uxPriority)
+#define traceTASK_DELETE(pxTCB)                    TraceEvent(TRACE_EVT_TASK_DELETE, 0U, TRACE_OBJECT(pxTCB))
+#define traceTASK_SWITCHED_IN()                    TraceEvent(TRACE_EVT_TASK_SWITCHED_IN, (uint8_t)pxCurrentTCB->uxPriority, TRACE_OBJECT(pxCurrentTCB))
+#define traceMOVED_TASK_TO_READY_STATE(pxTCB)      TraceEvent(TRACE_EVT_TASK_READY, 0U, TRACE_OBJECT(pxTCB))
+#define traceTASK_DELAY()                          TraceEvent(TRACE_EVT_TASK_DELAY, 0U, TRACE_OBJECT(pxCurrentTCB))
+#define traceTASK_DELAY_UNTIL(xTimeToWake)         TraceEvent(TRACE_EVT_TASK_DELAY, 0U, TRACE_OBJECT(pxCurrentTCB))
+#define traceTASK_SUSPEND(pxTCB)                   TraceEvent(TRACE_EVT_TASK_SUSPEND, 0U, TRACE_OBJECT(pxTCB))
+#define traceTASK_RESUME(pxTCB)                    TraceEvent(TRACE_EVT_TASK_RESUME, 0U, TRACE_OBJECT(pxTCB))
+#define traceTASK_RESUME_FROM_ISR(pxTCB)           TraceEvent(TRACE_EVT_TASK_RESUME, 0U, TRACE_OBJECT(pxTCB))
+#ifndef TRACE_CUSTOM_TIMESTAMP
+#define traceTASK_INCREMENT_TICK(xTickCount)       TraceTick()
+#endif
+
+#define traceQUEUE_CREATE(pxNewQueue)              TraceEvent(TRACE_EVT_QUEUE_CREATE, TRACE_QUEUE_TYPE(pxNewQueue), TRACE_OBJECT(pxNewQueue))
+#define traceQUEUE_DELETE(pxQueue)                 TraceEvent(TRACE_EVT_QUEUE_DELETE, TRACE_QUEUE_TYPE(pxQueue), TRACE_OBJECT(pxQueue))
+#define traceQUEUE_SEND(pxQueue)                   TraceEvent(TRACE_EVT_QUEUE_SEND, TRACE_QUEUE_TYPE(pxQueue), TRACE_OBJECT(pxQueue))
+#define traceQUEUE_SEND_FAILED(pxQueue)            TraceEvent(TRACE_EVT_QUEUE_SEND_FAILED, TRACE_QUEUE_TYPE(pxQueue), TRACE_OBJECT(pxQueue))
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)          TraceEvent(TRACE_EVT_QUEUE_SEND_FROM_ISR, TRACE_QUEUE_TYPE(pxQueue), TRACE_OBJECT(pxQueue))
+#define traceQUEUE_RECEIVE(pxQueue)                TraceEvent(TRACE_EVT_QUEUE_RECEIVE, TRACE_QUEUE_TYPE(pxQueue), TRACE_OBJECT(pxQueue))
+#define traceQUEUE_RECEIVE_FAILED(pxQueue)         TraceEvent(TRACE_EVT_QUEUE_RECEIVE_FAILED, TRACE_QUEUE_TYPE(pxQueue), TRACE_OBJECT(pxQueue))
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue)       TraceEvent(TRACE_EVT_QUEUE_RECEIVE_FROM_ISR, TRACE_QUEUE_TYPE(pxQueue), TRACE_OBJECT(pxQueue))
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue)       TraceEvent(TRACE_EVT_QUEUE_BLOCK_SEND, TRACE_QUEUE_TYPE(pxQueue), TRACE_OBJECT(pxQueue))
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue)    TraceEvent(TRACE_EVT_QUEUE_BLOCK_RECEIVE, TRACE_QUEUE_TYPE(pxQueue), TRACE_OBJECT(pxQueue))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TRACE_RECORDER_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/